@@ -42,6 +42,11 @@ bool RTDTempProbeClass::begin(uint8_t io_address) {
 }
 
 void RTDTempProbeClass::selectChannel(int channel) {
+    setChannel(channel);
+    delay(RTD_CHANNEL_SETTLE_MS);
+}
+
+void RTDTempProbeClass::setChannel(int channel) {
 
 #ifdef TRY_REV2_RECOGNITION
     // check if OTP data is present AND the board is mounted on a r2 carrier
@@ -83,7 +88,6 @@ void RTDTempProbeClass::selectChannel(int channel) {
             digitalWrite(_ch_sel2, LOW);
             break;
     }
-    delay(150);
 }
 
 void RTDTempProbeClass::end() {
@@ -16,6 +16,9 @@
 #include <mbed.h>\r\n#include <Arduino.h>
 #include "pins_mc.h"
 
+/* Defines --------------------------------------------------------------------*/
+#define RTD_CHANNEL_SETTLE_MS 150 // multiplexer settle time after a channel change
+
 /* Class ----------------------------------------------------------------------*/
 
 /**
@@ -71,6 +74,16 @@ public:
      */
     void selectChannel(int channel);
 
+    /**
+     * @brief Select the input channel without waiting for the multiplexer to settle.
+     *
+     * Non-blocking variant of selectChannel(): the caller has to wait
+     * RTD_CHANNEL_SETTLE_MS before starting a conversion on the new channel.
+     *
+     * @param channel The channel number (0-2) to be selected for temperature reading.
+     */
+    void setChannel(int channel);
+
 private:
     PinName _rtd_cs;  // Pin for the CS of RTD
     PinName _ch_sel0; // Pin for the first channel selection bit
@@ -16,6 +16,9 @@
 #include <mbed.h>\r\n#include <Arduino.h>
 #include "pins_mc.h"
 
+/* Defines --------------------------------------------------------------------*/
+#define TC_CHANNEL_SETTLE_MS 150 // multiplexer settle + one MAX31855 conversion after a channel change
+
 /* Class ----------------------------------------------------------------------*/
 
 /**
@@ -69,6 +72,16 @@ public:
      */
     void selectChannel(int channel);
 
+    /**
+     * @brief Select the input channel without waiting for the multiplexer to settle.
+     *
+     * Non-blocking variant of selectChannel(): the caller has to wait
+     * TC_CHANNEL_SETTLE_MS before reading the new channel.
+     *
+     * @param channel The channel number (0-2) to be selected for temperature reading.
+     */
+    void setChannel(int channel);
+
 private:
     PinName _tc_cs;     // Pin for the CS of Thermocouple
     PinName _ch_sel0;   // Pin for the first channel selection bit
@@ -1,7 +1,7 @@
 #include "MAX31865.h"
 
 
-MAX31865Class::MAX31865Class(PinName cs) : _spi(SPI), _cs(cs) {
+MAX31865Class::MAX31865Class(PinName cs) : _spi(SPI), _cs(cs), _convState(CONV_IDLE), _convStartMs(0) {
 }
 
 static SPISettings _spiSettings(1000000, MSBFIRST, SPI_MODE1);
@@ -88,9 +88,13 @@ bool MAX31865Class::getVoltageFault(uint8_t fault) {
 }
 
 float MAX31865Class::readTemperature(float RTDnominal, float refResistor) {
+  return temperatureFromRTD(readRTD(), RTDnominal, refResistor);
+}
+
+float MAX31865Class::temperatureFromRTD(uint32_t rtd, float RTDnominal, float refResistor) {
   float Z1, Z2, Z3, Z4, Rt, temp;
 
-  Rt = readRTD();
+  Rt = rtd;
   Rt /= 32768;
   Rt *= refResistor;
 
@@ -127,27 +131,68 @@ float MAX31865Class::readTemperature(float RTDnominal, float refResistor) {
 }
 
 uint32_t MAX31865Class::readRTD() {
+  // blocking wrapper around the one-shot state machine (~75 ms)
+  startConversion();
+  while (!isReady()) {
+    delay(1);
+  }
+  return readResult();
+}
 
+void MAX31865Class::startConversion() {
   // clear fault
   writeByte(MAX31856_CONFIG_REG, (readByte(MAX31856_CONFIG_REG) & MAX31856_CONFIG_CLEAR_FAULT_CYCLE) | MAX31856_CONFIG_CLEAR_FAULT);
 
-  // enable bias
+  // enable bias, the one shot is triggered by isReady() once it has settled
   writeByte(MAX31856_CONFIG_REG, (readByte(MAX31856_CONFIG_REG) | MAX31856_CONFIG_BIAS_ON));
-  delay(10);
+  _convStartMs = millis();
+  _convState = CONV_BIAS;
+}
 
-  // ONE shot cOnfIg and make readings change with readByte
-  writeByte(MAX31856_CONFIG_REG, readByte(MAX31856_CONFIG_REG) | MAX31856_CONFIG_ONE_SHOT);
-  delay(65);
+bool MAX31865Class::isReady() {
+  unsigned long now = millis();
+
+  switch (_convState) {
+    case CONV_BIAS:
+      if (now - _convStartMs < MAX31865_BIAS_SETTLE_MS) {
+        return false;
+      }
+      // ONE shot cOnfIg and make readings change with readByte
+      writeByte(MAX31856_CONFIG_REG, readByte(MAX31856_CONFIG_REG) | MAX31856_CONFIG_ONE_SHOT);
+      _convStartMs = now;
+      _convState = CONV_CONVERTING;
+      return false;
+
+    case CONV_CONVERTING:
+      if (now - _convStartMs < MAX31865_CONVERSION_MS) {
+        return false;
+      }
+      _convState = CONV_READY;
+      return true;
+
+    case CONV_READY:
+      return true;
+
+    default:
+      return false;
+  }
+}
 
+uint32_t MAX31865Class::readResult() {
   //readings bytes
   uint16_t read = (readBytes(MAX31856_RTD_MSB_REG));
   read = read >>1;
   // disable bias
   writeByte(MAX31856_CONFIG_REG, readByte(MAX31856_CONFIG_REG) & (MAX31856_CONFIG_BIAS_MASK));
 
+  _convState = CONV_IDLE;
   return read;
 }
 
+bool MAX31865Class::isConverting() {
+  return _convState != CONV_IDLE;
+}
+
 uint8_t MAX31865Class::readByte(uint8_t addr) {
   addr &= 0x7F;
   uint8_t read = 0;
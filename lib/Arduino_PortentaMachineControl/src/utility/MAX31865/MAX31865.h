@@ -50,6 +50,10 @@
 #define TWO_WIRE 0
 #define THREE_WIRE 1
 
+// one-shot timing (datasheet: bias settle ~10 ms, conversion 52 ms @ 60 Hz / 62.5 ms @ 50 Hz)
+#define MAX31865_BIAS_SETTLE_MS 10
+#define MAX31865_CONVERSION_MS 65
+
 
 class MAX31865Class {
 public:
@@ -62,6 +66,13 @@ public:
   uint8_t readFault(void);
   void clearFault(void);
   uint32_t readRTD();
+
+  // non-blocking one-shot conversion: startConversion(), poll isReady(), then readResult()
+  void startConversion();
+  bool isReady();
+  uint32_t readResult();
+  bool isConverting();
+  float temperatureFromRTD(uint32_t rtd, float RTDnominal, float refResistor);
   bool getHighThresholdFault(uint8_t fault);
   bool getLowThresholdFault(uint8_t fault);
   bool getLowREFINFault(uint8_t fault);
@@ -78,6 +89,10 @@ private:
 
   PinName _cs;
   SPIClass& _spi;
+
+  enum { CONV_IDLE, CONV_BIAS, CONV_CONVERTING, CONV_READY };
+  uint8_t _convState;
+  unsigned long _convStartMs;
 };
 
 
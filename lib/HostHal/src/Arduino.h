@@ -0,0 +1,77 @@
+/*
+ * *****************************************************************************
+ * ARDUINO CORE STAND-IN (env:native, see host_hal.h)
+ * *****************************************************************************
+ * The subset of the Arduino API the firmware uses: time, Serial, pins.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+#include "host_hal.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define F(text) (text)
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);       // Advances the virtual clock
+void delayMicroseconds(unsigned int us);
+inline void yield() {}
+
+// --- Pins ---
+
+enum { INPUT = 0, OUTPUT = 1, INPUT_PULLUP = 2 };
+enum { LOW = 0, HIGH = 1, CHANGE = 2, FALLING = 3, RISING = 4 };
+enum { A0 = 100, A1, A2, A3, A4, A5, A6, A7 };
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return LOW; }
+inline int analogRead(int) { return 0; }
+inline int digitalPinToInterrupt(int pin) { return pin; }
+inline void attachInterrupt(int, void (*)(), int) {}
+
+// --- Serial ---
+
+enum { DEC = 10, HEX = 16, OCT = 8, BIN = 2 };
+enum { SERIAL_8N1 = 0x06 };
+
+class HostSerial {
+public:
+  void begin(unsigned long) {}
+  operator bool() const { return true; }
+  int availableForWrite() const { return 4096; }
+  size_t write(const uint8_t *data, size_t len);
+  size_t write(uint8_t c) { return write(&c, 1); }
+
+  size_t print(const char *text) { return write((const uint8_t *)text, strlen(text)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(double value, int digits = 2);
+  template<typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+  size_t print(T value, int base = DEC) {
+    return std::is_signed<T>::value ? printSigned((long long)value, base) : printUnsigned((unsigned long long)value, base);
+  }
+
+  size_t println() { return print("\r\n"); }
+  template<typename T>
+  size_t println(T value) { return print(value) + println(); }
+  template<typename T>
+  size_t println(T value, int format) { return print(value, format) + println(); }
+
+private:
+  size_t printSigned(long long value, int base);
+  size_t printUnsigned(unsigned long long value, int base);
+};
+
+extern HostSerial Serial;
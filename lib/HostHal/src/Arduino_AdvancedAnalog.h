@@ -0,0 +1,29 @@
+/*
+ * *****************************************************************************
+ * ADVANCED ANALOG STAND-IN (env:native, see host_hal.h)
+ * *****************************************************************************
+ * DMA acquisition that never delivers a buffer.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+enum { AN_RESOLUTION_8 = 8, AN_RESOLUTION_10 = 10, AN_RESOLUTION_12 = 12, AN_RESOLUTION_16 = 16 };
+
+class SampleBuffer {
+public:
+  const uint16_t *data() const { return nullptr; }
+  size_t size() const { return 0; }
+  void release() {}
+};
+
+class AdvancedADC {
+public:
+  template<typename... Pins>
+  explicit AdvancedADC(Pins...) {}
+  bool begin(int, uint32_t, size_t, size_t) { return true; }
+  bool available() { return false; }
+  SampleBuffer read() { return SampleBuffer(); }
+};
@@ -0,0 +1,85 @@
+/*
+ * *****************************************************************************
+ * PORTENTA MACHINE CONTROL STAND-IN (env:native, see host_hal.h)
+ * *****************************************************************************
+ * The objects the front-end modules call. With Config::SIMULATE_SENSORS the
+ * probes, ADCs and RS485 are never started; the digital outputs and the RTC
+ * are, and report to host_hal.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <math.h>
+#include <time.h>
+
+enum class SensorType : uint8_t { V_0_10, MA_4_20, NTC };
+enum { TWO_WIRE = 0, THREE_WIRE = 1 };
+enum { PROBE_K = 0, PROBE_J = 1 };
+
+#define TC_CHANNEL_SETTLE_MS 150
+#define RTD_CHANNEL_SETTLE_MS 150
+
+class HostDigitalOutputs {
+public:
+  bool begin(bool latchMode = false) { (void)latchMode; return true; }
+  void writeAll(uint8_t mask);
+};
+
+class HostDigitalInputs {
+public:
+  bool begin() { return true; }
+  uint32_t readAll() { return 0; }
+};
+
+class HostRtcController {
+public:
+  bool begin() { return true; }
+  time_t getEpoch();
+  void setEpoch(time_t epoch);
+};
+
+class HostAnalogIn {
+public:
+  bool begin(SensorType) { return true; }
+};
+
+class HostRs485Comm {
+public:
+  void begin(unsigned long, int = SERIAL_8N1) {}
+  void receive() {}
+  void noReceive() {}
+  void beginTransmission() {}
+  void endTransmission() {}
+  size_t write(const uint8_t *, size_t len) { return len; }
+  int available() { return 0; }
+  int read() { return -1; }
+};
+
+class HostTcTempProbe {
+public:
+  void begin() {}
+  void setChannel(int) {}
+  float readTemperature(int = PROBE_K) { return NAN; }
+};
+
+class HostRtdTempProbe {
+public:
+  void begin(int = TWO_WIRE) {}
+  void setChannel(int) {}
+  void startConversion() {}
+  bool isReady() { return false; }
+  uint32_t readResult() { return 0; }
+  uint8_t readFault() { return 0; }
+  void clearFault() {}
+  float temperatureFromRTD(uint32_t, float, float) { return NAN; }
+};
+
+extern HostDigitalOutputs MachineControl_DigitalOutputs;
+extern HostDigitalInputs MachineControl_DigitalInputs;
+extern HostRtcController MachineControl_RTCController;
+extern HostAnalogIn MachineControl_AnalogIn;
+extern HostRs485Comm MachineControl_RS485Comm;
+extern HostTcTempProbe MachineControl_TCTempProbe;
+extern HostRtdTempProbe MachineControl_RTDTempProbe;
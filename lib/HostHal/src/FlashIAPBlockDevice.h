@@ -0,0 +1,30 @@
+/*
+ * *****************************************************************************
+ * BLOCK DEVICE STAND-IN (env:native, see host_hal.h)
+ * *****************************************************************************
+ * RAM flash with the mbed BlockDevice calls flash_ringbuffer.cpp uses. All
+ * instances share the one device configured by host_flash_geometry().
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "host_hal.h"
+
+typedef uint64_t bd_addr_t;
+typedef uint64_t bd_size_t;
+
+class FlashIAPBlockDevice {
+public:
+  int init();
+  int deinit();
+  int read(void *buffer, bd_addr_t addr, bd_size_t size);
+  int program(const void *buffer, bd_addr_t addr, bd_size_t size);
+  int erase(bd_addr_t addr, bd_size_t size);
+  bd_size_t size() const;
+  bd_size_t get_erase_size() const;
+  bd_size_t get_program_size() const;
+  bd_size_t get_read_size() const { return 1; }
+};
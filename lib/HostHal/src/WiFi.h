@@ -0,0 +1,45 @@
+/*
+ * *****************************************************************************
+ * WIFI STAND-IN (env:native, see host_hal.h)
+ * *****************************************************************************
+ * A server without clients, so web_server.cpp links; its generators are
+ * driven directly (web_server_bench_serialize()).
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL,
+  WL_SCAN_COMPLETED,
+  WL_CONNECTED,
+  WL_CONNECT_FAILED,
+  WL_CONNECTION_LOST,
+  WL_DISCONNECTED,
+  WL_NO_SHIELD = 255
+};
+
+class WiFiClient {
+public:
+  int connect(const char *, uint16_t) { return 0; }
+  bool connected() { return false; }
+  int available() { return 0; }
+  int read() { return -1; }
+  int read(uint8_t *, size_t) { return -1; }
+  size_t write(const uint8_t *, size_t len) { return len; }
+  size_t write(uint8_t) { return 1; }
+  void flush() {}
+  void stop() {}
+  operator bool() { return false; }
+};
+
+class WiFiServer {
+public:
+  explicit WiFiServer(uint16_t) {}
+  void begin() {}
+  WiFiClient accept() { return WiFiClient(); }
+  WiFiClient available() { return WiFiClient(); }
+};
@@ -0,0 +1,230 @@
+/*
+ * *****************************************************************************
+ * HOST HAL IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "host_hal.h"
+#include <chrono>
+#include <vector>
+#include "Arduino.h"
+#include "Arduino_PortentaMachineControl.h"
+#include "FlashIAPBlockDevice.h"
+
+// --- Clock ---
+
+static uint64_t g_virtualUs = 0;
+static bool g_realClock = false;
+static std::chrono::steady_clock::time_point g_realStart;
+static uint64_t g_realStartUs = 0;
+
+static uint64_t nowUs() {
+  if (!g_realClock) return g_virtualUs;
+  auto elapsed = std::chrono::steady_clock::now() - g_realStart;
+  return g_realStartUs + (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void host_clock_set_us(uint64_t us) {
+  g_realClock = false;
+  g_virtualUs = us;
+}
+
+void host_clock_advance_us(uint64_t us) {
+  if (!g_realClock) g_virtualUs += us;
+}
+
+void host_clock_use_real() {
+  g_realStartUs = nowUs();
+  g_realStart = std::chrono::steady_clock::now();
+  g_realClock = true;
+}
+
+unsigned long millis() {
+  return (unsigned long)(uint32_t)(nowUs() / 1000u);
+}
+
+unsigned long micros() {
+  return (unsigned long)(uint32_t)nowUs();
+}
+
+void delay(unsigned long ms) {
+  host_clock_advance_ms(ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+  host_clock_advance_us(us);
+}
+
+// --- Serial ---
+
+HostSerial Serial;
+static bool g_serialEcho = true;
+static uint64_t g_serialBytes = 0;
+
+void host_serial_echo(bool on) {
+  g_serialEcho = on;
+}
+
+uint64_t host_serial_bytes() {
+  return g_serialBytes;
+}
+
+size_t HostSerial::write(const uint8_t *data, size_t len) {
+  g_serialBytes += len;
+  if (g_serialEcho) {
+    // Drop the '\r' of Serial line ends on the terminal
+    for (size_t i = 0; i < len; i++) {
+      if (data[i] != '\r') putchar(data[i]);
+    }
+  }
+  return len;
+}
+
+size_t HostSerial::print(double value, int digits) {
+  char text[48];
+  int n = snprintf(text, sizeof(text), "%.*f", digits, value);
+  return (n > 0) ? write((const uint8_t *)text, (size_t)n) : 0;
+}
+
+size_t HostSerial::printSigned(long long value, int base) {
+  if (value < 0 && base == DEC) {
+    return print('-') + printUnsigned((unsigned long long)(-(value + 1)) + 1u, base);
+  }
+  return printUnsigned((unsigned long long)value, base);
+}
+
+size_t HostSerial::printUnsigned(unsigned long long value, int base) {
+  char text[66];
+  char *p = text + sizeof(text);
+  *--p = '\0';
+  if (base < 2) base = DEC;
+  do {
+    unsigned digit = (unsigned)(value % (unsigned)base);
+    *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+    value /= (unsigned)base;
+  } while (value != 0);
+  return print(p);
+}
+
+// --- Flash ---
+
+static uint64_t g_flashSize = 16u * 1024u * 1024u;
+static uint32_t g_flashErase = 4096;
+static uint32_t g_flashProgram = 1;
+static std::vector<uint8_t> g_flash;
+static HostFlashStats g_flashStats = {};
+static int32_t g_flashFailAfter = -1;
+
+void host_flash_geometry(uint64_t sizeBytes, uint32_t eraseSize, uint32_t programSize) {
+  g_flashSize = sizeBytes;
+  g_flashErase = eraseSize;
+  g_flashProgram = programSize;
+  g_flash.clear();
+}
+
+void host_flash_wipe() {
+  g_flash.assign((size_t)g_flashSize, 0xFF);
+  g_flashStats = {};
+  g_flashFailAfter = -1;
+}
+
+void host_flash_stats(HostFlashStats *out) {
+  *out = g_flashStats;
+}
+
+void host_flash_fail_after(int32_t programs) {
+  g_flashFailAfter = programs;
+}
+
+static bool inRange(bd_addr_t addr, bd_size_t size) {
+  return addr <= g_flash.size() && size <= g_flash.size() - addr;
+}
+
+// Content survives deinit()/init() like a real chip; only the geometry or a wipe resets it
+int FlashIAPBlockDevice::init() {
+  if (g_flash.size() != g_flashSize) host_flash_wipe();
+  return 0;
+}
+
+int FlashIAPBlockDevice::deinit() {
+  return 0;
+}
+
+int FlashIAPBlockDevice::read(void *buffer, bd_addr_t addr, bd_size_t size) {
+  if (!inRange(addr, size)) return -1;
+  memcpy(buffer, g_flash.data() + addr, (size_t)size);
+  g_flashStats.readBytes += size;
+  return 0;
+}
+
+int FlashIAPBlockDevice::program(const void *buffer, bd_addr_t addr, bd_size_t size) {
+  if (!inRange(addr, size) || addr % g_flashProgram != 0 || size % g_flashProgram != 0) return -1;
+  if (g_flashFailAfter == 0) return -1;
+  if (g_flashFailAfter > 0) g_flashFailAfter--;
+  const uint8_t *src = (const uint8_t *)buffer;
+  uint8_t *dst = g_flash.data() + addr;
+  bool fault = false;
+  for (bd_size_t i = 0; i < size; i++) {
+    if ((src[i] & ~dst[i]) != 0) fault = true; // NOR: a program only clears bits
+    dst[i] &= src[i];
+  }
+  if (fault) g_flashStats.programFaults++;
+  g_flashStats.programs++;
+  g_flashStats.programBytes += size;
+  return 0;
+}
+
+int FlashIAPBlockDevice::erase(bd_addr_t addr, bd_size_t size) {
+  if (!inRange(addr, size) || addr % g_flashErase != 0 || size % g_flashErase != 0) return -1;
+  memset(g_flash.data() + addr, 0xFF, (size_t)size);
+  g_flashStats.erases += (uint32_t)(size / g_flashErase);
+  return 0;
+}
+
+bd_size_t FlashIAPBlockDevice::size() const {
+  return g_flash.size();
+}
+
+bd_size_t FlashIAPBlockDevice::get_erase_size() const {
+  return g_flashErase;
+}
+
+bd_size_t FlashIAPBlockDevice::get_program_size() const {
+  return g_flashProgram;
+}
+
+// --- Machine Control ---
+
+HostDigitalOutputs MachineControl_DigitalOutputs;
+HostDigitalInputs MachineControl_DigitalInputs;
+HostRtcController MachineControl_RTCController;
+HostAnalogIn MachineControl_AnalogIn;
+HostRs485Comm MachineControl_RS485Comm;
+HostTcTempProbe MachineControl_TCTempProbe;
+HostRtdTempProbe MachineControl_RTDTempProbe;
+
+static uint8_t g_outputs = 0;
+static uint32_t g_rtcEpoch = 0;
+static uint64_t g_rtcSetUs = 0;
+
+void HostDigitalOutputs::writeAll(uint8_t mask) {
+  g_outputs = mask;
+}
+
+uint8_t host_outputs_mask() {
+  return g_outputs;
+}
+
+void host_rtc_set_epoch(uint32_t epoch) {
+  g_rtcEpoch = epoch;
+  g_rtcSetUs = nowUs();
+}
+
+// The RTC runs with the (virtual) clock from the epoch last set
+time_t HostRtcController::getEpoch() {
+  return (g_rtcEpoch == 0) ? 0 : (time_t)(g_rtcEpoch + (nowUs() - g_rtcSetUs) / 1000000u);
+}
+
+void HostRtcController::setEpoch(time_t epoch) {
+  host_rtc_set_epoch((uint32_t)epoch);
+}
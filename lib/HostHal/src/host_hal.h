@@ -0,0 +1,86 @@
+/*
+ * *****************************************************************************
+ * HOST HAL - ARDUINO / MBED / MACHINE CONTROL STAND-INS FOR env:native
+ * *****************************************************************************
+ * Lets the firmware modules compile and run unchanged on the development
+ * machine (pio test -e native):
+ * - Time: millis()/micros() read a virtual clock that only moves when the
+ *   test advances it, so days of chamber operation run in seconds; the
+ *   benchmarks switch it to the host's steady clock
+ * - Serial: printed to stdout, or swallowed for long simulations
+ * - Flash: FlashIAPBlockDevice is a RAM block device with NOR semantics
+ *   (program clears bits, erase sets a whole erase block to 0xFF) and
+ *   counters; flash_ringbuffer.cpp runs on it as on the board
+ * - Machine Control: outputs, inputs, RTC, RS485, probes and ADCs accept
+ *   every call; the digital outputs remember the last mask written
+ *
+ * Nothing here is built for the board (library.json: platforms = native).
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Clock ---
+
+/**
+ * @brief Virtual time: millis()/micros() return `us` until advanced
+ */
+void host_clock_set_us(uint64_t us);
+void host_clock_advance_us(uint64_t us);
+inline void host_clock_advance_ms(unsigned long ms) { host_clock_advance_us((uint64_t)ms * 1000u); }
+
+/**
+ * @brief Follow the host's steady clock from the current virtual time on
+ * (benchmarks); host_clock_set_us() returns to virtual time
+ */
+void host_clock_use_real();
+
+// --- Serial ---
+
+/**
+ * @brief Print Serial output to stdout (default) or drop it
+ */
+void host_serial_echo(bool on);
+
+/// Bytes written to Serial since start, echoed or not
+uint64_t host_serial_bytes();
+
+// --- Flash ---
+
+struct HostFlashStats {
+  uint64_t readBytes;
+  uint64_t programBytes;
+  uint32_t programs;
+  uint32_t erases;        ///< Erase blocks
+  uint32_t programFaults; ///< Programs that tried to set a cleared bit
+};
+
+/**
+ * @brief Geometry of the RAM flash; takes effect on the next init()
+ *
+ * Default: 16 MiB, 4 KiB erase blocks, 1-byte programs (QSPI NOR).
+ */
+void host_flash_geometry(uint64_t sizeBytes, uint32_t eraseSize, uint32_t programSize);
+
+/**
+ * @brief Discard the content (all 0xFF) and the counters, like a new chip
+ */
+void host_flash_wipe();
+
+void host_flash_stats(HostFlashStats *out);
+
+/**
+ * @brief Fail every program after `programs` more ones (power cut); -1 = never
+ */
+void host_flash_fail_after(int32_t programs);
+
+// --- Machine Control ---
+
+/// Last mask written to the digital outputs
+uint8_t host_outputs_mask();
+
+/// Value returned by the RTC (UTC seconds, 0 = not set)
+void host_rtc_set_epoch(uint32_t epoch);
@@ -0,0 +1,13 @@
+/*
+ * *****************************************************************************
+ * MBED OS STAND-IN (env:native, see host_hal.h)
+ * *****************************************************************************
+ * Threads and semaphores are not used on the host (CC_NETWORK_THREAD and
+ * CC_USB_LOG stay 0); this only satisfies the includes.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <chrono>
+#include <stdint.h>
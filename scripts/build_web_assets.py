@@ -0,0 +1,121 @@
+"""
+*******************************************************************************
+BUILD WEB ASSETS - MINIFY + GZIP THE DASHBOARD INTO src/web_assets.h
+*******************************************************************************
+Runs as a PlatformIO pre-script (extra_scripts in platformio.ini) or by hand:
+
+    python scripts/build_web_assets.py
+
+Every file in ASSETS is minified (comments, indentation and line breaks
+outside <script> removed), gzip-compressed with a fixed timestamp and
+emitted as a const uint8_t[] (flash) with a strong ETag (CRC-32 of the
+minified text). The header is only rewritten when its content changes, so
+an unchanged dashboard does not trigger a rebuild.
+*******************************************************************************
+"""
+
+import gzip
+import os
+import re
+import zlib
+
+try:
+    Import("env")  # noqa: F821 (SCons)
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+OUTPUT = os.path.join(PROJECT_DIR, "src", "web_assets.h")
+
+# (source below web/, C identifier, served path, Content-Type)
+ASSETS = [
+    ("dashboard.html", "DASHBOARD", "/", "text/html; charset=utf-8"),
+]
+
+
+def minify_html(text):
+    text = re.sub(r"<!--.*?-->", "", text, flags=re.S)
+    out = []
+    in_script = False
+    for raw in text.splitlines():
+        line = raw.strip()
+        if not line:
+            continue
+        if in_script and line.startswith("//"):
+            continue
+        # Inside <script> keep the line break (automatic semicolon insertion)
+        if in_script and out:
+            out.append("\n")
+        out.append(line)
+        if "<script>" in line:
+            in_script = True
+        if "</script>" in line:
+            in_script = False
+    return "".join(out)
+
+
+def c_array(data):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append("  " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(rows)
+
+
+def build():
+    parts = [
+        "/*",
+        " * *****************************************************************************",
+        " * WEB ASSETS - GENERATED BY scripts/build_web_assets.py, DO NOT EDIT",
+        " * *****************************************************************************",
+        " * Sources in web/. Each asset is minified and gzip-compressed; serve it",
+        " * with Content-Encoding: gzip and its ETag (see web_server.cpp).",
+        " * *****************************************************************************",
+        " */",
+        "",
+        "#pragma once",
+        "",
+        "#include <stddef.h>",
+        "#include <stdint.h>",
+        "",
+        "struct WebAsset {",
+        "  const char *path;         ///< Request path",
+        "  const char *contentType;",
+        "  const char *etag;         ///< Strong ETag including the quotes",
+        "  const uint8_t *data;      ///< gzip stream (flash)",
+        "  size_t length;",
+        "  size_t plainLength;       ///< Minified size before compression",
+        "};",
+        "",
+    ]
+    rows = []
+    for source, name, path, content_type in ASSETS:
+        with open(os.path.join(PROJECT_DIR, "web", source), encoding="utf-8") as f:
+            plain = minify_html(f.read()).encode("utf-8")
+        packed = gzip.compress(plain, compresslevel=9, mtime=0)
+        etag = '\\"%08x\\"' % (zlib.crc32(plain) & 0xFFFFFFFF)
+        parts.append("// %s: %d -> %d bytes" % (source, len(plain), len(packed)))
+        parts.append("static const uint8_t %s_GZ[] = {" % name)
+        parts.append(c_array(packed))
+        parts.append("};")
+        parts.append("")
+        rows.append('  {"%s", "%s", "%s", %s_GZ, sizeof(%s_GZ), %d},'
+                    % (path, content_type, etag, name, name, len(plain)))
+    parts.append("static const WebAsset WEB_ASSETS[] = {")
+    parts.extend(rows)
+    parts.append("};")
+    parts.append("")
+    parts.append("static constexpr uint8_t WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);")
+    parts.append("")
+    text = "\n".join(parts)
+
+    old = None
+    if os.path.exists(OUTPUT):
+        with open(OUTPUT, encoding="utf-8") as f:
+            old = f.read()
+    if old != text:
+        with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+            f.write(text)
+        print("web assets: wrote " + os.path.relpath(OUTPUT, PROJECT_DIR))
+
+
+build()
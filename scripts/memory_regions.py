@@ -0,0 +1,132 @@
+"""
+*******************************************************************************
+MEMORY REGIONS - PLACEMENT FLAGS AND STATIC MEMORY BUDGET
+*******************************************************************************
+Runs as a PlatformIO script (extra_scripts in platformio.ini):
+
+- Builds with -DCC_MEMORY_PLACEMENT=1 and links scripts/memory_regions.ld,
+  so FAST_DATA / FAST_CODE / EXT_DATA (src/memory_regions.h) land in DTCM,
+  ITCM and SDRAM
+- After linking, prints the budget of the image: bytes per region (by the
+  run address of every allocated section, plus the flash load image) and
+  the largest symbols of each region. A region over its capacity fails
+  the build.
+
+By hand, for any linked image:
+
+    python scripts/memory_regions.py .pio/build/portenta_h7_m7/firmware.elf
+*******************************************************************************
+"""
+
+import os
+import re
+import subprocess
+import sys
+
+# RAM vector table of the mbed core at the start of DTCM ((16 + 150) x 4
+# bytes, 8-byte aligned); its DTCMRAM region starts behind it
+DTCM_VECTORS = 664
+
+# (name, start, size): STM32H747 M7 view, sizes as in Config::Memory / the .ld.
+# The M7 image starts behind the 256 KB bootloader.
+REGIONS = [
+    ("FLASH", 0x08040000, 768 * 1024),
+    ("ITCM", 0x00000400, 63 * 1024),
+    ("DTCM", 0x20000000 + DTCM_VECTORS, 128 * 1024 - DTCM_VECTORS),
+    ("AXI SRAM", 0x24000000, 512 * 1024),
+    ("SRAM1-3", 0x30000000, 288 * 1024),
+    ("SRAM4", 0x38000000, 64 * 1024),
+    ("SDRAM", 0x60000000, 8 * 1024 * 1024),
+]
+TOP_SYMBOLS = 5
+WARN_PERCENT = 90
+
+# "  0 .text  0001a2b4  08040298  08040298  00000298  2**3"
+SECTION_RE = re.compile(r"^\s*\d+\s+(\S+)\s+([0-9a-f]+)\s+([0-9a-f]+)\s+([0-9a-f]+)\s+[0-9a-f]+\s+\S+$")
+
+
+def region_of(address):
+    for name, start, size in REGIONS:
+        if start <= address < start + size:
+            return name
+    return None
+
+
+def sections(objdump, elf):
+    """(name, size, vma, lma, flags) of every section."""
+    lines = subprocess.check_output([objdump, "-h", elf], text=True).splitlines()
+    result = []
+    for i, line in enumerate(lines):
+        m = SECTION_RE.match(line)
+        if m and i + 1 < len(lines):
+            flags = lines[i + 1].strip()
+            result.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16), int(m.group(4), 16), flags))
+    return result
+
+
+def largest_symbols(nm, elf):
+    """region -> [(size, name)], largest first."""
+    out = subprocess.check_output([nm, "-S", "-C", "--size-sort", "-r", elf], text=True)
+    tops = {}
+    for line in out.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) < 4:
+            continue
+        region = region_of(int(parts[0], 16))
+        if region and len(tops.setdefault(region, [])) < TOP_SYMBOLS:
+            tops[region].append((int(parts[1], 16), parts[3]))
+    return tops
+
+
+def report(elf, objdump="arm-none-eabi-objdump", nm="arm-none-eabi-nm"):
+    used = {name: 0 for name, _, _ in REGIONS}
+    for name, size, vma, lma, flags in sections(objdump, elf):
+        if "ALLOC" not in flags or size == 0:
+            continue
+        region = region_of(vma)
+        if region:
+            used[region] += size
+        # Initialised data and ITCM code also occupy flash
+        if "LOAD" in flags and region != "FLASH" and region_of(lma) == "FLASH":
+            used["FLASH"] += size
+    tops = largest_symbols(nm, elf)
+
+    print("Memory budget (%s):" % os.path.basename(elf))
+    over = False
+    for name, _, capacity in REGIONS:
+        percent = 100.0 * used[name] / capacity
+        mark = ""
+        if used[name] > capacity:
+            mark, over = "  OVER", True
+        elif percent >= WARN_PERCENT:
+            mark = "  (>= %d %%)" % WARN_PERCENT
+        print("  %-9s %9d / %9d bytes  %5.1f %%%s" % (name, used[name], capacity, percent, mark))
+        for size, symbol in tops.get(name, []):
+            print("  %-9s   %9d  %s" % ("", size, symbol))
+    return not over
+
+
+def tool(env, name):
+    # $OBJCOPY is the toolchain's objcopy: objdump and nm sit next to it
+    return re.sub(r"objcopy(\.exe)?$", name + r"\1", env.subst("$OBJCOPY"))
+
+
+try:
+    Import("env")  # noqa: F821 (SCons)
+except NameError:
+    env = None
+
+if env is not None:
+    project_dir = env.subst("$PROJECT_DIR")
+    env.Append(CPPDEFINES=[("CC_MEMORY_PLACEMENT", 1)])
+    env.Append(LINKFLAGS=["-Wl,-T," + os.path.join(project_dir, "scripts", "memory_regions.ld")])
+
+    def budget_action(target, source, env):
+        ok = report(target[0].get_abspath(), tool(env, "objdump"), tool(env, "nm"))
+        return 0 if ok else 1
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", budget_action)
+elif __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit("usage: memory_regions.py firmware.elf")
+    sys.exit(0 if report(sys.argv[1]) else 1)
@@ -0,0 +1,135 @@
+/*
+ * *****************************************************************************
+ * ACTION RECIPES - CONSTEXPR STEP TABLES OF THE CONTROLLER ACTIONS
+ * *****************************************************************************
+ * Every action is a list of steps, interpreted by the generic sequencer in
+ * controller.cpp:
+ * - A step holds an ACTUATOR_BIT_* mask (fogger, swirler, fresh air) for its
+ *   duration; entering a step switches only the outputs whose bit differs
+ *   from the previous step, so the outputs are set once per step
+ * - The step's event is logged when it starts, the recipe's completion
+ *   event when the last step ends
+ * - Post-actions run once the recipe completes: the last step's outputs off
+ *   and optionally a lockout of another action
+ *
+ * The heater is not part of any recipe, it is regulated on its own.
+ * Durations are chamber time (see chamber_clock.h).
+ *
+ * Arbitration: the ActionType order is the priority of queued requests
+ * (lowest value first). ACTION_SAFETY is never queued, a tripped CO2 or
+ * temperature limit starts it at once and aborts or shortens whatever runs.
+ *
+ * Adding a recipe: append an ActionType (before ACTION_SAFETY for a normal
+ * priority), a step list and its ACTION_RECIPES row, then request it from
+ * controllerEvaluate().
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "controller.h"
+#include "event_log.h"
+
+enum ActionType : uint8_t {
+  ACTION_NONE,
+  ACTION_CO2,
+  ACTION_RH_DOWN,
+  ACTION_RH_UP,
+  ACTION_BASELINE,
+  ACTION_SAFETY,             ///< Critical limit tripped: ventilate
+  ACTION_COUNT
+};
+
+static_assert(ACTION_COUNT <= 8, "Pending actions are one bit each in a uint8_t");
+
+/// Bit of an action in the arbiter's pending mask
+constexpr uint8_t actionBit(ActionType action) {
+  return (uint8_t)(1u << action);
+}
+
+// Step flags
+static constexpr uint8_t STEP_VENTILATES = 0x01;  ///< Restarts the baseline interval
+
+/**
+ * @brief One step of a recipe
+ */
+struct ActionStep {
+  uint8_t outputs;           ///< ACTUATOR_BIT_* held during the step
+  unsigned long durationMs;  ///< Chamber time
+  EventId event;             ///< Logged when the step starts
+  uint8_t flags;             ///< STEP_*
+};
+
+/**
+ * @brief One action: its steps and what happens when they are done
+ */
+struct ActionRecipe {
+  const ActionStep *steps;
+  uint8_t stepCount;
+  EventId completeEvent;     ///< Logged after the last step
+  ActionType lockAction;     ///< Locked out on completion (ACTION_NONE = none)
+  unsigned long lockoutMs;   ///< Chamber time
+};
+
+/// Outputs an action may switch; the heater belongs to the heater control
+static constexpr uint8_t ACTION_OUTPUT_MASK =
+    ACTUATOR_BIT_FOGGER | ACTUATOR_BIT_SWIRLER | ACTUATOR_BIT_FRESHAIR;
+
+// Lockout after an RH correction (chamber time)
+static constexpr unsigned long RT_RH_LOCKOUT_MS = 180000;  // 3 minutes
+
+// --- Step lists ---
+
+static constexpr ActionStep CO2_STEPS[] = {
+  {ACTUATOR_BIT_SWIRLER,  10000, EVT_CO2_SWIRL,  0},
+  {0,                     20000, EVT_CO2_SETTLE, 0},
+};
+
+static constexpr ActionStep RH_DOWN_STEPS[] = {
+  {ACTUATOR_BIT_FRESHAIR, 10000, EVT_RH_DOWN_FRESHAIR, STEP_VENTILATES},
+  {ACTUATOR_BIT_SWIRLER,  10000, EVT_RH_DOWN_SWIRL,    0},
+  {0,                     20000, EVT_RH_DOWN_SETTLE,   0},
+};
+
+static constexpr ActionStep RH_UP_STEPS[] = {
+  {ACTUATOR_BIT_FOGGER,   5000,  EVT_RH_UP_FOGGER, 0},
+  {ACTUATOR_BIT_FOGGER | ACTUATOR_BIT_SWIRLER | ACTUATOR_BIT_FRESHAIR,
+                          10000, EVT_RH_UP_MIX,    STEP_VENTILATES},
+  {0,                     120000, EVT_RH_UP_SETTLE, 0},
+};
+
+static constexpr ActionStep BASELINE_STEPS[] = {
+  {ACTUATOR_BIT_FRESHAIR, 10000, EVT_BASELINE_FRESHAIR, STEP_VENTILATES},
+  {0,                     10000, EVT_BASELINE_SETTLE,   0},
+};
+
+static constexpr ActionStep SAFETY_STEPS[] = {
+  {ACTUATOR_BIT_FRESHAIR | ACTUATOR_BIT_SWIRLER, 30000, EVT_SAFETY_VENT, STEP_VENTILATES},
+  {0,                     10000, EVT_SAFETY_SETTLE, 0},
+};
+
+template<size_t N>
+constexpr uint8_t stepCount(const ActionStep (&)[N]) {
+  return (uint8_t)N;
+}
+
+// --- Recipe table, indexed by ActionType ---
+
+static constexpr ActionRecipe ACTION_RECIPES[ACTION_COUNT] = {
+  {nullptr,        0,                             EVT_COUNT,             ACTION_NONE,    0},  // ACTION_NONE
+  {CO2_STEPS,      stepCount(CO2_STEPS),          EVT_CO2_COMPLETE,      ACTION_NONE,    0},
+  {RH_DOWN_STEPS,  stepCount(RH_DOWN_STEPS),      EVT_RH_DOWN_COMPLETE,  ACTION_RH_UP,   RT_RH_LOCKOUT_MS},
+  {RH_UP_STEPS,    stepCount(RH_UP_STEPS),        EVT_RH_UP_COMPLETE,    ACTION_RH_DOWN, RT_RH_LOCKOUT_MS},
+  {BASELINE_STEPS, stepCount(BASELINE_STEPS),     EVT_BASELINE_COMPLETE, ACTION_NONE,    0},
+  {SAFETY_STEPS,   stepCount(SAFETY_STEPS),       EVT_SAFETY_COMPLETE,   ACTION_NONE,    0},
+};
+
+constexpr bool actionRecipesValid() {
+  for (uint8_t a = ACTION_NONE + 1; a < ACTION_COUNT; a++) {
+    if (ACTION_RECIPES[a].stepCount == 0) return false;
+  }
+  return true;
+}
+static_assert(actionRecipesValid(), "Every action needs at least one step");
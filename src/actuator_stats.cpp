@@ -0,0 +1,161 @@
+/*
+ * *****************************************************************************
+ * ACTUATOR STATISTICS IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "actuator_stats.h"
+#include <Arduino.h>
+#include "config.h"
+#include "duty_window.h"
+#include "seqlock.h"
+#include "storage.h"
+
+using namespace Config::Stats;
+
+static_assert(SERIES_FOGGER - SENSOR_SERIES_COUNT == 0 && SERIES_SWIRLER - SENSOR_SERIES_COUNT == 1 &&
+              SERIES_FRESHAIR - SENSOR_SERIES_COUNT == 2 && SERIES_HEATER - SENSOR_SERIES_COUNT == 3,
+              "RATED_W and the lifetime keys are in ACTUATOR_BIT_* order");
+
+static constexpr float RATED_W[ACTUATOR_COUNT] = {FOGGER_W, SWIRLER_W, FRESHAIR_W, HEATER_W};
+static constexpr SettingKey ON_S_KEYS[ACTUATOR_COUNT] = {
+  SETTING_FOGGER_ON_S, SETTING_SWIRLER_ON_S, SETTING_FRESHAIR_ON_S, SETTING_HEATER_ON_S};
+static constexpr SettingKey SWITCH_KEYS[ACTUATOR_COUNT] = {
+  SETTING_FOGGER_SWITCHES, SETTING_SWIRLER_SWITCHES, SETTING_FRESHAIR_SWITCHES, SETTING_HEATER_SWITCHES};
+
+typedef DutyWindow<ACTUATOR_COUNT, 12, HOUR_BUCKET_MS> HourWindow;
+typedef DutyWindow<ACTUATOR_COUNT, 24, DAY_BUCKET_MS> DayWindow;
+
+struct ChamberStats {
+  bool started;
+  uint8_t on;              // ACTUATOR_BIT_* since lastMs
+  unsigned long startMs;   // Chamber time of the first call
+  unsigned long lastMs;    // Credited up to here
+  HourWindow hour;
+  DayWindow day;
+  ActuatorTotals boot[ACTUATOR_COUNT];
+};
+
+// Control side
+static ChamberStats g_chambers[Config::Chambers::COUNT];
+static ActuatorTotals g_checkpointed[ACTUATOR_COUNT];  // Sum of boot totals already added to the settings
+static unsigned long g_lastCheckpointMs = 0;           // Real time
+static ActuatorLifetime g_lifetime = {};               // Writer-side copy
+
+static SeqLock<ActuatorStats> g_published[Config::Chambers::COUNT];
+static SeqLock<ActuatorLifetime> g_publishedLifetime;
+
+static void start(ChamberStats &cs, unsigned long now) {
+  if (cs.started) return;
+  cs.started = true;
+  cs.startMs = now;
+  cs.lastMs = now;
+  cs.hour.reset(now);
+  cs.day.reset(now);
+}
+
+// Credit the constant on-mask since the last call
+static void advance(ChamberStats &cs, unsigned long now) {
+  start(cs, now);
+  if ((long)(now - cs.lastMs) <= 0) return;
+  uint32_t dt = (uint32_t)(now - cs.lastMs);
+  cs.hour.add(cs.lastMs, now, cs.on);
+  cs.day.add(cs.lastMs, now, cs.on);
+  for (uint8_t a = 0; a < ACTUATOR_COUNT; a++) {
+    if (cs.on & (1u << a)) cs.boot[a].onMs += dt;
+  }
+  cs.lastMs = now;
+}
+
+void actuator_stats_switch(uint8_t chamber, uint8_t actuatorBit, bool on, unsigned long now) {
+  if (chamber >= Config::Chambers::COUNT) return;
+  ChamberStats &cs = g_chambers[chamber];
+  if (cs.started && ((cs.on & actuatorBit) != 0) == on) return;
+  advance(cs, now);
+  if (!on) {
+    cs.on &= (uint8_t)~actuatorBit;
+    return;
+  }
+  cs.on |= actuatorBit;
+  for (uint8_t a = 0; a < ACTUATOR_COUNT; a++) {
+    if (actuatorBit & (1u << a)) {
+      cs.hour.countSwitch(a, now);
+      cs.day.countSwitch(a, now);
+      cs.boot[a].switches++;
+    }
+  }
+}
+
+// Boot totals of all chambers, per actuator
+static ActuatorTotals bootTotal(uint8_t a) {
+  ActuatorTotals sum = {0, 0};
+  for (const ChamberStats &cs : g_chambers) {
+    sum.onMs += cs.boot[a].onMs;
+    sum.switches += cs.boot[a].switches;
+  }
+  return sum;
+}
+
+// Add what accrued since the last checkpoint to the lifetime settings;
+// whole seconds only, the remainder waits for the next one
+static void checkpoint() {
+  for (uint8_t a = 0; a < ACTUATOR_COUNT; a++) {
+    ActuatorTotals total = bootTotal(a);
+    uint32_t seconds = (uint32_t)((total.onMs - g_checkpointed[a].onMs) / 1000u);
+    uint32_t switches = total.switches - g_checkpointed[a].switches;
+    if (seconds > 0) storage_add_counter(ON_S_KEYS[a], seconds);
+    if (switches > 0) storage_add_counter(SWITCH_KEYS[a], switches);
+    g_checkpointed[a].onMs += (uint64_t)seconds * 1000u;
+    g_checkpointed[a].switches = total.switches;
+  }
+  g_lifetime.checkpoints++;
+}
+
+static void publishLifetime() {
+  for (uint8_t a = 0; a < ACTUATOR_COUNT; a++) {
+    ActuatorTotals total = bootTotal(a);
+    g_lifetime.total[a].onMs = (uint64_t)storage_get_setting(ON_S_KEYS[a]) * 1000u + total.onMs -
+                               g_checkpointed[a].onMs;
+    g_lifetime.total[a].switches = (uint32_t)storage_get_setting(SWITCH_KEYS[a]) + total.switches -
+                                   g_checkpointed[a].switches;
+  }
+  g_publishedLifetime.write(g_lifetime);
+}
+
+void actuator_stats_sample(uint8_t chamber, unsigned long now) {
+  if (chamber >= Config::Chambers::COUNT) return;
+  ChamberStats &cs = g_chambers[chamber];
+  advance(cs, now);
+
+  ActuatorStats stats;
+  stats.on = cs.on;
+  stats.spanMs[STATS_WINDOW_HOUR] = cs.hour.spanMs(now);
+  stats.spanMs[STATS_WINDOW_DAY] = cs.day.spanMs(now);
+  stats.spanMs[STATS_WINDOW_BOOT] = now - cs.startMs;
+  for (uint8_t a = 0; a < ACTUATOR_COUNT; a++) {
+    stats.window[STATS_WINDOW_HOUR][a] = {cs.hour.onTimeMs(a), cs.hour.switches(a)};
+    stats.window[STATS_WINDOW_DAY][a] = {cs.day.onTimeMs(a), cs.day.switches(a)};
+    stats.window[STATS_WINDOW_BOOT][a] = cs.boot[a];
+  }
+  g_published[chamber].write(stats);
+
+  if (chamber != 0) return;
+  unsigned long real = millis();
+  if (real - g_lastCheckpointMs >= CHECKPOINT_INTERVAL_MS) {
+    g_lastCheckpointMs = real;
+    checkpoint();
+  }
+  publishLifetime();
+}
+
+void actuator_stats_read(uint8_t chamber, ActuatorStats *out) {
+  g_published[(chamber < Config::Chambers::COUNT) ? chamber : 0].read(out);
+}
+
+void actuator_stats_lifetime(ActuatorLifetime *out) {
+  g_publishedLifetime.read(out);
+}
+
+float actuator_stats_rated_w(uint8_t actuator) {
+  return (actuator < ACTUATOR_COUNT) ? RATED_W[actuator] : 0.0f;
+}
@@ -0,0 +1,93 @@
+/*
+ * *****************************************************************************
+ * ACTUATOR STATISTICS - ON-TIME, SWITCH-ONS AND ENERGY PER ACTUATOR
+ * *****************************************************************************
+ * Counted as the outputs switch instead of recomputed from the history:
+ * - Every actuator switch of a chamber credits the time since the previous
+ *   one (O(ACTUATOR_COUNT), duty_window.h) and counts a switch-on
+ * - Windows per chamber: last hour (12 x 5 min buckets), last 24 h
+ *   (24 x 1 h buckets, Config::Stats) and since boot, in chamber time
+ * - Lifetime totals are board-wide settings (SETTING_*_ON_S,
+ *   SETTING_*_SWITCHES): every Config::Stats::CHECKPOINT_INTERVAL_MS the
+ *   whole seconds and switch-ons since the last checkpoint are added, and
+ *   the settings store coalesces that into its next write. A reset loses
+ *   at most one interval. Writing a key (/api/settings) sets its total, e.g.
+ *   0 after replacing a heater.
+ * - Energy is on-time x Config::Stats rated power (no current measurement)
+ *
+ * The sample task publishes a copy per chamber through a seqlock, so
+ * /api/stats reads it from any thread.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "channels.h"
+
+enum StatsWindow : uint8_t {
+  STATS_WINDOW_HOUR,
+  STATS_WINDOW_DAY,
+  STATS_WINDOW_BOOT,   ///< Since boot (or since the chamber's first switch)
+  STATS_WINDOW_COUNT
+};
+
+struct ActuatorTotals {
+  uint64_t onMs;
+  uint32_t switches;
+};
+
+/**
+ * @brief Windows of one chamber, actuators in ACTUATOR_BIT_* order
+ */
+struct ActuatorStats {
+  uint8_t on;                                     ///< ACTUATOR_BIT_* mask at publish time
+  uint64_t spanMs[STATS_WINDOW_COUNT];            ///< Time each window covers so far
+  ActuatorTotals window[STATS_WINDOW_COUNT][ACTUATOR_COUNT];
+};
+
+/**
+ * @brief Board-wide lifetime totals (stored + not yet checkpointed)
+ */
+struct ActuatorLifetime {
+  ActuatorTotals total[ACTUATOR_COUNT];
+  uint32_t checkpoints;                           ///< Since boot
+};
+
+/**
+ * @brief An output of `chamber` was set (control side; unchanged states are ignored)
+ *
+ * @param actuatorBit One ACTUATOR_BIT_*
+ * @param now Chamber time
+ */
+void actuator_stats_switch(uint8_t chamber, uint8_t actuatorBit, bool on, unsigned long now);
+
+/**
+ * @brief Bring `chamber`'s windows up to `now` and publish them (sample task)
+ *
+ * Chamber 0's call also publishes the lifetime totals and checkpoints them
+ * when due.
+ */
+void actuator_stats_sample(uint8_t chamber, unsigned long now);
+
+/**
+ * @brief Copy the published windows of a chamber (any thread)
+ */
+void actuator_stats_read(uint8_t chamber, ActuatorStats *out);
+
+/**
+ * @brief Copy the published lifetime totals (any thread)
+ */
+void actuator_stats_lifetime(ActuatorLifetime *out);
+
+/**
+ * @brief Rated power of an actuator in W (Config::Stats)
+ */
+float actuator_stats_rated_w(uint8_t actuator);
+
+/**
+ * @brief Estimated energy in Wh for `onMs` of an actuator
+ */
+inline float actuator_stats_wh(uint8_t actuator, uint64_t onMs) {
+  return (float)((double)onMs / 3600000.0) * actuator_stats_rated_w(actuator);
+}
@@ -0,0 +1,254 @@
+/*
+ * *****************************************************************************
+ * ALARMS IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "alarms.h"
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+#include "channels.h"
+#include "config.h"
+#include "event_log.h"
+#include "fixed_point.h"
+#include "seqlock.h"
+#include "wall_clock.h"
+
+using namespace Config::Alarms;
+
+static_assert(ALARM_RULE_COUNT <= 16, "AlarmStatus::active holds 16 rules");
+static_assert((EDGE_RING & (EDGE_RING - 1)) == 0, "Config::Alarms::EDGE_RING must be a power of two");
+
+// How a rule turns a sample into its measure
+enum AlarmKind : uint8_t {
+  KIND_DISAGREE,        // |series - other|, both valid
+  KIND_ABOVE_SETPOINT,  // series - setpoint
+  KIND_OFF_SETPOINT,    // |series - setpoint|
+  KIND_STALE,           // ms since the last valid, changed reading of series
+  KIND_ON_TOO_LONG      // ms the actuator of series has been on
+};
+
+// Raises when measure > raiseAbove for holdMs, clears when measure <
+// clearBelow for CLEAR_HOLD_MS; in between both timers restart
+struct AlarmRuleDef {
+  AlarmRule rule;
+  const char *name;
+  AlarmKind kind;
+  uint8_t series;
+  uint8_t other;        // KIND_DISAGREE only
+  int32_t raiseAbove;   // Measure units: series fixed point, or ms
+  int32_t clearBelow;
+  unsigned long holdMs;
+};
+
+static constexpr int32_t bandClear(int32_t band) {
+  return band * BAND_CLEAR_PERCENT / 100;
+}
+
+// Registry (index == rule)
+static constexpr AlarmRuleDef RULES[ALARM_RULE_COUNT] = {
+  {ALARM_CO2_DISAGREE, "co2_disagree", KIND_DISAGREE, SERIES_CO2, SERIES_CO2_2,
+   CO2_DISAGREE_PPM, CO2_DISAGREE_CLEAR_PPM, DISAGREE_HOLD_MS},
+  {ALARM_CO2_OUT_OF_BAND, "co2_out_of_band", KIND_ABOVE_SETPOINT, SERIES_CO2, 0,
+   CO2_BAND_PPM, bandClear(CO2_BAND_PPM), OUT_OF_BAND_MS},
+  {ALARM_RH_OUT_OF_BAND, "rh_out_of_band", KIND_OFF_SETPOINT, SERIES_RH, 0,
+   (int32_t)(RH_BAND * 10), bandClear((int32_t)(RH_BAND * 10)), OUT_OF_BAND_MS},
+  {ALARM_TEMP_OUT_OF_BAND, "temp_out_of_band", KIND_OFF_SETPOINT, SERIES_TEMP, 0,
+   (int32_t)(TEMP_BAND * 10), bandClear((int32_t)(TEMP_BAND * 10)), OUT_OF_BAND_MS},
+  {ALARM_CO2_STALE, "co2_stale", KIND_STALE, SERIES_CO2, 0, (int32_t)STALE_MS, (int32_t)CLEAR_HOLD_MS, 0},
+  {ALARM_RH_STALE, "rh_stale", KIND_STALE, SERIES_RH, 0, (int32_t)STALE_MS, (int32_t)CLEAR_HOLD_MS, 0},
+  {ALARM_TEMP_STALE, "temp_stale", KIND_STALE, SERIES_TEMP, 0, (int32_t)STALE_MS, (int32_t)CLEAR_HOLD_MS, 0},
+  {ALARM_HEATER_STUCK_ON, "heater_stuck_on", KIND_ON_TOO_LONG, SERIES_HEATER, 0, (int32_t)HEATER_MAX_ON_MS, 1, 0},
+};
+
+static constexpr size_t nameLength(const char *name) {
+  return (*name == '\0') ? 0 : 1 + nameLength(name + 1);
+}
+
+static constexpr bool rulesInOrder(uint8_t i = 0) {
+  return i >= ALARM_RULE_COUNT ||
+         (RULES[i].rule == i && RULES[i].clearBelow <= RULES[i].raiseAbove &&
+          nameLength(RULES[i].name) <= ALARM_RULE_NAME_MAX && rulesInOrder(i + 1));
+}
+static_assert(rulesInOrder(),
+              "RULES out of sync with AlarmRule, clear level above the raise level, or name over ALARM_RULE_NAME_MAX");
+
+struct RuleState {
+  bool active;
+  bool timing;              // A raise or clear timer runs since `since`
+  unsigned long since;
+  bool seen;                // KIND_STALE / KIND_ON_TOO_LONG: mark is set
+  int16_t lastValue;        // KIND_STALE
+  unsigned long markMs;     // Last fresh reading, or switch-on
+  uint16_t raises;
+};
+
+// Control side
+static RuleState g_state[Config::Chambers::COUNT][ALARM_RULE_COUNT];
+static AlarmStatus g_local[Config::Chambers::COUNT];
+static uint32_t g_edgeSeq = 0;
+
+static SeqLock<AlarmStatus> g_published[Config::Chambers::COUNT];
+static SeqLock<AlarmEdge> g_edges[EDGE_RING];
+static std::atomic<uint32_t> g_newestEdge(0);  // Published after the edge itself
+
+static int32_t setpointOf(const AlarmInputs &in, uint8_t series) {
+  switch (series) {
+    case SERIES_CO2: return in.co2Setpoint;
+    case SERIES_RH: return in.rhSetpoint_x10;
+    case SERIES_TEMP: return in.tempSetpoint_x10;
+    default: return 0;
+  }
+}
+
+// Measure of one rule; false = no verdict this sample (timers hold)
+static bool measure(const AlarmRuleDef &def, RuleState &st, const AlarmInputs &in, unsigned long now,
+                    int32_t *out) {
+  uint8_t bit = (uint8_t)(1u << def.series);
+  int32_t value = (def.series < SENSOR_SERIES_COUNT) ? in.sensors[def.series] : 0;
+  switch (def.kind) {
+    case KIND_DISAGREE: {
+      uint8_t both = bit | (uint8_t)(1u << def.other);
+      if ((in.valid & both) != both) return false;
+      int32_t diff = value - in.sensors[def.other];
+      *out = (diff < 0) ? -diff : diff;
+      return true;
+    }
+    case KIND_ABOVE_SETPOINT:
+      if (!(in.valid & bit)) return false;
+      *out = value - setpointOf(in, def.series);
+      return true;
+    case KIND_OFF_SETPOINT: {
+      if (!(in.valid & bit)) return false;
+      int32_t diff = value - setpointOf(in, def.series);
+      *out = (diff < 0) ? -diff : diff;
+      return true;
+    }
+    case KIND_STALE:
+      if ((in.valid & bit) && (!st.seen || (int16_t)value != st.lastValue)) {
+        st.seen = true;
+        st.lastValue = (int16_t)value;
+        st.markMs = now;
+      }
+      if (!st.seen) return false;
+      *out = (int32_t)(now - st.markMs);
+      return true;
+    case KIND_ON_TOO_LONG: {
+      bool on = in.actuators & series_actuator_bit(def.series);
+      if (on && !st.seen) st.markMs = now;
+      st.seen = on;
+      *out = on ? (int32_t)(now - st.markMs) : 0;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void pushEdge(uint8_t chamber, const AlarmRuleDef &def, bool raised, int32_t value) {
+  bool timed = (def.kind == KIND_STALE || def.kind == KIND_ON_TOO_LONG);
+  AlarmEdge edge;
+  edge.seq = ++g_edgeSeq;
+  edge.epoch = wall_clock_now();
+  edge.chamber = chamber;
+  edge.rule = def.rule;
+  edge.raised = raised;
+  edge.decimals = timed ? 0 : series_decimals(def.series);
+  edge.value = timed ? value / 1000 : value;
+  edge.limit = timed ? def.raiseAbove / 1000 : def.raiseAbove;
+  g_edges[edge.seq & (EDGE_RING - 1)].write(edge);
+  g_newestEdge.store(edge.seq, std::memory_order_release);
+
+  if (raised) {
+    event_log_chamber(chamber, EVT_ALARM_RAISED, def.rule, edge.value, edge.limit);
+  } else {
+    event_log_chamber(chamber, EVT_ALARM_CLEARED, def.rule, edge.value);
+  }
+}
+
+void alarms_sample(uint8_t chamber, const AlarmInputs &in, unsigned long now) {
+  if (chamber >= Config::Chambers::COUNT) return;
+  AlarmStatus &status = g_local[chamber];
+  bool changed = false;
+
+  for (const AlarmRuleDef &def : RULES) {
+    RuleState &st = g_state[chamber][def.rule];
+    int32_t value;
+    if (!measure(def, st, in, now, &value)) continue;
+
+    // Towards the other state: above the raise level while clear, below
+    // the clear level while raised
+    bool toward = st.active ? (value < def.clearBelow) : (value > def.raiseAbove);
+    if (!toward) {
+      st.timing = false;
+      continue;
+    }
+    if (!st.timing) {
+      st.timing = true;
+      st.since = now;
+    }
+    unsigned long hold = st.active ? CLEAR_HOLD_MS : def.holdMs;
+    if (now - st.since < hold) continue;
+
+    st.active = !st.active;
+    st.timing = false;
+    uint16_t bit = (uint16_t)(1u << def.rule);
+    if (st.active) {
+      status.active |= bit;
+      if (st.raises < 0xFFFF) st.raises++;
+      status.raises[def.rule] = st.raises;
+    } else {
+      status.active &= (uint16_t)~bit;
+    }
+    pushEdge(chamber, def, st.active, value);
+    changed = true;
+  }
+  if (changed) g_published[chamber].write(status);
+}
+
+void alarms_status(uint8_t chamber, AlarmStatus *out) {
+  g_published[(chamber < Config::Chambers::COUNT) ? chamber : 0].read(out);
+}
+
+uint32_t alarms_newest_seq() {
+  return g_newestEdge.load(std::memory_order_acquire);
+}
+
+uint32_t alarms_oldest_seq() {
+  uint32_t newest = alarms_newest_seq();
+  if (newest == 0) return 0;
+  return (newest > EDGE_RING) ? newest - EDGE_RING + 1 : 1;
+}
+
+bool alarms_edge(uint32_t seq, AlarmEdge *out) {
+  if (seq == 0 || seq > alarms_newest_seq()) return false;
+  g_edges[seq & (EDGE_RING - 1)].read(out);
+  return out->seq == seq;
+}
+
+const char *alarms_rule_name(uint8_t rule) {
+  return (rule < ALARM_RULE_COUNT) ? RULES[rule].name : "unknown";
+}
+
+static size_t append(char *out, const char *text) {
+  size_t n = strlen(text);
+  memcpy(out, text, n);
+  return n;
+}
+
+size_t alarms_edge_json(char *out, const AlarmEdge &edge) {
+  size_t len = append(out, "{\"seq\":");
+  len += fixed_format(out + len, (int32_t)edge.seq, 0);
+  len += append(out + len, ",\"epoch\":");
+  len += fixed_format(out + len, (int32_t)edge.epoch, 0);
+  len += append(out + len, ",\"chamber\":");
+  len += fixed_format(out + len, edge.chamber, 0);
+  len += append(out + len, ",\"alarm\":\"");
+  len += append(out + len, alarms_rule_name(edge.rule));
+  len += append(out + len, edge.raised ? "\",\"state\":\"raised\",\"value\":" : "\",\"state\":\"cleared\",\"value\":");
+  len += fixed_format(out + len, edge.value, edge.decimals);
+  len += append(out + len, ",\"limit\":");
+  len += fixed_format(out + len, edge.limit, edge.decimals);
+  out[len++] = '}';
+  return len;
+}
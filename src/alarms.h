@@ -0,0 +1,124 @@
+/*
+ * *****************************************************************************
+ * ALARMS - RULE ENGINE ON THE SAMPLE STREAM
+ * *****************************************************************************
+ * A fixed rule table (alarms.cpp, thresholds in Config::Alarms), evaluated
+ * once per history sample of every chamber:
+ * - co2_disagree: main and second CO2 sensor apart by more than
+ *   CO2_DISAGREE_PPM (both readings valid)
+ * - co2/rh/temp_out_of_band: off the setpoint by more than the band for
+ *   OUT_OF_BAND_MS (CO2 only counts above the setpoint)
+ * - co2/rh/temp_stale: no valid, changing reading for STALE_MS, once the
+ *   sensor has delivered one since boot (unwired sensors stay quiet)
+ * - heater_stuck_on: heater on without a break for HEATER_MAX_ON_MS
+ *
+ * Each rule keeps its own timers and state per chamber: it raises once its
+ * condition held for the hold time and clears once the measure stayed below
+ * a lower clear level for CLEAR_HOLD_MS, so a value at the threshold does
+ * not flap. Cost per sample is O(rules), independent of the history length
+ * and of the number of clients.
+ *
+ * Only the edges leave the engine: an event (alarm_raised / alarm_cleared)
+ * and a numbered AlarmEdge in a small ring (Config::Alarms::EDGE_RING), from
+ * which /api/stream (SSE "alarm" events), MQTT (<prefix><id>/alarms) and
+ * /api/alarms read with their own cursors. Control side writes, any thread
+ * reads (seqlocks).
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum AlarmRule : uint8_t {
+  ALARM_CO2_DISAGREE,
+  ALARM_CO2_OUT_OF_BAND,
+  ALARM_RH_OUT_OF_BAND,
+  ALARM_TEMP_OUT_OF_BAND,
+  ALARM_CO2_STALE,
+  ALARM_RH_STALE,
+  ALARM_TEMP_STALE,
+  ALARM_HEATER_STUCK_ON,
+  ALARM_RULE_COUNT
+};
+
+/**
+ * @brief One history sample of a chamber, as the rules see it
+ */
+struct AlarmInputs {
+  const int16_t *sensors;     ///< HistorySeries order
+  uint8_t valid;              ///< Bit n = sensor series n read successfully
+  uint8_t actuators;          ///< ACTUATOR_BIT_* mask
+  uint16_t co2Setpoint;       ///< ppm
+  int16_t rhSetpoint_x10;
+  int16_t tempSetpoint_x10;
+};
+
+/**
+ * @brief Current state of one chamber's rules
+ */
+struct AlarmStatus {
+  uint16_t active;                     ///< Bit n = AlarmRule n raised
+  uint16_t raises[ALARM_RULE_COUNT];   ///< Since boot (saturating)
+};
+
+/**
+ * @brief One raise or clear
+ *
+ * Value and limit are fixed point with `decimals` places: the deviation
+ * and the band for the band rules, seconds for stale and stuck-on.
+ */
+struct AlarmEdge {
+  uint32_t seq;        ///< 1-based, 0 = none
+  uint32_t epoch;      ///< Wall clock (0 = not set)
+  uint8_t chamber;
+  uint8_t rule;        ///< AlarmRule
+  bool raised;
+  uint8_t decimals;
+  int32_t value;
+  int32_t limit;
+};
+
+/// Longest alarms_edge_json() output
+static constexpr size_t ALARM_EDGE_JSON_MAX = 160;
+
+/// Longest alarms_rule_name() (checked against the rule table)
+static constexpr size_t ALARM_RULE_NAME_MAX = 16;
+
+/**
+ * @brief Evaluate all rules for one history sample (sample task)
+ *
+ * @param now Chamber time
+ */
+void alarms_sample(uint8_t chamber, const AlarmInputs &in, unsigned long now);
+
+/**
+ * @brief Copy the published rule state of a chamber (any thread)
+ */
+void alarms_status(uint8_t chamber, AlarmStatus *out);
+
+/**
+ * @brief Newest edge number (0 = none yet) and the oldest one still in the ring
+ */
+uint32_t alarms_newest_seq();
+uint32_t alarms_oldest_seq();
+
+/**
+ * @brief Copy edge `seq` (any thread)
+ *
+ * @return false if it is not in the ring (not yet written or overwritten)
+ */
+bool alarms_edge(uint32_t seq, AlarmEdge *out);
+
+/**
+ * @brief JSON name of a rule (e.g. "heater_stuck_on")
+ */
+const char *alarms_rule_name(uint8_t rule);
+
+/**
+ * @brief {"seq":N,"epoch":T,"chamber":C,"alarm":"...","state":"raised","value":V,"limit":L}
+ *
+ * @return Characters written (no NUL), at most ALARM_EDGE_JSON_MAX
+ */
+size_t alarms_edge_json(char *out, const AlarmEdge &edge);
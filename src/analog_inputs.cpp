@@ -0,0 +1,160 @@
+/*
+ * *****************************************************************************
+ * ANALOG INPUTS IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "analog_inputs.h"
+#include "config.h"
+#include <Arduino_PortentaMachineControl.h>
+#include <Arduino_AdvancedAnalog.h>
+#include <math.h>
+
+// Box-car accumulator in raw ADC counts; 16-bit samples, < 65536 per window
+struct WindowAccumulator {
+  uint32_t sum;
+  uint64_t sumSq;
+  uint16_t min;
+  uint16_t max;
+  uint16_t count;
+};
+
+static_assert((uint64_t)Config::AnalogInputs::SAMPLE_RATE_HZ * Config::AnalogInputs::WINDOW_MS / 1000 < 65535,
+              "Decimation window too long for the 16-bit sample counter");
+
+// A3 = PMC-AI0, A2 = PMC-AI1 (both ADC3, interleaved in one buffer), A1 = PMC-AI2
+static AdvancedADC g_adcAi01(A3, A2);
+static AdvancedADC g_adcAi2(A1);
+
+// Engineering units per volt at the terminal
+static const float UNITS_PER_VOLT[ANALOG_IN_CHANNEL_COUNT] = {
+  Config::AnalogInputs::CO2_PPM_PER_V,
+  Config::AnalogInputs::RH_PERCENT_PER_V,
+  1.0f
+};
+
+static constexpr float VOLTS_PER_COUNT =
+    Config::AnalogInputs::ADC_REFERENCE_V / 65535.0f / Config::AnalogInputs::DIVIDER_RATIO;
+
+// Internal state
+static bool g_running = false;
+static unsigned long g_windowStartMs = 0;
+static uint32_t g_buffers = 0;
+static WindowAccumulator g_acc[ANALOG_IN_CHANNEL_COUNT];
+static AnalogWindow g_windows[ANALOG_IN_CHANNEL_COUNT];
+static bool g_windowValid[ANALOG_IN_CHANNEL_COUNT];
+
+static void resetAccumulator(WindowAccumulator &acc) {
+  acc.sum = 0;
+  acc.sumSq = 0;
+  acc.min = 0xFFFF;
+  acc.max = 0;
+  acc.count = 0;
+}
+
+static inline void accumulate(WindowAccumulator &acc, uint16_t sample) {
+  acc.sum += sample;
+  acc.sumSq += (uint32_t)sample * sample;
+  if (sample < acc.min) acc.min = sample;
+  if (sample > acc.max) acc.max = sample;
+  acc.count++;
+}
+
+// Fold every completed buffer of one ADC; channels are interleaved in scan order
+static void drainAdc(AdvancedADC &adc, uint8_t firstChannel, uint8_t channelCount) {
+  while (adc.available()) {
+    SampleBuffer buf = adc.read();
+    const uint16_t *samples = buf.data();
+    size_t n = buf.size();
+    for (size_t i = 0; i + channelCount <= n; i += channelCount) {
+      for (uint8_t c = 0; c < channelCount; c++) {
+        accumulate(g_acc[firstChannel + c], samples[i + c]);
+      }
+    }
+    buf.release();
+    g_buffers++;
+  }
+}
+
+static void closeWindow(unsigned long now) {
+  for (uint8_t ch = 0; ch < ANALOG_IN_CHANNEL_COUNT; ch++) {
+    WindowAccumulator &acc = g_acc[ch];
+    if (acc.count == 0) continue;  // No DMA data: keep the old window, it ages out
+
+    double n = acc.count;
+    double mean = acc.sum / n;
+    double variance = acc.sumSq / n - mean * mean;
+    if (variance < 0.0) variance = 0.0;
+
+    float scale = VOLTS_PER_COUNT * UNITS_PER_VOLT[ch];
+    AnalogWindow &w = g_windows[ch];
+    w.mean = (float)mean * scale;
+    w.stddev = (float)sqrt(variance) * scale;
+    w.min = acc.min * scale;
+    w.max = acc.max * scale;
+    w.samples = acc.count;
+    w.timestampMs = now;
+    g_windowValid[ch] = true;
+
+    resetAccumulator(acc);
+  }
+  g_windowStartMs = now;
+}
+
+void analog_inputs_init() {
+  for (uint8_t ch = 0; ch < ANALOG_IN_CHANNEL_COUNT; ch++) {
+    resetAccumulator(g_acc[ch]);
+    g_windowValid[ch] = false;
+  }
+  g_buffers = 0;
+  g_running = false;
+  if (Config::SIMULATE_SENSORS) {
+    return;
+  }
+
+  MachineControl_AnalogIn.begin(SensorType::V_0_10);
+  bool ok = g_adcAi01.begin(AN_RESOLUTION_16, Config::AnalogInputs::SAMPLE_RATE_HZ,
+                            Config::AnalogInputs::SAMPLES_PER_BUFFER, Config::AnalogInputs::DMA_BUFFER_COUNT);
+  ok = g_adcAi2.begin(AN_RESOLUTION_16, Config::AnalogInputs::SAMPLE_RATE_HZ,
+                      Config::AnalogInputs::SAMPLES_PER_BUFFER, Config::AnalogInputs::DMA_BUFFER_COUNT) && ok;
+  if (!ok) {
+    Serial.println("Analog inputs: failed to start DMA acquisition!");
+    return;
+  }
+
+  g_running = true;
+  g_windowStartMs = millis();
+  Serial.print("Analog inputs: DMA at ");
+  Serial.print(Config::AnalogInputs::SAMPLE_RATE_HZ);
+  Serial.print(" Hz, ");
+  Serial.print(Config::AnalogInputs::WINDOW_MS);
+  Serial.println(" ms windows");
+}
+
+void analog_inputs_tick(unsigned long now) {
+  if (!g_running) return;
+
+  drainAdc(g_adcAi01, ANALOG_IN_CO2, 2);
+  drainAdc(g_adcAi2, ANALOG_IN_AI2, 1);
+
+  if (now - g_windowStartMs >= Config::AnalogInputs::WINDOW_MS) {
+    closeWindow(now);
+  }
+}
+
+bool analog_inputs_read(AnalogInputChannel channel, float *value) {
+  if (channel >= ANALOG_IN_CHANNEL_COUNT || !g_windowValid[channel]) return false;
+  if (millis() - g_windows[channel].timestampMs > Config::AnalogInputs::MAX_AGE_MS) return false;
+  *value = g_windows[channel].mean;
+  return true;
+}
+
+bool analog_inputs_window(AnalogInputChannel channel, AnalogWindow *out) {
+  if (channel >= ANALOG_IN_CHANNEL_COUNT || !g_windowValid[channel]) return false;
+  *out = g_windows[channel];
+  return true;
+}
+
+uint32_t analog_inputs_buffers() {
+  return g_buffers;
+}
@@ -0,0 +1,79 @@
+/*
+ * *****************************************************************************
+ * ANALOG INPUTS - CONTINUOUS DMA ACQUISITION WITH DECIMATION
+ * *****************************************************************************
+ * Samples the three Machine Control ANALOG IN channels (0-10 V transmitters)
+ * continuously with Arduino_AdvancedAnalog:
+ * - The ADCs are timer-triggered and write into DMA buffers; the CPU takes
+ *   no part in the individual conversions (AI0/AI1 share ADC3, AI2 has its own)
+ * - The drain task only folds completed buffers into per-channel box-car
+ *   accumulators (sum, sum of squares, min, max), one integer add per sample
+ * - Every Config::AnalogInputs::WINDOW_MS a window is closed: mean, standard
+ *   deviation, min and max are scaled to engineering units and published
+ *
+ * The decimated mean feeds the median stage, the noise figures show whether a
+ * transmitter or its wiring picks up interference.
+ *
+ * Inactive while Config::SIMULATE_SENSORS is set.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @brief ANALOG IN channel per transmitter
+ */
+enum AnalogInputChannel : uint8_t {
+  ANALOG_IN_CO2 = 0,   ///< AI0: CO2 transmitter (ppm)
+  ANALOG_IN_RH = 1,    ///< AI1: RH transmitter (%)
+  ANALOG_IN_AI2 = 2,   ///< AI2: spare (V)
+  ANALOG_IN_CHANNEL_COUNT
+};
+
+/**
+ * @brief Statistics of one decimation window, in engineering units
+ */
+struct AnalogWindow {
+  float mean;
+  float stddev;
+  float min;
+  float max;
+  uint16_t samples;          ///< Samples folded into this window
+  unsigned long timestampMs; ///< millis() when the window was closed
+};
+
+/**
+ * @brief Configure the inputs for 0-10 V and start the DMA acquisition
+ */
+void analog_inputs_init();
+
+/**
+ * @brief Fold completed DMA buffers into the window, close it when due (scheduler task)
+ *
+ * @param now millis() of the current scheduler pass
+ */
+void analog_inputs_tick(unsigned long now);
+
+/**
+ * @brief Decimated value of the last closed window
+ *
+ * @param channel AnalogInputChannel
+ * @param value Output, only written if a valid window exists
+ * @return false if there is no window newer than Config::AnalogInputs::MAX_AGE_MS
+ */
+bool analog_inputs_read(AnalogInputChannel channel, float *value);
+
+/**
+ * @brief Full statistics of the last closed window
+ *
+ * @return false if the channel has not closed a window yet
+ */
+bool analog_inputs_window(AnalogInputChannel channel, AnalogWindow *out);
+
+/**
+ * @brief Number of DMA buffers consumed since init (all ADCs)
+ */
+uint32_t analog_inputs_buffers();
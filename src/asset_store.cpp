@@ -0,0 +1,227 @@
+/*
+ * *****************************************************************************
+ * ASSET STORE IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "asset_store.h"
+#include "config.h"
+#include "checksum.h"
+#include "flash_ringbuffer.h"
+
+// Header: first bytes of an asset area, programmed after the data
+struct AssetHeader {
+  uint32_t magic;       // ASSET_MAGIC
+  uint32_t length;
+  uint32_t crc32;       // CRC-32 of the data
+  uint32_t headerCrc;   // CRC-32 over the preceding 12 bytes
+};
+
+static_assert(sizeof(AssetHeader) == 16, "AssetHeader must be exactly 16 bytes");
+
+static constexpr uint32_t ASSET_MAGIC = 0x54534143; // "CAST" little-endian
+static constexpr size_t PAGE_SIZE = 256;            // Program unit of the upload stage
+static constexpr size_t VERIFY_CHUNK = 512;
+
+struct AssetDef {
+  const char *name;
+  const char *contentType;
+  uint32_t capacity;
+};
+
+static const AssetDef ASSET_DEFS[ASSET_COUNT] = {
+  {"chart.js", "application/javascript", Config::ASSET_CHART_JS_MAX_BYTES},
+};
+
+// Internal state
+static bool g_available = false;
+static uint32_t g_eraseSize = 0;
+static uint64_t g_areaStart[ASSET_COUNT];
+static AssetInfo g_info[ASSET_COUNT];   // length 0 = absent
+
+// Running upload
+static AssetId g_uploadId = ASSET_COUNT;
+static uint32_t g_uploadLength = 0;
+static uint32_t g_uploadReceived = 0;
+static uint32_t g_uploadCrc = 0;
+static uint32_t g_uploadProgrammed = 0; // Data bytes already in flash (page aligned)
+static uint8_t g_page[PAGE_SIZE];
+static size_t g_pageFill = 0;
+
+static uint64_t roundUp(uint64_t value, uint64_t unit) {
+  return ((value + unit - 1) / unit) * unit;
+}
+
+// Data starts one erase block into the area
+static uint64_t dataOffset(AssetId id) {
+  return g_areaStart[id] + g_eraseSize;
+}
+
+static bool loadHeader(AssetId id) {
+  AssetHeader header;
+  g_info[id].length = 0;
+  g_info[id].crc32 = 0;
+  if (!fb_asset_read(g_areaStart[id], &header, sizeof(header))) return false;
+  if (header.magic != ASSET_MAGIC || header.length == 0 || header.length > ASSET_DEFS[id].capacity) {
+    return false;
+  }
+  if (checksum_crc32(&header, sizeof(header) - sizeof(header.headerCrc)) != header.headerCrc) {
+    return false;
+  }
+  g_info[id].length = header.length;
+  g_info[id].crc32 = header.crc32;
+  return true;
+}
+
+bool asset_store_init() {
+  g_available = false;
+  g_eraseSize = fb_erase_size();
+  uint32_t programSize = fb_program_size();
+  if (g_eraseSize < PAGE_SIZE || g_eraseSize % PAGE_SIZE != 0 || programSize == 0 ||
+      PAGE_SIZE % programSize != 0 || sizeof(AssetHeader) % programSize != 0) {
+    Serial.println("Asset store: unsupported flash geometry; no local assets");
+    return false;
+  }
+
+  uint64_t regionBytes = 0;
+  for (uint8_t id = 0; id < ASSET_COUNT; id++) {
+    g_areaStart[id] = regionBytes;
+    regionBytes += g_eraseSize + roundUp(ASSET_DEFS[id].capacity, g_eraseSize);
+  }
+  if (!fb_asset_init(regionBytes) || fb_asset_size() < regionBytes) {
+    Serial.println("Asset store: no room for asset region; no local assets");
+    return false;
+  }
+  g_available = true;
+
+  for (uint8_t id = 0; id < ASSET_COUNT; id++) {
+    if (loadHeader((AssetId)id)) {
+      Serial.print("Asset store: ");
+      Serial.print(ASSET_DEFS[id].name);
+      Serial.print(" ");
+      Serial.print(g_info[id].length);
+      Serial.println(" bytes");
+    }
+  }
+  return true;
+}
+
+AssetId asset_store_find(const char *name) {
+  for (uint8_t id = 0; id < ASSET_COUNT; id++) {
+    if (strcmp(name, ASSET_DEFS[id].name) == 0) return (AssetId)id;
+  }
+  return ASSET_COUNT;
+}
+
+const char *asset_store_name(AssetId id) {
+  return (id < ASSET_COUNT) ? ASSET_DEFS[id].name : "";
+}
+
+const char *asset_store_content_type(AssetId id) {
+  return (id < ASSET_COUNT) ? ASSET_DEFS[id].contentType : "application/octet-stream";
+}
+
+uint32_t asset_store_capacity(AssetId id) {
+  return (id < ASSET_COUNT) ? ASSET_DEFS[id].capacity : 0;
+}
+
+bool asset_store_info(AssetId id, AssetInfo *out) {
+  if (!g_available || id >= ASSET_COUNT || g_info[id].length == 0 || id == g_uploadId) return false;
+  *out = g_info[id];
+  return true;
+}
+
+bool asset_store_read(AssetId id, uint32_t offset, void *buffer, size_t len) {
+  if (!g_available || id >= ASSET_COUNT || (uint64_t)offset + len > g_info[id].length) return false;
+  return fb_asset_read(dataOffset(id) + offset, buffer, len);
+}
+
+bool asset_store_begin(AssetId id, uint32_t length) {
+  if (!g_available || id >= ASSET_COUNT || g_uploadId != ASSET_COUNT) return false;
+  if (length == 0 || length > ASSET_DEFS[id].capacity) return false;
+  g_info[id].length = 0; // Gone from here on, even if the erase fails
+  if (!fb_asset_erase(g_areaStart[id], g_eraseSize)) return false;
+
+  g_uploadId = id;
+  g_uploadLength = length;
+  g_uploadReceived = 0;
+  g_uploadCrc = 0;
+  g_uploadProgrammed = 0;
+  g_pageFill = 0;
+  return true;
+}
+
+// Program the staged page, erasing its block first when it starts one
+static bool programPage() {
+  uint64_t offset = dataOffset(g_uploadId) + g_uploadProgrammed;
+  if (g_uploadProgrammed % g_eraseSize == 0 && !fb_asset_erase(offset, g_eraseSize)) return false;
+  if (g_pageFill < PAGE_SIZE) memset(g_page + g_pageFill, 0xFF, PAGE_SIZE - g_pageFill);
+  if (!fb_asset_program(offset, g_page, PAGE_SIZE)) return false;
+  g_uploadProgrammed += PAGE_SIZE;
+  g_pageFill = 0;
+  return true;
+}
+
+bool asset_store_write(const void *data, size_t len) {
+  if (g_uploadId == ASSET_COUNT) return false;
+  if ((uint64_t)g_uploadReceived + len > g_uploadLength) {
+    asset_store_abort();
+    return false;
+  }
+  g_uploadCrc = checksum_crc32_update(g_uploadCrc, data, len);
+  g_uploadReceived += len;
+
+  const uint8_t *p = (const uint8_t *)data;
+  while (len > 0) {
+    size_t n = PAGE_SIZE - g_pageFill;
+    if (n > len) n = len;
+    memcpy(g_page + g_pageFill, p, n);
+    g_pageFill += n;
+    p += n;
+    len -= n;
+    if (g_pageFill == PAGE_SIZE && !programPage()) {
+      asset_store_abort();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool asset_store_finish() {
+  if (g_uploadId == ASSET_COUNT) return false;
+  AssetId id = g_uploadId;
+  if (g_uploadReceived != g_uploadLength || (g_pageFill > 0 && !programPage())) {
+    asset_store_abort();
+    return false;
+  }
+
+  // Read back before the header makes the asset visible
+  uint8_t buffer[VERIFY_CHUNK];
+  uint32_t crc = 0;
+  for (uint32_t offset = 0; offset < g_uploadLength; offset += VERIFY_CHUNK) {
+    size_t n = (g_uploadLength - offset < VERIFY_CHUNK) ? g_uploadLength - offset : VERIFY_CHUNK;
+    if (!fb_asset_read(dataOffset(id) + offset, buffer, n)) {
+      asset_store_abort();
+      return false;
+    }
+    crc = checksum_crc32_update(crc, buffer, n);
+  }
+  if (crc != g_uploadCrc) {
+    asset_store_abort();
+    return false;
+  }
+
+  AssetHeader header;
+  header.magic = ASSET_MAGIC;
+  header.length = g_uploadLength;
+  header.crc32 = g_uploadCrc;
+  header.headerCrc = checksum_crc32(&header, sizeof(header) - sizeof(header.headerCrc));
+  g_uploadId = ASSET_COUNT;
+  if (!fb_asset_program(g_areaStart[id], &header, sizeof(header))) return false;
+  return loadHeader(id);
+}
+
+void asset_store_abort() {
+  g_uploadId = ASSET_COUNT;
+  g_pageFill = 0;
+}
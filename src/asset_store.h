@@ -0,0 +1,101 @@
+/*
+ * *****************************************************************************
+ * ASSET STORE - GZIP WEB ASSETS IN THE QSPI ASSET REGION
+ * *****************************************************************************
+ * Large static files the firmware does not embed (Chart.js), provisioned
+ * once over HTTP and streamed back from flash:
+ * - One area per AssetId: a header erase block followed by the data blocks
+ * - Upload: asset_store_begin() invalidates the header, write() erases each
+ *   data block just before its first page is programmed (one erase per call
+ *   at most), finish() reads the data back against the CRC-32 and only then
+ *   programs the header. An interrupted upload leaves the asset absent.
+ * - The header (length, CRC-32) is cached in RAM at boot; the CRC doubles
+ *   as the ETag
+ *
+ * The data is stored exactly as uploaded (the web server requires gzip).
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+enum AssetId : uint8_t {
+  ASSET_CHART_JS,
+  ASSET_COUNT
+};
+
+/**
+ * @brief A stored asset
+ */
+struct AssetInfo {
+  uint32_t length;  ///< Bytes
+  uint32_t crc32;   ///< CRC-32 of the data
+};
+
+/**
+ * @brief Reserve the asset region and load the headers (call after sample_log_init)
+ *
+ * @return true if the flash asset region is available
+ */
+bool asset_store_init();
+
+/**
+ * @brief Asset by upload/request name ("chart.js"), ASSET_COUNT if unknown
+ */
+AssetId asset_store_find(const char *name);
+
+/**
+ * @brief Name of an asset (as in asset_store_find)
+ */
+const char *asset_store_name(AssetId id);
+
+/**
+ * @brief Content-Type to serve an asset with
+ */
+const char *asset_store_content_type(AssetId id);
+
+/**
+ * @brief Largest accepted upload for an asset (bytes)
+ */
+uint32_t asset_store_capacity(AssetId id);
+
+/**
+ * @brief Length and CRC of a complete asset
+ *
+ * @return false if the asset has never been uploaded (or the upload failed)
+ */
+bool asset_store_info(AssetId id, AssetInfo *out);
+
+/**
+ * @brief Read part of a stored asset
+ */
+bool asset_store_read(AssetId id, uint32_t offset, void *buffer, size_t len);
+
+/**
+ * @brief Start replacing an asset; the old copy is gone from here on
+ *
+ * @param length Exact number of bytes that will follow
+ * @return false if unknown, too large, another upload runs or no flash
+ */
+bool asset_store_begin(AssetId id, uint32_t length);
+
+/**
+ * @brief Append upload data (any length)
+ *
+ * @return false on a flash error or more data than announced (upload aborted)
+ */
+bool asset_store_write(const void *data, size_t len);
+
+/**
+ * @brief Complete the upload: verify and commit the header
+ *
+ * @return false if bytes are missing or the read-back does not match
+ */
+bool asset_store_finish();
+
+/**
+ * @brief Drop a running upload (the asset stays absent)
+ */
+void asset_store_abort();
@@ -0,0 +1,170 @@
+/*
+ * *****************************************************************************
+ * BENCH IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "bench.h"
+
+#if CC_BENCH
+
+#include "checksum.h"
+#include "event_log.h"
+#include "running_filter.h"
+#include "sample_codec.h"
+#include "sensor_history.h"
+#include "web_server.h"
+
+static constexpr uint16_t ITERATIONS = 2000;
+static constexpr uint16_t SERIALIZE_ITERATIONS = 20;
+static constexpr size_t CRC_BLOCK_BYTES = Config::FLASH_SLOT_SIZE_BYTES;
+
+// Keeps results alive so the compiler cannot drop the measured work
+static volatile uint32_t g_sink = 0;
+
+static SensorHistory<7, Config::SENSOR_HISTORY_CAPACITY> g_benchHistory;
+static uint8_t g_crcBlock[CRC_BLOCK_BYTES];
+
+static void report(const char *name, uint32_t iterations, uint32_t elapsedUs) {
+  Serial.print("Bench: ");
+  Serial.print(name);
+  Serial.print(" x");
+  Serial.print(iterations);
+  Serial.print(": ");
+  Serial.print((uint32_t)((uint64_t)elapsedUs * 1000 / iterations));
+  Serial.println(" ns/op");
+}
+
+// Pseudo-random fixed-point sample values without calling random() in the timed loop
+static int16_t sampleValue(uint32_t i) {
+  return (int16_t)(800 + ((i * 2654435761u) >> 24));
+}
+
+static void benchHistory() {
+  int16_t frame[7];
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    for (uint8_t ch = 0; ch < 7; ch++) frame[ch] = sampleValue(i + ch);
+    g_benchHistory.push(frame, (uint8_t)i);
+  }
+  report("history push", ITERATIONS, micros() - start);
+
+  start = micros();
+  for (uint32_t i = 0; i < ITERATIONS / 10; i++) {
+    HistorySnapshot snap = g_benchHistory.snapshot(Config::SENSOR_RING_BUFFER_SIZE);
+    int32_t sum = 0;
+    for (uint8_t ch = 0; ch < 7; ch++) {
+      HistorySpan spans[2];
+      uint8_t n = g_benchHistory.spans(snap, ch, spans);
+      for (uint8_t k = 0; k < n; k++) {
+        for (uint16_t j = 0; j < spans[k].length; j++) sum += spans[k].data[j];
+      }
+    }
+    g_sink += (uint32_t)sum;
+  }
+  report("history snapshot 200x7", ITERATIONS / 10, micros() - start);
+}
+
+static void benchFilter() {
+  RunningFilter<int16_t, Config::MEDIAN_SAMPLE_COUNT> filter;
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    filter.push(sampleValue(i));
+    g_sink += (uint32_t)filter.median();
+  }
+  report("filter push+median", ITERATIONS, micros() - start);
+
+  start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    filter.push(sampleValue(i));
+    g_sink += (uint32_t)filter.hampelMean(Config::Filter::HAMPEL_K);
+  }
+  report("filter push+hampel", ITERATIONS, micros() - start);
+}
+
+static void benchCrc() {
+  for (size_t i = 0; i < CRC_BLOCK_BYTES; i++) g_crcBlock[i] = (uint8_t)(i * 31);
+  uint16_t iterations = ITERATIONS / 10;
+
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < iterations; i++) g_sink += checksum_crc8(g_crcBlock, CRC_BLOCK_BYTES);
+  report("crc8 512 B", iterations, micros() - start);
+
+  start = micros();
+  for (uint16_t i = 0; i < iterations; i++) g_sink += checksum_crc32(g_crcBlock, CRC_BLOCK_BYTES);
+  report("crc32 512 B", iterations, micros() - start);
+
+  start = micros();
+  for (uint16_t i = 0; i < iterations; i++) g_sink += checksum_crc16_modbus(g_crcBlock, CRC_BLOCK_BYTES);
+  report("crc16 512 B", iterations, micros() - start);
+}
+
+static void benchSerialize() {
+  size_t bytes = 0;
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < SERIALIZE_ITERATIONS; i++) bytes = web_server_bench_serialize(nullptr);
+  report("last200 json", SERIALIZE_ITERATIONS, micros() - start);
+  g_sink += bytes;
+
+  start = micros();
+  for (uint16_t i = 0; i < SERIALIZE_ITERATIONS; i++) bytes = web_server_bench_serialize("bin");
+  report("last200 binary", SERIALIZE_ITERATIONS, micros() - start);
+  g_sink += bytes;
+
+  start = micros();
+  for (uint16_t i = 0; i < SERIALIZE_ITERATIONS; i++) bytes = web_server_bench_serialize("packed");
+  report("last200 packed", SERIALIZE_ITERATIONS, micros() - start);
+  g_sink += bytes;
+}
+
+static void benchCodec() {
+  SampleRecord records[Config::SAMPLE_LOG_BLOCK_SAMPLES];
+  int16_t frame[7];
+  for (uint8_t i = 0; i < Config::SAMPLE_LOG_BLOCK_SAMPLES; i++) {
+    for (uint8_t ch = 0; ch < 7; ch++) frame[ch] = sampleValue(i + ch) / 8;
+    sample_log_encode(frame, i, &records[i]);
+  }
+  static uint8_t packed[sample_codec_max_bytes(Config::SAMPLE_LOG_BLOCK_SAMPLES)];
+  uint16_t iterations = ITERATIONS / 10;
+
+  size_t bytes = 0;
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < iterations; i++) {
+    bytes = sample_codec_encode(records, Config::SAMPLE_LOG_BLOCK_SAMPLES, packed, sizeof(packed));
+  }
+  report("codec encode block", iterations, micros() - start);
+  g_sink += bytes;
+
+  start = micros();
+  for (uint16_t i = 0; i < iterations; i++) {
+    g_sink += sample_codec_decode(packed, bytes, records, Config::SAMPLE_LOG_BLOCK_SAMPLES);
+  }
+  report("codec decode block", iterations, micros() - start);
+}
+
+static void benchEventLog() {
+  // Writes into the live ring: the drain reports these as dropped once
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) event_log_record(EVT_MEASURE_RESULT, i, i, i);
+  report("event record", ITERATIONS, micros() - start);
+
+  EventRecord record;
+  char line[96];
+  event_log_read(event_log_newest_seq(), &record);
+  start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) g_sink += event_log_format(record, line, sizeof(line));
+  report("event format", ITERATIONS, micros() - start);
+}
+
+void bench_run() {
+  Serial.println("Bench: running...");
+  benchHistory();
+  benchFilter();
+  benchCrc();
+  benchCodec();
+  benchSerialize();
+  benchEventLog();
+  Serial.println("Bench: done");
+}
+
+#endif // CC_BENCH
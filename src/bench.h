@@ -0,0 +1,31 @@
+/*
+ * *****************************************************************************
+ * BENCH - MICRO-BENCHMARKS
+ * *****************************************************************************
+ * Times the building blocks of the hot paths and prints one line per
+ * benchmark (iterations, ns per operation):
+ * - History ring push and snapshot/span walk (sensor_history.h)
+ * - Streaming filter push + median / Hampel (running_filter.h)
+ * - CRC-8, CRC-32, CRC-16 over a 512-byte settings slot (checksum.h)
+ * - Serialization of the /api/last200 window, JSON and binary
+ * - Event log record + formatting (event_log.h)
+ *
+ * Only built with -DCC_BENCH=1; bench_run() is called once in setup(), after
+ * the controller is initialized and before the scheduler starts. env:native
+ * also sets the flag and runs it from test/test_bench on the host CPU.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+#if CC_BENCH
+/**
+ * @brief Run all benchmarks and print the results to Serial (blocks ~1 s)
+ */
+void bench_run();
+#else
+inline void bench_run() {}
+#endif
@@ -0,0 +1,482 @@
+/*
+ * *****************************************************************************
+ * CAN LINK IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "can_link.h"
+#include "config.h"
+
+#if CC_CAN
+
+#include <Arduino_PortentaMachineControl.h>
+#include "checksum.h"
+#include "controller.h"
+#include "event_log.h"
+#include "storage.h"
+
+static constexpr bool GATEWAY = (Config::Can::ROLE == Config::Can::ROLE_GATEWAY);
+static constexpr uint8_t NODE_ID = Config::Can::NODE_ID;
+static constexpr uint8_t TX_MASK = Config::Can::TX_QUEUE_SIZE - 1;
+
+static_assert((Config::Can::TX_QUEUE_SIZE & TX_MASK) == 0 && Config::Can::TX_QUEUE_SIZE <= 128,
+              "Config::Can::TX_QUEUE_SIZE must be a power of two up to 128");
+static_assert(Config::Can::BITRATE_KBPS == 125 || Config::Can::BITRATE_KBPS == 250 ||
+              Config::Can::BITRATE_KBPS == 500 || Config::Can::BITRATE_KBPS == 1000,
+              "Config::Can::BITRATE_KBPS must be 125, 250, 500 or 1000");
+static_assert(sizeof(SampleRecord) == 16, "Sample frames carry the record in two 8-byte halves");
+static_assert(SETTING_COUNT <= 255, "Setting batches count keys in one byte");
+
+// Frame types (identifier bits 28..24), lowest first in arbitration
+static constexpr uint8_t TYPE_SETTING = 0x02;    // Gateway -> node: [index, count, key, 0, raw i32]
+static constexpr uint8_t TYPE_ACK = 0x03;        // Node -> gateway: [count, CanAckStatus], part = tag
+static constexpr uint8_t TYPE_SAMPLE = 0x10;     // Part 0: [seq u32, interval u16, chambers, 0],
+                                                 // parts 1, 2: SampleRecord bytes 0..7, 8..15
+static constexpr uint8_t TYPE_SETPOINTS = 0x11;  // [co2 u16, rh x10 i16, temp x10 i16]
+
+static constexpr uint8_t SAMPLE_PARTS = 3;
+static constexpr uint8_t SAMPLE_PARTS_DONE = (1 << SAMPLE_PARTS) - 1;
+static constexpr uint8_t SETPOINTS_LEN = 6;
+
+// Acceptance filter of a node: its own setting frames only
+static constexpr uint32_t FILTER_MASK = 0x1FFF0000;
+static constexpr uint32_t NODE_FILTER = ((uint32_t)TYPE_SETTING << 24) | ((uint32_t)NODE_ID << 16);
+
+struct CanFrame {
+  uint32_t id;       // 29-bit identifier
+  uint8_t len;
+  uint8_t data[8];
+};
+
+static CanLinkStatus g_status = {};
+static bool g_ready = false;
+static unsigned long g_nowMs = 0;
+
+static uint32_t frameId(uint8_t type, uint8_t node, uint8_t chamber, uint8_t part) {
+  return ((uint32_t)type << 24) | ((uint32_t)node << 16) | ((uint32_t)chamber << 8) | part;
+}
+
+static void putU16(uint8_t *out, uint16_t value) {
+  out[0] = (uint8_t)value;
+  out[1] = (uint8_t)(value >> 8);
+}
+
+static void putU32(uint8_t *out, uint32_t value) {
+  putU16(out, (uint16_t)value);
+  putU16(out + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t getU16(const uint8_t *in) {
+  return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t *in) {
+  return getU16(in) | ((uint32_t)getU16(in + 2) << 16);
+}
+
+static void receiveFrame(const CanFrame &frame);
+
+// --- Transmit queue (drained into the controller's mailboxes) ---
+
+static CanFrame g_tx[Config::Can::TX_QUEUE_SIZE];
+static uint8_t g_txHead = 0;  // Free-running, masked on access
+static uint8_t g_txTail = 0;
+
+static uint8_t txFree() {
+  return Config::Can::TX_QUEUE_SIZE - (uint8_t)(g_txHead - g_txTail);
+}
+
+// The gateway sees its own broadcasts too (CAN does not echo them back)
+static void txPush(const CanFrame &frame) {
+  g_tx[g_txHead & TX_MASK] = frame;
+  g_txHead++;
+  if (GATEWAY && (frame.id >> 24) != TYPE_SETTING) receiveFrame(frame);
+}
+
+static void flushTx() {
+  for (uint8_t i = 0; i < Config::Can::TX_FRAMES_PER_TICK && g_txTail != g_txHead; i++) {
+    const CanFrame &frame = g_tx[g_txTail & TX_MASK];
+    CanMsg msg(CanExtendedId(frame.id), frame.len, frame.data);
+    if (MachineControl_CANComm.write(msg) <= 0) {
+      g_status.txRetries++; // Mailboxes full or bus off: same frame next tick
+      return;
+    }
+    g_txTail++;
+    g_status.txFrames++;
+  }
+}
+
+// --- Node side: broadcast own chambers ---
+
+struct BroadcastState {
+  uint32_t sentSeq;
+  bool setpointsSent;
+  unsigned long setpointsMs;
+  uint8_t setpoints[SETPOINTS_LEN];
+};
+
+static BroadcastState g_broadcast[Config::Chambers::COUNT] = {};
+
+static void broadcastSample(uint8_t chamber, uint32_t seq) {
+  int16_t frame[SERIES_COUNT];
+  SampleRecord record;
+  controller_history_frame(chamber, seq, frame);
+  sample_log_encode(frame, controller_history_actuators(chamber, seq), &record);
+  const uint8_t *bytes = (const uint8_t *)&record;
+
+  unsigned long interval = controller_get_sample_interval_ms();
+  CanFrame header = {frameId(TYPE_SAMPLE, NODE_ID, chamber, 0), 8, {}};
+  putU32(header.data, seq);
+  putU16(header.data + 4, (uint16_t)(interval < 0xFFFF ? interval : 0xFFFF));
+  header.data[6] = Config::Chambers::COUNT;
+  txPush(header);
+
+  for (uint8_t part = 1; part < SAMPLE_PARTS; part++) {
+    CanFrame half = {frameId(TYPE_SAMPLE, NODE_ID, chamber, part), 8, {}};
+    memcpy(half.data, bytes + (part - 1) * 8, 8);
+    txPush(half);
+  }
+}
+
+static void broadcastChamber(uint8_t chamber, unsigned long now) {
+  BroadcastState &state = g_broadcast[chamber];
+
+  // Only the newest sample: the bus carries the present, /api/log the past
+  uint32_t seq = controller_get_sample_seq(chamber);
+  if (seq != 0 && seq != state.sentSeq) {
+    if (txFree() >= SAMPLE_PARTS) {
+      broadcastSample(chamber, seq);
+    } else {
+      g_status.txDropped += SAMPLE_PARTS;
+    }
+    state.sentSeq = seq;
+  }
+
+  ControllerSnapshot snapshot;
+  controller_snapshot(chamber, &snapshot);
+  uint8_t setpoints[SETPOINTS_LEN];
+  putU16(setpoints, snapshot.co2_setpoint);
+  putU16(setpoints + 2, (uint16_t)snapshot.rh_setpoint_x10);
+  putU16(setpoints + 4, (uint16_t)snapshot.temp_setpoint_x10);
+  bool changed = !state.setpointsSent || memcmp(setpoints, state.setpoints, SETPOINTS_LEN) != 0;
+  if (!changed && now - state.setpointsMs < Config::Can::SETPOINT_REFRESH_MS) return;
+  if (txFree() == 0) {
+    g_status.txDropped++;
+    return;
+  }
+  CanFrame frame = {frameId(TYPE_SETPOINTS, NODE_ID, chamber, 0), SETPOINTS_LEN, {}};
+  memcpy(frame.data, setpoints, SETPOINTS_LEN);
+  txPush(frame);
+  memcpy(state.setpoints, setpoints, SETPOINTS_LEN);
+  state.setpointsSent = true;
+  state.setpointsMs = now;
+}
+
+// --- Node side: setting batches addressed to this node ---
+
+struct PendingBatch {
+  bool active;
+  uint8_t tag;
+  uint8_t chamber;
+  uint8_t count;
+  uint8_t received;
+  ControlCommand commands[SETTING_COUNT];
+};
+
+static PendingBatch g_batch = {};
+
+static void dropBatch() {
+  if (g_batch.active) event_log(EVT_CAN_BATCH_DROPPED, g_batch.tag, g_batch.received);
+  g_batch.active = false;
+}
+
+static bool rawInRange(SettingKey key, int32_t raw) {
+  return storage_setting_from_float(key, storage_setting_to_float(key, raw)) == raw;
+}
+
+static uint8_t applyBatch() {
+  if (g_batch.chamber >= Config::Chambers::COUNT) return CAN_ACK_INVALID;
+  for (uint8_t i = 0; i < g_batch.count; i++) {
+    SettingKey key = g_batch.commands[i].key;
+    if (key == SETTING_COUNTER || key >= SETTING_COUNT || !rawInRange(key, g_batch.commands[i].raw)) {
+      return CAN_ACK_INVALID;
+    }
+    for (uint8_t j = 0; j < i; j++) {
+      if (g_batch.commands[j].key == key) return CAN_ACK_INVALID;
+    }
+  }
+  if (!control_link_post_batch(g_batch.commands, g_batch.count)) return CAN_ACK_BUSY;
+  g_status.batches++;
+  event_log_chamber(g_batch.chamber, EVT_CAN_SETTINGS_BATCH, g_batch.count, g_batch.tag);
+  return CAN_ACK_OK;
+}
+
+static void handleSettingFrame(uint8_t chamber, uint8_t tag, const CanFrame &frame) {
+  uint8_t index = frame.data[0];
+  uint8_t count = frame.data[1];
+  if (frame.len != 8 || count == 0 || count > SETTING_COUNT || index >= count) {
+    g_status.rxInvalid++;
+    return;
+  }
+  if (index == 0) {
+    dropBatch(); // A new batch replaces one that never completed
+    g_batch.active = true;
+    g_batch.tag = tag;
+    g_batch.chamber = chamber;
+    g_batch.count = count;
+    g_batch.received = 0;
+  } else if (!g_batch.active || tag != g_batch.tag || chamber != g_batch.chamber ||
+             count != g_batch.count || index != g_batch.received) {
+    g_status.rxInvalid++;
+    dropBatch();
+    return;
+  }
+
+  ControlCommand &command = g_batch.commands[index];
+  command.chamber = chamber;
+  command.key = (SettingKey)frame.data[2];
+  command.raw = (int32_t)getU32(frame.data + 4);
+  if (++g_batch.received < count) return;
+
+  g_batch.active = false;
+  uint8_t status = applyBatch();
+  if (txFree() == 0) {
+    g_status.txDropped++;
+    return;
+  }
+  CanFrame ack = {frameId(TYPE_ACK, NODE_ID, chamber, tag), 2, {count, status}};
+  txPush(ack);
+}
+
+// --- Gateway side: what every node last sent ---
+
+struct ChamberState {
+  CanChamberInfo info;
+  uint32_t pendingSeq;                      // Sample being reassembled
+  uint8_t pendingParts;                     // Bit per received part
+  uint8_t pending[sizeof(SampleRecord)];
+};
+
+struct NodeState {
+  bool known;
+  bool online;
+  unsigned long lastMs;
+  uint8_t chambers;
+  uint16_t sampleIntervalMs;
+  uint8_t ackTag;
+  uint8_t ackStatus;
+  ChamberState chamber[Config::Chambers::MAX_COUNT];
+};
+
+static constexpr uint8_t NODE_SLOTS = GATEWAY ? Config::Can::MAX_NODES : 1;
+static NodeState g_nodes[NODE_SLOTS] = {};
+static uint8_t g_nextTag = 1;
+
+static void handleSamplePart(NodeState &node, ChamberState &state, uint8_t part, const CanFrame &frame) {
+  if (frame.len != 8 || part >= SAMPLE_PARTS) {
+    g_status.rxInvalid++;
+    return;
+  }
+  if (part == 0) {
+    state.pendingSeq = getU32(frame.data);
+    state.pendingParts = 1;
+    node.sampleIntervalMs = getU16(frame.data + 4);
+    node.chambers = frame.data[6];
+    return;
+  }
+  if ((state.pendingParts & 1) == 0) {
+    g_status.rxInvalid++; // Half of a sample whose header was lost
+    return;
+  }
+  memcpy(state.pending + (part - 1) * 8, frame.data, 8);
+  state.pendingParts |= (uint8_t)(1 << part);
+  if (state.pendingParts != SAMPLE_PARTS_DONE) return;
+
+  state.pendingParts = 0;
+  if (checksum_crc8(state.pending, sizeof(SampleRecord) - 1) != state.pending[sizeof(SampleRecord) - 1]) {
+    g_status.rxInvalid++;
+    return;
+  }
+  memcpy(&state.info.record, state.pending, sizeof(SampleRecord));
+  state.info.seq = state.pendingSeq;
+  state.info.hasSample = true;
+}
+
+static void receiveGatewayFrame(uint8_t type, uint8_t nodeId, uint8_t chamber, uint8_t part,
+                                const CanFrame &frame) {
+  if (nodeId >= NODE_SLOTS || chamber >= Config::Chambers::MAX_COUNT) {
+    g_status.rxInvalid++;
+    return;
+  }
+  NodeState &node = g_nodes[nodeId];
+  node.known = true;
+  node.lastMs = g_nowMs;
+  if (!node.online) {
+    node.online = true;
+    event_log(EVT_CAN_NODE_ONLINE, nodeId);
+  }
+
+  ChamberState &state = node.chamber[chamber];
+  switch (type) {
+    case TYPE_SAMPLE:
+      handleSamplePart(node, state, part, frame);
+      break;
+
+    case TYPE_SETPOINTS:
+      if (frame.len != SETPOINTS_LEN) {
+        g_status.rxInvalid++;
+        break;
+      }
+      state.info.co2Setpoint = getU16(frame.data);
+      state.info.rhSetpoint_x10 = (int16_t)getU16(frame.data + 2);
+      state.info.tempSetpoint_x10 = (int16_t)getU16(frame.data + 4);
+      state.info.hasSetpoints = true;
+      break;
+
+    case TYPE_ACK:
+      if (frame.len != 2) {
+        g_status.rxInvalid++;
+        break;
+      }
+      node.ackTag = part;
+      node.ackStatus = frame.data[1];
+      break;
+
+    default:
+      g_status.rxInvalid++;
+      break;
+  }
+}
+
+static void receiveFrame(const CanFrame &frame) {
+  uint8_t type = (uint8_t)((frame.id >> 24) & 0x1F);
+  uint8_t node = (uint8_t)(frame.id >> 16);
+  uint8_t chamber = (uint8_t)(frame.id >> 8);
+  uint8_t part = (uint8_t)frame.id;
+
+  if (type == TYPE_SETTING) {
+    if (node == NODE_ID) handleSettingFrame(chamber, part, frame);
+    return;
+  }
+  if (GATEWAY) receiveGatewayFrame(type, node, chamber, part, frame);
+}
+
+static void checkTimeouts(unsigned long now) {
+  for (uint8_t id = 0; id < NODE_SLOTS; id++) {
+    NodeState &node = g_nodes[id];
+    if (node.online && now - node.lastMs > Config::Can::NODE_TIMEOUT_MS) {
+      node.online = false;
+      event_log(EVT_CAN_NODE_LOST, id, (int32_t)(now - node.lastMs));
+    }
+  }
+}
+
+// --- Public API ---
+
+static CanBitRate bitRate() {
+  switch (Config::Can::BITRATE_KBPS) {
+    case 125: return CanBitRate::BR_125k;
+    case 250: return CanBitRate::BR_250k;
+    case 1000: return CanBitRate::BR_1000k;
+    default: return CanBitRate::BR_500k;
+  }
+}
+
+void can_link_init() {
+  g_ready = MachineControl_CANComm.begin(bitRate());
+  Serial.print(F("CAN: "));
+  if (!g_ready) {
+    Serial.println(F("controller start failed, fleet link off"));
+    return;
+  }
+  Serial.print(GATEWAY ? F("gateway") : F("node"));
+  Serial.print(F(" "));
+  Serial.print(NODE_ID);
+  Serial.print(F(" at "));
+  Serial.print(Config::Can::BITRATE_KBPS);
+  Serial.println(F(" kbit/s"));
+}
+
+void can_link_tick(unsigned long now) {
+  if (!g_ready) return;
+  g_nowMs = now;
+
+  for (uint8_t i = 0; i < Config::Can::RX_FRAMES_PER_TICK && MachineControl_CANComm.available() > 0; i++) {
+    CanMsg msg = MachineControl_CANComm.read();
+    uint32_t id = msg.isExtendedId() ? msg.getExtendedId() : 0;
+    // The library has no acceptance filter API: the id/mask pair is applied here
+    if (!msg.isExtendedId() || (!GATEWAY && (id & FILTER_MASK) != NODE_FILTER)) {
+      g_status.rxFiltered++;
+      continue;
+    }
+    CanFrame frame;
+    frame.id = id;
+    frame.len = msg.data_length;
+    memcpy(frame.data, msg.data, sizeof(frame.data));
+    g_status.rxFrames++;
+    receiveFrame(frame);
+  }
+
+  for (uint8_t chamber = 0; chamber < Config::Chambers::COUNT; chamber++) {
+    broadcastChamber(chamber, now);
+  }
+  if (GATEWAY) checkTimeouts(now);
+  flushTx();
+}
+
+void can_link_status(CanLinkStatus *out) {
+  *out = g_status;
+}
+
+bool can_link_is_gateway() {
+  return GATEWAY;
+}
+
+bool can_link_node(uint8_t node, CanNodeInfo *out) {
+  if (!GATEWAY || node >= NODE_SLOTS || !g_nodes[node].known) return false;
+  const NodeState &state = g_nodes[node];
+  out->online = state.online;
+  out->ageMs = g_nowMs - state.lastMs;
+  out->chambers = state.chambers;
+  out->sampleIntervalMs = state.sampleIntervalMs;
+  out->ackTag = state.ackTag;
+  out->ackStatus = state.ackStatus;
+  return true;
+}
+
+bool can_link_chamber(uint8_t node, uint8_t chamber, CanChamberInfo *out) {
+  if (!GATEWAY || node >= NODE_SLOTS || !g_nodes[node].known || chamber >= Config::Chambers::MAX_COUNT) {
+    return false;
+  }
+  *out = g_nodes[node].chamber[chamber].info;
+  return true;
+}
+
+bool can_link_send_settings(uint8_t node, uint8_t chamber, const ControlCommand *commands, uint8_t count,
+                            uint8_t *tag) {
+  if (!GATEWAY || count == 0 || count > SETTING_COUNT) return false;
+  *tag = g_nextTag;
+
+  if (node == NODE_ID) {
+    // Own chambers: no bus round trip
+    ControlCommand local[SETTING_COUNT];
+    for (uint8_t i = 0; i < count; i++) {
+      local[i] = commands[i];
+      local[i].chamber = chamber;
+    }
+    if (!control_link_post_batch(local, count)) return false;
+    g_nodes[node].ackTag = *tag;
+    g_nodes[node].ackStatus = CAN_ACK_OK;
+  } else {
+    if (txFree() < count) return false;
+    for (uint8_t i = 0; i < count; i++) {
+      CanFrame frame = {frameId(TYPE_SETTING, node, chamber, *tag), 8, {i, count, (uint8_t)commands[i].key, 0}};
+      putU32(frame.data + 4, (uint32_t)commands[i].raw);
+      txPush(frame);
+    }
+  }
+  g_nextTag = (g_nextTag == 255) ? 1 : g_nextTag + 1;
+  return true;
+}
+
+#endif // CC_CAN
@@ -0,0 +1,124 @@
+/*
+ * *****************************************************************************
+ * CAN LINK - FLEET TELEMETRY AND SETPOINT DISTRIBUTION
+ * *****************************************************************************
+ * Several chambers on one CAN bus (Machine Control CAN port, CC_CAN=1):
+ * - Every node broadcasts each new sample of each chamber as three 8-byte
+ *   frames (sample number + the 16-byte SampleRecord of sample_log.h, CRC
+ *   included), and its setpoints on change or every SETPOINT_REFRESH_MS,
+ *   which doubles as the heartbeat
+ * - The gateway (Config::Can::ROLE_GATEWAY) collects every node, its own
+ *   chambers included, for GET /api/fleet, and forwards setting batches
+ *   (POST /api/fleet/setpoints) to one node's chamber
+ * - A node applies a batch only when all of its frames arrived, through
+ *   control_link_post_batch() like a local POST /api/setpoints, and answers
+ *   with an acknowledgement frame
+ *
+ * 29-bit identifiers: type << 24 | node << 16 | chamber << 8 | part. A
+ * lower type wins arbitration, so setting batches overtake telemetry. Nodes
+ * keep only frames matching SETTING << 24 | NODE_ID << 16 (mask 0x1FFF0000);
+ * the gateway keeps everything.
+ *
+ * Network side only (same thread as web_server_handle()): received settings
+ * go through control_link, whose producer must be a single thread.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "control_link.h"
+#include "sample_log.h"
+
+/**
+ * @brief Bus counters
+ */
+struct CanLinkStatus {
+  uint32_t txFrames;     ///< Frames handed to the controller
+  uint32_t txRetries;    ///< Writes refused (mailboxes full, bus off), retried next tick
+  uint32_t txDropped;    ///< Frames not queued: transmit queue full
+  uint32_t rxFrames;     ///< Frames accepted by the filter
+  uint32_t rxFiltered;   ///< Frames for other nodes, discarded
+  uint32_t rxInvalid;    ///< Malformed frames, record CRC mismatches
+  uint32_t batches;      ///< Setting batches applied on this node
+};
+
+/**
+ * @brief What the gateway knows of one node
+ */
+struct CanNodeInfo {
+  bool online;                 ///< Heard from within Config::Can::NODE_TIMEOUT_MS
+  unsigned long ageMs;         ///< Since its last frame
+  uint8_t chambers;            ///< Chambers it reports
+  uint16_t sampleIntervalMs;   ///< Its sample period
+  uint8_t ackTag;              ///< Last acknowledged setting batch (0 = none yet)
+  uint8_t ackStatus;           ///< CAN_ACK_* of that batch
+};
+
+/**
+ * @brief One chamber of a node, as last broadcast
+ */
+struct CanChamberInfo {
+  bool hasSample;        ///< record/seq are valid
+  uint32_t seq;          ///< Sample number on the node
+  SampleRecord record;   ///< Sample values (sample_log.h encoding)
+  bool hasSetpoints;
+  uint16_t co2Setpoint;  ///< ppm
+  int16_t rhSetpoint_x10;
+  int16_t tempSetpoint_x10;
+};
+
+/// Result of a setting batch, as acknowledged by the node
+enum CanAckStatus : uint8_t {
+  CAN_ACK_OK = 0,        ///< Queued for the node's controller
+  CAN_ACK_BUSY = 1,      ///< Command queue full, send again
+  CAN_ACK_INVALID = 2    ///< Unknown chamber/key or value out of range
+};
+
+/**
+ * @brief Start the CAN controller (call once, before the network side runs)
+ */
+void can_link_init();
+
+/**
+ * @brief Broadcast new samples, send queued frames, process received ones (network side)
+ */
+void can_link_tick(unsigned long now);
+
+/**
+ * @brief Copy the bus counters
+ */
+void can_link_status(CanLinkStatus *out);
+
+/**
+ * @brief true if this board runs as the gateway
+ */
+bool can_link_is_gateway();
+
+/**
+ * @brief State of one node (gateway only)
+ *
+ * @return false if the node was never heard of (or this is no gateway)
+ */
+bool can_link_node(uint8_t node, CanNodeInfo *out);
+
+/**
+ * @brief Last broadcast of one chamber of a node (gateway only)
+ *
+ * @return false if the node or chamber is unknown
+ */
+bool can_link_chamber(uint8_t node, uint8_t chamber, CanChamberInfo *out);
+
+/**
+ * @brief Send a setting batch to one chamber of a node (gateway only)
+ *
+ * For the gateway's own node id the batch goes straight to control_link.
+ * The node's answer shows up as CanNodeInfo::ackTag / ackStatus.
+ *
+ * @param commands Validated settings (chamber field ignored)
+ * @param tag      Set to the batch tag the acknowledgement will carry
+ * @return false if the transmit queue (or command queue) has no room
+ */
+bool can_link_send_settings(uint8_t node, uint8_t chamber, const ControlCommand *commands, uint8_t count,
+                            uint8_t *tag);
@@ -0,0 +1,67 @@
+/*
+ * *****************************************************************************
+ * CHAMBER CLOCK IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "chamber_clock.h"
+#include "config.h"
+
+static constexpr uint8_t MODE = Config::Clock::MODE;
+
+// Internal state
+static unsigned long g_now = 0;      // Latched chamber time
+static unsigned long g_latchMs = 0;  // millis() when g_now was latched
+static uint64_t g_chamberUs = 0;     // MODE_SCALED accumulator
+static uint32_t g_lastMicros = 0;
+
+void chamber_clock_init() {
+  g_now = millis();
+  g_latchMs = g_now;
+  g_chamberUs = (uint64_t)g_now * 1000;
+  g_lastMicros = micros();
+}
+
+void chamber_clock_tick(unsigned long now) {
+  g_latchMs = now;
+  switch (MODE) {
+    case Config::Clock::MODE_SCALED: {
+      // micros() wraps after ~71 min; the difference stays correct as long
+      // as the clock ticks more often than that
+      uint32_t us = micros();
+      g_chamberUs += (uint64_t)(uint32_t)(us - g_lastMicros) * Config::SPEEDUP_FACTOR;
+      g_lastMicros = us;
+      g_now = (unsigned long)(g_chamberUs / 1000);
+      break;
+    }
+    case Config::Clock::MODE_STEP:
+      g_now += Config::Clock::STEP_MS;
+      break;
+    default:
+      g_now = now;
+      break;
+  }
+}
+
+unsigned long chamber_clock_now() {
+  return g_now;
+}
+
+unsigned long chamber_clock_due_ms(unsigned long chamberMs) {
+  long ahead = (long)(chamberMs - g_now);
+  if (ahead <= 0 || MODE == Config::Clock::MODE_STEP) return g_latchMs;
+  if (MODE == Config::Clock::MODE_SCALED) {
+    return g_latchMs + ((unsigned long)ahead + Config::SPEEDUP_FACTOR - 1) / Config::SPEEDUP_FACTOR;
+  }
+  return chamberMs;
+}
+
+unsigned long chamber_clock_wall_ms(unsigned long chamberMs) {
+  if (MODE != Config::Clock::MODE_SCALED || chamberMs == 0) return chamberMs;
+  unsigned long wall = chamberMs / Config::SPEEDUP_FACTOR;
+  return (wall == 0) ? 1 : wall;
+}
+
+uint16_t chamber_clock_speedup() {
+  return (MODE == Config::Clock::MODE_SCALED) ? Config::SPEEDUP_FACTOR : 1;
+}
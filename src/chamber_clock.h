@@ -0,0 +1,68 @@
+/*
+ * *****************************************************************************
+ * CHAMBER CLOCK - TIME BASE OF THE CONTROL STATE MACHINES
+ * *****************************************************************************
+ * All controller durations (swirl, settle, lockouts, baseline interval,
+ * sample periods) are compared in chamber time, never divided or clamped:
+ * - MODE_REAL: chamber time is millis() (hardware)
+ * - MODE_SCALED: chamber time runs Config::SPEEDUP_FACTOR times faster than
+ *   real time, accumulated from micros() so even 1000x keeps 1 ms resolution
+ * - MODE_STEP: every control pass advances chamber time by
+ *   Config::Clock::STEP_MS, the control tasks run on every scheduler pass;
+ *   a soak test of hours of chamber operation takes seconds
+ *
+ * The clock task runs first in every pass that runs a control task (its
+ * next deadline is the earliest controller deadline) and latches the time
+ * for all control tasks of that pass (like the scheduler's single millis()).
+ * Chamber time wraps like millis(); compare with differences only.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @brief Start the chamber clock at the current real time (call before controller_init)
+ */
+void chamber_clock_init();
+
+/**
+ * @brief Advance and latch the chamber time (first control task of a pass)
+ *
+ * @param now millis() of the current scheduler pass
+ */
+void chamber_clock_tick(unsigned long now);
+
+/**
+ * @brief Chamber time of the current pass (ms)
+ */
+unsigned long chamber_clock_now();
+
+/**
+ * @brief millis() at which chamber time reaches `chamberMs`
+ *
+ * For the scheduler's next-deadline hooks. A reached deadline, and any
+ * deadline in MODE_STEP (every pass advances the clock), returns the time of
+ * the last clock tick, i.e. "due now".
+ *
+ * @param chamberMs Deadline in chamber time
+ */
+unsigned long chamber_clock_due_ms(unsigned long chamberMs);
+
+/**
+ * @brief Real time that corresponds to a chamber duration
+ *
+ * Used where a browser needs wall-clock spacing (sample timestamps). In
+ * MODE_STEP there is no fixed ratio; the chamber duration is returned.
+ *
+ * @param chamberMs Duration in chamber time
+ * @return Duration in real ms (at least 1 for a non-zero input)
+ */
+unsigned long chamber_clock_wall_ms(unsigned long chamberMs);
+
+/**
+ * @brief Chamber ms per real ms (1 in MODE_REAL and MODE_STEP)
+ */
+uint16_t chamber_clock_speedup();
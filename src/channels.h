@@ -0,0 +1,163 @@
+/*
+ * *****************************************************************************
+ * CHANNELS - COMPILE-TIME SENSOR/ACTUATOR REGISTRY
+ * *****************************************************************************
+ * One constexpr row per recorded history series, in HistorySeries order:
+ * - JSON key, label, unit, fixed-point decimals (fixed_point.h), sensor or
+ *   actuator, dashboard chart and color (Config::WebUI::Colors)
+ * - Sensor channels come first, actuator channels follow in ACTUATOR_BIT_*
+ *   order; SENSOR_SERIES_COUNT and ACTUATOR_COUNT are counted from the table
+ * - The history ring, the tiers, the JSON/binary serializers and
+ *   /api/channels (the dashboard's chart config) loop over the table
+ *
+ * Adding a channel: one HistorySeries entry and one CHANNELS row (plus the
+ * acquisition in controller.cpp). The static_asserts below catch a table
+ * that is out of order or out of sync with the enum.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+
+/**
+ * @brief History series recorded once per sample
+ *
+ * Order matches CHANNELS and the field order of the /api/last200 JSON document.
+ */
+enum HistorySeries : uint8_t {
+  SERIES_CO2,
+  SERIES_CO2_2,
+  SERIES_RH,
+  SERIES_RH_2,
+  SERIES_TEMP,
+  SERIES_TEMP_2,
+  SERIES_TEMP_OUTER,
+  SERIES_FOGGER,
+  SERIES_SWIRLER,
+  SERIES_FRESHAIR,
+  SERIES_HEATER,
+  SERIES_COUNT
+};
+
+enum ChannelKind : uint8_t {
+  CHANNEL_SENSOR,    ///< int16 fixed-point value per sample
+  CHANNEL_ACTUATOR   ///< One bit of the packed state word per sample
+};
+
+/**
+ * @brief Dashboard charts, in display order
+ */
+enum ChartId : uint8_t {
+  CHART_CO2,
+  CHART_FRESHAIR,
+  CHART_RH,
+  CHART_FOGGER,
+  CHART_SWIRLER,
+  CHART_TEMP,
+  CHART_HEATER,
+  CHART_COUNT
+};
+
+struct ChartDef {
+  ChartId id;
+  const char *title;
+  uint16_t roundStep;  ///< Values are rounded to this many fixed-point steps for display (1 = none)
+};
+
+struct ChannelDef {
+  HistorySeries series;
+  const char *key;     ///< JSON field name
+  const char *label;   ///< Legend label
+  const char *unit;
+  uint8_t decimals;    ///< Fixed-point places: value = raw / 10^decimals
+  ChannelKind kind;
+  ChartId chart;
+  const char *color;   ///< Hex without '#'
+};
+
+// Registry (index == id)
+constexpr ChartDef CHARTS[CHART_COUNT] = {
+  {CHART_CO2, "CO2 (ppm)", Config::WebUI::CO2_ROUNDING_PPM},
+  {CHART_FRESHAIR, "Fresh Air Status", 1},
+  {CHART_RH, "Relative Humidity (%)", 1},
+  {CHART_FOGGER, "Fogger Status", 1},
+  {CHART_SWIRLER, "Swirler Status", 1},
+  {CHART_TEMP, "Temperature (°C)", 1},
+  {CHART_HEATER, "Heater Status", 1},
+};
+
+// Registry (index == series)
+constexpr ChannelDef CHANNELS[SERIES_COUNT] = {
+  {SERIES_CO2, "co2", "CO2 Main", "ppm", 0, CHANNEL_SENSOR, CHART_CO2, Config::WebUI::Colors::CO2_MAIN},
+  {SERIES_CO2_2, "co2_2", "CO2 2nd", "ppm", 0, CHANNEL_SENSOR, CHART_CO2, Config::WebUI::Colors::CO2_SECONDARY},
+  {SERIES_RH, "rh", "RH Main", "%", Config::WebUI::RH_TEMP_DECIMAL_PLACES, CHANNEL_SENSOR, CHART_RH,
+   Config::WebUI::Colors::RH_MAIN},
+  {SERIES_RH_2, "rh_2", "RH 2nd", "%", Config::WebUI::RH_TEMP_DECIMAL_PLACES, CHANNEL_SENSOR, CHART_RH,
+   Config::WebUI::Colors::RH_SECONDARY},
+  {SERIES_TEMP, "temp", "Temp Main", "°C", Config::WebUI::RH_TEMP_DECIMAL_PLACES, CHANNEL_SENSOR, CHART_TEMP,
+   Config::WebUI::Colors::TEMP_MAIN},
+  {SERIES_TEMP_2, "temp_2", "Temp 2nd", "°C", Config::WebUI::RH_TEMP_DECIMAL_PLACES, CHANNEL_SENSOR, CHART_TEMP,
+   Config::WebUI::Colors::TEMP_SECONDARY},
+  {SERIES_TEMP_OUTER, "temp_outer", "Temp Outer", "°C", Config::WebUI::RH_TEMP_DECIMAL_PLACES, CHANNEL_SENSOR,
+   CHART_TEMP, Config::WebUI::Colors::TEMP_OUTER},
+  {SERIES_FOGGER, "fogger", "Fogger", "", 0, CHANNEL_ACTUATOR, CHART_FOGGER, Config::WebUI::Colors::FOGGER},
+  {SERIES_SWIRLER, "swirler", "Swirler", "", 0, CHANNEL_ACTUATOR, CHART_SWIRLER, Config::WebUI::Colors::SWIRLER},
+  {SERIES_FRESHAIR, "freshair", "FreshAir", "", 0, CHANNEL_ACTUATOR, CHART_FRESHAIR, Config::WebUI::Colors::FRESHAIR},
+  {SERIES_HEATER, "heater", "Heater", "", 0, CHANNEL_ACTUATOR, CHART_HEATER, Config::WebUI::Colors::HEATER},
+};
+
+// Number of leading sensor rows
+constexpr uint8_t channels_sensor_count(uint8_t i = 0) {
+  return (i < SERIES_COUNT && CHANNELS[i].kind == CHANNEL_SENSOR) ? channels_sensor_count(i + 1) : i;
+}
+
+// Every row sits at its own index, sensors before actuators
+constexpr bool channels_in_order(uint8_t i = 0) {
+  return i >= SERIES_COUNT ||
+         (CHANNELS[i].series == i && CHANNELS[i].chart < CHART_COUNT &&
+          (CHANNELS[i].kind == CHANNEL_ACTUATOR) == (i >= channels_sensor_count()) && channels_in_order(i + 1));
+}
+
+constexpr bool charts_in_order(uint8_t i = 0) {
+  return i >= CHART_COUNT || (CHARTS[i].id == i && CHARTS[i].roundStep > 0 && charts_in_order(i + 1));
+}
+
+static_assert(channels_in_order(), "CHANNELS out of sync with HistorySeries");
+static_assert(charts_in_order(), "CHARTS out of sync with ChartId");
+
+/// Series 0..SENSOR_SERIES_COUNT-1 are sensor values, the rest actuator states
+constexpr uint8_t SENSOR_SERIES_COUNT = channels_sensor_count();
+
+/**
+ * @brief Bits of the packed actuator state word recorded with every sample
+ */
+enum ActuatorBits : uint8_t {
+  ACTUATOR_BIT_FOGGER = 1 << (SERIES_FOGGER - SENSOR_SERIES_COUNT),
+  ACTUATOR_BIT_SWIRLER = 1 << (SERIES_SWIRLER - SENSOR_SERIES_COUNT),
+  ACTUATOR_BIT_FRESHAIR = 1 << (SERIES_FRESHAIR - SENSOR_SERIES_COUNT),
+  ACTUATOR_BIT_HEATER = 1 << (SERIES_HEATER - SENSOR_SERIES_COUNT)
+};
+
+/// Actuator series, in ACTUATOR_BIT_* order (bit n = SENSOR_SERIES_COUNT + n)
+constexpr uint8_t ACTUATOR_COUNT = SERIES_COUNT - SENSOR_SERIES_COUNT;
+
+static_assert(ACTUATOR_COUNT <= 8, "Actuator states are packed into one byte");
+
+/**
+ * @brief Decimal places of a series' fixed-point values
+ *
+ * CO2 and actuator states are whole numbers, RH and temperatures tenths.
+ */
+constexpr uint8_t series_decimals(uint8_t series) {
+  return (series < SERIES_COUNT) ? CHANNELS[series].decimals : 0;
+}
+
+/**
+ * @brief ACTUATOR_BIT_* of an actuator series (0 for sensor series)
+ */
+constexpr uint8_t series_actuator_bit(uint8_t series) {
+  return (series >= SENSOR_SERIES_COUNT && series < SERIES_COUNT) ? (uint8_t)(1u << (series - SENSOR_SERIES_COUNT))
+                                                                   : 0;
+}
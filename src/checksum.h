@@ -0,0 +1,56 @@
+/*
+ * *****************************************************************************
+ * CHECKSUM MODULE
+ * *****************************************************************************
+ * Shared integrity checks for the storage slots, the sample log and Modbus:
+ * - CRC-8 (poly 0x07, init 0xFF, no reflection) - the slot format on flash
+ * - CRC-32 (IEEE 802.3, reflected, init/xorout 0xFFFFFFFF) for larger frames
+ * - CRC-16/MODBUS (reflected 0x8005, init 0xFFFF) for Modbus-RTU frames
+ * All are byte-wise table lookups; on STM32H7 the CRC peripheral is used
+ * for CRC-8/CRC-32 instead when Config::USE_HARDWARE_CRC is set. Results
+ * are identical on every path. Callable from any thread: a caller that
+ * finds the peripheral in use falls back to the tables.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief CRC-8 as used by the storage slots and sample records
+ *
+ * @param data Bytes to check
+ * @param len Number of bytes
+ * @return CRC-8 (poly 0x07, init 0xFF)
+ */
+uint8_t checksum_crc8(const void *data, size_t len);
+
+/**
+ * @brief CRC-32 (IEEE 802.3, same as zlib/Ethernet)
+ *
+ * @param data Bytes to check
+ * @param len Number of bytes
+ * @return CRC-32, crc32("123456789") == 0xCBF43926
+ */
+uint32_t checksum_crc32(const void *data, size_t len);
+
+/**
+ * @brief Continue a CRC-32 over more data (zlib crc32() semantics)
+ *
+ * checksum_crc32_update(checksum_crc32(a, n), b, m) equals the CRC-32 of a
+ * followed by b; start with 0. Table-driven, for data arriving in pieces.
+ *
+ * @param crc CRC-32 of the data so far (0 for none)
+ */
+uint32_t checksum_crc32_update(uint32_t crc, const void *data, size_t len);
+
+/**
+ * @brief CRC-16/MODBUS as appended (low byte first) to every RTU frame
+ *
+ * @param data Bytes to check
+ * @param len Number of bytes
+ * @return CRC-16, crc16_modbus("123456789") == 0x4B37
+ */
+uint16_t checksum_crc16_modbus(const void *data, size_t len);
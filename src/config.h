@@ -16,32 +16,86 @@
 // SYSTEM CONFIGURATION
 // =============================================================================
 
+#ifndef CC_NETWORK_THREAD
+#define CC_NETWORK_THREAD 0   // 1 = WiFi + HTTP in a separate thread, control in loop() (0: only WiFi)
+#endif
+
+#ifndef CC_PERF
+#define CC_PERF 0             // 1 = DWT cycle counters per task at /api/perf (see perf.h)
+#endif
+
+#ifndef CC_BENCH
+#define CC_BENCH 0            // 1 = run the micro-benchmarks (bench.h) once at boot
+#endif
+
+#ifndef CC_MQTT
+#define CC_MQTT 0             // 1 = publish samples to an MQTT broker (mqtt_client.h, needs CC_NETWORK_THREAD)
+#endif
+
+#ifndef CC_CAN
+#define CC_CAN 0              // 1 = share samples and take setpoints over the CAN bus (can_link.h)
+#endif
+
+#ifndef CC_USB_LOG
+#define CC_USB_LOG 0          // 1 = log samples to a USB stick on the USB-A port (usb_logger.h)
+#endif
+
+#ifndef CC_TRACE
+#define CC_TRACE 0            // 1 = replay sensor traces from the sample log, run report at /api/trace (sensor_trace.h)
+#endif
+
+#ifndef CC_SIM_SENSOR
+#define CC_SIM_SENSOR 0       // 1 = SimSensor random walks instead of the front-end readings (env:native sets it)
+#endif
+
+#ifndef CC_MEMORY_PLACEMENT
+#define CC_MEMORY_PLACEMENT 0 // 1 = DTCM/ITCM/SDRAM sections (memory_regions.h, set by scripts/memory_regions.py)
+#endif
+
+#if CC_MQTT && !CC_NETWORK_THREAD
+#error "CC_MQTT=1 needs CC_NETWORK_THREAD=1: the broker's TCP connect blocks"
+#endif
+
 namespace Config {
 
 // --- Testing & Simulation ---
 constexpr bool SIMULATE_SENSORS = true;      // Use simulated sensors for testing
-constexpr uint8_t SPEEDUP_FACTOR = 10;       // 10x faster than real-time
+constexpr uint16_t SPEEDUP_FACTOR = 10;      // Chamber clock runs 10x faster than real-time
 constexpr unsigned long SERIAL_BAUD_RATE = 115200;
-constexpr unsigned long SERIAL_TIMEOUT_MS = 3000;
 
 // --- Storage ---
 constexpr unsigned long PERSIST_INTERVAL_MS = 5000;  // Auto-save every 5 seconds
 constexpr uint8_t STORAGE_NUM_VALUES = 10;
-constexpr uint32_t FLASH_RING_BUFFER_SLOTS = 100;
-constexpr uint32_t FLASH_SLOT_SIZE_BYTES = 64;
+constexpr uint32_t FLASH_RING_BUFFER_SLOTS = 16;
+constexpr uint32_t FLASH_SLOT_SIZE_BYTES = 512;
+constexpr bool USE_HARDWARE_CRC = true;              // STM32H7 CRC unit when available, else tables
+constexpr uint32_t SAMPLE_LOG_REGION_BYTES = 1024UL * 1024UL; // Persistent sample log (~6 days at 3 s, packed)
+constexpr uint16_t SAMPLE_LOG_MAX_SEGMENTS = 256;              // RAM index entries (one per erase block)
+constexpr uint8_t SAMPLE_LOG_BLOCK_SAMPLES = 32;               // Samples per packed flash block (lost on reset: up to this many - 1)
+constexpr uint32_t ASSET_CHART_JS_MAX_BYTES = 256UL * 1024UL;  // gzip'ed Chart.js in the QSPI asset region (4.4: ~70 KB)
 
 // --- Data Collection ---
-constexpr uint16_t SENSOR_RING_BUFFER_SIZE = 200;    // 200 samples per sensor
+constexpr uint16_t SENSOR_RING_BUFFER_SIZE = 200;    // 200 samples per sensor (API window)
+constexpr uint16_t SENSOR_HISTORY_CAPACITY = 256;    // Ring capacity, power of two >= window
 constexpr unsigned long SAMPLE_INTERVAL_MS = 3000;   // Sample every 3 seconds
 
+// --- Downsampled History Tiers (min/mean/max per bucket, ~46 bytes/bucket) ---
+constexpr unsigned long HISTORY_TIER_1M_INTERVAL_MS = 60000;  // 1-minute buckets
+constexpr uint16_t HISTORY_TIER_1M_CAPACITY = 512;            // ~8.5 h, power of two
+constexpr uint8_t HISTORY_TIER_15M_FACTOR = 15;               // 15 x 1 min per bucket
+constexpr uint16_t HISTORY_TIER_15M_CAPACITY = CC_MEMORY_PLACEMENT ? 4096 : 1024; // ~42 / ~10.6 days, power of two (SDRAM arena)
+static_assert(HISTORY_TIER_1M_INTERVAL_MS % SAMPLE_INTERVAL_MS == 0,
+              "Tier interval must be a whole number of samples");
+
 // =============================================================================
 // TIMING CONSTANTS
 // =============================================================================
 
 // --- Real-Time Operations (not scaled) ---
 constexpr unsigned long POLL_INTERVAL_MS = 200;      // UI poll rate
+constexpr unsigned long SENSOR_FRAME_MAX_AGE_MS = 20; // Shared sensor frame is re-acquired when older
 
-// --- Control Loop Timings (scaled by SPEEDUP_FACTOR) ---
+// --- Control Loop Timings (chamber time) ---
 constexpr unsigned long MEDIAN_DURATION_MS = 5000;         // 5s median sampling
 constexpr unsigned long SWIRL_DURATION_MS = 10000;         // 10s air mixing
 constexpr unsigned long WAIT_AFTER_SWIRL_MS = 10000;       // 10s settling time
@@ -53,12 +107,193 @@ constexpr unsigned long POST_FOGGER_WAIT_MS = 60000;       // 60s wait
 // --- Heater Control ---
 constexpr unsigned long HEATER_CHECK_INTERVAL_MS = 1000;   // Check every second
 
+// --- Actuator Outputs (Machine Control DIGITAL OUTPUTS, see outputs.h) ---
+namespace Outputs {
+  constexpr uint8_t SWIRLER_CHANNEL = 0;             // DO0
+  constexpr uint8_t FRESHAIR_CHANNEL = 1;            // DO1
+  constexpr uint8_t FOGGER_CHANNEL = 2;              // DO2
+  constexpr uint8_t HEATER_CHANNEL = 3;              // DO3
+  constexpr bool LATCH_MODE = true;                  // Latch off on overcurrent instead of auto-retry
+  constexpr bool DIGITAL_INPUTS = false;             // Track the DIGITAL INPUTS expander
+  constexpr int INPUT_INT_PIN = -1;                  // Expander INT line if wired, -1 = poll
+  constexpr unsigned long INPUT_POLL_MS = 50;        // Poll interval without INT line
+}
+
+// --- Chambers (one ChamberController per entry, see controller.h) ---
+// Each chamber has its own controller state, history and settings
+// namespace; all share the chamber clock and the scheduler tasks. A board
+// has 8 DIGITAL OUTPUTS, 3 TEMP PROBES and 3 ANALOG INPUTS, so beyond two
+// chambers the extra sensors come over Modbus or the simulation.
+namespace Chambers {
+  constexpr uint8_t NO_INPUT = 0xFF;                 // Sensor not wired to this chamber
+
+  struct Map {
+    uint8_t swirlerChannel;                          // DIGITAL OUTPUTS
+    uint8_t freshAirChannel;
+    uint8_t foggerChannel;
+    uint8_t heaterChannel;
+    uint8_t tempProbe;                               // TEMP PROBES channel or NO_INPUT
+    uint8_t temp2Probe;
+    uint8_t outerProbe;
+    uint8_t co2Input;                                // ANALOG IN channel or NO_INPUT
+    uint8_t rhInput;
+    bool modbus;                                     // Owns the Modbus transmitters (modbus_master.h)
+  };
+
+  constexpr Map MAPS[] = {
+    // swirler               fresh air                 fogger                  heater                  probes      analog  modbus
+    {Outputs::SWIRLER_CHANNEL, Outputs::FRESHAIR_CHANNEL, Outputs::FOGGER_CHANNEL, Outputs::HEATER_CHANNEL, 0, 1, 2,  0, 1,  true},
+    // Second chamber on DO4..DO7 (no probes/analog inputs left for it):
+    // {4, 5, 6, 7, NO_INPUT, NO_INPUT, NO_INPUT, NO_INPUT, NO_INPUT, false},
+  };
+  constexpr uint8_t COUNT = sizeof(MAPS) / sizeof(MAPS[0]);
+  constexpr uint8_t MAX_COUNT = 4;                   // Settings image and event records hold this many
+  static_assert(COUNT >= 1 && COUNT <= MAX_COUNT, "1..MAX_COUNT chambers");
+}
+
+// --- Memory Placement (memory_regions.h) ---
+// Region sizes of the STM32H747 M7 core as far as this firmware uses them;
+// scripts/memory_regions.ld and the budget report use the same numbers.
+namespace Memory {
+  constexpr uint32_t DTCM_VECTORS_BYTES = 664;              // mbed RAM vector table at 0x20000000
+  constexpr uint32_t DTCM_BYTES = 128UL * 1024UL - DTCM_VECTORS_BYTES; // FAST_DATA (core's DTCMRAM, behind the vectors)
+  constexpr uint32_t ITCM_BYTES = 63UL * 1024UL;            // FAST_CODE (0x00000400, first 1 KB unused)
+  constexpr uint32_t SDRAM_BYTES = 8UL * 1024UL * 1024UL;   // EXT_DATA + SDRAM heap (0x60000000)
+  // History tiers of all chambers; without SDRAM the arena is ordinary .bss
+  constexpr uint32_t ARENA_BYTES = CC_MEMORY_PLACEMENT ? 2UL * 1024UL * 1024UL : Chambers::COUNT * 80UL * 1024UL;
+  constexpr uint32_t ARENA_ALIGN = 8;
+}
+
+// --- Sensor Trace Replay (only with -DCC_TRACE=1, see sensor_trace.h) ---
+// A trace is a range of the flash sample log, replayed into chamber 0 one
+// record per SAMPLE_INTERVAL_MS of chamber time; the speed is the clock mode
+namespace Trace {
+  constexpr uint8_t SPEED_REALTIME = 0;              // 1x: chamber time = millis()
+  constexpr uint8_t SPEED_MAX = 1;                   // Chamber clock in MODE_STEP, as fast as the CPU allows
+  constexpr uint8_t SPEED = SPEED_MAX;
+}
+
+// --- Chamber Clock (time base of the control state machines, see chamber_clock.h) ---
+namespace Clock {
+  constexpr uint8_t MODE_REAL = 0;                   // Chamber time = millis()
+  constexpr uint8_t MODE_SCALED = 1;                 // Chamber time = real time x SPEEDUP_FACTOR
+  constexpr uint8_t MODE_STEP = 2;                   // Every control pass advances STEP_MS, as fast as the CPU allows
+  constexpr uint8_t MODE = CC_TRACE ? ((Trace::SPEED == Trace::SPEED_MAX) ? MODE_STEP : MODE_REAL)
+                                    : (SIMULATE_SENSORS ? MODE_SCALED : MODE_REAL);
+  constexpr unsigned long STEP_MS = 100;             // Chamber time per pass in MODE_STEP
+}
+
+// --- Cooperative Scheduler (real time, not scaled; see main.cpp task table) ---
+namespace Scheduler {
+  constexpr uint8_t MAX_TASKS = 20;
+  constexpr unsigned long CONTROL_PERIOD_MS =        // Clock, action, measurement and sample state machines
+      (Clock::MODE == Clock::MODE_STEP) ? 0 : 1;     // (every pass while stepping)
+  constexpr unsigned long CONTROL_DEADLINE_MS = 5;   // Allowed start latency for control tasks
+  constexpr unsigned long HEATER_PERIOD_MS =         // Heater checks its own (chamber time) interval
+      (Clock::MODE == Clock::MODE_STEP) ? 0 : 10;
+  constexpr unsigned long WEB_PERIOD_MS = 2;         // HTTP connection pool
+  constexpr unsigned long WEB_DEADLINE_MS = 50;
+  constexpr unsigned long WIFI_PERIOD_MS = 100;      // Status and RSSI monitoring
+  constexpr unsigned long CAN_PERIOD_MS = 2;         // CAN fleet link (cooperative mode only)
+  constexpr unsigned long STORAGE_PERIOD_MS = 20;    // Settings coalescing and sector erase
+  constexpr unsigned long SAMPLE_LOG_PERIOD_MS = 20; // Sample log segment erase
+  constexpr unsigned long MAX_IDLE_MS = 1000;        // Event-driven tasks run at least this often
+  constexpr bool IDLE_SLEEP = false;                 // WFI when nothing is due (needs a periodic tick interrupt)
+}
+
+// --- Wall Clock (RTC disciplined against millis(), see wall_clock.h) ---
+namespace WallClock {
+  constexpr unsigned long SYNC_INTERVAL_MS = 600000; // RTC edge measured every 10 min
+  constexpr unsigned long EDGE_POLL_MS = 10;         // RTC reads while hunting the seconds edge (= timestamp jitter)
+  constexpr unsigned long EDGE_TIMEOUT_MS = 1500;    // No seconds change: RTC stopped, sync skipped
+  constexpr int32_t STEP_MS = 2000;                  // Larger errors step the time instead of trimming the rate
+  constexpr float RATE_GAIN = 0.5f;                  // Share of the measured rate error applied per sync
+  constexpr float MAX_RATE_PPM = 500.0f;             // Crystal tolerance bound of the correction
+  constexpr uint32_t MIN_VALID_EPOCH = 1704067200;   // 2024-01-01: earlier RTC times count as unset
+}
+
+// --- Profiling (only with -DCC_PERF=1, see perf.h) ---
+namespace Perf {
+  constexpr unsigned long LOOP_WINDOW_MS = 1000;     // Window of the loop frequency measurement
+}
+
+// --- Networking / Control Link (see control_link.h) ---
+// Build with -DCC_NETWORK_THREAD=1 to run WiFi + HTTP in their own mbed thread;
+// without it only WiFi gets a thread and HTTP stays a scheduler task
+namespace Network {
+  constexpr uint8_t COMMAND_QUEUE_SIZE = 32;         // Network -> control setting changes, power of two
+  constexpr uint32_t THREAD_STACK_BYTES = 8192;      // WiFi stack + HTTP generators
+  constexpr uint32_t WIFI_THREAD_STACK_BYTES = 4096; // WiFi alone (begin(), network scan), CC_NETWORK_THREAD=0
+  constexpr unsigned long THREAD_IDLE_MS = 1;        // Network thread sleep between passes
+}
+
+// --- MQTT Telemetry (only with -DCC_MQTT=1, see mqtt_client.h) ---
+namespace Mqtt {
+  constexpr uint8_t QOS = 1;                          // 1 = every batch acknowledged (resent after a reconnect), 0 = fire and forget
+  constexpr uint16_t KEEPALIVE_S = 30;                // PINGREQ after half of it without sending or receiving
+  constexpr uint8_t MAX_BATCH_SAMPLES = 16;           // Samples per PUBLISH while a backlog drains
+  constexpr uint32_t OFFLINE_MAX_SAMPLES = 28800;     // Backlog kept while disconnected (24 h at 3 s)
+  constexpr unsigned long CONNACK_TIMEOUT_MS = 5000;
+  constexpr unsigned long ACK_TIMEOUT_MS = 10000;     // PUBACK overdue: reconnect and resend
+  constexpr unsigned long RETRY_MIN_MS = 1000;        // Reconnect backoff, doubling per failure
+  constexpr unsigned long RETRY_MAX_MS = 60000;
+  constexpr const char *TOPIC_PREFIX = "climatic-chamber/"; // + client id + "/samples" or "/status"
+}
+
+// --- USB Stick Logger (only with -DCC_USB_LOG=1, see usb_logger.h) ---
+namespace UsbLog {
+  constexpr uint8_t FORMAT_CSV = 0;                   // sample_csv.h rows, one header per file
+  constexpr uint8_t FORMAT_BINARY = 1;                // UsbLogRecord (usb_logger.h) per sample
+  constexpr uint8_t FORMAT = FORMAT_CSV;
+  constexpr uint32_t BUFFER_BYTES = 8192;             // Per buffer (two): filled while the other is written
+  constexpr uint32_t SECTOR_BYTES = 512;              // Writes end on this boundary
+  constexpr unsigned long SYNC_INTERVAL_MS = 60000;   // Partial buffer written + fsync (max data lost on removal)
+  constexpr uint32_t ROTATE_BYTES = 8UL * 1024UL * 1024UL; // New file beyond this size
+  constexpr unsigned long MOUNT_RETRY_MS = 5000;      // Probing for a stick while none is mounted
+  constexpr uint32_t THREAD_STACK_BYTES = 4096;       // Writer thread (FAT + USB host calls)
+  static_assert(BUFFER_BYTES >= 4096 && BUFFER_BYTES <= 16384 && BUFFER_BYTES % SECTOR_BYTES == 0,
+                "Config::UsbLog::BUFFER_BYTES must be 4..16 KB in whole sectors");
+}
+
+// --- CAN Fleet Link (only with -DCC_CAN=1, see can_link.h) ---
+// Every board broadcasts its samples and setpoints; the gateway collects the
+// whole bus for /api/fleet and forwards setting batches to single nodes.
+namespace Can {
+  constexpr uint8_t ROLE_NODE = 0;                    // Broadcast own chambers, accept own settings
+  constexpr uint8_t ROLE_GATEWAY = 1;                 // Additionally collect every node, send settings
+  constexpr uint8_t ROLE = ROLE_NODE;
+  constexpr uint8_t NODE_ID = 1;                      // Unique per bus, 0..MAX_NODES-1
+  constexpr uint8_t MAX_NODES = 16;                   // Nodes the gateway keeps track of
+  constexpr uint16_t BITRATE_KBPS = 500;              // 125, 250, 500 or 1000, same on every node
+  constexpr unsigned long SETPOINT_REFRESH_MS = 5000; // Setpoints resent at least this often (heartbeat)
+  constexpr unsigned long NODE_TIMEOUT_MS = 12000;    // Gateway marks a silent node offline
+  constexpr uint8_t TX_QUEUE_SIZE = 32;               // Frames, power of two
+  constexpr uint8_t TX_FRAMES_PER_TICK = 4;           // Controller mailboxes are 3 deep
+  constexpr uint8_t RX_FRAMES_PER_TICK = 16;
+  static_assert(NODE_ID < MAX_NODES, "Config::Can::NODE_ID must be below MAX_NODES");
+}
+
+// --- Event Log (binary RAM ring, see event_log.h) ---
+// Levels: 0 = off, 1 = error, 2 = warn, 3 = info, 4 = debug; events above the
+// level of their module are compiled out
+namespace EventLog {
+  constexpr uint16_t CAPACITY = 128;                 // Records, power of two (24 bytes each)
+  constexpr uint8_t LEVEL_CONTROL = 4;               // Actuators, actions, measurement cycle
+  constexpr uint8_t LEVEL_SENSORS = 4;               // Probe faults, bus errors
+  constexpr uint8_t LEVEL_WEB = 3;                   // Setpoint changes; connections/requests are debug
+  constexpr unsigned long DRAIN_PERIOD_MS = 5;       // Scheduler period of the Serial drain
+  constexpr uint8_t DRAIN_LINES_PER_TICK = 2;        // Upper bound when the port reports no free space
+}
+
 // =============================================================================
 // SENSOR CONFIGURATION
 // =============================================================================
 
 // --- Simulated Sensor Ranges ---
 namespace  Simulation {
+  // Random walks (xorshift.h); chamber n uses SEED + n, every boot repeats the same scenario
+  constexpr uint32_t SEED = 0x2545F491;
+
   // CO2 Sensors (ppm)
   constexpr int CO2_MIN = 450;
   constexpr int CO2_MAX = 3000;
@@ -92,9 +327,78 @@ namespace  Simulation {
   constexpr float TEMP_OUTER_NOISE_AMPLITUDE = 0.3f;
 }
 
+// --- Temperature Probes (Machine Control temperature inputs 0/1/2) ---
+// RTD and thermocouple front ends share the input multiplexer; one type for all three
+namespace TempProbes {
+  constexpr bool THERMOCOUPLES = false;         // false: PT100 (MAX31865), true: thermocouples (MAX31855)
+  constexpr bool TC_TYPE_J = false;             // Thermocouple type: false = K, true = J
+  constexpr bool THREE_WIRE_RTD = true;
+  constexpr float RTD_NOMINAL_OHM = 100.0f;     // PT100
+  constexpr float RTD_REFERENCE_OHM = 400.0f;   // Machine Control reference resistor
+  constexpr unsigned long POLL_PERIOD_MS = 5;   // Scheduler period of the round robin
+  constexpr unsigned long MAX_AGE_MS = 5000;    // Older readings count as missing
+}
+
+// --- Analog Inputs (CO2/RH transmitters on Machine Control AI0..AI2, 0-10 V) ---
+// Continuous DMA sampling (Arduino_AdvancedAnalog), box-car decimated per window
+namespace AnalogInputs {
+  constexpr uint32_t SAMPLE_RATE_HZ = 1000;     // Scan rate per channel
+  constexpr uint16_t SAMPLES_PER_BUFFER = 32;   // Samples per channel per DMA buffer
+  constexpr uint8_t DMA_BUFFER_COUNT = 8;       // Queued buffers (~256 ms of headroom)
+  constexpr unsigned long WINDOW_MS = 100;      // Decimation window (= scaled median sample period)
+  constexpr unsigned long DRAIN_PERIOD_MS = 10; // Scheduler period of the buffer drain
+  constexpr unsigned long MAX_AGE_MS = 1000;    // Older windows count as missing
+  constexpr float ADC_REFERENCE_V = 3.0f;       // ADC full scale at the pin
+  constexpr float DIVIDER_RATIO = 0.28057f;     // 100k/39k input divider in 0-10 V mode
+  constexpr float CO2_PPM_PER_V = 500.0f;       // AI0: 0-10 V = 0-5000 ppm
+  constexpr float RH_PERCENT_PER_V = 10.0f;     // AI1: 0-10 V = 0-100 %
+}
+
+// --- Modbus-RTU Transmitters (RS485, point table in modbus_master.cpp) ---
+namespace Modbus {
+  constexpr bool ENABLED = false;               // No transmitters on the bus yet
+  constexpr unsigned long BAUD_RATE = 19200;    // 8N1
+  constexpr unsigned long POLL_INTERVAL_MS = 1000;     // All blocks are queued once per interval
+  constexpr unsigned long RESPONSE_TIMEOUT_MS = 100;   // Per request, first byte to last byte
+  constexpr uint8_t RETRIES = 2;                // Extra attempts before a block counts as failed
+  constexpr uint8_t MAX_REGISTER_GAP = 4;       // Unused registers read to merge two points into one request
+  constexpr uint8_t QUEUE_SIZE = 8;             // Pending requests
+  constexpr unsigned long TICK_PERIOD_MS = 1;   // Scheduler period of the bus state machine
+  constexpr unsigned long MAX_AGE_MS = 5000;    // Older values count as missing
+}
+
 // --- Sensor Averaging ---
 constexpr uint8_t MEDIAN_SAMPLE_COUNT = 10;
 
+// --- Streaming Filters (sliding window per channel, fed every median sample period) ---
+namespace Filter {
+  constexpr uint8_t ESTIMATE_MEDIAN = 0;
+  constexpr uint8_t ESTIMATE_TRIMMED_MEAN = 1;
+  constexpr uint8_t ESTIMATE_HAMPEL = 2;
+  constexpr uint8_t ESTIMATE = ESTIMATE_MEDIAN;  // Value handed to controllerEvaluate()
+  constexpr uint8_t TRIM = 1;                    // Samples dropped at each end (trimmed mean)
+  constexpr float HAMPEL_K = 3.0f;               // Outlier limit in robust sigmas (1.4826 * MAD)
+}
+
+// --- Adaptive Measurement Cycle (trend_stats.h, fed with every filter sample) ---
+// Mixed: main and secondary sensors agree. Steady: trend noise and the drift
+// predicted over PREDICT_HORIZON_MS stay inside the band. CO2 in ppm, RH and
+// temperature in 0.1 steps (fixed_point.h).
+namespace Measure {
+  constexpr bool ADAPTIVE = true;               // false: fixed swirl, median and wait
+  constexpr float TREND_ALPHA = 0.3f;           // Level smoothing per filter sample
+  constexpr float TREND_BETA = 0.1f;            // Slope smoothing per filter sample
+  constexpr float CO2_AGREE_PPM = 50.0f;        // co2 vs co2_2 counts as mixed
+  constexpr float RH_AGREE_X10 = 15.0f;         // rh vs rh_2 (1.5 %RH)
+  constexpr float CO2_STEADY_PPM = 25.0f;
+  constexpr float RH_STEADY_X10 = 5.0f;         // 0.5 %RH
+  constexpr float TEMP_STEADY_X10 = 3.0f;       // 0.3 °C
+  constexpr unsigned long SWIRL_MIN_MS = 1000;  // Swirl ends early once mixed, not before this
+  constexpr unsigned long WAIT_MAX_MS = 300000; // Wait doubles per steady cycle up to this
+  constexpr unsigned long WAIT_MIN_MS = 10000;  // Earliest trend-triggered end of a wait
+  constexpr unsigned long PREDICT_HORIZON_MS = 60000; // Look-ahead for steady and threshold checks
+}
+
 // =============================================================================
 // CONTROL PARAMETERS
 // =============================================================================
@@ -127,14 +431,78 @@ namespace Temperature {
   constexpr float HEATER_OFF_THRESHOLD = 0.0f;       // Turn off at setpoint
 }
 
+// --- Control Mode (heater + fogger loops, see pid_control.h) ---
+// Mode and gains are settings (storage.h); hysteresis stays the default
+namespace Control {
+  constexpr uint8_t MODE_HYSTERESIS = 0;             // Heater bang-bang, fogger via the RH_UP action
+  constexpr uint8_t MODE_PI = 1;                     // PI/PID with time-proportional output
+  constexpr unsigned long HEATER_PWM_WINDOW_MS = 20000;  // Slow PWM window (chamber time)
+  constexpr unsigned long HEATER_MIN_SWITCH_MS = 2000;   // Shortest on or off pulse
+  constexpr unsigned long FOGGER_PWM_WINDOW_MS = 60000;
+  constexpr unsigned long FOGGER_MIN_SWITCH_MS = 3000;
+  constexpr float TEMP_SETTLE_BAND = 0.3f;           // °C around the setpoint counts as settled ...
+  constexpr float RH_SETTLE_BAND = 1.0f;             // %RH ...
+  constexpr unsigned long SETTLE_HOLD_MS = 300000;   // ... once held for 5 min (chamber time)
+}
+
+// --- Safety Overrides (see action arbitration in controller.cpp) ---
+// The limits are settings (co2_limit, temp_limit); a trip clears once the
+// filtered value is back below the limit minus the re-arm margin
+namespace Safety {
+  constexpr uint16_t CO2_REARM_PPM = 200;
+  constexpr float TEMP_REARM = 1.0f;                 // °C
+}
+
+// --- Actuator Statistics (on-time, switch-ons, energy; see actuator_stats.h) ---
+// Energy is on-time x rated power: no current sensing on the outputs
+namespace Stats {
+  constexpr float FOGGER_W = 30.0f;                  // Rated electrical power per actuator
+  constexpr float SWIRLER_W = 15.0f;
+  constexpr float FRESHAIR_W = 20.0f;
+  constexpr float HEATER_W = 500.0f;
+  constexpr unsigned long HOUR_BUCKET_MS = 300000;   // 1 h window: 12 x 5 min (chamber time)
+  constexpr unsigned long DAY_BUCKET_MS = 3600000;   // 24 h window: 24 x 1 h
+  constexpr unsigned long CHECKPOINT_INTERVAL_MS = 3600000; // Lifetime totals to the settings store (real time)
+}
+
+// --- Alarms (rule table in alarms.cpp, evaluated once per history sample) ---
+// A rule raises once its condition held for the hold time and clears once
+// it stayed below the clear level for CLEAR_HOLD_MS (chamber time)
+namespace Alarms {
+  constexpr uint16_t CO2_DISAGREE_PPM = 150;         // |co2 - co2_2| above this ...
+  constexpr uint16_t CO2_DISAGREE_CLEAR_PPM = 100;   // ... clears below this
+  constexpr unsigned long DISAGREE_HOLD_MS = 300000; // 5 min
+  constexpr uint16_t CO2_BAND_PPM = 500;             // Above setpoint + band ...
+  constexpr float RH_BAND = 5.0f;                    // %RH off the setpoint
+  constexpr float TEMP_BAND = 2.0f;                  // °C off the setpoint
+  constexpr uint8_t BAND_CLEAR_PERCENT = 80;         // ... clears back inside 80 % of the band
+  constexpr unsigned long OUT_OF_BAND_MS = 1800000;  // 30 min
+  constexpr unsigned long STALE_MS = 600000;         // No valid, changing reading for 10 min
+  constexpr unsigned long HEATER_MAX_ON_MS = 1800000; // Heater on without a break
+  constexpr unsigned long CLEAR_HOLD_MS = 60000;
+  constexpr uint8_t EDGE_RING = 16;                  // Raised/cleared edges kept for the stream, MQTT, /api/alarms; power of two
+}
+
 // =============================================================================
 // WEB INTERFACE CONFIGURATION
 // =============================================================================
 
 namespace WebUI {
-  constexpr unsigned long CACHE_DURATION_MS = 1000;   // Cache API responses for 1s
   constexpr uint16_t HTTP_PORT = 80;
   
+  // HTTP Connection Pool (bounded work per loop() iteration)
+  constexpr uint8_t HTTP_MAX_CONNECTIONS = 4;           // Concurrent client connections
+  constexpr uint16_t HTTP_READ_BUDGET_BYTES = 256;      // Request bytes parsed per connection per tick
+  constexpr uint16_t HTTP_MAX_HEADER_BYTES = 4096;      // Header block above this is refused (431)
+  constexpr uint16_t HTTP_WRITE_BUDGET_BYTES = 1024;    // Response bytes written per connection per tick
+  constexpr unsigned long HTTP_IDLE_TIMEOUT_MS = 5000;  // Drop connections idle for 5s (also between keep-alive requests)
+  constexpr uint16_t HTTP_KEEPALIVE_MAX_REQUESTS = 100; // Requests per connection before it is closed
+  constexpr uint16_t HTTP_ASSET_WRITE_BUDGET_BYTES = 4096; // Static assets (web_assets.h): few large writes
+
+  // Push stream (/api/stream, Server-Sent Events)
+  constexpr uint8_t HTTP_MAX_STREAMS = 8;               // Subscribers, outside the connection pool
+  constexpr unsigned long HTTP_STREAM_HEARTBEAT_MS = 4000; // Comment line when no sample was sent
+  
   // Chart Configuration
   constexpr uint16_t CHART_HEIGHT_PX = 150;
   constexpr uint16_t STATUS_CHART_HEIGHT_PX = 40;
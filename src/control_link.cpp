@@ -0,0 +1,30 @@
+/*
+ * *****************************************************************************
+ * CONTROL LINK IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "control_link.h"
+#include "config.h"
+#include "spsc_queue.h"
+
+static SpscQueue<ControlCommand, Config::Network::COMMAND_QUEUE_SIZE> g_commands;
+
+static_assert(decltype(g_commands)::capacity() >= SETTING_COUNT - 1,
+              "A batch changing every setting must fit into the command queue");
+
+bool control_link_next_command(ControlCommand *out) {
+  return g_commands.pop(out);
+}
+
+bool control_link_post(uint8_t chamber, SettingKey key, int32_t raw) {
+  ControlCommand command;
+  command.chamber = chamber;
+  command.key = key;
+  command.raw = raw;
+  return g_commands.push(command);
+}
+
+bool control_link_post_batch(const ControlCommand *commands, uint8_t count) {
+  return g_commands.pushAll(commands, count);
+}
@@ -0,0 +1,59 @@
+/*
+ * *****************************************************************************
+ * CONTROL LINK - CONTROLLER <-> NETWORK EXCHANGE
+ * *****************************************************************************
+ * Write path from the network side (WiFi + HTTP) into the control loop:
+ * setting changes are queued here and applied by the controller's command
+ * task at its own priority. The queue is an SpscQueue, so neither side ever
+ * blocks on the other and the same code works with networking in loop() or
+ * in its own thread (CC_NETWORK_THREAD). The read path is
+ * controller_snapshot() plus the sequence-numbered history rings.
+ *
+ * Thread ownership: control_link_next_command() on the control side only,
+ * control_link_post() on the network side only.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "storage.h"
+
+/**
+ * @brief One setting change requested by the network side
+ */
+struct ControlCommand {
+  uint8_t chamber;  ///< Config::Chambers index
+  SettingKey key;
+  int32_t raw;    ///< Fixed-point value, already clamped
+};
+
+// --- Control side ---
+
+/**
+ * @brief Next pending command
+ *
+ * @return false if none is pending
+ */
+bool control_link_next_command(ControlCommand *out);
+
+// --- Network side ---
+
+/**
+ * @brief Request a setting change
+ *
+ * @return false if the command queue is full (retry later)
+ */
+bool control_link_post(uint8_t chamber, SettingKey key, int32_t raw);
+
+/**
+ * @brief Request several setting changes at once
+ *
+ * All or nothing: the control side sees the whole batch in the same
+ * command pass and applies it with one controller update per chamber.
+ *
+ * @return false if the queue has no room for all of them (retry later)
+ */
+bool control_link_post_batch(const ControlCommand *commands, uint8_t count);
+
@@ -5,106 +5,73 @@
  */
 
 #include "controller.h"
+#include "action_recipes.h"
+#include "actuator_stats.h"
+#include "alarms.h"
+#include "analog_inputs.h"
+#include "chamber_clock.h"
+#include "control_link.h"
+#include "event_log.h"
+#include "history_tiers.h"
+#include "memory_regions.h"
+#include "modbus_master.h"
+#include "outputs.h"
+#include "pid_control.h"
+#include "running_filter.h"
+#include "seqlock.h"
+#include "sample_log.h"
+#include "sensor_history.h"
+#include "sensor_trace.h"
 #include "storage.h"
+#include "temp_probes.h"
+#include "trend_stats.h"
+#include "usb_logger.h"
+#include "wall_clock.h"
+#include "xorshift.h"
 
-// --- Config (SPEEDUP, timing constants) ---
+// --- Config (timing constants) ---
 
 // Import constants from config.h for local use
-static constexpr uint8_t SPEEDUP = Config::SPEEDUP_FACTOR;
 static constexpr uint16_t RING_BUFFER_SIZE = Config::SENSOR_RING_BUFFER_SIZE;
+static constexpr uint16_t HISTORY_CAPACITY = Config::SENSOR_HISTORY_CAPACITY;
 
-#if !defined(SIMULATE_SENSORS)
-  static constexpr bool SIMULATE_SENSORS = Config::SIMULATE_SENSORS;
-#endif
+static_assert(HISTORY_CAPACITY >= RING_BUFFER_SIZE, "History capacity must cover the API window");
+static constexpr uint16_t TIER_1M_SAMPLES = Config::HISTORY_TIER_1M_INTERVAL_MS / Config::SAMPLE_INTERVAL_MS;
+
+// Tiers live in the memory arena (external SDRAM with CC_MEMORY_PLACEMENT)
+typedef AggregateTier<SENSOR_SERIES_COUNT, ACTUATOR_COUNT, Config::HISTORY_TIER_1M_CAPACITY> Tier1m;
+typedef AggregateTier<SENSOR_SERIES_COUNT, ACTUATOR_COUNT, Config::HISTORY_TIER_15M_CAPACITY> Tier15m;
+static_assert(Config::Chambers::COUNT * (sizeof(Tier1m) + sizeof(Tier15m) + 2 * Config::Memory::ARENA_ALIGN) <=
+                  Config::Memory::ARENA_BYTES,
+              "Config::Memory::ARENA_BYTES too small for the history tiers");
 
-// Helper: scale milliseconds by SPEEDUP, never return 0 for non-zero input
-static inline unsigned long scaled(unsigned long ms) {
-  if (ms == 0) return 0;
-  unsigned long result = ms / SPEEDUP;
-  return (result == 0) ? 1 : result;
+// Wrap-safe "chamber time a is at or after b"
+static inline bool reached(unsigned long a, unsigned long b) {
+  return (long)(a - b) >= 0;
 }
 
-// Timing constants (real-time values, will be scaled)
+// Timing constants (chamber time, see chamber_clock.h)
 static constexpr unsigned long RT_SAMPLE_PERIOD_MS = 1000;          // 1 second sampling
-static constexpr unsigned long RT_POLL_PERIOD_MS = 200;             // 200ms UI poll (not scaled, already fast)
+static constexpr unsigned long RT_MAX_CATCHUP_STEPS = 600;          // Simulated steps per read at most
+static constexpr unsigned long RT_POLL_PERIOD_MS = 200;             // 200ms UI poll (real time)
 static constexpr unsigned long RT_MEDIAN_SAMPLE_PERIOD_MS = 1000;   // 1000ms per median sample
 static constexpr unsigned long RT_MEASURE_SWIRL_DURATION_MS = 5000; // 5s swirl before measurement
 static constexpr unsigned long RT_MEDIAN_DURATION_MS = 5000;        // 5s median sampling (5 samples)
 static constexpr unsigned long RT_WAIT_BETWEEN_CYCLES_MS = 60000;   // 60s wait
 
-// Action durations (real-time)
-static constexpr unsigned long RT_CO2_SWIRL_MS = 10000;
-static constexpr unsigned long RT_CO2_SETTLE_MS = 20000;
-static constexpr unsigned long RT_RH_DOWN_FRESHAIR_MS = 10000;
-static constexpr unsigned long RT_RH_DOWN_SWIRL_MS = 10000;
-static constexpr unsigned long RT_RH_DOWN_SETTLE_MS = 20000;
-static constexpr unsigned long RT_RH_UP_FOGGER_MS = 5000;
-static constexpr unsigned long RT_RH_UP_MIX_MS = 10000;
-static constexpr unsigned long RT_RH_UP_SETTLE_MS = 120000;
-static constexpr unsigned long RT_BASELINE_FRESHAIR_MS = 10000;
-static constexpr unsigned long RT_BASELINE_SETTLE_MS = 10000;
-
-// Lockout and baseline timing (real-time)
-static constexpr unsigned long RT_RH_LOCKOUT_MS = 180000;       // 3 minutes
+// Action steps and lockouts: see action_recipes.h
+
+// Baseline timing (chamber time)
 static constexpr unsigned long RT_BASELINE_INTERVAL_MS = 600000; // 10 minutes
 
-// Thresholds (loaded from storage)
-static uint16_t g_co2_setpoint = 800;  // ppm
-static float g_rh_setpoint = 95.0f;     // %
-static float g_temp_setpoint = 25.0f;   // °C
-static constexpr float RH_HYSTERESIS = 2.0f; // Use setpoint ± 2% for high/low thresholds
+static constexpr int16_t RH_HYSTERESIS_X10 = 20; // Use setpoint ± 2% for high/low thresholds
 
 // Median sample count
 static constexpr uint8_t MEDIAN_SAMPLE_COUNT = 5;
 
-// --- RingBuffer<T, 200> ---
-
-template<typename T, uint16_t N>
-class SensorRingBuffer {
-private:
-  T buffer[N];
-  uint16_t head;
-  uint16_t count;
-
-public:
-  SensorRingBuffer() : head(0), count(0) {
-    for (uint16_t i = 0; i < N; i++) {
-      buffer[i] = 0;
-    }
-  }
-
-  void push(T value) {
-    buffer[head] = value;
-    head = (head + 1) % N;
-    if (count < N) count++;
-  }
-
-  void getAll(T *out) const {
-    if (count < N) {
-      // Buffer not full: fill with zeros, then real data
-      uint16_t fillCount = N - count;
-      for (uint16_t i = 0; i < fillCount; i++) {
-        out[i] = 0;
-      }
-      // Copy real data oldest->newest
-      uint16_t start = 0;
-      for (uint16_t i = 0; i < count; i++) {
-        out[fillCount + i] = buffer[(start + i) % N];
-      }
-    } else {
-      // Buffer full: head points to oldest
-      for (uint16_t i = 0; i < N; i++) {
-        out[i] = buffer[(head + i) % N];
-      }
-    }
-  }
-
-  uint16_t size() const { return count; }
-};
-
 // --- SimSensor ---
 
-#if SIMULATE_SENSORS
+#if CC_SIM_SENSOR
 
 class SimSensor {
 private:
@@ -127,28 +94,35 @@ private:
   float co2_2Drift;
   uint8_t co2PulseCounter;
   uint8_t co2_2PulseCounter;
+  XorShift32 rng;
 
   float randomWalk(float current, float &drift, float min, float max, float noise, float driftSpeed) {
     // Update drift
-    drift += (random(-100, 101) / 10000.0f) * driftSpeed;
+    drift += (rng.range(-100, 101) / 10000.0f) * driftSpeed;
     drift = constrain(drift, -0.05f, 0.05f);
     
     // Apply drift and noise
-    float value = current + drift + (random(-100, 101) / 1000.0f) * noise;
+    float value = current + drift + (rng.range(-100, 101) / 1000.0f) * noise;
     return constrain(value, min, max);
   }
 
 public:
   SimSensor() : rh(92.0f), rh_2(90.5f), temp(25.0f), temp_2(24.0f), temp_outer(22.0f), co2(800), co2_2(820), lastUpdate(0), 
                 rhDrift(0), rh_2Drift(0), tempDrift(0), temp_2Drift(0), tempOuterDrift(0), co2Drift(0), co2_2Drift(0), 
-                co2PulseCounter(0), co2_2PulseCounter(0) {
-    randomSeed(analogRead(0));
-  }
+                co2PulseCounter(0), co2_2PulseCounter(0), rng(Config::Simulation::SEED) {}
+
+  // Same seed, same scenario: the walks depend on nothing else
+  void seed(uint32_t value) { rng.seed(value); }
 
+  // One random-walk step per RT_SAMPLE_PERIOD_MS of chamber time, however
+  // far the clock moved since the last read
   Sensors read() {
-    unsigned long now = millis();
-    if (now - lastUpdate >= scaled(RT_SAMPLE_PERIOD_MS)) {
-      lastUpdate = now;
+    unsigned long now = chamber_clock_now();
+    if (now - lastUpdate >= RT_MAX_CATCHUP_STEPS * RT_SAMPLE_PERIOD_MS) {
+      lastUpdate = now - RT_SAMPLE_PERIOD_MS; // Long leap: one step instead of a burst
+    }
+    while (now - lastUpdate >= RT_SAMPLE_PERIOD_MS) {
+      lastUpdate += RT_SAMPLE_PERIOD_MS;
       
       // Update RH (85..99.5)
       rh = randomWalk(rh, rhDrift, 85.0f, 99.5f, 0.3f, 0.5f);
@@ -166,669 +140,1323 @@ public:
       temp_outer = randomWalk(temp_outer, tempOuterDrift, 15.0f, 32.0f, 0.2f, 0.3f);
       
       // Update CO2 with occasional pulses (450..3000)
-      co2Drift += (random(-100, 101) / 100.0f);
+      co2Drift += (rng.range(-100, 101) / 100.0f);
       co2Drift = constrain(co2Drift, -10.0f, 10.0f);
       
-      int co2Value = co2 + (int)co2Drift + random(-20, 21);
+      int co2Value = co2 + (int)co2Drift + rng.range(-20, 21);
       
       // Occasional CO2 pulse
       if (co2PulseCounter > 0) {
         co2Value += 500;
         co2PulseCounter--;
-      } else if (random(0, 1000) < 5) { // 0.5% chance
+      } else if (rng.range(0, 1000) < 5) { // 0.5% chance
         co2PulseCounter = 10;
       }
       
       co2 = constrain(co2Value, 450, 3000);
       
       // Update CO2_2 with slightly different values (offset by 10-30 ppm)
-      co2_2Drift += (random(-100, 101) / 100.0f);
+      co2_2Drift += (rng.range(-100, 101) / 100.0f);
       co2_2Drift = constrain(co2_2Drift, -10.0f, 10.0f);
       
-      int co2_2Value = co2_2 + (int)co2_2Drift + random(-20, 21);
+      int co2_2Value = co2_2 + (int)co2_2Drift + rng.range(-20, 21);
       
       // Occasional CO2_2 pulse (different timing than CO2)
       if (co2_2PulseCounter > 0) {
         co2_2Value += 500;
         co2_2PulseCounter--;
-      } else if (random(0, 1000) < 3) { // 0.3% chance
+      } else if (rng.range(0, 1000) < 3) { // 0.3% chance
         co2_2PulseCounter = 10;
       }
       
       co2_2 = constrain(co2_2Value, 450, 3000);
     }
     
-    return {co2, co2_2, rh, rh_2, temp, temp_2, temp_outer};
+    return {{fixed_ppm(co2), fixed_ppm(co2_2), fixed_tenths(rh), fixed_tenths(rh_2),
+             fixed_tenths(temp), fixed_tenths(temp_2), fixed_tenths(temp_outer)}};
   }
 };
 
-static SimSensor g_simSensor;
-
 #endif
 
-// Read sensors (simulated or real)
-static Sensors readSensors3() {
-#if SIMULATE_SENSORS
-  return g_simSensor.read();
-#else
-  // TODO: Read real sensors here
-  // For now, return dummy values
-  return {500, 520, 50.0f, 51.0f, 20.0f, 19.5f, 18.0f};
-#endif
-}
+// Validity of the individual values in a sensor frame
+enum SensorValidBits : uint8_t {
+  SENSOR_VALID_CO2 = 1 << 0,
+  SENSOR_VALID_CO2_2 = 1 << 1,
+  SENSOR_VALID_RH = 1 << 2,
+  SENSOR_VALID_RH_2 = 1 << 3,
+  SENSOR_VALID_TEMP = 1 << 4,
+  SENSOR_VALID_TEMP_2 = 1 << 5,
+  SENSOR_VALID_TEMP_OUTER = 1 << 6,
+  SENSOR_VALID_ALL = 0x7F
+};
 
-// --- Median helpers (N=10, even median = average of middle two) ---
+static_assert(SENSOR_VALID_CO2 == 1 << SERIES_CO2 && SENSOR_VALID_CO2_2 == 1 << SERIES_CO2_2 &&
+              SENSOR_VALID_RH == 1 << SERIES_RH && SENSOR_VALID_TEMP == 1 << SERIES_TEMP,
+              "AlarmInputs::valid takes the bits in series order");
 
-template<typename T>
-static void sortArray(T *arr, uint8_t n) {
-  for (uint8_t i = 0; i < n - 1; i++) {
-    for (uint8_t j = 0; j < n - i - 1; j++) {
-      if (arr[j] > arr[j + 1]) {
-        T temp = arr[j];
-        arr[j] = arr[j + 1];
-        arr[j + 1] = temp;
-      }
-    }
-  }
-}
+// --- Sensor frame cache (one acquisition shared by sample, filter and heater) ---
 
-static float medianFloat(float *values, uint8_t n) {
-  if (n == 0) return 0.0f;
-  float sorted[MEDIAN_SAMPLE_COUNT];
-  for (uint8_t i = 0; i < n; i++) {
-    sorted[i] = values[i];
-  }
-  sortArray(sorted, n);
-  
-  if (n % 2 == 0) {
-    // Even: average of middle two
-    return (sorted[n/2 - 1] + sorted[n/2]) / 2.0f;
-  } else {
-    return sorted[n/2];
-  }
-}
+struct SensorFrame {
+  Sensors values;
+  unsigned long timestampMs;  // Scheduler time of the acquisition
+  uint8_t valid;              // SENSOR_VALID_* bits
+};
 
-static int medianInt(int *values, uint8_t n) {
-  if (n == 0) return 0;
-  int sorted[MEDIAN_SAMPLE_COUNT];
-  for (uint8_t i = 0; i < n; i++) {
-    sorted[i] = values[i];
-  }
-  sortArray(sorted, n);
-  
-  if (n % 2 == 0) {
-    return (sorted[n/2 - 1] + sorted[n/2]) / 2;
-  } else {
-    return sorted[n/2];
+// --- Streaming filters (one sliding window per evaluated channel, fed by sampleTick) ---
+
+// Robust estimate in the fixed point of the filtered channel; the median
+// stays integer, the means are rounded back
+template<typename F>
+static int16_t robustValue(const F &filter) {
+  switch (Config::Filter::ESTIMATE) {
+    case Config::Filter::ESTIMATE_TRIMMED_MEAN: return fixed_from_float(filter.trimmedMean(Config::Filter::TRIM), 1.0f);
+    case Config::Filter::ESTIMATE_HAMPEL:       return fixed_from_float(filter.hampelMean(Config::Filter::HAMPEL_K), 1.0f);
+    default:                                    return filter.median();
   }
 }
 
-// --- Actions + Context + IO wrapper ---
+// --- Action context ---
+
+struct ActionContext {
+  ActionType currentAction;
+  uint8_t step;                               // Index into the recipe's steps
+  unsigned long stepStartMs;
+  unsigned long lockoutUntilMs[ACTION_COUNT];
+  unsigned long lastVentilationMs;
+  uint8_t pending;                            // actionBit() of queued requests
+
+  ActionContext() : currentAction(ACTION_NONE), step(0), stepStartMs(0),
+                    lockoutUntilMs(), lastVentilationMs(0), pending(0) {}
+};
 
-enum ActionType {
-  ACTION_NONE,
-  ACTION_CO2,
-  ACTION_RH_DOWN,
-  ACTION_RH_UP,
-  ACTION_BASELINE
+// Heater and fogger loops, stepped by heaterTick()
+struct LoopContext {
+  PidController pid;
+  SlowPwm pwm;
+  LoopStats stats;
+  ControlLoopStatus status;
 };
 
-enum ActionStage {
-  STAGE_IDLE,
-  STAGE_CO2_SWIRL,
-  STAGE_CO2_SETTLE,
-  STAGE_RH_DOWN_FRESHAIR,
-  STAGE_RH_DOWN_SWIRL,
-  STAGE_RH_DOWN_SETTLE,
-  STAGE_RH_UP_FOGGER,
-  STAGE_RH_UP_MIX,
-  STAGE_RH_UP_SETTLE,
-  STAGE_BASELINE_FRESHAIR,
-  STAGE_BASELINE_SETTLE
+// Tripped safety limits (safetyCheck)
+enum SafetyBits : uint8_t {
+  SAFETY_CO2 = 1 << 0,
+  SAFETY_TEMP = 1 << 1
 };
 
-struct ActionContext {
-  ActionType currentAction;
-  ActionStage currentStage;
+// --- Measurement state machine (MEASURE_SWIRL / MEASURE_MEDIAN / EVALUATE / WAIT) ---
+
+enum MeasureStage {
+  MEASURE_IDLE,
+  MEASURE_SWIRL,
+  MEASURE_MEDIAN,
+  MEASURE_EVALUATE,
+  MEASURE_WAIT
+};
+
+struct MeasureContext {
+  MeasureStage stage;
   unsigned long stageStartMs;
-  unsigned long rhUpLockoutUntilMs;
-  unsigned long rhDownLockoutUntilMs;
-  unsigned long lastVentilationMs;
-  
-  ActionContext() : currentAction(ACTION_NONE), currentStage(STAGE_IDLE),
-                    stageStartMs(0), rhUpLockoutUntilMs(0), 
-                    rhDownLockoutUntilMs(0), lastVentilationMs(0) {}
+  uint32_t filterStart;  // Filter pushes when the median stage began
+  unsigned long waitMs;  // Current wait, grows while readings stay steady (Config::Measure)
+
+  MeasureContext() : stage(MEASURE_IDLE), stageStartMs(0), filterStart(0), waitMs(RT_WAIT_BETWEEN_CYCLES_MS) {}
+};
+
+static std::atomic<uint32_t> g_snapshotRetries(0);
+
+// --- One chamber (Config::Chambers::MAPS entry) ---
+
+// All control state of one chamber. Every instance runs the same state
+// machines on its own outputs, inputs and settings; the scheduler tasks
+// step all of them in turn.
+class ChamberController {
+public:
+  ChamberController()
+      : id(0), map(&Config::Chambers::MAPS[0]), frame(), frameAcquired(false),
+        swirlerState(false), freshAirState(false), foggerState(false), heaterState(false),
+        safetyTrips(0), tier1m(nullptr), tier15m(nullptr),
+        published(), nextSampleMs(0), nextFilterMs(0), heaterCheckMs(0), lastLoopStepMs(0),
+        co2Setpoint(800), rhSetpoint_x10(950), tempSetpoint_x10(250) {}
+
+  void init(uint8_t chamber);
+
+  void sampleTick(unsigned long now);
+  void measurementTick(unsigned long now);
+  void actionTick(unsigned long now);
+  void heaterTick(unsigned long now);
+
+  unsigned long actionNextMs(unsigned long now) const;
+  unsigned long heaterNextMs() const;
+  unsigned long measureNextMs(unsigned long now) const;
+  unsigned long sampleNextMs(unsigned long now) const;
+
+  void setSetting(SettingKey key, int32_t raw) { storage_set_chamber_setting(id, key, raw); }
+  void applyStoredSetpoints();
+  void setCo2Setpoint(uint16_t ppm);
+  void setRhSetpoint(float percent);
+  void setTempSetpoint(float celsius);
+  uint16_t co2SetpointPpm() const { return co2Setpoint; }
+  float rhSetpointPercent() const { return fixed_tenths_to_float(rhSetpoint_x10); }
+  float tempSetpointCelsius() const { return fixed_tenths_to_float(tempSetpoint_x10); }
+
+  void readSnapshot(ControllerSnapshot *out) const {
+    uint16_t retries = snapshot.read(out);
+    if (retries > 0) g_snapshotRetries.fetch_add(retries, std::memory_order_relaxed);
+  }
+
+  const SensorHistory<SENSOR_SERIES_COUNT, HISTORY_CAPACITY> &samples() const { return history; }
+  // Null only if the arena could not hold them (SDRAM down)
+  const Tier1m *tier1() const { return tier1m; }
+  const Tier15m *tier15() const { return tier15m; }
+
+private:
+  uint8_t id;
+  const Config::Chambers::Map *map;
+
+  // Sensor frame cache
+  SensorFrame frame;
+  bool frameAcquired;
+#if CC_SIM_SENSOR
+  SimSensor simSensor;
+#endif
+
+  // Streaming filters
+  RunningFilter<int16_t, MEDIAN_SAMPLE_COUNT> co2Filter;
+  RunningFilter<int16_t, MEDIAN_SAMPLE_COUNT> rhFilter;
+  RunningFilter<int16_t, MEDIAN_SAMPLE_COUNT> tempFilter;
+
+  // Trend and sensor agreement for the adaptive measurement cycle
+  TrendStats co2Trend;
+  TrendStats rhTrend;
+  TrendStats tempTrend;
+  AgreementStats co2Agreement;
+  AgreementStats rhAgreement;
+
+  // Output state tracking
+  bool swirlerState;
+  bool freshAirState;
+  bool foggerState;
+  bool heaterState;
+
+  // Controller (actions run to completion unless a safety limit trips)
+  ActionContext actionCtx;
+  LoopContext loops[CONTROL_LOOP_COUNT];
+  uint8_t safetyTrips;
+  MeasureContext measureCtx;
+
+  // Sensor values as fixed-point channels, actuators as one packed state word
+  SensorHistory<SENSOR_SERIES_COUNT, HISTORY_CAPACITY> history;
+  Tier1m *tier1m;    // Memory arena, built once in init()
+  Tier15m *tier15m;
+
+  // Published state for readers on other threads (controller_snapshot)
+  SeqLock<ControllerSnapshot> snapshot;
+  ControllerSnapshot published;  // Writer-side copy, sensors of the newest sample
+
+  // Sample tick: feed the streaming filters and add one frame to the history
+  unsigned long nextSampleMs;
+  unsigned long nextFilterMs;
+  unsigned long heaterCheckMs;
+  unsigned long lastLoopStepMs;
+
+  // Thresholds (loaded from storage)
+  uint16_t co2Setpoint;      // ppm
+  int16_t rhSetpoint_x10;    // % x10
+  int16_t tempSetpoint_x10;  // °C x10
+
+  void logEvent(EventId event, int32_t a0 = 0, int32_t a1 = 0, int32_t a2 = 0) const {
+    event_log_chamber(id, event, a0, a1, a2);
+  }
+
+  Sensors readSensors(uint8_t *valid);
+  const SensorFrame &sensorFrame(unsigned long now, unsigned long maxAgeMs);
+  Sensors filteredSensors() const;
+
+  void setSwirler(bool on);
+  void setFreshAir(bool on);
+  void setFogger(bool on);
+  void setHeater(bool on);
+  void allOutputsOff();
+
+  void applyActionOutputs(uint8_t from, uint8_t to);
+  void enterStep(uint8_t index, unsigned long now, uint8_t previous);
+  bool actionLockedOut(ActionType action, unsigned long now) const;
+  bool baselineDue(unsigned long now) const;
+  void startAction(ActionType action, unsigned long now);
+  void endAction(unsigned long now);
+  void dispatchPending(unsigned long now);
+  void preemptAction(ActionType action, unsigned long now);
+  void evaluate(const Sensors &medianSensors, unsigned long now);
+  void safetyCheck(unsigned long now);
+
+  void trendUpdate(const SensorFrame &current);
+  bool airMixed() const;
+  bool readingsSteady() const;
+  bool thresholdAhead() const;
+  void startCycle(unsigned long now, EventId swirlEvent);
+
+  uint8_t currentActuatorBits() const;
+  void publishSnapshot();
+
+  uint8_t loopMode(SettingKey key) const;
+  void heaterStep(const SensorFrame &frame, unsigned long now, float dtS);
+  void foggerStep(const SensorFrame &frame, unsigned long now, float dtS);
 };
 
-// Output state tracking
-static bool g_swirlerState = false;
-static bool g_freshAirState = false;
-static bool g_foggerState = false;
-static bool g_heaterState = false;
+// Hot control state: DTCM with CC_MEMORY_PLACEMENT (tiers are in the arena)
+FAST_DATA static ChamberController g_chambers[Config::Chambers::COUNT];
+
+// Out-of-range ids read chamber 0 (the web server rejects them earlier)
+static ChamberController &chamberAt(uint8_t chamber) {
+  return g_chambers[(chamber < Config::Chambers::COUNT) ? chamber : 0];
+}
+
+#if !CC_SIM_SENSOR
+// One optional input of the chamber map (NO_INPUT = not wired)
+static bool readProbe(uint8_t channel, float *value) {
+  return channel != Config::Chambers::NO_INPUT && temp_probes_read((TempProbeChannel)channel, value);
+}
+
+static bool readAnalog(uint8_t channel, float *value) {
+  return channel != Config::Chambers::NO_INPUT && analog_inputs_read((AnalogInputChannel)channel, value);
+}
+#endif
+
+// Read sensors (trace replay, simulated or real); invalid values keep their placeholder
+Sensors ChamberController::readSensors(uint8_t *valid) {
+  Sensors traced;
+  if (id == 0 && sensor_trace_frame(chamber_clock_now(), &traced)) {
+    *valid = SENSOR_VALID_ALL;
+    return traced;
+  }
+#if CC_SIM_SENSOR
+  *valid = SENSOR_VALID_ALL;
+  return simSensor.read();
+#else
+  // Dummy values until a fresh reading exists; CO2/RH from the decimated
+  // analog inputs, temperatures from the probe round robin, Modbus
+  // transmitters (all seven values) take precedence when configured. Each
+  // reading is converted to fixed point here, once.
+  Sensors s = {{500, 520, 500, 510, 200, 195, 180}}; // HistorySeries order
+  uint8_t bits = 0;
+  float raw;
+  if (readAnalog(map->co2Input, &raw)) {
+    s.value[SERIES_CO2] = fixed_ppm(raw);
+    bits |= SENSOR_VALID_CO2;
+  }
+  if (readAnalog(map->rhInput, &raw)) {
+    s.value[SERIES_RH] = fixed_tenths(raw);
+    bits |= SENSOR_VALID_RH;
+  }
+  if (readProbe(map->tempProbe, &raw)) {
+    s.value[SERIES_TEMP] = fixed_tenths(raw);
+    bits |= SENSOR_VALID_TEMP;
+  }
+  if (readProbe(map->temp2Probe, &raw)) {
+    s.value[SERIES_TEMP_2] = fixed_tenths(raw);
+    bits |= SENSOR_VALID_TEMP_2;
+  }
+  if (readProbe(map->outerProbe, &raw)) {
+    s.value[SERIES_TEMP_OUTER] = fixed_tenths(raw);
+    bits |= SENSOR_VALID_TEMP_OUTER;
+  }
+  if (map->modbus) {
+    if (modbus_master_read(MODBUS_CO2, &raw)) {
+      s.value[SERIES_CO2] = fixed_ppm(raw);
+      bits |= SENSOR_VALID_CO2;
+    }
+    if (modbus_master_read(MODBUS_CO2_2, &raw)) {
+      s.value[SERIES_CO2_2] = fixed_ppm(raw);
+      bits |= SENSOR_VALID_CO2_2;
+    }
+    if (modbus_master_read(MODBUS_RH, &raw)) {
+      s.value[SERIES_RH] = fixed_tenths(raw);
+      bits |= SENSOR_VALID_RH;
+    }
+    if (modbus_master_read(MODBUS_RH_2, &raw)) {
+      s.value[SERIES_RH_2] = fixed_tenths(raw);
+      bits |= SENSOR_VALID_RH_2;
+    }
+    if (modbus_master_read(MODBUS_TEMP, &raw)) {
+      s.value[SERIES_TEMP] = fixed_tenths(raw);
+      bits |= SENSOR_VALID_TEMP;
+    }
+    if (modbus_master_read(MODBUS_TEMP_2, &raw)) {
+      s.value[SERIES_TEMP_2] = fixed_tenths(raw);
+      bits |= SENSOR_VALID_TEMP_2;
+    }
+    if (modbus_master_read(MODBUS_TEMP_OUTER, &raw)) {
+      s.value[SERIES_TEMP_OUTER] = fixed_tenths(raw);
+      bits |= SENSOR_VALID_TEMP_OUTER;
+    }
+  }
+  // Front ends stay off while simulating: the placeholders are the test data
+  *valid = Config::SIMULATE_SENSORS ? (uint8_t)SENSOR_VALID_ALL : bits;
+  return s;
+#endif
+}
+
+// Frame no older than maxAgeMs; only acquires when the cached one is too old
+const SensorFrame &ChamberController::sensorFrame(unsigned long now, unsigned long maxAgeMs) {
+  if (!frameAcquired || now - frame.timestampMs > maxAgeMs) {
+    frame.values = readSensors(&frame.valid);
+    frame.timestampMs = now;
+    frameAcquired = true;
+  }
+  return frame;
+}
+
+// Robust value of the last MEDIAN_SAMPLE_COUNT samples, available at any time
+Sensors ChamberController::filteredSensors() const {
+  Sensors s = {};
+  s.value[SERIES_CO2] = robustValue(co2Filter);
+  s.value[SERIES_RH] = robustValue(rhFilter);
+  s.value[SERIES_TEMP] = robustValue(tempFilter);
+  return s;
+}
 
-// IO Wrapper (adapt to your hardware)
-static void setSwirler(bool on) {
-  g_swirlerState = on;
-  // TODO: Implement real hardware control
-  Serial.print("Swirler: ");
-  Serial.println(on ? "ON" : "OFF");
+// IO Wrapper: only the shadow register is changed here, the outputs task
+// commits it to the DIGITAL OUTPUTS (channels in the chamber map); the
+// actuator statistics count the switch
+void ChamberController::setSwirler(bool on) {
+  swirlerState = on;
+  outputs_set(map->swirlerChannel, on);
+  actuator_stats_switch(id, ACTUATOR_BIT_SWIRLER, on, chamber_clock_now());
+  logEvent(EVT_SWIRLER, on);
 }
 
-static void setFreshAir(bool on) {
-  g_freshAirState = on;
-  // TODO: Implement real hardware control
-  Serial.print("FreshAir: ");
-  Serial.println(on ? "ON" : "OFF");
+void ChamberController::setFreshAir(bool on) {
+  freshAirState = on;
+  outputs_set(map->freshAirChannel, on);
+  actuator_stats_switch(id, ACTUATOR_BIT_FRESHAIR, on, chamber_clock_now());
+  logEvent(EVT_FRESHAIR, on);
 }
 
-static void setFogger(bool on) {
-  g_foggerState = on;
-  // TODO: Implement real hardware control
-  Serial.print("Fogger: ");
-  Serial.println(on ? "ON" : "OFF");
+void ChamberController::setFogger(bool on) {
+  foggerState = on;
+  outputs_set(map->foggerChannel, on);
+  actuator_stats_switch(id, ACTUATOR_BIT_FOGGER, on, chamber_clock_now());
+  logEvent(EVT_FOGGER, on);
 }
 
-static void setHeater(bool on) {
-  g_heaterState = on;
-  // TODO: Implement real hardware control
-  Serial.print("Heater: ");
-  Serial.println(on ? "ON" : "OFF");
+void ChamberController::setHeater(bool on) {
+  heaterState = on;
+  outputs_set(map->heaterChannel, on);
+  actuator_stats_switch(id, ACTUATOR_BIT_HEATER, on, chamber_clock_now());
+  logEvent(EVT_HEATER, on);
 }
 
-static void allOutputsOff() {
+void ChamberController::allOutputsOff() {
   setSwirler(false);
   setFreshAir(false);
   setFogger(false);
   setHeater(false);
 }
 
-// --- Controller (non-preemptive) ---
+// --- Controller (actions run to completion unless a safety limit trips) ---
+
+// Switch only the outputs whose bit differs between two step masks, so an
+// action never touches what it does not drive (e.g. the measurement swirl)
+void ChamberController::applyActionOutputs(uint8_t from, uint8_t to) {
+  uint8_t changed = (from ^ to) & ACTION_OUTPUT_MASK;
+  if (changed & ACTUATOR_BIT_FOGGER) setFogger(to & ACTUATOR_BIT_FOGGER);
+  if (changed & ACTUATOR_BIT_SWIRLER) setSwirler(to & ACTUATOR_BIT_SWIRLER);
+  if (changed & ACTUATOR_BIT_FRESHAIR) setFreshAir(to & ACTUATOR_BIT_FRESHAIR);
+}
+
+// Enter a step of the running recipe; `previous` is the mask currently held
+void ChamberController::enterStep(uint8_t index, unsigned long now, uint8_t previous) {
+  const ActionStep &step = ACTION_RECIPES[actionCtx.currentAction].steps[index];
+  actionCtx.step = index;
+  actionCtx.stepStartMs = now;
+  applyActionOutputs(previous, step.outputs);
+  if (step.flags & STEP_VENTILATES) actionCtx.lastVentilationMs = now;
+  logEvent(step.event);
+}
 
-static ActionContext g_actionCtx;
+bool ChamberController::actionLockedOut(ActionType action, unsigned long now) const {
+  return !reached(now, actionCtx.lockoutUntilMs[action]);
+}
+
+bool ChamberController::baselineDue(unsigned long now) const {
+  return actionCtx.lastVentilationMs > 0 &&
+         (now - actionCtx.lastVentilationMs) >= RT_BASELINE_INTERVAL_MS;
+}
 
 // Start an action (only if no action is running)
-static void startAction(ActionType action) {
-  if (g_actionCtx.currentAction != ACTION_NONE) {
-    return; // Action already running, don't preempt
-  }
-  
-  g_actionCtx.currentAction = action;
-  g_actionCtx.stageStartMs = millis();
-  
-  switch (action) {
-    case ACTION_CO2:
-      g_actionCtx.currentStage = STAGE_CO2_SWIRL;
-      setSwirler(true);
-      Serial.println("Action: CO2 - SWIRL");
-      break;
-      
-    case ACTION_RH_DOWN:
-      g_actionCtx.currentStage = STAGE_RH_DOWN_FRESHAIR;
-      setFreshAir(true);
-      g_actionCtx.lastVentilationMs = millis();
-      Serial.println("Action: RH_DOWN - FRESHAIR");
-      break;
-      
-    case ACTION_RH_UP:
-      g_actionCtx.currentStage = STAGE_RH_UP_FOGGER;
-      setFogger(true);
-      Serial.println("Action: RH_UP - FOGGER");
-      break;
-      
-    case ACTION_BASELINE:
-      g_actionCtx.currentStage = STAGE_BASELINE_FRESHAIR;
-      setFreshAir(true);
-      g_actionCtx.lastVentilationMs = millis();
-      Serial.println("Action: BASELINE - FRESHAIR");
-      break;
-      
-    default:
-      break;
+void ChamberController::startAction(ActionType action, unsigned long now) {
+  if (actionCtx.currentAction != ACTION_NONE) {
+    return; // Action already running, the arbiter queues instead
   }
+  if (action == ACTION_NONE || action >= ACTION_COUNT) return;
+
+  actionCtx.currentAction = action;
+  if (id == 0) sensor_trace_action(action);
+  enterStep(0, now, 0);
 }
 
-// Tick action state machine
-static void actionTick() {
-  if (g_actionCtx.currentAction == ACTION_NONE) {
-    return;
+// Post-actions of the running recipe (outputs are switched by the caller)
+void ChamberController::endAction(unsigned long now) {
+  const ActionRecipe &recipe = ACTION_RECIPES[actionCtx.currentAction];
+  if (recipe.lockAction != ACTION_NONE) {
+    actionCtx.lockoutUntilMs[recipe.lockAction] = now + recipe.lockoutMs;
   }
-  
-  unsigned long now = millis();
-  unsigned long elapsed = now - g_actionCtx.stageStartMs;
-  
-  switch (g_actionCtx.currentStage) {
-    // --- CO2 Action ---
-    case STAGE_CO2_SWIRL:
-      if (elapsed >= scaled(RT_CO2_SWIRL_MS)) {
-        setSwirler(false);
-        g_actionCtx.currentStage = STAGE_CO2_SETTLE;
-        g_actionCtx.stageStartMs = now;
-        Serial.println("Action: CO2 - SETTLE");
-      }
-      break;
-      
-    case STAGE_CO2_SETTLE:
-      if (elapsed >= scaled(RT_CO2_SETTLE_MS)) {
-        allOutputsOff();
-        g_actionCtx.currentAction = ACTION_NONE;
-        g_actionCtx.currentStage = STAGE_IDLE;
-        Serial.println("Action: CO2 - COMPLETE");
-      }
-      break;
-      
-    // --- RH_DOWN Action ---
-    case STAGE_RH_DOWN_FRESHAIR:
-      if (elapsed >= scaled(RT_RH_DOWN_FRESHAIR_MS)) {
-        setFreshAir(false);
-        setSwirler(true);
-        g_actionCtx.currentStage = STAGE_RH_DOWN_SWIRL;
-        g_actionCtx.stageStartMs = now;
-        Serial.println("Action: RH_DOWN - SWIRL");
-      }
-      break;
-      
-    case STAGE_RH_DOWN_SWIRL:
-      if (elapsed >= scaled(RT_RH_DOWN_SWIRL_MS)) {
-        setSwirler(false);
-        g_actionCtx.currentStage = STAGE_RH_DOWN_SETTLE;
-        g_actionCtx.stageStartMs = now;
-        Serial.println("Action: RH_DOWN - SETTLE");
-      }
-      break;
-      
-    case STAGE_RH_DOWN_SETTLE:
-      if (elapsed >= scaled(RT_RH_DOWN_SETTLE_MS)) {
-        allOutputsOff();
-        g_actionCtx.rhUpLockoutUntilMs = now + scaled(RT_RH_LOCKOUT_MS);
-        g_actionCtx.currentAction = ACTION_NONE;
-        g_actionCtx.currentStage = STAGE_IDLE;
-        Serial.println("Action: RH_DOWN - COMPLETE (RH_UP locked for 3 min)");
-      }
-      break;
-      
-    // --- RH_UP Action ---
-    case STAGE_RH_UP_FOGGER:
-      if (elapsed >= scaled(RT_RH_UP_FOGGER_MS)) {
-        setSwirler(true);
-        setFreshAir(true);
-        // Fogger stays on
-        g_actionCtx.currentStage = STAGE_RH_UP_MIX;
-        g_actionCtx.stageStartMs = now;
-        g_actionCtx.lastVentilationMs = now;
-        Serial.println("Action: RH_UP - MIX");
-      }
-      break;
-      
-    case STAGE_RH_UP_MIX:
-      if (elapsed >= scaled(RT_RH_UP_MIX_MS)) {
-        allOutputsOff();
-        g_actionCtx.currentStage = STAGE_RH_UP_SETTLE;
-        g_actionCtx.stageStartMs = now;
-        Serial.println("Action: RH_UP - SETTLE");
-      }
-      break;
-      
-    case STAGE_RH_UP_SETTLE:
-      if (elapsed >= scaled(RT_RH_UP_SETTLE_MS)) {
-        allOutputsOff();
-        g_actionCtx.rhDownLockoutUntilMs = now + scaled(RT_RH_LOCKOUT_MS);
-        g_actionCtx.currentAction = ACTION_NONE;
-        g_actionCtx.currentStage = STAGE_IDLE;
-        Serial.println("Action: RH_UP - COMPLETE (RH_DOWN locked for 3 min)");
-      }
-      break;
-      
-    // --- Baseline Action ---
-    case STAGE_BASELINE_FRESHAIR:
-      if (elapsed >= scaled(RT_BASELINE_FRESHAIR_MS)) {
-        setFreshAir(false);
-        g_actionCtx.currentStage = STAGE_BASELINE_SETTLE;
-        g_actionCtx.stageStartMs = now;
-        Serial.println("Action: BASELINE - SETTLE");
-      }
-      break;
-      
-    case STAGE_BASELINE_SETTLE:
-      if (elapsed >= scaled(RT_BASELINE_SETTLE_MS)) {
-        allOutputsOff();
-        g_actionCtx.currentAction = ACTION_NONE;
-        g_actionCtx.currentStage = STAGE_IDLE;
-        Serial.println("Action: BASELINE - COMPLETE");
-      }
-      break;
-      
-    default:
-      break;
+  actionCtx.currentAction = ACTION_NONE;
+  actionCtx.step = 0;
+}
+
+// --- Arbitration (priority queue of requests, safety preemption) ---
+
+// Start the highest-priority pending action (lowest ActionType) that is
+// still wanted; at most ACTION_COUNT iterations
+void ChamberController::dispatchPending(unsigned long now) {
+  while (actionCtx.currentAction == ACTION_NONE && actionCtx.pending != 0) {
+    ActionType action = (ActionType)__builtin_ctz(actionCtx.pending);
+    actionCtx.pending &= (uint8_t)~actionBit(action);
+    if (actionLockedOut(action, now)) continue;
+    if (action == ACTION_BASELINE && !baselineDue(now)) continue; // Ventilated meanwhile
+    startAction(action, now);
   }
 }
 
-// Evaluate sensors and decide on action (only if no action running)
-static void controllerEvaluate(const Sensors &medianSensors) {
-  if (g_actionCtx.currentAction != ACTION_NONE) {
-    return; // Don't evaluate while action is running
+// Replace the running action by `action` at once. A settle step (no outputs)
+// is cut short and counts as completed; an active step is aborted and its
+// action queued again. Lockouts apply either way, so no RH correction can
+// follow its opposite right away.
+void ChamberController::preemptAction(ActionType action, unsigned long now) {
+  uint8_t held = 0;
+  if (actionCtx.currentAction != ACTION_NONE) {
+    ActionType running = actionCtx.currentAction;
+    const ActionRecipe &recipe = ACTION_RECIPES[running];
+    held = recipe.steps[actionCtx.step].outputs;
+    if (held == 0) {
+      logEvent(EVT_ACTION_SHORTENED, running, actionCtx.step);
+      logEvent(recipe.completeEvent);
+    } else {
+      logEvent(EVT_ACTION_PREEMPTED, running, actionCtx.step);
+      actionCtx.pending |= actionBit(running);
+    }
+    endAction(now);
   }
-  
-  unsigned long now = millis();
-  
-  // Priority 1: CO2 > setpoint
-  if (medianSensors.co2 > g_co2_setpoint) {
-    Serial.print("Controller: CO2 high (");
-    Serial.print(medianSensors.co2);
-    Serial.print(" ppm, setpoint=");
-    Serial.print(g_co2_setpoint);
-    Serial.println(") -> CO2 action");
-    startAction(ACTION_CO2);
+  actionCtx.currentAction = action;
+  enterStep(0, now, held); // Only the outputs that differ are switched
+}
+
+// Tick action sequencer: advance the running recipe by at most one step
+FAST_CODE void ChamberController::actionTick(unsigned long now) {
+  if (actionCtx.currentAction == ACTION_NONE) {
     return;
   }
-  
-  // Priority 2: RH > setpoint+hysteresis and RH_DOWN unlocked
-  float rhHighThreshold = g_rh_setpoint + RH_HYSTERESIS;
-  if (medianSensors.rh > rhHighThreshold && now >= g_actionCtx.rhDownLockoutUntilMs) {
-    Serial.print("Controller: RH high (");
-    Serial.print(medianSensors.rh);
-    Serial.print(" %, threshold=");
-    Serial.print(rhHighThreshold);
-    Serial.println(") -> RH_DOWN action");
-    startAction(ACTION_RH_DOWN);
+
+  const ActionRecipe &recipe = ACTION_RECIPES[actionCtx.currentAction];
+  const ActionStep &step = recipe.steps[actionCtx.step];
+  if (now - actionCtx.stepStartMs < step.durationMs) {
     return;
   }
-  
-  // Priority 3: RH < setpoint-hysteresis and RH_UP unlocked
-  float rhLowThreshold = g_rh_setpoint - RH_HYSTERESIS;
-  if (medianSensors.rh < rhLowThreshold && now >= g_actionCtx.rhUpLockoutUntilMs) {
-    Serial.print("Controller: RH low (");
-    Serial.print(medianSensors.rh);
-    Serial.print(" %, threshold=");
-    Serial.print(rhLowThreshold);
-    Serial.println(") -> RH_UP action");
-    startAction(ACTION_RH_UP);
+
+  if (actionCtx.step + 1 < recipe.stepCount) {
+    enterStep(actionCtx.step + 1, now, step.outputs);
     return;
   }
-  
+
+  // Last step done: post-actions, then whatever was queued meanwhile
+  // (a tripped limit keeps ventilating first)
+  applyActionOutputs(step.outputs, 0);
+  endAction(now);
+  logEvent(recipe.completeEvent);
+  if (safetyTrips != 0) {
+    startAction(ACTION_SAFETY, now);
+  } else {
+    dispatchPending(now);
+  }
+}
+
+// Evaluate sensors and request actions. Every condition that holds is
+// queued (the newest evaluation replaces the queue), the arbiter starts the
+// highest priority one as soon as no action runs
+void ChamberController::evaluate(const Sensors &medianSensors, unsigned long now) {
+  uint8_t wanted = 0;
+
+  // Priority 1: CO2 > setpoint
+  if (medianSensors.value[SERIES_CO2] > co2Setpoint) {
+    logEvent(EVT_CO2_HIGH, medianSensors.value[SERIES_CO2], co2Setpoint);
+    wanted |= actionBit(ACTION_CO2);
+  }
+
+  // Priority 2: RH > setpoint+hysteresis and RH_DOWN unlocked
+  int16_t rhHighThreshold = rhSetpoint_x10 + RH_HYSTERESIS_X10;
+  if (medianSensors.value[SERIES_RH] > rhHighThreshold && !actionLockedOut(ACTION_RH_DOWN, now)) {
+    logEvent(EVT_RH_HIGH, medianSensors.value[SERIES_RH], rhHighThreshold);
+    wanted |= actionBit(ACTION_RH_DOWN);
+  }
+
+  // Priority 3: RH < setpoint-hysteresis, RH_UP unlocked and the fogger not in PI mode
+  int16_t rhLowThreshold = rhSetpoint_x10 - RH_HYSTERESIS_X10;
+  if (medianSensors.value[SERIES_RH] < rhLowThreshold && !actionLockedOut(ACTION_RH_UP, now) &&
+      storage_get_chamber_setting(id, SETTING_FOGGER_MODE) != Config::Control::MODE_PI) {
+    logEvent(EVT_RH_LOW, medianSensors.value[SERIES_RH], rhLowThreshold);
+    wanted |= actionBit(ACTION_RH_UP);
+  }
+
   // Priority 4: Baseline (no ventilation for 10 minutes)
-  if (g_actionCtx.lastVentilationMs > 0 && 
-      (now - g_actionCtx.lastVentilationMs) >= scaled(RT_BASELINE_INTERVAL_MS)) {
-    Serial.println("Controller: Baseline due (no ventilation for 10 min)");
-    startAction(ACTION_BASELINE);
-    return;
+  if (baselineDue(now)) {
+    logEvent(EVT_BASELINE_DUE);
+    wanted |= actionBit(ACTION_BASELINE);
   }
-  
-  // Otherwise: wait
+
+  // The running action already answers its own condition
+  wanted &= (uint8_t)~actionBit(actionCtx.currentAction);
+  actionCtx.pending = wanted;
+  if (wanted != 0 && actionCtx.currentAction != ACTION_NONE) {
+    logEvent(EVT_ACTIONS_QUEUED, wanted, actionCtx.currentAction);
+  }
+  dispatchPending(now);
 }
 
-// --- Measurement state machine (MEASURE_SWIRL / MEASURE_MEDIAN / EVALUATE / WAIT) ---
+// --- Safety overrides (critical limits, checked on every filter sample) ---
+
+// Trip on the filtered value above the limit, clear below limit - re-arm
+// margin. While any limit is tripped the SAFETY action runs back to back
+// and queued requests wait.
+void ChamberController::safetyCheck(unsigned long now) {
+  if (!co2Filter.full()) return; // Not enough samples for a robust value
+  Sensors s = filteredSensors();
+  uint8_t trips = safetyTrips;
+
+  int32_t co2Limit = storage_get_chamber_setting(id, SETTING_CO2_LIMIT);
+  if (s.value[SERIES_CO2] > co2Limit) {
+    if (!(trips & SAFETY_CO2)) logEvent(EVT_CO2_CRITICAL, s.value[SERIES_CO2], co2Limit);
+    trips |= SAFETY_CO2;
+  } else if (s.value[SERIES_CO2] < co2Limit - (int32_t)Config::Safety::CO2_REARM_PPM) {
+    trips &= (uint8_t)~SAFETY_CO2;
+  }
 
-enum MeasureStage {
-  MEASURE_IDLE,
-  MEASURE_SWIRL,
-  MEASURE_MEDIAN,
-  MEASURE_EVALUATE,
-  MEASURE_WAIT
-};
+  int32_t tempLimit = storage_get_chamber_setting(id, SETTING_TEMP_LIMIT); // °C x10
+  if (s.value[SERIES_TEMP] > tempLimit) {
+    if (!(trips & SAFETY_TEMP)) logEvent(EVT_TEMP_CRITICAL, s.value[SERIES_TEMP], tempLimit);
+    trips |= SAFETY_TEMP;
+  } else if (s.value[SERIES_TEMP] < tempLimit - event_tenths(Config::Safety::TEMP_REARM)) {
+    trips &= (uint8_t)~SAFETY_TEMP;
+  }
 
-struct MeasureContext {
-  MeasureStage stage;
-  unsigned long stageStartMs;
-  unsigned long nextSampleMs;
-  uint8_t sampleIndex;
-  float rhSamples[MEDIAN_SAMPLE_COUNT];
-  float tempSamples[MEDIAN_SAMPLE_COUNT];
-  int co2Samples[MEDIAN_SAMPLE_COUNT];
-  
-  MeasureContext() : stage(MEASURE_IDLE), stageStartMs(0), nextSampleMs(0), sampleIndex(0) {}
-};
+  if (trips == 0 && safetyTrips != 0) logEvent(EVT_SAFETY_CLEAR);
+  safetyTrips = trips;
+  if (trips != 0 && actionCtx.currentAction != ACTION_SAFETY) {
+    preemptAction(ACTION_SAFETY, now);
+  }
+}
 
-static MeasureContext g_measureCtx;
+// --- Adaptive measurement cycle (Config::Measure) ---
+
+// Feed the trends with one filter sample. Agreement needs both sensors of a
+// pair; a missing one forgets it, so a stale agreement never skips a swirl.
+void ChamberController::trendUpdate(const SensorFrame &current) {
+  const float dtS = RT_MEDIAN_SAMPLE_PERIOD_MS / 1000.0f;
+  const int16_t *v = current.values.value;
+  TrendStats *trends[] = {&co2Trend, &rhTrend, &tempTrend};
+  const uint8_t series[] = {SERIES_CO2, SERIES_RH, SERIES_TEMP};
+  const uint8_t bits[] = {SENSOR_VALID_CO2, SENSOR_VALID_RH, SENSOR_VALID_TEMP};
+  for (uint8_t i = 0; i < 3; i++) {
+    if (current.valid & bits[i]) {
+      trends[i]->update(v[series[i]], dtS, Config::Measure::TREND_ALPHA, Config::Measure::TREND_BETA);
+    } else {
+      trends[i]->reset();
+    }
+  }
 
-static void measurementTick() {
-  unsigned long now = millis();
-  
-  switch (g_measureCtx.stage) {
+  const uint8_t co2Pair = SENSOR_VALID_CO2 | SENSOR_VALID_CO2_2;
+  const uint8_t rhPair = SENSOR_VALID_RH | SENSOR_VALID_RH_2;
+  if ((current.valid & co2Pair) == co2Pair) {
+    co2Agreement.update(v[SERIES_CO2], v[SERIES_CO2_2], Config::Measure::TREND_ALPHA);
+  } else {
+    co2Agreement.reset();
+  }
+  if ((current.valid & rhPair) == rhPair) {
+    rhAgreement.update(v[SERIES_RH], v[SERIES_RH_2], Config::Measure::TREND_ALPHA);
+  } else {
+    rhAgreement.reset();
+  }
+}
+
+// Main and secondary sensors agree and the filter window is full. Without
+// any secondary sensor the air never counts as mixed (always swirl).
+bool ChamberController::airMixed() const {
+  if (!Config::Measure::ADAPTIVE || !rhFilter.full()) return false;
+  if (!co2Agreement.ready() && !rhAgreement.ready()) return false;
+  if (co2Agreement.ready() && co2Agreement.difference() > Config::Measure::CO2_AGREE_PPM) return false;
+  if (rhAgreement.ready() && rhAgreement.difference() > Config::Measure::RH_AGREE_X10) return false;
+  return true;
+}
+
+static bool trend_steady(const TrendStats &trend, float band) {
+  const float horizonS = Config::Measure::PREDICT_HORIZON_MS / 1000.0f;
+  return trend.ready() && trend.spread() <= band && fabsf(trend.slopePerS()) * horizonS <= band;
+}
+
+// Little noise and little drift over the prediction horizon on all channels
+bool ChamberController::readingsSteady() const {
+  return trend_steady(co2Trend, Config::Measure::CO2_STEADY_PPM) &&
+         trend_steady(rhTrend, Config::Measure::RH_STEADY_X10) &&
+         trend_steady(tempTrend, Config::Measure::TEMP_STEADY_X10);
+}
+
+// A level still inside a threshold that the trend carries across it within
+// the prediction horizon (levels already beyond wait for the regular cycle)
+bool ChamberController::thresholdAhead() const {
+  const float horizonS = Config::Measure::PREDICT_HORIZON_MS / 1000.0f;
+  if (co2Trend.ready() && co2Trend.level() <= co2Setpoint && co2Trend.predict(horizonS) > co2Setpoint) {
+    return true;
+  }
+  if (!rhTrend.ready()) return false;
+  float rhHigh = rhSetpoint_x10 + RH_HYSTERESIS_X10;
+  float rhLow = rhSetpoint_x10 - RH_HYSTERESIS_X10;
+  float rhAhead = rhTrend.predict(horizonS);
+  return (rhTrend.level() <= rhHigh && rhAhead > rhHigh) || (rhTrend.level() >= rhLow && rhAhead < rhLow);
+}
+
+// Swirl, or sample right away when the air is already mixed: the filter
+// window then holds MEDIAN_SAMPLE_COUNT valid samples
+void ChamberController::startCycle(unsigned long now, EventId swirlEvent) {
+  measureCtx.stageStartMs = now;
+  if (airMixed()) {
+    measureCtx.stage = MEASURE_MEDIAN;
+    measureCtx.filterStart = rhFilter.pushes() - MEDIAN_SAMPLE_COUNT;
+    logEvent(EVT_MEASURE_SWIRL_SKIPPED);
+    return;
+  }
+  measureCtx.stage = MEASURE_SWIRL;
+  setSwirler(true);
+  logEvent(swirlEvent);
+}
+
+FAST_CODE void ChamberController::measurementTick(unsigned long now) {
+  switch (measureCtx.stage) {
     case MEASURE_IDLE:
       // Start first measurement cycle
-      g_measureCtx.stage = MEASURE_SWIRL;
-      g_measureCtx.stageStartMs = now;
-      setSwirler(true);
-      Serial.println("Measurement: SWIRL");
+      startCycle(now, EVT_MEASURE_SWIRL);
       break;
-      
+
     case MEASURE_SWIRL:
-      if (now - g_measureCtx.stageStartMs >= scaled(RT_MEASURE_SWIRL_DURATION_MS)) {
+      {
+        unsigned long swirlMs = now - measureCtx.stageStartMs;
+        bool mixedEarly = swirlMs >= Config::Measure::SWIRL_MIN_MS && airMixed();
+        if (swirlMs < RT_MEASURE_SWIRL_DURATION_MS && !mixedEarly) break;
+        if (swirlMs < RT_MEASURE_SWIRL_DURATION_MS) logEvent(EVT_MEASURE_SWIRL_SHORT, swirlMs);
         setSwirler(false);
-        g_measureCtx.stage = MEASURE_MEDIAN;
-        g_measureCtx.stageStartMs = now;
-        g_measureCtx.nextSampleMs = now;
-        g_measureCtx.sampleIndex = 0;
-        Serial.println("Measurement: MEDIAN sampling");
+        measureCtx.stage = MEASURE_MEDIAN;
+        measureCtx.stageStartMs = now;
+        measureCtx.filterStart = rhFilter.pushes();
+        logEvent(EVT_MEASURE_MEDIAN);
       }
       break;
-      
+
     case MEASURE_MEDIAN:
-      if (now >= g_measureCtx.nextSampleMs && g_measureCtx.sampleIndex < MEDIAN_SAMPLE_COUNT) {
-        Sensors s = readSensors3();
-        g_measureCtx.rhSamples[g_measureCtx.sampleIndex] = s.rh;
-        g_measureCtx.tempSamples[g_measureCtx.sampleIndex] = s.temp;
-        g_measureCtx.co2Samples[g_measureCtx.sampleIndex] = s.co2;
-        g_measureCtx.sampleIndex++;
-        g_measureCtx.nextSampleMs += scaled(RT_MEDIAN_SAMPLE_PERIOD_MS);
-        
-        Serial.print("  Sample ");
-        Serial.print(g_measureCtx.sampleIndex);
-        Serial.print("/");
-        Serial.print(MEDIAN_SAMPLE_COUNT);
-        Serial.print(": RH=");
-        Serial.print(s.rh);
-        Serial.print(" Temp=");
-        Serial.print(s.temp);
-        Serial.print(" CO2=");
-        Serial.println(s.co2);
-      }
-      
-      if (g_measureCtx.sampleIndex >= MEDIAN_SAMPLE_COUNT) {
-        g_measureCtx.stage = MEASURE_EVALUATE;
-        Serial.println("Measurement: EVALUATE");
+      // Wait until the filter window holds only samples taken after the swirl
+      if (rhFilter.pushes() - measureCtx.filterStart >= MEDIAN_SAMPLE_COUNT) {
+        measureCtx.stage = MEASURE_EVALUATE;
+        logEvent(EVT_MEASURE_EVALUATE);
       }
       break;
-      
+
     case MEASURE_EVALUATE:
       {
-        Sensors medianSensors;
-        medianSensors.rh = medianFloat(g_measureCtx.rhSamples, MEDIAN_SAMPLE_COUNT);
-        medianSensors.temp = medianFloat(g_measureCtx.tempSamples, MEDIAN_SAMPLE_COUNT);
-        medianSensors.co2 = medianInt(g_measureCtx.co2Samples, MEDIAN_SAMPLE_COUNT);
-        
-        Serial.print("Median: RH=");
-        Serial.print(medianSensors.rh);
-        Serial.print(" Temp=");
-        Serial.print(medianSensors.temp);
-        Serial.print(" CO2=");
-        Serial.println(medianSensors.co2);
-        
-        controllerEvaluate(medianSensors);
-        
-        g_measureCtx.stage = MEASURE_WAIT;
-        g_measureCtx.stageStartMs = now;
-        Serial.println("Measurement: WAIT");
+        Sensors medianSensors = filteredSensors();
+
+        logEvent(EVT_MEASURE_RESULT, medianSensors.value[SERIES_RH], medianSensors.value[SERIES_TEMP],
+                 medianSensors.value[SERIES_CO2]);
+
+        evaluate(medianSensors, now);
+
+        // Nothing to do and nothing moving: wait twice as long next time
+        bool idle = actionCtx.currentAction == ACTION_NONE && actionCtx.pending == 0;
+        if (Config::Measure::ADAPTIVE && idle && readingsSteady()) {
+          unsigned long longer = measureCtx.waitMs * 2;
+          measureCtx.waitMs = (longer < Config::Measure::WAIT_MAX_MS) ? longer : Config::Measure::WAIT_MAX_MS;
+        } else {
+          measureCtx.waitMs = RT_WAIT_BETWEEN_CYCLES_MS;
+        }
+        measureCtx.stage = MEASURE_WAIT;
+        measureCtx.stageStartMs = now;
+        logEvent(EVT_MEASURE_WAIT, measureCtx.waitMs / 1000);
       }
       break;
-      
+
     case MEASURE_WAIT:
-      if (now - g_measureCtx.stageStartMs >= scaled(RT_WAIT_BETWEEN_CYCLES_MS)) {
-        g_measureCtx.stage = MEASURE_SWIRL;
-        g_measureCtx.stageStartMs = now;
-        setSwirler(true);
-        Serial.println("Measurement: SWIRL (new cycle)");
+      {
+        unsigned long waitedMs = now - measureCtx.stageStartMs;
+        if (waitedMs >= measureCtx.waitMs) {
+          startCycle(now, EVT_MEASURE_CYCLE);
+        } else if (Config::Measure::ADAPTIVE && waitedMs >= Config::Measure::WAIT_MIN_MS &&
+                   actionCtx.currentAction == ACTION_NONE && thresholdAhead()) {
+          logEvent(EVT_MEASURE_EARLY, waitedMs / 1000);
+          measureCtx.waitMs = RT_WAIT_BETWEEN_CYCLES_MS;
+          startCycle(now, EVT_MEASURE_CYCLE);
+        }
       }
       break;
   }
 }
 
-// --- Ring buffers for plotting ---
-
-static SensorRingBuffer<float, RING_BUFFER_SIZE> g_rhBuffer;
-static SensorRingBuffer<float, RING_BUFFER_SIZE> g_rh_2Buffer;
-static SensorRingBuffer<float, RING_BUFFER_SIZE> g_tempBuffer;
-static SensorRingBuffer<float, RING_BUFFER_SIZE> g_temp_2Buffer;
-static SensorRingBuffer<float, RING_BUFFER_SIZE> g_tempOuterBuffer;
-static SensorRingBuffer<int, RING_BUFFER_SIZE> g_co2Buffer;
-static SensorRingBuffer<int, RING_BUFFER_SIZE> g_co2_2Buffer;
-static SensorRingBuffer<int, RING_BUFFER_SIZE> g_foggerBuffer;
-static SensorRingBuffer<int, RING_BUFFER_SIZE> g_swirlerBuffer;
-static SensorRingBuffer<int, RING_BUFFER_SIZE> g_freshAirBuffer;
-static SensorRingBuffer<int, RING_BUFFER_SIZE> g_heaterBuffer;
-
-// Sample tick: read sensors and add to ring buffers
-static unsigned long g_nextSampleMs = 0;
-
-static void sampleTick() {
-  unsigned long now = millis();
-  if (now >= g_nextSampleMs) {
-    Sensors s = readSensors3();
-    g_rhBuffer.push(s.rh);
-    g_rh_2Buffer.push(s.rh_2);
-    g_tempBuffer.push(s.temp);
-    g_temp_2Buffer.push(s.temp_2);
-    g_tempOuterBuffer.push(s.temp_outer);
-    g_co2Buffer.push(s.co2);
-    g_co2_2Buffer.push(s.co2_2);
-    g_foggerBuffer.push(g_foggerState ? 1 : 0);
-    g_swirlerBuffer.push(g_swirlerState ? 1 : 0);
-    g_freshAirBuffer.push(g_freshAirState ? 1 : 0);
-    g_heaterBuffer.push(g_heaterState ? 1 : 0);
-    
+// --- Sample history for plotting (one SoA ring for all series) ---
+
+uint8_t ChamberController::currentActuatorBits() const {
+  uint8_t bits = 0;
+  if (foggerState) bits |= ACTUATOR_BIT_FOGGER;
+  if (swirlerState) bits |= ACTUATOR_BIT_SWIRLER;
+  if (freshAirState) bits |= ACTUATOR_BIT_FRESHAIR;
+  if (heaterState) bits |= ACTUATOR_BIT_HEATER;
+  return bits;
+}
+
+void ChamberController::publishSnapshot() {
+  published.seq = history.newestSeq();
+  published.actuators = currentActuatorBits();
+  published.co2_setpoint = co2Setpoint;
+  published.rh_setpoint_x10 = rhSetpoint_x10;
+  published.temp_setpoint_x10 = tempSetpoint_x10;
+  for (uint8_t i = 0; i < CONTROL_LOOP_COUNT; i++) {
+    published.loops[i] = loops[i].status;
+  }
+  snapshot.write(published);
+}
+
+FAST_CODE void ChamberController::sampleTick(unsigned long now) {
+  bool filterDue = reached(now, nextFilterMs);
+  bool historyDue = reached(now, nextSampleMs);
+  if (!filterDue && !historyDue) return;
+  const SensorFrame &current = sensorFrame(now, Config::SENSOR_FRAME_MAX_AGE_MS);
+  const Sensors &s = current.values;
+
+  if (filterDue) {
+    co2Filter.push(s.value[SERIES_CO2]);
+    rhFilter.push(s.value[SERIES_RH]);
+    tempFilter.push(s.value[SERIES_TEMP]);
+    trendUpdate(current);
+    safetyCheck(now);
+    if (nextFilterMs == 0) {
+      nextFilterMs = now + RT_MEDIAN_SAMPLE_PERIOD_MS;
+    } else {
+      nextFilterMs += RT_MEDIAN_SAMPLE_PERIOD_MS;
+    }
+  }
+
+  if (historyDue) {
+    const int16_t (&values)[SENSOR_SERIES_COUNT] = s.value; // Already in HistorySeries order
+    uint8_t actuators = currentActuatorBits();
+    history.push(values, actuators);
+    if (tier1m && tier1m->addSample(values, actuators)) {
+      tier15m->addBucket(*tier1m);
+    }
+    if (id == 0) { // The flash log and the USB stick record chamber 0
+      uint32_t epoch = wall_clock_now();
+      if (!sensor_trace_active()) sample_log_append(values, actuators, epoch); // Keep the replayed trace intact
+      usb_logger_append(values, actuators, epoch);
+      sensor_trace_sample(values, actuators, co2Setpoint, rhSetpoint_x10, tempSetpoint_x10);
+    }
+    actuator_stats_sample(id, now);
+    AlarmInputs alarmInputs = {values, current.valid, actuators, co2Setpoint, rhSetpoint_x10, tempSetpoint_x10};
+    alarms_sample(id, alarmInputs, now);
+    memcpy(published.sensors, values, sizeof(published.sensors));
+    publishSnapshot();
+
     // Drift-free scheduling
-    if (g_nextSampleMs == 0) {
-      g_nextSampleMs = now + scaled(Config::SAMPLE_INTERVAL_MS);
+    if (nextSampleMs == 0) {
+      nextSampleMs = now + Config::SAMPLE_INTERVAL_MS;
     } else {
-      g_nextSampleMs += scaled(Config::SAMPLE_INTERVAL_MS);
+      nextSampleMs += Config::SAMPLE_INTERVAL_MS;
     }
   }
 }
 
-// Heater control: independent temperature regulation with 1°C hysteresis
-static void heaterTick() {
-  static unsigned long lastCheckMs = 0;
-  unsigned long now = millis();
-  
-  // Check every second (scaled)
-  if (now - lastCheckMs < scaled(Config::HEATER_CHECK_INTERVAL_MS)) return;
-  lastCheckMs = now;
-  
-  Sensors s = readSensors3();
-  
-  // Hysteresis: turn on if temp < setpoint - 1, turn off if temp >= setpoint
-  if (!g_heaterState && s.temp < (g_temp_setpoint - 1.0f)) {
+// --- Heater and fogger loops (hysteresis or PI, Config::Control) ---
+
+uint8_t ChamberController::loopMode(SettingKey key) const {
+  return (storage_get_chamber_setting(id, key) == Config::Control::MODE_PI) ? Config::Control::MODE_PI
+                                                                             : Config::Control::MODE_HYSTERESIS;
+}
+
+// Mode switch: start the PI state from scratch
+static void updateLoopMode(LoopContext &loop, uint8_t mode) {
+  if (loop.status.mode == mode) return;
+  loop.status.mode = mode;
+  loop.pid.reset();
+  loop.pwm.reset();
+}
+
+static void accountLoop(LoopContext &loop, float setpoint, float value, bool on, unsigned long now,
+                        float band) {
+  loop.stats.update(setpoint, value, on, now, band, Config::Control::SETTLE_HOLD_MS);
+  LoopStatsValues v = loop.stats.values();
+  loop.status.setpoint = setpoint;
+  loop.status.value = value;
+  loop.status.overshoot = v.overshoot;
+  loop.status.settlingS = v.settlingMs / 1000.0f;
+  loop.status.settled = v.settled;
+  loop.status.duty = v.duty;
+}
+
+// Heater: hysteresis (on 1°C below the setpoint, off at the setpoint) or PI
+void ChamberController::heaterStep(const SensorFrame &frame, unsigned long now, float dtS) {
+  LoopContext &loop = loops[LOOP_HEATER];
+  updateLoopMode(loop, loopMode(SETTING_HEATER_MODE));
+  float setpoint = fixed_tenths_to_float(tempSetpoint_x10);
+  float temp = fixed_tenths_to_float(frame.values.value[SERIES_TEMP]);
+  if (!(frame.valid & SENSOR_VALID_TEMP)) {
+    // No fresh probe reading: never heat blind
+    if (heaterState) {
+      setHeater(false);
+      logEvent(EVT_HEATER_STALE);
+    }
+    loop.pid.reset();
+    return;
+  }
+  if (safetyTrips & SAFETY_TEMP) {
+    // Over-temperature interlock: off until the limit clears
+    if (heaterState) setHeater(false);
+    loop.pid.reset();
+    loop.status.output = 0.0f;
+    accountLoop(loop, setpoint, temp, false, now, Config::Control::TEMP_SETTLE_BAND);
+    return;
+  }
+
+  if (loop.status.mode == Config::Control::MODE_PI) {
+    float duty = loop.pid.update(setpoint, temp,
+                                 storage_get_chamber_setting_float(id, SETTING_HEATER_KP),
+                                 storage_get_chamber_setting_float(id, SETTING_HEATER_KI),
+                                 storage_get_chamber_setting_float(id, SETTING_HEATER_KD), dtS);
+    bool on = loop.pwm.update(duty, now, Config::Control::HEATER_PWM_WINDOW_MS,
+                              Config::Control::HEATER_MIN_SWITCH_MS);
+    if (on != heaterState) setHeater(on);
+    loop.status.output = duty;
+  } else if (!heaterState && frame.values.value[SERIES_TEMP] < tempSetpoint_x10 - FIXED_TENTHS_PER_UNIT) {
     setHeater(true);
-    Serial.print("Heater: ON (temp=");
-    Serial.print(s.temp, 1);
-    Serial.print(", setpoint=");
-    Serial.print(g_temp_setpoint, 1);
-    Serial.println(")!");
-  } else if (g_heaterState && s.temp >= g_temp_setpoint) {
+    logEvent(EVT_HEATER_ON, frame.values.value[SERIES_TEMP], tempSetpoint_x10);
+  } else if (heaterState && frame.values.value[SERIES_TEMP] >= tempSetpoint_x10) {
     setHeater(false);
-    Serial.print("Heater: OFF (temp=");
-    Serial.print(s.temp, 1);
-    Serial.print(", setpoint=");
-    Serial.print(g_temp_setpoint, 1);
-    Serial.println(")!");
+    logEvent(EVT_HEATER_OFF, frame.values.value[SERIES_TEMP], tempSetpoint_x10);
   }
+  if (loop.status.mode != Config::Control::MODE_PI) loop.status.output = heaterState ? 1.0f : 0.0f;
+  accountLoop(loop, setpoint, temp, heaterState, now, Config::Control::TEMP_SETTLE_BAND);
 }
 
-// --- Public API ---
+// Fogger: in hysteresis mode the RH_UP action fogs (only accounted here);
+// in PI mode the loop fogs continuously and RH_UP is not started
+void ChamberController::foggerStep(const SensorFrame &frame, unsigned long now, float dtS) {
+  LoopContext &loop = loops[LOOP_FOGGER];
+  uint8_t previousMode = loop.status.mode;
+  updateLoopMode(loop, loopMode(SETTING_FOGGER_MODE));
+  bool pi = loop.status.mode == Config::Control::MODE_PI;
+  if (!pi && previousMode == Config::Control::MODE_PI &&
+      actionCtx.currentAction != ACTION_RH_UP && foggerState) {
+    setFogger(false); // Hand the fogger back to the RH_UP action
+  }
+  if (!(frame.valid & SENSOR_VALID_RH)) {
+    if (pi && foggerState) setFogger(false);
+    loop.pid.reset();
+    return;
+  }
 
-void controller_init() {
-  Serial.println("Controller: Initializing...");
+  float setpoint = fixed_tenths_to_float(rhSetpoint_x10);
+  float rh = fixed_tenths_to_float(frame.values.value[SERIES_RH]);
+  if (pi) {
+    float duty = 0.0f;
+    if (actionCtx.currentAction == ACTION_RH_DOWN || actionCtx.currentAction == ACTION_SAFETY) {
+      loop.pid.reset(); // Fresh air is drying the chamber: do not fight it
+    } else {
+      duty = loop.pid.update(setpoint, rh,
+                             storage_get_chamber_setting_float(id, SETTING_FOGGER_KP),
+                             storage_get_chamber_setting_float(id, SETTING_FOGGER_KI), 0.0f, dtS);
+    }
+    bool on = loop.pwm.update(duty, now, Config::Control::FOGGER_PWM_WINDOW_MS,
+                              Config::Control::FOGGER_MIN_SWITCH_MS);
+    if (on != foggerState) setFogger(on);
+    loop.status.output = duty;
+  } else {
+    loop.status.output = foggerState ? 1.0f : 0.0f;
+  }
+  accountLoop(loop, setpoint, rh, foggerState, now, Config::Control::RH_SETTLE_BAND);
+}
+
+// Both loops step once per HEATER_CHECK_INTERVAL_MS (chamber time)
+FAST_CODE void ChamberController::heaterTick(unsigned long now) {
+  if (now - heaterCheckMs < Config::HEATER_CHECK_INTERVAL_MS) return;
+  heaterCheckMs = now;
+  float dtS = (lastLoopStepMs != 0) ? (now - lastLoopStepMs) / 1000.0f
+                                    : Config::HEATER_CHECK_INTERVAL_MS / 1000.0f;
+  lastLoopStepMs = now;
+
+  const SensorFrame &current = sensorFrame(now, Config::SENSOR_FRAME_MAX_AGE_MS);
+  heaterStep(current, now, dtS);
+  foggerStep(current, now, dtS);
+}
+
+void ChamberController::init(uint8_t chamber) {
+  id = chamber;
+  map = &Config::Chambers::MAPS[chamber];
   allOutputsOff();
-  g_nextSampleMs = 0;
-  g_measureCtx.stage = MEASURE_IDLE;
-  g_actionCtx.currentAction = ACTION_NONE;
-  g_actionCtx.lastVentilationMs = millis(); // Start baseline timer
-  
+  nextSampleMs = 0;
+  nextFilterMs = 0;
+  frameAcquired = false;
+#if CC_SIM_SENSOR
+  simSensor.seed(Config::Simulation::SEED + chamber);
+#endif
+  if (!tier1m) {
+    tier1m = memory_arena_new<Tier1m>(TIER_1M_SAMPLES);
+    tier15m = memory_arena_new<Tier15m>(Config::HISTORY_TIER_15M_FACTOR);
+    if (!tier1m || !tier15m) {
+      tier1m = nullptr;
+      tier15m = nullptr;
+      Serial.println("History tiers: no arena memory");
+    }
+  }
+  measureCtx.stage = MEASURE_IDLE;
+  measureCtx.waitMs = RT_WAIT_BETWEEN_CYCLES_MS;
+  co2Trend.reset();
+  rhTrend.reset();
+  tempTrend.reset();
+  co2Agreement.reset();
+  rhAgreement.reset();
+  actionCtx.currentAction = ACTION_NONE;
+  actionCtx.pending = 0;
+  safetyTrips = 0;
+  actionCtx.lastVentilationMs = chamber_clock_now(); // Start baseline timer
+
   // Load setpoints from storage
-  g_co2_setpoint = storage_get_co2_setpoint();
-  g_rh_setpoint = storage_get_rh_setpoint();
-  g_temp_setpoint = storage_get_temp_setpoint();
-  
+  co2Setpoint = (uint16_t)storage_get_chamber_setting(id, SETTING_CO2_SETPOINT);
+  rhSetpoint_x10 = (int16_t)storage_get_chamber_setting(id, SETTING_RH_SETPOINT);
+  tempSetpoint_x10 = (int16_t)storage_get_chamber_setting(id, SETTING_TEMP_SETPOINT);
+
+  if (Config::Chambers::COUNT > 1) {
+    Serial.print("Chamber ");
+    Serial.println(id);
+  }
   Serial.print("CO2 Setpoint: ");
-  Serial.print(g_co2_setpoint);
+  Serial.print(co2Setpoint);
   Serial.println(" ppm");
   Serial.print("RH Setpoint: ");
-  Serial.print(g_rh_setpoint);
+  Serial.print(rhSetpointPercent(), 1);
   Serial.println(" %");
   Serial.print("Temp Setpoint: ");
-  Serial.print(g_temp_setpoint);
+  Serial.print(tempSetpointCelsius(), 1);
   Serial.println(" °C");
-  
+  publishSnapshot(); // Setpoints are known before the first sample
+}
+
+// --- Next deadlines ---
+
+// Wrap-safe earlier of two deadlines in the future of `now`
+static inline unsigned long earlier(unsigned long a, unsigned long b, unsigned long now) {
+  return (long)(a - now) < (long)(b - now) ? a : b;
+}
+
+unsigned long ChamberController::actionNextMs(unsigned long now) const {
+  if (actionCtx.currentAction == ACTION_NONE) {
+    return now + Config::Scheduler::MAX_IDLE_MS; // Started by the measure task
+  }
+  const ActionStep &step = ACTION_RECIPES[actionCtx.currentAction].steps[actionCtx.step];
+  return chamber_clock_due_ms(actionCtx.stepStartMs + step.durationMs);
+}
+
+unsigned long ChamberController::heaterNextMs() const {
+  return chamber_clock_due_ms(heaterCheckMs + Config::HEATER_CHECK_INTERVAL_MS);
+}
+
+unsigned long ChamberController::measureNextMs(unsigned long now) const {
+  switch (measureCtx.stage) {
+    case MEASURE_SWIRL:
+      if (Config::Measure::ADAPTIVE) {
+        // May end early on any filter sample
+        return earlier(chamber_clock_due_ms(measureCtx.stageStartMs + RT_MEASURE_SWIRL_DURATION_MS),
+                       sampleNextMs(now), now);
+      }
+      return chamber_clock_due_ms(measureCtx.stageStartMs + RT_MEASURE_SWIRL_DURATION_MS);
+    case MEASURE_MEDIAN:
+      // Waits for filter pushes, which the sample task makes on its deadline
+      if (rhFilter.pushes() - measureCtx.filterStart < MEDIAN_SAMPLE_COUNT) {
+        return sampleNextMs(now);
+      }
+      return now;
+    case MEASURE_WAIT:
+      if (Config::Measure::ADAPTIVE) {
+        // The trend check runs on every filter sample
+        return earlier(chamber_clock_due_ms(measureCtx.stageStartMs + measureCtx.waitMs), sampleNextMs(now), now);
+      }
+      return chamber_clock_due_ms(measureCtx.stageStartMs + measureCtx.waitMs);
+    default:
+      return now; // IDLE and EVALUATE move on in the next pass
+  }
+}
+
+unsigned long ChamberController::sampleNextMs(unsigned long now) const {
+  if (nextFilterMs == 0 || nextSampleMs == 0) return now;
+  return chamber_clock_due_ms(earlier(nextFilterMs, nextSampleMs, chamber_clock_now()));
+}
+
+// --- Setpoints ---
+
+// Take over the stored setpoints after a command pass: one snapshot, an
+// event for each setpoint that actually changed
+void ChamberController::applyStoredSetpoints() {
+  uint16_t co2 = (uint16_t)storage_get_chamber_setting(id, SETTING_CO2_SETPOINT);
+  int16_t rh = (int16_t)storage_get_chamber_setting(id, SETTING_RH_SETPOINT);
+  int16_t temp = (int16_t)storage_get_chamber_setting(id, SETTING_TEMP_SETPOINT);
+  if (co2 != co2Setpoint) logEvent(EVT_CO2_SETPOINT, co2);
+  if (rh != rhSetpoint_x10) logEvent(EVT_RH_SETPOINT, rh);
+  if (temp != tempSetpoint_x10) logEvent(EVT_TEMP_SETPOINT, temp);
+  co2Setpoint = co2;
+  rhSetpoint_x10 = rh;
+  tempSetpoint_x10 = temp;
+  publishSnapshot();
+}
+
+void ChamberController::setCo2Setpoint(uint16_t ppm) {
+  setSetting(SETTING_CO2_SETPOINT, ppm); // Clamped to 400-10000 ppm
+  co2Setpoint = (uint16_t)storage_get_chamber_setting(id, SETTING_CO2_SETPOINT);
+  publishSnapshot();
+  logEvent(EVT_CO2_SETPOINT, co2Setpoint);
+}
+
+void ChamberController::setRhSetpoint(float percent) {
+  setSetting(SETTING_RH_SETPOINT, storage_setting_from_float(SETTING_RH_SETPOINT, percent));
+  rhSetpoint_x10 = (int16_t)storage_get_chamber_setting(id, SETTING_RH_SETPOINT);
+  publishSnapshot();
+  logEvent(EVT_RH_SETPOINT, rhSetpoint_x10);
+}
+
+void ChamberController::setTempSetpoint(float celsius) {
+  setSetting(SETTING_TEMP_SETPOINT, storage_setting_from_float(SETTING_TEMP_SETPOINT, celsius));
+  tempSetpoint_x10 = (int16_t)storage_get_chamber_setting(id, SETTING_TEMP_SETPOINT);
+  publishSnapshot();
+  logEvent(EVT_TEMP_SETPOINT, tempSetpoint_x10);
+}
+
+// --- Public API ---
+
+void controller_init() {
+  Serial.println("Controller: Initializing...");
+  for (uint8_t c = 0; c < Config::Chambers::COUNT; c++) {
+    g_chambers[c].init(c);
+  }
   Serial.print("SPEEDUP: ");
-  Serial.println(SPEEDUP);
+  Serial.println(chamber_clock_speedup());
   Serial.println("Controller: Ready");
 }
 
-void controller_tick() {
-  sampleTick();
-  measurementTick();
-  actionTick();
-  heaterTick();
+void controller_tick(unsigned long now) {
+  chamber_clock_tick(now);
+  now = chamber_clock_now();
+  for (ChamberController &chamber : g_chambers) {
+    chamber.sampleTick(now);
+    chamber.measurementTick(now);
+    chamber.actionTick(now);
+    chamber.heaterTick(now);
+  }
+}
+
+// --- Next deadlines (scheduler hooks: earliest over all chambers) ---
+
+unsigned long controller_action_next_ms(unsigned long now) {
+  unsigned long next = g_chambers[0].actionNextMs(now);
+  for (uint8_t c = 1; c < Config::Chambers::COUNT; c++) next = earlier(next, g_chambers[c].actionNextMs(now), now);
+  return next;
+}
+
+unsigned long controller_heater_next_ms(unsigned long now) {
+  unsigned long next = g_chambers[0].heaterNextMs();
+  for (uint8_t c = 1; c < Config::Chambers::COUNT; c++) next = earlier(next, g_chambers[c].heaterNextMs(), now);
+  return next;
+}
+
+unsigned long controller_measure_next_ms(unsigned long now) {
+  unsigned long next = g_chambers[0].measureNextMs(now);
+  for (uint8_t c = 1; c < Config::Chambers::COUNT; c++) next = earlier(next, g_chambers[c].measureNextMs(now), now);
+  return next;
+}
+
+unsigned long controller_sample_next_ms(unsigned long now) {
+  unsigned long next = g_chambers[0].sampleNextMs(now);
+  for (uint8_t c = 1; c < Config::Chambers::COUNT; c++) next = earlier(next, g_chambers[c].sampleNextMs(now), now);
+  return next;
+}
+
+unsigned long controller_next_ms(unsigned long now) {
+  unsigned long next = earlier(controller_action_next_ms(now), controller_heater_next_ms(now), now);
+  next = earlier(next, controller_measure_next_ms(now), now);
+  return earlier(next, controller_sample_next_ms(now), now);
+}
+
+void controller_action_tick(unsigned long) {
+  for (ChamberController &chamber : g_chambers) chamber.actionTick(chamber_clock_now());
+}
+
+void controller_heater_tick(unsigned long) {
+  for (ChamberController &chamber : g_chambers) chamber.heaterTick(chamber_clock_now());
+}
+
+void controller_measure_tick(unsigned long) {
+  for (ChamberController &chamber : g_chambers) chamber.measurementTick(chamber_clock_now());
+}
+
+void controller_sample_tick(unsigned long) {
+  uint32_t startUs = sensor_trace_us();
+  for (ChamberController &chamber : g_chambers) chamber.sampleTick(chamber_clock_now());
+  sensor_trace_pass(startUs);
+}
+
+void controller_command_tick(unsigned long) {
+  ControlCommand command;
+  bool setpoints[Config::Chambers::COUNT] = {};
+  // A batch (control_link_post_batch) is visible as a whole, so it is
+  // applied in this one pass
+  while (control_link_next_command(&command)) {
+    if (command.chamber >= Config::Chambers::COUNT) continue;
+    g_chambers[command.chamber].setSetting(command.key, command.raw);
+    if (command.key == SETTING_CO2_SETPOINT || command.key == SETTING_RH_SETPOINT ||
+        command.key == SETTING_TEMP_SETPOINT) {
+      setpoints[command.chamber] = true;
+    }
+  }
+  for (uint8_t c = 0; c < Config::Chambers::COUNT; c++) {
+    if (setpoints[c]) g_chambers[c].applyStoredSetpoints();
+  }
+}
+
+void controller_snapshot(uint8_t chamber, ControllerSnapshot *out) {
+  chamberAt(chamber).readSnapshot(out);
+}
+
+uint32_t controller_snapshot_retries() {
+  return g_snapshotRetries.load(std::memory_order_relaxed);
+}
+
+// Newest RING_BUFFER_SIZE samples of one series, oldest -> newest,
+// zero-padded in front while the history is filling up
+void controller_get_series(uint8_t chamber, HistorySeries series, int16_t *out) {
+  const auto &history = chamberAt(chamber).samples();
+  HistorySnapshot snap = history.snapshot(RING_BUFFER_SIZE);
+  uint16_t fill = RING_BUFFER_SIZE - snap.count;
+  for (uint16_t i = 0; i < fill; i++) {
+    out[i] = 0;
+  }
+  int16_t *dst = out + fill;
+
+  if (series >= SENSOR_SERIES_COUNT) {
+    HistoryStateSpan spans[2];
+    uint8_t n = history.stateSpans(snap, spans);
+    uint8_t bit = series_actuator_bit(series);
+    for (uint8_t k = 0; k < n; k++) {
+      for (uint16_t i = 0; i < spans[k].length; i++) {
+        *dst++ = (spans[k].data[i] & bit) ? 1 : 0;
+      }
+    }
+    return;
+  }
+
+  HistorySpan spans[2];
+  uint8_t n = history.spans(snap, series, spans);
+  for (uint8_t k = 0; k < n; k++) {
+    memcpy(dst, spans[k].data, spans[k].length * sizeof(int16_t));
+    dst += spans[k].length;
+  }
+}
+
+uint32_t controller_get_sample_seq(uint8_t chamber) {
+  return chamberAt(chamber).samples().newestSeq();
 }
 
-void controller_get_last200(float *rh_out, float *temp_out, int *co2_out) {
-  g_rhBuffer.getAll(rh_out);
-  g_tempBuffer.getAll(temp_out);
-  g_co2Buffer.getAll(co2_out);
+unsigned long controller_get_sample_interval_ms() {
+  return chamber_clock_wall_ms(Config::SAMPLE_INTERVAL_MS);
 }
 
-void controller_get_additional_sensors(int *co2_2_out, float *rh_2_out, float *temp_2_out, float *temp_outer_out) {
-  g_co2_2Buffer.getAll(co2_2_out);
-  g_rh_2Buffer.getAll(rh_2_out);
-  g_temp_2Buffer.getAll(temp_2_out);
-  g_tempOuterBuffer.getAll(temp_outer_out);
+uint16_t controller_history_length() {
+  return RING_BUFFER_SIZE;
 }
 
-void controller_get_outputs(int *fogger_out, int *swirler_out, int *freshair_out) {
-  g_foggerBuffer.getAll(fogger_out);
-  g_swirlerBuffer.getAll(swirler_out);
-  g_freshAirBuffer.getAll(freshair_out);
+int16_t controller_history_value(uint8_t chamber, HistorySeries series, uint32_t seq) {
+  const auto &history = chamberAt(chamber).samples();
+  if (series < SENSOR_SERIES_COUNT) return history.at(series, seq);
+  if (series < SERIES_COUNT) return (history.stateAt(seq) & series_actuator_bit(series)) ? 1 : 0;
+  return 0;
 }
 
-void controller_get_heater(int *heater_out) {
-  g_heaterBuffer.getAll(heater_out);
+uint32_t controller_tier_seq(uint8_t chamber, HistoryResolution res) {
+  const ChamberController &c = chamberAt(chamber);
+  switch (res) {
+    case RES_1M:  return c.tier1() ? c.tier1()->newestSeq() : 0;
+    case RES_15M: return c.tier15() ? c.tier15()->newestSeq() : 0;
+    default:      return c.samples().newestSeq();
+  }
+}
+
+uint16_t controller_tier_length(uint8_t chamber, HistoryResolution res) {
+  const ChamberController &c = chamberAt(chamber);
+  switch (res) {
+    case RES_1M:  return c.tier1() ? c.tier1()->size() : 0;
+    case RES_15M: return c.tier15() ? c.tier15()->size() : 0;
+    default:      return c.samples().size();
+  }
+}
+
+unsigned long controller_tier_interval_ms(HistoryResolution res) {
+  unsigned long sample = controller_get_sample_interval_ms();
+  switch (res) {
+    case RES_1M:  return sample * TIER_1M_SAMPLES;
+    case RES_15M: return sample * TIER_1M_SAMPLES * Config::HISTORY_TIER_15M_FACTOR;
+    default:      return sample;
+  }
+}
+
+int16_t controller_tier_value(uint8_t chamber, HistoryResolution res, HistorySeries series, TierStat stat,
+                              uint32_t seq) {
+  if (res == RES_RAW || series >= SERIES_COUNT) return controller_history_value(chamber, series, seq);
+  const ChamberController &c = chamberAt(chamber);
+  if (!c.tier1()) return 0;
+  if (series < SENSOR_SERIES_COUNT) {
+    return (res == RES_1M) ? c.tier1()->value(series, stat, seq) : c.tier15()->value(series, stat, seq);
+  }
+  uint8_t flag = series - SENSOR_SERIES_COUNT;
+  return (res == RES_1M) ? c.tier1()->dutyPercent(flag, seq) : c.tier15()->dutyPercent(flag, seq);
+}
+
+uint8_t controller_history_actuators(uint8_t chamber, uint32_t seq) {
+  return chamberAt(chamber).samples().stateAt(seq);
+}
+
+void controller_history_frame(uint8_t chamber, uint32_t seq, int16_t *frame_out) {
+  const auto &history = chamberAt(chamber).samples();
+  for (uint8_t ch = 0; ch < SENSOR_SERIES_COUNT; ch++) {
+    frame_out[ch] = history.at(ch, seq);
+  }
+  uint8_t bits = history.stateAt(seq);
+  for (uint8_t ch = SENSOR_SERIES_COUNT; ch < SERIES_COUNT; ch++) {
+    frame_out[ch] = (bits & series_actuator_bit(ch)) ? 1 : 0;
+  }
 }
 
 // CO2 Setpoint management
-void controller_set_co2_setpoint(uint16_t ppm) {
-  storage_set_co2_setpoint(ppm);
-  g_co2_setpoint = storage_get_co2_setpoint(); // Get clamped value
-  Serial.print("Controller: CO2 setpoint changed to ");
-  Serial.print(g_co2_setpoint);
-  Serial.println(" ppm");
+void controller_set_co2_setpoint(uint8_t chamber, uint16_t ppm) {
+  chamberAt(chamber).setCo2Setpoint(ppm);
 }
 
-uint16_t controller_get_co2_setpoint() {
-  return g_co2_setpoint;
+uint16_t controller_get_co2_setpoint(uint8_t chamber) {
+  return chamberAt(chamber).co2SetpointPpm();
 }
 
 // RH Setpoint management
-void controller_set_rh_setpoint(float percent) {
-  storage_set_rh_setpoint(percent);
-  g_rh_setpoint = storage_get_rh_setpoint(); // Get clamped value
-  Serial.print("Controller: RH setpoint changed to ");
-  Serial.print(g_rh_setpoint);
-  Serial.println(" %");
+void controller_set_rh_setpoint(uint8_t chamber, float percent) {
+  chamberAt(chamber).setRhSetpoint(percent);
 }
 
-float controller_get_rh_setpoint() {
-  return g_rh_setpoint;
+float controller_get_rh_setpoint(uint8_t chamber) {
+  return chamberAt(chamber).rhSetpointPercent();
 }
 
 // Temperature Setpoint management
-void controller_set_temp_setpoint(float celsius) {
-  storage_set_temp_setpoint(celsius);
-  g_temp_setpoint = storage_get_temp_setpoint(); // Get clamped value
-  Serial.print("Controller: Temp setpoint changed to ");
-  Serial.print(g_temp_setpoint);
-  Serial.println(" °C");
+void controller_set_temp_setpoint(uint8_t chamber, float celsius) {
+  chamberAt(chamber).setTempSetpoint(celsius);
 }
 
-float controller_get_temp_setpoint() {
-  return g_temp_setpoint;
+float controller_get_temp_setpoint(uint8_t chamber) {
+  return chamberAt(chamber).tempSetpointCelsius();
 }
@@ -4,26 +4,36 @@
  * *****************************************************************************
  * Non-blocking climate control system with:
  * - Multi-sensor monitoring (CO2, humidity, temperature)
- * - Ring buffer data collection (200 samples per sensor)
- * - Non-preemptive action state machine
+ * - Ring buffer data collection (200 fixed-point samples per sensor)
+ * - Action state machine with priority queue and safety preemption
  * - Measurement cycle with median filtering
  * - Independent heater control
  * 
  * Configuration:
- * - SIMULATE_SENSORS: Use simulated sensors (defined in config.h)
- * - SPEEDUP_FACTOR: Time acceleration for testing
+ * - CC_SIM_SENSOR: SimSensor random walks instead of the front-ends (config.h)
+ * - Config::Clock / SPEEDUP_FACTOR: chamber clock for accelerated testing
  * 
  * Control Loop:
  * - Reads sensors continuously
  * - Calculates median values for decision-making
  * - Executes control actions (fogger, fresh air, heater)
  * - Stores data in ring buffers for web visualization
+ * - Downsampled 1-minute / 15-minute tiers for long-horizon history
+ *
+ * Chambers: one controller instance per Config::Chambers::MAPS entry, each
+ * with its own outputs, inputs, settings, history and snapshot. The
+ * scheduler tasks step all instances; the data and setpoint functions take
+ * the chamber index first (0..Config::Chambers::COUNT-1, others read
+ * chamber 0).
  * *****************************************************************************
  */
 
 #pragma once
 
+#include "channels.h"
 #include "config.h"
+#include "fixed_point.h"
+#include "history_tiers.h"
 #include <stdint.h>
 
 // =============================================================================
@@ -31,21 +41,62 @@
 // =============================================================================
 
 /**
- * @brief Sensor readings from all sensors
- * 
- * Contains readings from 7 sensors:
- * - 2 CO2 sensors (main + secondary)
- * - 2 humidity sensors (main + secondary)  
- * - 3 temperature sensors (main + secondary + outer)
+ * @brief Sensor readings from all sensors (fixed point, see fixed_point.h)
+ *
+ * One value per sensor channel of CHANNELS (channels.h), indexed by
+ * HistorySeries: 2 CO2 sensors (ppm), 2 humidity sensors (% x10) and
+ * 3 temperature sensors (°C x10: main, secondary, outer).
  */
 struct Sensors {
-  int co2;           ///< CO2 concentration (ppm) from main sensor
-  int co2_2;         ///< CO2 concentration (ppm) from secondary sensor
-  float rh;          ///< Relative humidity (%) from main sensor
-  float rh_2;        ///< Relative humidity (%) from secondary sensor
-  float temp;        ///< Temperature (°C) from main inner sensor
-  float temp_2;      ///< Temperature (°C) from secondary inner sensor
-  float temp_outer;  ///< Temperature (°C) from outer box sensor
+  int16_t value[SENSOR_SERIES_COUNT];  ///< HistorySeries order
+};
+
+/**
+ * @brief Closed loops with a selectable control mode (Config::Control)
+ */
+enum ControlLoop : uint8_t {
+  LOOP_HEATER,  ///< Temperature via heater
+  LOOP_FOGGER,  ///< Humidity via fogger (upwards only)
+  CONTROL_LOOP_COUNT
+};
+
+/**
+ * @brief State and quality figures of one loop (since its last setpoint step)
+ */
+struct ControlLoopStatus {
+  uint8_t mode;           ///< Config::Control::MODE_*
+  float setpoint;
+  float value;            ///< Last measurement the loop acted on
+  float output;           ///< Demanded duty 0..1 (hysteresis: 0 or 1)
+  float overshoot;        ///< Largest excursion past the setpoint
+  float settlingS;        ///< Step -> settled, chamber seconds (valid if settled)
+  bool settled;           ///< Within the settle band for Config::Control::SETTLE_HOLD_MS
+  float duty;             ///< Actuator on-time fraction since the step
+};
+
+/**
+ * @brief Consistent controller state, published once per sample and on setpoint changes
+ *
+ * Read with controller_snapshot() from any thread: all fields come from the
+ * same publish, and `seq` is a sample that the history rings already hold.
+ */
+struct ControllerSnapshot {
+  uint32_t seq;                          ///< Newest sample (0 = no sample yet)
+  int16_t sensors[SENSOR_SERIES_COUNT];  ///< Fixed-point values of sample `seq`, HistorySeries order
+  uint8_t actuators;                     ///< ACTUATOR_BIT_* mask at publish time
+  uint16_t co2_setpoint;                 ///< ppm
+  int16_t rh_setpoint_x10;               ///< % x10
+  int16_t temp_setpoint_x10;             ///< °C x10
+  ControlLoopStatus loops[CONTROL_LOOP_COUNT]; ///< Heater and fogger loop
+};
+
+/**
+ * @brief Resolution of a history query
+ */
+enum HistoryResolution : uint8_t {
+  RES_RAW,  ///< Raw samples (SAMPLE_INTERVAL_MS)
+  RES_1M,   ///< 1-minute min/mean/max buckets
+  RES_15M   ///< 15-minute min/mean/max buckets
 };
 
 // =============================================================================
@@ -56,62 +107,180 @@ struct Sensors {
  * @brief Initialize the climate controller
  * 
  * Must be called once during setup before any other controller functions.
- * Initializes sensors, actuators, and internal state machines.
+ * Initializes sensors, actuators, and internal state machines of every chamber.
  */
 void controller_init();
 
 /**
  * @brief Execute one iteration of the control loop
  * 
- * Call this repeatedly in the main loop. Performs non-blocking operations:
+ * Advances the chamber clock, then runs the four sub-ticks below in order
+ * with one shared chamber timestamp.
+ * Performs non-blocking operations:
  * - Reads sensors
  * - Updates ring buffers
  * - Executes control decisions
  * - Manages actuator states
+ * 
+ * @param now millis() of the current pass
+ */
+void controller_tick(unsigned long now);
+
+/**
+ * @brief Sub-ticks of controller_tick(), registered as separate scheduler tasks
+ * 
+ * Each one only advances its own state machine and compares against the
+ * chamber time latched by the clock task (chamber_clock.h), so they can run
+ * at different priorities and all see the same time within a pass:
+ * - action: running CO2 / RH / baseline action sequence
+ * - heater: hysteresis heater control
+ * - measure: swirl / median / evaluate cycle, may start an action
+ * - sample: history, tier and sample log frame every SAMPLE_INTERVAL_MS
+ * 
+ * @param now millis() of the current scheduler pass (unused, see chamber_clock_now())
+ */
+void controller_action_tick(unsigned long now);
+void controller_heater_tick(unsigned long now);
+void controller_measure_tick(unsigned long now);
+void controller_sample_tick(unsigned long now);
+
+/**
+ * @brief Next deadline of each sub-tick (scheduler `next` hooks)
+ *
+ * Stage ends, filter/history samples and heater
+ * checks are known in advance, so the sub-ticks only run when one is reached
+ * instead of on every pass. controller_next_ms() is the earliest of the four
+ * and drives the chamber clock task.
+ *
+ * @param now millis() of the pass that just ran
+ * @return millis() of the deadline (see chamber_clock_due_ms())
+ */
+unsigned long controller_action_next_ms(unsigned long now);
+unsigned long controller_heater_next_ms(unsigned long now);
+unsigned long controller_measure_next_ms(unsigned long now);
+unsigned long controller_sample_next_ms(unsigned long now);
+unsigned long controller_next_ms(unsigned long now);
+
+/**
+ * @brief Apply setting changes queued by the network side (control_link_post)
+ * 
+ * Runs on the control side only, so storage and setpoints are never written
+ * from the network thread. A change is visible in the next controller_snapshot().
+ * 
+ * @param now millis() of the current scheduler pass (unused)
  */
-void controller_tick();
+void controller_command_tick(unsigned long now);
 
 // =============================================================================
 // DATA RETRIEVAL
 // =============================================================================
 
 /**
- * @brief Get last 200 samples from primary sensors
+ * @brief Read the newest published controller state (seqlock, never blocks the writer)
  * 
- * @param rh_out    Output array for humidity data (must have 200 elements)
- * @param temp_out  Output array for temperature data (must have 200 elements)
- * @param co2_out   Output array for CO2 data (must have 200 elements)
+ * Safe from the network thread. Pin a response to `out->seq` and read the
+ * history by sequence number; those samples stay valid for the ring capacity.
  * 
+ * @param chamber Config::Chambers index
+ * @param out Snapshot
+ */
+void controller_snapshot(uint8_t chamber, ControllerSnapshot *out);
+
+/**
+ * @brief Reads that had to be retried because a publish was in progress
+ */
+uint32_t controller_snapshot_retries();
+
+/**
+ * @brief Get the last 200 samples of one series
+ *
+ * @param series Series to copy (any CHANNELS entry)
+ * @param out    Output array (200 elements): fixed-point values
+ *               (series_decimals()), actuator series 0=OFF, 1=ON
+ *
  * @note Returns data oldest to newest. If buffer not full, pads with zeros.
  */
-void controller_get_last200(float *rh_out, float *temp_out, int *co2_out);
+void controller_get_series(uint8_t chamber, HistorySeries series, int16_t *out);
 
 /**
- * @brief Get last 200 samples from additional sensors
- * 
- * @param co2_2_out      Output array for secondary CO2 (200 elements)
- * @param rh_2_out       Output array for secondary humidity (200 elements)
- * @param temp_2_out     Output array for secondary temperature (200 elements)
- * @param temp_outer_out Output array for outer temperature (200 elements)
+ * @brief Get the sequence number of the newest history sample
+ *
+ * Incremented by one for every sample pushed to the ring buffers.
+ *
+ * @return Sequence number of the newest sample (0 = no sample yet)
  */
-void controller_get_additional_sensors(int *co2_2_out, float *rh_2_out, 
-                                       float *temp_2_out, float *temp_outer_out);
+uint32_t controller_get_sample_seq(uint8_t chamber);
 
 /**
- * @brief Get last 200 output states for primary actuators
- * 
- * @param fogger_out    Output array for fogger states (0=OFF, 1=ON)
- * @param swirler_out   Output array for swirler states (0=OFF, 1=ON)
- * @param freshair_out  Output array for fresh air states (0=OFF, 1=ON)
+ * @brief Get the time between two history samples
+ * @return Sample interval in real ms (chamber_clock_wall_ms())
  */
-void controller_get_outputs(int *fogger_out, int *swirler_out, int *freshair_out);
+unsigned long controller_get_sample_interval_ms();
 
 /**
- * @brief Get last 200 heater states
- * 
- * @param heater_out Output array for heater states (0=OFF, 1=ON)
+ * @brief Get the number of samples held per history series
+ * @return Ring buffer capacity (Config::SENSOR_RING_BUFFER_SIZE)
+ */
+uint16_t controller_history_length();
+
+/**
+ * @brief Read one history value in place, without copying the ring buffer
+ *
+ * @param series Series to read
+ * @param seq    Sample sequence number (see controller_get_sample_seq())
+ * @return Fixed-point sample value (series_decimals()); 0 if seq is 0 or
+ *         newer than the newest sample. Samples already overwritten read as
+ *         the oldest retained value.
+ */
+int16_t controller_history_value(uint8_t chamber, HistorySeries series, uint32_t seq);
+
+/**
+ * @brief Sequence number of the newest sample/bucket of a tier (0 = empty)
+ */
+uint32_t controller_tier_seq(uint8_t chamber, HistoryResolution res);
+
+/**
+ * @brief Number of retained samples/buckets of a tier
+ */
+uint16_t controller_tier_length(uint8_t chamber, HistoryResolution res);
+
+/**
+ * @brief Time covered by one sample/bucket of a tier in milliseconds
+ */
+unsigned long controller_tier_interval_ms(HistoryResolution res);
+
+/**
+ * @brief Read one statistic of one bucket of a tier
+ *
+ * Sensor series return min/mean/max in their fixed point (series_decimals()),
+ * actuator series the on-duty in percent, 0..100 (stat ignored). RES_RAW
+ * behaves like controller_history_value().
+ *
+ * @param res Tier
+ * @param series Series to read
+ * @param stat Statistic for sensor series
+ * @param seq Bucket sequence number (see controller_tier_seq())
+ */
+int16_t controller_tier_value(uint8_t chamber, HistoryResolution res, HistorySeries series, TierStat stat,
+                              uint32_t seq);
+
+/**
+ * @brief Read the packed actuator states of one sample
+ *
+ * @param seq Sample sequence number (see controller_get_sample_seq())
+ * @return ACTUATOR_BIT_* mask, same padding/clamping rules as
+ *         controller_history_value()
+ */
+uint8_t controller_history_actuators(uint8_t chamber, uint32_t seq);
+
+/**
+ * @brief Read all series of one sample in a single call
+ *
+ * @param seq       Sample sequence number (see controller_get_sample_seq())
+ * @param frame_out Output array indexed by HistorySeries (SERIES_COUNT
+ *                  elements), values as controller_history_value()
  */
-void controller_get_heater(int *heater_out);
+void controller_history_frame(uint8_t chamber, uint32_t seq, int16_t *frame_out);
 
 // =============================================================================
 // SETPOINT MANAGEMENT
@@ -121,34 +290,34 @@ void controller_get_heater(int *heater_out);
  * @brief Set CO2 target level
  * @param ppm Target CO2 concentration (400-10000 ppm)
  */
-void controller_set_co2_setpoint(uint16_t ppm);
+void controller_set_co2_setpoint(uint8_t chamber, uint16_t ppm);
 
 /**
  * @brief Get current CO2 setpoint
  * @return Target CO2 concentration in ppm
  */
-uint16_t controller_get_co2_setpoint();
+uint16_t controller_get_co2_setpoint(uint8_t chamber);
 
 /**
  * @brief Set humidity target level
  * @param percent Target relative humidity (82-96 %)
  */
-void controller_set_rh_setpoint(float percent);
+void controller_set_rh_setpoint(uint8_t chamber, float percent);
 
 /**
  * @brief Get current humidity setpoint
  * @return Target relative humidity in percent
  */
-float controller_get_rh_setpoint();
+float controller_get_rh_setpoint(uint8_t chamber);
 
 /**
  * @brief Set temperature target level
  * @param celsius Target temperature (18-32 °C)
  */
-void controller_set_temp_setpoint(float celsius);
+void controller_set_temp_setpoint(uint8_t chamber, float celsius);
 
 /**
  * @brief Get current temperature setpoint
  * @return Target temperature in degrees Celsius
  */
-float controller_get_temp_setpoint();
+float controller_get_temp_setpoint(uint8_t chamber);
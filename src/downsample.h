@@ -0,0 +1,112 @@
+/*
+ * *****************************************************************************
+ * DOWNSAMPLE - LARGEST-TRIANGLE-THREE-BUCKETS AND BUCKET REDUCTIONS
+ * *****************************************************************************
+ * Reduces a window of `length` samples to `points` output points for the
+ * chart endpoints (?points=N):
+ * - Bucket layout of LTTB: the first and the last sample are kept, the
+ *   samples in between are split into points - 2 equal buckets
+ * - lttb_pick(): the sample of a bucket that spans the largest triangle with
+ *   the previously picked point and the mean of the next bucket; keeps peaks
+ *   and edges a plain mean would flatten
+ * - downsample_reduce(): min, max or mean of a bucket, for series that are
+ *   already statistics (tier min/max) or on/off states
+ *
+ * Samples are read through a callable `get(offset)` (offset 0 = oldest), so
+ * the history store is read in place: every bucket is visited once as the
+ * "next" bucket and once for the pick, no buffer. Values are int16 fixed
+ * point (fixed_point.h).
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+enum DownsampleMode : uint8_t {
+  DOWNSAMPLE_LTTB,
+  DOWNSAMPLE_MIN,
+  DOWNSAMPLE_MAX,
+  DOWNSAMPLE_MEAN
+};
+
+/**
+ * @brief Sample range [begin, end) behind each output point
+ */
+struct DownsampleBuckets {
+  uint16_t length;  ///< Samples in the window
+  uint16_t points;  ///< Output points, 3 <= points < length
+
+  uint16_t begin(uint16_t b) const {
+    if (b == 0) return 0;
+    if (b >= points - 1) return length - 1;
+    return (uint16_t)(1 + (uint32_t)(b - 1) * (length - 2) / (points - 2));
+  }
+
+  uint16_t end(uint16_t b) const {
+    if (b == 0) return 1;
+    if (b >= points - 1) return length;
+    return (uint16_t)(1 + (uint32_t)b * (length - 2) / (points - 2));
+  }
+
+  /// Offset the output point is drawn at (the bucket's middle sample)
+  uint16_t center(uint16_t b) const {
+    return (uint16_t)((begin(b) + end(b) - 1) / 2);
+  }
+};
+
+/**
+ * @brief Offset of the LTTB pick in bucket `b`
+ *
+ * @param prevX,prevY Point picked in bucket b - 1 (for b = 0 and the last
+ *                    bucket the single sample is returned)
+ */
+template<typename Get>
+uint16_t lttb_pick(const DownsampleBuckets &buckets, uint16_t b, uint16_t prevX, int16_t prevY, Get get) {
+  uint16_t from = buckets.begin(b);
+  uint16_t to = buckets.end(b);
+  if (to - from <= 1) return from;
+
+  // Mean of the next bucket
+  uint16_t nextFrom = buckets.begin(b + 1);
+  uint16_t nextTo = buckets.end(b + 1);
+  int32_t sum = 0;
+  for (uint16_t i = nextFrom; i < nextTo; i++) sum += get(i);
+  float cx = (nextFrom + nextTo - 1) * 0.5f;
+  float cy = (float)sum / (float)(nextTo - nextFrom);
+
+  // Twice the triangle area; the factor and the sign do not matter
+  uint16_t best = from;
+  float bestArea = -1.0f;
+  for (uint16_t i = from; i < to; i++) {
+    float area = (prevX - cx) * (get(i) - prevY) - (prevX - i) * (cy - prevY);
+    if (area < 0) area = -area;
+    if (area > bestArea) {
+      bestArea = area;
+      best = i;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Min, max or mean (rounded half away from zero) of bucket `b`
+ */
+template<typename Get>
+int16_t downsample_reduce(const DownsampleBuckets &buckets, uint16_t b, DownsampleMode mode, Get get) {
+  uint16_t from = buckets.begin(b);
+  uint16_t to = buckets.end(b);
+  int16_t lo = INT16_MAX;
+  int16_t hi = INT16_MIN;
+  int32_t sum = 0;
+  for (uint16_t i = from; i < to; i++) {
+    int16_t v = get(i);
+    if (v < lo) lo = v;
+    if (v > hi) hi = v;
+    sum += v;
+  }
+  if (mode == DOWNSAMPLE_MIN) return lo;
+  if (mode == DOWNSAMPLE_MAX) return hi;
+  int32_t count = to - from;
+  return (int16_t)((sum >= 0) ? (sum + count / 2) / count : (sum - count / 2) / count);
+}
@@ -0,0 +1,126 @@
+/*
+ * *****************************************************************************
+ * DUTY WINDOW - ROLLING ON-TIME AND SWITCH-ONS PER ACTUATOR
+ * *****************************************************************************
+ * On-time and switch-on count per actuator over the last BUCKETS x
+ * BUCKET_MS, kept as a ring of buckets with running sums:
+ * - add() credits an interval in which the on-mask was constant, split at
+ *   bucket boundaries; countSwitch() counts one switch-on
+ * - Closing a bucket subtracts the oldest one from the sums, so a read is
+ *   O(1) and an update costs O(ACTUATORS) plus one step per bucket crossed
+ * - The window covers BUCKETS - 1 full buckets plus the open one, i.e. it
+ *   slides in steps of BUCKET_MS; spanMs() is the time actually covered
+ *
+ * Times are wrap-safe unsigned long milliseconds (chamber time here).
+ *
+ * test/test_duty_window checks the sliding, the span and the gap reset on
+ * the host (env:native).
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+template<uint8_t ACTUATORS, uint8_t BUCKETS, unsigned long BUCKET_MS>
+class DutyWindow {
+private:
+  uint32_t onMs[BUCKETS][ACTUATORS];
+  uint16_t switchOns[BUCKETS][ACTUATORS];
+  uint32_t onSum[ACTUATORS];
+  uint32_t switchSum[ACTUATORS];
+  uint8_t head;             // Open bucket
+  unsigned long headStart;  // Start of the open bucket
+  unsigned long startMs;    // reset() time, bounds spanMs()
+
+  static_assert(BUCKETS >= 2, "One open and at least one closed bucket");
+  static_assert((uint64_t)BUCKETS * BUCKET_MS < 0x80000000UL, "Window must stay below half the time range");
+
+  void clearBucket(uint8_t b) {
+    for (uint8_t a = 0; a < ACTUATORS; a++) {
+      onSum[a] -= onMs[b][a];
+      switchSum[a] -= switchOns[b][a];
+      onMs[b][a] = 0;
+      switchOns[b][a] = 0;
+    }
+  }
+
+  // Open the bucket that contains `now`
+  void roll(unsigned long now) {
+    if (now - headStart >= (unsigned long)BUCKETS * BUCKET_MS) {
+      for (uint8_t b = 0; b < BUCKETS; b++) clearBucket(b);
+      headStart = now - (now - headStart) % BUCKET_MS;
+      return;
+    }
+    while (now - headStart >= BUCKET_MS) {
+      head = (uint8_t)((head + 1) % BUCKETS);
+      headStart += BUCKET_MS;
+      clearBucket(head);
+    }
+  }
+
+public:
+  DutyWindow() { reset(0); }
+
+  void reset(unsigned long now) {
+    for (uint8_t b = 0; b < BUCKETS; b++) {
+      for (uint8_t a = 0; a < ACTUATORS; a++) {
+        onMs[b][a] = 0;
+        switchOns[b][a] = 0;
+      }
+    }
+    for (uint8_t a = 0; a < ACTUATORS; a++) {
+      onSum[a] = 0;
+      switchSum[a] = 0;
+    }
+    head = 0;
+    headStart = now;
+    startMs = now;
+  }
+
+  /**
+   * @brief Credit [from, to) to the actuators on in `onMask`
+   *
+   * Calls must follow each other in time (from = the previous call's to).
+   */
+  void add(unsigned long from, unsigned long to, uint8_t onMask) {
+    if ((long)(to - from) <= 0) return;
+    // Anything older than the window would be dropped again right away
+    if (to - from > (unsigned long)BUCKETS * BUCKET_MS) from = to - (unsigned long)BUCKETS * BUCKET_MS;
+    while (from != to) {
+      roll(from);
+      unsigned long bucketEnd = headStart + BUCKET_MS;
+      unsigned long end = ((long)(to - bucketEnd) < 0) ? to : bucketEnd;
+      uint32_t dt = (uint32_t)(end - from);
+      for (uint8_t a = 0; a < ACTUATORS; a++) {
+        if (onMask & (1u << a)) {
+          onMs[head][a] += dt;
+          onSum[a] += dt;
+        }
+      }
+      from = end;
+    }
+    roll(to);
+  }
+
+  void countSwitch(uint8_t actuator, unsigned long now) {
+    roll(now);
+    if (switchOns[head][actuator] < 0xFFFF) {
+      switchOns[head][actuator]++;
+      switchSum[actuator]++;
+    }
+  }
+
+  uint32_t onTimeMs(uint8_t actuator) const { return onSum[actuator]; }
+  uint32_t switches(uint8_t actuator) const { return switchSum[actuator]; }
+
+  /**
+   * @brief Time the sums cover at `now` (the last add()): full window once
+   *        it has run that long
+   */
+  uint32_t spanMs(unsigned long now) const {
+    unsigned long covered = (unsigned long)(BUCKETS - 1) * BUCKET_MS + (now - headStart);
+    unsigned long elapsed = now - startMs;
+    return (uint32_t)((elapsed < covered) ? elapsed : covered);
+  }
+};
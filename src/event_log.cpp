@@ -0,0 +1,343 @@
+/*
+ * *****************************************************************************
+ * EVENT LOG IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "event_log.h"
+#include <atomic>
+#include <string.h>
+
+// Name and Serial line per event, same order as EventId. Placeholders take
+// the arguments in order: {} integer, {.1} tenths, {x} hex, {b} ON/OFF,
+// {s} the record's text
+struct EventFormat {
+  const char *name;
+  const char *format;
+};
+
+static const EventFormat EVENT_FORMAT[EVT_COUNT] = {
+  {"swirler",           "Swirler: {b}"},
+  {"freshair",          "FreshAir: {b}"},
+  {"fogger",            "Fogger: {b}"},
+  {"heater",            "Heater: {b}"},
+  {"co2_swirl",         "Action: CO2 - SWIRL"},
+  {"co2_settle",        "Action: CO2 - SETTLE"},
+  {"co2_complete",      "Action: CO2 - COMPLETE"},
+  {"rh_down_freshair",  "Action: RH_DOWN - FRESHAIR"},
+  {"rh_down_swirl",     "Action: RH_DOWN - SWIRL"},
+  {"rh_down_settle",    "Action: RH_DOWN - SETTLE"},
+  {"rh_down_complete",  "Action: RH_DOWN - COMPLETE (RH_UP locked for 3 min)"},
+  {"rh_up_fogger",      "Action: RH_UP - FOGGER"},
+  {"rh_up_mix",         "Action: RH_UP - MIX"},
+  {"rh_up_settle",      "Action: RH_UP - SETTLE"},
+  {"rh_up_complete",    "Action: RH_UP - COMPLETE (RH_DOWN locked for 3 min)"},
+  {"baseline_freshair", "Action: BASELINE - FRESHAIR"},
+  {"baseline_settle",   "Action: BASELINE - SETTLE"},
+  {"baseline_complete", "Action: BASELINE - COMPLETE"},
+  {"safety_vent",       "Action: SAFETY - VENT"},
+  {"safety_settle",     "Action: SAFETY - SETTLE"},
+  {"safety_complete",   "Action: SAFETY - COMPLETE"},
+  {"co2_high",          "Controller: CO2 high ({} ppm, setpoint={}) -> CO2 action"},
+  {"rh_high",           "Controller: RH high ({.1} %, threshold={.1}) -> RH_DOWN action"},
+  {"rh_low",            "Controller: RH low ({.1} %, threshold={.1}) -> RH_UP action"},
+  {"baseline_due",      "Controller: Baseline due (no ventilation for 10 min)"},
+  {"actions_queued",    "Arbiter: actions 0x{x} queued behind action {}"},
+  {"co2_critical",      "Safety: CO2 critical ({} ppm, limit={}) -> SAFETY action"},
+  {"temp_critical",     "Safety: Temp critical ({.1} °C, limit={.1}) -> SAFETY action, heater off"},
+  {"safety_clear",      "Safety: all limits clear"},
+  {"action_preempted",  "Arbiter: action {} aborted in step {}"},
+  {"action_shortened",  "Arbiter: action {} settle step {} cut short"},
+  {"measure_swirl",     "Measurement: SWIRL"},
+  {"measure_median",    "Measurement: MEDIAN sampling"},
+  {"measure_evaluate",  "Measurement: EVALUATE"},
+  {"measure_result",    "Median: RH={.1} Temp={.1} CO2={}"},
+  {"measure_wait",      "Measurement: WAIT ({} s)"},
+  {"measure_cycle",     "Measurement: SWIRL (new cycle)"},
+  {"measure_skip",      "Measurement: air mixed, swirl skipped"},
+  {"measure_swirl_short", "Measurement: air mixed after {} ms swirl"},
+  {"measure_early",     "Measurement: trend nears a threshold, new cycle after {} s"},
+  {"heater_on",         "Heater: ON (temp={.1}, setpoint={.1})!"},
+  {"heater_off",        "Heater: OFF (temp={.1}, setpoint={.1})!"},
+  {"heater_stale",      "Heater: OFF (no fresh temperature reading)!"},
+  {"co2_setpoint",      "Controller: CO2 setpoint changed to {} ppm"},
+  {"rh_setpoint",       "Controller: RH setpoint changed to {.1} %"},
+  {"temp_setpoint",     "Controller: Temp setpoint changed to {.1} °C"},
+  {"probe_fault",       "Temp probe: fault 0x{x} on channel {}"},
+  {"modbus_timeout",    "Modbus: slave {} not responding"},
+  {"modbus_exception",  "Modbus: slave {} exception {}"},
+  {"web_connect",       "Web: Client connected"},
+  {"web_request",       "Web: Request path: {s}"},
+  {"web_streamed",      "API: Streamed {} bytes in {} us"},
+  {"web_disconnect",    "Web: Client disconnected"},
+  {"web_idle_timeout",  "Web: Client idle timeout"},
+  {"web_stream_open",   "Web: Stream subscriber joined ({} open)"},
+  {"web_stream_dropped", "Web: Stream subscriber too slow, dropped"},
+  {"api_co2_setpoint",  "API: Setpoint set to {}"},
+  {"api_rh_setpoint",   "API: RH setpoint set to {.1}"},
+  {"api_temp_setpoint", "API: Temp setpoint set to {.1}"},
+  {"api_settings_batch", "API: {} settings queued as one batch"},
+  {"api_asset_stored",  "API: Asset stored, {} bytes, CRC {x}"},
+  {"api_time_set",      "API: Clock set, step {} s"},
+  {"mqtt_connected",    "MQTT: Connected, {} samples to catch up"},
+  {"mqtt_connect_failed", "MQTT: Broker unreachable, retry in {} s"},
+  {"mqtt_refused",      "MQTT: Connection refused (code {}), retry in {} s"},
+  {"mqtt_timeout",      "MQTT: Broker not answering, retry in {} s"},
+  {"mqtt_lost",         "MQTT: Connection lost, retry in {} s"},
+  {"mqtt_backlog_dropped", "MQTT: Offline queue full, {} samples dropped"},
+  {"can_node_online",   "CAN: Node {} online"},
+  {"can_node_lost",     "CAN: Node {} silent for {} ms"},
+  {"can_settings_batch", "CAN: {} settings received as one batch (tag {})"},
+  {"can_batch_dropped", "CAN: Incomplete settings batch {} dropped after {} frames"},
+  {"usb_mounted",       "USB: Stick mounted"},
+  {"usb_file",          "USB: Log file {} opened"},
+  {"usb_removed",       "USB: Stick unmounted, {} frames lost ({} write errors)"},
+  {"trace_start",       "Trace: Replay of samples {}..{} started"},
+  {"trace_done",        "Trace: Replay done, {} samples, {} actions, pass max {} us"},
+  {"trace_stopped",     "Trace: Replay stopped after {} samples"},
+  {"alarm_raised",      "Alarm {} RAISED: value {}, limit {}"},
+  {"alarm_cleared",     "Alarm {} cleared: value {}"},
+};
+
+static const char *const MODULE_NAMES[EVENT_MODULE_COUNT] = {"control", "sensors", "web"};
+static const char *const LEVEL_NAMES[] = {"off", "error", "warn", "info", "debug"};
+
+static_assert(sizeof(EVENT_CLASS) / sizeof(EVENT_CLASS[0]) == EVT_COUNT, "EVENT_CLASS out of sync");
+static_assert(sizeof(EventRecord) == 24, "EventRecord must be exactly 24 bytes");
+
+static constexpr uint16_t CAPACITY = Config::EventLog::CAPACITY;
+static constexpr uint16_t MASK = CAPACITY - 1;
+static_assert((CAPACITY & MASK) == 0, "Config::EventLog::CAPACITY must be a power of two");
+
+static constexpr size_t LINE_MAX = 96;
+
+// Ring slot; seq is 0 while the slot is being written
+struct EventSlot {
+  std::atomic<uint32_t> seq;
+  uint32_t timestampMs;
+  uint8_t id;
+  uint8_t chamber;
+  int32_t args[3];
+};
+
+// Internal state
+static EventSlot g_slots[CAPACITY];
+static std::atomic<uint32_t> g_head(0);   // Newest claimed sequence number
+static uint32_t g_drainSeq = 1;           // Next record to print (drain task only)
+static int g_txRoomMax = 0;                // Largest Serial.availableForWrite() seen (drain task only)
+static uint32_t g_dropped = 0;
+
+static EventSlot &slotFor(uint32_t seq) {
+  return g_slots[(seq - 1) & MASK];
+}
+
+static void store(EventId id, const int32_t *args, uint8_t chamber) {
+  uint32_t seq = g_head.fetch_add(1, std::memory_order_relaxed) + 1;
+  EventSlot &slot = slotFor(seq);
+  slot.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.timestampMs = millis();
+  slot.id = id;
+  slot.chamber = chamber;
+  memcpy(slot.args, args, sizeof(slot.args));
+  slot.seq.store(seq, std::memory_order_release);
+}
+
+void event_log_record(EventId id, int32_t a0, int32_t a1, int32_t a2, uint8_t chamber) {
+  const int32_t args[3] = {a0, a1, a2};
+  store(id, args, chamber);
+}
+
+void event_log_record_text(EventId id, const char *text) {
+  int32_t args[3] = {0, 0, 0};
+  size_t len = strnlen(text, EVENT_TEXT_MAX);
+  memcpy(args, text, len);
+  store(id, args, 0);
+}
+
+uint32_t event_log_newest_seq() {
+  return g_head.load(std::memory_order_acquire);
+}
+
+uint32_t event_log_oldest_seq() {
+  uint32_t newest = event_log_newest_seq();
+  return newest > CAPACITY ? newest - CAPACITY + 1 : 1;
+}
+
+bool event_log_read(uint32_t seq, EventRecord *out) {
+  uint32_t newest = event_log_newest_seq();
+  if (seq == 0 || seq > newest || newest - seq >= CAPACITY) return false;
+  const EventSlot &slot = slotFor(seq);
+  if (slot.seq.load(std::memory_order_acquire) != seq) return false;
+  out->seq = seq;
+  out->timestampMs = slot.timestampMs;
+  out->id = slot.id;
+  out->chamber = slot.chamber;
+  memset(out->reserved, 0, sizeof(out->reserved));
+  memcpy(out->args, slot.args, sizeof(out->args));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // Overwritten while copying?
+  return slot.seq.load(std::memory_order_relaxed) == seq;
+}
+
+uint32_t event_log_dropped() {
+  return g_dropped;
+}
+
+// --- Formatting ---
+
+static size_t appendInt(char *out, size_t cap, int32_t value, uint8_t decimals, bool hex) {
+  char buf[16];
+  int len;
+  if (hex) {
+    len = snprintf(buf, sizeof(buf), "%lX", (unsigned long)(uint32_t)value);
+  } else if (decimals == 1) {
+    uint32_t mag = value < 0 ? (uint32_t)(-(int64_t)value) : (uint32_t)value;
+    len = snprintf(buf, sizeof(buf), "%s%lu.%lu", value < 0 ? "-" : "",
+                   (unsigned long)(mag / 10), (unsigned long)(mag % 10));
+  } else {
+    len = snprintf(buf, sizeof(buf), "%ld", (long)value);
+  }
+  size_t n = (size_t)len < cap ? (size_t)len : cap;
+  memcpy(out, buf, n);
+  return n;
+}
+
+size_t event_log_format(const EventRecord &record, char *out, size_t cap) {
+  if (cap == 0) return 0;
+  size_t len = 0;
+  size_t room = cap - 1;
+  if (record.id >= EVT_COUNT) {
+    out[0] = '\0';
+    return 0;
+  }
+
+  const char *p = EVENT_FORMAT[record.id].format;
+  uint8_t arg = 0;
+  while (*p != '\0' && len < room) {
+    if (*p != '{') {
+      out[len++] = *p++;
+      continue;
+    }
+    const char *end = strchr(p, '}');
+    if (end == nullptr) break;
+    const char *spec = p + 1;
+    int32_t value = arg < 3 ? record.args[arg] : 0;
+    if (*spec == 's') {
+      const char *text = (const char *)record.args;
+      size_t n = strnlen(text, EVENT_TEXT_MAX);
+      if (n > room - len) n = room - len;
+      memcpy(out + len, text, n);
+      len += n;
+    } else if (*spec == 'b') {
+      const char *state = value ? "ON" : "OFF";
+      size_t n = strlen(state);
+      if (n > room - len) n = room - len;
+      memcpy(out + len, state, n);
+      len += n;
+      arg++;
+    } else {
+      len += appendInt(out + len, room - len, value, *spec == '.' ? 1 : 0, *spec == 'x');
+      arg++;
+    }
+    p = end + 1;
+  }
+  out[len] = '\0';
+  return len;
+}
+
+const char *event_log_name(uint8_t id) {
+  return id < EVT_COUNT ? EVENT_FORMAT[id].name : "unknown";
+}
+
+const char *event_log_module_name(uint8_t id) {
+  return id < EVT_COUNT ? MODULE_NAMES[EVENT_CLASS[id].module] : "unknown";
+}
+
+const char *event_log_level_name(uint8_t id) {
+  return id < EVT_COUNT ? LEVEL_NAMES[EVENT_CLASS[id].level] : "unknown";
+}
+
+// Placeholder `index` of an event's format (nullptr if there are fewer)
+static const char *placeholder(uint8_t id, uint8_t index) {
+  const char *p = EVENT_FORMAT[id].format;
+  while ((p = strchr(p, '{')) != nullptr) {
+    if (p[1] != 's') {
+      if (index == 0) return p + 1;
+      index--;
+    }
+    p++;
+  }
+  return nullptr;
+}
+
+uint8_t event_log_arg_count(uint8_t id) {
+  if (id >= EVT_COUNT) return 0;
+  uint8_t count = 0;
+  while (count < 3 && placeholder(id, count) != nullptr) count++;
+  return count;
+}
+
+uint8_t event_log_arg_decimals(uint8_t id, uint8_t arg) {
+  if (id >= EVT_COUNT) return 0;
+  const char *spec = placeholder(id, arg);
+  return (spec != nullptr && *spec == '.') ? 1 : 0;
+}
+
+// --- Serial drain ---
+
+static void reportDropped(uint32_t count) {
+  Serial.print("Event log: ");
+  Serial.print(count);
+  Serial.println(" events dropped");
+}
+
+unsigned long event_log_next_due_ms(unsigned long now) {
+  if (g_drainSeq <= event_log_newest_seq()) return now;
+  return now + Config::Scheduler::MAX_IDLE_MS;
+}
+
+void event_log_tick(unsigned long now) {
+  (void)now;
+  uint32_t dropped = 0;
+
+  for (uint8_t line = 0; line < Config::EventLog::DRAIN_LINES_PER_TICK; line++) {
+    uint32_t newest = event_log_newest_seq();
+    if (g_drainSeq > newest) break;
+    if (newest - g_drainSeq >= CAPACITY) {
+      // Lapped by the writers
+      uint32_t oldest = newest - CAPACITY + 1;
+      dropped += oldest - g_drainSeq;
+      g_drainSeq = oldest;
+    }
+
+    EventRecord record;
+    if (!event_log_read(g_drainSeq, &record)) {
+      uint32_t slotSeq = slotFor(g_drainSeq).seq.load(std::memory_order_acquire);
+      if (slotSeq == 0 || slotSeq < g_drainSeq) break; // Still being written
+      dropped++;                                        // Overwritten meanwhile
+      g_drainSeq++;
+      continue;
+    }
+
+    char text[LINE_MAX];
+    int len = (Config::Chambers::COUNT > 1)
+                  ? snprintf(text, sizeof(text), "[%lu] C%u ", (unsigned long)record.timestampMs, record.chamber)
+                  : snprintf(text, sizeof(text), "[%lu] ", (unsigned long)record.timestampMs);
+    len += event_log_format(record, text + len, sizeof(text) - len);
+
+    // 0 = the port does not report its buffer; rely on DRAIN_LINES_PER_TICK.
+    // A line longer than the whole buffer goes out once the buffer is empty.
+    int room = Serial.availableForWrite();
+    if (room > g_txRoomMax) g_txRoomMax = room;
+    if (room > 0 && room < len + 2 && room < g_txRoomMax) break;
+    Serial.write((const uint8_t *)text, len);
+    Serial.println();
+    g_drainSeq++;
+  }
+
+  if (dropped > 0) {
+    g_dropped += dropped;
+    reportDropped(dropped);
+  }
+}
@@ -0,0 +1,360 @@
+/*
+ * *****************************************************************************
+ * EVENT LOG - BINARY RING-BUFFER EVENT LOG
+ * *****************************************************************************
+ * Replaces the Serial.print() calls on the control and network hot paths:
+ * - event_log() stores one fixed-size record (timestamp, event id, three
+ *   int32 arguments) in a RAM ring; no formatting, no waiting for the port
+ * - The event log task drains the ring to Serial in the background, one or two
+ *   lines per pass and only while the port has room; records that are
+ *   overwritten before they were printed are counted as dropped
+ * - Each event belongs to a module with a compile-time level
+ *   (Config::EventLog::LEVEL_*); events above it are compiled out
+ * - /api/events serves the retained records, formatted on request
+ *
+ * Writers on both sides (control loop, network thread) claim a slot with one
+ * atomic increment; every record carries its own sequence number, published
+ * last, so a reader detects a record that is still being written or has been
+ * overwritten in the meantime.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "config.h"
+
+enum EventModule : uint8_t {
+  EVENT_MODULE_CONTROL = 0,
+  EVENT_MODULE_SENSORS,
+  EVENT_MODULE_WEB,
+  EVENT_MODULE_COUNT
+};
+
+enum EventLevel : uint8_t {
+  EVENT_ERROR = 1,
+  EVENT_WARN = 2,
+  EVENT_INFO = 3,
+  EVENT_DEBUG = 4
+};
+
+/**
+ * @brief Event catalogue; module and level in EVENT_CLASS, names and
+ *        formats in event_log.cpp (same order)
+ */
+enum EventId : uint8_t {
+  // Control: actuators (arg: on)
+  EVT_SWIRLER = 0,
+  EVT_FRESHAIR,
+  EVT_FOGGER,
+  EVT_HEATER,
+  // Control: action stages
+  EVT_CO2_SWIRL,
+  EVT_CO2_SETTLE,
+  EVT_CO2_COMPLETE,
+  EVT_RH_DOWN_FRESHAIR,
+  EVT_RH_DOWN_SWIRL,
+  EVT_RH_DOWN_SETTLE,
+  EVT_RH_DOWN_COMPLETE,
+  EVT_RH_UP_FOGGER,
+  EVT_RH_UP_MIX,
+  EVT_RH_UP_SETTLE,
+  EVT_RH_UP_COMPLETE,
+  EVT_BASELINE_FRESHAIR,
+  EVT_BASELINE_SETTLE,
+  EVT_BASELINE_COMPLETE,
+  EVT_SAFETY_VENT,
+  EVT_SAFETY_SETTLE,
+  EVT_SAFETY_COMPLETE,
+  // Control: decisions (args: value, limit; RH in 0.1 %)
+  EVT_CO2_HIGH,
+  EVT_RH_HIGH,
+  EVT_RH_LOW,
+  EVT_BASELINE_DUE,
+  EVT_ACTIONS_QUEUED,       // ActionType bit mask, running action
+  EVT_CO2_CRITICAL,         // ppm, limit
+  EVT_TEMP_CRITICAL,        // temp, limit (0.1)
+  EVT_SAFETY_CLEAR,
+  EVT_ACTION_PREEMPTED,     // action, step
+  EVT_ACTION_SHORTENED,     // action, step
+  // Control: measurement cycle
+  EVT_MEASURE_SWIRL,
+  EVT_MEASURE_MEDIAN,
+  EVT_MEASURE_EVALUATE,
+  EVT_MEASURE_RESULT,       // rh, temp (0.1), co2
+  EVT_MEASURE_WAIT,         // wait (s)
+  EVT_MEASURE_CYCLE,
+  EVT_MEASURE_SWIRL_SKIPPED,
+  EVT_MEASURE_SWIRL_SHORT,  // swirl (ms)
+  EVT_MEASURE_EARLY,        // waited (s)
+  // Control: heater regulation (args: temp, setpoint in 0.1 °C)
+  EVT_HEATER_ON,
+  EVT_HEATER_OFF,
+  EVT_HEATER_STALE,
+  // Control: applied setpoints
+  EVT_CO2_SETPOINT,
+  EVT_RH_SETPOINT,
+  EVT_TEMP_SETPOINT,
+  // Sensors
+  EVT_PROBE_FAULT,          // fault code, channel
+  EVT_MODBUS_TIMEOUT,       // slave
+  EVT_MODBUS_EXCEPTION,     // slave, exception code
+  // Web
+  EVT_WEB_CONNECT,
+  EVT_WEB_REQUEST,          // First 12 characters of the path
+  EVT_WEB_STREAMED,         // bytes, us
+  EVT_WEB_DISCONNECT,
+  EVT_WEB_IDLE_TIMEOUT,
+  EVT_WEB_STREAM_OPEN,      // open subscribers
+  EVT_WEB_STREAM_DROPPED,   // subscriber lagged a whole frame behind
+  EVT_API_CO2_SETPOINT,
+  EVT_API_RH_SETPOINT,
+  EVT_API_TEMP_SETPOINT,
+  EVT_API_SETTINGS_BATCH,   // settings in the batch
+  EVT_API_ASSET_STORED,     // bytes, crc32
+  EVT_API_TIME_SET,         // step (s)
+  // MQTT (network side, logged under the web module)
+  EVT_MQTT_CONNECTED,       // backlog samples
+  EVT_MQTT_CONNECT_FAILED,  // retry in s
+  EVT_MQTT_REFUSED,         // CONNACK return code, retry in s
+  EVT_MQTT_TIMEOUT,         // retry in s
+  EVT_MQTT_LOST,            // retry in s
+  EVT_MQTT_BACKLOG_DROPPED, // samples
+  // CAN fleet link (network side, logged under the web module)
+  EVT_CAN_NODE_ONLINE,      // node
+  EVT_CAN_NODE_LOST,        // node, silent for ms
+  EVT_CAN_SETTINGS_BATCH,   // settings, batch tag (chamber in the record)
+  EVT_CAN_BATCH_DROPPED,    // batch tag, frames received of it
+  // USB stick logger (writer thread, logged under the web module)
+  EVT_USB_MOUNTED,
+  EVT_USB_FILE,             // files opened
+  EVT_USB_REMOVED,          // frames lost, write errors
+  // Trace replay (sample task, logged under the control module)
+  EVT_TRACE_START,          // first, last sample number
+  EVT_TRACE_DONE,           // samples, actions, max pass us
+  EVT_TRACE_STOPPED,        // samples
+  // Alarms (sample task, logged under the control module; names in /api/alarms)
+  EVT_ALARM_RAISED,         // AlarmRule, value, limit
+  EVT_ALARM_CLEARED,        // AlarmRule, value
+  EVT_COUNT
+};
+
+struct EventClass {
+  EventModule module;
+  EventLevel level;
+};
+
+static constexpr EventClass EVENT_CLASS[EVT_COUNT] = {
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_SWIRLER
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_FRESHAIR
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_FOGGER
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_HEATER
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_CO2_SWIRL
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_CO2_SETTLE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_CO2_COMPLETE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_RH_DOWN_FRESHAIR
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_RH_DOWN_SWIRL
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_RH_DOWN_SETTLE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_RH_DOWN_COMPLETE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_RH_UP_FOGGER
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_RH_UP_MIX
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_RH_UP_SETTLE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_RH_UP_COMPLETE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_BASELINE_FRESHAIR
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_BASELINE_SETTLE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_BASELINE_COMPLETE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_SAFETY_VENT
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_SAFETY_SETTLE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_SAFETY_COMPLETE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_CO2_HIGH
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_RH_HIGH
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_RH_LOW
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_BASELINE_DUE
+  {EVENT_MODULE_CONTROL, EVENT_DEBUG},  // EVT_ACTIONS_QUEUED
+  {EVENT_MODULE_CONTROL, EVENT_ERROR},  // EVT_CO2_CRITICAL
+  {EVENT_MODULE_CONTROL, EVENT_ERROR},  // EVT_TEMP_CRITICAL
+  {EVENT_MODULE_CONTROL, EVENT_WARN},   // EVT_SAFETY_CLEAR
+  {EVENT_MODULE_CONTROL, EVENT_WARN},   // EVT_ACTION_PREEMPTED
+  {EVENT_MODULE_CONTROL, EVENT_WARN},   // EVT_ACTION_SHORTENED
+  {EVENT_MODULE_CONTROL, EVENT_DEBUG},  // EVT_MEASURE_SWIRL
+  {EVENT_MODULE_CONTROL, EVENT_DEBUG},  // EVT_MEASURE_MEDIAN
+  {EVENT_MODULE_CONTROL, EVENT_DEBUG},  // EVT_MEASURE_EVALUATE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_MEASURE_RESULT
+  {EVENT_MODULE_CONTROL, EVENT_DEBUG},  // EVT_MEASURE_WAIT
+  {EVENT_MODULE_CONTROL, EVENT_DEBUG},  // EVT_MEASURE_CYCLE
+  {EVENT_MODULE_CONTROL, EVENT_DEBUG},  // EVT_MEASURE_SWIRL_SKIPPED
+  {EVENT_MODULE_CONTROL, EVENT_DEBUG},  // EVT_MEASURE_SWIRL_SHORT
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_MEASURE_EARLY
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_HEATER_ON
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_HEATER_OFF
+  {EVENT_MODULE_CONTROL, EVENT_WARN},   // EVT_HEATER_STALE
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_CO2_SETPOINT
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_RH_SETPOINT
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_TEMP_SETPOINT
+  {EVENT_MODULE_SENSORS, EVENT_WARN},   // EVT_PROBE_FAULT
+  {EVENT_MODULE_SENSORS, EVENT_WARN},   // EVT_MODBUS_TIMEOUT
+  {EVENT_MODULE_SENSORS, EVENT_WARN},   // EVT_MODBUS_EXCEPTION
+  {EVENT_MODULE_WEB, EVENT_DEBUG},      // EVT_WEB_CONNECT
+  {EVENT_MODULE_WEB, EVENT_DEBUG},      // EVT_WEB_REQUEST
+  {EVENT_MODULE_WEB, EVENT_DEBUG},      // EVT_WEB_STREAMED
+  {EVENT_MODULE_WEB, EVENT_DEBUG},      // EVT_WEB_DISCONNECT
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_WEB_IDLE_TIMEOUT
+  {EVENT_MODULE_WEB, EVENT_DEBUG},      // EVT_WEB_STREAM_OPEN
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_WEB_STREAM_DROPPED
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_API_CO2_SETPOINT
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_API_RH_SETPOINT
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_API_TEMP_SETPOINT
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_API_SETTINGS_BATCH
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_API_ASSET_STORED
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_API_TIME_SET
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_MQTT_CONNECTED
+  {EVENT_MODULE_WEB, EVENT_WARN},       // EVT_MQTT_CONNECT_FAILED
+  {EVENT_MODULE_WEB, EVENT_WARN},       // EVT_MQTT_REFUSED
+  {EVENT_MODULE_WEB, EVENT_WARN},       // EVT_MQTT_TIMEOUT
+  {EVENT_MODULE_WEB, EVENT_WARN},       // EVT_MQTT_LOST
+  {EVENT_MODULE_WEB, EVENT_WARN},       // EVT_MQTT_BACKLOG_DROPPED
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_CAN_NODE_ONLINE
+  {EVENT_MODULE_WEB, EVENT_WARN},       // EVT_CAN_NODE_LOST
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_CAN_SETTINGS_BATCH
+  {EVENT_MODULE_WEB, EVENT_WARN},       // EVT_CAN_BATCH_DROPPED
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_USB_MOUNTED
+  {EVENT_MODULE_WEB, EVENT_INFO},       // EVT_USB_FILE
+  {EVENT_MODULE_WEB, EVENT_WARN},       // EVT_USB_REMOVED
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_TRACE_START
+  {EVENT_MODULE_CONTROL, EVENT_INFO},   // EVT_TRACE_DONE
+  {EVENT_MODULE_CONTROL, EVENT_WARN},   // EVT_TRACE_STOPPED
+  {EVENT_MODULE_CONTROL, EVENT_ERROR},  // EVT_ALARM_RAISED
+  {EVENT_MODULE_CONTROL, EVENT_WARN},   // EVT_ALARM_CLEARED
+};
+
+/**
+ * @brief One logged event (24 bytes)
+ */
+struct EventRecord {
+  uint32_t seq;          ///< 1-based sequence number (0 = slot being written)
+  uint32_t timestampMs;  ///< millis() when logged
+  uint8_t id;            ///< EventId
+  uint8_t chamber;       ///< Controller instance of control events (0 for the rest)
+  uint8_t reserved[2];
+  int32_t args[3];       ///< Event arguments (or 12 characters of text)
+};
+
+static constexpr uint8_t EVENT_TEXT_MAX = sizeof(EventRecord::args);
+
+constexpr uint8_t event_module_level(EventModule module) {
+  return module == EVENT_MODULE_CONTROL ? Config::EventLog::LEVEL_CONTROL
+       : module == EVENT_MODULE_SENSORS ? Config::EventLog::LEVEL_SENSORS
+       : Config::EventLog::LEVEL_WEB;
+}
+
+/**
+ * @brief Whether an event passes the compile-time level of its module
+ */
+constexpr bool event_enabled(EventId id) {
+  return EVENT_CLASS[id].level <= event_module_level(EVENT_CLASS[id].module);
+}
+
+/**
+ * @brief Store a record (no level check; use event_log())
+ */
+void event_log_record(EventId id, int32_t a0, int32_t a1, int32_t a2, uint8_t chamber = 0);
+
+/**
+ * @brief Store a record whose arguments are the first characters of text
+ */
+void event_log_record_text(EventId id, const char *text);
+
+/**
+ * @brief Log an event; compiled out if its level is disabled
+ */
+inline void event_log(EventId id, int32_t a0 = 0, int32_t a1 = 0, int32_t a2 = 0) {
+  if (event_enabled(id)) event_log_record(id, a0, a1, a2);
+}
+
+/**
+ * @brief Log an event of one chamber (Config::Chambers); compiled out like event_log()
+ */
+inline void event_log_chamber(uint8_t chamber, EventId id, int32_t a0 = 0, int32_t a1 = 0, int32_t a2 = 0) {
+  if (event_enabled(id)) event_log_record(id, a0, a1, a2, chamber);
+}
+
+/**
+ * @brief Log a text event (EVT_WEB_REQUEST); truncated to EVENT_TEXT_MAX
+ */
+inline void event_log_text(EventId id, const char *text) {
+  if (event_enabled(id)) event_log_record_text(id, text);
+}
+
+/**
+ * @brief Fixed-point argument in tenths (value * 10, rounded)
+ */
+inline int32_t event_tenths(float value) {
+  return (int32_t)lroundf(value * 10.0f);
+}
+
+/**
+ * @brief Drain pending records to Serial (scheduler task)
+ *
+ * @param now millis() of the current scheduler pass
+ */
+void event_log_tick(unsigned long now);
+
+/**
+ * @brief Next deadline for the scheduler: now while records wait for the drain
+ */
+unsigned long event_log_next_due_ms(unsigned long now);
+
+/**
+ * @brief Sequence number of the newest record (0 = none yet)
+ */
+uint32_t event_log_newest_seq();
+
+/**
+ * @brief Sequence number of the oldest record still in the ring
+ */
+uint32_t event_log_oldest_seq();
+
+/**
+ * @brief Copy one record
+ *
+ * @return false if seq is not (or no longer, or not yet completely) in the ring
+ */
+bool event_log_read(uint32_t seq, EventRecord *out);
+
+/**
+ * @brief Records overwritten before the drain printed them
+ */
+uint32_t event_log_dropped();
+
+/**
+ * @brief Render a record as the text line printed to Serial
+ *
+ * @return Length written (always NUL-terminated, truncated to cap - 1)
+ */
+size_t event_log_format(const EventRecord &record, char *out, size_t cap);
+
+/**
+ * @brief Short event name ("swirler", "co2_high", ...)
+ */
+const char *event_log_name(uint8_t id);
+
+/**
+ * @brief Module name ("control", "sensors", "web")
+ */
+const char *event_log_module_name(uint8_t id);
+
+/**
+ * @brief Level name ("error", "warn", "info", "debug")
+ */
+const char *event_log_level_name(uint8_t id);
+
+/**
+ * @brief Number of argument values of an event (0 for text events)
+ */
+uint8_t event_log_arg_count(uint8_t id);
+
+/**
+ * @brief Decimals of an argument (1 for tenths, else 0)
+ */
+uint8_t event_log_arg_decimals(uint8_t id, uint8_t arg);
@@ -0,0 +1,81 @@
+/*
+ * *****************************************************************************
+ * FIXED POINT - DECI-UNIT SAMPLE VALUES
+ * *****************************************************************************
+ * Sensor samples are integers from acquisition to the wire:
+ * - CO2 in ppm, relative humidity in 0.1 %RH, temperatures in 0.1 °C,
+ *   all int16 (the scaling of SampleRecord and the binary telemetry)
+ * - Driver readings (ADC, probes, Modbus) are converted once, when the
+ *   controller takes its sensor frame; filters, history, tiers, the flash
+ *   log and the serializers only see these integers
+ * - Control maths (PI loops, loop statistics) converts back to float where
+ *   it needs a continuous value
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Fixed-point steps per unit of the deci channels (RH, temperatures)
+constexpr int16_t FIXED_TENTHS_PER_UNIT = 10;
+
+/**
+ * @brief Float to int16 fixed point, rounded and saturated
+ *
+ * @param value Value in its unit
+ * @param scale Steps per unit (1 for ppm, 10 for deci units)
+ */
+inline int16_t fixed_from_float(float value, float scale) {
+  float scaled = value * scale;
+  if (scaled >= 32767.0f) return 32767;
+  if (scaled <= -32768.0f) return -32768;
+  return (int16_t)lroundf(scaled);
+}
+
+/**
+ * @brief Reading in 0.1 steps (RH, temperature)
+ */
+inline int16_t fixed_tenths(float value) {
+  return fixed_from_float(value, FIXED_TENTHS_PER_UNIT);
+}
+
+/**
+ * @brief CO2 reading in ppm (negative readings clamp to 0)
+ */
+inline int16_t fixed_ppm(float value) {
+  return (value <= 0.0f) ? 0 : fixed_from_float(value, 1.0f);
+}
+
+/**
+ * @brief Deci value back to its unit (control maths only)
+ */
+inline float fixed_tenths_to_float(int32_t tenths) {
+  return tenths / (float)FIXED_TENTHS_PER_UNIT;
+}
+
+/**
+ * @brief Fixed-point integer as decimal text: (925, 1) -> "92.5", (-5, 1) -> "-0.5"
+ *
+ * @return Characters written (no NUL), at most 12 + decimals
+ */
+inline size_t fixed_format(char *out, int32_t scaledValue, uint8_t decimals) {
+  char digits[12];
+  size_t n = 0;
+  size_t len = 0;
+  uint32_t magnitude = (scaledValue < 0) ? (uint32_t)(-(int64_t)scaledValue) : (uint32_t)scaledValue;
+
+  do {
+    digits[n++] = '0' + (magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0 || n <= decimals);
+
+  if (scaledValue < 0) out[len++] = '-';
+  while (n > 0) {
+    out[len++] = digits[--n];
+    if (n == decimals && decimals > 0) out[len++] = '.';
+  }
+  return len;
+}
@@ -19,6 +19,10 @@ static uint64_t g_region_start = 0;
 static uint64_t g_region_size = 0;
 static uint32_t g_slot_size = 0;
 static uint32_t g_num_slots = 0;
+static uint64_t g_log_start = 0;
+static uint64_t g_log_size = 0;
+static uint64_t g_asset_start = 0;
+static uint64_t g_asset_size = 0;
 #endif
 
 bool fb_init(uint64_t region_bytes, uint32_t slot_size, uint32_t num_slots) {
@@ -50,6 +54,16 @@ bool fb_init(uint64_t region_bytes, uint32_t slot_size, uint32_t num_slots) {
 #endif
 }
 
+bool fb_read_region(uint64_t offset, void *buffer, size_t len) {
+#if HAVE_BLOCKDEVICE
+  if (offset + len > g_region_size) return false;
+  return (g_bd.read(buffer, g_region_start + offset, len) == 0);
+#else
+  (void)offset; (void)buffer; (void)len;
+  return false;
+#endif
+}
+
 bool fb_read_slot(uint32_t slot, void *buffer, size_t len) {
 #if HAVE_BLOCKDEVICE
   if (slot >= g_num_slots || len != g_slot_size) return false;
@@ -81,6 +95,40 @@ bool fb_erase_region() {
 #endif
 }
 
+uint32_t fb_slots_per_sector() {
+#if HAVE_BLOCKDEVICE
+  if (g_region_size == 0 || g_slot_size == 0) return 0;
+  uint64_t erase_size = g_bd.get_erase_size();
+  if (erase_size <= g_slot_size) return 1;
+  return (uint32_t)(erase_size / g_slot_size);
+#else
+  return 0;
+#endif
+}
+
+uint32_t fb_num_sectors() {
+#if HAVE_BLOCKDEVICE
+  uint32_t per_sector = fb_slots_per_sector();
+  if (per_sector == 0) return 0;
+  return (g_num_slots + per_sector - 1) / per_sector;
+#else
+  return 0;
+#endif
+}
+
+bool fb_erase_sector(uint32_t sector) {
+#if HAVE_BLOCKDEVICE
+  if (sector >= fb_num_sectors()) return false;
+  uint64_t erase_size = g_bd.get_erase_size();
+  if (erase_size < g_slot_size) erase_size = g_slot_size;
+  uint64_t addr = g_region_start + (uint64_t)sector * erase_size;
+  return (g_bd.erase(addr, erase_size) == 0);
+#else
+  (void)sector;
+  return false;
+#endif
+}
+
 bool fb_available() {
 #if HAVE_BLOCKDEVICE
   return (g_region_size > 0);
@@ -104,3 +152,134 @@ uint64_t fb_region_size() {
   return 0;
 #endif
 }
+
+uint32_t fb_erase_size() {
+#if HAVE_BLOCKDEVICE
+  return (g_region_size > 0) ? (uint32_t)g_bd.get_erase_size() : 0;
+#else
+  return 0;
+#endif
+}
+
+uint32_t fb_program_size() {
+#if HAVE_BLOCKDEVICE
+  return (g_region_size > 0) ? (uint32_t)g_bd.get_program_size() : 0;
+#else
+  return 0;
+#endif
+}
+
+bool fb_log_init(uint64_t region_bytes) {
+#if HAVE_BLOCKDEVICE
+  if (g_region_size == 0) return false;
+  uint64_t erase_size = g_bd.get_erase_size();
+  uint64_t log_size = region_bytes;
+  if (erase_size > 0) {
+    log_size = (log_size / erase_size) * erase_size; // whole erase blocks only
+  }
+  if (log_size == 0 || log_size > g_region_start) return false;
+
+  g_log_size = log_size;
+  g_log_start = g_region_start - g_log_size; // directly below the slot region
+  return true;
+#else
+  (void)region_bytes;
+  return false;
+#endif
+}
+
+bool fb_log_read(uint64_t offset, void *buffer, size_t len) {
+#if HAVE_BLOCKDEVICE
+  if (offset + len > g_log_size) return false;
+  return (g_bd.read(buffer, g_log_start + offset, len) == 0);
+#else
+  (void)offset; (void)buffer; (void)len;
+  return false;
+#endif
+}
+
+bool fb_log_program(uint64_t offset, const void *buffer, size_t len) {
+#if HAVE_BLOCKDEVICE
+  if (offset + len > g_log_size) return false;
+  return (g_bd.program(buffer, g_log_start + offset, len) == 0);
+#else
+  (void)offset; (void)buffer; (void)len;
+  return false;
+#endif
+}
+
+bool fb_log_erase(uint64_t offset, uint64_t len) {
+#if HAVE_BLOCKDEVICE
+  if (offset + len > g_log_size) return false;
+  return (g_bd.erase(g_log_start + offset, len) == 0);
+#else
+  (void)offset; (void)len;
+  return false;
+#endif
+}
+
+uint64_t fb_log_size() {
+#if HAVE_BLOCKDEVICE
+  return g_log_size;
+#else
+  return 0;
+#endif
+}
+
+bool fb_asset_init(uint64_t region_bytes) {
+#if HAVE_BLOCKDEVICE
+  if (g_region_size == 0) return false;
+  uint64_t top = (g_log_size > 0) ? g_log_start : g_region_start;
+  uint64_t erase_size = g_bd.get_erase_size();
+  uint64_t asset_size = region_bytes;
+  if (erase_size > 0) {
+    asset_size = (asset_size / erase_size) * erase_size; // whole erase blocks only
+  }
+  if (asset_size == 0 || asset_size > top) return false;
+
+  g_asset_size = asset_size;
+  g_asset_start = top - g_asset_size; // directly below the log region
+  return true;
+#else
+  (void)region_bytes;
+  return false;
+#endif
+}
+
+bool fb_asset_read(uint64_t offset, void *buffer, size_t len) {
+#if HAVE_BLOCKDEVICE
+  if (offset + len > g_asset_size) return false;
+  return (g_bd.read(buffer, g_asset_start + offset, len) == 0);
+#else
+  (void)offset; (void)buffer; (void)len;
+  return false;
+#endif
+}
+
+bool fb_asset_program(uint64_t offset, const void *buffer, size_t len) {
+#if HAVE_BLOCKDEVICE
+  if (offset + len > g_asset_size) return false;
+  return (g_bd.program(buffer, g_asset_start + offset, len) == 0);
+#else
+  (void)offset; (void)buffer; (void)len;
+  return false;
+#endif
+}
+
+bool fb_asset_erase(uint64_t offset, uint64_t len) {
+#if HAVE_BLOCKDEVICE
+  if (offset + len > g_asset_size) return false;
+  return (g_bd.erase(g_asset_start + offset, len) == 0);
+#else
+  (void)offset; (void)len;
+  return false;
+#endif
+}
+
+uint64_t fb_asset_size() {
+#if HAVE_BLOCKDEVICE
+  return g_asset_size;
+#else
+  return 0;
+#endif
+}
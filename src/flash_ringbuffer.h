@@ -9,22 +9,27 @@ extern "C" {
 #endif
 
 // Ring Buffer Configuration
-static constexpr uint32_t RING_BUFFER_NUM_SLOTS = 100;  // ~270 days of daily storage
-static constexpr uint32_t RING_BUFFER_SLOT_SIZE = 64;   // 64 bytes per slot
+static constexpr uint32_t RING_BUFFER_NUM_SLOTS = 16;   // Settings images (2 x 4 KB sectors)
+static constexpr uint32_t RING_BUFFER_SLOT_SIZE = 512;  // 512 bytes per slot (one full settings image)
 static constexpr uint32_t RING_BUFFER_TOTAL_SIZE = RING_BUFFER_NUM_SLOTS * RING_BUFFER_SLOT_SIZE;
 
 // Storage Model
 // - Fixed-size ring buffer carved from the tail of QSPI/FlashIAP when available;
 //   otherwise the app falls back to RAM.
 // Wear and Data Integrity
-// - Wear is reduced by appending writes across slots and erasing the whole
-//   region only on wrap.
+// - Wear is reduced by appending writes across slots; erases are done one
+//   sector (erase block) at a time, ahead of the write position, so the
+//   newest slot always survives.
 // - Integrity relies on per-slot CRC and treating 0xFF as "unwritten".
 // API: Initialization
 // - Returns true on success.
 // - Parameters: total region size in bytes, slot size in bytes, number of slots.
 bool fb_init(uint64_t region_bytes, uint32_t slot_size, uint32_t num_slots);
 
+// API: Read raw bytes at an offset into the slot region (e.g. an older slot
+// layout). Returns true on success.
+bool fb_read_region(uint64_t offset, void *buffer, size_t len);
+
 // API: Read a slot from the flash region. Returns true on success.
 bool fb_read_slot(uint32_t slot, void *buffer, size_t len);
 
@@ -34,10 +39,41 @@ bool fb_write_slot(uint32_t slot, const void *buffer, size_t len);
 // API: Erase the reserved flash region. Returns true on success.
 bool fb_erase_region();
 
+// API: Sector granularity of the slot region
+// - A sector is one erase block; slot `s` lives in sector s / fb_slots_per_sector().
+uint32_t fb_slots_per_sector();
+uint32_t fb_num_sectors();
+
+// API: Erase one sector of the slot region. Returns true on success.
+bool fb_erase_sector(uint32_t sector);
+
 // API: Query helpers
 bool fb_available();
 uint64_t fb_region_start();
 uint64_t fb_region_size();
+uint32_t fb_erase_size();    // Erase granularity of the device (0 if unavailable)
+uint32_t fb_program_size();  // Program granularity of the device (0 if unavailable)
+
+// Log Region
+// - Second region placed directly in front of the slot region, for the
+//   append-only sample log (sample_log.cpp). Call after fb_init().
+// - Offsets are relative to the start of the log region; erases must be
+//   erase-size aligned.
+bool fb_log_init(uint64_t region_bytes);
+bool fb_log_read(uint64_t offset, void *buffer, size_t len);
+bool fb_log_program(uint64_t offset, const void *buffer, size_t len);
+bool fb_log_erase(uint64_t offset, uint64_t len);
+uint64_t fb_log_size();
+
+// Asset Region
+// - Third region directly in front of the log region (or the slot region
+//   without a log), for static web assets (asset_store.cpp). Call after
+//   fb_log_init(). Same offset and alignment rules as the log region.
+bool fb_asset_init(uint64_t region_bytes);
+bool fb_asset_read(uint64_t offset, void *buffer, size_t len);
+bool fb_asset_program(uint64_t offset, const void *buffer, size_t len);
+bool fb_asset_erase(uint64_t offset, uint64_t len);
+uint64_t fb_asset_size();
 
 #ifdef __cplusplus
 }
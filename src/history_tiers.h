@@ -0,0 +1,172 @@
+/*
+ * *****************************************************************************
+ * HISTORY TIERS - DOWNSAMPLED MIN/MEAN/MAX RINGS
+ * *****************************************************************************
+ * Long-horizon history next to the raw SensorHistory:
+ * - Each tier closes one bucket every BUCKET inputs
+ * - Per bucket and channel: min, mean and max in the int16 fixed point of
+ *   the input frames (fixed_point.h) plus one on-duty byte per packed state
+ *   bit; folding is integer arithmetic only
+ * - Tiers cascade: a closed bucket of one tier is the input of the next,
+ *   so every sample costs O(CHANNELS) work regardless of the horizon
+ * - Same power-of-two ring, sequence numbering and publish order as
+ *   SensorHistory: a closed bucket becomes visible to readers on other
+ *   threads only once it is complete
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Statistic of a downsampled bucket
+ */
+enum TierStat : uint8_t {
+  STAT_MIN,
+  STAT_MEAN,
+  STAT_MAX
+};
+
+template<uint8_t CHANNELS, uint8_t FLAGS, uint16_t CAPACITY>
+class AggregateTier {
+  static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0,
+                "AggregateTier capacity must be a power of two");
+  static_assert(FLAGS <= 8, "State flags are packed into one byte");
+
+private:
+  static constexpr uint16_t MASK = CAPACITY - 1;
+
+  // Closed buckets, channel-major
+  int16_t lo[CHANNELS][CAPACITY];
+  int16_t mean[CHANNELS][CAPACITY];
+  int16_t hi[CHANNELS][CAPACITY];
+  uint8_t duty[FLAGS][CAPACITY];  // 0..255 = 0..100 % on
+  std::atomic<uint32_t> seq;      // Newest closed bucket, bucket `s` at (s - 1) & MASK
+
+  // Open bucket
+  int16_t accLo[CHANNELS];
+  int16_t accHi[CHANNELS];
+  int32_t accSum[CHANNELS];
+  uint16_t accDuty[FLAGS];
+  uint16_t accCount;
+
+  uint16_t bucket;     // Inputs per bucket
+
+  // Mean of the open bucket, rounded half away from zero
+  int16_t accMean(uint8_t ch) const {
+    int32_t half = accCount / 2;
+    int32_t sum = accSum[ch];
+    return (int16_t)((sum >= 0) ? (sum + half) / accCount : (sum - half) / accCount);
+  }
+
+  void resetAccumulator() {
+    for (uint8_t ch = 0; ch < CHANNELS; ch++) {
+      accLo[ch] = INT16_MAX;
+      accHi[ch] = INT16_MIN;
+      accSum[ch] = 0;
+    }
+    memset(accDuty, 0, sizeof(accDuty));
+    accCount = 0;
+  }
+
+  // Ring index of bucket `s` (1 <= s <= newest), clamped to the oldest retained
+  static uint16_t indexOf(uint32_t s, uint32_t newest) {
+    if (newest - s >= CAPACITY) s = newest - CAPACITY + 1;
+    return (uint16_t)(s - 1) & MASK;
+  }
+
+  // Store the open bucket and start a new one
+  void close() {
+    uint32_t next = seq.load(std::memory_order_relaxed) + 1;
+    uint16_t i = indexOf(next, next);
+    for (uint8_t ch = 0; ch < CHANNELS; ch++) {
+      lo[ch][i] = accLo[ch];
+      hi[ch][i] = accHi[ch];
+      mean[ch][i] = accMean(ch);
+    }
+    for (uint8_t f = 0; f < FLAGS; f++) {
+      duty[f][i] = (uint8_t)((accDuty[f] + accCount / 2) / accCount);
+    }
+    seq.store(next, std::memory_order_release); // Publish after the bucket is complete
+    resetAccumulator();
+  }
+
+public:
+  /**
+   * @param inputsPerBucket Inputs folded into one bucket
+   */
+  explicit AggregateTier(uint16_t inputsPerBucket) : seq(0), bucket(inputsPerBucket) {
+    memset(lo, 0, sizeof(lo));
+    memset(mean, 0, sizeof(mean));
+    memset(hi, 0, sizeof(hi));
+    memset(duty, 0, sizeof(duty));
+    resetAccumulator();
+  }
+
+  // Fold one raw sample in; returns true when it closed a bucket
+  bool addSample(const int16_t *frame, uint8_t stateWord) {
+    for (uint8_t ch = 0; ch < CHANNELS; ch++) {
+      int16_t v = frame[ch];
+      if (v < accLo[ch]) accLo[ch] = v;
+      if (v > accHi[ch]) accHi[ch] = v;
+      accSum[ch] += v;
+    }
+    for (uint8_t f = 0; f < FLAGS; f++) {
+      if (stateWord & (1u << f)) accDuty[f] += 255;
+    }
+    if (++accCount < bucket) return false;
+    close();
+    return true;
+  }
+
+  // Fold the newest closed bucket of a finer tier in; returns true when it closed a bucket
+  template<uint16_t FINER_CAPACITY>
+  bool addBucket(const AggregateTier<CHANNELS, FLAGS, FINER_CAPACITY> &finer) {
+    uint32_t s = finer.newestSeq();
+    for (uint8_t ch = 0; ch < CHANNELS; ch++) {
+      int16_t l = finer.value(ch, STAT_MIN, s);
+      int16_t m = finer.value(ch, STAT_MEAN, s);
+      int16_t h = finer.value(ch, STAT_MAX, s);
+      if (l < accLo[ch]) accLo[ch] = l;
+      if (h > accHi[ch]) accHi[ch] = h;
+      accSum[ch] += m; // Finer buckets are equally sized, mean of means is exact
+    }
+    for (uint8_t f = 0; f < FLAGS; f++) {
+      accDuty[f] += finer.dutyRaw(f, s);
+    }
+    if (++accCount < bucket) return false;
+    close();
+    return true;
+  }
+
+  uint16_t size() const {
+    uint32_t newest = newestSeq();
+    return (newest < CAPACITY) ? (uint16_t)newest : CAPACITY;
+  }
+  uint32_t newestSeq() const { return seq.load(std::memory_order_acquire); }
+  uint16_t bucketInputs() const { return bucket; }
+  static constexpr uint16_t capacity() { return CAPACITY; }
+
+  // Statistic of bucket `s`; 0 if not yet closed, oldest retained if overwritten
+  int16_t value(uint8_t channel, TierStat stat, uint32_t s) const {
+    uint32_t newest = newestSeq();
+    if (s == 0 || s > newest) return 0;
+    uint16_t i = indexOf(s, newest);
+    return (stat == STAT_MIN) ? lo[channel][i] : (stat == STAT_MAX) ? hi[channel][i] : mean[channel][i];
+  }
+
+  // On-duty of state bit `flag` in bucket `s`, 0..255
+  uint8_t dutyRaw(uint8_t flag, uint32_t s) const {
+    uint32_t newest = newestSeq();
+    if (s == 0 || s > newest) return 0;
+    return duty[flag][indexOf(s, newest)];
+  }
+
+  // On-duty of state bit `flag` in bucket `s`, in percent (0..100)
+  uint8_t dutyPercent(uint8_t flag, uint32_t s) const {
+    return (uint8_t)((dutyRaw(flag, s) * 100u + 127u) / 255u);
+  }
+};
@@ -0,0 +1,124 @@
+/*
+ * *****************************************************************************
+ * JSON READER - FLAT OBJECTS OF NUMBERS, IN PLACE
+ * *****************************************************************************
+ * Reads request bodies like {"co2":900,"rh":92.5} member by member straight
+ * from the receive buffer:
+ * - Keys are slices into the buffer (not NUL-terminated), values floats
+ * - Only what the API needs: one object, string keys without escapes,
+ *   number values; anything else is a syntax error
+ * - No allocation, no copy; the buffer must be NUL-terminated
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief One "key": number member
+ */
+struct JsonMember {
+  const char *key;   ///< Points into the buffer, keyLen characters
+  uint8_t keyLen;
+  float value;
+};
+
+class JsonObjectReader {
+private:
+  const char *p;
+  bool started;
+  bool done;
+  bool failed;
+
+  void skipSpace() {
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+  }
+
+  bool fail() {
+    failed = true;
+    return false;
+  }
+
+public:
+  explicit JsonObjectReader(const char *text) : p(text), started(false), done(false), failed(false) {}
+
+  /**
+   * @brief Read the next member
+   *
+   * @return false at the end of the object or on a syntax error (see ok())
+   */
+  bool next(JsonMember *out) {
+    if (done || failed) return false;
+    skipSpace();
+    if (!started) {
+      if (*p++ != '{') return fail();
+      started = true;
+      skipSpace();
+      if (*p == '}') {
+        p++;
+        return finish();
+      }
+    }
+
+    if (*p++ != '"') return fail();
+    const char *key = p;
+    while (*p != '"') {
+      if (*p == '\0' || *p == '\\') return fail();
+      p++;
+    }
+    size_t keyLen = p - key;
+    p++;
+    if (keyLen == 0 || keyLen > 255) return fail();
+    skipSpace();
+    if (*p++ != ':') return fail();
+    skipSpace();
+
+    // JSON numbers only: strtof alone would also take "inf", "nan", hex
+    if (*p != '-' && (*p < '0' || *p > '9')) return fail();
+    char *end = nullptr;
+    float value = strtof(p, &end);
+    if (end == p) return fail();
+    for (const char *c = p; c < end; c++) {
+      if (!((*c >= '0' && *c <= '9') || *c == '-' || *c == '+' || *c == '.' || *c == 'e' || *c == 'E')) {
+        return fail();
+      }
+    }
+    p = end;
+
+    skipSpace();
+    if (*p == ',') {
+      p++;
+    } else if (*p == '}') {
+      p++;
+      done = true;
+      skipSpace();
+      if (*p != '\0') return fail();
+    } else {
+      return fail();
+    }
+
+    out->key = key;
+    out->keyLen = (uint8_t)keyLen;
+    out->value = value;
+    return true;
+  }
+
+  /// false if next() stopped on a syntax error
+  bool ok() const { return !failed; }
+
+  /// Key comparison for a member
+  static bool keyIs(const JsonMember &member, const char *name) {
+    return strlen(name) == member.keyLen && strncmp(member.key, name, member.keyLen) == 0;
+  }
+
+private:
+  bool finish() {
+    done = true;
+    skipSpace();
+    if (*p != '\0') return fail();
+    return false;
+  }
+};
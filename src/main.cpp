@@ -7,54 +7,213 @@
  * Control platform.
  * 
  * Architecture:
- * - Non-blocking control loops
+ * - Non-blocking control loops on a cooperative priority scheduler
  * - Persistent storage with flash ring buffer
- * - WiFi-enabled web interface
- * - Simulated sensors for testing (10x speedup)
+ * - WiFi-enabled web interface (WiFi in its own thread)
+ * - Simulated sensors on a virtual chamber clock (chamber_clock.h)
  * *****************************************************************************
  */
 
+#include "analog_inputs.h"
+#include "asset_store.h"
+#include "bench.h"
+#include "can_link.h"
+#include "chamber_clock.h"
 #include "config.h"
 #include "controller.h"
 #include "credentials.h"
+#include "event_log.h"
+#include "memory_regions.h"
+#include "modbus_master.h"
+#include "mqtt_client.h"
+#include "outputs.h"
+#include "perf.h"
+#include "sample_log.h"
+#include "scheduler.h"
 #include "storage.h"
+#include "tasks.h"
+#include "temp_probes.h"
+#include "usb_logger.h"
+#include "wall_clock.h"
 #include "web_server.h"
 #include "wifi_manager.h"
 #include <Arduino.h>
 #include <Arduino_PortentaMachineControl.h>
+#include <mbed.h>
 
 // Web server configuration
 static WebServerConfig g_webConfig = {};
 
+// --- Network side and the task entries of main.cpp (tasks.h) ---
+
+#if CC_NETWORK_THREAD
+// WiFi + HTTP run here, below the control loop's priority. The network side
+// reads controller_snapshot() and writes only through control_link, so a
+// stalled socket or a blocking connect never delays a control task.
+static rtos::Thread g_networkThread(osPriorityBelowNormal, Config::Network::THREAD_STACK_BYTES,
+                                    nullptr, "network");
+
+static void networkThreadMain() {
+  wifi_init(WIFI_SSID, WIFI_PASS);
+  unsigned long lastWifiTickMs = millis();
+  while (true) {
+    uint32_t startCycles = perf_cycles();
+    web_server_handle(&g_webConfig);
+    perf_record(PERF_PROBE_NETWORK, perf_cycles() - startCycles);
+    unsigned long now = millis();
+#if CC_MQTT
+    mqtt_tick(now);
+#endif
+#if CC_CAN
+    can_link_tick(now);
+#endif
+    if (now - lastWifiTickMs >= Config::Scheduler::WIFI_PERIOD_MS) {
+      lastWifiTickMs = now;
+      wifi_tick();
+    }
+    rtos::ThisThread::sleep_for(std::chrono::milliseconds(Config::Network::THREAD_IDLE_MS));
+  }
+}
+#else
+// Only WiFi has a thread here: begin() and the network scan block for
+// seconds in the mbed driver, retries and reconnects included. HTTP stays
+// a scheduler task and waits for the link.
+static rtos::Thread g_wifiThread(osPriorityBelowNormal, Config::Network::WIFI_THREAD_STACK_BYTES,
+                                 nullptr, "wifi");
+
+static void wifiThreadMain() {
+  wifi_init(WIFI_SSID, WIFI_PASS);
+  while (true) {
+    wifi_tick();
+    rtos::ThisThread::sleep_for(std::chrono::milliseconds(Config::Scheduler::WIFI_PERIOD_MS));
+  }
+}
+
+void main_web_tick(unsigned long) {
+  if (wifi_connected()) web_server_handle(&g_webConfig);
+}
+#endif
+
+// --- Deferred startup ---
+
+// Boot work that control does not need, one stage per run of the boot task
+// so the control tasks run in between. Flash scans and the network start
+// happen here, after the controller is already regulating.
+enum BootStage : uint8_t {
+  BOOT_SAMPLE_LOG,  // Rebuild the flash sample log index (reads every segment header)
+  BOOT_ASSETS,      // Asset headers, before anything can serve them
+  BOOT_NETWORK,     // MQTT queue (counts from the log's newest sample), CAN, then WiFi
+  BOOT_DONE
+};
+
+static BootStage g_bootStage = BOOT_SAMPLE_LOG;
+
+void main_boot_tick(unsigned long now) {
+  uint32_t startUs = micros();
+  switch (g_bootStage) {
+    case BOOT_SAMPLE_LOG:
+      sample_log_init();
+      perf_boot_phase(PERF_BOOT_SAMPLE_LOG, startUs);
+      break;
+
+    case BOOT_ASSETS:
+      asset_store_init();
+      usb_logger_init(); // Stick detection and file writes run in the logger's own thread
+      perf_boot_phase(PERF_BOOT_ASSETS, startUs);
+      break;
+
+    case BOOT_NETWORK:
+#if CC_MQTT
+      // Before the network thread starts: queued samples count from here
+      mqtt_init(MQTT_HOST, MQTT_PORT, MQTT_CLIENT_ID, MQTT_USER, MQTT_PASS);
+#endif
+#if CC_CAN
+      can_link_init();
+#endif
+      // WiFi connects from wifi_tick(): nothing here waits for it
+      Serial.print(F("WiFi... "));
+#if CC_NETWORK_THREAD
+      g_networkThread.start(networkThreadMain);
+      Serial.println(F("connecting in network thread"));
+#else
+      g_wifiThread.start(wifiThreadMain);
+      Serial.println(F("connecting in WiFi thread"));
+#endif
+      perf_boot_phase(PERF_BOOT_NETWORK, startUs);
+      Serial.print(F("=== System Ready === ("));
+      Serial.print(now);
+      Serial.println(F(" ms after reset)"));
+      Serial.println();
+      break;
+
+    case BOOT_DONE:
+      return;
+  }
+  g_bootStage = (BootStage)(g_bootStage + 1);
+}
+
+unsigned long main_boot_next_ms(unsigned long now) {
+  return (g_bootStage < BOOT_DONE) ? now : now + Config::Scheduler::MAX_IDLE_MS;
+}
+
 /**
- * @brief Initialize all subsystems
+ * @brief Bring up control first, everything else from the boot task
  * 
  * Order of initialization:
- * 1. Serial communication for debugging
- * 2. Storage system and load persisted data
- * 3. Climate chamber controller
- * 4. WiFi connection
+ * 1. Serial (not waited for: boot messages before the monitor attaches are lost)
+ *    and the SDRAM (memory_regions.h)
+ * 2. Outputs in their safe state
+ * 3. Settings from the flash ring (last checkpointed setpoints, or defaults)
+ *    and the RTC wall clock (sample timestamps)
+ * 4. Sensor front ends and climate chamber controller
+ * 5. Task scheduler: control runs from the first loop() pass
+ * 
+ * The boot task then rebuilds the sample log, loads the assets and starts
+ * MQTT and WiFi, one stage per pass. Every phase is timed (/api/perf with
+ * -DCC_PERF=1), so a reset leaves the chamber uncontrolled only for the few
+ * milliseconds up to step 5.
  */
 void setup() {
-  // Initialize serial communication
+  // No wait for the USB monitor: a reset in the field has no one attached
   Serial.begin(Config::SERIAL_BAUD_RATE);
-  unsigned long serialStart = millis();
-  while (!Serial && (millis() - serialStart) < Config::SERIAL_TIMEOUT_MS) {
-    delay(10);
-  }
+  perf_init();
   Serial.println(F("=== Climatic Chamber Control System ==="));
   Serial.println(F("Initializing..."));
+
+  // SDRAM before anything touches EXT_DATA (settings fallback ring, history tiers)
+  bool sdramOk = memory_regions_init();
+
+  // Actuators off before anything else can fail or take time
+  uint32_t phaseUs = micros();
+  outputs_init();
+  perf_boot_phase(PERF_BOOT_OUTPUTS, phaseUs);
   
-  // Initialize storage and load persisted data
+  // Settings: 16-slot ring, found by binary search
   Serial.print(F("Storage... "));
+  phaseUs = micros();
   storage_init();
   storage_load();
+  perf_boot_phase(PERF_BOOT_SETTINGS, phaseUs);
   Serial.println(F("OK"));
+
+  wall_clock_init();
   
-  // Initialize climate chamber controller
+  // Initialize climate chamber controller (sensor front ends first, they feed the sensors)
   Serial.print(F("Controller... "));
+  phaseUs = micros();
+  temp_probes_init();
+  analog_inputs_init();
+  modbus_master_init();
+  chamber_clock_init();
   controller_init();
+  perf_boot_phase(PERF_BOOT_CONTROLLER, phaseUs);
   Serial.println(F("OK"));
+
+  Serial.println(sdramOk ? F("Memory:") : F("Memory: SDRAM FAILED"));
+  memory_regions_report();
+
+  // Micro-benchmarks (only with -DCC_BENCH=1)
+  bench_run();
   
   // Configure web server
   g_webConfig = {
@@ -64,27 +223,30 @@ void setup() {
     nullptr  // No increment callback needed
   };
   
-  // Initialize WiFi and connect
-  Serial.print(F("WiFi... "));
-  wifi_init(WIFI_SSID, WIFI_PASS);
-  Serial.println(F("OK"));
+  scheduler_init(TASKS, TASK_COUNT);
   
-  Serial.println(F("=== System Ready ==="));
-  Serial.println();
+  Serial.print(F("Control running after "));
+  Serial.print(millis());
+  Serial.println(F(" ms; sample log, assets and network follow in the background"));
 }
 
 /**
  * @brief Main control loop
  * 
- * Executes non-blocking tick functions for all subsystems:
- * - Climate control (sensor reading, actuator control)
- * - WiFi connection management
- * - Web server request handling
- * - Storage persistence
+ * One scheduler pass per call: every due task of TASKS (tasks.h) runs once, in
+ * priority order, with a shared timestamp:
+ * - Climate control (actions, heater, measurement, sampling)
+ * - Web server request handling (unless CC_NETWORK_THREAD moves it to the
+ *   network thread)
+ * - Storage persistence and sample log maintenance
+ *
+ * WiFi always runs in a thread below loop()'s priority, so loop() yields
+ * whenever nothing is due.
  */
 void loop() {
-  controller_tick();
-  wifi_tick();
-  web_server_handle(&g_webConfig);
-  storage_tick();
+  if (!scheduler_run_pass()) {
+    // Nothing due: give the time until the next deadline to the network/WiFi thread
+    long waitMs = (long)(scheduler_next_due_ms() - millis());
+    rtos::ThisThread::sleep_for(std::chrono::milliseconds(waitMs > 1 ? waitMs : 1));
+  }
 }
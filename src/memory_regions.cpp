@@ -0,0 +1,88 @@
+/*
+ * *****************************************************************************
+ * MEMORY REGIONS IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "memory_regions.h"
+#include <Arduino.h>
+#include <string.h>
+#if CC_MEMORY_PLACEMENT
+#include <SDRAM.h>
+#endif
+
+static constexpr size_t ARENA_BYTES = Config::Memory::ARENA_BYTES;
+
+// The arena itself: SDRAM with placement, internal .bss without
+alignas(Config::Memory::ARENA_ALIGN) EXT_DATA static uint8_t g_arena[ARENA_BYTES];
+static size_t g_arenaUsed = 0;
+static bool g_sdramReady = false;
+
+#if CC_MEMORY_PLACEMENT
+// Section bounds from scripts/memory_regions.ld
+extern "C" {
+extern uint8_t __dtcm_bss_start[];
+extern uint8_t __dtcm_bss_end[];
+extern uint8_t __itcm_text_start[];
+extern uint8_t __itcm_text_end[];
+extern uint8_t __itcm_text_load[];
+extern uint8_t __sdram_bss_start[];
+extern uint8_t __sdram_bss_end[];
+}
+
+// Before every other static constructor: FAST_DATA objects are constructed
+// into zeroed DTCM, FAST_CODE is in ITCM before anything can call it. Only
+// .dtcm_bss is cleared; it lies in the core's DTCMRAM, behind the relocated
+// vector table.
+__attribute__((constructor(101))) static void memoryRegionsEarlyInit() {
+  memset(__dtcm_bss_start, 0, (size_t)(__dtcm_bss_end - __dtcm_bss_start));
+  memcpy(__itcm_text_start, __itcm_text_load, (size_t)(__itcm_text_end - __itcm_text_start));
+  __DSB();
+  __ISB();
+}
+#endif
+
+bool memory_regions_init() {
+#if CC_MEMORY_PLACEMENT
+  // SDRAM above EXT_DATA goes to the SDRAM library's heap
+  uintptr_t heapStart = ((uintptr_t)__sdram_bss_end + 31u) & ~(uintptr_t)31u;
+  g_sdramReady = SDRAM.begin(heapStart) != 0;
+  if (g_sdramReady) {
+    memset(__sdram_bss_start, 0, (size_t)(__sdram_bss_end - __sdram_bss_start));
+  }
+#else
+  g_sdramReady = true; // EXT_DATA is ordinary .bss
+#endif
+  g_arenaUsed = 0;
+  return g_sdramReady;
+}
+
+void *memory_arena_alloc(size_t bytes, size_t align) {
+  if (!g_sdramReady || align == 0 || (align & (align - 1)) != 0) return nullptr;
+  size_t start = (g_arenaUsed + align - 1) & ~(align - 1);
+  if (start > ARENA_BYTES || bytes > ARENA_BYTES - start) return nullptr;
+  g_arenaUsed = start + bytes;
+  return g_arena + start;
+}
+
+size_t memory_arena_used() {
+  return g_arenaUsed;
+}
+
+static void printUsage(const char *name, size_t used, size_t capacity) {
+  Serial.print(name);
+  Serial.print(used);
+  Serial.print(F(" / "));
+  Serial.print(capacity);
+  Serial.println(F(" bytes"));
+}
+
+void memory_regions_report() {
+#if CC_MEMORY_PLACEMENT
+  printUsage("  DTCM:  ", (size_t)(__dtcm_bss_end - __dtcm_bss_start), Config::Memory::DTCM_BYTES);
+  printUsage("  ITCM:  ", (size_t)(__itcm_text_end - __itcm_text_start), Config::Memory::ITCM_BYTES);
+  printUsage("  SDRAM: ", (size_t)(__sdram_bss_end - __sdram_bss_start), Config::Memory::SDRAM_BYTES);
+  if (!g_sdramReady) Serial.println(F("  SDRAM did not start"));
+#endif
+  printUsage("  Arena: ", g_arenaUsed, ARENA_BYTES);
+}
@@ -0,0 +1,75 @@
+/*
+ * *****************************************************************************
+ * MEMORY REGIONS - DTCM, ITCM AND EXTERNAL SDRAM PLACEMENT
+ * *****************************************************************************
+ * Ordinary .bss/.text lives in AXI SRAM and flash behind the M7 caches. With
+ * CC_MEMORY_PLACEMENT=1 (scripts/memory_regions.py sets it together with the
+ * linker fragment scripts/memory_regions.ld):
+ * - FAST_DATA: zero-initialised data in DTCM (no wait states, never evicted).
+ *   Not reachable by the peripheral DMA: no DMA buffers here
+ * - FAST_CODE: functions copied from flash to ITCM at startup; calls to and
+ *   from flash go through linker veneers
+ * - EXT_DATA: zero-initialised data in the 8 MB SDRAM, usable only after
+ *   memory_regions_init(). Plain data only (no constructors)
+ * - memory_arena_alloc(): bump allocator over one EXT_DATA buffer for
+ *   objects built once at init time and never freed (history tiers)
+ *
+ * Without the flag the macros are empty, the arena is an ordinary .bss array
+ * (Config::Memory::ARENA_BYTES) and nothing else changes.
+ *
+ * DTCM is zeroed and ITCM filled by a constructor that runs before all other
+ * static constructors, so FAST_DATA objects may have constructors.
+ * memory_regions_report() prints the region usage at boot; the static budget
+ * of the linked image is printed by scripts/memory_regions.py after linking.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include "config.h"
+
+#if CC_MEMORY_PLACEMENT
+#define FAST_DATA __attribute__((section(".dtcm_bss")))
+#define FAST_CODE __attribute__((section(".itcm_text"), noinline))
+#define EXT_DATA __attribute__((section(".sdram_bss")))
+#else
+#define FAST_DATA
+#define FAST_CODE
+#define EXT_DATA
+#endif
+
+/**
+ * @brief Start the SDRAM and zero EXT_DATA; first call in setup()
+ *
+ * The SDRAM behind EXT_DATA and the arena is handed to SDRAM.malloc().
+ * Returns false if the SDRAM controller did not come up.
+ */
+bool memory_regions_init();
+
+/**
+ * @brief Reserve `bytes` from the arena (never freed)
+ *
+ * @return Aligned block, nullptr once the arena is exhausted
+ */
+void *memory_arena_alloc(size_t bytes, size_t align = Config::Memory::ARENA_ALIGN);
+
+/// Bytes handed out by memory_arena_alloc() so far
+size_t memory_arena_used();
+
+/**
+ * @brief Construct one T in the arena
+ */
+template<typename T, typename... Args>
+T *memory_arena_new(Args &&...args) {
+  void *block = memory_arena_alloc(sizeof(T), alignof(T));
+  return block ? new (block) T(std::forward<Args>(args)...) : nullptr;
+}
+
+/**
+ * @brief Print region and arena usage to Serial
+ */
+void memory_regions_report();
@@ -0,0 +1,339 @@
+/*
+ * *****************************************************************************
+ * MODBUS MASTER IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "modbus_master.h"
+#include "checksum.h"
+#include "config.h"
+#include "event_log.h"
+#include <Arduino_PortentaMachineControl.h>
+
+// One register value; holding (0x03) or input (0x04) registers, big-endian 16 bit
+struct ModbusPoint {
+  ModbusValue value;
+  uint8_t slave;
+  uint8_t function;
+  uint16_t reg;
+  float scale;     // Engineering units per count
+  bool isSigned;   // Two's complement register
+};
+
+/**
+ * Transmitters on the bus. Example layout: one combined CO2/RH/T transmitter
+ * per inner sensor position and a temperature transmitter outside the box.
+ * Points of one slave with registers close together end up in one request.
+ */
+static const ModbusPoint POINTS[] = {
+  // value               slave  fn     reg  scale  signed
+  {MODBUS_CO2,           1,     0x04,  0,   1.0f,  false},
+  {MODBUS_RH,            1,     0x04,  1,   0.1f,  false},
+  {MODBUS_TEMP,          1,     0x04,  2,   0.1f,  true},
+  {MODBUS_CO2_2,         2,     0x04,  0,   1.0f,  false},
+  {MODBUS_RH_2,          2,     0x04,  1,   0.1f,  false},
+  {MODBUS_TEMP_2,        2,     0x04,  2,   0.1f,  true},
+  {MODBUS_TEMP_OUTER,    3,     0x04,  0,   0.1f,  true},
+};
+
+static constexpr uint8_t POINT_COUNT = sizeof(POINTS) / sizeof(POINTS[0]);
+static constexpr uint8_t MAX_BLOCK_REGISTERS = 125;  // Spec limit for function 0x03/0x04
+static constexpr uint8_t QUEUE_SIZE = Config::Modbus::QUEUE_SIZE;
+
+// Contiguous register range of one slave, read with one request
+struct ModbusBlock {
+  uint8_t slave;
+  uint8_t function;
+  uint16_t start;
+  uint8_t count;
+  uint8_t firstPoint;  // Into g_pointOrder
+  uint8_t pointCount;
+  uint8_t slaveIndex;  // Into g_slaves
+  bool queued;
+};
+
+struct ModbusReading {
+  float value;
+  unsigned long timestampMs;
+  bool valid;
+};
+
+enum BusState : uint8_t {
+  BUS_OFF,
+  BUS_IDLE,
+  BUS_WAIT_REPLY
+};
+
+// Internal state
+static ModbusBlock g_blocks[POINT_COUNT];
+static uint8_t g_blockCount = 0;
+static uint8_t g_pointOrder[POINT_COUNT];     // POINTS indices sorted by slave, function, register
+static ModbusSlaveStats g_slaves[POINT_COUNT];
+static uint8_t g_slaveCount = 0;
+static ModbusReading g_readings[MODBUS_VALUE_COUNT];
+
+static uint8_t g_queue[QUEUE_SIZE];           // Block indices, FIFO
+static uint8_t g_queueHead = 0;
+static uint8_t g_queueCount = 0;
+
+static BusState g_state = BUS_OFF;
+static uint8_t g_current = 0;                 // Block being transferred
+static uint8_t g_attempt = 0;
+static unsigned long g_nextPollMs = 0;
+static unsigned long g_sentMs = 0;
+static uint32_t g_lastActivityUs = 0;         // End of the last frame on the bus
+static uint32_t g_t35Us = 0;                  // Inter-frame silence
+static uint8_t g_rx[5 + 2 * MAX_BLOCK_REGISTERS];
+static uint16_t g_rxLen = 0;
+
+// Sort key: slave, function, register
+static bool pointBefore(const ModbusPoint &a, const ModbusPoint &b) {
+  if (a.slave != b.slave) return a.slave < b.slave;
+  if (a.function != b.function) return a.function < b.function;
+  return a.reg < b.reg;
+}
+
+static uint8_t slaveIndex(uint8_t slave) {
+  for (uint8_t i = 0; i < g_slaveCount; i++) {
+    if (g_slaves[i].slave == slave) return i;
+  }
+  g_slaves[g_slaveCount] = ModbusSlaveStats();
+  g_slaves[g_slaveCount].slave = slave;
+  return g_slaveCount++;
+}
+
+// Merge sorted points into as few blocks as the register gap allows
+static void buildBlocks() {
+  for (uint8_t i = 0; i < POINT_COUNT; i++) {
+    uint8_t pos = i;
+    while (pos > 0 && pointBefore(POINTS[i], POINTS[g_pointOrder[pos - 1]])) {
+      g_pointOrder[pos] = g_pointOrder[pos - 1];
+      pos--;
+    }
+    g_pointOrder[pos] = i;
+  }
+
+  g_blockCount = 0;
+  g_slaveCount = 0;
+  for (uint8_t k = 0; k < POINT_COUNT; k++) {
+    const ModbusPoint &p = POINTS[g_pointOrder[k]];
+    if (g_blockCount > 0) {
+      ModbusBlock &last = g_blocks[g_blockCount - 1];
+      uint16_t end = last.start + last.count;  // First register after the block
+      if (last.slave == p.slave && last.function == p.function && p.reg < end + Config::Modbus::MAX_REGISTER_GAP + 1 &&
+          p.reg + 1 - last.start <= MAX_BLOCK_REGISTERS) {
+        if (p.reg >= end) last.count = p.reg + 1 - last.start;
+        last.pointCount++;
+        continue;
+      }
+    }
+    ModbusBlock &block = g_blocks[g_blockCount++];
+    block.slave = p.slave;
+    block.function = p.function;
+    block.start = p.reg;
+    block.count = 1;
+    block.firstPoint = k;
+    block.pointCount = 1;
+    block.slaveIndex = slaveIndex(p.slave);
+    block.queued = false;
+  }
+}
+
+static void enqueueAll() {
+  for (uint8_t b = 0; b < g_blockCount; b++) {
+    if (g_blocks[b].queued || g_queueCount >= QUEUE_SIZE) continue;  // Still pending from last interval
+    g_queue[(g_queueHead + g_queueCount) % QUEUE_SIZE] = b;
+    g_queueCount++;
+    g_blocks[b].queued = true;
+  }
+}
+
+static void sendRequest(unsigned long now) {
+  const ModbusBlock &block = g_blocks[g_current];
+  uint8_t frame[8] = {
+    block.slave, block.function,
+    (uint8_t)(block.start >> 8), (uint8_t)(block.start & 0xFF),
+    0, block.count,
+    0, 0
+  };
+  uint16_t crc = checksum_crc16_modbus(frame, 6);
+  frame[6] = crc & 0xFF;
+  frame[7] = crc >> 8;
+
+  MachineControl_RS485Comm.noReceive();
+  MachineControl_RS485Comm.beginTransmission();
+  MachineControl_RS485Comm.write(frame, sizeof(frame));
+  MachineControl_RS485Comm.endTransmission();
+  MachineControl_RS485Comm.receive();
+
+  g_slaves[block.slaveIndex].requests++;
+  g_rxLen = 0;
+  g_sentMs = now;
+  g_lastActivityUs = micros();
+  g_state = BUS_WAIT_REPLY;
+}
+
+// Done with the current block: pop it, successful or not
+static void finishBlock() {
+  g_blocks[g_current].queued = false;
+  g_queueHead = (g_queueHead + 1) % QUEUE_SIZE;
+  g_queueCount--;
+  g_attempt = 0;
+  g_lastActivityUs = micros();
+  g_state = BUS_IDLE;
+}
+
+static void retryOrFail() {
+  if (g_attempt < Config::Modbus::RETRIES) {
+    g_attempt++;
+    g_lastActivityUs = micros();
+    g_state = BUS_IDLE;  // Resent after the inter-frame gap
+    return;
+  }
+  ModbusSlaveStats &stats = g_slaves[g_blocks[g_current].slaveIndex];
+  stats.failures++;
+  event_log(EVT_MODBUS_TIMEOUT, stats.slave);
+  finishBlock();
+}
+
+static bool validCrc(const uint8_t *frame, uint16_t len) {
+  if (len < 4) return false;
+  uint16_t crc = checksum_crc16_modbus(frame, len - 2);
+  return frame[len - 2] == (crc & 0xFF) && frame[len - 1] == (crc >> 8);
+}
+
+static void publishBlock(unsigned long now) {
+  const ModbusBlock &block = g_blocks[g_current];
+  for (uint8_t k = 0; k < block.pointCount; k++) {
+    const ModbusPoint &p = POINTS[g_pointOrder[block.firstPoint + k]];
+    uint16_t offset = 3 + 2 * (p.reg - block.start);
+    uint16_t raw = ((uint16_t)g_rx[offset] << 8) | g_rx[offset + 1];
+    float counts = p.isSigned ? (float)(int16_t)raw : (float)raw;
+    ModbusReading &reading = g_readings[p.value];
+    reading.value = counts * p.scale;
+    reading.timestampMs = now;
+    reading.valid = true;
+  }
+}
+
+// Evaluate the bytes received so far: publish, retry or keep waiting
+static void checkReply(unsigned long now) {
+  const ModbusBlock &block = g_blocks[g_current];
+  ModbusSlaveStats &stats = g_slaves[block.slaveIndex];
+  uint16_t expected = 5 + 2 * block.count;
+  bool silent = g_rxLen > 0 && (uint32_t)(micros() - g_lastActivityUs) >= g_t35Us;
+
+  if (g_rxLen >= 5 && (g_rx[1] & 0x80)) {
+    // Exception reply; deterministic, so no retry
+    if (!validCrc(g_rx, 5)) {
+      stats.crcErrors++;
+      retryOrFail();
+      return;
+    }
+    stats.exceptions++;
+    event_log(EVT_MODBUS_EXCEPTION, block.slave, g_rx[2]);
+    finishBlock();
+    return;
+  }
+
+  if (g_rxLen >= expected) {
+    if (validCrc(g_rx, expected) && g_rx[0] == block.slave && g_rx[1] == block.function &&
+        g_rx[2] == 2 * block.count) {
+      publishBlock(now);
+      finishBlock();
+    } else {
+      stats.crcErrors++;
+      retryOrFail();
+    }
+    return;
+  }
+
+  if (silent) {
+    // Frame ended early
+    stats.crcErrors++;
+    retryOrFail();
+  } else if (now - g_sentMs >= Config::Modbus::RESPONSE_TIMEOUT_MS) {
+    stats.timeouts++;
+    retryOrFail();
+  }
+}
+
+void modbus_master_init() {
+  for (uint8_t v = 0; v < MODBUS_VALUE_COUNT; v++) {
+    g_readings[v] = {0.0f, 0, false};
+  }
+  g_queueHead = 0;
+  g_queueCount = 0;
+  g_state = BUS_OFF;
+  buildBlocks();
+  if (!Config::Modbus::ENABLED || Config::SIMULATE_SENSORS) {
+    return;
+  }
+
+  // 11 bit times per character; fixed gaps above 19200 baud
+  uint32_t charUs = (uint32_t)(11000000UL / Config::Modbus::BAUD_RATE);
+  g_t35Us = (Config::Modbus::BAUD_RATE > 19200) ? 1750 : (charUs * 7) / 2;
+
+  MachineControl_RS485Comm.begin(Config::Modbus::BAUD_RATE, SERIAL_8N1);
+  MachineControl_RS485Comm.receive();
+  g_lastActivityUs = micros();
+  g_nextPollMs = millis();
+  g_state = BUS_IDLE;
+
+  Serial.print("Modbus: ");
+  Serial.print(POINT_COUNT);
+  Serial.print(" points in ");
+  Serial.print(g_blockCount);
+  Serial.print(" requests, ");
+  Serial.print(g_slaveCount);
+  Serial.println(" slaves");
+}
+
+void modbus_master_tick(unsigned long now) {
+  if (g_state == BUS_OFF) return;
+
+  if ((long)(now - g_nextPollMs) >= 0) {
+    enqueueAll();
+    g_nextPollMs = now + Config::Modbus::POLL_INTERVAL_MS;
+  }
+
+  switch (g_state) {
+    case BUS_IDLE:
+      // Drop stray bytes, then wait for t3.5 of silence before the next request
+      while (MachineControl_RS485Comm.available()) {
+        MachineControl_RS485Comm.read();
+        g_lastActivityUs = micros();
+      }
+      if (g_queueCount == 0) break;
+      if ((uint32_t)(micros() - g_lastActivityUs) < g_t35Us) break;
+      g_current = g_queue[g_queueHead];
+      sendRequest(now);
+      break;
+
+    case BUS_WAIT_REPLY:
+      while (MachineControl_RS485Comm.available() && g_rxLen < sizeof(g_rx)) {
+        g_rx[g_rxLen++] = (uint8_t)MachineControl_RS485Comm.read();
+        g_lastActivityUs = micros();
+      }
+      checkReply(now);
+      break;
+
+    case BUS_OFF:
+      break;
+  }
+}
+
+bool modbus_master_read(ModbusValue value, float *out) {
+  if (value >= MODBUS_VALUE_COUNT || !g_readings[value].valid) return false;
+  if (millis() - g_readings[value].timestampMs > Config::Modbus::MAX_AGE_MS) return false;
+  *out = g_readings[value].value;
+  return true;
+}
+
+uint8_t modbus_master_block_count() {
+  return g_blockCount;
+}
+
+const ModbusSlaveStats *modbus_master_slave_stats(uint8_t index) {
+  return (index < g_slaveCount) ? &g_slaves[index] : nullptr;
+}
@@ -0,0 +1,86 @@
+/*
+ * *****************************************************************************
+ * MODBUS MASTER - NON-BLOCKING MODBUS-RTU OVER RS485
+ * *****************************************************************************
+ * Polls the CO2/RH/temperature transmitters on the Machine Control RS485 port:
+ * - A static point table (slave, function, register, scale) names the value
+ *   behind each register; init merges neighbouring points of one slave into
+ *   multi-register blocks, so all points take as few requests as possible
+ * - Every Config::Modbus::POLL_INTERVAL_MS all blocks are put into a request
+ *   queue; the tick sends one at a time and never waits for the reply:
+ *   IDLE -> (t3.5 silence) -> send -> WAIT_REPLY (bytes collected per tick)
+ *   -> CRC check -> values published -> IDLE
+ * - Inter-frame timing follows the baud rate (3.5 / 1.5 characters, fixed
+ *   1750 / 750 us above 19200 baud as the spec demands)
+ * - A missing, short or corrupt reply is retried Config::Modbus::RETRIES
+ *   times, then the block is skipped until the next interval; errors are
+ *   counted per slave
+ *
+ * Values are consumed by readSensors3() like the other front ends. Only the
+ * transmit path blocks, for the few ms the UART needs to shift a request out.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @brief Sensor value that can come from a transmitter
+ */
+enum ModbusValue : uint8_t {
+  MODBUS_CO2 = 0,
+  MODBUS_CO2_2,
+  MODBUS_RH,
+  MODBUS_RH_2,
+  MODBUS_TEMP,
+  MODBUS_TEMP_2,
+  MODBUS_TEMP_OUTER,
+  MODBUS_VALUE_COUNT
+};
+
+/**
+ * @brief Bus counters per slave
+ */
+struct ModbusSlaveStats {
+  uint8_t slave;      ///< Slave address
+  uint32_t requests;  ///< Requests sent (retries included)
+  uint32_t timeouts;  ///< No complete reply within Config::Modbus::RESPONSE_TIMEOUT_MS
+  uint32_t crcErrors; ///< Reply with wrong CRC or unexpected header
+  uint32_t exceptions;///< Modbus exception replies
+  uint32_t failures;  ///< Blocks given up after all retries
+};
+
+/**
+ * @brief Build the request blocks and open the RS485 port
+ */
+void modbus_master_init();
+
+/**
+ * @brief Advance the bus state machine (scheduler task)
+ *
+ * @param now millis() of the current scheduler pass
+ */
+void modbus_master_tick(unsigned long now);
+
+/**
+ * @brief Newest value of one point
+ *
+ * @param value ModbusValue
+ * @param out Output, only written if a fresh value exists
+ * @return false if there is no value newer than Config::Modbus::MAX_AGE_MS
+ */
+bool modbus_master_read(ModbusValue value, float *out);
+
+/**
+ * @brief Number of request blocks built from the point table
+ */
+uint8_t modbus_master_block_count();
+
+/**
+ * @brief Counters of the index-th slave on the bus
+ *
+ * @return nullptr if index is out of range
+ */
+const ModbusSlaveStats *modbus_master_slave_stats(uint8_t index);
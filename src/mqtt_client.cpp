@@ -0,0 +1,504 @@
+/*
+ * *****************************************************************************
+ * MQTT CLIENT IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "mqtt_client.h"
+#include "config.h"
+
+#if CC_MQTT
+
+#include <WiFi.h>
+#include "alarms.h"
+#include "controller.h"
+#include "event_log.h"
+#include "sample_log.h"
+#include "telemetry_format.h"
+#include "wifi_manager.h"
+
+static constexpr uint8_t QOS = Config::Mqtt::QOS;
+static constexpr uint8_t MAX_BATCH = Config::Mqtt::MAX_BATCH_SAMPLES;
+static constexpr unsigned long PING_AFTER_MS = Config::Mqtt::KEEPALIVE_S * 500UL;
+static constexpr unsigned long SILENCE_LIMIT_MS = Config::Mqtt::KEEPALIVE_S * 1500UL;
+
+static_assert(QOS <= 1, "Config::Mqtt::QOS must be 0 or 1");
+
+static constexpr size_t TOPIC_SIZE = 64;
+static constexpr size_t TX_BUFFER_SIZE = 5 + 2 + TOPIC_SIZE + 2 + sizeof(Telemetry::BatchHeader) +
+                                         MAX_BATCH * sizeof(SampleRecord);
+static constexpr size_t READ_CHUNK = 32;
+static_assert(5 + 2 + TOPIC_SIZE + ALARM_EDGE_JSON_MAX <= TX_BUFFER_SIZE, "An alarm edge must fit the TX buffer");
+
+// Fixed header: packet type (upper nibble) and flags
+static constexpr uint8_t MQTT_CONNECT = 0x10;
+static constexpr uint8_t MQTT_CONNACK = 0x20;
+static constexpr uint8_t MQTT_PUBLISH = 0x30;
+static constexpr uint8_t MQTT_PUBACK = 0x40;
+static constexpr uint8_t MQTT_PINGREQ = 0xC0;
+static constexpr uint8_t PUBLISH_RETAIN = 0x01;
+
+// CONNECT flags
+static constexpr uint8_t CONNECT_USERNAME = 0x80;
+static constexpr uint8_t CONNECT_PASSWORD = 0x40;
+static constexpr uint8_t CONNECT_WILL_RETAIN = 0x20;
+static constexpr uint8_t CONNECT_WILL = 0x04;
+static constexpr uint8_t CONNECT_CLEAN_SESSION = 0x02;
+
+static const char STATUS_ONLINE[] = "online";
+static const char STATUS_OFFLINE[] = "offline";
+
+enum MqttState : uint8_t {
+  MQTT_DISCONNECTED,
+  MQTT_WAIT_CONNACK,
+  MQTT_CONNECTED
+};
+
+enum RxStage : uint8_t {
+  RX_TYPE,
+  RX_LENGTH,
+  RX_BODY
+};
+
+// Broker
+static const char *g_host = nullptr;   // nullptr = not configured
+static uint16_t g_port = 0;
+static const char *g_clientId = "";
+static const char *g_user = "";
+static const char *g_pass = "";
+static char g_sampleTopic[TOPIC_SIZE];
+static char g_statusTopic[TOPIC_SIZE];
+static char g_alarmTopic[TOPIC_SIZE];
+
+// Connection
+static WiFiClient g_client;
+static MqttState g_state = MQTT_DISCONNECTED;
+static unsigned long g_stateMs = 0;
+static unsigned long g_retryAtMs = 0;
+static unsigned long g_retryDelayMs = Config::Mqtt::RETRY_MIN_MS;
+static unsigned long g_lastTxMs = 0;
+static unsigned long g_lastRxMs = 0;
+static bool g_pingPending = false;     // PINGREQ sent, nothing received since
+
+// Queue positions (sample numbers): (acked, sent] is in flight, (sent, newest] waits
+static uint32_t g_ackedSeq = 0;
+static uint32_t g_sentSeq = 0;
+static uint16_t g_inflightId = 0;      // Packet awaiting its PUBACK (0 = none)
+static unsigned long g_inflightMs = 0;
+static uint16_t g_nextPacketId = 1;
+static bool g_dropLogged = false;
+static uint32_t g_alarmSeq = 0;        // Newest alarm edge published
+
+// Outgoing packet, written across ticks
+static uint8_t g_tx[TX_BUFFER_SIZE];
+static uint16_t g_txLen = 0;
+static uint16_t g_txSent = 0;
+static bool g_txBatch = false;         // QoS 0 batch: delivered once written
+
+// Incoming packet
+static RxStage g_rxStage = RX_TYPE;
+static uint8_t g_rxType = 0;
+static uint32_t g_rxRemaining = 0;
+static uint8_t g_rxShift = 0;
+static uint8_t g_rxBody[2];            // CONNACK and PUBACK carry two bytes
+static uint8_t g_rxBodyLen = 0;
+
+static MqttStatus g_status = {};
+
+// --- Sample source: flash log, else the controller's RAM ring ---
+
+static uint32_t newestSeq() {
+  return sample_log_available() ? sample_log_newest_seq() : controller_get_sample_seq(0);
+}
+
+static uint32_t oldestSeq() {
+  if (sample_log_available()) return sample_log_oldest_seq();
+  uint32_t newest = controller_get_sample_seq(0);
+  uint16_t length = controller_history_length();
+  if (newest == 0) return 0;
+  return (newest > length) ? newest - length + 1 : 1;
+}
+
+static bool readSample(uint32_t seq, SampleRecord *out) {
+  if (sample_log_available()) return sample_log_read(seq, out);
+  int16_t frame[SERIES_COUNT];
+  controller_history_frame(0, seq, frame);
+  sample_log_encode(frame, controller_history_actuators(0, seq), out);
+  return true;
+}
+
+// Keep at most OFFLINE_MAX_SAMPLES, and nothing the source no longer holds
+static void trimBacklog(uint32_t newest) {
+  uint32_t oldest = oldestSeq();
+  if (newest >= Config::Mqtt::OFFLINE_MAX_SAMPLES) {
+    uint32_t floor = newest - Config::Mqtt::OFFLINE_MAX_SAMPLES + 1;
+    if (floor > oldest) oldest = floor;
+  }
+  if (oldest == 0 || g_ackedSeq + 1 >= oldest) return;
+
+  uint32_t dropped = oldest - 1 - g_ackedSeq;
+  g_ackedSeq = oldest - 1;
+  if (g_sentSeq < g_ackedSeq) g_sentSeq = g_ackedSeq;
+  g_status.dropped += dropped;
+  if (!g_dropLogged) {
+    event_log(EVT_MQTT_BACKLOG_DROPPED, dropped); // Once per outage
+    g_dropLogged = true;
+  }
+}
+
+// --- Packet encoding ---
+
+static size_t putLength(uint8_t *out, uint32_t length) {
+  size_t n = 0;
+  do {
+    uint8_t digit = length & 0x7F;
+    length >>= 7;
+    out[n++] = digit | (length > 0 ? 0x80 : 0);
+  } while (length > 0);
+  return n;
+}
+
+static size_t putString(uint8_t *out, const char *text, size_t len) {
+  out[0] = (uint8_t)(len >> 8);
+  out[1] = (uint8_t)len;
+  memcpy(out + 2, text, len);
+  return 2 + len;
+}
+
+static size_t connectSize() {
+  size_t remaining = 10 + 2 + strlen(g_clientId) + 2 + strlen(g_statusTopic) + 2 + strlen(STATUS_OFFLINE);
+  if (g_user[0] != '\0') remaining += 2 + strlen(g_user) + 2 + strlen(g_pass);
+  return 5 + remaining;
+}
+
+static void queueConnect() {
+  static const uint8_t PROTOCOL[] = {0, 4, 'M', 'Q', 'T', 'T', 4};
+  uint8_t flags = CONNECT_CLEAN_SESSION | CONNECT_WILL | CONNECT_WILL_RETAIN;
+  if (g_user[0] != '\0') flags |= CONNECT_USERNAME | CONNECT_PASSWORD;
+
+  uint8_t *p = g_tx;
+  *p++ = MQTT_CONNECT;
+  p += putLength(p, connectSize() - 5);
+  memcpy(p, PROTOCOL, sizeof(PROTOCOL));
+  p += sizeof(PROTOCOL);
+  *p++ = flags;
+  *p++ = (uint8_t)(Config::Mqtt::KEEPALIVE_S >> 8);
+  *p++ = (uint8_t)Config::Mqtt::KEEPALIVE_S;
+  p += putString(p, g_clientId, strlen(g_clientId));
+  p += putString(p, g_statusTopic, strlen(g_statusTopic));
+  p += putString(p, STATUS_OFFLINE, strlen(STATUS_OFFLINE));
+  if (g_user[0] != '\0') {
+    p += putString(p, g_user, strlen(g_user));
+    p += putString(p, g_pass, strlen(g_pass));
+  }
+  g_txLen = p - g_tx;
+  g_txSent = 0;
+}
+
+static void queueStatus(const char *text) {
+  size_t topicLen = strlen(g_statusTopic);
+  size_t textLen = strlen(text);
+  uint8_t *p = g_tx;
+  *p++ = MQTT_PUBLISH | PUBLISH_RETAIN;
+  p += putLength(p, 2 + topicLen + textLen);
+  p += putString(p, g_statusTopic, topicLen);
+  memcpy(p, text, textLen);
+  g_txLen = p + textLen - g_tx;
+  g_txSent = 0;
+}
+
+// Next alarm edge as JSON, QoS 0 (a disconnect meanwhile loses it; the
+// edges still in the ring are published after the reconnect)
+static void queueAlarm() {
+  uint32_t oldest = alarms_oldest_seq();
+  if (g_alarmSeq + 1 < oldest) g_alarmSeq = oldest - 1;
+  AlarmEdge edge;
+  if (!alarms_edge(++g_alarmSeq, &edge)) return;
+  char json[ALARM_EDGE_JSON_MAX];
+  size_t jsonLen = alarms_edge_json(json, edge);
+  size_t topicLen = strlen(g_alarmTopic);
+  uint8_t *p = g_tx;
+  *p++ = MQTT_PUBLISH;
+  p += putLength(p, 2 + topicLen + jsonLen);
+  p += putString(p, g_alarmTopic, topicLen);
+  memcpy(p, json, jsonLen);
+  g_txLen = p + jsonLen - g_tx;
+  g_txSent = 0;
+}
+
+static void queuePing() {
+  g_pingPending = true;
+  g_tx[0] = MQTT_PINGREQ;
+  g_tx[1] = 0;
+  g_txLen = 2;
+  g_txSent = 0;
+}
+
+// Everything after the last sent sample, up to MAX_BATCH samples
+static void queueBatch(uint32_t newest, unsigned long now) {
+  uint32_t first = g_sentSeq + 1;
+  uint16_t count = (newest - g_sentSeq > MAX_BATCH) ? MAX_BATCH : (uint16_t)(newest - g_sentSeq);
+  size_t topicLen = strlen(g_sampleTopic);
+  size_t payloadLen = sizeof(Telemetry::BatchHeader) + count * sizeof(SampleRecord);
+
+  uint8_t *p = g_tx;
+  *p++ = MQTT_PUBLISH | (QOS << 1);
+  p += putLength(p, 2 + topicLen + (QOS > 0 ? 2 : 0) + payloadLen);
+  p += putString(p, g_sampleTopic, topicLen);
+  if (QOS > 0) {
+    g_inflightId = g_nextPacketId;
+    g_nextPacketId = (g_nextPacketId == 0xFFFF) ? 1 : g_nextPacketId + 1;
+    g_inflightMs = now;
+    *p++ = (uint8_t)(g_inflightId >> 8);
+    *p++ = (uint8_t)g_inflightId;
+  }
+
+  Telemetry::BatchHeader header;
+  header.magic[0] = Telemetry::MAGIC_0;
+  header.magic[1] = Telemetry::BATCH_MAGIC_1;
+  header.version = Telemetry::BATCH_FORMAT_VERSION;
+  header.flags = sample_log_available() ? 0 : Telemetry::BATCH_FLAG_BOOT_SEQ;
+  header.first_seq = first;
+  header.count = count;
+  header.sample_interval_ms = (uint16_t)controller_get_sample_interval_ms();
+  memcpy(p, &header, sizeof(header));
+  p += sizeof(header);
+
+  for (uint16_t i = 0; i < count; i++) {
+    SampleRecord record;
+    if (!readSample(first + i, &record)) memset(&record, 0xFF, sizeof(record)); // CRC fails
+    memcpy(p, &record, sizeof(record));
+    p += sizeof(record);
+  }
+
+  g_txLen = p - g_tx;
+  g_txSent = 0;
+  g_txBatch = (QOS == 0);
+  g_sentSeq = first + count - 1;
+  g_status.publishes++;
+}
+
+// Write what the socket takes. Returns true once nothing is pending.
+static bool flushTx(unsigned long now) {
+  if (g_txSent < g_txLen) {
+    size_t written = g_client.write(g_tx + g_txSent, g_txLen - g_txSent);
+    if (written > 0) {
+      g_txSent += written;
+      g_lastTxMs = now;
+    }
+    if (g_txSent < g_txLen) return false;
+  }
+  if (g_txBatch) {
+    g_status.samples += g_sentSeq - g_ackedSeq;
+    g_ackedSeq = g_sentSeq;
+    g_txBatch = false;
+  }
+  g_txLen = 0;
+  g_txSent = 0;
+  return true;
+}
+
+// --- Connection ---
+
+// Close the socket; unacknowledged samples are sent again after the
+// reconnect. Returns the backoff in seconds.
+static int32_t disconnect(unsigned long now) {
+  g_client.stop();
+  g_state = MQTT_DISCONNECTED;
+  g_txLen = 0;
+  g_txSent = 0;
+  g_txBatch = false;
+  g_inflightId = 0;
+  g_sentSeq = g_ackedSeq;
+  g_rxStage = RX_TYPE;
+  g_pingPending = false;
+
+  unsigned long delayMs = g_retryDelayMs;
+  g_retryAtMs = now + delayMs;
+  g_retryDelayMs = (delayMs * 2 < Config::Mqtt::RETRY_MAX_MS) ? delayMs * 2 : Config::Mqtt::RETRY_MAX_MS;
+  return (int32_t)(delayMs / 1000);
+}
+
+static void connectBroker() {
+  if (!g_client.connect(g_host, g_port)) {
+    event_log(EVT_MQTT_CONNECT_FAILED, disconnect(millis()));
+    return;
+  }
+  unsigned long now = millis(); // The connect may have taken a while
+  g_state = MQTT_WAIT_CONNACK;
+  g_stateMs = now;
+  g_lastRxMs = now;
+  g_rxStage = RX_TYPE;
+  queueConnect();
+  flushTx(now);
+}
+
+static void onConnack(unsigned long now) {
+  uint8_t code = (g_rxBodyLen == 2) ? g_rxBody[1] : 0xFF;
+  if (code != 0) {
+    event_log(EVT_MQTT_REFUSED, code, disconnect(now));
+    return;
+  }
+  g_state = MQTT_CONNECTED;
+  g_stateMs = now;
+  g_retryDelayMs = Config::Mqtt::RETRY_MIN_MS;
+  g_dropLogged = false;
+  g_status.connects++;
+  event_log(EVT_MQTT_CONNECTED, newestSeq() - g_ackedSeq);
+  queueStatus(STATUS_ONLINE);
+}
+
+static void onPuback() {
+  uint16_t id = (g_rxBodyLen == 2) ? (uint16_t)((g_rxBody[0] << 8) | g_rxBody[1]) : 0;
+  if (id == 0 || id != g_inflightId) return;
+  g_inflightId = 0;
+  if (g_sentSeq > g_ackedSeq) {
+    g_status.samples += g_sentSeq - g_ackedSeq;
+    g_ackedSeq = g_sentSeq;
+  }
+}
+
+static void onPacket(unsigned long now) {
+  g_rxStage = RX_TYPE;
+  if (g_rxType == MQTT_CONNACK && g_state == MQTT_WAIT_CONNACK) {
+    onConnack(now);
+  } else if (g_rxType == MQTT_PUBACK && g_state == MQTT_CONNECTED) {
+    onPuback();
+  }
+  // PINGRESP only refreshes g_lastRxMs; nothing is subscribed
+}
+
+// Returns false on a malformed length (connection dropped)
+static bool rxByte(uint8_t b, unsigned long now) {
+  switch (g_rxStage) {
+    case RX_TYPE:
+      g_rxType = b & 0xF0;
+      g_rxRemaining = 0;
+      g_rxShift = 0;
+      g_rxBodyLen = 0;
+      g_rxStage = RX_LENGTH;
+      return true;
+
+    case RX_LENGTH:
+      g_rxRemaining |= (uint32_t)(b & 0x7F) << g_rxShift;
+      g_rxShift += 7;
+      if (b & 0x80) {
+        if (g_rxShift > 21) {
+          event_log(EVT_MQTT_LOST, disconnect(now));
+          return false;
+        }
+        return true;
+      }
+      g_rxStage = RX_BODY;
+      if (g_rxRemaining == 0) onPacket(now);
+      return true;
+
+    case RX_BODY:
+      if (g_rxBodyLen < sizeof(g_rxBody)) g_rxBody[g_rxBodyLen++] = b;
+      if (--g_rxRemaining == 0) onPacket(now);
+      return true;
+  }
+  return true;
+}
+
+static void readPackets(unsigned long now) {
+  uint8_t buffer[READ_CHUNK];
+  while (g_state != MQTT_DISCONNECTED) {
+    int available = g_client.available();
+    if (available <= 0) return;
+    size_t n = ((size_t)available < sizeof(buffer)) ? (size_t)available : sizeof(buffer);
+    int got = g_client.read(buffer, n);
+    if (got <= 0) return;
+    g_lastRxMs = now;
+    g_pingPending = false;
+    for (int i = 0; i < got; i++) {
+      if (!rxByte(buffer[i], now)) return;
+    }
+  }
+}
+
+// --- Public API ---
+
+void mqtt_init(const char *host, uint16_t port, const char *clientId, const char *user, const char *pass) {
+  g_host = nullptr;
+  if (host == nullptr || host[0] == '\0' || clientId == nullptr || clientId[0] == '\0') return;
+  g_clientId = clientId;
+  g_user = (user != nullptr) ? user : "";
+  g_pass = (pass != nullptr) ? pass : "";
+
+  int sampleLen = snprintf(g_sampleTopic, sizeof(g_sampleTopic), "%s%s/samples", Config::Mqtt::TOPIC_PREFIX, clientId);
+  int statusLen = snprintf(g_statusTopic, sizeof(g_statusTopic), "%s%s/status", Config::Mqtt::TOPIC_PREFIX, clientId);
+  int alarmLen = snprintf(g_alarmTopic, sizeof(g_alarmTopic), "%s%s/alarms", Config::Mqtt::TOPIC_PREFIX, clientId);
+  if (sampleLen <= 0 || (size_t)sampleLen >= sizeof(g_sampleTopic) || statusLen <= 0 ||
+      (size_t)statusLen >= sizeof(g_statusTopic) || alarmLen <= 0 || (size_t)alarmLen >= sizeof(g_alarmTopic) ||
+      connectSize() > sizeof(g_tx)) {
+    Serial.println("MQTT: client id or credentials too long; MQTT disabled");
+    return;
+  }
+
+  g_host = host;
+  g_port = port;
+  g_ackedSeq = newestSeq(); // Queue starts now, older log entries are not replayed
+  g_sentSeq = g_ackedSeq;
+  g_alarmSeq = alarms_newest_seq();
+  g_retryAtMs = millis();
+  Serial.print("MQTT: publishing to ");
+  Serial.print(host);
+  Serial.print(":");
+  Serial.print(port);
+  Serial.print(" as ");
+  Serial.println(g_sampleTopic);
+}
+
+void mqtt_tick(unsigned long now) {
+  if (g_host == nullptr) return;
+  uint32_t newest = newestSeq();
+  trimBacklog(newest);
+
+  if (g_state == MQTT_DISCONNECTED) {
+    if ((long)(now - g_retryAtMs) < 0 || !wifi_connected()) return;
+    connectBroker();
+    return;
+  }
+  if (!g_client.connected()) {
+    event_log(EVT_MQTT_LOST, disconnect(now));
+    return;
+  }
+
+  readPackets(now);
+  if (g_state == MQTT_DISCONNECTED) return;
+  if (!flushTx(now)) return;
+
+  if (g_state == MQTT_WAIT_CONNACK) {
+    if (now - g_stateMs > Config::Mqtt::CONNACK_TIMEOUT_MS) event_log(EVT_MQTT_TIMEOUT, disconnect(now));
+    return;
+  }
+  if (now - g_lastRxMs > SILENCE_LIMIT_MS ||
+      (g_inflightId != 0 && now - g_inflightMs > Config::Mqtt::ACK_TIMEOUT_MS)) {
+    event_log(EVT_MQTT_TIMEOUT, disconnect(now));
+    return;
+  }
+
+  // Liveness is judged by what the broker sends: with QoS 0 publishes
+  // nothing comes back, so a quiet receive side asks for a PINGRESP even
+  // while samples keep going out
+  if (!g_pingPending && now - g_lastRxMs >= PING_AFTER_MS) {
+    queuePing();
+  } else if (alarms_newest_seq() != g_alarmSeq) {
+    queueAlarm(); // Ahead of the samples, also while a batch awaits its PUBACK
+  } else if (g_inflightId == 0 && newest > g_sentSeq) {
+    queueBatch(newest, now);
+  } else if (now - g_lastTxMs >= PING_AFTER_MS) {
+    queuePing(); // Keep-alive towards the broker
+  }
+  flushTx(now);
+}
+
+void mqtt_status(MqttStatus *out) {
+  *out = g_status;
+  out->connected = (g_state == MQTT_CONNECTED);
+  uint32_t newest = newestSeq();
+  out->backlog = (g_host != nullptr && newest > g_ackedSeq) ? newest - g_ackedSeq : 0;
+}
+
+#endif // CC_MQTT
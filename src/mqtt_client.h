@@ -0,0 +1,64 @@
+/*
+ * *****************************************************************************
+ * MQTT CLIENT - SAMPLE TELEMETRY TO A BROKER
+ * *****************************************************************************
+ * Minimal MQTT 3.1.1 publisher on the network side (CC_MQTT=1):
+ * - Every new sample goes out as a compact binary batch (Telemetry::
+ *   BatchHeader + 16-byte SampleRecords, telemetry_format.h) on
+ *   <prefix><client id>/samples; "online"/"offline" (last will) are
+ *   retained on <prefix><client id>/status, alarm edges (alarms.h) go
+ *   out as JSON with QoS 0 on <prefix><client id>/alarms
+ * - QoS 1: one batch in flight, the next one leaves after its PUBACK and
+ *   takes everything that arrived meanwhile (up to MAX_BATCH_SAMPLES), so
+ *   a slow broker gets fewer, larger publishes
+ * - Offline queue: the flash sample log (sample_log.h). Only the number of
+ *   the last acknowledged sample is kept; after a reconnect the backlog is
+ *   read back from flash and drained batch by batch. Without the flash log
+ *   the controller's RAM ring (Config::SENSOR_RING_BUFFER_SIZE samples) is
+ *   the queue. At most Config::Mqtt::OFFLINE_MAX_SAMPLES are kept.
+ * - Delivery is at least once: a batch cut off by a disconnect is sent
+ *   again, receivers deduplicate by sample number
+ *
+ * mqtt_tick() never waits on the socket: partial writes resume on the next
+ * call, reads take what is there. The TCP connect itself blocks inside the
+ * mbed socket layer, which is why MQTT needs CC_NETWORK_THREAD=1: it then
+ * only ever delays the network thread.
+ *
+ * Network side only (same thread as web_server_handle()).
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @brief Publisher counters
+ */
+struct MqttStatus {
+  bool connected;        ///< CONNACK received, publishing
+  uint32_t backlog;      ///< Samples not yet acknowledged by the broker
+  uint32_t publishes;    ///< Sample batches sent
+  uint32_t samples;      ///< Samples acknowledged (QoS 1) or sent (QoS 0)
+  uint32_t connects;     ///< Successful broker connections
+  uint32_t dropped;      ///< Samples lost to the offline queue limit
+};
+
+/**
+ * @brief Set the broker (call once in setup, after sample_log_init)
+ *
+ * Samples from here on are queued until the first connection. The strings
+ * must stay valid (credentials.h constants). Empty user = no login.
+ */
+void mqtt_init(const char *host, uint16_t port, const char *clientId, const char *user, const char *pass);
+
+/**
+ * @brief Advance the connection and publish pending samples (network side, every pass)
+ */
+void mqtt_tick(unsigned long now);
+
+/**
+ * @brief Copy the publisher counters
+ */
+void mqtt_status(MqttStatus *out);
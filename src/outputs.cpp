@@ -0,0 +1,80 @@
+/*
+ * *****************************************************************************
+ * OUTPUTS IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "outputs.h"
+#include "config.h"
+#include <Arduino_PortentaMachineControl.h>
+
+// Internal state
+static uint8_t g_shadow = 0;      // Requested output states
+static uint8_t g_committed = 0;   // Last mask written to the hardware
+static uint32_t g_commits = 0;
+static uint32_t g_inputs = 0;
+static unsigned long g_lastInputReadMs = 0;
+static volatile bool g_inputChanged = false;
+
+static void onInputInterrupt() {
+  g_inputChanged = true;
+}
+
+static void readInputs(unsigned long now) {
+  g_inputChanged = false;  // Reading the ports also clears the expander's INT
+  g_inputs = MachineControl_DigitalInputs.readAll();
+  g_lastInputReadMs = now;
+}
+
+void outputs_init() {
+  MachineControl_DigitalOutputs.begin(Config::Outputs::LATCH_MODE);
+  g_shadow = 0;
+  g_committed = 0;
+  g_commits = 0;
+  MachineControl_DigitalOutputs.writeAll(0);
+
+  if (Config::Outputs::DIGITAL_INPUTS) {
+    MachineControl_DigitalInputs.begin();
+    if (Config::Outputs::INPUT_INT_PIN >= 0) {
+      pinMode(Config::Outputs::INPUT_INT_PIN, INPUT_PULLUP);
+      attachInterrupt(digitalPinToInterrupt(Config::Outputs::INPUT_INT_PIN), onInputInterrupt, FALLING);
+    }
+    readInputs(millis());
+  }
+}
+
+void outputs_set(uint8_t channel, bool on) {
+  if (channel >= 8) return;
+  if (on) {
+    g_shadow |= (uint8_t)(1u << channel);
+  } else {
+    g_shadow &= (uint8_t)~(1u << channel);
+  }
+}
+
+void outputs_tick(unsigned long now) {
+  if (g_shadow != g_committed) {
+    MachineControl_DigitalOutputs.writeAll(g_shadow);
+    g_committed = g_shadow;
+    g_commits++;
+  }
+
+  if (!Config::Outputs::DIGITAL_INPUTS) return;
+  if (Config::Outputs::INPUT_INT_PIN >= 0) {
+    if (g_inputChanged) readInputs(now);
+  } else if (now - g_lastInputReadMs >= Config::Outputs::INPUT_POLL_MS) {
+    readInputs(now);
+  }
+}
+
+uint8_t outputs_committed() {
+  return g_committed;
+}
+
+uint32_t outputs_inputs() {
+  return g_inputs;
+}
+
+uint32_t outputs_commit_count() {
+  return g_commits;
+}
@@ -0,0 +1,55 @@
+/*
+ * *****************************************************************************
+ * OUTPUTS - SHADOW-REGISTER ACTUATOR OUTPUTS + DIGITAL INPUT TRACKING
+ * *****************************************************************************
+ * The controller never touches the output hardware directly:
+ * - outputs_set() only changes a bit in the shadow register
+ * - The outputs task (right after the action and heater tasks) commits the
+ *   shadow with one DigitalOutputsClass::writeAll() per pass, and only when
+ *   it differs from what was last written; allOutputsOff() becomes one
+ *   write instead of four
+ * - Optional DIGITAL INPUTS tracking: one readAll() burst of the TCA6424A
+ *   expander when its INT line reports a change (Config::Outputs::
+ *   INPUT_INT_PIN), or every INPUT_POLL_MS when no INT line is wired
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @brief Configure the outputs (all off) and, if enabled, the digital inputs
+ */
+void outputs_init();
+
+/**
+ * @brief Set one output in the shadow register (no hardware access)
+ *
+ * @param channel DO channel 0..7
+ * @param on Output state
+ */
+void outputs_set(uint8_t channel, bool on);
+
+/**
+ * @brief Commit the shadow register and refresh the inputs (scheduler task)
+ *
+ * @param now millis() of the current scheduler pass
+ */
+void outputs_tick(unsigned long now);
+
+/**
+ * @brief Output mask last written to the hardware
+ */
+uint8_t outputs_committed();
+
+/**
+ * @brief Last known DIGITAL INPUTS state (bit n = input n)
+ */
+uint32_t outputs_inputs();
+
+/**
+ * @brief Number of writeAll() commits since init
+ */
+uint32_t outputs_commit_count();
@@ -0,0 +1,139 @@
+/*
+ * *****************************************************************************
+ * PERF IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "perf.h"
+
+#if CC_PERF
+
+#include "scheduler.h"
+#include <atomic>
+#include <string.h>
+
+// Cortex-M7 DWT (CMSIS register names); absent on host builds
+#if defined(DWT) && defined(DWT_CTRL_CYCCNTENA_Msk)
+#define PERF_HAVE_DWT 1
+#else
+#define PERF_HAVE_DWT 0
+#endif
+
+// Internal state
+static PerfStats g_stats[PERF_PROBE_COUNT];
+static uint32_t g_epoch[PERF_PROBE_COUNT];    // Reset epoch each probe was last cleared in
+static std::atomic<uint32_t> g_resetEpoch(1); // Bumped by perf_request_reset()
+static uint32_t g_passes = 0;
+static unsigned long g_windowStartMs = 0;
+static uint32_t g_loopHz = 0;
+static PerfBootTime g_boot[PERF_BOOT_PHASE_COUNT];
+static std::atomic<uint8_t> g_bootDone(0);    // Bit per completed phase, published after g_boot
+static_assert(PERF_BOOT_PHASE_COUNT <= 8, "Boot phase bits must fit g_bootDone");
+
+static const char *const BOOT_PHASE_NAMES[PERF_BOOT_PHASE_COUNT] = {
+  "outputs", "settings", "controller", "sample_log", "assets", "network",
+};
+
+void perf_init() {
+#if PERF_HAVE_DWT
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR = 0xC5ACCE55;  // M7: unlock the DWT registers
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+  g_windowStartMs = millis();
+}
+
+uint32_t perf_cycles() {
+#if PERF_HAVE_DWT
+  return DWT->CYCCNT;
+#else
+  return micros();
+#endif
+}
+
+uint32_t perf_cycles_per_second() {
+#if PERF_HAVE_DWT
+  return SystemCoreClock;
+#else
+  return 1000000;
+#endif
+}
+
+// log2 bucket: 0..1 cycles -> 0, 2..3 -> 1, 4..7 -> 2, ...
+static uint8_t bucketOf(uint32_t cycles) {
+  uint8_t b = 0;
+  while (cycles > 1 && b < PERF_HISTOGRAM_BUCKETS - 1) {
+    cycles >>= 1;
+    b++;
+  }
+  return b;
+}
+
+void perf_record(uint8_t probe, uint32_t cycles) {
+  if (probe >= PERF_PROBE_COUNT) return;
+  PerfStats &stats = g_stats[probe];
+
+  uint32_t epoch = g_resetEpoch.load(std::memory_order_relaxed);
+  if (g_epoch[probe] != epoch) {
+    memset(&stats, 0, sizeof(stats));
+    g_epoch[probe] = epoch;
+  }
+
+  if (stats.count == 0 || cycles < stats.minCycles) stats.minCycles = cycles;
+  if (cycles > stats.maxCycles) stats.maxCycles = cycles;
+  stats.totalCycles += cycles;
+  stats.histogram[bucketOf(cycles)]++;
+  stats.count++;
+}
+
+void perf_pass(unsigned long now) {
+  g_passes++;
+  unsigned long elapsed = now - g_windowStartMs;
+  if (elapsed >= Config::Perf::LOOP_WINDOW_MS) {
+    g_loopHz = (uint32_t)((uint64_t)g_passes * 1000 / elapsed);
+    g_passes = 0;
+    g_windowStartMs = now;
+  }
+}
+
+bool perf_stats(uint8_t probe, PerfStats *out) {
+  if (probe >= PERF_PROBE_COUNT) return false;
+  if (g_epoch[probe] != g_resetEpoch.load(std::memory_order_relaxed)) return false;
+  *out = g_stats[probe];
+  return out->count > 0;
+}
+
+const char *perf_probe_name(uint8_t probe) {
+  if (probe == PERF_PROBE_NETWORK) return "network";
+  const SchedulerTask *task = scheduler_task(probe);
+  return task != nullptr ? task->name : "";
+}
+
+uint32_t perf_loop_hz() {
+  return g_loopHz;
+}
+
+void perf_request_reset() {
+  g_resetEpoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+void perf_boot_phase(PerfBootPhase phase, uint32_t startUs) {
+  if (phase >= PERF_BOOT_PHASE_COUNT) return;
+  g_boot[phase].startUs = startUs;
+  g_boot[phase].durationUs = micros() - startUs;
+  g_bootDone.fetch_or((uint8_t)(1u << phase), std::memory_order_release);
+}
+
+bool perf_boot_time(PerfBootPhase phase, PerfBootTime *out) {
+  if (phase >= PERF_BOOT_PHASE_COUNT) return false;
+  if ((g_bootDone.load(std::memory_order_acquire) & (1u << phase)) == 0) return false;
+  *out = g_boot[phase];
+  return true;
+}
+
+const char *perf_boot_phase_name(PerfBootPhase phase) {
+  return (phase < PERF_BOOT_PHASE_COUNT) ? BOOT_PHASE_NAMES[phase] : "";
+}
+
+#endif // CC_PERF
@@ -0,0 +1,151 @@
+/*
+ * *****************************************************************************
+ * PERF - CYCLE-COUNTER PROFILING OF THE HOT PATHS
+ * *****************************************************************************
+ * Answers "what is the worst-case run time of each tick?" with numbers:
+ * - The Cortex-M7 DWT cycle counter (CYCCNT, 1 count per core clock) times
+ *   every scheduler task run and the network thread's web_server_handle()
+ * - Per probe: run count, min / avg / max cycles and a log2 histogram
+ *   (bucket b counts runs of 2^b .. 2^(b+1)-1 cycles)
+ * - The scheduler pass rate is measured over Config::Perf::LOOP_WINDOW_MS
+ * - Boot phases (outputs, settings, controller, then the deferred sample log,
+ *   asset and network start) are timed once in micros() since reset
+ * - /api/perf serves the numbers; ?reset=1 starts a new measurement (the
+ *   boot timings stay)
+ *
+ * Only built with -DCC_PERF=1. Otherwise every function below is an empty
+ * inline and the instrumented call sites compile to nothing.
+ *
+ * Each probe has one writer (scheduler or network thread); readers copy the
+ * counters without locking, so a copy may be one run out of date.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "config.h"
+
+static constexpr uint8_t PERF_HISTOGRAM_BUCKETS = 32;
+
+/**
+ * @brief Probes 0 .. MAX_TASKS-1 are the scheduler tasks (registration order)
+ */
+static constexpr uint8_t PERF_PROBE_NETWORK = Config::Scheduler::MAX_TASKS; ///< web_server_handle() in the network thread
+static constexpr uint8_t PERF_PROBE_COUNT = PERF_PROBE_NETWORK + 1;
+
+/**
+ * @brief Startup phases, in boot order (see setup() and the boot task)
+ */
+enum PerfBootPhase : uint8_t {
+  PERF_BOOT_OUTPUTS,     ///< Outputs in their safe state
+  PERF_BOOT_SETTINGS,    ///< Settings ring recovered
+  PERF_BOOT_CONTROLLER,  ///< Sensor front ends + controller: control runs after this
+  PERF_BOOT_SAMPLE_LOG,  ///< Deferred: flash sample log index rebuilt
+  PERF_BOOT_ASSETS,      ///< Deferred: asset headers loaded
+  PERF_BOOT_NETWORK,     ///< Deferred: MQTT queue + WiFi / network thread started
+  PERF_BOOT_PHASE_COUNT
+};
+
+/**
+ * @brief One timed boot phase (micros() since reset)
+ */
+struct PerfBootTime {
+  uint32_t startUs;
+  uint32_t durationUs;
+};
+
+/**
+ * @brief Counters of one probe
+ */
+struct PerfStats {
+  uint32_t count;        ///< Measured runs
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint64_t totalCycles;  ///< For the average
+  uint32_t histogram[PERF_HISTOGRAM_BUCKETS];
+};
+
+#if CC_PERF
+
+/**
+ * @brief Enable the DWT cycle counter (call once in setup)
+ */
+void perf_init();
+
+/**
+ * @brief Current cycle count
+ */
+uint32_t perf_cycles();
+
+/**
+ * @brief Account one run of a probe
+ *
+ * @param probe Probe index (< PERF_PROBE_COUNT)
+ * @param cycles Duration in cycles (perf_cycles() difference)
+ */
+void perf_record(uint8_t probe, uint32_t cycles);
+
+/**
+ * @brief Count one scheduler pass (loop frequency)
+ *
+ * @param now millis() of the pass
+ */
+void perf_pass(unsigned long now);
+
+/**
+ * @brief Copy the counters of a probe
+ *
+ * @return false if the probe never ran since the last reset
+ */
+bool perf_stats(uint8_t probe, PerfStats *out);
+
+/**
+ * @brief Probe name (scheduler task name, "network")
+ */
+const char *perf_probe_name(uint8_t probe);
+
+/**
+ * @brief Scheduler passes per second in the last complete window
+ */
+uint32_t perf_loop_hz();
+
+/**
+ * @brief Cycle counter frequency
+ */
+uint32_t perf_cycles_per_second();
+
+/**
+ * @brief Clear all probes; each one restarts on its next run
+ */
+void perf_request_reset();
+
+/**
+ * @brief Record a boot phase (once per phase, scheduler side)
+ *
+ * @param startUs micros() when the phase began; it ends now
+ */
+void perf_boot_phase(PerfBootPhase phase, uint32_t startUs);
+
+/**
+ * @brief Timing of a boot phase
+ *
+ * @return false if the phase has not completed yet
+ */
+bool perf_boot_time(PerfBootPhase phase, PerfBootTime *out);
+
+/**
+ * @brief Boot phase name ("outputs", "settings", ...)
+ */
+const char *perf_boot_phase_name(PerfBootPhase phase);
+
+#else
+
+inline void perf_init() {}
+inline uint32_t perf_cycles() { return 0; }
+inline void perf_record(uint8_t, uint32_t) {}
+inline void perf_pass(unsigned long) {}
+inline void perf_boot_phase(PerfBootPhase, uint32_t) {}
+
+#endif
@@ -0,0 +1,190 @@
+/*
+ * *****************************************************************************
+ * PID CONTROL - PI/PID LOOP, SLOW PWM AND LOOP STATISTICS
+ * *****************************************************************************
+ * Building blocks of the PI control mode (see Config::Control):
+ * - PidController: discrete PI/PID on the error setpoint - measurement,
+ *   output 0..1. The derivative acts on the measurement (no kick on setpoint
+ *   steps); anti-windup by conditional integration: while the output is
+ *   saturated the integral only moves back towards the linear range
+ * - SlowPwm: time-proportional output for on/off actuators (heater, fogger).
+ *   Each window is on for duty * window and off for the rest; pulses shorter
+ *   than the minimum switch time are skipped or stretched to full on
+ * - LoopStats: overshoot, settling time and duty cycle after each setpoint
+ *   step, for comparing the PI mode with the hysteresis mode
+ *
+ * All times are chamber time in ms (see chamber_clock.h); no allocation.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class PidController {
+private:
+  float integral;         // Integral term, already scaled by ki
+  float lastMeasurement;
+  float out;
+  bool primed;            // lastMeasurement valid
+
+public:
+  PidController() : integral(0.0f), lastMeasurement(0.0f), out(0.0f), primed(false) {}
+
+  void reset() {
+    integral = 0.0f;
+    out = 0.0f;
+    primed = false;
+  }
+
+  /**
+   * @brief One control step
+   *
+   * @param kp Proportional gain (output per unit of error)
+   * @param ki Integral gain (output per unit of error and second)
+   * @param kd Derivative gain (output per unit of error change per second)
+   * @param dtS Time since the previous step in seconds (> 0)
+   * @return Output 0..1
+   */
+  float update(float setpoint, float measurement, float kp, float ki, float kd, float dtS) {
+    float error = setpoint - measurement;
+    float derivative = primed ? -kd * (measurement - lastMeasurement) / dtS : 0.0f;
+    lastMeasurement = measurement;
+    primed = true;
+
+    float proportional = kp * error;
+    float candidate = integral + ki * error * dtS;
+    float u = proportional + candidate + derivative;
+    bool windingUp = (u > 1.0f && error > 0.0f) || (u < 0.0f && error < 0.0f);
+    if (!windingUp) integral = candidate;
+    if (integral > 1.0f) integral = 1.0f;
+    if (integral < 0.0f) integral = 0.0f;
+
+    u = proportional + integral + derivative;
+    out = (u > 1.0f) ? 1.0f : (u < 0.0f) ? 0.0f : u;
+    return out;
+  }
+
+  float output() const { return out; }
+};
+
+class SlowPwm {
+private:
+  unsigned long windowStartMs;
+  bool started;
+  bool offLatched;        // Off for the rest of the current window
+
+public:
+  SlowPwm() : windowStartMs(0), started(false), offLatched(false) {}
+
+  void reset() {
+    started = false;
+    offLatched = false;
+  }
+
+  /**
+   * @brief Output state for `duty` at chamber time `now`
+   *
+   * The duty may change within a window; once the output went off it stays
+   * off until the next window, so there is at most one pulse per window.
+   */
+  bool update(float duty, unsigned long now, unsigned long windowMs, unsigned long minSwitchMs) {
+    if (!started || now - windowStartMs >= windowMs) {
+      windowStartMs = started ? windowStartMs + windowMs : now;
+      if (now - windowStartMs >= windowMs) windowStartMs = now; // Long gap: restart
+      started = true;
+      offLatched = false;
+    }
+    unsigned long onMs = (unsigned long)(duty * (float)windowMs);
+    if (onMs < minSwitchMs) onMs = 0;
+    if (onMs + minSwitchMs > windowMs) onMs = windowMs;
+
+    bool on = !offLatched && (now - windowStartMs) < onMs;
+    if (!on) offLatched = true;
+    return on;
+  }
+};
+
+/**
+ * @brief Quality figures of one loop since its last setpoint step
+ */
+struct LoopStatsValues {
+  float overshoot;           ///< Largest excursion past the setpoint (units, >= 0)
+  unsigned long settlingMs;  ///< Step -> entering the band for good (valid if settled)
+  bool settled;              ///< Within the band for the hold time
+  float duty;                ///< On-time fraction of the actuator since the step
+};
+
+class LoopStats {
+private:
+  float setpoint;
+  float direction;           // +1 approaching from below, -1 from above
+  unsigned long stepMs;      // Setpoint step (or start)
+  unsigned long bandSinceMs; // Entered the band (inBand)
+  unsigned long lastMs;
+  unsigned long onMs;
+  unsigned long totalMs;
+  float overshoot;
+  unsigned long settlingMs;
+  bool settled;
+  bool started;
+  bool inBand;
+
+public:
+  LoopStats()
+      : setpoint(0.0f), direction(1.0f), stepMs(0), bandSinceMs(0), lastMs(0), onMs(0),
+        totalMs(0), overshoot(0.0f), settlingMs(0), settled(false), started(false),
+        inBand(false) {}
+
+  /**
+   * @brief Account one loop step
+   *
+   * @param band Settled means |error| <= band ...
+   * @param holdMs ... continuously for holdMs
+   * @param actuatorOn Actuator state since the previous call
+   */
+  void update(float sp, float measurement, bool actuatorOn, unsigned long now,
+              float band, unsigned long holdMs) {
+    if (!started || sp != setpoint) {
+      setpoint = sp;
+      direction = (measurement <= sp) ? 1.0f : -1.0f;
+      stepMs = now;
+      lastMs = now;
+      onMs = 0;
+      totalMs = 0;
+      overshoot = 0.0f;
+      settlingMs = 0;
+      settled = false;
+      inBand = false;
+      started = true;
+    }
+
+    unsigned long dt = now - lastMs;
+    lastMs = now;
+    totalMs += dt;
+    if (actuatorOn) onMs += dt;
+
+    float past = direction * (measurement - setpoint);
+    if (past > overshoot) overshoot = past;
+
+    float error = measurement - setpoint;
+    bool within = error <= band && error >= -band;
+    if (within && !inBand) bandSinceMs = now;
+    inBand = within;
+    if (!inBand) {
+      settled = false;
+    } else if (!settled && now - bandSinceMs >= holdMs) {
+      settled = true;
+      settlingMs = bandSinceMs - stepMs;
+    }
+  }
+
+  LoopStatsValues values() const {
+    LoopStatsValues v;
+    v.overshoot = overshoot;
+    v.settlingMs = settlingMs;
+    v.settled = settled;
+    v.duty = (totalMs > 0) ? (float)onMs / (float)totalMs : 0.0f;
+    return v;
+  }
+};
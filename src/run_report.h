@@ -0,0 +1,99 @@
+/*
+ * *****************************************************************************
+ * RUN REPORT - SUMMARY OF ONE CONTROL RUN
+ * *****************************************************************************
+ * Accumulates what a control change is judged by, over one run (e.g. a
+ * trace replay, sensor_trace.h), so two runs of the same input compare:
+ * - Actuator duty (on-time fraction) and switch-on count per actuator
+ * - Time in band per controlled quantity (the caller decides per sample)
+ * - Actions started, per action
+ * - Control pass run time (mean / max, µs)
+ *
+ * Time is the sum of the per-sample durations the caller passes in (chamber
+ * time), so a replay at full speed reports the same as one in real time.
+ * O(1) per call, no allocation. Needs only <stdint.h>, so the sensor_trace
+ * report and test/test_run_report (env:native) share this one header.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+template<uint8_t ACTUATORS, uint8_t ACTIONS, uint8_t BANDS>
+class RunReport {
+private:
+  uint32_t sampleCount;
+  uint64_t totalMs;
+  uint64_t onMs[ACTUATORS];
+  uint64_t bandMs[BANDS];
+  uint32_t switchOns[ACTUATORS];
+  uint32_t actionCount[ACTIONS];
+  uint8_t lastActuators;
+  uint32_t passCount;
+  uint64_t passUsTotal;
+  uint32_t passUsMax;
+
+  static float share(uint64_t part, uint64_t whole) {
+    return (whole == 0) ? 0.0f : (float)((double)part / (double)whole);
+  }
+
+public:
+  RunReport() { reset(); }
+
+  void reset() {
+    sampleCount = 0;
+    totalMs = 0;
+    for (uint8_t i = 0; i < ACTUATORS; i++) {
+      onMs[i] = 0;
+      switchOns[i] = 0;
+    }
+    for (uint8_t i = 0; i < BANDS; i++) bandMs[i] = 0;
+    for (uint8_t i = 0; i < ACTIONS; i++) actionCount[i] = 0;
+    lastActuators = 0;
+    passCount = 0;
+    passUsTotal = 0;
+    passUsMax = 0;
+  }
+
+  /**
+   * @brief Account one sample
+   *
+   * @param actuators Bit n = actuator n on, held for dtMs
+   * @param inBand Bit n = quantity n within its band
+   * @param dtMs Time the sample stands for
+   */
+  void addSample(uint8_t actuators, uint8_t inBand, uint32_t dtMs) {
+    for (uint8_t i = 0; i < ACTUATORS; i++) {
+      uint8_t bit = (uint8_t)(1u << i);
+      if (actuators & bit) onMs[i] += dtMs;
+      if ((actuators & bit) && !(lastActuators & bit) && sampleCount > 0) switchOns[i]++;
+    }
+    for (uint8_t i = 0; i < BANDS; i++) {
+      if (inBand & (1u << i)) bandMs[i] += dtMs;
+    }
+    lastActuators = actuators;
+    totalMs += dtMs;
+    sampleCount++;
+  }
+
+  void addAction(uint8_t action) {
+    if (action < ACTIONS) actionCount[action]++;
+  }
+
+  void addPass(uint32_t us) {
+    passCount++;
+    passUsTotal += us;
+    if (us > passUsMax) passUsMax = us;
+  }
+
+  uint32_t samples() const { return sampleCount; }
+  uint64_t durationMs() const { return totalMs; }
+  float duty(uint8_t actuator) const { return share(onMs[actuator], totalMs); }
+  uint32_t switches(uint8_t actuator) const { return switchOns[actuator]; }
+  float timeInBand(uint8_t band) const { return share(bandMs[band], totalMs); }
+  uint32_t actions(uint8_t action) const { return actionCount[action]; }
+  uint32_t passes() const { return passCount; }
+  uint32_t passMeanUs() const { return (passCount == 0) ? 0 : (uint32_t)(passUsTotal / passCount); }
+  uint32_t passMaxUs() const { return passUsMax; }
+};
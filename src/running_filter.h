@@ -0,0 +1,128 @@
+/*
+ * *****************************************************************************
+ * RUNNING FILTER - SLIDING-WINDOW MEDIAN / TRIMMED MEAN / HAMPEL
+ * *****************************************************************************
+ * Robust estimates over the last N samples of one channel, updated per sample:
+ * - The window is kept twice: in arrival order (to know which sample leaves)
+ *   and sorted; push() evicts the oldest and inserts the new value in one
+ *   shift pass, so a query never sorts
+ * - median(): middle element (even N: average of the middle two)
+ * - trimmedMean(t): mean without the t smallest and t largest samples
+ * - hampelMean(k): mean of the samples within k * 1.4826 * MAD of the median;
+ *   the MAD comes from a two-pointer walk outwards from the median
+ *
+ * The window always holds the raw samples, so a real step change is followed
+ * after N/2 samples instead of being rejected forever.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+template<typename T, uint8_t N>
+class RunningFilter {
+  static_assert(N >= 1, "RunningFilter needs a window of at least one sample");
+
+private:
+  T arrival[N];     // Ring in arrival order
+  T sorted[N];      // Same samples, ascending
+  uint8_t head;     // Oldest sample in `arrival` once full
+  uint8_t count;
+  uint32_t total;   // Samples pushed since reset()
+
+  // Median absolute deviation around m (sorted window, count > 0)
+  float mad(float m) const {
+    // Deviations grow outwards from the median on both sides: merge them
+    int lo = (count - 1) / 2;
+    int hi = lo + 1;
+    uint8_t target = count / 2;  // Index of the (upper) median deviation
+    float prev = 0.0f;
+    float dev = 0.0f;
+    for (uint8_t k = 0; k <= target; k++) {
+      float dl = (lo >= 0) ? m - (float)sorted[lo] : 3.4e38f;
+      float dh = (hi < count) ? (float)sorted[hi] - m : 3.4e38f;
+      prev = dev;
+      if (dl <= dh) { dev = dl; lo--; } else { dev = dh; hi++; }
+    }
+    return (count % 2 == 0) ? (prev + dev) / 2.0f : dev;
+  }
+
+public:
+  RunningFilter() : head(0), count(0), total(0) {}
+
+  void reset() {
+    head = 0;
+    count = 0;
+    total = 0;
+  }
+
+  void push(T value) {
+    uint8_t pos;
+    if (count < N) {
+      arrival[count] = value;
+      pos = count++;
+    } else {
+      // Evict the oldest sample from the sorted window
+      T oldest = arrival[head];
+      arrival[head] = value;
+      head = (head + 1) % N;
+      pos = 0;
+      while (pos + 1 < N && sorted[pos] != oldest) pos++;
+      // Slide the gap towards where `value` belongs
+      while (pos > 0 && sorted[pos - 1] > value) {
+        sorted[pos] = sorted[pos - 1];
+        pos--;
+      }
+      while (pos + 1 < N && sorted[pos + 1] < value) {
+        sorted[pos] = sorted[pos + 1];
+        pos++;
+      }
+      sorted[pos] = value;
+      total++;
+      return;
+    }
+    while (pos > 0 && sorted[pos - 1] > value) {
+      sorted[pos] = sorted[pos - 1];
+      pos--;
+    }
+    sorted[pos] = value;
+    total++;
+  }
+
+  uint8_t size() const { return count; }
+  bool full() const { return count == N; }
+  uint32_t pushes() const { return total; }
+
+  T median() const {
+    if (count == 0) return T();
+    if (count % 2 == 0) return (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+    return sorted[count / 2];
+  }
+
+  float trimmedMean(uint8_t trim) const {
+    if (count == 0) return 0.0f;
+    if (2 * trim >= count) return (float)median();
+    float sum = 0.0f;
+    for (uint8_t i = trim; i < count - trim; i++) sum += (float)sorted[i];
+    return sum / (count - 2 * trim);
+  }
+
+  float hampelMean(float k) const {
+    if (count == 0) return 0.0f;
+    float m = (count % 2 == 0) ? ((float)sorted[count / 2 - 1] + (float)sorted[count / 2]) / 2.0f
+                               : (float)sorted[count / 2];
+    float limit = k * 1.4826f * mad(m);
+    float sum = 0.0f;
+    uint8_t used = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      float d = (float)sorted[i] - m;
+      if (d < 0.0f) d = -d;
+      if (d <= limit) {
+        sum += (float)sorted[i];
+        used++;
+      }
+    }
+    return (used > 0) ? sum / used : m;
+  }
+};
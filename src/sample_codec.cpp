@@ -0,0 +1,165 @@
+/*
+ * *****************************************************************************
+ * SAMPLE CODEC IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "sample_codec.h"
+#include "checksum.h"
+
+// Payload widths of the step code, by prefix length (1..4 one-bits + '0', or '1111')
+static constexpr uint8_t STEP_BITS[] = {4, 8, 12, 16};
+
+namespace {
+
+class BitWriter {
+public:
+  BitWriter(uint8_t *out, size_t cap) : out(out), cap(cap), len(0), acc(0), bits(0), overflow(false) {}
+
+  // Append the low `n` bits of `value` (n <= 24)
+  void put(uint32_t value, uint8_t n) {
+    acc = (acc << n) | (value & ((1UL << n) - 1));
+    bits += n;
+    while (bits >= 8) {
+      bits -= 8;
+      emit((uint8_t)(acc >> bits));
+    }
+  }
+
+  // Pad the last byte with zeros; 0 if the buffer overflowed
+  size_t finish() {
+    if (bits > 0) emit((uint8_t)(acc << (8 - bits)));
+    bits = 0;
+    return overflow ? 0 : len;
+  }
+
+private:
+  void emit(uint8_t byte) {
+    if (len < cap) {
+      out[len++] = byte;
+    } else {
+      overflow = true;
+    }
+  }
+
+  uint8_t *out;
+  size_t cap;
+  size_t len;
+  uint32_t acc;
+  uint8_t bits;
+  bool overflow;
+};
+
+class BitReader {
+public:
+  BitReader(const uint8_t *in, size_t len) : in(in), len(len), pos(0), acc(0), bits(0), failed(false) {}
+
+  // Next `n` bits (n <= 24); sets failed() past the end
+  uint32_t get(uint8_t n) {
+    while (bits < n) {
+      if (pos >= len) {
+        failed = true;
+        return 0;
+      }
+      acc = (acc << 8) | in[pos++];
+      bits += 8;
+    }
+    bits -= n;
+    return (acc >> bits) & ((1UL << n) - 1);
+  }
+
+  bool ok() const { return !failed; }
+
+private:
+  const uint8_t *in;
+  size_t len;
+  size_t pos;
+  uint32_t acc;
+  uint8_t bits;
+  bool failed;
+};
+
+} // namespace
+
+static void recordChannels(const SampleRecord &record, uint16_t *channels) {
+  channels[0] = record.co2;
+  channels[1] = record.co2_2;
+  channels[2] = (uint16_t)record.rh_x10;
+  channels[3] = (uint16_t)record.rh_2_x10;
+  channels[4] = (uint16_t)record.temp_x10;
+  channels[5] = (uint16_t)record.temp_2_x10;
+  channels[6] = (uint16_t)record.temp_outer_x10;
+}
+
+static void putStep(BitWriter &writer, uint16_t from, uint16_t to) {
+  int16_t step = (int16_t)(uint16_t)(to - from); // 16-bit wrap: every step fits
+  if (step == 0) {
+    writer.put(0, 1);
+    return;
+  }
+  uint16_t zigzag = (uint16_t)(((uint16_t)step << 1) ^ (uint16_t)(step >> 15));
+  for (uint8_t code = 0; code < 3; code++) {
+    if (zigzag < (1U << STEP_BITS[code])) {
+      writer.put((1U << (code + 2)) - 2, code + 2); // code + 1 ones, then a zero
+      writer.put(zigzag, STEP_BITS[code]);
+      return;
+    }
+  }
+  writer.put(0xF, 4);
+  writer.put(zigzag, 16);
+}
+
+static uint16_t getStep(BitReader &reader, uint16_t from) {
+  if (reader.get(1) == 0) return from;
+  uint8_t code = 0;
+  while (code < 3 && reader.get(1) == 1) code++;
+  uint16_t zigzag = (uint16_t)reader.get(STEP_BITS[code]);
+  int16_t step = (int16_t)((zigzag >> 1) ^ (uint16_t)-(int16_t)(zigzag & 1));
+  return (uint16_t)(from + (uint16_t)step);
+}
+
+size_t sample_codec_encode(const SampleRecord *records, uint16_t count, uint8_t *out, size_t cap) {
+  BitWriter writer(out, cap);
+  uint16_t previous[SAMPLE_CODEC_CHANNELS] = {};
+  uint8_t previousActuators = 0;
+
+  for (uint16_t i = 0; i < count; i++) {
+    uint16_t channels[SAMPLE_CODEC_CHANNELS];
+    recordChannels(records[i], channels);
+    for (uint8_t ch = 0; ch < SAMPLE_CODEC_CHANNELS; ch++) {
+      putStep(writer, previous[ch], channels[ch]);
+      previous[ch] = channels[ch];
+    }
+    if (records[i].actuators == previousActuators) {
+      writer.put(0, 1);
+    } else {
+      writer.put(0x100 | records[i].actuators, 9);
+      previousActuators = records[i].actuators;
+    }
+  }
+  return writer.finish();
+}
+
+uint16_t sample_codec_decode(const uint8_t *in, size_t len, SampleRecord *out, uint16_t count) {
+  BitReader reader(in, len);
+  uint16_t channels[SAMPLE_CODEC_CHANNELS] = {};
+  uint8_t actuators = 0;
+
+  for (uint16_t i = 0; i < count; i++) {
+    for (uint8_t ch = 0; ch < SAMPLE_CODEC_CHANNELS; ch++) channels[ch] = getStep(reader, channels[ch]);
+    if (reader.get(1) == 1) actuators = (uint8_t)reader.get(8);
+    if (!reader.ok()) return i;
+
+    SampleRecord &record = out[i];
+    record.co2 = channels[0];
+    record.co2_2 = channels[1];
+    record.rh_x10 = (int16_t)channels[2];
+    record.rh_2_x10 = (int16_t)channels[3];
+    record.temp_x10 = (int16_t)channels[4];
+    record.temp_2_x10 = (int16_t)channels[5];
+    record.temp_outer_x10 = (int16_t)channels[6];
+    record.actuators = actuators;
+    record.crc = checksum_crc8(&record, sizeof(record) - 1);
+  }
+  return count;
+}
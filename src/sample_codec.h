@@ -0,0 +1,66 @@
+/*
+ * *****************************************************************************
+ * SAMPLE CODEC - DELTA BIT PACKING OF SAMPLE RECORDS
+ * *****************************************************************************
+ * Compresses runs of SampleRecords (sample_log.h) for the flash sample log
+ * and the packed binary API. Sensor values move by a few ppm or 0.1 % per
+ * sample, so each channel is stored as the difference to the previous
+ * sample, zigzag-mapped and bit-packed with a prefix code:
+ *
+ *   '0'                       no change                1 bit
+ *   '10'   + 4 bits          step -8..7                6 bits
+ *   '110'  + 8 bits          step -128..127            11 bits
+ *   '1110' + 12 bits         step -2048..2047          16 bits
+ *   '1111' + 16 bits         any 16-bit step           20 bits
+ *
+ * Actuators: '0' unchanged, '1' + 8 bits. Channels in SampleRecord order,
+ * MSB first, the last byte zero-padded. Every block starts from an all-zero
+ * record, so blocks decode on their own.
+ *
+ * No timestamps are stored: samples are evenly spaced and a block never
+ * spans a gap, so the delta-of-delta of the sample number is always zero.
+ * The container (segment header, telemetry header) carries the first
+ * sample number and the interval.
+ *
+ * Typical noisy chamber data packs into 5-6 bytes per sample (8 values),
+ * against 16 bytes per SampleRecord.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sample_log.h"
+
+/// Values per record the codec packs (7 sensors + actuator byte)
+constexpr uint8_t SAMPLE_CODEC_CHANNELS = 7;
+
+/**
+ * @brief Largest encoding of `count` records (every step a full 16 bits)
+ */
+constexpr size_t sample_codec_max_bytes(uint16_t count) {
+  return ((size_t)count * (SAMPLE_CODEC_CHANNELS * 20 + 9) + 7) / 8;
+}
+
+/**
+ * @brief Pack records, oldest first
+ *
+ * @param records Input (CRC fields are ignored)
+ * @param count Number of records
+ * @param out Output buffer
+ * @param cap Its size; sample_codec_max_bytes(count) always suffices
+ * @return Bytes written, 0 if `cap` was too small
+ */
+size_t sample_codec_encode(const SampleRecord *records, uint16_t count, uint8_t *out, size_t cap);
+
+/**
+ * @brief Unpack records (CRC fields recomputed)
+ *
+ * @param in Encoded block
+ * @param len Its length in bytes
+ * @param out Output, room for `count` records
+ * @param count Records the block holds
+ * @return Records decoded; less than `count` if the block is truncated
+ */
+uint16_t sample_codec_decode(const uint8_t *in, size_t len, SampleRecord *out, uint16_t count);
@@ -0,0 +1,53 @@
+/*
+ * *****************************************************************************
+ * SAMPLE CSV IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "sample_csv.h"
+#include "channels.h"
+#include "fixed_point.h"
+#include "wall_clock.h"
+
+static_assert(SENSOR_SERIES_COUNT == 7, "CSV rows list the SampleRecord fields");
+static_assert(WALL_CLOCK_ISO_LENGTH + 1 + 10 + SENSOR_SERIES_COUNT * 8 + ACTUATOR_COUNT * 2 + 2 <= SAMPLE_CSV_ROW_MAX,
+              "SAMPLE_CSV_ROW_MAX too small for a row");
+
+static size_t appendText(char *out, const char *text) {
+  size_t n = 0;
+  while (text[n] != '\0') {
+    out[n] = text[n];
+    n++;
+  }
+  return n;
+}
+
+size_t sample_csv_header(char *out) {
+  size_t len = appendText(out, "time,epoch");
+  for (uint8_t i = 0; i < SERIES_COUNT; i++) {
+    out[len++] = ',';
+    len += appendText(out + len, CHANNELS[i].key);
+  }
+  out[len++] = '\r';
+  out[len++] = '\n';
+  return len;
+}
+
+size_t sample_csv_row(char *out, uint32_t epoch, const SampleRecord &r) {
+  size_t len = (epoch != 0) ? wall_clock_format_iso(out, epoch) : 0;
+  out[len++] = ',';
+  len += fixed_format(out + len, (int32_t)epoch, 0);
+  const int32_t fields[SENSOR_SERIES_COUNT] = {r.co2, r.co2_2, r.rh_x10, r.rh_2_x10,
+                                               r.temp_x10, r.temp_2_x10, r.temp_outer_x10};
+  for (uint8_t i = 0; i < SENSOR_SERIES_COUNT; i++) {
+    out[len++] = ',';
+    len += fixed_format(out + len, fields[i], CHANNELS[i].decimals);
+  }
+  for (uint8_t i = SENSOR_SERIES_COUNT; i < SERIES_COUNT; i++) {
+    out[len++] = ',';
+    out[len++] = (r.actuators & series_actuator_bit(i)) ? '1' : '0';
+  }
+  out[len++] = '\r';
+  out[len++] = '\n';
+  return len;
+}
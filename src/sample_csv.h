@@ -0,0 +1,35 @@
+/*
+ * *****************************************************************************
+ * SAMPLE CSV - TEXT ROWS OF PERSISTED SAMPLES
+ * *****************************************************************************
+ * One layout for every CSV the board writes (GET /api/export.csv, the USB
+ * logger): a header row of the CHANNELS keys behind "time,epoch", then per
+ * sample the ISO 8601 UTC time, the epoch seconds, the sensor values in their
+ * fixed-point decimals and one 0/1 column per actuator. Rows end in CRLF.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sample_log.h"
+
+/// Upper bound of one row (and of the header row)
+static constexpr size_t SAMPLE_CSV_ROW_MAX = 128;
+
+/**
+ * @brief Header row
+ *
+ * @return Characters written (no NUL)
+ */
+size_t sample_csv_header(char *out);
+
+/**
+ * @brief Row of one sample
+ *
+ * @param epoch Wall time of the sample (UTC seconds); 0 leaves the time
+ *              column empty
+ * @return Characters written (no NUL)
+ */
+size_t sample_csv_row(char *out, uint32_t epoch, const SampleRecord &record);
@@ -0,0 +1,586 @@
+/*
+ * *****************************************************************************
+ * SAMPLE LOG IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "sample_log.h"
+#include <atomic>
+#include "config.h"
+#include "checksum.h"
+#include "flash_ringbuffer.h"
+#include "sample_codec.h"
+
+// Segment header: first bytes of every erase block
+struct SegmentHeader {
+  uint32_t magic;               // SEGMENT_MAGIC
+  uint32_t segment_seq;         // Monotonic, highest = newest (0 = never used)
+  uint32_t first_sample;        // Sample number of record 0
+  uint16_t sample_interval_ms;  // For decoding timestamps offline
+  uint8_t version;              // FORMAT_VERSION
+  uint8_t crc;                  // CRC8 over the preceding 15 bytes
+} __attribute__((packed));
+
+static_assert(sizeof(SegmentHeader) == 16, "SegmentHeader must be exactly 16 bytes");
+
+// Version 2 segments hold packed blocks, each behind a BlockHeader, starting
+// at program-size aligned offsets
+struct BlockHeader {
+  uint16_t payload_bytes;       // sample_codec bytes that follow
+  uint8_t count;                // Samples in the block
+  uint8_t header_crc;           // CRC8 over the preceding 3 bytes
+  uint32_t payload_crc;         // CRC32 over the payload
+} __attribute__((packed));
+
+static_assert(sizeof(BlockHeader) == 8, "BlockHeader must be exactly 8 bytes");
+
+// Version 3 blocks carry the wall time of their first and last sample right
+// behind the BlockHeader, covered by payload_crc; samples in between are
+// interpolated (they are evenly spaced by the sample interval)
+struct BlockTimes {
+  uint32_t first_time;          // UTC seconds, 0 = clock unknown
+  uint32_t last_time;
+} __attribute__((packed));
+
+static_assert(sizeof(BlockTimes) == 8, "BlockTimes must be exactly 8 bytes");
+
+static constexpr uint32_t SEGMENT_MAGIC = 0x4C534343; // "CCSL" little-endian
+static constexpr uint8_t FORMAT_RECORDS = 1;          // Plain 16-byte SampleRecords (read only)
+static constexpr uint8_t FORMAT_PACKED = 2;           // sample_codec blocks (read only)
+static constexpr uint8_t FORMAT_TIMED = 3;            // sample_codec blocks with BlockTimes
+static constexpr uint16_t MAX_SEGMENTS = Config::SAMPLE_LOG_MAX_SEGMENTS;
+static constexpr uint16_t MIN_SEGMENTS = 3;  // active + erased spare + at least one old
+static constexpr uint16_t NO_SEGMENT = 0xFFFF;
+static constexpr uint8_t BLOCK_SAMPLES = Config::SAMPLE_LOG_BLOCK_SAMPLES;
+static constexpr uint32_t MAX_PROGRAM_SIZE = sizeof(SegmentHeader); // Headers must stay aligned
+static constexpr size_t BLOCK_BUFFER_BYTES =
+    sizeof(BlockHeader) + sizeof(BlockTimes) + sample_codec_max_bytes(BLOCK_SAMPLES) + MAX_PROGRAM_SIZE - 1;
+
+static_assert(BLOCK_SAMPLES >= 1, "Config::SAMPLE_LOG_BLOCK_SAMPLES must be at least 1");
+
+// RAM copy of one segment header
+struct SegmentIndex {
+  uint32_t segmentSeq;   // 0 = erased or invalid
+  uint32_t firstSample;
+  uint8_t version;       // FORMAT_*
+  uint32_t firstTime;    // Time of the first sample (sparse time index), 0 = unknown or no block yet
+};
+
+// Last block sample_log_read() decoded; sequential reads stay in it and
+// continue the block walk from where it ended
+struct BlockCache {
+  uint16_t segment;
+  uint32_t segmentSeq;   // 0 = empty
+  uint32_t firstSample;
+  uint8_t count;
+  bool valid;            // Payload CRC matched
+  BlockTimes times;      // Zero for FORMAT_PACKED
+  uint32_t nextOffset;   // Block behind it, relative to the segment start
+  SampleRecord records[BLOCK_SAMPLES];
+};
+
+// Block cache and read buffer of one SampleLogReader
+struct BlockReader {
+  uint8_t buffer[BLOCK_BUFFER_BYTES];
+  BlockCache cache;
+};
+
+// Internal state
+static SegmentIndex g_index[MAX_SEGMENTS];
+static bool g_available = false;
+static uint32_t g_segmentSize = 0;
+static uint16_t g_segmentCount = 0;
+static uint32_t g_programSize = 1;
+static uint16_t g_recordsPerSegment = 0; // Of FORMAT_RECORDS segments
+static uint16_t g_active = 0;          // Segment currently appended to
+static uint32_t g_activeUsed = 0;      // Bytes programmed in the active segment, header included
+static uint32_t g_segmentSeq = 0;      // Sequence number of the active segment
+static uint32_t g_nextSample = 1;      // Sample number of the next append
+static uint16_t g_erasePending = NO_SEGMENT;
+
+// Samples not yet in flash: written to g_pending before g_pendingCount
+// grows (release). After the block is programmed g_pendingCount drops to 0
+// and then g_pendingFirst moves (release), before any slot is reused. A
+// reader on another thread copies a slot and re-checks g_pendingFirst
+// afterwards (seqlock style); if it moved or the slot was not there, the
+// sample is looked up in flash.
+static SampleRecord g_pending[BLOCK_SAMPLES];
+static uint32_t g_pendingTimes[BLOCK_SAMPLES];
+static std::atomic<uint8_t> g_pendingCount(0);
+static std::atomic<uint32_t> g_pendingFirst(1); // Sample number of g_pending[0]
+static bool g_flushPending = false;    // Block full, program it from sample_log_tick()
+
+static uint8_t g_blockBuffer[BLOCK_BUFFER_BYTES]; // Writer (sample task)
+static BlockReader g_readers[SAMPLE_LOG_READER_COUNT] = {};
+
+static bool isErased(const void *data, size_t len) {
+  const uint8_t *p = (const uint8_t *)data;
+  for (size_t i = 0; i < len; i++) {
+    if (p[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+static uint64_t segmentOffset(uint16_t segment) {
+  return (uint64_t)segment * g_segmentSize;
+}
+
+static uint64_t recordOffset(uint16_t segment, uint16_t record) {
+  return segmentOffset(segment) + sizeof(SegmentHeader) + (uint64_t)record * sizeof(SampleRecord);
+}
+
+static uint32_t alignProgram(uint32_t bytes) {
+  return (bytes + g_programSize - 1) / g_programSize * g_programSize;
+}
+
+// Bytes between the BlockHeader and the codec payload
+static uint32_t timesBytes(uint8_t version) {
+  return (version == FORMAT_TIMED) ? sizeof(BlockTimes) : 0;
+}
+
+static uint32_t blockSize(const BlockHeader &header, uint8_t version) {
+  return alignProgram(sizeof(BlockHeader) + timesBytes(version) + header.payload_bytes);
+}
+
+// Wall time of sample `i` of a block; 0 where the clock was unknown
+static uint32_t sampleTime(const BlockTimes &times, uint8_t i, uint8_t count) {
+  if (times.first_time != 0 && times.last_time >= times.first_time && count > 1) {
+    return times.first_time + (uint32_t)((uint64_t)(times.last_time - times.first_time) * i / (count - 1));
+  }
+  if (i == 0) return times.first_time;
+  return (i == count - 1) ? times.last_time : 0;
+}
+
+static uint16_t nextSegment(uint16_t segment) {
+  return (segment + 1 < g_segmentCount) ? segment + 1 : 0;
+}
+
+static bool readHeader(uint16_t segment, SegmentHeader *header) {
+  if (!fb_log_read(segmentOffset(segment), header, sizeof(*header))) return false;
+  if (header->magic != SEGMENT_MAGIC) return false;
+  if (header->version < FORMAT_RECORDS || header->version > FORMAT_TIMED) return false;
+  if (header->segment_seq == 0 || header->segment_seq == 0xFFFFFFFF) return false;
+  return checksum_crc8(header, sizeof(*header) - 1) == header->crc;
+}
+
+// FORMAT_RECORDS: records are appended in order, so "written" is monotonic:
+// binary search for the first erased record. A torn record counts as written.
+static uint16_t countRecords(uint16_t segment) {
+  uint16_t lo = 0;
+  uint16_t hi = g_recordsPerSegment;
+  while (lo < hi) {
+    uint16_t mid = lo + (hi - lo) / 2;
+    SampleRecord record;
+    bool written = !fb_log_read(recordOffset(segment, mid), &record, sizeof(record)) ||
+                   !isErased(&record, sizeof(record));
+    if (written) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+enum BlockState : uint8_t {
+  BLOCK_OK,
+  BLOCK_END,      // Erased or end of segment: nothing written here yet
+  BLOCK_CORRUPT   // Torn header: the rest of the segment cannot be walked
+};
+
+// Header and, for FORMAT_TIMED, the block times in one read. The times are
+// unverified until the payload CRC is checked; they only steer searches.
+static BlockState readBlockHeader(uint16_t segment, uint32_t offset, BlockHeader *header, BlockTimes *times) {
+  uint8_t version = g_index[segment].version;
+  uint8_t raw[sizeof(BlockHeader) + sizeof(BlockTimes)];
+  uint32_t rawBytes = sizeof(BlockHeader) + timesBytes(version);
+  if (offset + rawBytes > g_segmentSize) return BLOCK_END;
+  if (!fb_log_read(segmentOffset(segment) + offset, raw, rawBytes)) return BLOCK_CORRUPT;
+  if (isErased(raw, sizeof(BlockHeader))) return BLOCK_END;
+  memcpy(header, raw, sizeof(*header));
+  memset(times, 0, sizeof(*times));
+  memcpy(times, raw + sizeof(BlockHeader), timesBytes(version));
+  if (checksum_crc8(header, 3) != header->header_crc || header->count == 0 || header->count > BLOCK_SAMPLES ||
+      header->payload_bytes > sample_codec_max_bytes(header->count) ||
+      offset + blockSize(*header, version) > g_segmentSize) {
+    return BLOCK_CORRUPT;
+  }
+  return BLOCK_OK;
+}
+
+// FORMAT_PACKED / FORMAT_TIMED: walk the blocks of a segment from its header on
+static uint32_t countBlockSamples(uint16_t segment, uint32_t *usedBytes, bool *corrupt) {
+  uint32_t offset = sizeof(SegmentHeader);
+  uint32_t samples = 0;
+  BlockHeader header;
+  BlockTimes times;
+  BlockState state;
+  while ((state = readBlockHeader(segment, offset, &header, &times)) == BLOCK_OK) {
+    samples += header.count;
+    offset += blockSize(header, g_index[segment].version);
+  }
+  *usedBytes = offset;
+  *corrupt = (state == BLOCK_CORRUPT);
+  return samples;
+}
+
+static void eraseSegment(uint16_t segment) {
+  if (!fb_log_erase(segmentOffset(segment), g_segmentSize)) {
+    Serial.print("Sample log: erase failed for segment ");
+    Serial.println(segment);
+  }
+  g_index[segment].segmentSeq = 0;
+  g_index[segment].firstSample = 0;
+  g_index[segment].version = 0;
+  g_index[segment].firstTime = 0;
+}
+
+// Start appending to `segment`; schedules the erase of the one after it
+static void openSegment(uint16_t segment) {
+  if (g_erasePending == segment) {
+    // Background erase did not run in time; do it now
+    eraseSegment(segment);
+    g_erasePending = NO_SEGMENT;
+  }
+
+  SegmentHeader header;
+  header.magic = SEGMENT_MAGIC;
+  header.segment_seq = ++g_segmentSeq;
+  header.first_sample = g_pendingFirst.load(std::memory_order_relaxed);
+  header.sample_interval_ms = (uint16_t)Config::SAMPLE_INTERVAL_MS;
+  header.version = FORMAT_TIMED;
+  header.crc = checksum_crc8(&header, sizeof(header) - 1);
+  if (!fb_log_program(segmentOffset(segment), &header, sizeof(header))) {
+    Serial.print("Sample log: header program failed for segment ");
+    Serial.println(segment);
+  }
+
+  g_index[segment].segmentSeq = header.segment_seq;
+  g_index[segment].firstSample = header.first_sample;
+  g_index[segment].version = header.version;
+  g_index[segment].firstTime = 0;
+  g_active = segment;
+  g_activeUsed = sizeof(SegmentHeader);
+  g_erasePending = nextSegment(segment);
+}
+
+// Pack the pending samples into one block; a new segment when it does not fit
+static void flushBlock() {
+  g_flushPending = false;
+  uint8_t count = g_pendingCount.load(std::memory_order_relaxed);
+  if (count == 0) return;
+
+  BlockTimes times;
+  times.first_time = g_pendingTimes[0];
+  times.last_time = g_pendingTimes[count - 1];
+  uint8_t *covered = g_blockBuffer + sizeof(BlockHeader);
+  memcpy(covered, &times, sizeof(times));
+  uint8_t *payload = covered + sizeof(times);
+  size_t bytes = sample_codec_encode(g_pending, count, payload, sample_codec_max_bytes(BLOCK_SAMPLES));
+  BlockHeader header;
+  header.payload_bytes = (uint16_t)bytes;
+  header.count = count;
+  header.header_crc = checksum_crc8(&header, 3);
+  header.payload_crc = checksum_crc32(covered, sizeof(times) + bytes);
+  memcpy(g_blockBuffer, &header, sizeof(header));
+  uint32_t used = sizeof(header) + sizeof(times) + bytes;
+  uint32_t size = blockSize(header, FORMAT_TIMED);
+  memset(g_blockBuffer + used, 0, size - used);
+
+  if (g_activeUsed + size > g_segmentSize) openSegment(nextSegment(g_active));
+  if (g_activeUsed == sizeof(SegmentHeader)) g_index[g_active].firstTime = times.first_time;
+  if (!fb_log_program(segmentOffset(g_active) + g_activeUsed, g_blockBuffer, size)) {
+    Serial.println("Sample log: program failed");
+  }
+  g_activeUsed += size;
+  g_pendingCount.store(0, std::memory_order_relaxed);
+  g_pendingFirst.store(g_nextSample, std::memory_order_release); // Readers now go to flash
+}
+
+// Oldest segment still holding data (first valid one after the active segment)
+static uint16_t oldestSegment() {
+  uint16_t segment = nextSegment(g_active);
+  while (segment != g_active && g_index[segment].segmentSeq == 0) {
+    segment = nextSegment(segment);
+  }
+  return segment;
+}
+
+bool sample_log_init() {
+  g_available = false;
+  if (!fb_available()) {
+    Serial.println("Sample log: flash not available; history is RAM-only");
+    return false;
+  }
+
+  uint32_t eraseSize = fb_erase_size();
+  uint32_t programSize = fb_program_size();
+  if (eraseSize <= sizeof(SegmentHeader) + BLOCK_BUFFER_BYTES || programSize == 0 ||
+      programSize > MAX_PROGRAM_SIZE || sizeof(SegmentHeader) % programSize != 0) {
+    Serial.println("Sample log: unsupported flash geometry; history is RAM-only");
+    return false;
+  }
+
+  uint64_t regionBytes = Config::SAMPLE_LOG_REGION_BYTES;
+  if (regionBytes > (uint64_t)MAX_SEGMENTS * eraseSize) {
+    regionBytes = (uint64_t)MAX_SEGMENTS * eraseSize;
+  }
+  if (!fb_log_init(regionBytes) || fb_log_size() / eraseSize < MIN_SEGMENTS) {
+    Serial.println("Sample log: no room for log region; history is RAM-only");
+    return false;
+  }
+
+  g_segmentSize = eraseSize;
+  g_segmentCount = fb_log_size() / eraseSize;
+  g_programSize = programSize;
+  g_recordsPerSegment = (eraseSize - sizeof(SegmentHeader)) / sizeof(SampleRecord);
+  g_pendingCount = 0;
+  g_flushPending = false;
+  for (BlockReader &reader : g_readers) reader.cache.segmentSeq = 0;
+
+  // Rebuild the RAM index from the segment headers
+  uint16_t newest = NO_SEGMENT;
+  g_segmentSeq = 0;
+  for (uint16_t segment = 0; segment < g_segmentCount; segment++) {
+    SegmentHeader header;
+    if (readHeader(segment, &header)) {
+      g_index[segment].segmentSeq = header.segment_seq;
+      g_index[segment].firstSample = header.first_sample;
+      g_index[segment].version = header.version;
+      g_index[segment].firstTime = 0;
+      BlockHeader block;
+      BlockTimes times;
+      if (header.version == FORMAT_TIMED &&
+          readBlockHeader(segment, sizeof(SegmentHeader), &block, &times) == BLOCK_OK) {
+        g_index[segment].firstTime = times.first_time;
+      }
+      if (header.segment_seq > g_segmentSeq) {
+        g_segmentSeq = header.segment_seq;
+        newest = segment;
+      }
+    } else {
+      g_index[segment].segmentSeq = 0;
+      g_index[segment].firstSample = 0;
+      g_index[segment].version = 0;
+      g_index[segment].firstTime = 0;
+    }
+  }
+
+  g_available = true;
+  if (newest == NO_SEGMENT) {
+    g_nextSample = 1;
+    g_pendingFirst = 1;
+    g_erasePending = 0; // Unknown content: erase before first use
+    openSegment(0);
+    Serial.println("Sample log: empty, starting fresh");
+  } else {
+    g_active = newest;
+    if (g_index[newest].version != FORMAT_RECORDS) {
+      bool corrupt;
+      g_nextSample = g_index[newest].firstSample + countBlockSamples(newest, &g_activeUsed, &corrupt);
+      if (corrupt) g_activeUsed = g_segmentSize; // Torn block: continue in the next segment
+    } else {
+      // Older firmware: keep the records readable, append packed blocks in the next segment
+      g_nextSample = g_index[newest].firstSample + countRecords(newest);
+      g_activeUsed = g_segmentSize;
+    }
+    g_pendingFirst = g_nextSample;
+    g_erasePending = nextSegment(newest);
+    Serial.print("Sample log: recovered samples ");
+    Serial.print(sample_log_oldest_seq());
+    Serial.print("..");
+    Serial.println(sample_log_newest_seq());
+  }
+
+  Serial.print("Sample log: ");
+  Serial.print(g_segmentCount);
+  Serial.print(" segments x ");
+  Serial.print(g_segmentSize);
+  Serial.print(" bytes, blocks of ");
+  Serial.print(BLOCK_SAMPLES);
+  Serial.println(" samples");
+  return true;
+}
+
+void sample_log_encode(const int16_t *sensors, uint8_t actuators, SampleRecord *out) {
+  out->co2 = (uint16_t)sensors[0];
+  out->co2_2 = (uint16_t)sensors[1];
+  out->rh_x10 = sensors[2];
+  out->rh_2_x10 = sensors[3];
+  out->temp_x10 = sensors[4];
+  out->temp_2_x10 = sensors[5];
+  out->temp_outer_x10 = sensors[6];
+  out->actuators = actuators;
+  out->crc = checksum_crc8(out, sizeof(*out) - 1);
+}
+
+void sample_log_decode(const SampleRecord &record, int16_t *sensors) {
+  sensors[0] = (int16_t)record.co2;
+  sensors[1] = (int16_t)record.co2_2;
+  sensors[2] = record.rh_x10;
+  sensors[3] = record.rh_2_x10;
+  sensors[4] = record.temp_x10;
+  sensors[5] = record.temp_2_x10;
+  sensors[6] = record.temp_outer_x10;
+}
+
+void sample_log_append(const int16_t *sensors, uint8_t actuators, uint32_t epochS) {
+  if (!g_available) return;
+  if (g_flushPending) flushBlock(); // Background flush did not run in time; do it now
+
+  uint8_t count = g_pendingCount.load(std::memory_order_relaxed);
+  sample_log_encode(sensors, actuators, &g_pending[count]);
+  g_pendingTimes[count] = epochS;
+  g_pendingCount.store(count + 1, std::memory_order_release);
+  g_nextSample++;
+  if (count + 1 >= BLOCK_SAMPLES) g_flushPending = true;
+}
+
+void sample_log_tick() {
+  if (!g_available) return;
+  // One flash operation per call: program the full block first, erase next
+  if (g_flushPending) {
+    flushBlock();
+    return;
+  }
+  if (g_erasePending == NO_SEGMENT) return;
+  eraseSegment(g_erasePending);
+  g_erasePending = NO_SEGMENT;
+}
+
+unsigned long sample_log_next_due_ms(unsigned long now) {
+  if (!g_available || (!g_flushPending && g_erasePending == NO_SEGMENT)) return now + Config::Scheduler::MAX_IDLE_MS;
+  return now;
+}
+
+bool sample_log_available() {
+  return g_available;
+}
+
+uint32_t sample_log_oldest_seq() {
+  if (!g_available || g_nextSample <= 1) return 0;
+  uint32_t oldest = g_index[oldestSegment()].firstSample;
+  return (oldest < g_nextSample) ? oldest : 0;
+}
+
+uint32_t sample_log_newest_seq() {
+  if (!g_available || sample_log_oldest_seq() == 0) return 0;
+  return g_nextSample - 1;
+}
+
+// Decode the block of a packed segment holding `seq` into the reader's cache
+static bool loadBlock(BlockReader &reader, uint16_t segment, uint32_t seq) {
+  BlockCache &cache = reader.cache;
+  const SegmentIndex &index = g_index[segment];
+  uint32_t offset = sizeof(SegmentHeader);
+  uint32_t first = index.firstSample;
+  if (cache.segmentSeq == index.segmentSeq && cache.segment == segment && seq >= cache.firstSample) {
+    if (seq < cache.firstSample + cache.count) return cache.valid;
+    offset = cache.nextOffset; // Sequential read: continue behind the cached block
+    first = cache.firstSample + cache.count;
+  }
+
+  BlockHeader header;
+  BlockTimes times;
+  uint32_t extra = timesBytes(index.version);
+  while (readBlockHeader(segment, offset, &header, &times) == BLOCK_OK) {
+    if (seq >= first + header.count) {
+      first += header.count;
+      offset += blockSize(header, index.version);
+      continue;
+    }
+    uint32_t covered = extra + header.payload_bytes;
+    bool valid = fb_log_read(segmentOffset(segment) + offset + sizeof(BlockHeader), reader.buffer, covered) &&
+                 checksum_crc32(reader.buffer, covered) == header.payload_crc &&
+                 sample_codec_decode(reader.buffer + extra, header.payload_bytes, cache.records, header.count) ==
+                     header.count;
+    cache.segment = segment;
+    cache.segmentSeq = index.segmentSeq;
+    cache.firstSample = first;
+    cache.count = header.count;
+    cache.valid = valid;
+    cache.times = times;
+    cache.nextOffset = offset + blockSize(header, index.version);
+    return valid;
+  }
+  return false;
+}
+
+bool sample_log_read(uint32_t seq, SampleRecord *out, uint32_t *epochS, SampleLogReader reader) {
+  uint32_t oldest = sample_log_oldest_seq();
+  if (oldest == 0 || seq < oldest || seq >= g_nextSample) return false;
+
+  uint32_t pendingFirst = g_pendingFirst.load(std::memory_order_acquire);
+  if (seq >= pendingFirst) {
+    uint32_t slot = seq - pendingFirst;
+    bool present = slot < g_pendingCount.load(std::memory_order_acquire);
+    SampleRecord record = present ? g_pending[slot] : SampleRecord();
+    uint32_t time = present ? g_pendingTimes[slot] : 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (present && g_pendingFirst.load(std::memory_order_relaxed) == pendingFirst) {
+      *out = record;
+      if (epochS) *epochS = time;
+      return checksum_crc8(out, sizeof(*out) - 1) == out->crc;
+    }
+    // Flushed meanwhile (the slot may already hold a newer sample): look in flash
+  }
+
+  // Binary search the segments oldest -> active for the one holding `seq`
+  uint16_t first = oldestSegment();
+  uint16_t span = (g_active + g_segmentCount - first) % g_segmentCount + 1;
+  uint16_t lo = 0;
+  uint16_t hi = span - 1;
+  while (lo < hi) {
+    uint16_t mid = lo + (hi - lo + 1) / 2;
+    uint16_t segment = (first + mid) % g_segmentCount;
+    if (g_index[segment].segmentSeq != 0 && g_index[segment].firstSample <= seq) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  uint16_t segment = (first + lo) % g_segmentCount;
+  if (g_index[segment].version != FORMAT_RECORDS) {
+    const BlockCache &cache = g_readers[reader].cache;
+    if (!loadBlock(g_readers[reader], segment, seq)) return false;
+    uint8_t i = (uint8_t)(seq - cache.firstSample);
+    *out = cache.records[i];
+    if (epochS) *epochS = sampleTime(cache.times, i, cache.count);
+    return true;
+  }
+
+  if (epochS) *epochS = 0;
+  uint32_t record = seq - g_index[segment].firstSample;
+  if (record >= g_recordsPerSegment) return false;
+
+  if (!fb_log_read(recordOffset(segment, (uint16_t)record), out, sizeof(*out))) return false;
+  return checksum_crc8(out, sizeof(*out) - 1) == out->crc;
+}
+
+uint32_t sample_log_find_time(uint32_t epochS) {
+  uint32_t oldest = sample_log_oldest_seq();
+  if (oldest == 0) return 0;
+
+  // Sparse index: the last segment starting at or before epochS. A linear
+  // pass over RAM, so segments without a time (older formats, clock
+  // unknown) and clock steps backwards cannot mislead it.
+  uint16_t segment = NO_SEGMENT;
+  for (uint16_t s = oldestSegment();; s = nextSegment(s)) {
+    const SegmentIndex &index = g_index[s];
+    if (index.segmentSeq != 0 && index.firstTime != 0 && index.firstTime <= epochS) segment = s;
+    if (s == g_active) break;
+  }
+  if (segment == NO_SEGMENT) return oldest;
+
+  // Dense part: the block headers of that segment, first block ending at or after epochS
+  uint32_t first = g_index[segment].firstSample;
+  uint32_t offset = sizeof(SegmentHeader);
+  BlockHeader header;
+  BlockTimes times;
+  while (readBlockHeader(segment, offset, &header, &times) == BLOCK_OK) {
+    if (times.last_time >= epochS) return first;
+    first += header.count;
+    offset += blockSize(header, g_index[segment].version);
+  }
+  return (first > oldest) ? first : oldest; // Next segment or the pending block
+}
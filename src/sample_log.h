@@ -0,0 +1,141 @@
+/*
+ * *****************************************************************************
+ * SAMPLE LOG - PERSISTENT SENSOR HISTORY
+ * *****************************************************************************
+ * Log-structured append store for sample frames on the flash log region:
+ * - One segment per erase block, each starting with a SegmentHeader
+ *   (segment sequence number, first sample number, CRC8)
+ * - Fixed-point SampleRecords collected in RAM and programmed as packed
+ *   blocks of Config::SAMPLE_LOG_BLOCK_SAMPLES (sample_codec.h, about a
+ *   third of the plain size), each with a CRC; a reset loses the samples
+ *   of the unfinished block. Segments of the older formats (plain records,
+ *   blocks without times) stay readable until they are recycled.
+ * - Every block carries the wall time (wall_clock.h) of its first and last
+ *   sample. The first time of each segment forms a sparse RAM time index;
+ *   sample_log_find_time() picks the segment from it and walks only that
+ *   segment's block headers.
+ * - The segment after the active one is kept erased; erasing the oldest
+ *   segment is one erase block at a time from sample_log_tick(), never the
+ *   whole region
+ * - A RAM index of all segment headers maps sample numbers to segments;
+ *   sample_log_read() walks the block headers and keeps the last decoded
+ *   block, so sequential reads decode each block once. Each reading thread
+ *   has its own cache (SampleLogReader): the network side, and the control
+ *   side for trace replay (sensor_trace.h).
+ *
+ * Sample numbers are log-wide and continue across reboots, they are not the
+ * controller's per-boot sample sequence.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @brief One persisted sample (16 bytes, same scaling as the binary telemetry)
+ */
+struct SampleRecord {
+  uint16_t co2;             ///< ppm
+  uint16_t co2_2;           ///< ppm
+  int16_t rh_x10;           ///< % x10
+  int16_t rh_2_x10;         ///< % x10
+  int16_t temp_x10;         ///< °C x10
+  int16_t temp_2_x10;       ///< °C x10
+  int16_t temp_outer_x10;   ///< °C x10
+  uint8_t actuators;        ///< ACTUATOR_BIT_* mask
+  uint8_t crc;              ///< CRC8 over the preceding 15 bytes
+} __attribute__((packed));
+
+static_assert(sizeof(SampleRecord) == 16, "SampleRecord must be exactly 16 bytes");
+
+/**
+ * @brief Thread calling sample_log_read(), one block cache each
+ */
+enum SampleLogReader : uint8_t {
+  SAMPLE_LOG_READER_NETWORK,  ///< Export, charts, MQTT backlog
+  SAMPLE_LOG_READER_CONTROL,  ///< Trace replay in the sample task
+  SAMPLE_LOG_READER_COUNT
+};
+
+/**
+ * @brief Initialize the log and rebuild the RAM index (call after storage_init)
+ *
+ * @return true if the flash log region is available
+ */
+bool sample_log_init();
+
+/**
+ * @brief Append one sample frame
+ *
+ * @param sensors 7 fixed-point sensor values in HistorySeries order (CO2 ... temp outer)
+ * @param actuators Packed ACTUATOR_BIT_* mask
+ * @param epochS Wall time of the frame (UTC seconds, 0 = unknown)
+ */
+void sample_log_append(const int16_t *sensors, uint8_t actuators, uint32_t epochS);
+
+/**
+ * @brief Record of one sample frame, as sample_log_append() stores it
+ *
+ * The frame is already in the record's fixed point (fixed_point.h), so this
+ * only copies the values and adds the CRC.
+ */
+void sample_log_encode(const int16_t *sensors, uint8_t actuators, SampleRecord *out);
+
+/**
+ * @brief Sensor values of a record, the inverse of sample_log_encode()
+ *
+ * @param sensors 7 fixed-point values in HistorySeries order
+ */
+void sample_log_decode(const SampleRecord &record, int16_t *sensors);
+
+/**
+ * @brief Background work: program a full block, erase the next segment ahead of time (call in loop)
+ */
+void sample_log_tick();
+
+/**
+ * @brief Next deadline for the scheduler: now while a block or an erase is pending
+ */
+unsigned long sample_log_next_due_ms(unsigned long now);
+
+/**
+ * @brief Whether samples are being persisted
+ */
+bool sample_log_available();
+
+/**
+ * @brief Oldest retained sample number (0 = log empty)
+ */
+uint32_t sample_log_oldest_seq();
+
+/**
+ * @brief Newest sample number (0 = log empty)
+ */
+uint32_t sample_log_newest_seq();
+
+/**
+ * @brief Read one persisted sample
+ *
+ * @param seq Sample number between sample_log_oldest_seq() and sample_log_newest_seq()
+ * @param out Record (only valid on success)
+ * @param epochS Optional: wall time of the sample, interpolated inside its
+ *               block; 0 if unknown
+ * @param reader Calling thread, selects the block cache
+ * @return false if out of range, unreadable or the CRC does not match
+ */
+bool sample_log_read(uint32_t seq, SampleRecord *out, uint32_t *epochS = nullptr,
+                     SampleLogReader reader = SAMPLE_LOG_READER_NETWORK);
+
+/**
+ * @brief Where to start reading for samples at or after `epochS`
+ *
+ * Assumes the wall time grows with the sample number. The result is the
+ * first sample of the block the time falls into, so up to one block of
+ * earlier samples precedes it: callers compare the sample times.
+ *
+ * @return Sample number (the oldest if epochS precedes the log, past the
+ *         newest if it follows it), 0 = log empty
+ */
+uint32_t sample_log_find_time(uint32_t epochS);
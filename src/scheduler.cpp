@@ -0,0 +1,159 @@
+/*
+ * *****************************************************************************
+ * SCHEDULER IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "scheduler.h"
+#include "config.h"
+#include "memory_regions.h"
+#include "perf.h"
+
+static constexpr uint8_t MAX_TASKS = Config::Scheduler::MAX_TASKS;
+
+// Internal state
+static const SchedulerTask *g_tasks = nullptr;
+static uint8_t g_taskCount = 0;
+FAST_DATA static uint8_t g_order[MAX_TASKS];            // Task indices, highest priority first
+FAST_DATA static unsigned long g_nextRunMs[MAX_TASKS];  // Periodic due time (earliest run for event-driven tasks)
+FAST_DATA static unsigned long g_dueMs[MAX_TASKS];      // millis() at which each task is due
+FAST_DATA static unsigned long g_lastRunMs[MAX_TASKS];  // Start of the last run
+static unsigned long g_earliestDueMs = 0;     // Minimum of g_dueMs
+static SchedulerTaskStats g_stats[MAX_TASKS];
+static uint32_t g_idlePasses = 0;
+
+// Wrap-safe "a is at or after b"
+static inline bool reached(unsigned long a, unsigned long b) {
+  return (long)(a - b) >= 0;
+}
+
+// Due time of an event-driven task: its deadline, not before the period
+// allows and not later than MAX_IDLE_MS after its last run
+static unsigned long nextDue(uint8_t i, unsigned long now) {
+  unsigned long due = g_tasks[i].next(now);
+  if (reached(now, due)) due = now;
+  unsigned long latest = g_lastRunMs[i] + Config::Scheduler::MAX_IDLE_MS;
+  if (reached(due, latest)) due = latest;
+  return reached(due, g_nextRunMs[i]) ? due : g_nextRunMs[i];
+}
+
+// Runs after every active pass: any task may have created new deadlines
+static void updateDue(unsigned long now) {
+  g_earliestDueMs = now + Config::Scheduler::MAX_IDLE_MS;
+  for (uint8_t i = 0; i < g_taskCount; i++) {
+    g_dueMs[i] = (g_tasks[i].next != nullptr) ? nextDue(i, now) : g_nextRunMs[i];
+    if (!reached(g_dueMs[i], g_earliestDueMs)) g_earliestDueMs = g_dueMs[i];
+  }
+}
+
+static void idleSleep() {
+#if defined(__arm__)
+  // Any interrupt (SysTick, WiFi, UART) wakes the core again
+  __asm__ volatile("wfi");
+#endif
+}
+
+static bool idlePass() {
+  g_idlePasses++;
+  if (Config::Scheduler::IDLE_SLEEP) {
+    idleSleep();
+  }
+  return false;
+}
+
+void scheduler_init(const SchedulerTask *tasks, uint8_t count) {
+  if (count > MAX_TASKS) {
+    Serial.print("Scheduler: task table truncated to ");
+    Serial.println(MAX_TASKS);
+    count = MAX_TASKS;
+  }
+  g_tasks = tasks;
+  g_taskCount = count;
+  g_idlePasses = 0;
+
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < count; i++) {
+    g_nextRunMs[i] = now;
+    g_dueMs[i] = now;
+    g_lastRunMs[i] = now;
+    g_stats[i] = SchedulerTaskStats();
+
+    // Stable insertion sort by priority
+    uint8_t pos = i;
+    while (pos > 0 && tasks[g_order[pos - 1]].priority > tasks[i].priority) {
+      g_order[pos] = g_order[pos - 1];
+      pos--;
+    }
+    g_order[pos] = i;
+  }
+  g_earliestDueMs = now;
+
+  Serial.print("Scheduler: ");
+  Serial.print(count);
+  Serial.println(" tasks");
+}
+
+FAST_CODE bool scheduler_run_pass() {
+  unsigned long now = millis();
+  bool ran = false;
+  perf_pass(now);
+
+  // Nothing due: one comparison instead of a scan of the table
+  if (!reached(now, g_earliestDueMs)) return idlePass();
+
+  for (uint8_t k = 0; k < g_taskCount; k++) {
+    uint8_t i = g_order[k];
+    const SchedulerTask &task = g_tasks[i];
+    if (!reached(now, g_dueMs[i])) continue;
+
+    SchedulerTaskStats &stats = g_stats[i];
+    unsigned long latency = now - g_dueMs[i];
+    if (latency > stats.maxLatencyMs) stats.maxLatencyMs = latency;
+    if (task.deadlineMs != 0 && latency > task.deadlineMs) stats.deadlineMisses++;
+
+    uint32_t startUs = micros();
+    uint32_t startCycles = perf_cycles();
+    task.fn(now);
+    perf_record(i, perf_cycles() - startCycles);
+    uint32_t runUs = micros() - startUs;
+    if (runUs > stats.maxRunUs) stats.maxRunUs = runUs;
+    stats.runs++;
+    ran = true;
+
+    g_lastRunMs[i] = now;
+    if (task.next != nullptr) {
+      g_nextRunMs[i] = now + task.periodMs;
+      continue;
+    }
+
+    // Fixed rate; after an overrun skip the missed slots instead of bursting
+    g_nextRunMs[i] += task.periodMs;
+    if (reached(now, g_nextRunMs[i] + task.periodMs)) {
+      g_nextRunMs[i] = now + task.periodMs;
+    }
+  }
+
+  if (!ran) return idlePass();
+  updateDue(now);
+  return true;
+}
+
+unsigned long scheduler_next_due_ms() {
+  return g_earliestDueMs;
+}
+
+uint8_t scheduler_task_count() {
+  return g_taskCount;
+}
+
+const SchedulerTask *scheduler_task(uint8_t index) {
+  return (index < g_taskCount) ? &g_tasks[index] : nullptr;
+}
+
+const SchedulerTaskStats *scheduler_task_stats(uint8_t index) {
+  return (index < g_taskCount) ? &g_stats[index] : nullptr;
+}
+
+uint32_t scheduler_idle_passes() {
+  return g_idlePasses;
+}
@@ -0,0 +1,108 @@
+/*
+ * *****************************************************************************
+ * SCHEDULER - COOPERATIVE STATIC TASK TABLE
+ * *****************************************************************************
+ * Replaces the fixed call order in loop():
+ * - Tasks are a static table (see main.cpp), each with its own period,
+ *   deadline and priority
+ * - One pass reads millis() once and runs every due task in priority order,
+ *   so control state machines always run before web or flash work
+ * - A task that starts later than its deadline after becoming due counts as
+ *   a deadline miss; latency and run time are tracked per task
+ * - Event-driven tasks also name their next pending deadline (`next`); they
+ *   only run when it is reached instead of polling every period
+ * - The earliest due time of all tasks is cached, so a pass with nothing due
+ *   costs one comparison; scheduler_next_due_ms() tells loop() how long it
+ *   may sleep
+ * - Optionally sleeps (WFI) until the next interrupt when nothing is due
+ * - With -DCC_PERF=1 every run is also timed in cycles (perf.h)
+ *
+ * Tasks must not block: a long task delays every task behind it.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @brief Task entry point
+ *
+ * @param now millis() of the current scheduler pass (shared by all tasks)
+ */
+typedef void (*SchedulerTaskFn)(unsigned long now);
+
+/**
+ * @brief Next deadline of an event-driven task
+ *
+ * Called after every pass that ran a task, so state changes made by any task
+ * are seen before the next pass. Return `now` (or earlier) if there is work,
+ * `now + Config::Scheduler::MAX_IDLE_MS` if nothing is pending.
+ *
+ * @param now millis() of the pass that just ran
+ * @return millis() at which the task has work again
+ */
+typedef unsigned long (*SchedulerNextFn)(unsigned long now);
+
+/**
+ * @brief One entry of the static task table
+ */
+struct SchedulerTask {
+  const char *name;          ///< For logs and statistics
+  SchedulerTaskFn fn;        ///< Entry point
+  uint8_t priority;          ///< 0 = highest; ties keep table order
+  unsigned long periodMs;    ///< Run interval (0 = every pass); minimum spacing if `next` is set
+  unsigned long deadlineMs;  ///< Allowed start latency after becoming due (0 = none)
+  SchedulerNextFn next;      ///< Next deadline (nullptr = periodic), run at least every MAX_IDLE_MS
+};
+
+/**
+ * @brief Runtime statistics of one task
+ */
+struct SchedulerTaskStats {
+  uint32_t runs;               ///< Completed runs
+  uint32_t deadlineMisses;     ///< Runs started later than deadlineMs
+  unsigned long maxLatencyMs;  ///< Worst start latency after becoming due
+  uint32_t maxRunUs;           ///< Worst run time
+};
+
+/**
+ * @brief Register the task table (call once at the end of setup)
+ *
+ * @param tasks Table, must outlive the scheduler
+ * @param count Entries (at most Config::Scheduler::MAX_TASKS)
+ */
+void scheduler_init(const SchedulerTask *tasks, uint8_t count);
+
+/**
+ * @brief Run one pass: every due task once, highest priority first (call in loop)
+ *
+ * @return false if no task was due (idle pass)
+ */
+bool scheduler_run_pass();
+
+/**
+ * @brief millis() at which the next task becomes due (may be in the past)
+ */
+unsigned long scheduler_next_due_ms();
+
+/**
+ * @brief Number of registered tasks
+ */
+uint8_t scheduler_task_count();
+
+/**
+ * @brief Table entry of task `index` (registration order), nullptr if out of range
+ */
+const SchedulerTask *scheduler_task(uint8_t index);
+
+/**
+ * @brief Statistics of task `index` (registration order), nullptr if out of range
+ */
+const SchedulerTaskStats *scheduler_task_stats(uint8_t index);
+
+/**
+ * @brief Passes in which no task was due
+ */
+uint32_t scheduler_idle_passes();
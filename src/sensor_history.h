@@ -0,0 +1,162 @@
+/*
+ * *****************************************************************************
+ * SENSOR HISTORY - STRUCTURE-OF-ARRAYS RING BUFFER
+ * *****************************************************************************
+ * One ring for all history channels:
+ * - Single shared head/count, so every channel always holds the same samples
+ * - Power-of-two capacity (index wrap is a mask, not a modulo)
+ * - Channel-major layout: each channel is one contiguous array of int16
+ *   fixed-point values (fixed_point.h: ppm, 0.1 %RH, 0.1 °C)
+ * - snapshot() + spans() hand out at most two contiguous spans per channel
+ *   instead of copying
+ * - On/off states are bit-packed into one 8-bit state word per sample
+ * - Every push is stamped with a monotonically increasing sequence number
+ *
+ * Sample `s` lives at ring index (s - 1) & MASK, so the sequence number is the
+ * only shared index: push() writes the frame first and then publishes the new
+ * sequence number (release), readers load it once (acquire). A reader on
+ * another thread sees complete frames and never a torn head/count pair; a
+ * frame stays valid until the writer laps it (CAPACITY samples later).
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Contiguous run of samples of one channel
+ */
+struct HistorySpan {
+  const int16_t *data;  ///< First sample (oldest first)
+  uint16_t length;      ///< Number of samples
+};
+
+/**
+ * @brief Contiguous run of packed state words
+ */
+struct HistoryStateSpan {
+  const uint8_t *data;  ///< First state word (oldest first)
+  uint16_t length;      ///< Number of samples
+};
+
+/**
+ * @brief Consistent view of the newest samples of all channels
+ *
+ * Only describes positions; values are read through SensorHistory::spans().
+ */
+struct HistorySnapshot {
+  uint32_t seq;      ///< Sequence number of the newest sample (0 = empty)
+  uint16_t count;    ///< Samples in the snapshot
+  uint16_t start;    ///< Ring index of the oldest sample
+};
+
+template<uint8_t CHANNELS, uint16_t CAPACITY>
+class SensorHistory {
+  static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0,
+                "SensorHistory capacity must be a power of two");
+
+private:
+  static constexpr uint16_t MASK = CAPACITY - 1;
+
+  int16_t values[CHANNELS][CAPACITY]; // Channel-major, one contiguous array per channel
+  uint8_t states[CAPACITY];           // Packed on/off states, 1 bit per output
+  std::atomic<uint32_t> seq;          // Sequence number of the newest sample
+
+  static uint16_t countFor(uint32_t newest) {
+    return (newest < CAPACITY) ? (uint16_t)newest : CAPACITY;
+  }
+
+public:
+  SensorHistory() : seq(0) {
+    memset(values, 0, sizeof(values));
+    memset(states, 0, sizeof(states));
+  }
+
+  static constexpr uint16_t capacity() { return CAPACITY; }
+
+  // Append one sample frame (one value per channel + packed state word)
+  void push(const int16_t (&frame)[CHANNELS], uint8_t stateWord) {
+    uint32_t next = seq.load(std::memory_order_relaxed) + 1;
+    uint16_t i = indexOf(next);
+    for (uint8_t ch = 0; ch < CHANNELS; ch++) {
+      values[ch][i] = frame[ch];
+    }
+    states[i] = stateWord;
+    seq.store(next, std::memory_order_release); // Publish after the frame is complete
+  }
+
+  uint16_t size() const { return countFor(newestSeq()); }
+  uint32_t newestSeq() const { return seq.load(std::memory_order_acquire); }
+
+  // True if sample `s` is still held by the ring
+  bool contains(uint32_t s) const {
+    uint32_t newest = newestSeq();
+    return s != 0 && s <= newest && (newest - s) < CAPACITY;
+  }
+
+  // Value of sample `s`; 0 if not yet pushed, oldest retained if overwritten
+  int16_t at(uint8_t channel, uint32_t s) const {
+    uint32_t newest = newestSeq();
+    if (s == 0 || s > newest) return 0;
+    return values[channel][indexOf(clampToRetained(s, newest))];
+  }
+
+  // State word of sample `s`, same rules as at()
+  uint8_t stateAt(uint32_t s) const {
+    uint32_t newest = newestSeq();
+    if (s == 0 || s > newest) return 0;
+    return states[indexOf(clampToRetained(s, newest))];
+  }
+
+  // Newest `maxCount` samples (fewer while the ring is filling up)
+  HistorySnapshot snapshot(uint16_t maxCount) const {
+    HistorySnapshot snap;
+    snap.seq = newestSeq();
+    uint16_t count = countFor(snap.seq);
+    snap.count = (maxCount < count) ? maxCount : count;
+    snap.start = (uint16_t)(snap.seq - snap.count) & MASK;
+    return snap;
+  }
+
+  // Spans of one channel covering a snapshot, oldest -> newest.
+  // Returns the number of spans written (0, 1 or 2).
+  uint8_t spans(const HistorySnapshot &snap, uint8_t channel, HistorySpan out[2]) const {
+    if (snap.count == 0) return 0;
+    const int16_t *base = values[channel];
+    uint16_t firstLen = CAPACITY - snap.start;
+    if (firstLen >= snap.count) {
+      out[0] = {base + snap.start, snap.count};
+      return 1;
+    }
+    out[0] = {base + snap.start, firstLen};
+    out[1] = {base, (uint16_t)(snap.count - firstLen)};
+    return 2;
+  }
+
+  // Spans of the packed state words covering a snapshot, oldest -> newest
+  uint8_t stateSpans(const HistorySnapshot &snap, HistoryStateSpan out[2]) const {
+    if (snap.count == 0) return 0;
+    uint16_t firstLen = CAPACITY - snap.start;
+    if (firstLen >= snap.count) {
+      out[0] = {states + snap.start, snap.count};
+      return 1;
+    }
+    out[0] = {states + snap.start, firstLen};
+    out[1] = {states, (uint16_t)(snap.count - firstLen)};
+    return 2;
+  }
+
+private:
+  // Ring index of sample `s` (s >= 1)
+  static uint16_t indexOf(uint32_t s) {
+    return (uint16_t)(s - 1) & MASK;
+  }
+
+  // Oldest retained sample if `s` has been overwritten (1 <= s <= newest)
+  static uint32_t clampToRetained(uint32_t s, uint32_t newest) {
+    return (newest - s >= CAPACITY) ? newest - CAPACITY + 1 : s;
+  }
+};
@@ -0,0 +1,150 @@
+/*
+ * *****************************************************************************
+ * SENSOR TRACE IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "sensor_trace.h"
+
+#if CC_TRACE
+
+#include <atomic>
+#include "event_log.h"
+#include "sample_log.h"
+#include "seqlock.h"
+
+static constexpr uint32_t STOP_REQUEST = 0;  // firstSeq of a stop request
+
+// Network -> control: range, published by bumping the generation last
+static std::atomic<uint32_t> g_requestFirst(0);
+static std::atomic<uint32_t> g_requestLast(0);
+static std::atomic<uint32_t> g_requestGen(0);
+
+// Control side (sample task)
+static uint32_t g_seenGen = 0;
+static unsigned long g_startMs = 0;    // Chamber time of frame 0
+static uint32_t g_loadedSeq = 0;       // Record in g_frame, 0 = none
+static Sensors g_frame = {};
+static bool g_frameUsed = false;       // Since the last sensor_trace_pass()
+static TraceStatus g_local = {};       // Writer-side copy
+static SeqLock<TraceStatus> g_published;
+
+static void publish() {
+  g_published.write(g_local);
+}
+
+bool sensor_trace_request(uint32_t firstSeq, uint32_t lastSeq) {
+  uint32_t oldest = sample_log_oldest_seq();
+  if (firstSeq == STOP_REQUEST || lastSeq < firstSeq || oldest == 0 || firstSeq < oldest ||
+      lastSeq > sample_log_newest_seq()) {
+    return false;
+  }
+  g_requestFirst.store(firstSeq, std::memory_order_relaxed);
+  g_requestLast.store(lastSeq, std::memory_order_relaxed);
+  g_requestGen.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+void sensor_trace_request_stop() {
+  g_requestFirst.store(STOP_REQUEST, std::memory_order_relaxed);
+  g_requestGen.fetch_add(1, std::memory_order_release);
+}
+
+static void finish(TraceState state) {
+  g_local.state = state;
+  publish();
+  if (state == TRACE_DONE) {
+    uint32_t actions = 0;
+    for (uint8_t a = 0; a < ACTION_COUNT; a++) actions += g_local.report.actions(a);
+    event_log(EVT_TRACE_DONE, (int32_t)g_local.report.samples(), (int32_t)actions,
+              (int32_t)g_local.report.passMaxUs());
+  } else {
+    event_log(EVT_TRACE_STOPPED, (int32_t)g_local.report.samples());
+  }
+}
+
+// Take over a new request; a request changed while being read waits for the next call
+static void applyRequest(unsigned long now) {
+  uint32_t gen = g_requestGen.load(std::memory_order_acquire);
+  if (gen == g_seenGen) return;
+  uint32_t first = g_requestFirst.load(std::memory_order_relaxed);
+  uint32_t last = g_requestLast.load(std::memory_order_relaxed);
+  if (g_requestGen.load(std::memory_order_acquire) != gen) return;
+  g_seenGen = gen;
+
+  if (g_local.state == TRACE_RUNNING) finish(TRACE_STOPPED);
+  if (first == STOP_REQUEST) return;
+
+  g_local = TraceStatus();
+  g_local.state = TRACE_RUNNING;
+  g_local.firstSeq = first;
+  g_local.lastSeq = last;
+  g_startMs = now;
+  g_loadedSeq = 0;
+  publish();
+  event_log(EVT_TRACE_START, (int32_t)first, (int32_t)last);
+}
+
+bool sensor_trace_frame(unsigned long now, Sensors *out) {
+  applyRequest(now);
+  if (g_local.state != TRACE_RUNNING) return false;
+
+  uint32_t index = (uint32_t)((now - g_startMs) / Config::SAMPLE_INTERVAL_MS);
+  if (index > g_local.lastSeq - g_local.firstSeq) {
+    finish(TRACE_DONE);
+    return false;
+  }
+  uint32_t seq = g_local.firstSeq + index;
+  if (seq != g_loadedSeq) {
+    SampleRecord record;
+    if (sample_log_read(seq, &record, nullptr, SAMPLE_LOG_READER_CONTROL)) {
+      sample_log_decode(record, g_frame.value);
+    } else {
+      g_local.unreadable++; // Corrupt or already recycled: hold the previous frame
+    }
+    g_loadedSeq = seq;
+    g_local.frames = index + 1;
+  }
+  g_frameUsed = true;
+  *out = g_frame;
+  return true;
+}
+
+bool sensor_trace_active() {
+  return g_local.state == TRACE_RUNNING;
+}
+
+static bool within(int32_t value, int32_t setpoint, int32_t band) {
+  return value - setpoint <= band && setpoint - value <= band;
+}
+
+void sensor_trace_sample(const int16_t *sensors, uint8_t actuators, uint16_t co2Setpoint, int16_t rhSetpoint_x10,
+                         int16_t tempSetpoint_x10) {
+  if (g_local.state != TRACE_RUNNING) return;
+  uint8_t inBand = 0;
+  if (sensors[SERIES_CO2] <= (int32_t)co2Setpoint + Config::CO2::CONTROL_THRESHOLD) inBand |= 1u << TRACE_BAND_CO2;
+  if (within(sensors[SERIES_RH], rhSetpoint_x10, fixed_tenths(Config::Humidity::HYSTERESIS_BAND))) {
+    inBand |= 1u << TRACE_BAND_RH;
+  }
+  if (within(sensors[SERIES_TEMP], tempSetpoint_x10, fixed_tenths(Config::Control::TEMP_SETTLE_BAND))) {
+    inBand |= 1u << TRACE_BAND_TEMP;
+  }
+  g_local.report.addSample(actuators, inBand, Config::SAMPLE_INTERVAL_MS);
+  publish();
+}
+
+void sensor_trace_action(uint8_t action) {
+  if (g_local.state == TRACE_RUNNING) g_local.report.addAction(action);
+}
+
+void sensor_trace_pass(uint32_t startUs) {
+  if (!g_frameUsed) return;
+  g_frameUsed = false;
+  if (g_local.state == TRACE_RUNNING) g_local.report.addPass(micros() - startUs);
+}
+
+void sensor_trace_status(TraceStatus *out) {
+  g_published.read(out);
+}
+
+#endif // CC_TRACE
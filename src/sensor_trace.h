@@ -0,0 +1,136 @@
+/*
+ * *****************************************************************************
+ * SENSOR TRACE - RECORD AND REPLAY OF SENSOR FRAMES
+ * *****************************************************************************
+ * Reruns the controller on recorded input, so control changes can be
+ * benchmarked against each other on the same data:
+ * - Recording: chamber 0's frames already go to the flash sample log (and
+ *   the USB stick, FORMAT_BINARY) as 16-byte SampleRecords, real or
+ *   simulated; a simulated scenario repeats itself from
+ *   Config::Simulation::SEED (xorshift.h)
+ * - Replay (-DCC_TRACE=1): POST /api/trace picks a range of the sample log;
+ *   chamber 0 then reads record n instead of its sensors from chamber time
+ *   start + n * SAMPLE_INTERVAL_MS on. Config::Trace::SPEED runs the chamber
+ *   clock in real time (1x) or stepped (as fast as the CPU allows); both
+ *   give the same control decisions.
+ * - While replaying, chamber 0's samples are not appended to the flash log
+ *   (the trace stays intact); the USB stick records the run's output
+ * - Run report (run_report.h): actuator duty and switch-ons, time in band
+ *   of CO2 / RH / temperature, actions started, run time of the sample
+ *   passes that consumed a trace frame; GET /api/trace, and one event when
+ *   the run ends
+ *
+ * The replay reads the log through its own block cache
+ * (SAMPLE_LOG_READER_CONTROL) in the sample task. Requests come from the
+ * network side through atomics; the status is published through a seqlock.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "action_recipes.h"
+#include "channels.h"
+#include "config.h"
+#include "controller.h"
+#include "run_report.h"
+
+/**
+ * @brief Quantities of the time-in-band report
+ */
+enum TraceBand : uint8_t {
+  TRACE_BAND_CO2,   ///< At most Config::CO2::CONTROL_THRESHOLD above the setpoint
+  TRACE_BAND_RH,    ///< Within Config::Humidity::HYSTERESIS_BAND
+  TRACE_BAND_TEMP,  ///< Within Config::Control::TEMP_SETTLE_BAND
+  TRACE_BAND_COUNT
+};
+
+typedef RunReport<ACTUATOR_COUNT, ACTION_COUNT, TRACE_BAND_COUNT> TraceReport;
+
+enum TraceState : uint8_t {
+  TRACE_IDLE,      ///< No run since boot
+  TRACE_RUNNING,
+  TRACE_DONE,      ///< Last frame replayed
+  TRACE_STOPPED    ///< Stopped by request before the end
+};
+
+/**
+ * @brief Replay progress and the report of the current or last run
+ */
+struct TraceStatus {
+  TraceState state;
+  uint32_t firstSeq;       ///< Replayed sample log range
+  uint32_t lastSeq;
+  uint32_t frames;         ///< Records replayed so far
+  uint32_t unreadable;     ///< Records that failed their CRC (previous frame held)
+  TraceReport report;
+};
+
+#if CC_TRACE
+
+/**
+ * @brief Replay sample log records firstSeq..lastSeq into chamber 0 (network side)
+ *
+ * Replaces a running replay; taken over by the next sensor read.
+ *
+ * @return false if the range is empty or not (any longer) in the log
+ */
+bool sensor_trace_request(uint32_t firstSeq, uint32_t lastSeq);
+
+/**
+ * @brief Stop a running replay (network side)
+ */
+void sensor_trace_request_stop();
+
+/**
+ * @brief Trace frame for chamber time `now`, instead of the sensors (chamber 0)
+ *
+ * @return false if no replay is running
+ */
+bool sensor_trace_frame(unsigned long now, Sensors *out);
+
+/**
+ * @brief A replay is running (the sample log is not appended to)
+ */
+bool sensor_trace_active();
+
+/**
+ * @brief Account one history sample of chamber 0 in the run report
+ */
+void sensor_trace_sample(const int16_t *sensors, uint8_t actuators, uint16_t co2Setpoint, int16_t rhSetpoint_x10,
+                         int16_t tempSetpoint_x10);
+
+/**
+ * @brief Count an action started by chamber 0
+ */
+void sensor_trace_action(uint8_t action);
+
+/**
+ * @brief Start of a sample pass (µs), for sensor_trace_pass()
+ */
+inline uint32_t sensor_trace_us() { return micros(); }
+
+/**
+ * @brief End of a sample pass: timed if it consumed a trace frame
+ */
+void sensor_trace_pass(uint32_t startUs);
+
+/**
+ * @brief Copy the published status (any thread)
+ */
+void sensor_trace_status(TraceStatus *out);
+
+#else
+
+inline bool sensor_trace_request(uint32_t, uint32_t) { return false; }
+inline void sensor_trace_request_stop() {}
+inline bool sensor_trace_frame(unsigned long, Sensors *) { return false; }
+inline bool sensor_trace_active() { return false; }
+inline void sensor_trace_sample(const int16_t *, uint8_t, uint16_t, int16_t, int16_t) {}
+inline void sensor_trace_action(uint8_t) {}
+inline uint32_t sensor_trace_us() { return 0; }
+inline void sensor_trace_pass(uint32_t) {}
+inline void sensor_trace_status(TraceStatus *out) { *out = TraceStatus(); }
+
+#endif
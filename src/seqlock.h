@@ -0,0 +1,60 @@
+/*
+ * *****************************************************************************
+ * SEQLOCK - SINGLE-WRITER SNAPSHOT CELL
+ * *****************************************************************************
+ * Publishes one small value from a single writer to any number of readers:
+ * - The writer bumps an odd version, copies the value and bumps it even again;
+ *   it never waits
+ * - A reader copies the value and retries if the version was odd or changed,
+ *   so it always ends up with one complete publish, never a mix of two
+ * - No lock, no interrupt masking; a read costs one copy of T
+ *
+ * The writer must not be preempted by a reader of the same cell (e.g. write
+ * from an ISR that also reads), otherwise the reader spins until the write
+ * finishes. Here the writer is the control loop, the readers run at the same
+ * or lower priority.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+template<typename T>
+class SeqLock {
+private:
+  T value;
+  std::atomic<uint32_t> version;  // Odd while a write is in progress
+
+public:
+  SeqLock() : value(), version(0) {}
+
+  // Writer side (one writer only)
+  void write(const T &v) {
+    uint32_t ver = version.load(std::memory_order_relaxed);
+    version.store(ver + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    value = v;
+    version.store(ver + 2, std::memory_order_release);
+  }
+
+  // Reader side; returns how often the read had to be retried
+  uint16_t read(T *out) const {
+    uint16_t retries = 0;
+    while (true) {
+      uint32_t before = version.load(std::memory_order_acquire);
+      if ((before & 1) == 0) {
+        *out = value;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version.load(std::memory_order_relaxed) == before) return retries;
+      }
+      if (retries < 0xFFFF) retries++;
+    }
+  }
+
+  // Number of completed writes
+  uint32_t writes() const {
+    return version.load(std::memory_order_acquire) / 2;
+  }
+};
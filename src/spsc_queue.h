@@ -0,0 +1,73 @@
+/*
+ * *****************************************************************************
+ * SPSC QUEUE - LOCK-FREE SINGLE-PRODUCER / SINGLE-CONSUMER RING
+ * *****************************************************************************
+ * Fixed-capacity FIFO between exactly one producer and one consumer context
+ * (thread, core or ISR):
+ * - Only the producer writes `tail`, only the consumer writes `head`
+ * - Acquire/release ordering publishes the element before the index, so no
+ *   lock, no critical section and no interrupt masking is needed
+ * - Never blocks: push() fails when full, pop() fails when empty
+ * - pushAll() publishes a batch with one index update (all or nothing)
+ * - Same power-of-two indexing as SensorHistory; one slot stays free to tell
+ *   full from empty
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+template<typename T, uint16_t CAPACITY>
+class SpscQueue {
+  static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                "SpscQueue capacity must be a power of two");
+
+private:
+  static constexpr uint16_t MASK = CAPACITY - 1;
+
+  T items[CAPACITY];
+  std::atomic<uint16_t> head;  // Next element to pop (consumer)
+  std::atomic<uint16_t> tail;  // Next free slot (producer)
+
+public:
+  SpscQueue() : head(0), tail(0) {}
+
+  // Producer side; returns false (and drops `item`) when full
+  bool push(const T &item) {
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    uint16_t next = (t + 1) & MASK;
+    if (next == head.load(std::memory_order_acquire)) return false;
+    items[t] = item;
+    tail.store(next, std::memory_order_release);
+    return true;
+  }
+
+  // Producer side; all `count` items or none. The consumer sees them at
+  // once, there is only one tail publish.
+  bool pushAll(const T *batch, uint16_t count) {
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    uint16_t used = (t - head.load(std::memory_order_acquire)) & MASK;
+    if (count > CAPACITY - 1 - used) return false;
+    for (uint16_t i = 0; i < count; i++) items[(t + i) & MASK] = batch[i];
+    tail.store((t + count) & MASK, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side; returns false when empty
+  bool pop(T *out) {
+    uint16_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) return false;
+    *out = items[h];
+    head.store((h + 1) & MASK, std::memory_order_release);
+    return true;
+  }
+
+  // Either side; a snapshot that may be stale by the time it is used
+  bool empty() const {
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+  }
+
+  static constexpr uint16_t capacity() { return CAPACITY - 1; }
+};
@@ -5,48 +5,348 @@
  */
 
 #include "storage.h"
+#include "config.h"
+#include "checksum.h"
 #include "flash_ringbuffer.h"
+#include "memory_regions.h"
+#include <stddef.h>
+
+// Setting definition: stable key, fixed-point scale, range and default
+struct SettingDef {
+  SettingKey key;
+  const char *name;
+  uint8_t decimals;     // raw = value * 10^decimals
+  int32_t minRaw;
+  int32_t maxRaw;
+  int32_t defaultRaw;
+  int8_t legacyIndex;   // Position in the legacy values[] array, -1 = none
+  bool boardWide;       // One value for all chambers
+};
+
+// Registry (index == key). Append new tunables at the end.
+static constexpr SettingDef SETTING_DEFS[SETTING_COUNT] = {
+  {SETTING_COUNTER, "counter", 0, 0, 65535, 0, 0, true},
+  {SETTING_CO2_SETPOINT, "co2_setpoint", 0, 400, 10000, 800, 1, false},
+  {SETTING_RH_SETPOINT, "rh_setpoint", 1, 820, 960, 890, 2, false},
+  {SETTING_TEMP_SETPOINT, "temp_setpoint", 1, 180, 320, 250, 3, false},
+  {SETTING_HEATER_MODE, "heater_mode", 0, 0, 1, 0, -1, false},
+  {SETTING_HEATER_KP, "heater_kp", 2, 0, 1000, 25, -1, false},
+  {SETTING_HEATER_KI, "heater_ki", 4, 0, 10000, 20, -1, false},
+  {SETTING_HEATER_KD, "heater_kd", 1, 0, 1000, 0, -1, false},
+  {SETTING_FOGGER_MODE, "fogger_mode", 0, 0, 1, 0, -1, false},
+  {SETTING_FOGGER_KP, "fogger_kp", 2, 0, 1000, 10, -1, false},
+  {SETTING_FOGGER_KI, "fogger_ki", 4, 0, 10000, 5, -1, false},
+  {SETTING_CO2_LIMIT, "co2_limit", 0, 1000, 10000, 2500, -1, false},
+  {SETTING_TEMP_LIMIT, "temp_limit", 1, 200, 600, 380, -1, false},
+  {SETTING_FOGGER_ON_S, "fogger_on_s", 0, 0, INT32_MAX, 0, -1, true},
+  {SETTING_SWIRLER_ON_S, "swirler_on_s", 0, 0, INT32_MAX, 0, -1, true},
+  {SETTING_FRESHAIR_ON_S, "freshair_on_s", 0, 0, INT32_MAX, 0, -1, true},
+  {SETTING_HEATER_ON_S, "heater_on_s", 0, 0, INT32_MAX, 0, -1, true},
+  {SETTING_FOGGER_SWITCHES, "fogger_switches", 0, 0, INT32_MAX, 0, -1, true},
+  {SETTING_SWIRLER_SWITCHES, "swirler_switches", 0, 0, INT32_MAX, 0, -1, true},
+  {SETTING_FRESHAIR_SWITCHES, "freshair_switches", 0, 0, INT32_MAX, 0, -1, true},
+  {SETTING_HEATER_SWITCHES, "heater_switches", 0, 0, INT32_MAX, 0, -1, true},
+};
+
+static constexpr uint8_t countChamberScoped(uint8_t from = 0) {
+  return (from >= SETTING_COUNT) ? 0 : (uint8_t)(!SETTING_DEFS[from].boardWide + countChamberScoped(from + 1));
+}
+
+// One persisted key/value pair
+struct SettingEntry {
+  uint8_t key;       // SettingKey
+  uint8_t reserved;  // 0
+  uint16_t changes;  // Effective changes of this key (saturating)
+  int32_t value;     // Raw fixed-point value
+} __attribute__((packed));
+
+static constexpr uint16_t SETTINGS_MAGIC = 0x5453; // "ST"
+static constexpr uint8_t MAX_SLOT_ENTRIES = (RING_BUFFER_SLOT_SIZE - 16) / sizeof(SettingEntry);
+
+// Chamber namespaces: chamber c stores key k under id c * CHAMBER_KEY_STRIDE + k.
+// Chamber 0 keeps the plain ids, so single-chamber images read unchanged and
+// older firmware skips the other chambers as unknown keys.
+static constexpr uint8_t CHAMBERS = Config::Chambers::COUNT;
+static constexpr uint8_t CHAMBER_KEY_STRIDE = 32;
+static constexpr uint8_t CHAMBER_SCOPED_KEYS = countChamberScoped();
+static constexpr uint8_t IMAGE_ENTRIES = SETTING_COUNT + (CHAMBERS - 1) * CHAMBER_SCOPED_KEYS;
+static_assert(SETTING_COUNT <= CHAMBER_KEY_STRIDE, "Setting ids must stay below the chamber stride");
+static_assert((uint16_t)Config::Chambers::MAX_COUNT * CHAMBER_KEY_STRIDE <= 256, "Entry ids are one byte");
+static_assert(SETTING_COUNT + (Config::Chambers::MAX_COUNT - 1) * CHAMBER_SCOPED_KEYS <= MAX_SLOT_ENTRIES,
+              "Settings image does not fit into one slot");
+
+// Data structure: one full settings image per slot
+struct SettingsSlot {
+  uint32_t sequence;        // Highest = newest (first field: probed by the binary search)
+  uint16_t magic;           // SETTINGS_MAGIC
+  uint8_t schema_version;   // SETTINGS_SCHEMA_VERSION of the writer
+  uint8_t count;            // Used entries
+  uint32_t total_changes;   // Effective changes of all keys
+  SettingEntry entries[MAX_SLOT_ENTRIES];
+  uint32_t crc;             // CRC-32 over everything before this field
+} __attribute__((packed));
+
+static_assert(sizeof(SettingsSlot) == RING_BUFFER_SLOT_SIZE, "SettingsSlot must fill one slot");
 
-// Data structure: 64 bytes per slot
-struct DataEntry {
-  uint32_t sequence;   // 4 bytes - sequence number (highest = newest)
-  uint16_t values[10]; // 20 bytes - 10 × 10-bit values (stored as uint16_t)
-  uint8_t crc;         // 1 byte - CRC8 checksum
-  uint8_t padding[39]; // 39 bytes - padding to 64 bytes
+// Previous slot layout (64-byte DataEntry, 100 slots), read once for migration
+struct LegacyEntry {
+  uint32_t sequence;
+  uint16_t values[10];
+  uint8_t crc;         // CRC8 over the first 24 bytes
+  uint8_t padding[39];
 } __attribute__((packed));
 
-static_assert(sizeof(DataEntry) == 64, "DataEntry must be exactly 64 bytes");
+static_assert(sizeof(LegacyEntry) == 64, "LegacyEntry must be exactly 64 bytes");
+static constexpr uint32_t LEGACY_NUM_SLOTS = 100;
 
 // Internal state
-static uint8_t g_ringBuffer[RING_BUFFER_TOTAL_SIZE];
+EXT_DATA static uint8_t g_ringBuffer[RING_BUFFER_TOTAL_SIZE]; // Only read without flash: SDRAM with placement
 static bool g_storageInitialized = false;
 static uint32_t g_currentSlot = 0;
 static bool g_flashAvailable = false;
 
-// Application data
-static uint16_t g_values[NUM_VALUES] = {0};
+// Sector erase ahead of the write position (flash only)
+static constexpr uint32_t NO_SECTOR = 0xFFFFFFFF;
+static uint32_t g_slotsPerSector = 0;
+static uint32_t g_numSectors = 0;
+static uint32_t g_pendingEraseSector = NO_SECTOR;
+
+// Application data, per chamber (board-wide keys live in chamber 0 only)
+static int32_t g_settings[CHAMBERS][SETTING_COUNT];
+static int32_t g_persisted[CHAMBERS][SETTING_COUNT];   // Values in the newest slot
+static uint16_t g_changes[CHAMBERS][SETTING_COUNT];
+static uint32_t g_totalChanges = 0;
+static uint32_t g_sequence = 0;              // Sequence of the newest slot
+static uint16_t g_values[NUM_VALUES] = {0};  // Legacy view
 static bool g_valuesDirty = false;
+static unsigned long g_firstChangeMs = 0;
 static unsigned long g_lastValueChangeMs = 0;
 
 // Forward declarations
-static uint8_t crc8(const void *data, size_t len);
 static void saveDataToRingBuffer();
+static void scheduleEraseAhead(uint32_t slot);
+
+static uint32_t sectorOf(uint32_t slot) {
+  return (g_slotsPerSector > 0) ? slot / g_slotsPerSector : 0;
+}
+
+static bool readSlot(uint32_t slot, SettingsSlot *out) {
+  if (!g_flashAvailable) {
+    memcpy(out, g_ringBuffer + slot * RING_BUFFER_SLOT_SIZE, RING_BUFFER_SLOT_SIZE);
+    return true;
+  }
+  return fb_read_slot(slot, out, RING_BUFFER_SLOT_SIZE);
+}
+
+static bool slotErased(uint32_t slot) {
+  SettingsSlot probe;
+  if (!readSlot(slot, &probe)) return false;
+  const uint8_t *p = (const uint8_t *)&probe;
+  for (size_t i = 0; i < RING_BUFFER_SLOT_SIZE; ++i) {
+    if (p[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+// `slot` holds the newest entry: erase the following sector from
+// storage_tick() so it is clean before the write position gets there
+static void scheduleEraseAhead(uint32_t slot) {
+  if (!g_flashAvailable || g_numSectors < 2) return;
+  g_pendingEraseSector = (sectorOf(slot) + 1) % g_numSectors;
+}
+
+static void eraseSector(uint32_t sector) {
+  unsigned long start = millis();
+  if (!fb_erase_sector(sector)) {
+    Serial.print("Flash erase failed for sector ");
+    Serial.println(sector);
+    return;
+  }
+  Serial.print("Erased flash sector ");
+  Serial.print(sector);
+  Serial.print(" (");
+  Serial.print(millis() - start);
+  Serial.println(" ms)");
+}
+
+// Make g_currentSlot writable without touching the sector holding the newest
+// entry (in `prevSlot`): if the slot is dirty, skip to the next sector
+static void prepareSlotForWrite(uint32_t prevSlot) {
+  if (g_pendingEraseSector == sectorOf(g_currentSlot)) {
+    // Background erase did not run in time; do it now
+    eraseSector(g_pendingEraseSector);
+    g_pendingEraseSector = NO_SECTOR;
+  }
+  if (slotErased(g_currentSlot)) return;
 
-// CRC8 calculation for data integrity
-static uint8_t crc8(const void *data, size_t len) {
-  const uint8_t *p = (const uint8_t *)data;
-  uint8_t crc = 0xFF;
-  for (size_t i = 0; i < len; i++) {
-    crc ^= p[i];
-    for (int j = 0; j < 8; j++) {
-      if (crc & 0x80) {
-        crc = (crc << 1) ^ 0x07;
+  if (g_numSectors >= 2 && sectorOf(g_currentSlot) == sectorOf(prevSlot)) {
+    uint32_t nextSector = (sectorOf(g_currentSlot) + 1) % g_numSectors;
+    g_currentSlot = nextSector * g_slotsPerSector;
+  }
+  eraseSector(sectorOf(g_currentSlot));
+  if (g_pendingEraseSector == sectorOf(g_currentSlot)) {
+    g_pendingEraseSector = NO_SECTOR;
+  }
+}
+
+// Read a slot; true if it holds a CRC-valid settings image
+static bool readValidSlot(uint32_t slot, SettingsSlot *entry) {
+  if (!readSlot(slot, entry)) return false;
+  if (entry->magic != SETTINGS_MAGIC || entry->count > MAX_SLOT_ENTRIES) return false;
+  if (checksum_crc32(entry, offsetof(SettingsSlot, crc)) != entry->crc) return false;
+  return entry->sequence != 0 && entry->sequence != 0xFFFFFFFF;
+}
+
+// Sequence number of the first slot of a sector (0 = erased/invalid)
+static uint32_t sectorHeadSeq(uint32_t sector) {
+  SettingsSlot entry;
+  return readValidSlot(sector * g_slotsPerSector, &entry) ? entry.sequence : 0;
+}
+
+// Find the newest entry in O(log sectors + log slots-per-sector) reads.
+//
+// Layout invariant (append-only writes, sector erase ahead, writer only ever
+// skips to a sector start): within a sector the written slots form a prefix,
+// and the sector head sequence numbers in ring order rise up to the newest
+// sector and then drop (to the erased sector or older data).
+static bool findNewestSlot(uint32_t *slotOut, SettingsSlot *entryOut) {
+  if (g_slotsPerSector == 0 || g_numSectors == 0) return false;
+
+  // Newest sector: last sector whose head is not older than sector 0's
+  uint32_t newestSector;
+  uint32_t firstSeq = sectorHeadSeq(0);
+  if (firstSeq == 0) {
+    newestSector = g_numSectors - 1; // Sector 0 is the erased one after the newest
+  } else {
+    uint32_t lo = 0;
+    uint32_t hi = g_numSectors - 1;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo + 1) / 2;
+      if (sectorHeadSeq(mid) >= firstSeq) {
+        lo = mid;
       } else {
-        crc = crc << 1;
+        hi = mid - 1;
       }
     }
+    newestSector = lo;
+  }
+  uint32_t headSeq = sectorHeadSeq(newestSector);
+  if (headSeq == 0) return false;
+
+  // Last written slot of that sector (written slots form a prefix)
+  uint32_t first = newestSector * g_slotsPerSector;
+  uint32_t end = first + g_slotsPerSector;
+  if (end > RING_BUFFER_NUM_SLOTS) end = RING_BUFFER_NUM_SLOTS;
+  uint32_t lo = first + 1; // Head is known to be valid
+  uint32_t hi = end;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (!slotErased(mid)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  // Walk back over a torn last write (or stale data older than the head)
+  for (uint32_t slot = lo; slot > first; slot--) {
+    if (readValidSlot(slot - 1, entryOut) && entryOut->sequence >= headSeq) {
+      *slotOut = slot - 1;
+      return true;
+    }
   }
-  return crc;
+  return false;
+}
+
+static int32_t clampSetting(SettingKey key, int32_t raw) {
+  const SettingDef &def = SETTING_DEFS[key];
+  if (raw < def.minRaw) return def.minRaw;
+  if (raw > def.maxRaw) return def.maxRaw;
+  return raw;
+}
+
+// Keys with one value per chamber (all but the counter and the lifetime totals)
+static bool chamberScoped(uint8_t key) {
+  return !SETTING_DEFS[key].boardWide;
+}
+
+// The legacy values[] are chamber 0's
+static void refreshLegacyView() {
+  for (uint8_t k = 0; k < SETTING_COUNT; k++) {
+    int8_t index = SETTING_DEFS[k].legacyIndex;
+    if (index >= 0 && index < NUM_VALUES) {
+      g_values[index] = (uint16_t)g_settings[0][k];
+    }
+  }
+}
+
+static void loadDefaults() {
+  for (uint8_t c = 0; c < CHAMBERS; c++) {
+    for (uint8_t k = 0; k < SETTING_COUNT; k++) {
+      g_settings[c][k] = SETTING_DEFS[k].defaultRaw;
+      g_persisted[c][k] = g_settings[c][k];
+      g_changes[c][k] = 0;
+    }
+  }
+  g_totalChanges = 0;
+  refreshLegacyView();
+}
+
+// Apply a settings image; keys unknown to this schema (or chambers beyond
+// Config::Chambers::COUNT) are skipped
+static void applySlot(const SettingsSlot &slot) {
+  loadDefaults();
+  for (uint8_t i = 0; i < slot.count; i++) {
+    const SettingEntry &entry = slot.entries[i];
+    uint8_t chamber = entry.key / CHAMBER_KEY_STRIDE;
+    uint8_t k = entry.key % CHAMBER_KEY_STRIDE;
+    if (chamber >= CHAMBERS || k >= SETTING_COUNT || (chamber > 0 && !chamberScoped(k))) continue;
+    SettingKey key = (SettingKey)k;
+    g_settings[chamber][key] = clampSetting(key, entry.value);
+    g_persisted[chamber][key] = g_settings[chamber][key];
+    g_changes[chamber][key] = entry.changes;
+  }
+  g_totalChanges = slot.total_changes;
+  refreshLegacyView();
+  if (slot.schema_version != SETTINGS_SCHEMA_VERSION) {
+    Serial.print("Settings schema ");
+    Serial.print(slot.schema_version);
+    Serial.print(" -> ");
+    Serial.println(SETTINGS_SCHEMA_VERSION);
+  }
+}
+
+// Import the newest entry of the previous 64-byte slot layout
+static bool migrateLegacySlots() {
+  LegacyEntry entry;
+  LegacyEntry newest;
+  bool found = false;
+  for (uint32_t slot = 0; slot < LEGACY_NUM_SLOTS; slot++) {
+    if (!fb_read_region((uint64_t)slot * sizeof(LegacyEntry), &entry, sizeof(entry))) continue;
+    if (checksum_crc8(&entry, 24) != entry.crc || entry.sequence == 0xFFFFFFFF) continue;
+    if (!found || entry.sequence > newest.sequence) {
+      newest = entry;
+      found = true;
+    }
+  }
+  if (!found) return false;
+
+  loadDefaults();
+  for (uint8_t k = 0; k < SETTING_COUNT; k++) {
+    int8_t index = SETTING_DEFS[k].legacyIndex;
+    if (index < 0) continue;
+    int32_t raw = newest.values[index];
+    // Out-of-range legacy values meant "not set": keep the default
+    if (raw >= SETTING_DEFS[k].minRaw && raw <= SETTING_DEFS[k].maxRaw) {
+      g_settings[0][k] = raw;
+    }
+    g_persisted[0][k] = -1; // Force the first write in the new layout
+  }
+  refreshLegacyView();
+  Serial.print("Migrated legacy slot (seq=");
+  Serial.print(newest.sequence);
+  Serial.println(") to settings schema");
+  return true;
 }
 
 // Initialize storage system
@@ -58,12 +358,25 @@ void storage_init() {
   g_flashAvailable = fb_init(RING_BUFFER_TOTAL_SIZE, RING_BUFFER_SLOT_SIZE,
                              RING_BUFFER_NUM_SLOTS);
   if (g_flashAvailable) {
-    Serial.println("Flash block device initialized for ring buffer");
+    g_slotsPerSector = fb_slots_per_sector();
+    g_numSectors = fb_num_sectors();
+    Serial.print("Flash block device initialized for ring buffer (");
+    Serial.print(g_numSectors);
+    Serial.print(" sectors x ");
+    Serial.print(g_slotsPerSector);
+    Serial.println(" slots)");
   } else {
+    g_slotsPerSector = 0;
+    g_numSectors = 0;
     Serial.println("Flash block device not available; using RAM ring buffer");
   }
 
   memset(g_ringBuffer, 0xFF, RING_BUFFER_TOTAL_SIZE);
+  loadDefaults();
+  g_currentSlot = 0;
+  g_sequence = 0;
+  g_valuesDirty = false;
+  g_pendingEraseSector = NO_SECTOR;
 
   Serial.print("Ring Buffer initialized: ");
   Serial.print(RING_BUFFER_NUM_SLOTS);
@@ -76,76 +389,53 @@ void storage_init() {
 void storage_load() {
   if (!g_storageInitialized) {
     Serial.println("Storage not initialized; using default values");
-    memset(g_values, 0, sizeof(g_values));
+    loadDefaults();
     return;
   }
 
-  Serial.println("Scanning ring buffer for newest valid entry...");
-
-  DataEntry entry;
-  uint32_t highestSeq = 0;
+  SettingsSlot entry;
+  SettingsSlot newest;
   uint32_t highestSlot = 0;
   bool found = false;
 
-  if (g_flashAvailable) {
-    for (uint32_t slot = 0; slot < RING_BUFFER_NUM_SLOTS; slot++) {
-      if (!fb_read_slot(slot, &entry, RING_BUFFER_SLOT_SIZE))
-        continue;
-      uint8_t calculated_crc = crc8(&entry, 24);
-      if (calculated_crc != entry.crc)
-        continue;
-      if (entry.sequence == 0xFFFFFFFF)
-        continue;
-      if (entry.sequence > highestSeq) {
-        highestSeq = entry.sequence;
-        highestSlot = slot;
-        found = true;
-      }
-    }
+  unsigned long start = millis();
+  found = findNewestSlot(&highestSlot, &newest);
+  if (found) {
+    Serial.print("Recovered newest entry by binary search (");
+    Serial.print(millis() - start);
+    Serial.println(" ms)");
   } else {
-    uint32_t start_slot =
-        (RING_BUFFER_NUM_SLOTS > 10) ? (RING_BUFFER_NUM_SLOTS - 10) : 0;
-    for (uint32_t slot = start_slot; slot < RING_BUFFER_NUM_SLOTS; slot++) {
-      uint32_t addr = slot * RING_BUFFER_SLOT_SIZE;
-      DataEntry *entry_ptr = (DataEntry *)(g_ringBuffer + addr);
-      uint8_t calculated_crc = crc8(entry_ptr, 24);
-      if (calculated_crc != entry_ptr->crc) {
-        continue;
-      }
-      if (entry_ptr->sequence == 0xFFFFFFFF) {
+    Serial.println("Scanning ring buffer for newest valid entry...");
+    for (uint32_t slot = 0; slot < RING_BUFFER_NUM_SLOTS; slot++) {
+      if (!readValidSlot(slot, &entry))
         continue;
-      }
-      if (entry_ptr->sequence > highestSeq) {
-        highestSeq = entry_ptr->sequence;
+      if (!found || entry.sequence > newest.sequence) {
         highestSlot = slot;
+        newest = entry;
         found = true;
       }
     }
   }
 
   if (found) {
-    if (g_flashAvailable) {
-      if (fb_read_slot(highestSlot, &entry, RING_BUFFER_SLOT_SIZE)) {
-        memcpy(g_values, entry.values, sizeof(entry.values));
-      } else {
-        memset(g_values, 0, sizeof(g_values));
-      }
-    } else {
-      uint32_t addr = highestSlot * RING_BUFFER_SLOT_SIZE;
-      DataEntry *entry_ptr = (DataEntry *)(g_ringBuffer + addr);
-      memcpy(g_values, entry_ptr->values, sizeof(entry_ptr->values));
-    }
+    applySlot(newest);
+    g_sequence = newest.sequence;
     g_currentSlot = (highestSlot + 1) % RING_BUFFER_NUM_SLOTS;
-    Serial.print("Loaded data from slot ");
+    scheduleEraseAhead(highestSlot);
+    Serial.print("Loaded settings from slot ");
     Serial.print(highestSlot);
     Serial.print(" (seq=");
-    Serial.print(highestSeq);
-    Serial.print(", values[0]=");
-    Serial.print(g_values[0]);
+    Serial.print(g_sequence);
+    Serial.print(", schema=");
+    Serial.print(newest.schema_version);
     Serial.println(")");
+  } else if (g_flashAvailable && migrateLegacySlots()) {
+    g_currentSlot = 0;
+    saveDataToRingBuffer();
   } else {
-    memset(g_values, 0, sizeof(g_values));
+    loadDefaults();
     g_currentSlot = 0;
+    scheduleEraseAhead(g_currentSlot);
     Serial.println("No valid entries found; starting fresh");
   }
 }
@@ -156,89 +446,236 @@ static void saveDataToRingBuffer() {
     return;
   }
 
-  DataEntry entry;
+  SettingsSlot entry;
   memset(&entry, 0, sizeof(entry));
+  entry.sequence = g_sequence + 1;
+  entry.magic = SETTINGS_MAGIC;
+  entry.schema_version = SETTINGS_SCHEMA_VERSION;
+  entry.count = IMAGE_ENTRIES;
+  entry.total_changes = g_totalChanges;
+  uint8_t n = 0;
+  for (uint8_t c = 0; c < CHAMBERS; c++) {
+    for (uint8_t k = 0; k < SETTING_COUNT; k++) {
+      if (c > 0 && !chamberScoped(k)) continue;
+      entry.entries[n].key = c * CHAMBER_KEY_STRIDE + k;
+      entry.entries[n].changes = g_changes[c][k];
+      entry.entries[n].value = g_settings[c][k];
+      n++;
+    }
+  }
+  entry.crc = checksum_crc32(&entry, offsetof(SettingsSlot, crc));
 
   uint32_t prevSlot =
       (g_currentSlot == 0) ? (RING_BUFFER_NUM_SLOTS - 1) : (g_currentSlot - 1);
-  uint32_t prevSeq = 0xFFFFFFFF;
 
+  bool ok;
   if (g_flashAvailable) {
-    DataEntry prevEntry;
-    if (fb_read_slot(prevSlot, &prevEntry, RING_BUFFER_SLOT_SIZE)) {
-      prevSeq = prevEntry.sequence;
-    }
-    entry.sequence = (prevSeq != 0xFFFFFFFF) ? (prevSeq + 1) : 1;
-    memcpy(entry.values, g_values, sizeof(entry.values));
-    entry.crc = crc8(&entry, 24);
-
-    uint8_t probe[RING_BUFFER_SLOT_SIZE];
-    if (fb_read_slot(g_currentSlot, probe, RING_BUFFER_SLOT_SIZE)) {
-      bool erased = true;
-      for (size_t i = 0; i < RING_BUFFER_SLOT_SIZE; ++i) {
-        if (probe[i] != 0xFF) {
-          erased = false;
-          break;
-        }
-      }
-      if (!erased) {
-        fb_erase_region();
-      }
-    }
-
-    if (!fb_write_slot(g_currentSlot, &entry, RING_BUFFER_SLOT_SIZE)) {
-      Serial.println("Flash program failed");
-    } else {
-      Serial.print("Saved to flash slot ");
-      Serial.print(g_currentSlot);
-      Serial.print(" (seq=");
-      Serial.print(entry.sequence);
-      Serial.print(", values[0]=");
-      Serial.print(g_values[0]);
-      Serial.println(")");
-    }
-
-    g_currentSlot = (g_currentSlot + 1) % RING_BUFFER_NUM_SLOTS;
-    g_valuesDirty = false;
-    return;
+    prepareSlotForWrite(prevSlot);
+    ok = fb_write_slot(g_currentSlot, &entry, RING_BUFFER_SLOT_SIZE);
+  } else {
+    memcpy(&g_ringBuffer[g_currentSlot * RING_BUFFER_SLOT_SIZE], &entry, RING_BUFFER_SLOT_SIZE);
+    ok = true;
   }
 
-  // Fallback: RAM buffer
-  uint32_t prevAddr = prevSlot * RING_BUFFER_SLOT_SIZE;
-  DataEntry *prevEntry_ptr = (DataEntry *)(g_ringBuffer + prevAddr);
-  entry.sequence = (prevEntry_ptr->sequence != 0xFFFFFFFF)
-                       ? (prevEntry_ptr->sequence + 1)
-                       : 1;
-  memcpy(entry.values, g_values, sizeof(entry.values));
-  entry.crc = crc8(&entry, 24);
-
-  uint32_t addr = g_currentSlot * RING_BUFFER_SLOT_SIZE;
-  memcpy(&g_ringBuffer[addr], &entry, RING_BUFFER_SLOT_SIZE);
-
-  Serial.print("Saved to RAM slot ");
-  Serial.print(g_currentSlot);
-  Serial.print(" (seq=");
-  Serial.print(entry.sequence);
-  Serial.print(", values[0]=");
-  Serial.print(g_values[0]);
-  Serial.println(")");
+  if (!ok) {
+    Serial.println("Flash program failed");
+  } else {
+    Serial.print(g_flashAvailable ? "Saved to flash slot " : "Saved to RAM slot ");
+    Serial.print(g_currentSlot);
+    Serial.print(" (seq=");
+    Serial.print(entry.sequence);
+    Serial.print(", changes=");
+    Serial.print(g_totalChanges);
+    Serial.println(")");
+    g_sequence = entry.sequence;
+    memcpy(g_persisted, g_settings, sizeof(g_persisted));
+  }
 
+  // First write into a new sector: the newest entry now lives here, so
+  // the sector after it can be erased
+  if (sectorOf(g_currentSlot) != sectorOf(prevSlot)) {
+    scheduleEraseAhead(g_currentSlot);
+  }
   g_currentSlot = (g_currentSlot + 1) % RING_BUFFER_NUM_SLOTS;
   g_valuesDirty = false;
 }
 
-// Periodic tick - handles auto-persistence
+static bool settingsDiffer() {
+  return memcmp(g_settings, g_persisted, sizeof(g_settings)) != 0;
+}
+
+// Periodic tick - handles ahead-of-time erase and coalesced persistence
 void storage_tick() {
-  if (!g_storageInitialized || !g_valuesDirty) {
+  if (!g_storageInitialized) {
     return;
   }
 
+  // One sector erase per tick, never in the same tick as a save
+  if (g_pendingEraseSector != NO_SECTOR) {
+    uint32_t sector = g_pendingEraseSector;
+    g_pendingEraseSector = NO_SECTOR;
+    eraseSector(sector);
+    return;
+  }
+
+  if (!g_valuesDirty) {
+    return;
+  }
+
+  // Write once changes have settled, or at the latest PERSIST_MAX_DELAY_MS
+  // after the first one; back-and-forth edits that cancel out cost nothing
   unsigned long now = millis();
-  if ((now - g_lastValueChangeMs) < PERSIST_INTERVAL_MS) {
+  if ((now - g_lastValueChangeMs) < PERSIST_INTERVAL_MS &&
+      (now - g_firstChangeMs) < PERSIST_MAX_DELAY_MS) {
     return;
   }
 
-  saveDataToRingBuffer();
+  if (settingsDiffer()) {
+    saveDataToRingBuffer();
+  } else {
+    g_valuesDirty = false;
+  }
+}
+
+unsigned long storage_next_due_ms(unsigned long now) {
+  if (!g_storageInitialized || g_pendingEraseSector != NO_SECTOR) return now;
+  if (!g_valuesDirty) return now + Config::Scheduler::MAX_IDLE_MS;
+  unsigned long settled = g_lastValueChangeMs + PERSIST_INTERVAL_MS;
+  unsigned long latest = g_firstChangeMs + PERSIST_MAX_DELAY_MS;
+  return ((long)(settled - latest) < 0) ? settled : latest;
+}
+
+// --- Typed settings ---
+
+// Value row of a key: its chamber's, chamber 0's for board-wide keys
+static uint8_t rowOf(uint8_t chamber, SettingKey key) {
+  return (chamber < CHAMBERS && chamberScoped(key)) ? chamber : 0;
+}
+
+int32_t storage_get_setting(SettingKey key) {
+  return storage_get_chamber_setting(0, key);
+}
+
+float storage_get_setting_float(SettingKey key) {
+  return storage_get_chamber_setting_float(0, key);
+}
+
+int32_t storage_set_setting(SettingKey key, int32_t raw) {
+  return storage_set_chamber_setting(0, key, raw);
+}
+
+int32_t storage_get_chamber_setting(uint8_t chamber, SettingKey key) {
+  return (key < SETTING_COUNT) ? g_settings[rowOf(chamber, key)][key] : 0;
+}
+
+float storage_get_chamber_setting_float(uint8_t chamber, SettingKey key) {
+  if (key >= SETTING_COUNT) return 0.0f;
+  return storage_setting_to_float(key, g_settings[rowOf(chamber, key)][key]);
+}
+
+// Store a clamped value and schedule the write; only user changes are counted
+static int32_t storeSetting(uint8_t row, SettingKey key, int32_t raw, bool countChange) {
+  raw = clampSetting(key, raw);
+  if (raw == g_settings[row][key]) return raw;
+
+  g_settings[row][key] = raw;
+  if (countChange) {
+    if (g_changes[row][key] < 0xFFFF) g_changes[row][key]++;
+    g_totalChanges++;
+  }
+  refreshLegacyView();
+
+  unsigned long now = millis();
+  if (!g_valuesDirty) g_firstChangeMs = now;
+  g_valuesDirty = true;
+  g_lastValueChangeMs = now;
+  return raw;
+}
+
+int32_t storage_set_chamber_setting(uint8_t chamber, SettingKey key, int32_t raw) {
+  if (key >= SETTING_COUNT) return 0;
+  return storeSetting(rowOf(chamber, key), key, raw, true);
+}
+
+int32_t storage_add_counter(SettingKey key, uint32_t delta) {
+  if (key >= SETTING_COUNT || chamberScoped(key)) return 0;
+  int64_t sum = (int64_t)g_settings[0][key] + delta;
+  return storeSetting(0, key, (sum > INT32_MAX) ? INT32_MAX : (int32_t)sum, false);
+}
+
+// Scaled value -> raw, false if it does not round into the key's range.
+// Checked in float before lroundf(): from 2^31 on the result does not fit
+// a long, and (float)INT32_MAX is already 2^31 (maxRaw of the counters).
+static bool roundIntoRange(SettingKey key, float scaled, int32_t *raw) {
+  const SettingDef &def = SETTING_DEFS[key];
+  if (!(scaled > (float)def.minRaw - 1.0f && scaled < (float)def.maxRaw + 1.0f)) return false; // Also NaN
+  int32_t rounded = lroundf(scaled);
+  if (rounded < def.minRaw || rounded > def.maxRaw) return false;
+  *raw = rounded;
+  return true;
+}
+
+int32_t storage_setting_from_float(SettingKey key, float value) {
+  if (key >= SETTING_COUNT) return 0;
+  for (uint8_t i = 0; i < SETTING_DEFS[key].decimals; i++) value *= 10.0f;
+  int32_t raw;
+  if (roundIntoRange(key, value, &raw)) return raw;
+  return (value >= (float)SETTING_DEFS[key].maxRaw) ? SETTING_DEFS[key].maxRaw : SETTING_DEFS[key].minRaw;
+}
+
+bool storage_setting_parse(SettingKey key, float value, int32_t *raw) {
+  if (key >= SETTING_COUNT || !isfinite(value)) return false;
+  for (uint8_t i = 0; i < SETTING_DEFS[key].decimals; i++) value *= 10.0f;
+  return roundIntoRange(key, value, raw);
+}
+
+float storage_setting_to_float(SettingKey key, int32_t raw) {
+  if (key >= SETTING_COUNT) return 0.0f;
+  float value = (float)raw;
+  for (uint8_t i = 0; i < SETTING_DEFS[key].decimals; i++) value /= 10.0f;
+  return value;
+}
+
+const char *storage_setting_name(SettingKey key) {
+  return (key < SETTING_COUNT) ? SETTING_DEFS[key].name : "";
+}
+
+uint8_t storage_setting_decimals(SettingKey key) {
+  return (key < SETTING_COUNT) ? SETTING_DEFS[key].decimals : 0;
+}
+
+uint32_t storage_setting_changes(SettingKey key) {
+  return storage_chamber_setting_changes(0, key);
+}
+
+uint32_t storage_chamber_setting_changes(uint8_t chamber, SettingKey key) {
+  return (key < SETTING_COUNT) ? g_changes[rowOf(chamber, key)][key] : 0;
+}
+
+bool storage_setting_per_chamber(SettingKey key) {
+  return key < SETTING_COUNT && chamberScoped(key);
+}
+
+uint32_t storage_total_changes() {
+  return g_totalChanges;
+}
+
+uint32_t storage_flash_writes() {
+  return g_sequence;
+}
+
+bool storage_write_pending() {
+  return g_valuesDirty && settingsDiffer();
+}
+
+// --- Legacy value API ---
+
+// Setting stored at a legacy values[] index, SETTING_COUNT if none
+static SettingKey legacyKey(uint8_t index) {
+  for (uint8_t k = 0; k < SETTING_COUNT; k++) {
+    if (SETTING_DEFS[k].legacyIndex == index) return (SettingKey)k;
+  }
+  return SETTING_COUNT;
 }
 
 // Get values (read-only)
@@ -259,80 +696,51 @@ uint8_t storage_get_num_values() {
 // Increment a value
 void storage_increment_value(uint8_t index) {
   if (index < NUM_VALUES) {
-    g_values[index]++;
-    g_valuesDirty = true;
-    g_lastValueChangeMs = millis();
+    storage_set_value(index, g_values[index] + 1);
   }
 }
 
-// Set a value
+// Set a value (indices without a setting key are RAM-only)
 void storage_set_value(uint8_t index, uint16_t value) {
-  if (index < NUM_VALUES) {
+  if (index >= NUM_VALUES) return;
+  SettingKey key = legacyKey(index);
+  if (key < SETTING_COUNT) {
+    storage_set_setting(key, value);
+  } else {
     g_values[index] = value;
-    g_valuesDirty = true;
-    g_lastValueChangeMs = millis();
   }
 }
 
 // Force immediate save
 void storage_save_now() {
-  if (g_storageInitialized && g_valuesDirty) {
+  if (g_storageInitialized && g_valuesDirty && settingsDiffer()) {
     saveDataToRingBuffer();
   }
 }
 
-// CO2 Setpoint management (stored in values[1])
+// CO2 Setpoint management
 void storage_set_co2_setpoint(uint16_t ppm) {
-  // Clamp to valid range: 400-10000 ppm
-  if (ppm < 400) ppm = 400;
-  if (ppm > 10000) ppm = 10000;
-  storage_set_value(1, ppm);
+  storage_set_setting(SETTING_CO2_SETPOINT, ppm); // Clamped to 400-10000 ppm
 }
 
 uint16_t storage_get_co2_setpoint() {
-  uint16_t setpoint = g_values[1];
-  // Default to 800 ppm if not set or out of range
-  if (setpoint < 400 || setpoint > 10000) {
-    setpoint = 800;
-    storage_set_co2_setpoint(setpoint);
-  }
-  return setpoint;
+  return (uint16_t)storage_get_setting(SETTING_CO2_SETPOINT);
 }
 
-// RH Setpoint management (stored in values[2], scaled by 10)
+// RH Setpoint management (scaled by 10)
 void storage_set_rh_setpoint(float percent) {
-  // Clamp to valid range: 82-96%
-  if (percent < 82.0f) percent = 82.0f;
-  if (percent > 96.0f) percent = 96.0f;
-  uint16_t scaled = (uint16_t)(percent * 10.0f); // 89.0 -> 890
-  storage_set_value(2, scaled);
+  storage_set_setting(SETTING_RH_SETPOINT, storage_setting_from_float(SETTING_RH_SETPOINT, percent)); // 89.0 -> 890, clamped to 82-96%
 }
 
 float storage_get_rh_setpoint() {
-  uint16_t scaled = g_values[2];
-  // Default to 89.0% if not set
-  if (scaled < 820 || scaled > 960) {
-    scaled = 890; // 89.0%
-    storage_set_value(2, scaled);
-  }
-  return scaled / 10.0f;
+  return storage_get_setting_float(SETTING_RH_SETPOINT);
 }
 
-// Temperature Setpoint management (stored in values[3], scaled by 10)
+// Temperature Setpoint management (scaled by 10)
 void storage_set_temp_setpoint(float celsius) {
-  // Clamp to valid range: 18-32°C
-  if (celsius < 18.0f) celsius = 18.0f;
-  if (celsius > 32.0f) celsius = 32.0f;
-  uint16_t scaled = (uint16_t)(celsius * 10.0f); // 25.0 -> 250
-  storage_set_value(3, scaled);
+  storage_set_setting(SETTING_TEMP_SETPOINT, storage_setting_from_float(SETTING_TEMP_SETPOINT, celsius)); // 25.0 -> 250, clamped to 18-32°C
 }
 
 float storage_get_temp_setpoint() {
-  uint16_t scaled = g_values[3];
-  // Default to 25.0°C if not set
-  if (scaled < 180 || scaled > 320) {
-    scaled = 250; // 25.0°C
-    storage_set_value(3, scaled);
-  }
-  return scaled / 10.0f;
+  return storage_get_setting_float(SETTING_TEMP_SETPOINT);
 }
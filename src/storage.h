@@ -4,6 +4,15 @@
  * *****************************************************************************
  * High-level storage API for application data with ring buffer persistence
  * Handles flash-backed or RAM-backed storage with wear-leveling
+ *
+ * Settings are typed key/value pairs: every key has a stable id, a fixed-point
+ * scale, a range and a default (see SETTING_DEFS in storage.cpp). A slot holds
+ * a full image of all settings, tagged with the schema version; unknown keys
+ * are ignored and missing keys take their default on load.
+ *
+ * Every key except the demo counter and the lifetime actuator totals exists
+ * once per chamber (Config::Chambers); the plain accessors address chamber
+ * 0, which also keeps the on-flash ids of a single-chamber image.
  * *****************************************************************************
  */
 
@@ -13,8 +22,41 @@
 #include <stdint.h>
 
 // Storage Configuration
-static constexpr unsigned long PERSIST_INTERVAL_MS = 5000UL;
+static constexpr unsigned long PERSIST_INTERVAL_MS = 5000UL;       // Quiet time before a write
+static constexpr unsigned long PERSIST_MAX_DELAY_MS = 60000UL;     // Upper bound while changes keep coming
 static constexpr uint8_t NUM_VALUES = 10;
+static constexpr uint8_t SETTINGS_SCHEMA_VERSION = 1;
+
+/**
+ * @brief Persistent setting keys
+ *
+ * The numeric value is the id stored on flash: never reuse or renumber,
+ * only append.
+ */
+enum SettingKey : uint8_t {
+  SETTING_COUNTER = 0,        ///< Demo counter (legacy values[0])
+  SETTING_CO2_SETPOINT = 1,   ///< ppm
+  SETTING_RH_SETPOINT = 2,    ///< % x10
+  SETTING_TEMP_SETPOINT = 3,  ///< °C x10
+  SETTING_HEATER_MODE = 4,    ///< Config::Control::MODE_*
+  SETTING_HEATER_KP = 5,      ///< Duty per °C x100
+  SETTING_HEATER_KI = 6,      ///< Duty per °C·s x10000
+  SETTING_HEATER_KD = 7,      ///< Duty·s per °C x10
+  SETTING_FOGGER_MODE = 8,    ///< Config::Control::MODE_*
+  SETTING_FOGGER_KP = 9,      ///< Duty per %RH x100
+  SETTING_FOGGER_KI = 10,     ///< Duty per %RH·s x10000
+  SETTING_CO2_LIMIT = 11,     ///< ppm, critical: preempts the running action
+  SETTING_TEMP_LIMIT = 12,    ///< °C x10, critical: preempts, heater interlocked
+  SETTING_FOGGER_ON_S = 13,   ///< Lifetime on-time, s (board-wide, actuator_stats.h)
+  SETTING_SWIRLER_ON_S = 14,
+  SETTING_FRESHAIR_ON_S = 15,
+  SETTING_HEATER_ON_S = 16,
+  SETTING_FOGGER_SWITCHES = 17,   ///< Lifetime switch-ons (board-wide)
+  SETTING_SWIRLER_SWITCHES = 18,
+  SETTING_FRESHAIR_SWITCHES = 19,
+  SETTING_HEATER_SWITCHES = 20,
+  SETTING_COUNT
+};
 
 // Initialize storage system (call once in setup)
 void storage_init();
@@ -25,6 +67,62 @@ void storage_load();
 // Periodic tick function (call in loop to handle auto-persistence)
 void storage_tick();
 
+// Next deadline for the scheduler: pending erase or end of the coalescing window
+unsigned long storage_next_due_ms(unsigned long now);
+
+// --- Typed settings ---
+
+// Raw fixed-point value of a setting (e.g. 890 for 89.0 %RH)
+int32_t storage_get_setting(SettingKey key);
+
+// Value of a setting in its unit (raw / 10^decimals)
+float storage_get_setting_float(SettingKey key);
+
+// Set a raw value (clamped to the key's range); returns the stored value.
+// Writes are coalesced: nothing is programmed if the value ends up unchanged.
+int32_t storage_set_setting(SettingKey key, int32_t raw);
+
+// Unit value -> clamped raw value, without storing (e.g. to validate a request)
+int32_t storage_setting_from_float(SettingKey key, float value);
+
+// Unit value -> raw value; false (nothing clamped) if it is outside the key's range
+bool storage_setting_parse(SettingKey key, float value, int32_t *raw);
+
+// Raw value -> unit value (raw / 10^decimals)
+float storage_setting_to_float(SettingKey key, int32_t raw);
+
+// Metadata for iterating all settings (e.g. web API)
+const char *storage_setting_name(SettingKey key);
+uint8_t storage_setting_decimals(SettingKey key);
+
+// Number of effective changes of one key (persisted with the next write)
+uint32_t storage_setting_changes(SettingKey key);
+
+// Add to a board-wide statistic (lifetime actuator totals), saturating at
+// the key's maximum. Persisted like a setting, but not counted as a change.
+int32_t storage_add_counter(SettingKey key, uint32_t delta);
+
+// --- Per-chamber settings (chamber < Config::Chambers::COUNT; counter and lifetime totals are board-wide) ---
+
+int32_t storage_get_chamber_setting(uint8_t chamber, SettingKey key);
+float storage_get_chamber_setting_float(uint8_t chamber, SettingKey key);
+int32_t storage_set_chamber_setting(uint8_t chamber, SettingKey key, int32_t raw);
+uint32_t storage_chamber_setting_changes(uint8_t chamber, SettingKey key);
+
+// False for board-wide keys (same value for every chamber)
+bool storage_setting_per_chamber(SettingKey key);
+
+// Effective changes of all keys since the first boot (persisted with the next write)
+uint32_t storage_total_changes();
+
+// Settings images written since the first boot (= newest slot sequence)
+uint32_t storage_flash_writes();
+
+// True while changes are waiting for the coalescing window to close
+bool storage_write_pending();
+
+// --- Legacy value API (index = legacy values[] position) ---
+
 // Get pointer to values array (read-only access)
 const uint16_t* storage_get_values();
 
@@ -43,14 +141,14 @@ void storage_set_value(uint8_t index, uint16_t value);
 // Force immediate save (normally called automatically by storage_tick)
 void storage_save_now();
 
-// CO2 Setpoint management (stored in values[1])
+// CO2 Setpoint management (SETTING_CO2_SETPOINT)
 void storage_set_co2_setpoint(uint16_t ppm);
 uint16_t storage_get_co2_setpoint();
 
-// RH Setpoint management (stored in values[2], scaled by 10: 940 = 94.0%)
+// RH Setpoint management (SETTING_RH_SETPOINT, scaled by 10: 940 = 94.0%)
 void storage_set_rh_setpoint(float percent);
 float storage_get_rh_setpoint();
 
-// Temperature Setpoint management (stored in values[3], scaled by 10: 250 = 25.0°C)
+// Temperature Setpoint management (SETTING_TEMP_SETPOINT, scaled by 10: 250 = 25.0°C)
 void storage_set_temp_setpoint(float celsius);
 float storage_get_temp_setpoint();
@@ -0,0 +1,97 @@
+/*
+ * *****************************************************************************
+ * TASKS - SCHEDULER TASK TABLE OF THE FIRMWARE
+ * *****************************************************************************
+ * The one task table: main.cpp hands it to scheduler_init(), and the
+ * env:native harness (test/host_sim.h) runs the same table on the virtual
+ * clock, so a simulated run follows the firmware's priorities, periods,
+ * deadlines and `next` hooks.
+ *
+ * Defines the table, so include it once per program. The includer defines
+ * the entries that belong to main.cpp: main_web_tick() (HTTP pool, only
+ * without CC_NETWORK_THREAD) and main_boot_tick()/main_boot_next_ms()
+ * (deferred startup); host_sim.h provides stand-ins.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include "analog_inputs.h"
+#include "can_link.h"
+#include "chamber_clock.h"
+#include "config.h"
+#include "controller.h"
+#include "event_log.h"
+#include "modbus_master.h"
+#include "outputs.h"
+#include "sample_log.h"
+#include "scheduler.h"
+#include "storage.h"
+#include "temp_probes.h"
+#include "usb_logger.h"
+#include "wall_clock.h"
+
+#if !CC_NETWORK_THREAD
+void main_web_tick(unsigned long now);
+#endif
+void main_boot_tick(unsigned long now);
+unsigned long main_boot_next_ms(unsigned long now);
+
+// --- Task adapters for modules that keep their own clock ---
+
+static void storageTask(unsigned long) {
+  storage_tick();
+}
+
+static void sampleLogTask(unsigned long) {
+  sample_log_tick();
+}
+
+#if CC_CAN && !CC_NETWORK_THREAD
+static void canTask(unsigned long now) {
+  can_link_tick(now);
+}
+#endif
+
+/**
+ * @brief Static task table, run by scheduler_run_pass()
+ *
+ * Lower priority value runs first within a pass: the actuator state machines
+ * never wait behind HTTP or flash work. Flash erases (storage, sample log)
+ * come late because a sector erase is the longest single step; the event log
+ * drain only prints what the pass left time for. The deferred boot stages
+ * come after everything else and go idle once the network is started.
+ *
+ * Tasks with a `next` hook are event-driven: they run when their next
+ * deadline is reached, the period is only the minimum spacing. The clock
+ * follows the earliest controller deadline so it always runs first.
+ */
+static const SchedulerTask TASKS[] = {
+  // name        entry point               prio  period                                     deadline                                 next
+  {"clock",      chamber_clock_tick,       0,    Config::Scheduler::CONTROL_PERIOD_MS,      Config::Scheduler::CONTROL_DEADLINE_MS,  controller_next_ms},
+  {"action",     controller_action_tick,   0,    Config::Scheduler::CONTROL_PERIOD_MS,      Config::Scheduler::CONTROL_DEADLINE_MS,  controller_action_next_ms},
+  {"heater",     controller_heater_tick,   1,    Config::Scheduler::HEATER_PERIOD_MS,       Config::Scheduler::CONTROL_DEADLINE_MS,  controller_heater_next_ms},
+  {"outputs",    outputs_tick,             1,    Config::Scheduler::CONTROL_PERIOD_MS,      Config::Scheduler::CONTROL_DEADLINE_MS,  nullptr},
+  {"probes",     temp_probes_tick,         2,    Config::TempProbes::POLL_PERIOD_MS,        0,                                       nullptr},
+  {"analog",     analog_inputs_tick,       2,    Config::AnalogInputs::DRAIN_PERIOD_MS,     0,                                       nullptr},
+  {"modbus",     modbus_master_tick,       2,    Config::Modbus::TICK_PERIOD_MS,            0,                                       nullptr},
+  {"commands",   controller_command_tick,  3,    Config::Scheduler::CONTROL_PERIOD_MS,      0,                                       nullptr},
+  {"measure",    controller_measure_tick,  4,    Config::Scheduler::CONTROL_PERIOD_MS,      Config::Scheduler::CONTROL_DEADLINE_MS,  controller_measure_next_ms},
+  {"sample",     controller_sample_tick,   5,    Config::Scheduler::CONTROL_PERIOD_MS,      Config::Scheduler::CONTROL_DEADLINE_MS,  controller_sample_next_ms},
+  {"rtc",        wall_clock_tick,          5,    Config::WallClock::EDGE_POLL_MS,           0,                                       wall_clock_next_ms},
+#if !CC_NETWORK_THREAD
+  {"web",        main_web_tick,            6,    Config::Scheduler::WEB_PERIOD_MS,          Config::Scheduler::WEB_DEADLINE_MS,      nullptr},
+#if CC_CAN
+  {"can",        canTask,                  7,    Config::Scheduler::CAN_PERIOD_MS,          0,                                       nullptr},
+#endif
+#endif
+  {"storage",    storageTask,              8,    Config::Scheduler::STORAGE_PERIOD_MS,      0,                                       storage_next_due_ms},
+  {"sample_log", sampleLogTask,            9,    Config::Scheduler::SAMPLE_LOG_PERIOD_MS,   0,                                       sample_log_next_due_ms},
+#if CC_USB_LOG
+  {"usb_log",    usb_logger_tick,          9,    Config::Scheduler::MAX_IDLE_MS,            0,                                       usb_logger_next_ms},
+#endif
+  {"events",     event_log_tick,           10,   Config::EventLog::DRAIN_PERIOD_MS,         0,                                       event_log_next_due_ms},
+  {"boot",       main_boot_tick,           11,   0,                                         0,                                       main_boot_next_ms},
+};
+
+static constexpr uint8_t TASK_COUNT = sizeof(TASKS) / sizeof(TASKS[0]);
@@ -0,0 +1,103 @@
+/*
+ * *****************************************************************************
+ * BINARY TELEMETRY FORMAT
+ * *****************************************************************************
+ * Compact application/octet-stream variant of the history API
+ * (/api/last200?format=bin, /api/since?seq=N&format=bin) for data collectors.
+ *
+ * Layout (all multi-byte fields little-endian, no padding):
+ *
+ *   Header                       24 bytes, see Telemetry::Header
+ *   co2          uint16[count]   ppm
+ *   co2_2        uint16[count]   ppm
+ *   rh           int16[count]    %RH × 10
+ *   rh_2         int16[count]    %RH × 10
+ *   temp         int16[count]    °C × 10
+ *   temp_2       int16[count]    °C × 10
+ *   temp_outer   int16[count]    °C × 10
+ *   actuators    uint8[count]    Telemetry::ACTUATOR_* bits
+ *
+ * Samples within a channel are ordered oldest -> newest; the last one has
+ * sequence number Header::seq. The ×10 scaling matches the setpoint storage
+ * in storage.cpp.
+ *
+ * Packed variant (format=packed, Header::flags has FLAG_PACKED): the same
+ * header, then the samples oldest -> newest in blocks of up to
+ * PACKED_BLOCK_SAMPLES:
+ *
+ *   count        uint8          Samples in this block
+ *   bytes        uint16         Payload length
+ *   payload      uint8[bytes]   sample_codec.h bit stream of `count` records
+ *
+ * Each block decodes on its own (delta coding restarts from zero); the
+ * counts add up to Header::count.
+ *
+ * MQTT sample batches (topic <prefix><client id>/samples, mqtt_client.h):
+ *
+ *   BatchHeader                  12 bytes, see Telemetry::BatchHeader
+ *   records      SampleRecord[count], 16 bytes each (sample_log.h), oldest first
+ *
+ * Record i has sample number first_seq + i. A record whose CRC8 does not
+ * match could not be read back and carries no data.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace Telemetry {
+
+constexpr uint8_t MAGIC_0 = 'C';
+constexpr uint8_t MAGIC_1 = 'C';
+constexpr uint8_t FORMAT_VERSION = 1;
+
+// Header::flags
+constexpr uint8_t FLAG_RESET = 0x01;   // Full window, client must discard its data
+constexpr uint8_t FLAG_PACKED = 0x02;  // Channels follow as packed blocks
+
+constexpr uint8_t PACKED_BLOCK_SAMPLES = 24;  // Worst case block fits one HTTP chunk
+
+// Bits of one actuator state byte
+constexpr uint8_t ACTUATOR_FOGGER = 0x01;
+constexpr uint8_t ACTUATOR_SWIRLER = 0x02;
+constexpr uint8_t ACTUATOR_FRESHAIR = 0x04;
+constexpr uint8_t ACTUATOR_HEATER = 0x08;
+
+constexpr uint8_t SENSOR_CHANNEL_COUNT = 7;
+
+struct Header {
+  uint8_t magic[2];             ///< MAGIC_0, MAGIC_1
+  uint8_t version;              ///< FORMAT_VERSION
+  uint8_t flags;                ///< FLAG_* bits
+  uint32_t seq;                 ///< Sequence number of the newest sample
+  uint16_t count;               ///< Samples per channel in this response
+  uint16_t length;              ///< History window length (ring capacity)
+  uint16_t sample_interval_ms;  ///< Time between two samples
+  uint16_t co2_setpoint;        ///< ppm
+  int16_t rh_setpoint_x10;      ///< %RH × 10
+  int16_t temp_setpoint_x10;    ///< °C × 10
+  uint32_t uptime_s;            ///< Seconds since boot
+} __attribute__((packed));
+
+static_assert(sizeof(Header) == 24, "Telemetry::Header must be exactly 24 bytes");
+
+// MQTT batches
+constexpr uint8_t BATCH_MAGIC_1 = 'B';
+constexpr uint8_t BATCH_FORMAT_VERSION = 1;
+
+// BatchHeader::flags
+constexpr uint8_t BATCH_FLAG_BOOT_SEQ = 0x01; // No flash log: numbers are the controller's per-boot sequence
+
+struct BatchHeader {
+  uint8_t magic[2];             ///< MAGIC_0, BATCH_MAGIC_1
+  uint8_t version;              ///< BATCH_FORMAT_VERSION
+  uint8_t flags;                ///< BATCH_FLAG_* bits
+  uint32_t first_seq;           ///< Sample number of the first record (sample log numbering)
+  uint16_t count;               ///< Records that follow
+  uint16_t sample_interval_ms;  ///< Time between two samples
+} __attribute__((packed));
+
+static_assert(sizeof(BatchHeader) == 12, "Telemetry::BatchHeader must be exactly 12 bytes");
+
+} // namespace Telemetry
@@ -0,0 +1,123 @@
+/*
+ * *****************************************************************************
+ * TEMPERATURE PROBES IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "temp_probes.h"
+#include "config.h"
+#include "event_log.h"
+#include <Arduino_PortentaMachineControl.h>
+#include <limits.h>
+#include <math.h>
+
+enum ProbeStage : uint8_t {
+  PROBE_STAGE_OFF,       // Not initialized / simulation
+  PROBE_STAGE_SETTLE,    // Channel switched, waiting for the multiplexer
+  PROBE_STAGE_CONVERT    // RTD one-shot conversion running
+};
+
+struct ProbeReading {
+  float celsius;
+  unsigned long timestampMs;
+  uint8_t fault;
+  bool valid;
+};
+
+static constexpr bool USE_TC = Config::TempProbes::THERMOCOUPLES;
+
+// Internal state
+static ProbeStage g_stage = PROBE_STAGE_OFF;
+static uint8_t g_channel = 0;
+static unsigned long g_stageStartMs = 0;
+static ProbeReading g_readings[TEMP_PROBE_CHANNEL_COUNT];
+
+static void selectChannel(uint8_t channel, unsigned long now) {
+  g_channel = channel;
+  if (USE_TC) {
+    MachineControl_TCTempProbe.setChannel(channel);
+  } else {
+    MachineControl_RTDTempProbe.setChannel(channel);
+  }
+  g_stageStartMs = now;
+  g_stage = PROBE_STAGE_SETTLE;
+}
+
+// Store the result of the current channel and move on to the next one
+static void finishChannel(float celsius, uint8_t fault, unsigned long now) {
+  ProbeReading &reading = g_readings[g_channel];
+  reading.fault = fault;
+  if (fault == 0) {
+    reading.celsius = celsius;
+    reading.timestampMs = now;
+    reading.valid = true;
+  } else {
+    event_log(EVT_PROBE_FAULT, fault, g_channel);
+  }
+  selectChannel((g_channel + 1) % TEMP_PROBE_CHANNEL_COUNT, now);
+}
+
+void temp_probes_init() {
+  for (uint8_t ch = 0; ch < TEMP_PROBE_CHANNEL_COUNT; ch++) {
+    g_readings[ch] = {0.0f, 0, 0, false};
+  }
+  g_stage = PROBE_STAGE_OFF;
+  if (Config::SIMULATE_SENSORS) {
+    return;
+  }
+
+  if (USE_TC) {
+    MachineControl_TCTempProbe.begin();
+    Serial.println("Temp probes: thermocouple round robin over 3 channels");
+  } else {
+    MachineControl_RTDTempProbe.begin(Config::TempProbes::THREE_WIRE_RTD ? THREE_WIRE : TWO_WIRE);
+    Serial.println("Temp probes: RTD round robin over 3 channels");
+  }
+  selectChannel(0, millis());
+}
+
+void temp_probes_tick(unsigned long now) {
+  switch (g_stage) {
+    case PROBE_STAGE_OFF:
+      break;
+
+    case PROBE_STAGE_SETTLE:
+      if (USE_TC) {
+        if (now - g_stageStartMs < TC_CHANNEL_SETTLE_MS) break;
+        float celsius = MachineControl_TCTempProbe.readTemperature(
+            Config::TempProbes::TC_TYPE_J ? PROBE_J : PROBE_K);
+        finishChannel(celsius, isnan(celsius) ? 0x07 : 0, now); // NAN = open/short fault
+      } else {
+        if (now - g_stageStartMs < RTD_CHANNEL_SETTLE_MS) break;
+        MachineControl_RTDTempProbe.startConversion();
+        g_stage = PROBE_STAGE_CONVERT;
+      }
+      break;
+
+    case PROBE_STAGE_CONVERT:
+      if (MachineControl_RTDTempProbe.isReady()) {
+        uint32_t rtd = MachineControl_RTDTempProbe.readResult();
+        uint8_t fault = MachineControl_RTDTempProbe.readFault();
+        if (fault != 0) MachineControl_RTDTempProbe.clearFault();
+        float celsius = MachineControl_RTDTempProbe.temperatureFromRTD(
+            rtd, Config::TempProbes::RTD_NOMINAL_OHM, Config::TempProbes::RTD_REFERENCE_OHM);
+        finishChannel(celsius, fault, now);
+      }
+      break;
+  }
+}
+
+bool temp_probes_read(TempProbeChannel channel, float *celsius) {
+  if (temp_probes_age_ms(channel) > Config::TempProbes::MAX_AGE_MS) return false;
+  *celsius = g_readings[channel].celsius;
+  return true;
+}
+
+unsigned long temp_probes_age_ms(TempProbeChannel channel) {
+  if (channel >= TEMP_PROBE_CHANNEL_COUNT || !g_readings[channel].valid) return ULONG_MAX;
+  return millis() - g_readings[channel].timestampMs;
+}
+
+uint8_t temp_probes_fault(TempProbeChannel channel) {
+  return (channel < TEMP_PROBE_CHANNEL_COUNT) ? g_readings[channel].fault : 0;
+}
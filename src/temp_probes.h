@@ -0,0 +1,69 @@
+/*
+ * *****************************************************************************
+ * TEMPERATURE PROBES - NON-BLOCKING CHANNEL SEQUENCER
+ * *****************************************************************************
+ * Cycles through the three temperature inputs of the Machine Control without
+ * ever calling delay(). The inputs share one multiplexer between the PT100
+ * front end (MAX31865) and the thermocouple front end (MAX31855), so one
+ * sequencer drives whichever type Config::TempProbes selects:
+ *   RTD: select -> settle RTD_CHANNEL_SETTLE_MS -> startConversion()
+ *        -> poll isReady() -> readResult() + fault check -> next channel
+ *   TC:  select -> settle TC_CHANNEL_SETTLE_MS -> readTemperature() (one SPI
+ *        frame, the MAX31855 converts continuously) -> next channel
+ * Deadlines are taken from the scheduler clock passed to the tick. Every
+ * tick does at most a few SPI transfers. Readers get the newest value per
+ * channel and its age.
+ *
+ * Inactive while Config::SIMULATE_SENSORS is set.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @brief Input channel per temperature probe
+ */
+enum TempProbeChannel : uint8_t {
+  TEMP_PROBE_TEMP = 0,        ///< Inner temperature (main)
+  TEMP_PROBE_TEMP_2 = 1,      ///< Inner temperature (secondary)
+  TEMP_PROBE_TEMP_OUTER = 2,  ///< Outer box temperature
+  TEMP_PROBE_CHANNEL_COUNT
+};
+
+/**
+ * @brief Initialize the selected front end (call once in setup)
+ */
+void temp_probes_init();
+
+/**
+ * @brief Advance the channel sequencer (scheduler task)
+ *
+ * @param now millis() of the current scheduler pass
+ */
+void temp_probes_tick(unsigned long now);
+
+/**
+ * @brief Newest temperature of one channel
+ *
+ * @param channel TempProbeChannel
+ * @param celsius Output, only written if a valid reading exists
+ * @return false if there is no fault-free reading newer than Config::TempProbes::MAX_AGE_MS
+ */
+bool temp_probes_read(TempProbeChannel channel, float *celsius);
+
+/**
+ * @brief Age of the newest fault-free reading of a channel
+ *
+ * @return ms since that reading, ULONG_MAX if there is none
+ */
+unsigned long temp_probes_age_ms(TempProbeChannel channel);
+
+/**
+ * @brief Fault status of the last read on a channel (0 = ok)
+ *
+ * MAX31865 fault register for RTDs, MAX31855 fault bits (D2..D0) for thermocouples.
+ */
+uint8_t temp_probes_fault(TempProbeChannel channel);
@@ -0,0 +1,85 @@
+/*
+ * *****************************************************************************
+ * TREND STATS - SMOOTHED LEVEL, SLOPE AND SPREAD OF ONE CHANNEL
+ * *****************************************************************************
+ * Holt's linear smoothing over the filter samples of one channel, for the
+ * adaptive measurement cycle (Config::Measure):
+ * - level/slope: double exponential smoothing (alpha for the level, beta
+ *   for the slope); predict(t) extrapolates the level t seconds ahead
+ * - spread: exponentially weighted RMS of the one-step prediction error,
+ *   i.e. the noise around the trend, not the trend itself
+ * - AgreementStats: smoothed absolute difference of two sensors of the
+ *   same quantity (main/secondary), a measure of how well mixed the air is
+ *
+ * Values are in the channel's fixed point (fixed_point.h), times in chamber
+ * seconds. O(1) per sample, no allocation.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+class TrendStats {
+private:
+  float lvl;
+  float slp;        // Per second
+  float variance;   // Of the one-step prediction error
+  uint8_t samples;  // Saturating at WARMUP
+
+  static constexpr uint8_t WARMUP = 3;  // Samples before slope and spread mean anything
+
+public:
+  TrendStats() : lvl(0.0f), slp(0.0f), variance(0.0f), samples(0) {}
+
+  void reset() {
+    lvl = 0.0f;
+    slp = 0.0f;
+    variance = 0.0f;
+    samples = 0;
+  }
+
+  void update(float value, float dtS, float alpha, float beta) {
+    if (samples == 0) {
+      lvl = value;
+      samples = 1;
+      return;
+    }
+    float predicted = lvl + slp * dtS;
+    float error = value - predicted;
+    float next = predicted + alpha * error;
+    slp += beta * ((next - lvl) / dtS - slp);
+    lvl = next;
+    variance += alpha * (error * error - variance);
+    if (samples < WARMUP) samples++;
+  }
+
+  bool ready() const { return samples >= WARMUP; }
+  float level() const { return lvl; }
+  float slopePerS() const { return slp; }
+  float spread() const { return sqrtf(variance); }
+
+  // Extrapolated level `aheadS` seconds from the last sample
+  float predict(float aheadS) const { return lvl + slp * aheadS; }
+};
+
+class AgreementStats {
+private:
+  float diff;
+  bool primed;
+
+public:
+  AgreementStats() : diff(0.0f), primed(false) {}
+
+  void reset() { primed = false; }
+
+  void update(float a, float b, float alpha) {
+    float d = fabsf(a - b);
+    diff = primed ? diff + alpha * (d - diff) : d;
+    primed = true;
+  }
+
+  bool ready() const { return primed; }
+  float difference() const { return diff; }
+};
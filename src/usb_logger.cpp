@@ -0,0 +1,289 @@
+/*
+ * *****************************************************************************
+ * USB LOGGER IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "usb_logger.h"
+
+#if CC_USB_LOG
+
+#include <Arduino_PortentaMachineControl.h>
+#include <Arduino_USBHostMbed5.h>
+#include <FATFileSystem.h>
+#include <mbed.h>
+#include <atomic>
+#include <stdio.h>
+#include "event_log.h"
+#include "sample_csv.h"
+#include "wall_clock.h"
+
+using namespace Config::UsbLog;
+
+static constexpr uint8_t NO_BUFFER = 0xFF;
+static constexpr size_t NAME_MAX_LEN = 40;
+static constexpr size_t FRAME_MAX = (SAMPLE_CSV_ROW_MAX > sizeof(UsbLogRecord)) ? SAMPLE_CSV_ROW_MAX
+                                                                                : sizeof(UsbLogRecord);
+static constexpr char BINARY_MAGIC[4] = {'C', 'C', 'U', 'L'};
+
+enum BufferState : uint8_t {
+  BUF_FREE,     // Producer may take it
+  BUF_FILLING,  // Producer owns it
+  BUF_FULL      // Writer owns it
+};
+
+struct LogBuffer {
+  uint8_t data[BUFFER_BYTES];
+  uint32_t len;
+  uint32_t limit;              // Fill up to here: the write then ends on a sector boundary
+  uint16_t frames;
+  bool newFile;                // Open `name` before writing
+  bool sync;                   // fsync after writing
+  char name[NAME_MAX_LEN];
+  std::atomic<uint8_t> state;
+};
+
+// Ping-pong: both sides visit the buffers in turn, so writes keep their order
+static LogBuffer g_buffers[2];
+
+// Producer (sample task)
+static uint8_t g_fill = NO_BUFFER;          // Buffer being filled
+static uint8_t g_nextFill = 0;
+static uint32_t g_fileBytes = 0;            // Bytes given to the current file, filling buffer included
+static bool g_rotate = true;                // Next buffer starts a file
+static bool g_syncPending = false;
+static uint32_t g_frameSeq = 0;
+static unsigned long g_lastSyncMs = 0;
+
+// Writer thread
+static USBHostMSD g_msd;
+static mbed::FATFileSystem g_fs("usb");
+static rtos::Thread g_writer(osPriorityLow, THREAD_STACK_BYTES, nullptr, "usb_log");
+static rtos::Semaphore g_wake(0);
+static FILE *g_file = nullptr;
+static uint8_t g_nextWrite = 0;
+static std::atomic<bool> g_remounted(false); // Writer -> producer: continue in a new file
+
+static UsbLoggerStatus g_status = {};
+static std::atomic<uint32_t> g_dropped(0);   // Both sides
+
+// --- Producer ---
+
+static void fileName(char *out, uint32_t epoch) {
+  const char *ext = (FORMAT == FORMAT_CSV) ? "csv" : "bin";
+  if (epoch != 0) {
+    char iso[WALL_CLOCK_ISO_LENGTH];
+    wall_clock_format_iso(iso, epoch); // "2026-01-31T23:59:59Z"
+    snprintf(out, NAME_MAX_LEN, "/usb/cc_%.4s%.2s%.2s_%.2s%.2s%.2s.%s", iso, iso + 5, iso + 8, iso + 11, iso + 14,
+             iso + 17, ext);
+  } else {
+    snprintf(out, NAME_MAX_LEN, "/usb/cc_s%lu.%s", (unsigned long)sample_log_newest_seq(), ext);
+  }
+}
+
+static void handOver(bool sync) {
+  LogBuffer &buf = g_buffers[g_fill];
+  buf.sync = sync || g_syncPending;
+  g_syncPending = false;
+  buf.state.store(BUF_FULL, std::memory_order_release);
+  g_wake.release();
+  g_fill = NO_BUFFER;
+}
+
+static bool nextBufferFree() {
+  return g_buffers[g_nextFill].state.load(std::memory_order_acquire) == BUF_FREE;
+}
+
+// `frameStart` false: the buffer continues a frame split at the sector
+// boundary, which must stay in the same file
+static void takeBuffer(uint32_t epoch, bool frameStart) {
+  LogBuffer &buf = g_buffers[g_nextFill];
+  g_fill = g_nextFill;
+  g_nextFill ^= 1;
+  buf.state.store(BUF_FILLING, std::memory_order_relaxed);
+  buf.len = 0;
+  buf.frames = 0;
+  buf.sync = false;
+  if (frameStart && g_remounted.exchange(false, std::memory_order_acquire)) g_rotate = true;
+  buf.newFile = frameStart && g_rotate;
+  if (buf.newFile) {
+    g_rotate = false;
+    g_fileBytes = 0;
+    fileName(buf.name, epoch);
+    if (FORMAT == FORMAT_CSV) {
+      buf.len = sample_csv_header((char *)buf.data);
+    } else {
+      uint32_t interval = Config::SAMPLE_INTERVAL_MS;
+      memcpy(buf.data, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+      memcpy(buf.data + sizeof(BINARY_MAGIC), &interval, sizeof(interval));
+      buf.len = sizeof(BINARY_MAGIC) + sizeof(interval);
+    }
+    g_fileBytes = buf.len;
+  }
+  // After a partial (synced) write the file ends mid-sector: stop at the next boundary
+  buf.limit = BUFFER_BYTES - (g_fileBytes - buf.len) % SECTOR_BYTES;
+}
+
+void usb_logger_append(const int16_t *sensors, uint8_t actuators, uint32_t epochS) {
+  uint8_t frame[FRAME_MAX];
+  size_t n;
+  g_frameSeq++;
+  if (FORMAT == FORMAT_CSV) {
+    SampleRecord record;
+    sample_log_encode(sensors, actuators, &record);
+    n = sample_csv_row((char *)frame, epochS, record);
+  } else {
+    UsbLogRecord record;
+    record.seq = g_frameSeq;
+    record.epoch = epochS;
+    sample_log_encode(sensors, actuators, &record.record);
+    memcpy(frame, &record, sizeof(record));
+    n = sizeof(record);
+  }
+
+  // Rotate between frames: the filled part ends the old file
+  if (g_fileBytes >= ROTATE_BYTES && !g_rotate) {
+    if (g_fill != NO_BUFFER) handOver(false);
+    g_rotate = true;
+  }
+
+  // Room for the whole frame, or it is dropped: a torn row would corrupt the file
+  if (g_fill == NO_BUFFER) {
+    if (!nextBufferFree()) {
+      g_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    takeBuffer(epochS, true);
+  }
+  LogBuffer *buf = &g_buffers[g_fill];
+  size_t room = buf->limit - buf->len;
+  if (n > room && !nextBufferFree()) {
+    g_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // Fill up to the sector boundary, the rest starts the next buffer
+  size_t first = (n < room) ? n : room;
+  memcpy(buf->data + buf->len, frame, first);
+  buf->len += first;
+  buf->frames++;
+  g_fileBytes += first;
+  if (buf->len == buf->limit) {
+    handOver(false);
+    if (first < n) {
+      takeBuffer(epochS, false);
+      buf = &g_buffers[g_fill];
+      memcpy(buf->data + buf->len, frame + first, n - first);
+      buf->len += n - first;
+      g_fileBytes += n - first;
+    }
+  }
+  g_status.framesLogged++;
+}
+
+void usb_logger_tick(unsigned long now) {
+  if (now - g_lastSyncMs < SYNC_INTERVAL_MS) return;
+  g_lastSyncMs = now;
+  if (g_fill != NO_BUFFER && g_buffers[g_fill].len > 0) {
+    handOver(true);
+  } else {
+    g_syncPending = true; // Nothing new: the next buffer carries the sync
+  }
+}
+
+unsigned long usb_logger_next_ms(unsigned long now) {
+  unsigned long due = g_lastSyncMs + SYNC_INTERVAL_MS;
+  return ((long)(due - now) < (long)Config::Scheduler::MAX_IDLE_MS) ? due : now + Config::Scheduler::MAX_IDLE_MS;
+}
+
+// --- Writer thread ---
+
+static void unmount(uint16_t lostFrames) {
+  if (g_file != nullptr) fclose(g_file);
+  g_file = nullptr;
+  g_fs.unmount();
+  g_status.mounted = false;
+  event_log(EVT_USB_REMOVED, lostFrames, g_status.writeErrors);
+}
+
+static bool tryMount() {
+  if (!g_msd.connect()) return false;
+  if (g_fs.mount(&g_msd) != 0) return false;
+  g_status.mounted = true;
+  g_remounted.store(true, std::memory_order_release);
+  event_log(EVT_USB_MOUNTED);
+  return true;
+}
+
+static bool openFile(const char *name) {
+  if (g_file != nullptr) fclose(g_file);
+  g_file = fopen(name, "ab");
+  if (g_file == nullptr) return false;
+  setvbuf(g_file, nullptr, _IONBF, 0); // Whole sectors straight to FAT, no second copy
+  g_status.files++;
+  event_log(EVT_USB_FILE, g_status.files);
+  return true;
+}
+
+static void writeBuffer(LogBuffer &buf) {
+  // A file cut off by a removal is not continued: its buffers wait for a new file
+  if (!g_status.mounted || (!buf.newFile && g_file == nullptr)) {
+    g_dropped.fetch_add(buf.frames, std::memory_order_relaxed);
+    return;
+  }
+
+  unsigned long start = millis();
+  bool ok = g_msd.connected() && (!buf.newFile || openFile(buf.name)) &&
+            fwrite(buf.data, 1, buf.len, g_file) == buf.len;
+  if (ok && buf.sync) ok = fflush(g_file) == 0 && fsync(fileno(g_file)) == 0;
+  unsigned long elapsed = millis() - start;
+  if (elapsed > g_status.maxWriteMs) g_status.maxWriteMs = elapsed;
+
+  if (ok) {
+    g_status.bytesWritten += buf.len;
+  } else {
+    g_status.writeErrors++;
+    g_dropped.fetch_add(buf.frames, std::memory_order_relaxed);
+    unmount(buf.frames);
+  }
+}
+
+static void writerMain() {
+  while (true) {
+    if (!g_status.mounted && !tryMount()) {
+      // No stick: release what the producer handed over, probe again later
+      while (g_buffers[g_nextWrite].state.load(std::memory_order_acquire) == BUF_FULL) {
+        LogBuffer &buf = g_buffers[g_nextWrite];
+        g_dropped.fetch_add(buf.frames, std::memory_order_relaxed);
+        buf.state.store(BUF_FREE, std::memory_order_release);
+        g_nextWrite ^= 1;
+      }
+      rtos::ThisThread::sleep_for(std::chrono::milliseconds(MOUNT_RETRY_MS));
+      continue;
+    }
+
+    g_wake.try_acquire_for(std::chrono::milliseconds(MOUNT_RETRY_MS));
+    while (g_buffers[g_nextWrite].state.load(std::memory_order_acquire) == BUF_FULL) {
+      LogBuffer &buf = g_buffers[g_nextWrite];
+      writeBuffer(buf);
+      buf.state.store(BUF_FREE, std::memory_order_release);
+      g_nextWrite ^= 1;
+    }
+    if (g_status.mounted && !g_msd.connected()) unmount(0);
+  }
+}
+
+void usb_logger_init() {
+  // VBUS on the USB-A port; the stick enumerates in the writer thread
+  MachineControl_USBController.begin();
+  g_lastSyncMs = millis();
+  g_writer.start(writerMain);
+  Serial.println(F("USB logger: waiting for a stick"));
+}
+
+void usb_logger_status(UsbLoggerStatus *out) {
+  *out = g_status;
+  out->framesDropped = g_dropped.load(std::memory_order_relaxed);
+}
+
+#endif // CC_USB_LOG
@@ -0,0 +1,96 @@
+/*
+ * *****************************************************************************
+ * USB LOGGER - SAMPLE FILES ON A USB STICK
+ * *****************************************************************************
+ * Writes every sample of chamber 0 to a FAT-formatted stick on the Machine
+ * Control's USB-A port (CC_USB_LOG=1):
+ * - Rotating files /usb/cc_YYYYMMDD_HHMMSS.csv (or .bin, Config::UsbLog::
+ *   FORMAT); without a wall time the name carries the flash log's sample
+ *   number instead. A file is closed beyond Config::UsbLog::ROTATE_BYTES.
+ * - Double buffering: usb_logger_append() formats into one buffer of
+ *   Config::UsbLog::BUFFER_BYTES while a writer thread writes the other.
+ *   Buffers are handed over full, so every write ends on a sector
+ *   boundary; a frame that finds no free buffer is dropped, never waited for.
+ * - Every Config::UsbLog::SYNC_INTERVAL_MS the partial buffer goes out too,
+ *   followed by an fsync: at most that much data is lost when the stick is
+ *   pulled. The next buffer is sized so its write ends aligned again.
+ * - A failed write or a disconnected stick unmounts it. The writer probes
+ *   for a stick every MOUNT_RETRY_MS and continues in a new file.
+ *
+ * All USB and file system calls block, so they run in the writer thread
+ * only; the control side touches RAM and two atomic buffer states.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "config.h"
+#include "sample_log.h"
+
+/**
+ * @brief Binary file record (Config::UsbLog::FORMAT_BINARY), 24 bytes
+ *
+ * Files start with the 4 magic bytes "CCUL" and a uint32 sample interval in
+ * ms, followed by records.
+ */
+struct UsbLogRecord {
+  uint32_t seq;            ///< Sample number since boot
+  uint32_t epoch;          ///< UTC seconds, 0 = clock unknown
+  SampleRecord record;     ///< Values as in the flash log (CRC included)
+} __attribute__((packed));
+
+static_assert(sizeof(UsbLogRecord) == 24, "UsbLogRecord must be exactly 24 bytes");
+
+/**
+ * @brief Logger counters
+ */
+struct UsbLoggerStatus {
+  bool mounted;            ///< A stick is mounted
+  uint32_t files;          ///< Files opened
+  uint32_t bytesWritten;   ///< Bytes the file system accepted
+  uint32_t framesLogged;   ///< Frames placed in a buffer
+  uint32_t framesDropped;  ///< Both buffers busy, or no stick when a buffer was due
+  uint32_t writeErrors;    ///< Writes that failed (stick removed, full)
+  uint32_t maxWriteMs;     ///< Longest buffer write incl. fsync
+};
+
+#if CC_USB_LOG
+
+/**
+ * @brief Power the USB-A port and start the writer thread (boot task)
+ */
+void usb_logger_init();
+
+/**
+ * @brief Add one sample frame to the filling buffer (sample task, no I/O)
+ *
+ * @param sensors 7 fixed-point sensor values in HistorySeries order
+ * @param actuators Packed ACTUATOR_BIT_* mask
+ * @param epochS Wall time of the frame (UTC seconds, 0 = unknown)
+ */
+void usb_logger_append(const int16_t *sensors, uint8_t actuators, uint32_t epochS);
+
+/**
+ * @brief Hand the partial buffer to the writer when a sync is due
+ */
+void usb_logger_tick(unsigned long now);
+
+/**
+ * @brief Next deadline for the scheduler
+ */
+unsigned long usb_logger_next_ms(unsigned long now);
+
+/**
+ * @brief Copy the counters
+ */
+void usb_logger_status(UsbLoggerStatus *out);
+
+#else
+
+inline void usb_logger_init() {}
+inline void usb_logger_append(const int16_t *, uint8_t, uint32_t) {}
+inline void usb_logger_status(UsbLoggerStatus *out) { *out = {}; }
+
+#endif
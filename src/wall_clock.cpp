@@ -0,0 +1,283 @@
+/*
+ * *****************************************************************************
+ * WALL CLOCK IMPLEMENTATION
+ * *****************************************************************************
+ */
+
+#include "wall_clock.h"
+#include "config.h"
+#include "seqlock.h"
+#include <Arduino_PortentaMachineControl.h>
+#include <atomic>
+
+// Published extrapolation base; epochMs 0 = time unknown
+struct WallClockBase {
+  uint64_t epochMs;
+  uint32_t baseMs;  // millis() at epochMs
+  float rate;       // Correction of millis(), 1e-6 = 1 ppm
+};
+
+enum SyncStage : uint8_t {
+  SYNC_IDLE,
+  SYNC_EDGE  // Polling the RTC for its next seconds change
+};
+
+static SeqLock<WallClockBase> g_base;
+static WallClockBase g_local = {};          // Writer-side copy
+static std::atomic<uint32_t> g_setRequest(0);
+
+// Writer state (wall_clock_tick only)
+static bool g_rtcReady = false;
+static SyncStage g_stage = SYNC_IDLE;
+static uint32_t g_edgeSecond = 0;           // RTC second the edge hunt started in
+static unsigned long g_edgeStartMs = 0;
+static unsigned long g_lastSyncMs = 0;      // Start of the last sync (due time base)
+static unsigned long g_lastEdgeMs = 0;      // millis() of the last measured edge
+static bool g_haveEdge = false;
+static WallClockStatus g_status = {};
+
+static bool plausible(uint32_t epoch) {
+  return epoch >= Config::WallClock::MIN_VALID_EPOCH;
+}
+
+static uint64_t extrapolate(const WallClockBase &base, uint32_t ms) {
+  uint32_t elapsed = ms - base.baseMs; // Wrap-safe
+  return base.epochMs + (uint64_t)((double)elapsed * (1.0 + base.rate));
+}
+
+static void publish() {
+  g_base.write(g_local);
+  g_status.valid = g_local.epochMs != 0;
+  g_status.ratePpm = g_local.rate * 1e6f;
+}
+
+static uint32_t readRtc() {
+  return (uint32_t)MachineControl_RTCController.getEpoch();
+}
+
+static void startSync(unsigned long now) {
+  g_stage = SYNC_EDGE;
+  g_edgeSecond = readRtc();
+  g_edgeStartMs = now;
+  g_lastSyncMs = now;
+}
+
+// The RTC just entered second `epoch` at millis() `now`
+static void onEdge(uint32_t epoch, unsigned long now) {
+  g_status.syncs++;
+  if (!plausible(epoch)) {
+    g_local.epochMs = 0;
+    g_haveEdge = false;
+    publish();
+    return;
+  }
+
+  uint64_t rtcMs = (uint64_t)epoch * 1000u;
+  int64_t error = (g_local.epochMs != 0) ? (int64_t)(rtcMs - extrapolate(g_local, now)) : INT64_MAX;
+  if (error > Config::WallClock::STEP_MS || error < -Config::WallClock::STEP_MS) {
+    g_status.steps++;
+    g_status.lastErrorMs = 0;
+  } else {
+    g_status.lastErrorMs = (int32_t)error;
+    unsigned long interval = now - g_lastEdgeMs;
+    if (g_haveEdge && interval > 0) {
+      // Residual error over the interval is what the current rate missed
+      float rate = g_local.rate + Config::WallClock::RATE_GAIN * (float)error / (float)interval;
+      const float limit = Config::WallClock::MAX_RATE_PPM * 1e-6f;
+      g_local.rate = (rate > limit) ? limit : (rate < -limit) ? -limit : rate;
+    }
+  }
+  g_local.epochMs = rtcMs;
+  g_local.baseMs = now;
+  g_lastEdgeMs = now;
+  g_haveEdge = true;
+  publish();
+}
+
+void wall_clock_init() {
+  g_rtcReady = MachineControl_RTCController.begin();
+  g_local = {};
+  if (g_rtcReady) {
+    uint32_t epoch = readRtc();
+    if (plausible(epoch)) {
+      // Somewhere inside this second: middle until the first edge is measured
+      g_local.epochMs = (uint64_t)epoch * 1000u + 500u;
+      g_local.baseMs = millis();
+    }
+    startSync(millis());
+  }
+  publish();
+  Serial.print(F("Wall clock: "));
+  if (!g_rtcReady) {
+    Serial.println(F("RTC not responding"));
+  } else if (g_local.epochMs == 0) {
+    Serial.println(F("RTC not set (POST /api/time?epoch=...)"));
+  } else {
+    char iso[WALL_CLOCK_ISO_LENGTH + 1];
+    iso[wall_clock_format_iso(iso, (uint32_t)(g_local.epochMs / 1000u))] = '\0';
+    Serial.println(iso);
+  }
+}
+
+void wall_clock_tick(unsigned long now) {
+  if (!g_rtcReady) return;
+
+  uint32_t request = g_setRequest.exchange(0, std::memory_order_acquire);
+  if (request != 0) {
+    MachineControl_RTCController.setEpoch((time_t)request);
+    g_local.epochMs = (uint64_t)request * 1000u;
+    g_local.baseMs = now;
+    g_haveEdge = false; // Rate stays, the next edge only rebases
+    g_status.steps++;
+    publish();
+    startSync(now);
+    return;
+  }
+
+  if (g_stage == SYNC_IDLE) {
+    if (now - g_lastSyncMs >= Config::WallClock::SYNC_INTERVAL_MS) startSync(now);
+    return;
+  }
+
+  uint32_t epoch = readRtc();
+  if (epoch != g_edgeSecond) {
+    g_stage = SYNC_IDLE;
+    onEdge(epoch, now);
+  } else if (now - g_edgeStartMs > Config::WallClock::EDGE_TIMEOUT_MS) {
+    g_stage = SYNC_IDLE; // RTC not counting (oscillator stopped): keep extrapolating
+  }
+}
+
+unsigned long wall_clock_next_ms(unsigned long now) {
+  if (!g_rtcReady) return now + Config::Scheduler::MAX_IDLE_MS;
+  if (g_stage == SYNC_EDGE || g_setRequest.load(std::memory_order_relaxed) != 0) {
+    return now + Config::WallClock::EDGE_POLL_MS;
+  }
+  unsigned long due = g_lastSyncMs + Config::WallClock::SYNC_INTERVAL_MS;
+  return ((long)(due - now) < (long)Config::Scheduler::MAX_IDLE_MS) ? due : now + Config::Scheduler::MAX_IDLE_MS;
+}
+
+uint32_t wall_clock_now() {
+  WallClockBase base;
+  g_base.read(&base);
+  if (base.epochMs == 0) return 0;
+  return (uint32_t)(extrapolate(base, millis()) / 1000u);
+}
+
+bool wall_clock_request_set(uint32_t epoch) {
+  if (!plausible(epoch)) return false;
+  g_setRequest.store(epoch, std::memory_order_release);
+  return true;
+}
+
+void wall_clock_status(WallClockStatus *out) {
+  *out = g_status;
+}
+
+// --- Calendar (proleptic Gregorian, UTC) ---
+
+// Days since 1970-01-01 of a civil date
+static int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+  y -= (m <= 2);
+  int32_t era = (y >= 0 ? y : y - 399) / 400;
+  uint32_t yoe = (uint32_t)(y - era * 400);
+  uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (int32_t)doe - 719468;
+}
+
+static void civilFromDays(int32_t z, int32_t *y, uint32_t *m, uint32_t *d) {
+  z += 719468;
+  int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+  uint32_t doe = (uint32_t)(z - era * 146097);
+  uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  uint32_t mp = (5 * doy + 2) / 153;
+  *d = doy - (153 * mp + 2) / 5 + 1;
+  *m = mp < 10 ? mp + 3 : mp - 9;
+  *y = (int32_t)yoe + era * 400 + (*m <= 2);
+}
+
+static void put2(char *out, uint32_t v) {
+  out[0] = (char)('0' + v / 10 % 10);
+  out[1] = (char)('0' + v % 10);
+}
+
+size_t wall_clock_format_iso(char *out, uint32_t epoch) {
+  int32_t y;
+  uint32_t m, d;
+  civilFromDays((int32_t)(epoch / 86400u), &y, &m, &d);
+  uint32_t s = epoch % 86400u;
+  put2(out, (uint32_t)y / 100);
+  put2(out + 2, (uint32_t)y % 100);
+  out[4] = '-';
+  put2(out + 5, m);
+  out[7] = '-';
+  put2(out + 8, d);
+  out[10] = 'T';
+  put2(out + 11, s / 3600);
+  out[13] = ':';
+  put2(out + 14, s / 60 % 60);
+  out[16] = ':';
+  put2(out + 17, s % 60);
+  out[19] = 'Z';
+  return WALL_CLOCK_ISO_LENGTH;
+}
+
+// `count` digits at text[*pos], false if there are fewer
+static bool digits(const char *text, size_t len, size_t *pos, uint8_t count, uint32_t *out) {
+  uint32_t v = 0;
+  for (uint8_t i = 0; i < count; i++, (*pos)++) {
+    if (*pos >= len || text[*pos] < '0' || text[*pos] > '9') return false;
+    v = v * 10 + (uint32_t)(text[*pos] - '0');
+  }
+  *out = v;
+  return true;
+}
+
+static bool expect(const char *text, size_t len, size_t *pos, char c) {
+  if (*pos >= len || text[*pos] != c) return false;
+  (*pos)++;
+  return true;
+}
+
+bool wall_clock_parse(const char *text, size_t len, uint32_t *epoch) {
+  if (len == 0) return false;
+
+  // Plain epoch seconds
+  size_t pos = 0;
+  uint64_t value = 0;
+  while (pos < len && text[pos] >= '0' && text[pos] <= '9' && value <= 0xFFFFFFFFu) {
+    value = value * 10 + (uint32_t)(text[pos] - '0');
+    pos++;
+  }
+  if (pos == len) {
+    if (value > 0xFFFFFFFFu) return false;
+    *epoch = (uint32_t)value;
+    return true;
+  }
+
+  // YYYY-MM-DD[THH:MM[:SS]][Z]
+  pos = 0;
+  uint32_t y, m, d, hh = 0, mm = 0, ss = 0;
+  if (!digits(text, len, &pos, 4, &y) || !expect(text, len, &pos, '-') || !digits(text, len, &pos, 2, &m) ||
+      !expect(text, len, &pos, '-') || !digits(text, len, &pos, 2, &d)) {
+    return false;
+  }
+  if (pos < len && (text[pos] == 'T' || text[pos] == ' ')) {
+    pos++;
+    if (!digits(text, len, &pos, 2, &hh) || !expect(text, len, &pos, ':') || !digits(text, len, &pos, 2, &mm)) {
+      return false;
+    }
+    if (pos < len && text[pos] == ':' && (pos++, !digits(text, len, &pos, 2, &ss))) return false;
+  }
+  if (pos < len && text[pos] == 'Z') pos++;
+  if (pos != len || y < 1970 || m < 1 || m > 12 || d < 1 || d > 31 || hh > 23 || mm > 59 || ss > 59) return false;
+  int32_t monthStart = daysFromCivil((int32_t)y, m, 1);
+  int32_t nextMonth = (m == 12) ? daysFromCivil((int32_t)y + 1, 1, 1) : daysFromCivil((int32_t)y, m + 1, 1);
+  if ((int32_t)d > nextMonth - monthStart) return false;
+  int64_t seconds = (int64_t)(monthStart + (int32_t)d - 1) * 86400 + hh * 3600 + mm * 60 + ss;
+  if (seconds < 0 || seconds > 0xFFFFFFFFLL) return false;
+  *epoch = (uint32_t)seconds;
+  return true;
+}
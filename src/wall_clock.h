@@ -0,0 +1,82 @@
+/*
+ * *****************************************************************************
+ * WALL CLOCK - RTC TIME DISCIPLINED AGAINST millis()
+ * *****************************************************************************
+ * UTC wall time for sample timestamps and the CSV export:
+ * - Source: the board's PCF8563T (MachineControl_RTCController), 1 s
+ *   resolution, one I2C transaction per read
+ * - Between reads the time is extrapolated from millis(), corrected by a
+ *   rate estimate (ppm): wall = base + (millis() - baseMs) * (1 + rate)
+ * - Every Config::WallClock::SYNC_INTERVAL_MS wall_clock_tick() polls the
+ *   RTC until its seconds change (the edge is the exact second), rebases
+ *   on it and trims the rate with the error it found; an error beyond
+ *   STEP_MS (RTC set, first sync) steps the time and keeps the rate
+ * - millis() enters only as differences, so its 49-day wrap does not matter
+ * - An RTC time before MIN_VALID_EPOCH (lost its backup supply) counts as
+ *   unknown: wall_clock_now() returns 0 until the RTC is set
+ *
+ * The RTC is only touched by wall_clock_tick() (control loop); other threads
+ * read the published base through a seqlock and queue a new time with
+ * wall_clock_request_set().
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Discipline state (GET /api/time)
+ */
+struct WallClockStatus {
+  bool valid;           ///< RTC time is plausible
+  float ratePpm;        ///< millis() correction, positive = millis() runs slow
+  int32_t lastErrorMs;  ///< RTC minus extrapolation at the last sync
+  uint32_t syncs;       ///< Edges measured
+  uint32_t steps;       ///< Syncs that stepped the time
+};
+
+/**
+ * @brief Start the RTC and take its time as the first base (call in setup())
+ */
+void wall_clock_init();
+
+/**
+ * @brief Apply a queued set, hunt the seconds edge when a sync is due
+ */
+void wall_clock_tick(unsigned long now);
+
+/**
+ * @brief Next deadline for the scheduler
+ */
+unsigned long wall_clock_next_ms(unsigned long now);
+
+/**
+ * @brief UTC seconds since 1970, 0 while unknown (any thread)
+ */
+uint32_t wall_clock_now();
+
+/**
+ * @brief Queue a new RTC time, written by the next wall_clock_tick()
+ *
+ * @return false if `epoch` is before Config::WallClock::MIN_VALID_EPOCH
+ */
+bool wall_clock_request_set(uint32_t epoch);
+
+void wall_clock_status(WallClockStatus *out);
+
+static constexpr size_t WALL_CLOCK_ISO_LENGTH = 20;  ///< "2026-01-31T23:59:59Z"
+
+/**
+ * @brief Format `epoch` as ISO 8601 UTC (WALL_CLOCK_ISO_LENGTH chars, no NUL)
+ */
+size_t wall_clock_format_iso(char *out, uint32_t epoch);
+
+/**
+ * @brief Parse decimal epoch seconds or "YYYY-MM-DD[THH:MM[:SS]][Z]" (UTC)
+ *
+ * @return false if the text is neither
+ */
+bool wall_clock_parse(const char *text, size_t len, uint32_t *epoch);
@@ -0,0 +1,243 @@
+/*
+ * *****************************************************************************
+ * WEB ASSETS - GENERATED BY scripts/build_web_assets.py, DO NOT EDIT
+ * *****************************************************************************
+ * Sources in web/. Each asset is minified and gzip-compressed; serve it
+ * with Content-Encoding: gzip and its ETag (see web_server.cpp).
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct WebAsset {
+  const char *path;         ///< Request path
+  const char *contentType;
+  const char *etag;         ///< Strong ETag including the quotes
+  const uint8_t *data;      ///< gzip stream (flash)
+  size_t length;
+  size_t plainLength;       ///< Minified size before compression
+};
+
+// dashboard.html: 9028 -> 3374 bytes
+static const uint8_t DASHBOARD_GZ[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xbd, 0x5a, 0xff, 0x72, 0xdb, 0xc6,
+  0x11, 0xfe, 0xdf, 0x4f, 0x01, 0x3b, 0x63, 0x1f, 0x10, 0x82, 0xe0, 0x2f, 0x89, 0x91, 0x40, 0x82,
+  0x1a, 0x47, 0xb1, 0x27, 0xe9, 0xd8, 0x71, 0xc7, 0x52, 0xa7, 0x33, 0x75, 0x3d, 0x1d, 0x10, 0x38,
+  0x12, 0xb0, 0x41, 0x00, 0xc5, 0x1d, 0x25, 0x32, 0x0c, 0xdf, 0xa9, 0xcf, 0xd0, 0x27, 0xeb, 0xb7,
+  0x77, 0x00, 0x08, 0x52, 0xa2, 0x2c, 0xbb, 0x69, 0xad, 0xb1, 0x08, 0xdc, 0x2d, 0xf6, 0xf6, 0xbe,
+  0xdd, 0xfd, 0x76, 0x0f, 0xd4, 0x38, 0x92, 0x8b, 0x64, 0x32, 0x8e, 0xb8, 0x1f, 0x4e, 0xc6, 0x32,
+  0x96, 0x09, 0x9f, 0x5c, 0x26, 0xf1, 0xc2, 0x97, 0xdc, 0xb8, 0xcc, 0x52, 0x59, 0x64, 0xc9, 0xb8,
+  0xa3, 0x87, 0xc7, 0x0b, 0x2e, 0x7d, 0x23, 0x88, 0xfc, 0x42, 0x70, 0xe9, 0xb1, 0xa5, 0x9c, 0xb5,
+  0xcf, 0xd8, 0x64, 0x2c, 0x82, 0x22, 0xce, 0xa5, 0x21, 0x8a, 0xc0, 0x63, 0x1d, 0x9a, 0x95, 0xce,
+  0x27, 0x71, 0x71, 0xe3, 0x9d, 0x38, 0x27, 0x4e, 0x17, 0xf3, 0x1d, 0x2d, 0x00, 0x41, 0xb9, 0x86,
+  0x96, 0x69, 0x16, 0xae, 0x37, 0x33, 0x68, 0x76, 0x7b, 0x27, 0xf9, 0xca, 0x78, 0x59, 0xc4, 0x7e,
+  0x32, 0x5a, 0xf8, 0xc5, 0x3c, 0x4e, 0xdd, 0xde, 0x69, 0xbe, 0x1a, 0x4d, 0xfd, 0xe0, 0xf3, 0xbc,
+  0xc8, 0x96, 0x69, 0xe8, 0x7e, 0x37, 0x3b, 0xa5, 0x9f, 0xad, 0x33, 0x2f, 0xe2, 0x70, 0x13, 0xc6,
+  0x22, 0x4f, 0xfc, 0xb5, 0x4b, 0x37, 0x23, 0xfa, 0xd5, 0x96, 0x7c, 0x81, 0x11, 0xc9, 0xdb, 0x41,
+  0x96, 0x2c, 0x17, 0xa9, 0x70, 0x0b, 0x9e, 0x73, 0x5f, 0x9a, 0xfe, 0x52, 0x66, 0xed, 0x59, 0x2c,
+  0xed, 0x45, 0x9c, 0x2e, 0xfc, 0x95, 0xd9, 0x3f, 0xeb, 0xe6, 0x2b, 0xbb, 0x37, 0x2b, 0x2c, 0x6b,
+  0x34, 0xf7, 0x73, 0xbd, 0x0e, 0x26, 0xda, 0xb7, 0x71, 0x28, 0x23, 0xf7, 0xbc, 0x8b, 0xe9, 0xad,
+  0x33, 0xcd, 0x56, 0x9b, 0xbd, 0xc5, 0x67, 0xb3, 0x51, 0xee, 0x87, 0x61, 0x9c, 0xce, 0x4b, 0xcb,
+  0xb2, 0x22, 0xe4, 0x45, 0xbb, 0xf0, 0xc3, 0x78, 0x29, 0x5c, 0x3d, 0xb2, 0x6a, 0x8b, 0xc8, 0x0f,
+  0xb3, 0x5b, 0xb7, 0x6b, 0xf4, 0xb1, 0x1d, 0xda, 0x52, 0x31, 0x9f, 0xfa, 0x66, 0xd7, 0x56, 0x3f,
+  0x4e, 0xcf, 0xda, 0x46, 0x3d, 0xb5, 0xdf, 0xb6, 0x88, 0x7f, 0xe3, 0x6e, 0xef, 0x4c, 0x2d, 0xad,
+  0xb6, 0xdb, 0x35, 0xba, 0x46, 0x0f, 0x4b, 0x8f, 0x60, 0x7e, 0x56, 0xb8, 0xdf, 0x0d, 0x06, 0x83,
+  0x6a, 0x8d, 0x69, 0x26, 0x65, 0xb6, 0x70, 0x49, 0xa5, 0xc8, 0x92, 0x38, 0x34, 0xbe, 0xeb, 0xf7,
+  0xce, 0x87, 0xaf, 0x07, 0x95, 0x41, 0x95, 0xc0, 0x19, 0x19, 0x2e, 0xf2, 0x76, 0x91, 0xdd, 0xd6,
+  0xf8, 0xcc, 0x12, 0xbe, 0x1a, 0xf9, 0x49, 0x3c, 0x4f, 0xdb, 0x31, 0x10, 0x12, 0x6e, 0xc0, 0x53,
+  0xc9, 0x8b, 0xd1, 0xa7, 0xa5, 0x90, 0xf1, 0x6c, 0x0d, 0xb0, 0x70, 0x0b, 0xfc, 0x45, 0xee, 0x07,
+  0xbc, 0x3d, 0xe5, 0xf2, 0x96, 0xf3, 0xb4, 0xb2, 0x09, 0x0a, 0x8d, 0x2e, 0xa9, 0xd4, 0x3e, 0xea,
+  0x93, 0x05, 0x8b, 0x2c, 0xcd, 0x94, 0xf0, 0x48, 0xed, 0xe3, 0x96, 0xc7, 0xf3, 0x48, 0xba, 0xd3,
+  0x2c, 0x09, 0x6b, 0x7c, 0xce, 0x0e, 0x1d, 0x37, 0x9b, 0x0d, 0x78, 0xf7, 0x00, 0x31, 0x80, 0x33,
+  0xaa, 0x8c, 0x8c, 0xd3, 0x24, 0x4e, 0xb1, 0x7a, 0x92, 0x05, 0x9f, 0xb7, 0x4e, 0x90, 0xf5, 0xdb,
+  0x58, 0xb2, 0xc4, 0x21, 0x1c, 0xf4, 0x67, 0xfd, 0xd9, 0xd6, 0x29, 0xa2, 0xc6, 0x60, 0xef, 0xfc,
+  0x87, 0x61, 0xd8, 0xdf, 0x3a, 0xe4, 0xf3, 0xc6, 0xf0, 0xe0, 0xec, 0x8c, 0x0f, 0x02, 0x68, 0x58,
+  0x16, 0x05, 0x36, 0xd5, 0x44, 0xba, 0xbf, 0x43, 0x76, 0x38, 0x1c, 0x96, 0x1b, 0x6c, 0xcb, 0x2c,
+  0x57, 0x86, 0x48, 0xbe, 0x92, 0x6d, 0x85, 0x52, 0x89, 0x0f, 0x02, 0x40, 0xa6, 0x9b, 0xc6, 0x86,
+  0x8c, 0xde, 0x10, 0x72, 0x0d, 0x85, 0xc3, 0x3a, 0x06, 0xdc, 0x34, 0x4b, 0xf9, 0x3d, 0xbb, 0x83,
+  0x15, 0x02, 0xeb, 0xe5, 0x59, 0xac, 0x10, 0xd7, 0xab, 0xdf, 0x46, 0x70, 0x83, 0xd2, 0x0e, 0xe8,
+  0xfb, 0xfb, 0x21, 0x76, 0x72, 0x32, 0x18, 0x0c, 0xeb, 0x39, 0xd7, 0x0f, 0x64, 0x7c, 0xc3, 0xf7,
+  0x44, 0x2a, 0x30, 0x48, 0xa4, 0x88, 0xf6, 0xa6, 0x74, 0x48, 0x54, 0x53, 0xf7, 0x3d, 0x4c, 0xa0,
+  0xfd, 0xd4, 0xd7, 0x12, 0x04, 0xdc, 0xde, 0xe4, 0xc9, 0xe5, 0xcb, 0xd7, 0xa7, 0xdd, 0xdd, 0xe4,
+  0x7d, 0x0a, 0x00, 0xef, 0xab, 0xc1, 0x25, 0xe0, 0xa5, 0xbc, 0x6e, 0xff, 0x8f, 0x32, 0xa4, 0xe9,
+  0x9a, 0xfb, 0x53, 0xb3, 0x5e, 0xbe, 0x2d, 0xa4, 0x2f, 0x97, 0xe2, 0xa8, 0x15, 0x03, 0x72, 0x1b,
+  0x54, 0x18, 0xa7, 0xe5, 0xc5, 0x1f, 0x60, 0xd2, 0xd9, 0x83, 0x16, 0x19, 0x48, 0xef, 0x7b, 0x62,
+  0xe9, 0xd0, 0x62, 0x63, 0x9f, 0x05, 0x06, 0xfb, 0x2c, 0x40, 0xa1, 0x7a, 0x90, 0xd9, 0xfd, 0x7b,
+  0x63, 0x34, 0xf0, 0xd3, 0x1b, 0x5f, 0x6c, 0x22, 0x9d, 0x82, 0xbd, 0x53, 0xd8, 0xf2, 0x34, 0x5e,
+  0xe4, 0x59, 0x21, 0xfd, 0x54, 0x96, 0xb3, 0x4e, 0x89, 0x51, 0x29, 0x74, 0xb2, 0x2f, 0xe3, 0xdc,
+  0xf8, 0x49, 0xc9, 0xbf, 0xc3, 0xbd, 0xdc, 0xae, 0x20, 0x1c, 0xee, 0x4c, 0x23, 0x60, 0xba, 0xfb,
+  0x79, 0x7d, 0x4e, 0x3f, 0x15, 0xa8, 0x09, 0x9f, 0x49, 0x05, 0xf9, 0xfd, 0x1c, 0xa5, 0xa6, 0x15,
+  0x43, 0xc9, 0x78, 0xc1, 0x1f, 0x97, 0x9a, 0xc4, 0x87, 0x5b, 0xd4, 0x0c, 0x55, 0x2b, 0xc6, 0x1d,
+  0x5d, 0x96, 0xa8, 0x66, 0xa0, 0x44, 0xf5, 0x0c, 0x35, 0xec, 0xb1, 0x66, 0x12, 0xee, 0xb4, 0xf6,
+  0x4f, 0x6a, 0xcb, 0x2b, 0x10, 0x29, 0x02, 0xd8, 0xae, 0x9e, 0x45, 0xfe, 0x62, 0xca, 0x8b, 0x5d,
+  0x5d, 0x8b, 0x7a, 0x93, 0x71, 0x18, 0xdf, 0x18, 0x41, 0xe2, 0x0b, 0xe1, 0x31, 0xb2, 0x92, 0x19,
+  0x71, 0x58, 0x5e, 0x4d, 0xde, 0x64, 0x3e, 0xed, 0xc3, 0x71, 0x9c, 0x71, 0x07, 0x62, 0x47, 0x64,
+  0xfd, 0xc4, 0x2f, 0x16, 0x82, 0x55, 0xb6, 0xed, 0x71, 0xd8, 0x1d, 0xc2, 0xa4, 0x7a, 0x78, 0xaf,
+  0xaa, 0xc9, 0x7b, 0x3f, 0x9d, 0x73, 0xd7, 0x18, 0x0b, 0x9e, 0xf0, 0x40, 0x2a, 0xcd, 0x05, 0x0d,
+  0x31, 0x23, 0x4b, 0x11, 0x4c, 0xb8, 0xf2, 0x18, 0xe4, 0xe5, 0x15, 0xff, 0xa7, 0xd7, 0x1d, 0x45,
+  0xd7, 0xf8, 0xb5, 0x34, 0x2d, 0xe8, 0xcb, 0x72, 0x19, 0x67, 0xa9, 0x01, 0xb7, 0x2e, 0x21, 0x02,
+  0xab, 0x91, 0xc3, 0x86, 0xd9, 0xeb, 0x1a, 0x28, 0x7e, 0xd6, 0xb8, 0xa3, 0xa7, 0x0f, 0xc5, 0x7a,
+  0x8b, 0x17, 0xa9, 0x77, 0x72, 0x86, 0xfa, 0x7c, 0x66, 0x44, 0x47, 0x85, 0x4e, 0x49, 0xea, 0x7c,
+  0xc8, 0x26, 0xfd, 0x93, 0x2f, 0x49, 0x0d, 0x7f, 0xe8, 0xb3, 0xc9, 0x0f, 0x46, 0xb8, 0x93, 0xea,
+  0xe8, 0x9d, 0xdc, 0xb3, 0x61, 0xaa, 0xdd, 0x6c, 0x6f, 0x04, 0x79, 0xc2, 0xc8, 0xc1, 0x93, 0xcb,
+  0x77, 0x7d, 0xe3, 0x8a, 0x4b, 0x45, 0xa0, 0x77, 0xfc, 0xa3, 0xeb, 0x1c, 0x04, 0xa7, 0x4b, 0x78,
+  0x37, 0xad, 0x1f, 0x96, 0xa9, 0x51, 0x12, 0xa8, 0x02, 0x2b, 0x89, 0x83, 0xcf, 0x70, 0x4b, 0xf8,
+  0xc9, 0x7c, 0x86, 0xa1, 0x67, 0x76, 0xbb, 0xd7, 0xed, 0x02, 0x28, 0xfa, 0x18, 0x77, 0xf4, 0xa3,
+  0x4a, 0xed, 0x81, 0x6e, 0x43, 0x17, 0x21, 0xed, 0x54, 0x2c, 0x45, 0xea, 0x26, 0xb5, 0xef, 0xe1,
+  0x98, 0x85, 0x9f, 0x24, 0x93, 0x3c, 0x5f, 0x60, 0x67, 0xea, 0xb2, 0xdc, 0xd8, 0xd7, 0x19, 0xa3,
+  0x6d, 0x69, 0xed, 0xd9, 0x72, 0x07, 0xa0, 0xb2, 0x98, 0x69, 0x53, 0xe8, 0x46, 0x1b, 0x73, 0xa9,
+  0x87, 0x5d, 0xa3, 0xdd, 0x36, 0x94, 0x1d, 0xea, 0xb9, 0x3b, 0x4f, 0xd7, 0x60, 0xbe, 0xff, 0xf9,
+  0x9b, 0xb1, 0x2c, 0xa2, 0x43, 0xeb, 0x8b, 0x88, 0x90, 0x54, 0x38, 0x3e, 0x88, 0xa2, 0x2a, 0xda,
+  0x35, 0x88, 0xd0, 0x73, 0x17, 0xc3, 0xe7, 0x8f, 0x42, 0xf0, 0x7e, 0x13, 0x7a, 0x0a, 0xbd, 0xaf,
+  0xc2, 0x8e, 0x6c, 0x68, 0x40, 0xf7, 0xfc, 0x8b, 0xb8, 0x5d, 0xa3, 0x18, 0x7e, 0x33, 0x72, 0x54,
+  0x49, 0x0f, 0x0d, 0xa7, 0xb1, 0xc7, 0xa1, 0x57, 0x76, 0x37, 0x35, 0x7e, 0x4a, 0xdb, 0x5d, 0x04,
+  0xff, 0xfd, 0xaf, 0xcb, 0x47, 0x61, 0x78, 0xdc, 0x98, 0x6f, 0xc0, 0x51, 0xdb, 0xd2, 0x40, 0x52,
+  0x59, 0xd1, 0xc0, 0x72, 0xa7, 0x43, 0x3d, 0x43, 0x15, 0x50, 0xd4, 0x84, 0x57, 0x9e, 0x02, 0x9e,
+  0x24, 0x5c, 0x1a, 0x7a, 0xca, 0xfb, 0xf0, 0xd1, 0x26, 0xee, 0x43, 0xb9, 0x5a, 0xe4, 0xea, 0x0e,
+  0xcb, 0x78, 0x9b, 0xed, 0xe8, 0x09, 0x3a, 0x54, 0x01, 0xa9, 0xd9, 0xfc, 0xed, 0x32, 0x91, 0xb1,
+  0x67, 0x86, 0xbe, 0xf4, 0x71, 0xe6, 0x10, 0x76, 0xc8, 0x03, 0x50, 0x79, 0x22, 0x2c, 0x6f, 0x62,
+  0x6e, 0xe4, 0x3a, 0xe7, 0x2e, 0xa3, 0x36, 0x92, 0xd9, 0x24, 0xe1, 0x6e, 0x12, 0x7f, 0xca, 0x13,
+  0xe1, 0xee, 0x94, 0xda, 0xd5, 0x93, 0x6e, 0x75, 0xb1, 0xb5, 0x35, 0x3f, 0x09, 0x77, 0x53, 0x70,
+  0x91, 0xe3, 0x02, 0x74, 0xe9, 0xca, 0x62, 0xc9, 0xed, 0x85, 0x0f, 0x77, 0xe3, 0xff, 0x4b, 0x91,
+  0x83, 0xb7, 0xde, 0xfb, 0x10, 0x73, 0x67, 0x58, 0x8c, 0xdb, 0x79, 0xb2, 0x44, 0x51, 0xc1, 0x23,
+  0x09, 0x9f, 0x73, 0x94, 0xc1, 0xba, 0xd5, 0xae, 0xb4, 0x3a, 0x09, 0x4f, 0xe7, 0x32, 0x9a, 0xf4,
+  0xec, 0x3c, 0x13, 0x31, 0xe9, 0x77, 0x19, 0xaa, 0x19, 0xdb, 0xda, 0x32, 0xcb, 0xb0, 0x85, 0xdc,
+  0xdd, 0x04, 0x70, 0x16, 0x55, 0x52, 0x51, 0x9a, 0xe9, 0x06, 0x72, 0xe5, 0x4d, 0xf0, 0xcb, 0x29,
+  0x95, 0x38, 0x6a, 0xb8, 0xc5, 0x5c, 0x83, 0xb5, 0xcc, 0x6a, 0xa3, 0x17, 0x24, 0x90, 0xd3, 0x89,
+  0x2b, 0x74, 0xd6, 0x8e, 0xcc, 0x5e, 0xc7, 0x2b, 0x1e, 0xd6, 0xb3, 0x96, 0xdb, 0x9c, 0xb6, 0xb6,
+  0xdb, 0xad, 0x2d, 0xb0, 0x0e, 0xc7, 0x1a, 0x2b, 0x77, 0x23, 0x63, 0xb5, 0x1a, 0x5a, 0x97, 0xf7,
+  0x99, 0xf4, 0x95, 0x51, 0x27, 0xa7, 0x74, 0x24, 0x6a, 0xdc, 0xe2, 0x89, 0xb5, 0xbb, 0x99, 0x72,
+  0x6c, 0xef, 0xa5, 0xfc, 0x1b, 0x2f, 0xaa, 0x1d, 0x97, 0xcf, 0x56, 0x46, 0xbb, 0xb3, 0x65, 0x1a,
+  0xd0, 0x23, 0xa6, 0x22, 0x7d, 0x0b, 0xd8, 0xc9, 0x65, 0x91, 0x1a, 0xb5, 0x99, 0x6a, 0xf8, 0xae,
+  0x7d, 0x0e, 0x0e, 0x64, 0x09, 0x9a, 0x0b, 0x93, 0xd9, 0xf8, 0x71, 0x98, 0xe5, 0x2a, 0xc1, 0xd1,
+  0x56, 0xfd, 0xb3, 0x1a, 0x9e, 0xfe, 0x31, 0x4e, 0xbd, 0x0a, 0xcd, 0xff, 0xaf, 0x73, 0xe1, 0xc7,
+  0x6c, 0x29, 0xdd, 0xba, 0xf3, 0xdf, 0x50, 0x1b, 0xd2, 0xb5, 0xcb, 0x0e, 0xa2, 0x6b, 0xab, 0x2e,
+  0xe6, 0xd4, 0x2e, 0x54, 0x0d, 0x27, 0xc0, 0x8e, 0x46, 0x83, 0xd2, 0xf7, 0xcd, 0x2e, 0x6f, 0xba,
+  0xf2, 0x82, 0xbd, 0xfb, 0x95, 0xb9, 0xec, 0xdd, 0xeb, 0xd7, 0xec, 0xd0, 0xab, 0x07, 0x8b, 0xc1,
+  0x7b, 0x0b, 0x6a, 0x22, 0xb1, 0xc1, 0x95, 0xdb, 0xab, 0xfc, 0x26, 0x24, 0xcf, 0xaf, 0x54, 0xa7,
+  0x65, 0xd7, 0x2e, 0xbc, 0xf1, 0x26, 0x37, 0x0d, 0xbd, 0x95, 0x07, 0x2a, 0xcf, 0x1a, 0xd3, 0x65,
+  0x9c, 0x84, 0x66, 0x60, 0x6d, 0x28, 0x43, 0xc1, 0x85, 0x5e, 0x98, 0x05, 0xcb, 0x05, 0x52, 0xdd,
+  0x99, 0x73, 0xf9, 0x2a, 0xe1, 0x74, 0xf9, 0xe3, 0xfa, 0x97, 0xd0, 0xac, 0x32, 0x9b, 0xdc, 0xa7,
+  0x13, 0x39, 0xd0, 0xed, 0xae, 0x70, 0x16, 0x7e, 0x6e, 0x9a, 0x41, 0x64, 0xc7, 0x48, 0x50, 0xa5,
+  0x47, 0xb9, 0x53, 0x4d, 0xa7, 0x29, 0xbc, 0xe7, 0xcc, 0xe2, 0x04, 0x6d, 0xac, 0x09, 0x18, 0x56,
+  0xfa, 0x19, 0xcf, 0x8b, 0x2d, 0x7b, 0x0a, 0xe7, 0x93, 0xe4, 0x87, 0xee, 0x47, 0x87, 0x1c, 0xef,
+  0x81, 0xaa, 0x02, 0xb9, 0xf4, 0x65, 0x56, 0x30, 0xca, 0xf9, 0x7a, 0xb2, 0x0a, 0x2c, 0x9b, 0x36,
+  0xe8, 0x05, 0x91, 0xa3, 0xda, 0xd2, 0xce, 0x5b, 0x5f, 0x46, 0x4e, 0x9e, 0xdd, 0xa2, 0xeb, 0x21,
+  0x71, 0x18, 0x46, 0x6b, 0xf3, 0x64, 0xb7, 0x85, 0xa0, 0xe0, 0xe8, 0x00, 0xcb, 0x5d, 0x98, 0x0c,
+  0x8c, 0x04, 0xf3, 0x79, 0xe2, 0x28, 0xb2, 0xfb, 0xd5, 0x5f, 0x70, 0x0f, 0x36, 0x5c, 0xb0, 0xc3,
+  0xae, 0x1d, 0x58, 0xd5, 0x43, 0x8c, 0xe4, 0x63, 0x6c, 0xa3, 0xf8, 0xf9, 0xfa, 0xed, 0x1b, 0x8f,
+  0x51, 0xa5, 0x60, 0x2d, 0xd8, 0xa0, 0xde, 0x8e, 0xb4, 0x98, 0x2e, 0x14, 0xba, 0x05, 0x87, 0x3b,
+  0x49, 0xdf, 0xb3, 0x9a, 0xd9, 0xb5, 0xb6, 0x67, 0x2e, 0x63, 0x56, 0x8b, 0x28, 0x51, 0x8b, 0x4d,
+  0x18, 0x1d, 0x46, 0x1c, 0x3f, 0xcf, 0x11, 0x47, 0x97, 0x11, 0xe1, 0xcf, 0x93, 0xd2, 0xfa, 0x50,
+  0xa8, 0x5d, 0x2b, 0x48, 0x57, 0x94, 0x11, 0x3a, 0x84, 0x56, 0x3a, 0x66, 0x74, 0x4e, 0x80, 0x32,
+  0x75, 0x2b, 0x7c, 0xa9, 0x9a, 0x4e, 0x40, 0x4a, 0x9f, 0xf6, 0xae, 0x61, 0xdf, 0x1b, 0x6f, 0xb1,
+  0xc1, 0x80, 0xd9, 0x38, 0xfa, 0x0b, 0xca, 0x7d, 0xb2, 0xaf, 0xeb, 0x76, 0x9d, 0x81, 0xc2, 0x32,
+  0xe7, 0x21, 0x8d, 0xd8, 0xf0, 0x4f, 0x42, 0x17, 0x5b, 0x0b, 0x66, 0x94, 0x49, 0xbe, 0x51, 0x10,
+  0xb8, 0x29, 0xbf, 0xa5, 0x0e, 0xba, 0x90, 0xb0, 0xd1, 0xa1, 0x4e, 0x54, 0x19, 0x4c, 0xbe, 0xbb,
+  0xd0, 0xf9, 0x6b, 0x86, 0x44, 0x48, 0x25, 0x69, 0xe3, 0x46, 0xb9, 0xc2, 0xb2, 0x3f, 0xf3, 0xb5,
+  0x70, 0x9b, 0x5b, 0x59, 0x39, 0x18, 0xb2, 0xec, 0x42, 0x99, 0x60, 0x52, 0x58, 0x5a, 0x2e, 0x7d,
+  0xb4, 0x4c, 0xe5, 0x47, 0x65, 0xb8, 0x79, 0xd3, 0x21, 0xb3, 0xac, 0xef, 0xd5, 0xef, 0x26, 0xb1,
+  0x58, 0xd6, 0x76, 0x84, 0xb8, 0xdd, 0xee, 0x02, 0x37, 0x4e, 0x63, 0xa9, 0x0c, 0x13, 0xa6, 0xb5,
+  0x89, 0x67, 0x26, 0x45, 0x50, 0x36, 0xd3, 0xb6, 0x7a, 0x08, 0x25, 0xa8, 0xe3, 0x33, 0x10, 0x49,
+  0xc8, 0xac, 0x0d, 0xf1, 0x4d, 0x96, 0x70, 0x27, 0xc9, 0xe6, 0x26, 0xbb, 0x2c, 0x5f, 0x56, 0x19,
+  0x69, 0x26, 0x8d, 0x04, 0xcd, 0x3e, 0x0f, 0x8d, 0x35, 0x97, 0xb6, 0x81, 0x8d, 0x17, 0x6b, 0xdd,
+  0xf9, 0x23, 0x4c, 0x60, 0xfb, 0x35, 0x48, 0x07, 0x24, 0x61, 0xee, 0x96, 0x52, 0x8d, 0xdc, 0x48,
+  0x23, 0x34, 0xda, 0xee, 0xa9, 0xfd, 0x05, 0x42, 0x31, 0x4e, 0x6d, 0xbf, 0x41, 0x43, 0x59, 0xea,
+  0xb4, 0xa2, 0x27, 0x33, 0x2e, 0x83, 0xc8, 0x64, 0x1d, 0x3f, 0x8f, 0x3b, 0x55, 0x4a, 0x30, 0xec,
+  0x2e, 0xe2, 0xa9, 0x59, 0x78, 0x93, 0x02, 0xb6, 0x80, 0x62, 0xad, 0x72, 0x24, 0x40, 0x0e, 0x55,
+  0x49, 0x39, 0xf2, 0x13, 0xd3, 0x1a, 0xdd, 0xb5, 0x5e, 0xa8, 0xdd, 0xab, 0xd5, 0x68, 0x7f, 0x23,
+  0x6c, 0xff, 0x69, 0x02, 0xd2, 0x83, 0x92, 0x4d, 0x9e, 0x25, 0x09, 0xc5, 0xd0, 0x2f, 0x74, 0x72,
+  0x04, 0xef, 0x9a, 0x4b, 0x7b, 0xd0, 0x25, 0xab, 0x71, 0x6e, 0x00, 0x03, 0x5b, 0x4e, 0xe0, 0x93,
+  0x39, 0x1c, 0xcb, 0x54, 0x8a, 0x79, 0x51, 0x64, 0x45, 0xa9, 0x5a, 0x69, 0x36, 0xd4, 0x88, 0xcb,
+  0x6c, 0x7e, 0x0c, 0x07, 0xad, 0x52, 0x79, 0xe4, 0x36, 0x4e, 0x71, 0xa8, 0x76, 0xb2, 0x94, 0xb0,
+  0xf4, 0x76, 0x32, 0x3a, 0xa0, 0xeb, 0xc3, 0x8b, 0xad, 0x0c, 0x03, 0xc3, 0x2e, 0xc5, 0x1a, 0xa7,
+  0x98, 0xb2, 0x06, 0x24, 0xd3, 0xc4, 0x93, 0xde, 0x44, 0xb1, 0xcd, 0xcf, 0xd9, 0xb2, 0x80, 0x33,
+  0xe1, 0xf6, 0x2b, 0x59, 0x00, 0x45, 0x5c, 0x82, 0x9d, 0xaf, 0x24, 0x05, 0x5f, 0xdf, 0x66, 0x5d,
+  0x4a, 0x22, 0x97, 0xb5, 0x94, 0xec, 0xdb, 0x38, 0x5d, 0x4a, 0xfe, 0x58, 0xe9, 0x2b, 0x8e, 0xd5,
+  0xc2, 0x87, 0xa5, 0x1b, 0x9c, 0x18, 0x85, 0x85, 0x19, 0x5a, 0x9b, 0x27, 0x47, 0xa9, 0xb0, 0x3c,
+  0x27, 0x58, 0x0d, 0x62, 0x08, 0x1d, 0x51, 0xb6, 0x8e, 0x82, 0xde, 0x6b, 0x8d, 0x1e, 0x7c, 0x18,
+  0xbd, 0xe9, 0xb1, 0x67, 0x8b, 0xa8, 0x0e, 0xfb, 0x9e, 0xf5, 0xb0, 0x16, 0xd5, 0x99, 0x1d, 0xd3,
+  0x43, 0x93, 0x7b, 0x9a, 0xc8, 0x19, 0x51, 0x21, 0x3c, 0x95, 0x6d, 0xb3, 0x24, 0x83, 0xc7, 0x43,
+  0x75, 0x42, 0xef, 0x0c, 0x86, 0xe4, 0x4b, 0x9a, 0x47, 0x4d, 0x69, 0xce, 0x97, 0x02, 0xcf, 0x95,
+  0x40, 0x67, 0xd8, 0x7d, 0xc8, 0x1e, 0x75, 0x9c, 0x6d, 0x1a, 0xc3, 0xfe, 0x92, 0xd3, 0x98, 0x2a,
+  0x72, 0x58, 0x77, 0xdc, 0xeb, 0x5e, 0x00, 0x66, 0x45, 0x85, 0xb8, 0x55, 0xbe, 0x31, 0xb1, 0x5e,
+  0x73, 0x1c, 0xb7, 0x2d, 0x66, 0xfc, 0x6e, 0xbc, 0x41, 0xcc, 0x18, 0xcb, 0x1c, 0x64, 0xa7, 0x1e,
+  0x27, 0x0a, 0xfa, 0x09, 0xd7, 0xca, 0x7d, 0x6f, 0x32, 0x2a, 0x8a, 0x14, 0x91, 0xa5, 0x23, 0x59,
+  0xc8, 0xdb, 0x3f, 0xbd, 0x62, 0xf6, 0x26, 0x42, 0xf8, 0xb8, 0xac, 0xdf, 0x0e, 0xe3, 0x79, 0x2c,
+  0x19, 0x75, 0x3c, 0x88, 0x90, 0xc6, 0x00, 0xcd, 0xf7, 0xfa, 0x65, 0x05, 0xa5, 0xc0, 0x55, 0x88,
+  0x5c, 0xef, 0x62, 0x31, 0x47, 0xd1, 0x32, 0x51, 0xc2, 0x14, 0x02, 0xf4, 0x02, 0xf9, 0xb4, 0x6b,
+  0xeb, 0x6b, 0xb0, 0x1c, 0x12, 0xbf, 0xbc, 0xd3, 0x4c, 0xa5, 0x33, 0x9c, 0xaa, 0x93, 0x7e, 0xf9,
+  0x5d, 0xbe, 0x84, 0x41, 0xcb, 0x0d, 0x48, 0xfe, 0x4a, 0xef, 0x8c, 0x7e, 0xff, 0x1d, 0x49, 0x62,
+  0x59, 0x7b, 0x81, 0x65, 0x16, 0x73, 0x45, 0x56, 0xb4, 0x1d, 0x27, 0x45, 0xe9, 0xb2, 0xda, 0xd1,
+  0xf5, 0x18, 0xf0, 0x42, 0xb2, 0x64, 0x15, 0x58, 0xb4, 0x9b, 0x1d, 0x35, 0xb9, 0x23, 0x8a, 0x05,
+  0x4a, 0xe3, 0xfa, 0x02, 0x4d, 0x8e, 0xc7, 0x5a, 0xc5, 0xbc, 0xc5, 0x5e, 0x68, 0x67, 0xe3, 0x2e,
+  0x27, 0x1a, 0x3c, 0xca, 0x29, 0x21, 0x92, 0x5d, 0x07, 0xb5, 0x8e, 0x03, 0x34, 0x5d, 0x1f, 0x76,
+  0x1b, 0x20, 0xaa, 0xc6, 0xe7, 0xc7, 0xb2, 0x9d, 0xb5, 0xb1, 0xb2, 0xb7, 0xc3, 0x7c, 0xb4, 0x6b,
+  0xbd, 0x4a, 0x01, 0x42, 0x6c, 0x86, 0xf0, 0x20, 0x4d, 0x31, 0x6e, 0xe2, 0x71, 0x3a, 0x8a, 0x5b,
+  0x2d, 0xdd, 0x42, 0x64, 0xb3, 0x19, 0xe2, 0x70, 0x75, 0x81, 0xff, 0x1f, 0xe2, 0x8f, 0x6e, 0x6c,
+  0xcb, 0x9d, 0x2e, 0x28, 0xa6, 0xb8, 0x21, 0xe7, 0x61, 0xe3, 0x88, 0x2e, 0xe8, 0x6b, 0xf7, 0xda,
+  0x78, 0xc4, 0xfa, 0x3e, 0x74, 0xe2, 0x92, 0xb0, 0xfe, 0xb1, 0x10, 0x7b, 0x8b, 0xe6, 0x4b, 0x11,
+  0x99, 0x2a, 0xe0, 0xb4, 0x41, 0x2d, 0x74, 0x94, 0x2d, 0x3d, 0xf0, 0x36, 0x4b, 0x65, 0x84, 0x91,
+  0x1e, 0x0d, 0x22, 0x52, 0xc0, 0x26, 0xa6, 0xb4, 0x1c, 0x81, 0x73, 0x0f, 0x37, 0xbb, 0xf6, 0xa9,
+  0x45, 0x6e, 0x2e, 0xb9, 0x18, 0x16, 0xbf, 0xf2, 0x81, 0x25, 0xf1, 0x6b, 0xd9, 0xb9, 0xa8, 0x86,
+  0x4c, 0x57, 0x56, 0xe1, 0xed, 0x56, 0x1c, 0x05, 0x0a, 0x92, 0xfa, 0x09, 0xf3, 0xb3, 0xee, 0x6c,
+  0xf6, 0x9e, 0xaa, 0x9a, 0x4f, 0x6c, 0x52, 0x5d, 0x03, 0xd1, 0xcf, 0x1f, 0x55, 0xad, 0x0b, 0x9c,
+  0x42, 0x31, 0x63, 0x25, 0xae, 0x03, 0xd9, 0x64, 0xf4, 0xde, 0x8a, 0xa9, 0x99, 0x27, 0x0f, 0xb1,
+  0xf0, 0x6b, 0xf2, 0x78, 0x93, 0x80, 0xf7, 0xcb, 0x1e, 0x58, 0x5c, 0xe1, 0x5c, 0xcc, 0x8f, 0x77,
+  0x6a, 0xfa, 0x0d, 0x92, 0xe5, 0xe8, 0xae, 0x1b, 0xe1, 0x46, 0x51, 0xa7, 0x62, 0xaf, 0x2e, 0x5d,
+  0x4f, 0x30, 0x4a, 0x4c, 0x5c, 0x45, 0x9d, 0x62, 0xe5, 0xde, 0x7e, 0xad, 0x12, 0x71, 0x1a, 0xf0,
+  0x0b, 0x01, 0xf2, 0x06, 0xb2, 0x9a, 0xc6, 0x8f, 0x46, 0x18, 0xba, 0xe8, 0xaf, 0xdb, 0x13, 0x7a,
+  0xc2, 0x14, 0x3d, 0xea, 0xda, 0xa4, 0x8c, 0xdb, 0x94, 0x45, 0x61, 0x7f, 0xab, 0xba, 0xa2, 0x51,
+  0xba, 0x3c, 0x2d, 0x6b, 0xcc, 0xab, 0x1b, 0xec, 0xf1, 0x0a, 0x79, 0x1c, 0xf0, 0xd2, 0x70, 0x43,
+  0xa5, 0xb3, 0x22, 0x2f, 0x64, 0x05, 0x45, 0x5a, 0x43, 0xa6, 0xda, 0x87, 0x44, 0x1b, 0xb8, 0x20,
+  0x86, 0xe7, 0x02, 0x65, 0x2a, 0x43, 0xdb, 0xe5, 0x2d, 0xd5, 0x0d, 0xac, 0x56, 0xe2, 0x6f, 0x90,
+  0x59, 0x1c, 0xc4, 0x65, 0xea, 0xd7, 0x7a, 0xcc, 0xf6, 0x93, 0x4a, 0x1a, 0x41, 0x21, 0xfc, 0x39,
+  0xf7, 0x68, 0x57, 0xb0, 0xe4, 0x71, 0x98, 0x5b, 0x1b, 0x2a, 0xb6, 0x15, 0xd6, 0x07, 0x50, 0xab,
+  0x36, 0xcf, 0xfb, 0xd3, 0xd5, 0xbb, 0x5f, 0x75, 0xe3, 0x6f, 0x72, 0x15, 0x40, 0x58, 0x90, 0xf4,
+  0x3b, 0x84, 0xb7, 0x57, 0xc2, 0x8d, 0xc0, 0x86, 0x89, 0x94, 0xb6, 0x88, 0x50, 0x6e, 0x54, 0xf3,
+  0x93, 0xca, 0x1b, 0xaa, 0xa4, 0x97, 0x86, 0x2a, 0x74, 0x15, 0x7f, 0x91, 0x9d, 0x18, 0xc2, 0xa6,
+  0xc3, 0x35, 0x2a, 0x9c, 0x44, 0x63, 0xdd, 0x7f, 0xf1, 0xe2, 0x29, 0xd5, 0x5f, 0xeb, 0x68, 0x77,
+  0xb0, 0xad, 0x1b, 0x3f, 0x3a, 0x38, 0x35, 0xdd, 0x40, 0x3d, 0xc8, 0xa6, 0x19, 0x17, 0xe5, 0xab,
+  0xcf, 0x07, 0xd9, 0x46, 0xd1, 0x8c, 0x8f, 0xd3, 0xfd, 0x28, 0xa4, 0x34, 0xa0, 0x17, 0xb0, 0x7b,
+  0x29, 0x18, 0x38, 0xfa, 0x6b, 0x87, 0x7a, 0x2c, 0xf5, 0x26, 0xbe, 0x4e, 0x75, 0xb3, 0xf1, 0x44,
+  0x75, 0xc0, 0xbe, 0x60, 0x97, 0x68, 0xba, 0xab, 0x71, 0x14, 0x09, 0x5d, 0x30, 0xd2, 0xfa, 0xa4,
+  0xd9, 0xf9, 0x47, 0x67, 0x6e, 0x63, 0xd8, 0x52, 0x84, 0x7b, 0xd4, 0x4b, 0x3b, 0xd3, 0xf9, 0x4a,
+  0x5e, 0xea, 0x6f, 0xc4, 0x3c, 0xbf, 0x5c, 0xe6, 0x82, 0xbd, 0xa4, 0x69, 0x2a, 0x39, 0xbe, 0xf3,
+  0x09, 0xcc, 0x8a, 0xf3, 0x2b, 0x34, 0x62, 0xa5, 0xd1, 0x7f, 0x91, 0xb0, 0xda, 0x81, 0xdf, 0x4e,
+  0xbf, 0xca, 0xe9, 0xa0, 0x7c, 0x2e, 0xad, 0x47, 0x33, 0xf1, 0x21, 0x7b, 0x12, 0x2f, 0x1e, 0x63,
+  0x61, 0x62, 0xe0, 0xd8, 0xfa, 0x5e, 0x45, 0x01, 0x61, 0x77, 0x8b, 0xfe, 0x9e, 0x9b, 0x77, 0x96,
+  0x9a, 0x28, 0xb6, 0x6e, 0x6a, 0x16, 0x51, 0x3c, 0x93, 0x66, 0x7d, 0x1c, 0xfc, 0x03, 0x08, 0xb6,
+  0x3c, 0x00, 0x1d, 0xe3, 0x59, 0x1b, 0xf1, 0x2a, 0x0e, 0x78, 0xf6, 0x49, 0x03, 0x9e, 0x50, 0x68,
+  0x26, 0x26, 0x31, 0x95, 0x30, 0x9b, 0x72, 0x44, 0x83, 0x80, 0x6e, 0x9c, 0x66, 0xac, 0x91, 0xde,
+  0x61, 0x35, 0xb7, 0xb7, 0xbd, 0x6a, 0xb0, 0xda, 0xdb, 0x36, 0x58, 0x16, 0x58, 0xcf, 0x2b, 0xc7,
+  0x3f, 0xec, 0x3f, 0xd4, 0xee, 0x7d, 0xfc, 0x02, 0xd1, 0x57, 0xdd, 0xaf, 0x4a, 0x5b, 0x65, 0x2c,
+  0x14, 0x52, 0x7f, 0xf8, 0xd4, 0xf3, 0xea, 0x03, 0xca, 0x43, 0x9d, 0x66, 0xfd, 0x1a, 0x78, 0xaf,
+  0xb5, 0xaa, 0xdf, 0xc6, 0x21, 0x29, 0xb4, 0x3e, 0xa4, 0x44, 0x9e, 0x2f, 0xd8, 0xe8, 0x0b, 0x9a,
+  0x0e, 0x1a, 0xcf, 0x43, 0x45, 0x7b, 0xcd, 0x67, 0x8b, 0x3d, 0xff, 0xa2, 0xbe, 0x3b, 0x2d, 0xe8,
+  0xa1, 0xc6, 0x83, 0x36, 0xb4, 0xc5, 0xfe, 0xbe, 0xec, 0x76, 0xa7, 0xdd, 0x4b, 0xa4, 0xd4, 0x5e,
+  0x8e, 0x7c, 0x52, 0xe7, 0x37, 0x9c, 0x1d, 0x13, 0x30, 0xa1, 0x66, 0x0f, 0x91, 0xdb, 0xf4, 0x0d,
+  0x90, 0x7a, 0x35, 0x58, 0x9e, 0xef, 0x3c, 0xfa, 0xa2, 0x05, 0x58, 0x6c, 0x44, 0xee, 0x29, 0xee,
+  0x04, 0x8d, 0x99, 0x8f, 0xec, 0xd2, 0xaf, 0x91, 0xf1, 0x38, 0xcd, 0xe4, 0x2d, 0x4f, 0x2d, 0x42,
+  0x79, 0x25, 0xf2, 0xf1, 0x09, 0xa2, 0x1e, 0xca, 0xf0, 0xa1, 0x07, 0x26, 0x3d, 0xd5, 0x8b, 0x61,
+  0x48, 0x5d, 0x8c, 0xc8, 0x02, 0xc2, 0xd7, 0x13, 0x39, 0x92, 0xba, 0x62, 0xe1, 0xd2, 0x16, 0x42,
+  0xb3, 0x36, 0xe5, 0x35, 0x8e, 0x3f, 0x0f, 0x1b, 0xb3, 0x03, 0xff, 0x7e, 0x5b, 0xce, 0xfa, 0xb4,
+  0xee, 0x59, 0xbf, 0xb4, 0xe4, 0x7c, 0x48, 0xb7, 0xe7, 0x43, 0x6d, 0x43, 0x11, 0x79, 0x2d, 0xb1,
+  0xd7, 0xd1, 0xdf, 0x31, 0x47, 0x3b, 0xe3, 0x2b, 0x0c, 0x6a, 0x7a, 0xef, 0x7e, 0x93, 0x7a, 0x67,
+  0x0a, 0x8a, 0xb3, 0xd2, 0xa4, 0x81, 0xb2, 0x70, 0xd0, 0xd7, 0x26, 0xd1, 0xe3, 0x77, 0x8d, 0xda,
+  0xeb, 0x20, 0xaa, 0xe3, 0x08, 0xda, 0xf3, 0x05, 0x97, 0x51, 0x16, 0xba, 0xec, 0xcf, 0xef, 0xae,
+  0xae, 0xd1, 0x8c, 0xa3, 0x38, 0x81, 0xe0, 0xdd, 0x0d, 0x2b, 0x59, 0xb8, 0x7d, 0x8d, 0x4d, 0x80,
+  0xd5, 0xfd, 0x3c, 0x47, 0xf7, 0xa6, 0x5e, 0x54, 0x76, 0xa8, 0xaa, 0xb0, 0xad, 0x8a, 0x02, 0x57,
+  0xd5, 0x4b, 0xa1, 0x5a, 0xfe, 0x78, 0xb6, 0x36, 0x69, 0xcc, 0xda, 0x3e, 0x58, 0x82, 0x14, 0x33,
+  0x28, 0x5a, 0xb6, 0x70, 0x62, 0xc0, 0x39, 0x8f, 0xbd, 0x52, 0x1c, 0x8d, 0xc8, 0xac, 0xc6, 0xf5,
+  0x99, 0xb8, 0xc1, 0xed, 0x87, 0x82, 0x5c, 0x75, 0x90, 0xbb, 0x3f, 0x66, 0xe9, 0xe8, 0xef, 0x24,
+  0x3b, 0xea, 0xaf, 0x67, 0xfe, 0x03, 0x52, 0x8c, 0x4a, 0xfa, 0x44, 0x23, 0x00, 0x00,
+};
+
+static const WebAsset WEB_ASSETS[] = {
+  {"/", "text/html; charset=utf-8", "\"fa4a8c52\"", DASHBOARD_GZ, sizeof(DASHBOARD_GZ), 9028},
+};
+
+static constexpr uint8_t WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);
@@ -1,50 +1,302 @@
 #include "web_server.h"
+#include "actuator_stats.h"
+#include "alarms.h"
+#include "asset_store.h"
+#include "can_link.h"
 #include "controller.h"
+#include "control_link.h"
+#include "downsample.h"
+#include "event_log.h"
+#include "fixed_point.h"
+#include "json_reader.h"
+#include "memory_regions.h"
+#include "perf.h"
+#include "sample_codec.h"
+#include "sample_csv.h"
+#include "sample_log.h"
+#include "scheduler.h"
+#include "sensor_trace.h"
+#include "storage.h"
+#include "telemetry_format.h"
+#include "usb_logger.h"
+#include "wall_clock.h"
+#include "web_assets.h"
 
-// Cached JSON response - rebuilt only when data changes
-static String cachedJsonResponse = "";
-static unsigned long lastCacheUpdate = 0;
-static const unsigned long CACHE_VALID_MS = 900; // Cache for 900ms (just under 1s sample rate)
-
-static void sendJson(WiFiClient &client, const String &body) {
-  client.println("HTTP/1.1 200 OK");
-  client.println("Content-Type: application/json");
-  client.println("Connection: close");
-  client.println();
-  client.println(body);
-}
-
-static void sendHtml(WiFiClient &client, const String &body) {
-  client.println("HTTP/1.1 200 OK");
-  client.println("Content-Type: text/html");
-  client.println("Connection: close");
-  client.println();
-  client.println(body);
-}
-
-static void serveIndex(WiFiClient &client, const WebServerConfig *config) {
-  String html;
-  html.reserve(256);
-  html += "<!DOCTYPE html><html><head><meta "
-          "charset=\"utf-8\"><title>Counter</title>";
-  html += "<meta name=\"viewport\" "
-          "content=\"width=device-width,initial-scale=1\"></head><body>";
-  html += "<h1 id=\"count\">Counter: ";
+// --- HTTP connection pool ---
+//
+// Each browser connection is advanced by a small, bounded amount of work per
+// web_server_handle() call: request line -> headers -> response writer. No
+// call ever waits on a slow client, so the control tasks keep their timing no
+// matter how many dashboards are open.
+
+static constexpr uint8_t MAX_CONNECTIONS = Config::WebUI::HTTP_MAX_CONNECTIONS;
+static constexpr uint16_t READ_BUDGET_BYTES = Config::WebUI::HTTP_READ_BUDGET_BYTES;
+static constexpr uint16_t WRITE_BUDGET_BYTES = Config::WebUI::HTTP_WRITE_BUDGET_BYTES;
+static constexpr unsigned long IDLE_TIMEOUT_MS = Config::WebUI::HTTP_IDLE_TIMEOUT_MS;
+static constexpr uint16_t ASSET_WRITE_BUDGET_BYTES = Config::WebUI::HTTP_ASSET_WRITE_BUDGET_BYTES;
+static constexpr uint16_t KEEPALIVE_MAX_REQUESTS = Config::WebUI::HTTP_KEEPALIVE_MAX_REQUESTS;
+
+static constexpr uint16_t MAX_HEADER_BYTES = Config::WebUI::HTTP_MAX_HEADER_BYTES;
+
+static constexpr size_t REQUEST_BUFFER_SIZE = 384; // Request line + current header line + read-ahead
+static constexpr size_t REQUEST_LINE_MAX = 128;   // Longer request lines are refused (414)
+static constexpr size_t HEAD_BUFFER_SIZE = 256;   // Response status line + headers
+static constexpr size_t ETAG_BUFFER_SIZE = 24;    // If-None-Match value (one ETag and some)
+static constexpr size_t SCRATCH_BUFFER_SIZE = 512; // Small generated bodies / one chunk
+static constexpr size_t CHUNK_HEADER_SIZE = 6;     // "hhh\r\n" in front of a chunk payload
+static constexpr size_t CHUNK_TRAILER_SIZE = 2;    // "\r\n" after a chunk payload
+
+enum HttpConnState {
+  CONN_FREE,
+  CONN_REQUEST_LINE,
+  CONN_HEADERS,
+  CONN_BODY,
+  CONN_RESPONSE,
+  CONN_CLOSE
+};
+
+enum HttpMethod : uint8_t {
+  HTTP_GET,
+  HTTP_PUT,
+  HTTP_POST,
+  HTTP_OTHER
+};
+
+struct HttpConnection;
+
+// Fills `out` with the next piece of a streamed body; returns 0 when done
+typedef size_t (*BodyGenerator)(HttpConnection &conn, char *out, size_t cap);
+
+// Part of the request buffer; not NUL-terminated
+struct HttpSlice {
+  const char *data;
+  uint16_t len;
+};
+
+// Consumes the next piece of a request body; called once more with len 0
+// when the body is complete, and must then start the response
+typedef void (*BodySink)(HttpConnection &conn, const uint8_t *data, size_t len);
+
+struct HttpConnection {
+  WiFiClient client;
+  HttpConnState state;
+  unsigned long lastActivityMs;
+
+  // Request parsing, in place: the request line stays at the front of
+  // `request` (target, path and query point into it); header lines are
+  // parsed behind it and dropped. Bytes read past the header block (body,
+  // pipelined request) stay buffered at [scanPos, fill).
+  char request[REQUEST_BUFFER_SIZE];
+  uint16_t lineStart;     // Header region: just behind the request line
+  uint16_t scanPos;       // Start of the next unparsed line
+  uint16_t fill;          // Bytes buffered
+  uint16_t headerBytes;   // Header block so far, against MAX_HEADER_BYTES
+  bool lineOverflow;      // Dropping the rest of an overlong header line
+  const char *target;     // Request target as sent, NUL-terminated
+  HttpSlice path;         // Target up to '?'
+  HttpSlice query;        // After '?', empty if none
+  char ifNoneMatch[ETAG_BUFFER_SIZE];
+  HttpMethod method;
+  uint8_t chamber;        // Config::Chambers index of a /api/c/{id}/ request (fleet: of the node), else 0
+  uint8_t fleetNode;      // Target node of POST /api/fleet/setpoints
+  int32_t contentLength;  // -1 = no Content-Length header
+  bool keepAlive;         // Reuse the connection after this response
+  uint16_t requests;      // Requests served on this connection, including this one
+
+  // Request body (PUT/POST handlers)
+  BodySink sink;
+  uint32_t bodyRemaining;
+
+  // Response writer
+  char head[HEAD_BUFFER_SIZE];
+  uint16_t headLen;
+  uint16_t headSent;
+  const char *body;
+  size_t bodyLen;
+  size_t bodySent;
+  uint16_t writeBudget; // Bytes per tick for this response
+  char scratch[SCRATCH_BUFFER_SIZE];
+
+  // Streaming body (chunked transfer encoding)
+  BodyGenerator generator;
+  uint8_t genSeries;   // Serializer cursor: current series
+  uint16_t genIndex;   // Serializer cursor: current sample within series
+  uint32_t genSeq;     // Newest sample when the response started
+  uint16_t genCount;   // Samples per series in this response
+  bool genStarted;     // Document prefix emitted
+  bool genRaw;         // Content-Length body: no chunk framing
+  bool genDelta;       // Emit the /api/since header fields
+  bool genReset;       // Delta response is a full resync
+  HistoryResolution genRes; // Tier served by /api/history
+  uint16_t genPoints;  // Downsampled output points per series (?points=N)
+  uint16_t genPrevX;   // LTTB: offset and value of the previous pick
+  int16_t genPrevY;
+  uint16_t genEmitted; // Records written by /api/events (some may be skipped)
+  uint32_t genFrom;    // Wall time range of /api/export.csv
+  uint32_t genUntil;
+  uint32_t genBytes;   // Payload bytes produced so far
+  uint32_t genMicros;  // CPU time spent in the generator so far
+
+  HttpConnection() : state(CONN_FREE), lastActivityMs(0), lineStart(0), scanPos(0), fill(0), headerBytes(0),
+                     lineOverflow(false), target(""), path{"", 0}, query{"", 0},
+                     method(HTTP_GET), chamber(0), fleetNode(0), contentLength(-1), keepAlive(false), requests(0), sink(nullptr), bodyRemaining(0),
+                     headLen(0), headSent(0), body(nullptr), bodyLen(0), bodySent(0),
+                     writeBudget(WRITE_BUDGET_BYTES), generator(nullptr), genSeries(0), genIndex(0), genSeq(0), genCount(0),
+                     genStarted(false), genRaw(false), genDelta(false), genReset(false), genRes(RES_RAW), genPoints(0),
+                     genPrevX(0), genPrevY(0), genEmitted(0),
+                     genBytes(0), genMicros(0) {
+    request[0] = '\0';
+    ifNoneMatch[0] = '\0';
+    head[0] = '\0';
+    scratch[0] = '\0';
+  }
+};
+
+static HttpConnection g_connections[MAX_CONNECTIONS];
+
+// --- Request slices ---
+
+static bool sliceIs(HttpSlice slice, const char *text) {
+  size_t len = strlen(text);
+  return slice.len == len && memcmp(slice.data, text, len) == 0;
+}
+
+static bool sliceStartsWith(HttpSlice slice, const char *prefix) {
+  size_t len = strlen(prefix);
+  return slice.len >= len && memcmp(slice.data, prefix, len) == 0;
+}
+
+static HttpSlice sliceFrom(HttpSlice slice, uint16_t offset) {
+  return (offset < slice.len) ? HttpSlice{slice.data + offset, (uint16_t)(slice.len - offset)}
+                              : HttpSlice{slice.data + slice.len, 0};
+}
+
+// Value of "<name>=" in a query string; empty if absent
+static HttpSlice queryParam(HttpSlice query, const char *name) {
+  size_t nameLen = strlen(name);
+  const char *p = query.data;
+  const char *end = query.data + query.len;
+  while (p < end) {
+    const char *amp = (const char *)memchr(p, '&', end - p);
+    const char *pairEnd = (amp != nullptr) ? amp : end;
+    if ((size_t)(pairEnd - p) > nameLen && p[nameLen] == '=' && memcmp(p, name, nameLen) == 0) {
+      const char *value = p + nameLen + 1;
+      return HttpSlice{value, (uint16_t)(pairEnd - value)};
+    }
+    p = pairEnd + 1;
+  }
+  return HttpSlice{end, 0};
+}
+
+// Numeric value of a slice (0 if not a number, like String::toInt/toFloat)
+static long sliceToLong(HttpSlice slice) {
+  char text[16];
+  size_t len = (slice.len < sizeof(text) - 1) ? slice.len : sizeof(text) - 1;
+  memcpy(text, slice.data, len);
+  text[len] = '\0';
+  return strtol(text, nullptr, 10);
+}
+
+static float sliceToFloat(HttpSlice slice) {
+  char text[16];
+  size_t len = (slice.len < sizeof(text) - 1) ? slice.len : sizeof(text) - 1;
+  memcpy(text, slice.data, len);
+  text[len] = '\0';
+  return strtof(text, nullptr);
+}
+
+// Value of the Connection header; decides whether the connection is reused.
+// A request body the handler did not read would be parsed as the next
+// request, so such a response always closes.
+static const char *connectionHeader(HttpConnection &conn) {
+  if (conn.bodyRemaining > 0 || conn.requests >= KEEPALIVE_MAX_REQUESTS) conn.keepAlive = false;
+  return conn.keepAlive ? "keep-alive" : "close";
+}
+
+// Prepare status line + headers and point the writer at the body
+static void beginResponse(HttpConnection &conn, const char *status, const char *contentType,
+                          const char *body, size_t bodyLen) {
+  int n = snprintf(conn.head, sizeof(conn.head),
+                   "HTTP/1.1 %s\r\n"
+                   "Content-Type: %s\r\n"
+                   "Content-Length: %u\r\n"
+                   "Connection: %s\r\n"
+                   "\r\n",
+                   status, contentType, (unsigned)bodyLen, connectionHeader(conn));
+  conn.headLen = (n > 0 && (size_t)n < sizeof(conn.head)) ? n : 0;
+  conn.headSent = 0;
+  conn.body = body;
+  conn.bodyLen = bodyLen;
+  conn.bodySent = 0;
+  conn.writeBudget = WRITE_BUDGET_BYTES;
+  conn.generator = nullptr;
+  conn.state = CONN_RESPONSE;
+}
+
+// Prepare headers for a body produced incrementally by `generator`
+static void beginChunkedResponse(HttpConnection &conn, const char *contentType,
+                                 BodyGenerator generator) {
+  int n = snprintf(conn.head, sizeof(conn.head),
+                   "HTTP/1.1 200 OK\r\n"
+                   "Content-Type: %s\r\n"
+                   "Transfer-Encoding: chunked\r\n"
+                   "Connection: %s\r\n"
+                   "\r\n",
+                   contentType, connectionHeader(conn));
+  conn.headLen = (n > 0 && (size_t)n < sizeof(conn.head)) ? n : 0;
+  conn.headSent = 0;
+  conn.body = nullptr;
+  conn.bodyLen = 0;
+  conn.bodySent = 0;
+  conn.writeBudget = WRITE_BUDGET_BYTES;
+  conn.generator = generator;
+  conn.genRaw = false;
+  conn.genSeries = 0;
+  conn.genIndex = 0;
+  conn.genStarted = false;
+  conn.genDelta = false;
+  conn.genReset = false;
+  conn.genRes = RES_RAW;
+  conn.genPoints = 0;
+  conn.genPrevX = 0;
+  conn.genPrevY = 0;
+  conn.genEmitted = 0;
+  conn.genFrom = 0;
+  conn.genUntil = 0;
+  conn.genBytes = 0;
+  conn.genMicros = 0;
+  conn.state = CONN_RESPONSE;
+}
+
+// Respond with a body formatted into the per-connection scratch buffer
+static void beginScratchResponse(HttpConnection &conn, const char *status,
+                                 const char *contentType, int len) {
+  size_t bodyLen = (len > 0) ? (size_t)len : 0;
+  if (bodyLen >= sizeof(conn.scratch)) bodyLen = sizeof(conn.scratch) - 1;
+  beginResponse(conn, status, contentType, conn.scratch, bodyLen);
+}
+
+static void serveIndex(HttpConnection &conn, const WebServerConfig *config) {
+  uint16_t count = 0;
   if (config != nullptr && config->values != nullptr && config->values_len > 0) {
-    html += String(config->values[0]);
-  } else {
-    html += "0";
+    count = config->values[0];
   }
-  html += "</h1>";
-  html += "<button id=\"inc\">Increment</button>";
-  html += "<script>document.getElementById('inc').onclick=function(){fetch('/"
-          "inc').then(r=>r.json()).then(j=>{document.getElementById('count')."
-          "innerText='Counter: '+j.count});};</script>";
-  html += "</body></html>";
-  sendHtml(client, html);
+  int len = snprintf(conn.scratch, sizeof(conn.scratch),
+      "<!DOCTYPE html><html><head><meta "
+      "charset=\"utf-8\"><title>Counter</title>"
+      "<meta name=\"viewport\" "
+      "content=\"width=device-width,initial-scale=1\"></head><body>"
+      "<h1 id=\"count\">Counter: %u</h1>"
+      "<button id=\"inc\">Increment</button>"
+      "<script>document.getElementById('inc').onclick=function(){fetch('/"
+      "inc').then(r=>r.json()).then(j=>{document.getElementById('count')."
+      "innerText='Counter: '+j.count});};</script>"
+      "</body></html>\r\n",
+      (unsigned)count);
+  beginScratchResponse(conn, "200 OK", "text/html", len);
 }
 
-static void handleIncrement(WiFiClient &client, const WebServerConfig *config) {
+static void handleIncrement(HttpConnection &conn, const WebServerConfig *config) {
   if (config != nullptr && config->on_increment != nullptr) {
     config->on_increment();
   }
@@ -52,440 +304,2856 @@ static void handleIncrement(WiFiClient &client, const WebServerConfig *config) {
   if (config != nullptr && config->values != nullptr && config->values_len > 0) {
     count = config->values[0];
   }
-  String json = "{\"count\":" + String(count) + "}";
-  sendJson(client, json);
-}
-
-// Comprehensive Climate UI with all setpoints and current values
-static void serveClimateUI(WiFiClient &client) {
-  client.println("HTTP/1.1 200 OK");
-  client.println("Content-Type: text/html");
-  client.println("Connection: close");
-  client.println();
-  
-  // Comprehensive HTML with all controls
-  client.print(F("<html><head><title>Climate Control</title><meta charset='utf-8'>"));
-  client.print(F("<script src='https://cdn.jsdelivr.net/npm/chart.js@4.4.0/dist/chart.umd.min.js'></script>"));
-  client.print(F("<style>body{font:14px Arial;margin:15px;background:#f5f5f5}"));
-  client.print(F(".grid{display:grid;grid-template-columns:repeat(auto-fit,minmax(280px,1fr));gap:15px;max-width:900px}"));
-  client.print(F(".box{background:#fff;padding:15px;border-radius:5px;box-shadow:0 2px 4px rgba(0,0,0,0.1)}"));
-  client.print(F("h1{font-size:18px;margin:0 0 10px;color:#333;border-bottom:2px solid #2196F3;padding-bottom:8px}"));
-  client.print(F(".sp-row{display:flex;align-items:center;justify-content:space-between;margin:8px 0}"));
-  client.print(F(".sp{font:22px monospace;font-weight:bold;padding:8px;background:#fff3e0;border-radius:4px;display:inline-block}"));
-  client.print(F(".co2-sp{color:#d32f2f}.rh-sp{color:#1976d2}.temp-sp{color:#388e3c}"));
-  client.print(F(".current{font-size:12px;color:#666;margin-top:4px;text-align:center}"));
-  client.print(F(".btn{padding:8px 16px;font-size:16px;border:none;border-radius:4px;cursor:pointer;color:white}"));
-  client.print(F(".btn-co2{background:#f44336}.btn-co2:active{background:#d32f2f}"));
-  client.print(F(".btn-rh{background:#2196F3}.btn-rh:active{background:#1976D2}"));
-  client.print(F(".btn-temp{background:#4CAF50}.btn-temp:active{background:#388E3C}"));
-  client.print(F(".chart-box{background:#fff;padding:15px;border-radius:5px;box-shadow:0 2px 4px rgba(0,0,0,0.1);margin-top:15px;max-width:900px}"));
-  client.print(F(".chart-box-status{background:#fff;padding:3px 15px 5px 15px;border-radius:5px;box-shadow:0 2px 4px rgba(0,0,0,0.1);margin-top:8px;max-width:900px}"));
-  client.print(F(".chart-box h1{text-align:center}"));
-  client.print(F(".chart-box-status h1{font-size:13px;margin:0 0 2px;padding-bottom:2px;text-align:center}"));
-  client.print(F("canvas{height:150px!important}"));
-  client.print(F("canvas.status{height:40px!important}"));
-  client.print(F(".val{font:16px monospace;padding:6px;margin:4px 0;background:#f9f9f9;border-left:3px solid #2196F3;padding-left:8px}"));
-  client.print(F(".time{font-size:12px;color:#666;margin-top:10px}"));
-  client.print(F("</style></head><body>"));
-  
-  client.print(F("<h1 style='border:none;font-size:24px;margin-bottom:15px'>Climate Chamber Control</h1>"));
-  client.print(F("<div class='time' id='time'>Loading...</div>"));
-  
-  client.print(F("<div class='grid'>"));
-  
-  // CO2 Setpoint box
-  client.print(F("<div class='box'><h1>CO2 Setpoint</h1>"));
-  client.print(F("<div class='sp-row'>"));
-  client.print(F("<button class='btn btn-co2' onclick='adj(\"co2\",-100)'>-100</button>"));
-  client.print(F("<div><div class='sp co2-sp' id='sp-co2'>...</div> <small>ppm</small></div>"));
-  client.print(F("<button class='btn btn-co2' onclick='adj(\"co2\",100)'>+100</button>"));
-  client.print(F("</div>"));
-  client.print(F("<div class='current' id='curr-co2'>Current: -- ppm</div>"));
-  client.print(F("</div>"));
-  
-  // RH Setpoint box
-  client.print(F("<div class='box'><h1>RH Setpoint</h1>"));
-  client.print(F("<div class='sp-row'>"));
-  client.print(F("<button class='btn btn-rh' onclick='adj(\"rh\",-1)'>-1</button>"));
-  client.print(F("<div><div class='sp rh-sp' id='sp-rh'>...</div> <small>%</small></div>"));
-  client.print(F("<button class='btn btn-rh' onclick='adj(\"rh\",1)'>+1</button>"));
-  client.print(F("</div>"));
-  client.print(F("<div class='current' id='curr-rh'>Current: --%</div>"));
-  client.print(F("</div>"));
-  
-  // Temp Setpoint box
-  client.print(F("<div class='box'><h1>Temp Setpoint</h1>"));
-  client.print(F("<div class='sp-row'>"));
-  client.print(F("<button class='btn btn-temp' onclick='adj(\"temp\",-1)'>-1</button>"));
-  client.print(F("<div><div class='sp temp-sp' id='sp-temp'>...</div> <small>\u00b0C</small></div>"));
-  client.print(F("<button class='btn btn-temp' onclick='adj(\"temp\",1)'>+1</button>"));
-  client.print(F("</div>"));
-  client.print(F("<div class='current' id='curr-temp'>Current: --\u00b0C</div>"));
-  client.print(F("</div>"));
-  
-  client.print(F("</div>")); // end grid
-  
-  // Charts (ordered: CO2, FreshAir, RH, Fogger, Swirler, Temp, Heater)
-  client.print(F("<div class='chart-box'><h1>CO2 (ppm)</h1><canvas id='co2Chart'></canvas></div>"));
-  client.print(F("<div class='chart-box-status'><h1>Fresh Air Status</h1><canvas class='status' id='freshairChart'></canvas></div>"));
-  client.print(F("<div class='chart-box'><h1>Relative Humidity (%)</h1><canvas id='rhChart'></canvas></div>"));
-  client.print(F("<div class='chart-box-status'><h1>Fogger Status</h1><canvas class='status' id='foggerChart'></canvas></div>"));
-  client.print(F("<div class='chart-box-status'><h1>Swirler Status</h1><canvas class='status' id='swirlerChart'></canvas></div>"));
-  client.print(F("<div class='chart-box'><h1>Temperature (°C)</h1><canvas id='tempChart'></canvas></div>"));
-  client.print(F("<div class='chart-box-status'><h1>Heater Status</h1><canvas class='status' id='heaterChart'></canvas></div>"));
-  
-  // JavaScript
-  client.print(F("<script>"));
-  client.print(F("let co2Chart,rhChart,tempChart,foggerChart,swirlerChart,freshairChart,heaterChart,timestamps=[];"));
-  client.print(F("const cfg=(label,color,decimals)=>({type:'line',data:{labels:timestamps,datasets:[{label:label,data:[],borderColor:color,backgroundColor:color+'33',tension:0.3,fill:true}]},options:{responsive:true,maintainAspectRatio:false,plugins:{legend:{display:false},tooltip:{callbacks:{label:ctx=>label+': '+(decimals?ctx.parsed.y.toFixed(decimals):ctx.parsed.y)}}},scales:{x:{ticks:{maxRotation:45,minRotation:45}},y:{beginAtZero:false,ticks:{callback:function(value){return decimals?value.toFixed(decimals).replace(',','.'):value;}}}}}});"));
-  client.print(F("const cfgMulti=(datasets,decimals)=>({type:'line',data:{labels:timestamps,datasets:datasets},options:{responsive:true,maintainAspectRatio:false,plugins:{legend:{display:true,position:'top'},tooltip:{callbacks:{label:ctx=>ctx.dataset.label+': '+(decimals?ctx.parsed.y.toFixed(decimals):ctx.parsed.y)}}},scales:{x:{ticks:{maxRotation:45,minRotation:45}},y:{beginAtZero:false,ticks:{callback:function(value){return decimals?value.toFixed(decimals).replace(',','.'):value;}}}}}});"));
-  client.print(F("const cfgBin=(label,color)=>({type:'line',data:{labels:timestamps,datasets:[{label:label,data:[],borderColor:color,backgroundColor:color+'33',tension:0,stepped:true,fill:true}]},options:{responsive:true,maintainAspectRatio:false,layout:{padding:{top:0,bottom:0,left:5,right:5}},plugins:{legend:{display:false},tooltip:{callbacks:{label:ctx=>label+': '+(ctx.parsed.y?'ON':'OFF')}}},scales:{x:{display:false},y:{min:0,max:1,ticks:{stepSize:1,callback:v=>v?'ON':'OFF'}}}}});"));
-  client.print(F("function initCharts(){if(typeof Chart==='undefined'){console.log('Chart.js not loaded yet, retrying...');setTimeout(initCharts,100);return;}console.log('Initializing charts...');try{co2Chart=new Chart(document.getElementById('co2Chart'),cfgMulti([{label:'CO2 Main',data:[],borderColor:'#f44336',backgroundColor:'#f4433633',tension:0.3,fill:false},{label:'CO2 2nd',data:[],borderColor:'#e91e63',backgroundColor:'#e91e6333',tension:0.3,fill:false}],0));rhChart=new Chart(document.getElementById('rhChart'),cfgMulti([{label:'RH Main',data:[],borderColor:'#2196F3',backgroundColor:'#2196F333',tension:0.3,fill:false},{label:'RH 2nd',data:[],borderColor:'#64B5F6',backgroundColor:'#64B5F633',tension:0.3,fill:false}],1));tempChart=new Chart(document.getElementById('tempChart'),cfgMulti([{label:'Temp Main',data:[],borderColor:'#4CAF50',backgroundColor:'#4CAF5033',tension:0.3,fill:false},{label:'Temp 2nd',data:[],borderColor:'#66BB6A',backgroundColor:'#66BB6A33',tension:0.3,fill:false},{label:'Temp Outer',data:[],borderColor:'#8BC34A',backgroundColor:'#8BC34A33',tension:0.3,fill:false}],1));foggerChart=new Chart(document.getElementById('foggerChart'),cfgBin('Fogger','#9C27B0'));swirlerChart=new Chart(document.getElementById('swirlerChart'),cfgBin('Swirler','#FF9800'));freshairChart=new Chart(document.getElementById('freshairChart'),cfgBin('FreshAir','#00BCD4'));heaterChart=new Chart(document.getElementById('heaterChart'),cfgBin('Heater','#FF5722'));console.log('Charts initialized');setInterval(u,3000);u();}catch(e){console.error('Chart init error:',e);}}")); 
-  client.print(F("window.onload=initCharts;"));
-  client.print(F("function u(){fetch('/api/last200').then(r=>r.json()).then(d=>{console.log('Data received:',d);"));
-  // Update setpoints
-  client.print(F("document.getElementById('sp-co2').innerHTML=d.setpoints.co2;"));
-  client.print(F("document.getElementById('sp-rh').innerHTML=d.setpoints.rh.toFixed(1);"));
-  client.print(F("document.getElementById('sp-temp').innerHTML=d.setpoints.temp.toFixed(1);"));
-  // Update current values (latest from arrays)
-  client.print(F("let latestCO2=Math.round(d.co2[d.co2.length-1]/50)*50;"));
-  client.print(F("let latestRH=(Math.round(d.rh[d.rh.length-1]*10)/10).toFixed(1);"));
-  client.print(F("let latestTemp=(Math.round(d.temp[d.temp.length-1]*10)/10).toFixed(1);"));
-  client.print(F("document.getElementById('curr-co2').innerHTML='Current: '+latestCO2+' ppm';"));
-  client.print(F("document.getElementById('curr-rh').innerHTML='Current: '+latestRH+'%';"));
-  client.print(F("document.getElementById('curr-temp').innerHTML='Current: '+latestTemp+'\\u00b0C';"));
-  // Update time
-  client.print(F("let hrs=Math.floor(d.time/3600);let min=Math.floor((d.time%3600)/60);"));
-  client.print(F("document.getElementById('time').innerHTML='Uptime: '+(hrs<10?'0':'')+hrs+':'+(min<10?'0':'')+min+' | Last update: '+new Date().toLocaleTimeString('de-DE',{hour:'2-digit',minute:'2-digit',hour12:false});"));
-  // Generate timestamps and round values
-  client.print(F("let now=new Date();timestamps=d.co2.map((_,i)=>{let t=new Date(now.getTime()-(d.co2.length-1-i)*3000);return t.getHours().toString().padStart(2,'0')+':'+t.getMinutes().toString().padStart(2,'0')+':'+t.getSeconds().toString().padStart(2,'0');});"));
-  client.print(F("let co2Rounded=d.co2.map(v=>Math.round(v/50)*50);"));
-  client.print(F("let co2_2Rounded=d.co2_2.map(v=>Math.round(v/50)*50);"));
-  client.print(F("let rhRounded=d.rh.map(v=>Math.round(v*10)/10);"));
-  client.print(F("let rh_2Rounded=d.rh_2.map(v=>Math.round(v*10)/10);"));
-  client.print(F("let tempRounded=d.temp.map(v=>Math.round(v*10)/10);"));
-  client.print(F("let temp_2Rounded=d.temp_2.map(v=>Math.round(v*10)/10);"));
-  client.print(F("let tempOuterRounded=d.temp_outer.map(v=>Math.round(v*10)/10);"));
-  // Update charts
-  client.print(F("if(co2Chart){console.log('Updating CO2 chart');co2Chart.data.labels=timestamps;co2Chart.data.datasets[0].data=co2Rounded;co2Chart.data.datasets[1].data=co2_2Rounded;co2Chart.update('none');}"));
-  client.print(F("if(rhChart){console.log('Updating RH chart');rhChart.data.labels=timestamps;rhChart.data.datasets[0].data=rhRounded;rhChart.data.datasets[1].data=rh_2Rounded;rhChart.update('none');}"));
-  client.print(F("if(tempChart){console.log('Updating Temp chart');tempChart.data.labels=timestamps;tempChart.data.datasets[0].data=tempRounded;tempChart.data.datasets[1].data=temp_2Rounded;tempChart.data.datasets[2].data=tempOuterRounded;tempChart.update('none');}"));
-  client.print(F("if(foggerChart){foggerChart.data.labels=timestamps;foggerChart.data.datasets[0].data=d.fogger;foggerChart.update('none');}"));
-  client.print(F("if(swirlerChart){swirlerChart.data.labels=timestamps;swirlerChart.data.datasets[0].data=d.swirler;swirlerChart.update('none');}"));
-  client.print(F("if(freshairChart){freshairChart.data.labels=timestamps;freshairChart.data.datasets[0].data=d.freshair;freshairChart.update('none');}"));
-  client.print(F("if(heaterChart){heaterChart.data.labels=timestamps;heaterChart.data.datasets[0].data=d.heater;heaterChart.update('none');}"));
-  client.print(F("}).catch(e=>{console.error('Fetch error:',e);});}"));
-  
-  client.print(F("function adj(type,delta){"));
-  client.print(F("let sp,ep;"));
-  client.print(F("if(type=='co2'){sp=parseInt(document.getElementById('sp-co2').innerText);sp+=delta;if(sp<400)sp=400;if(sp>10000)sp=10000;ep='/api/setpoint?value='+sp;}"));
-  client.print(F("else if(type=='rh'){sp=parseFloat(document.getElementById('sp-rh').innerText);sp+=delta;if(sp<82)sp=82;if(sp>96)sp=96;ep='/api/setpoint_rh?value='+sp.toFixed(1);}"));
-  client.print(F("else if(type=='temp'){sp=parseFloat(document.getElementById('sp-temp').innerText);sp+=delta;if(sp<18)sp=18;if(sp>32)sp=32;ep='/api/setpoint_temp?value='+sp.toFixed(1);}"));
-  client.print(F("fetch(ep).then(r=>r.json()).then(d=>{u();}).catch(e=>alert('Error: '+e));}"));
-  
-  client.print(F("</script></body></html>"));
-  
-  client.flush();
-}
-
-// API endpoint: /api/last200 (cached, 5 values + all setpoints + timestamp)
-static void handleLast200(WiFiClient &client) {
-  unsigned long now = millis();
-  Serial.println("API: /api/last200 requested");
-  
-  // Rebuild cache if expired or empty
-  if (cachedJsonResponse.length() == 0 || (now - lastCacheUpdate) > CACHE_VALID_MS) {
-    Serial.println("API: Rebuilding cache...");
-    static float rhData[200];
-    static float rh_2Data[200];
-    static float tempData[200];
-    static float temp_2Data[200];
-    static float tempOuterData[200];
-    static int co2Data[200];
-    static int co2_2Data[200];
-    static int foggerData[200];
-    static int swirlerData[200];
-    static int freshairData[200];
-    static int heaterData[200];
-    
-    controller_get_last200(rhData, tempData, co2Data);
-    controller_get_additional_sensors(co2_2Data, rh_2Data, temp_2Data, tempOuterData);
-    controller_get_outputs(foggerData, swirlerData, freshairData);
-    controller_get_heater(heaterData);
-    uint16_t co2_sp = controller_get_co2_setpoint();
-    float rh_sp = controller_get_rh_setpoint();
-    float temp_sp = controller_get_temp_setpoint();
-    
-    Serial.print("API: First 5 CO2 values: ");
-    for (int i = 0; i < 5; i++) {
-      Serial.print(co2Data[i]);
-      Serial.print(" ");
-    }
-    Serial.println();
-    
-    // Build JSON once and cache it (200 values)
-    cachedJsonResponse = "{\"co2\":[";
-    for (int i = 0; i < 200; i++) {
-      if (i > 0) cachedJsonResponse += ",";
-      cachedJsonResponse += String(co2Data[i]);
-    }
-    cachedJsonResponse += "],\"co2_2\":[";
-    for (int i = 0; i < 200; i++) {
-      if (i > 0) cachedJsonResponse += ",";
-      cachedJsonResponse += String(co2_2Data[i]);
-    }
-    cachedJsonResponse += "],\"rh\":[";
-    for (int i = 0; i < 200; i++) {
-      if (i > 0) cachedJsonResponse += ",";
-      cachedJsonResponse += String(rhData[i], 1);
-    }
-    cachedJsonResponse += "],\"rh_2\":[";
-    for (int i = 0; i < 200; i++) {
-      if (i > 0) cachedJsonResponse += ",";
-      cachedJsonResponse += String(rh_2Data[i], 1);
-    }
-    cachedJsonResponse += "],\"temp\":[";
-    for (int i = 0; i < 200; i++) {
-      if (i > 0) cachedJsonResponse += ",";
-      cachedJsonResponse += String(tempData[i], 1);
-    }
-    cachedJsonResponse += "],\"temp_2\":[";
-    for (int i = 0; i < 200; i++) {
-      if (i > 0) cachedJsonResponse += ",";
-      cachedJsonResponse += String(temp_2Data[i], 1);
-    }
-    cachedJsonResponse += "],\"temp_outer\":[";
-    for (int i = 0; i < 200; i++) {
-      if (i > 0) cachedJsonResponse += ",";
-      cachedJsonResponse += String(tempOuterData[i], 1);
-    }
-    cachedJsonResponse += "],\"fogger\":[";
-    for (int i = 0; i < 200; i++) {
-      if (i > 0) cachedJsonResponse += ",";
-      cachedJsonResponse += String(foggerData[i]);
-    }
-    cachedJsonResponse += "],\"swirler\":[";
-    for (int i = 0; i < 200; i++) {
-      if (i > 0) cachedJsonResponse += ",";
-      cachedJsonResponse += String(swirlerData[i]);
-    }
-    cachedJsonResponse += "],\"freshair\":[";
-    for (int i = 0; i < 200; i++) {
-      if (i > 0) cachedJsonResponse += ",";
-      cachedJsonResponse += String(freshairData[i]);
-    }
-    cachedJsonResponse += "],\"heater\":[";
-    for (int i = 0; i < 200; i++) {
-      if (i > 0) cachedJsonResponse += ",";
-      cachedJsonResponse += String(heaterData[i]);
-    }
-    cachedJsonResponse += "],\"setpoints\":{\"co2\":";
-    cachedJsonResponse += String(co2_sp);
-    cachedJsonResponse += ",\"rh\":";
-    cachedJsonResponse += String(rh_sp, 1);
-    cachedJsonResponse += ",\"temp\":";
-    cachedJsonResponse += String(temp_sp, 1);
-    cachedJsonResponse += "},\"time\":";
-    cachedJsonResponse += String(millis() / 1000); // seconds since boot
-    cachedJsonResponse += "}";
-    
-    lastCacheUpdate = now;
-    Serial.print("API: Cache rebuilt, CO2=");
-    Serial.print(co2Data[99]);
-    Serial.print(", RH=");
-    Serial.print(rhData[99], 1);
-    Serial.print(", Temp=");
-    Serial.print(tempData[99], 1);
-    Serial.print(", JSON size: ");
-    Serial.print(cachedJsonResponse.length());
-    Serial.println(" bytes");
+  int len = snprintf(conn.scratch, sizeof(conn.scratch), "{\"count\":%u}\r\n", (unsigned)count);
+  beginScratchResponse(conn, "200 OK", "application/json", len);
+}
+
+// Precompressed asset from flash (web_assets.h). The browser revalidates on
+// every load (no-cache) and gets a bodiless 304 while the ETag matches.
+static void serveAsset(HttpConnection &conn, const WebAsset &asset) {
+  bool notModified = conn.ifNoneMatch[0] != '\0' &&
+                     (strstr(conn.ifNoneMatch, asset.etag) != nullptr || strcmp(conn.ifNoneMatch, "*") == 0);
+  int n;
+  if (notModified) {
+    n = snprintf(conn.head, sizeof(conn.head),
+                 "HTTP/1.1 304 Not Modified\r\n"
+                 "ETag: %s\r\n"
+                 "Cache-Control: no-cache\r\n"
+                 "Connection: %s\r\n"
+                 "\r\n",
+                 asset.etag, connectionHeader(conn));
   } else {
-    Serial.println("API: Using cached response");
+    n = snprintf(conn.head, sizeof(conn.head),
+                 "HTTP/1.1 200 OK\r\n"
+                 "Content-Type: %s\r\n"
+                 "Content-Encoding: gzip\r\n"
+                 "Content-Length: %u\r\n"
+                 "ETag: %s\r\n"
+                 "Cache-Control: no-cache\r\n"
+                 "Connection: %s\r\n"
+                 "\r\n",
+                 asset.contentType, (unsigned)asset.length, asset.etag, connectionHeader(conn));
   }
-  
-  // Send cached response
-  client.println("HTTP/1.1 200 OK");
-  client.println("Content-Type: application/json");
-  client.println("Connection: close");
-  client.println();
-  client.print(cachedJsonResponse);
-  Serial.println("API: Response sent");
-  client.flush();
+  conn.headLen = (n > 0 && (size_t)n < sizeof(conn.head)) ? n : 0;
+  conn.headSent = 0;
+  conn.body = (const char *)asset.data;
+  conn.bodyLen = notModified ? 0 : asset.length;
+  conn.bodySent = 0;
+  conn.writeBudget = ASSET_WRITE_BUDGET_BYTES;
+  conn.generator = nullptr;
+  conn.state = CONN_RESPONSE;
 }
 
-// API endpoint: /api/setpoint?value=XXX (set CO2 setpoint)
-static void handleSetpoint(WiFiClient &client, const String &query) {
-  // Parse value from query string: value=XXX
-  int valueIndex = query.indexOf("value=");
-  uint16_t newSetpoint = 800; // default
-  
-  if (valueIndex >= 0) {
-    String valueStr = query.substring(valueIndex + 6); // skip "value="
-    // Remove anything after & or whitespace
-    int endIndex = valueStr.indexOf('&');
-    if (endIndex > 0) valueStr = valueStr.substring(0, endIndex);
-    valueStr.trim();
-    newSetpoint = valueStr.toInt();
-  }
-  
-  // Set the new setpoint (will be clamped to 600-10000)
-  controller_set_co2_setpoint(newSetpoint);
-  uint16_t actualSetpoint = controller_get_co2_setpoint();
-  
-  // Invalidate cache so next request gets fresh data
-  cachedJsonResponse = "";
-  
-  // Send response
-  client.println("HTTP/1.1 200 OK");
-  client.println("Content-Type: application/json");
-  client.println("Connection: close");
-  client.println();
-  client.print("{\"setpoint\":");
-  client.print(actualSetpoint);
-  client.println("}");
-  client.flush();
-  
-  Serial.print("API: Setpoint set to ");
-  Serial.println(actualSetpoint);
+static void serveClimateUI(HttpConnection &conn) {
+  serveAsset(conn, WEB_ASSETS[0]);
 }
 
-// API endpoint: /api/setpoint_rh?value=XX.X (set RH setpoint)
-static void handleSetpointRH(WiFiClient &client, const String &query) {
-  int valueIndex = query.indexOf("value=");
-  float newSetpoint = 95.0f; // default
-  
-  if (valueIndex >= 0) {
-    String valueStr = query.substring(valueIndex + 6);
-    int endIndex = valueStr.indexOf('&');
-    if (endIndex > 0) valueStr = valueStr.substring(0, endIndex);
-    valueStr.trim();
-    newSetpoint = valueStr.toFloat();
-  }
-  
-  controller_set_rh_setpoint(newSetpoint);
-  float actualSetpoint = controller_get_rh_setpoint();
-  
-  cachedJsonResponse = ""; // Invalidate cache
-  
-  client.println("HTTP/1.1 200 OK");
-  client.println("Content-Type: application/json");
-  client.println("Connection: close");
-  client.println();
-  client.print("{\"setpoint\":");
-  client.print(actualSetpoint, 1);
-  client.println("}");
-  client.flush();
-  
-  Serial.print("API: RH setpoint set to ");
-  Serial.println(actualSetpoint);
+// --- Assets stored in the QSPI asset region (asset_store.h) ---
+
+static constexpr char CHART_JS_CDN_URL[] = "https://cdn.jsdelivr.net/npm/chart.js@4.4.0/dist/chart.umd.min.js";
+static const uint8_t GZIP_MAGIC[2] = {0x1f, 0x8b};
+
+// Copy the next block of the asset (genSeries) straight from flash
+static size_t storedAssetGenerator(HttpConnection &conn, char *out, size_t cap) {
+  AssetInfo info;
+  if (!asset_store_info((AssetId)conn.genSeries, &info) || conn.genBytes >= info.length) return 0;
+  size_t n = info.length - conn.genBytes;
+  if (n > cap) n = cap;
+  return asset_store_read((AssetId)conn.genSeries, conn.genBytes, out, n) ? n : 0;
 }
 
-// API endpoint: /api/setpoint_temp?value=XX.X (set Temp setpoint)
-static void handleSetpointTemp(WiFiClient &client, const String &query) {
-  int valueIndex = query.indexOf("value=");
-  float newSetpoint = 25.0f; // default
-  
-  if (valueIndex >= 0) {
-    String valueStr = query.substring(valueIndex + 6);
-    int endIndex = valueStr.indexOf('&');
-    if (endIndex > 0) valueStr = valueStr.substring(0, endIndex);
-    valueStr.trim();
-    newSetpoint = valueStr.toFloat();
-  }
-  
-  controller_set_temp_setpoint(newSetpoint);
-  float actualSetpoint = controller_get_temp_setpoint();
-  
-  cachedJsonResponse = ""; // Invalidate cache
-  
-  client.println("HTTP/1.1 200 OK");
-  client.println("Content-Type: application/json");
-  client.println("Connection: close");
-  client.println();
-  client.print("{\"setpoint\":");
-  client.print(actualSetpoint, 1);
-  client.println("}");
-  client.flush();
-  
-  Serial.print("API: Temp setpoint set to ");
-  Serial.println(actualSetpoint);
+// Versioned URL (?v=...), so the copy is cached for good; without an
+// uploaded copy the browser is sent to the CDN instead
+static void serveStoredAsset(HttpConnection &conn, AssetId id, const char *fallbackUrl) {
+  AssetInfo info;
+  int n;
+  if (!asset_store_info(id, &info)) {
+    n = snprintf(conn.head, sizeof(conn.head),
+                 "HTTP/1.1 302 Found\r\n"
+                 "Location: %s\r\n"
+                 "Cache-Control: no-store\r\n"
+                 "Content-Length: 0\r\n"
+                 "Connection: %s\r\n"
+                 "\r\n",
+                 fallbackUrl, connectionHeader(conn));
+    conn.headLen = (n > 0 && (size_t)n < sizeof(conn.head)) ? n : 0;
+    conn.headSent = 0;
+    conn.body = nullptr;
+    conn.bodyLen = 0;
+    conn.bodySent = 0;
+    conn.writeBudget = WRITE_BUDGET_BYTES;
+    conn.generator = nullptr;
+    conn.state = CONN_RESPONSE;
+    return;
+  }
+
+  char etag[12];
+  snprintf(etag, sizeof(etag), "\"%08lx\"", (unsigned long)info.crc32);
+  bool notModified = conn.ifNoneMatch[0] != '\0' &&
+                     (strstr(conn.ifNoneMatch, etag) != nullptr || strcmp(conn.ifNoneMatch, "*") == 0);
+  if (notModified) {
+    n = snprintf(conn.head, sizeof(conn.head),
+                 "HTTP/1.1 304 Not Modified\r\n"
+                 "ETag: %s\r\n"
+                 "Cache-Control: public, max-age=31536000, immutable\r\n"
+                 "Connection: %s\r\n"
+                 "\r\n",
+                 etag, connectionHeader(conn));
+  } else {
+    n = snprintf(conn.head, sizeof(conn.head),
+                 "HTTP/1.1 200 OK\r\n"
+                 "Content-Type: %s\r\n"
+                 "Content-Encoding: gzip\r\n"
+                 "Content-Length: %lu\r\n"
+                 "ETag: %s\r\n"
+                 "Cache-Control: public, max-age=31536000, immutable\r\n"
+                 "Connection: %s\r\n"
+                 "\r\n",
+                 asset_store_content_type(id), (unsigned long)info.length, etag, connectionHeader(conn));
+  }
+  conn.headLen = (n > 0 && (size_t)n < sizeof(conn.head)) ? n : 0;
+  conn.headSent = 0;
+  conn.body = nullptr;
+  conn.bodyLen = 0;
+  conn.bodySent = 0;
+  conn.writeBudget = ASSET_WRITE_BUDGET_BYTES;
+  conn.generator = notModified ? nullptr : storedAssetGenerator;
+  conn.genRaw = true;
+  conn.genSeries = id;
+  conn.genBytes = 0;
+  conn.genMicros = 0;
+  conn.state = CONN_RESPONSE;
 }
 
-void web_server_handle(const WebServerConfig *config) {
-  if (config == nullptr || config->server == nullptr) {
+// {"error":"<message>"} with the given status
+static void beginErrorResponse(HttpConnection &conn, const char *status, const char *message) {
+  int len = snprintf(conn.scratch, sizeof(conn.scratch), "{\"error\":\"%s\"}\r\n", message);
+  beginScratchResponse(conn, status, "application/json", len);
+}
+
+// Body of PUT /api/assets/<name>: gzip data straight into the asset region
+static void assetUploadSink(HttpConnection &conn, const uint8_t *data, size_t len) {
+  AssetId id = (AssetId)conn.genSeries;
+  if (len == 0) {
+    AssetInfo info;
+    if (!asset_store_finish() || !asset_store_info(id, &info)) {
+      beginErrorResponse(conn, "500 Internal Server Error", "verify failed");
+      return;
+    }
+    event_log(EVT_API_ASSET_STORED, (int32_t)info.length, (int32_t)info.crc32);
+    int n = snprintf(conn.scratch, sizeof(conn.scratch),
+                     "{\"asset\":\"%s\",\"bytes\":%lu,\"crc32\":\"%08lx\"}\r\n",
+                     asset_store_name(id), (unsigned long)info.length, (unsigned long)info.crc32);
+    beginScratchResponse(conn, "201 Created", "application/json", n);
+    return;
+  }
+
+  for (size_t i = 0; i < len && conn.genBytes + i < sizeof(GZIP_MAGIC); i++) {
+    if (data[i] != GZIP_MAGIC[conn.genBytes + i]) {
+      if (conn.genBytes > 0) asset_store_abort();
+      beginErrorResponse(conn, "415 Unsupported Media Type", "gzip data expected");
+      return;
+    }
+  }
+  // The old copy stays until the first block of the new one arrives
+  if (conn.genBytes == 0 && !asset_store_begin(id, (uint32_t)conn.contentLength)) {
+    beginErrorResponse(conn, "503 Service Unavailable", "asset store busy or unavailable");
+    return;
+  }
+  if (!asset_store_write(data, len)) {
+    beginErrorResponse(conn, "500 Internal Server Error", "flash write failed");
     return;
   }
+  conn.genBytes += len;
+}
 
-  WiFiClient client = config->server->accept();
-  if (!client) {
+static void handleAssetUpload(HttpConnection &conn, HttpSlice name) {
+  AssetId id = ASSET_COUNT;
+  for (uint8_t i = 0; i < ASSET_COUNT; i++) {
+    if (sliceIs(name, asset_store_name((AssetId)i))) id = (AssetId)i;
+  }
+  if (id == ASSET_COUNT) {
+    beginErrorResponse(conn, "404 Not Found", "unknown asset");
+    return;
+  }
+  if (conn.contentLength < 0) {
+    beginErrorResponse(conn, "411 Length Required", "Content-Length required");
     return;
   }
+  if (conn.contentLength < (int32_t)sizeof(GZIP_MAGIC) || (uint32_t)conn.contentLength > asset_store_capacity(id)) {
+    beginErrorResponse(conn, "413 Payload Too Large", "size out of range");
+    return;
+  }
+  conn.sink = assetUploadSink;
+  conn.bodyRemaining = (uint32_t)conn.contentLength;
+  conn.genSeries = id;
+  conn.genBytes = 0;
+  conn.state = CONN_BODY;
+}
+
+// --- Streaming JSON serializer ---
+
+// Append a NUL-free string, returns bytes written
+static size_t appendText(char *out, const char *text) {
+  size_t n = 0;
+  while (text[n] != '\0') {
+    out[n] = text[n];
+    n++;
+  }
+  return n;
+}
+
+// Format a fixed-point integer: (925, 1) -> "92.5", (-5, 1) -> "-0.5"
+static size_t formatFixed(char *out, int32_t scaledValue, uint8_t decimals) {
+  return fixed_format(out, scaledValue, decimals);
+}
+
+// Format a value rounded to `decimals` places (matches String(value, decimals))
+static size_t formatNumber(char *out, float value, uint8_t decimals) {
+  float scale = 1.0f;
+  for (uint8_t i = 0; i < decimals; i++) scale *= 10.0f;
+  return formatFixed(out, lroundf(value * scale), decimals);
+}
+
+// Field order of the /api/last200 and /api/since documents: CHANNELS (channels.h)
+static constexpr size_t JSON_TOKEN_MAX = 112; // Largest single token (the trailer)
+
+// Bounds of the staged generators, checked against the chunk payload
+static constexpr size_t CHUNK_PAYLOAD_MAX = SCRATCH_BUFFER_SIZE - CHUNK_HEADER_SIZE - CHUNK_TRAILER_SIZE;
+static constexpr size_t JSON_NUMBER_MAX = 12; // formatFixed() of an int32 with sign and decimal point
+
+static constexpr size_t nameLength(const char *name) {
+  return (*name == '\0') ? 0 : 1 + nameLength(name + 1);
+}
+
+// Longest of `count` names
+static constexpr size_t longestName(const char *const *names, uint8_t count, uint8_t i = 0) {
+  return (i >= count) ? 0
+         : (nameLength(names[i]) > longestName(names, count, i + 1)) ? nameLength(names[i])
+                                                                     : longestName(names, count, i + 1);
+}
+
+// Longest actuator key in CHANNELS
+static constexpr size_t actuatorKeyMax(uint8_t a = 0) {
+  return (a >= ACTUATOR_COUNT) ? 0
+         : (nameLength(CHANNELS[SENSOR_SERIES_COUNT + a].key) > actuatorKeyMax(a + 1))
+             ? nameLength(CHANNELS[SENSOR_SERIES_COUNT + a].key)
+             : actuatorKeyMax(a + 1);
+}
+
+// Setpoints of a chamber, uptime and wall time, closing the document
+static size_t appendTrailer(char *out, uint8_t chamber) {
+  ControllerSnapshot state;
+  controller_snapshot(chamber, &state);
+  size_t len = appendText(out, "],\"setpoints\":{\"co2\":");
+  len += formatFixed(out + len, state.co2_setpoint, 0);
+  len += appendText(out + len, ",\"rh\":");
+  len += formatFixed(out + len, state.rh_setpoint_x10, 1);
+  len += appendText(out + len, ",\"temp\":");
+  len += formatFixed(out + len, state.temp_setpoint_x10, 1);
+  len += appendText(out + len, "},\"time\":");
+  len += formatFixed(out + len, millis() / 1000, 0); // seconds since boot
+  len += appendText(out + len, ",\"epoch\":");
+  len += formatFixed(out + len, wall_clock_now(), 0); // UTC seconds, 0 = clock unknown
+  out[len++] = '}';
+  return len;
+}
+
+// --- Sample cache (shared by /api/last200, /api/since, /api/stream, JSON and binary) ---
+//
+// Every history sample is encoded once, when web_server_handle() first sees
+// it: the history's fixed-point values (one decimal for RH/temperature, as
+// in the binary telemetry) and their JSON text. The ring is indexed by sequence number and
+// moves with the controller history, one row per new sample; only a jump
+// past the whole window re-encodes all rows. Setpoints and uptime are read
+// per response (trailer/header), so the rows do not depend on them.
+// Only chamber 0 is cached; other chambers are formatted per response.
+
+static constexpr uint16_t SAMPLE_CACHE_SIZE = Config::SENSOR_RING_BUFFER_SIZE;
+static constexpr size_t SAMPLE_TEXT_MAX = 8; // Longer values are formatted per response
+
+static_assert(Config::WebUI::RH_TEMP_DECIMAL_PLACES == 1 && series_decimals(SERIES_RH) == 1,
+              "History fixed-point values serve the JSON and the binary deci channels as they are");
+
+struct CachedSample {
+  uint32_t seq;                                 // 0 = empty row
+  int16_t fixed[SENSOR_SERIES_COUNT];           // History value, series_decimals() places
+  uint8_t actuators;                            // ACTUATOR_BIT_* mask
+  uint8_t textLen[SENSOR_SERIES_COUNT];         // 0 = did not fit
+  char text[SENSOR_SERIES_COUNT][SAMPLE_TEXT_MAX];
+};
+
+EXT_DATA static CachedSample g_sampleCache[SAMPLE_CACHE_SIZE]; // Zeroed by memory_regions_init()
+static uint32_t g_sampleCacheSeq = 0; // Newest encoded sample
+
+static void encodeSample(uint32_t seq) {
+  int16_t frame[SERIES_COUNT];
+  controller_history_frame(0, seq, frame);
+  CachedSample &row = g_sampleCache[seq % SAMPLE_CACHE_SIZE];
+  row.actuators = controller_history_actuators(0, seq);
+  for (uint8_t i = 0; i < SENSOR_SERIES_COUNT; i++) {
+    char text[16];
+    size_t len = formatFixed(text, frame[i], series_decimals(i));
+    row.fixed[i] = frame[i];
+    row.textLen[i] = (len <= SAMPLE_TEXT_MAX) ? (uint8_t)len : 0;
+    if (row.textLen[i] > 0) memcpy(row.text[i], text, len);
+  }
+  row.seq = seq;
+}
+
+// Encode the samples pushed since the last call (usually one, or none)
+static void syncSampleCache() {
+  uint32_t newest = controller_get_sample_seq(0);
+  if (newest == g_sampleCacheSeq) return;
+  uint32_t from = g_sampleCacheSeq + 1;
+  if (newest < g_sampleCacheSeq || newest - g_sampleCacheSeq > SAMPLE_CACHE_SIZE) {
+    from = (newest > SAMPLE_CACHE_SIZE) ? newest - SAMPLE_CACHE_SIZE + 1 : 1;
+  }
+  for (uint32_t seq = from; seq <= newest; seq++) encodeSample(seq);
+  g_sampleCacheSeq = newest;
+}
+
+// Row of `seq`, nullptr if it is not (or no longer) cached
+static const CachedSample *cachedSample(uint8_t chamber, uint32_t seq) {
+  if (chamber != 0) return nullptr;
+  const CachedSample &row = g_sampleCache[seq % SAMPLE_CACHE_SIZE];
+  return (seq != 0 && row.seq == seq) ? &row : nullptr;
+}
+
+// JSON text of one value; seq 0 is the zero padding of a filling ring
+static size_t appendSampleValue(char *out, uint8_t chamber, const ChannelDef &series, uint32_t seq) {
+  const CachedSample *row = cachedSample(chamber, seq);
+  if (row == nullptr) {
+    int16_t value = (seq == 0) ? 0 : controller_history_value(chamber, series.series, seq);
+    return formatFixed(out, value, series.decimals);
+  }
+  if (series.series >= SENSOR_SERIES_COUNT) {
+    out[0] = (row->actuators & (1u << (series.series - SENSOR_SERIES_COUNT))) ? '1' : '0';
+    return 1;
+  }
+  uint8_t len = row->textLen[series.series];
+  if (len == 0) return formatFixed(out, row->fixed[series.series], series.decimals);
+  memcpy(out, row->text[series.series], len);
+  return len;
+}
+
+// Stream genCount samples per series ending at genSeq straight from the
+// sample cache, one chunk per call
+static size_t historyJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  while (conn.genSeries < SERIES_COUNT && cap - len >= JSON_TOKEN_MAX) {
+    const ChannelDef &series = CHANNELS[conn.genSeries];
+
+    if (!conn.genStarted) {
+      out[len++] = '{';
+      if (conn.genDelta) {
+        len += appendText(out + len, "\"seq\":");
+        len += formatFixed(out + len, conn.genSeq, 0);
+        len += appendText(out + len, ",\"len\":");
+        len += formatFixed(out + len, controller_history_length(), 0);
+        len += appendText(out + len, conn.genReset ? ",\"reset\":true," : ",\"reset\":false,");
+      }
+      len += appendText(out + len, "\"");
+      len += appendText(out + len, series.key);
+      len += appendText(out + len, "\":[");
+      conn.genStarted = true;
+      continue;
+    }
+
+    if (conn.genIndex < conn.genCount) {
+      if (conn.genIndex > 0) out[len++] = ',';
+      // Oldest -> newest, zero-padded in front while the ring is filling up
+      uint32_t back = conn.genCount - 1 - conn.genIndex;
+      len += appendSampleValue(out + len, conn.chamber, series, (back >= conn.genSeq) ? 0 : conn.genSeq - back);
+      conn.genIndex++;
+      continue;
+    }
+
+    // Series complete: open the next one or close the document
+    conn.genIndex = 0;
+    conn.genSeries++;
+    if (conn.genSeries < SERIES_COUNT) {
+      len += appendText(out + len, "],\"");
+      len += appendText(out + len, CHANNELS[conn.genSeries].key);
+      len += appendText(out + len, "\":[");
+    } else {
+      len += appendTrailer(out + len, conn.chamber);
+    }
+  }
+  return len;
+}
+
+// --- Downsampled tiers (/api/history) ---
+
+// Each sensor series is emitted as mean ("co2"), "co2_min" and "co2_max";
+// each actuator series as its on-duty 0..1 (the tier's percent, two places)
+static constexpr uint8_t TIER_STATS_PER_SENSOR = 3;
+static constexpr uint8_t TIER_FIELD_COUNT = SENSOR_SERIES_COUNT * TIER_STATS_PER_SENSOR + ACTUATOR_COUNT;
+static const TierStat TIER_FIELD_STATS[TIER_STATS_PER_SENSOR] = {STAT_MEAN, STAT_MIN, STAT_MAX};
+static const char *const TIER_FIELD_SUFFIX[TIER_STATS_PER_SENSOR] = {"", "_min", "_max"};
+static constexpr uint8_t TIER_DUTY_DECIMALS = 2;
+
+static const char *resolutionName(HistoryResolution res) {
+  switch (res) {
+    case RES_1M:  return "1m";
+    case RES_15M: return "15m";
+    default:      return "raw";
+  }
+}
+
+struct TierField {
+  const ChannelDef *series;
+  TierStat stat;
+  uint8_t statIndex;  // Index into TIER_FIELD_SUFFIX, actuators use 0
+  uint8_t decimals;
+};
+
+// Field order: co2, co2_min, co2_max, ..., temp_outer_max, fogger, ..., heater
+static TierField tierField(uint8_t field) {
+  constexpr uint8_t SENSOR_FIELDS = SENSOR_SERIES_COUNT * TIER_STATS_PER_SENSOR;
+  if (field < SENSOR_FIELDS) {
+    const ChannelDef *series = &CHANNELS[field / TIER_STATS_PER_SENSOR];
+    uint8_t statIndex = field % TIER_STATS_PER_SENSOR;
+    return {series, TIER_FIELD_STATS[statIndex], statIndex, series->decimals};
+  }
+  return {&CHANNELS[SENSOR_SERIES_COUNT + field - SENSOR_FIELDS], STAT_MEAN, 0, TIER_DUTY_DECIMALS};
+}
+
+// Quoted key of a field followed by ":["
+static size_t appendTierKey(char *out, const TierField &field) {
+  size_t len = appendText(out, "\"");
+  len += appendText(out + len, field.series->key);
+  len += appendText(out + len, TIER_FIELD_SUFFIX[field.statIndex]);
+  len += appendText(out + len, "\":[");
+  return len;
+}
 
-  Serial.println("Web: Client connected");
+// Stream genCount buckets per field ending at genSeq of tier genRes
+static size_t tierJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
 
-  // Read request line and headers until blank line
-  String line = "";
-  bool firstLine = true;
-  String path;
+  while (conn.genSeries < TIER_FIELD_COUNT && cap - len >= JSON_TOKEN_MAX) {
+    if (!conn.genStarted) {
+      len += appendText(out + len, "{\"res\":\"");
+      len += appendText(out + len, resolutionName(conn.genRes));
+      len += appendText(out + len, "\",\"interval_ms\":");
+      len += formatFixed(out + len, controller_tier_interval_ms(conn.genRes), 0);
+      len += appendText(out + len, ",\"seq\":");
+      len += formatFixed(out + len, conn.genSeq, 0);
+      len += appendText(out + len, ",\"len\":");
+      len += formatFixed(out + len, conn.genCount, 0);
+      out[len++] = ',';
+      len += appendTierKey(out + len, tierField(0));
+      conn.genStarted = true;
+      continue;
+    }
 
-  while (client.connected()) {
-    if (!client.available()) {
+    if (conn.genIndex < conn.genCount) {
+      TierField field = tierField(conn.genSeries);
+      if (conn.genIndex > 0) out[len++] = ',';
+      uint32_t seq = conn.genSeq - (conn.genCount - 1 - conn.genIndex);
+      int16_t value = controller_tier_value(conn.chamber, conn.genRes, field.series->series, field.stat, seq);
+      len += formatFixed(out + len, value, field.decimals);
+      conn.genIndex++;
       continue;
     }
-    char c = client.read();
-    if (c == '\r') {
+
+    // Field complete: open the next one or close the document
+    conn.genIndex = 0;
+    conn.genSeries++;
+    if (conn.genSeries < TIER_FIELD_COUNT) {
+      len += appendText(out + len, "],");
+      len += appendTierKey(out + len, tierField(conn.genSeries));
+    } else {
+      len += appendTrailer(out + len, conn.chamber);
+    }
+  }
+  return len;
+}
+
+// --- Downsampled chart series (?points=N on /api/last200 and /api/history) ---
+
+// Fields: the CHANNELS keys for raw samples, the tier fields for 1m/15m.
+// "x" holds the window offset each point is drawn at (0 = oldest of "len").
+static constexpr uint16_t DOWNSAMPLE_MIN_POINTS = 3;
+
+static uint8_t downsampleFieldCount(HistoryResolution res) {
+  return (res == RES_RAW) ? SERIES_COUNT : TIER_FIELD_COUNT;
+}
+
+static TierField downsampleField(HistoryResolution res, uint8_t field) {
+  if (res != RES_RAW) return tierField(field);
+  const ChannelDef *series = &CHANNELS[field];
+  return {series, STAT_MEAN, 0, series->decimals};
+}
+
+// Samples and means keep their shape (LTTB), tier min/max stay extremes;
+// raw on/off states show any on-time, tier duty is averaged
+static DownsampleMode downsampleMode(HistoryResolution res, const TierField &field) {
+  bool actuator = field.series->kind == CHANNEL_ACTUATOR;
+  if (res == RES_RAW) return actuator ? DOWNSAMPLE_MAX : DOWNSAMPLE_LTTB;
+  if (actuator) return DOWNSAMPLE_MEAN;
+  if (field.stat == STAT_MIN) return DOWNSAMPLE_MIN;
+  if (field.stat == STAT_MAX) return DOWNSAMPLE_MAX;
+  return DOWNSAMPLE_LTTB;
+}
+
+// ?points=N for a window of `length` samples; 0 = serve the full window
+static uint16_t requestedPoints(HttpSlice query, uint16_t length) {
+  long points = sliceToLong(queryParam(query, "points"));
+  if (points <= 0 || points >= length) return 0;
+  return (points < DOWNSAMPLE_MIN_POINTS) ? DOWNSAMPLE_MIN_POINTS : (uint16_t)points;
+}
+
+// Stream genPoints points per field for the genCount samples ending at
+// genSeq, read in place from the history/tier; genSeries 0 is "x"
+static size_t downsampleJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+  const DownsampleBuckets buckets = {conn.genCount, conn.genPoints};
+  const uint8_t fields = downsampleFieldCount(conn.genRes);
+  const uint32_t oldest = conn.genSeq - conn.genCount + 1;
+
+  while (conn.genSeries <= fields && cap - len >= JSON_TOKEN_MAX) {
+    if (!conn.genStarted) {
+      len += appendText(out + len, "{\"res\":\"");
+      len += appendText(out + len, resolutionName(conn.genRes));
+      len += appendText(out + len, "\",\"interval_ms\":");
+      len += formatFixed(out + len, controller_tier_interval_ms(conn.genRes), 0);
+      len += appendText(out + len, ",\"seq\":");
+      len += formatFixed(out + len, conn.genSeq, 0);
+      len += appendText(out + len, ",\"len\":");
+      len += formatFixed(out + len, conn.genCount, 0);
+      len += appendText(out + len, ",\"points\":");
+      len += formatFixed(out + len, conn.genPoints, 0);
+      len += appendText(out + len, ",\"x\":[");
+      conn.genStarted = true;
       continue;
     }
-    if (c == '\n') {
-      if (firstLine) {
-        firstLine = false;
-        int sp1 = line.indexOf(' ');
-        int sp2 = line.indexOf(' ', sp1 + 1);
-        if (sp1 > 0 && sp2 > sp1) {
-          path = line.substring(sp1 + 1, sp2);
+
+    if (conn.genIndex < conn.genPoints) {
+      if (conn.genIndex > 0) out[len++] = ',';
+      if (conn.genSeries == 0) {
+        len += formatFixed(out + len, buckets.center(conn.genIndex), 0);
+      } else {
+        TierField field = downsampleField(conn.genRes, conn.genSeries - 1);
+        auto get = [&](uint16_t offset) {
+          return controller_tier_value(conn.chamber, conn.genRes, field.series->series, field.stat, oldest + offset);
+        };
+        DownsampleMode mode = downsampleMode(conn.genRes, field);
+        int16_t value;
+        if (mode == DOWNSAMPLE_LTTB) {
+          uint16_t pick = lttb_pick(buckets, conn.genIndex, conn.genPrevX, conn.genPrevY, get);
+          value = get(pick);
+          conn.genPrevX = pick;
+          conn.genPrevY = value;
+        } else {
+          value = downsample_reduce(buckets, conn.genIndex, mode, get);
         }
+        len += formatFixed(out + len, value, field.decimals);
       }
-      if (line.length() == 0) {
-        // end of headers
-        break;
+      conn.genIndex++;
+      continue;
+    }
+
+    // Field complete: open the next one or close the document
+    conn.genIndex = 0;
+    conn.genSeries++;
+    if (conn.genSeries <= fields) {
+      len += appendText(out + len, "],");
+      len += appendTierKey(out + len, downsampleField(conn.genRes, conn.genSeries - 1));
+    } else {
+      len += appendTrailer(out + len, conn.chamber);
+    }
+  }
+  return len;
+}
+
+// --- Persistent sample log (/api/log) ---
+
+static constexpr uint16_t LOG_MAX_SAMPLES = 2000; // Per request
+
+// Stream genCount persisted samples starting at genSeq as rows of
+// [co2,co2_2,rh,rh_2,temp,temp_2,temp_outer,actuators]; unreadable rows are null
+static size_t logJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  if (!conn.genStarted) {
+    len += appendText(out, "{\"oldest\":");
+    len += formatFixed(out + len, sample_log_oldest_seq(), 0);
+    len += appendText(out + len, ",\"newest\":");
+    len += formatFixed(out + len, sample_log_newest_seq(), 0);
+    len += appendText(out + len, ",\"first\":");
+    len += formatFixed(out + len, conn.genSeq, 0);
+    len += appendText(out + len, ",\"interval_ms\":");
+    len += formatFixed(out + len, Config::SAMPLE_INTERVAL_MS, 0);
+    len += appendText(out + len, ",\"samples\":[");
+    conn.genStarted = true;
+  }
+
+  while (conn.genSeries == 0 && cap - len >= JSON_TOKEN_MAX) {
+    if (conn.genIndex >= conn.genCount) {
+      len += appendText(out + len, "]}");
+      conn.genSeries = 1;
+      break;
+    }
+    if (conn.genIndex > 0) out[len++] = ',';
+    SampleRecord r;
+    if (!sample_log_read(conn.genSeq + conn.genIndex, &r)) {
+      len += appendText(out + len, "null");
+    } else {
+      const int32_t fields[] = {r.co2, r.co2_2, r.rh_x10, r.rh_2_x10, r.temp_x10,
+                                r.temp_2_x10, r.temp_outer_x10, r.actuators};
+      out[len++] = '[';
+      for (uint8_t i = 0; i < 8; i++) {
+        if (i > 0) out[len++] = ',';
+        bool deci = (i >= 2 && i < 7);
+        len += formatFixed(out + len, fields[i], deci ? 1 : 0);
+      }
+      out[len++] = ']';
+    }
+    conn.genIndex++;
+  }
+  return len;
+}
+
+// --- Time range export (/api/export.csv) ---
+
+// Header row, then one row per persisted sample from genSeq on with a wall
+// time in [genFrom, genUntil]; genSeq is the read cursor. The log is in
+// time order, so the first later sample ends the document. Samples without
+// a time (clock unknown, older log formats) and unreadable ones are skipped.
+static size_t csvExportGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  if (!conn.genStarted) {
+    len += sample_csv_header(out);
+    conn.genStarted = true;
+  }
+
+  uint32_t newest = sample_log_newest_seq();
+  while (conn.genSeries == 0 && cap - len >= SAMPLE_CSV_ROW_MAX) {
+    uint32_t seq = conn.genSeq++;
+    if (seq == 0 || seq > newest) {
+      conn.genSeries = 1;
+      break;
+    }
+    SampleRecord r;
+    uint32_t epoch;
+    if (!sample_log_read(seq, &r, &epoch) || epoch == 0 || epoch < conn.genFrom) continue;
+    if (epoch > conn.genUntil) {
+      conn.genSeries = 1;
+      break;
+    }
+
+    len += sample_csv_row(out + len, epoch, r);
+  }
+  return len;
+}
+
+// --- Persistent settings (/api/settings) ---
+
+// {"schema":1,"writes":W,"changes":C,"pending":false,"settings":{"co2_setpoint":{"value":800,"changes":3},...}}
+static size_t settingsJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  if (!conn.genStarted) {
+    len += appendText(out, "{\"schema\":");
+    len += formatFixed(out + len, SETTINGS_SCHEMA_VERSION, 0);
+    len += appendText(out + len, ",\"writes\":");
+    len += formatFixed(out + len, storage_flash_writes(), 0);
+    len += appendText(out + len, ",\"changes\":");
+    len += formatFixed(out + len, storage_total_changes(), 0);
+    len += appendText(out + len, storage_write_pending() ? ",\"pending\":true" : ",\"pending\":false");
+    len += appendText(out + len, ",\"settings\":{");
+    conn.genStarted = true;
+  }
+
+  while (conn.genSeries == 0 && cap - len >= JSON_TOKEN_MAX) {
+    if (conn.genIndex >= SETTING_COUNT) {
+      len += appendText(out + len, "}}");
+      conn.genSeries = 1;
+      break;
+    }
+    SettingKey key = (SettingKey)conn.genIndex;
+    if (conn.genIndex > 0) out[len++] = ',';
+    out[len++] = '"';
+    len += appendText(out + len, storage_setting_name(key));
+    len += appendText(out + len, "\":{\"value\":");
+    len += formatFixed(out + len, storage_get_chamber_setting(conn.chamber, key), storage_setting_decimals(key));
+    len += appendText(out + len, ",\"changes\":");
+    len += formatFixed(out + len, storage_chamber_setting_changes(conn.chamber, key), 0);
+    out[len++] = '}';
+    conn.genIndex++;
+  }
+  return len;
+}
+
+// --- Actuator statistics (/api/stats) ---
+
+static constexpr const char *STATS_WINDOW_NAMES[STATS_WINDOW_COUNT] = {"hour", "day", "boot"};
+
+// Largest stage: one actuator with all windows, or the lifetime totals
+static constexpr size_t STATS_WINDOW_JSON_MAX = // ,"hour":{"on_s":S,"switches":N,"duty":D,"wh":W}
+    39 + longestName(STATS_WINDOW_NAMES, STATS_WINDOW_COUNT) + 4 * JSON_NUMBER_MAX;
+static constexpr size_t STATS_ACTUATOR_JSON_MAX = // ,"fogger":{"on":false,"rated_w":R,<windows>}
+    27 + actuatorKeyMax() + JSON_NUMBER_MAX + STATS_WINDOW_COUNT * STATS_WINDOW_JSON_MAX;
+static constexpr size_t STATS_LIFETIME_JSON_MAX = // },"lifetime":{"checkpoints":C,"fogger":{"on_s":S,"switches":N,"kwh":K},...}}
+    32 + JSON_NUMBER_MAX + ACTUATOR_COUNT * (33 + actuatorKeyMax() + 3 * JSON_NUMBER_MAX);
+static constexpr size_t STATS_JSON_MAX =
+    (STATS_ACTUATOR_JSON_MAX > STATS_LIFETIME_JSON_MAX) ? STATS_ACTUATOR_JSON_MAX : STATS_LIFETIME_JSON_MAX;
+static_assert(STATS_JSON_MAX <= CHUNK_PAYLOAD_MAX, "One /api/stats stage must fit a chunk");
+
+// Fraction as a JSON number with 3 decimals
+static size_t formatShare(char *out, float share) {
+  return formatFixed(out, (int32_t)(share * 1000.0f + 0.5f), 3);
+}
+
+static const char *actuatorKey(uint8_t actuator) {
+  return CHANNELS[SENSOR_SERIES_COUNT + actuator].key;
+}
+
+// One stage per actuator, each from a fresh copy (a sample may land between them):
+// {"chamber":0,"span_s":{"hour":3600,"day":86400,"boot":B},"actuators":{
+//  "fogger":{"on":false,"rated_w":30,"hour":{"on_s":S,"switches":N,"duty":0.125,"wh":1.2},"day":{...},"boot":{...}},
+//  ...},"lifetime":{"checkpoints":C,"fogger":{"on_s":S,"switches":N,"kwh":0.5},...}}
+static size_t statsJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  while (conn.genIndex <= ACTUATOR_COUNT + 1 && cap - len >= STATS_JSON_MAX) {
+    ActuatorStats stats;
+    actuator_stats_read(conn.chamber, &stats);
+
+    if (conn.genIndex == 0) {
+      len += appendText(out + len, "{\"chamber\":");
+      len += formatFixed(out + len, conn.chamber, 0);
+      len += appendText(out + len, ",\"span_s\":{");
+      for (uint8_t w = 0; w < STATS_WINDOW_COUNT; w++) {
+        len += appendText(out + len, (w > 0) ? ",\"" : "\"");
+        len += appendText(out + len, STATS_WINDOW_NAMES[w]);
+        len += appendText(out + len, "\":");
+        len += formatFixed(out + len, (int32_t)(stats.spanMs[w] / 1000u), 0);
+      }
+      len += appendText(out + len, "},\"actuators\":{");
+    } else if (conn.genIndex <= ACTUATOR_COUNT) {
+      uint8_t a = (uint8_t)(conn.genIndex - 1);
+      len += appendText(out + len, (a > 0) ? ",\"" : "\"");
+      len += appendText(out + len, actuatorKey(a));
+      len += appendText(out + len, (stats.on & (1u << a)) ? "\":{\"on\":true" : "\":{\"on\":false");
+      len += appendText(out + len, ",\"rated_w\":");
+      len += formatFixed(out + len, (int32_t)actuator_stats_rated_w(a), 0);
+      for (uint8_t w = 0; w < STATS_WINDOW_COUNT; w++) {
+        const ActuatorTotals &t = stats.window[w][a];
+        len += appendText(out + len, ",\"");
+        len += appendText(out + len, STATS_WINDOW_NAMES[w]);
+        len += appendText(out + len, "\":{\"on_s\":");
+        len += formatFixed(out + len, (int32_t)(t.onMs / 1000u), 0);
+        len += appendText(out + len, ",\"switches\":");
+        len += formatFixed(out + len, (int32_t)t.switches, 0);
+        len += appendText(out + len, ",\"duty\":");
+        len += formatShare(out + len, (stats.spanMs[w] == 0) ? 0.0f : (float)((double)t.onMs / (double)stats.spanMs[w]));
+        len += appendText(out + len, ",\"wh\":");
+        len += formatFixed(out + len, (int32_t)(actuator_stats_wh(a, t.onMs) * 10.0f + 0.5f), 1);
+        out[len++] = '}';
       }
-      line = "";
+      out[len++] = '}';
     } else {
-      line += c;
+      ActuatorLifetime lifetime;
+      actuator_stats_lifetime(&lifetime);
+      len += appendText(out + len, "},\"lifetime\":{\"checkpoints\":");
+      len += formatFixed(out + len, (int32_t)lifetime.checkpoints, 0);
+      for (uint8_t a = 0; a < ACTUATOR_COUNT; a++) {
+        const ActuatorTotals &t = lifetime.total[a];
+        len += appendText(out + len, ",\"");
+        len += appendText(out + len, actuatorKey(a));
+        len += appendText(out + len, "\":{\"on_s\":");
+        len += formatFixed(out + len, (int32_t)(t.onMs / 1000u), 0);
+        len += appendText(out + len, ",\"switches\":");
+        len += formatFixed(out + len, (int32_t)t.switches, 0);
+        len += appendText(out + len, ",\"kwh\":");
+        len += formatFixed(out + len, (int32_t)(actuator_stats_wh(a, t.onMs) / 100.0f + 0.5f), 1);
+        out[len++] = '}';
+      }
+      len += appendText(out + len, "}}\r\n");
     }
+    conn.genIndex++;
   }
+  return len;
+}
+
+// --- Alarms (/api/alarms) ---
+
+// One chamber stage, with the document head in front of the first chamber
+// and the edges array opened after the last:
+// {"newest":N,"chambers":[ + ,{"chamber":C,"active":[<names>],"raised":{<name:count>}} + ],"edges":[
+static constexpr size_t ALARM_CHAMBER_JSON_MAX =
+    (23 + JSON_NUMBER_MAX) + (48 + JSON_NUMBER_MAX) +
+    ALARM_RULE_COUNT * ((ALARM_RULE_NAME_MAX + 3) + (ALARM_RULE_NAME_MAX + 4 + 5));
+static_assert(ALARM_CHAMBER_JSON_MAX <= CHUNK_PAYLOAD_MAX, "One /api/alarms chamber stage must fit a chunk");
+static_assert(ALARM_EDGE_JSON_MAX + 1 <= CHUNK_PAYLOAD_MAX, "One /api/alarms edge must fit a chunk");
 
-  Serial.print("Web: Request path: ");
-  Serial.println(path);
+// One stage per chamber, then the retained edges after `since`:
+// {"newest":N,"chambers":[{"chamber":0,"active":["heater_stuck_on"],"raised":{"co2_disagree":0,...}},...],
+//  "edges":[{"seq":N,"epoch":T,"chamber":0,"alarm":"heater_stuck_on","state":"raised","value":1800,"limit":1800},...]}
+static size_t alarmsJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  while (conn.genIndex < Config::Chambers::COUNT && cap - len >= ALARM_CHAMBER_JSON_MAX) {
+    if (!conn.genStarted) {
+      len += appendText(out + len, "{\"newest\":");
+      len += formatFixed(out + len, (int32_t)alarms_newest_seq(), 0);
+      len += appendText(out + len, ",\"chambers\":[");
+      conn.genStarted = true;
+    }
+
+    uint8_t c = (uint8_t)conn.genIndex;
+    AlarmStatus status;
+    alarms_status(c, &status);
+    if (c > 0) out[len++] = ',';
+    len += appendText(out + len, "{\"chamber\":");
+    len += formatFixed(out + len, c, 0);
+    len += appendText(out + len, ",\"active\":[");
+    bool first = true;
+    for (uint8_t r = 0; r < ALARM_RULE_COUNT; r++) {
+      if (!(status.active & (1u << r))) continue;
+      len += appendText(out + len, first ? "\"" : ",\"");
+      len += appendText(out + len, alarms_rule_name(r));
+      out[len++] = '"';
+      first = false;
+    }
+    len += appendText(out + len, "],\"raised\":{");
+    for (uint8_t r = 0; r < ALARM_RULE_COUNT; r++) {
+      len += appendText(out + len, (r > 0) ? ",\"" : "\"");
+      len += appendText(out + len, alarms_rule_name(r));
+      len += appendText(out + len, "\":");
+      len += formatFixed(out + len, status.raises[r], 0);
+    }
+    len += appendText(out + len, "}}");
+    conn.genIndex++;
+    if (conn.genIndex == Config::Chambers::COUNT) len += appendText(out + len, "],\"edges\":[");
+  }
+  if (conn.genIndex < Config::Chambers::COUNT) return len;
 
-  // Parse path and query string
-  String pathOnly = path;
-  String query = "";
-  int queryIndex = path.indexOf('?');
-  if (queryIndex >= 0) {
-    pathOnly = path.substring(0, queryIndex);
-    query = path.substring(queryIndex + 1);
+  // Edges: genSeq is the cursor, genCount the number written
+  if (conn.genSeq + 1 < alarms_oldest_seq()) conn.genSeq = alarms_oldest_seq() - 1;
+  while (conn.genSeq < alarms_newest_seq() && cap - len >= ALARM_EDGE_JSON_MAX + 1) {
+    AlarmEdge edge;
+    conn.genSeq++;
+    if (!alarms_edge(conn.genSeq, &edge)) continue;
+    if (conn.genCount > 0) out[len++] = ',';
+    len += alarms_edge_json(out + len, edge);
+    conn.genCount++;
   }
+  if (conn.genSeries == 0 && conn.genSeq >= alarms_newest_seq() && cap - len >= 4) {
+    conn.genSeries = 1;
+    len += appendText(out + len, "]}\r\n");
+  }
+  return len;
+}
 
-  if (pathOnly == "/inc") {
-    handleIncrement(client, config);
-  } else if (pathOnly == "/api/last200") {
-    handleLast200(client);
-  } else if (pathOnly == "/api/setpoint") {
-    handleSetpoint(client, query);
-  } else if (pathOnly == "/api/setpoint_rh") {
-    handleSetpointRH(client, query);
-  } else if (pathOnly == "/api/setpoint_temp") {
-    handleSetpointTemp(client, query);
-  } else if (pathOnly == "/old") {
-    // Old counter interface
-    serveIndex(client, config);
-  } else {
-    // Default: Climate chamber UI
-    serveClimateUI(client);
+// --- Channel registry (/api/channels) ---
+
+static constexpr size_t CHANNEL_JSON_MAX = 160; // One chart or channel object
+
+// Charts in display order, then one object per CHANNELS row; the dashboard
+// builds its charts and maps every history field from this document
+static size_t channelsJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  if (!conn.genStarted) {
+    len += appendText(out, "{\"charts\":[");
+    conn.genStarted = true;
+  }
+
+  while (conn.genSeries == 0 && cap - len >= CHANNEL_JSON_MAX) {
+    if (conn.genIndex < CHART_COUNT) {
+      const ChartDef &chart = CHARTS[conn.genIndex];
+      if (conn.genIndex > 0) out[len++] = ',';
+      len += appendText(out + len, "{\"title\":\"");
+      len += appendText(out + len, chart.title);
+      len += appendText(out + len, "\",\"round\":");
+      len += formatFixed(out + len, chart.roundStep, 0);
+      out[len++] = '}';
+    } else if (conn.genIndex < CHART_COUNT + SERIES_COUNT) {
+      const ChannelDef &channel = CHANNELS[conn.genIndex - CHART_COUNT];
+      len += appendText(out + len, (channel.series == 0) ? "],\"channels\":[" : ",");
+      len += appendText(out + len, "{\"key\":\"");
+      len += appendText(out + len, channel.key);
+      len += appendText(out + len, "\",\"label\":\"");
+      len += appendText(out + len, channel.label);
+      len += appendText(out + len, "\",\"unit\":\"");
+      len += appendText(out + len, channel.unit);
+      len += appendText(out + len, "\",\"decimals\":");
+      len += formatFixed(out + len, channel.decimals, 0);
+      len += appendText(out + len, (channel.kind == CHANNEL_SENSOR) ? ",\"type\":\"sensor\",\"chart\":"
+                                                                   : ",\"type\":\"actuator\",\"chart\":");
+      len += formatFixed(out + len, channel.chart, 0);
+      len += appendText(out + len, ",\"color\":\"#");
+      len += appendText(out + len, channel.color);
+      len += appendText(out + len, "\"}");
+    } else {
+      len += appendText(out + len, "]}");
+      conn.genSeries = 1;
+      break;
+    }
+    conn.genIndex++;
+  }
+  return len;
+}
+
+// --- Event log (/api/events) ---
+
+static constexpr uint16_t EVENTS_DEFAULT_COUNT = 50;
+static constexpr size_t EVENT_JSON_MAX = 240; // One event object incl. its text
+
+// Append text as a JSON string body (quotes, backslashes and controls escaped)
+static size_t appendJsonEscaped(char *out, const char *text) {
+  size_t len = 0;
+  for (; *text != '\0'; text++) {
+    char c = *text;
+    if (c == '"' || c == '\\') {
+      out[len++] = '\\';
+      out[len++] = c;
+    } else if ((uint8_t)c < 0x20) {
+      out[len++] = ' ';
+    } else {
+      out[len++] = c;
+    }
+  }
+  return len;
+}
+
+// {"oldest":O,"newest":N,"dropped":D,"events":[{"seq":S,"t":ms,"module":"control",
+//  "level":"info","event":"swirler","args":[1],"text":"Swirler: ON"},...]}
+// Records overwritten while the response is streamed are skipped (seq gap)
+static size_t eventsJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  if (!conn.genStarted) {
+    len += appendText(out, "{\"oldest\":");
+    len += formatFixed(out + len, event_log_oldest_seq(), 0);
+    len += appendText(out + len, ",\"newest\":");
+    len += formatFixed(out + len, event_log_newest_seq(), 0);
+    len += appendText(out + len, ",\"dropped\":");
+    len += formatFixed(out + len, event_log_dropped(), 0);
+    len += appendText(out + len, ",\"events\":[");
+    conn.genStarted = true;
+  }
+
+  while (conn.genSeries == 0 && cap - len >= EVENT_JSON_MAX) {
+    if (conn.genIndex >= conn.genCount) {
+      len += appendText(out + len, "]}");
+      conn.genSeries = 1;
+      break;
+    }
+    EventRecord record;
+    uint32_t seq = conn.genSeq + conn.genIndex++;
+    if (!event_log_read(seq, &record)) continue;
+
+    if (conn.genEmitted++ > 0) out[len++] = ',';
+    len += appendText(out + len, "{\"seq\":");
+    len += formatFixed(out + len, record.seq, 0);
+    len += appendText(out + len, ",\"t\":");
+    len += formatFixed(out + len, record.timestampMs, 0);
+    if (Config::Chambers::COUNT > 1) {
+      len += appendText(out + len, ",\"chamber\":");
+      len += formatFixed(out + len, record.chamber, 0);
+    }
+    len += appendText(out + len, ",\"module\":\"");
+    len += appendText(out + len, event_log_module_name(record.id));
+    len += appendText(out + len, "\",\"level\":\"");
+    len += appendText(out + len, event_log_level_name(record.id));
+    len += appendText(out + len, "\",\"event\":\"");
+    len += appendText(out + len, event_log_name(record.id));
+    len += appendText(out + len, "\",\"args\":[");
+    uint8_t argCount = event_log_arg_count(record.id);
+    for (uint8_t i = 0; i < argCount; i++) {
+      if (i > 0) out[len++] = ',';
+      len += formatFixed(out + len, record.args[i], event_log_arg_decimals(record.id, i));
+    }
+    len += appendText(out + len, "],\"text\":\"");
+    char text[96];
+    event_log_format(record, text, sizeof(text));
+    len += appendJsonEscaped(out + len, text);
+    len += appendText(out + len, "\"}");
+  }
+  return len;
+}
+
+// --- Profiling (/api/perf, only with -DCC_PERF=1) ---
+
+#if CC_PERF
+static constexpr size_t PERF_JSON_MAX = 480; // One probe with its histogram
+
+// Cycles as microseconds with two decimals
+static size_t appendMicros(char *out, uint64_t cycles) {
+  uint64_t hundredths = cycles * 100 * 1000000 / perf_cycles_per_second();
+  return formatFixed(out, (int32_t)hundredths, 2);
+}
+
+// {"enabled":true,"cycles_per_us":480,"loop_hz":H,"idle_passes":I,"probes":[{"name":"action",
+//  "count":N,"min_us":..,"avg_us":..,"max_us":..,"max_cycles":C,"hist_from":B,"hist":[..]},...],
+//  "boot":[{"phase":"outputs","start_us":S,"us":D},...]}
+// hist holds buckets hist_from.. (runs of 2^b..2^(b+1)-1 cycles); trailing zeros are cut.
+// boot lists the completed startup phases, start_us counted from reset.
+static size_t perfJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  if (!conn.genStarted) {
+    len += appendText(out, "{\"enabled\":true,\"cycles_per_us\":");
+    len += formatFixed(out + len, perf_cycles_per_second() / 1000000, 0);
+    len += appendText(out + len, ",\"loop_hz\":");
+    len += formatFixed(out + len, perf_loop_hz(), 0);
+    len += appendText(out + len, ",\"idle_passes\":");
+    len += formatFixed(out + len, scheduler_idle_passes(), 0);
+    len += appendText(out + len, ",\"probes\":[");
+    conn.genStarted = true;
   }
 
-  delay(1);
-  client.stop();
-  Serial.println("Web: Client disconnected");
+  while (conn.genSeries == 0 && cap - len >= PERF_JSON_MAX) {
+    if (conn.genIndex >= PERF_PROBE_COUNT) {
+      len += appendText(out + len, "]");
+      conn.genSeries = 1;
+      break;
+    }
+    uint8_t probe = (uint8_t)conn.genIndex++;
+    PerfStats stats;
+    if (!perf_stats(probe, &stats)) continue;
+
+    uint8_t from = 0;
+    uint8_t to = PERF_HISTOGRAM_BUCKETS;
+    while (from < to && stats.histogram[from] == 0) from++;
+    while (to > from && stats.histogram[to - 1] == 0) to--;
+
+    if (conn.genEmitted++ > 0) out[len++] = ',';
+    len += appendText(out + len, "{\"name\":\"");
+    len += appendText(out + len, perf_probe_name(probe));
+    len += appendText(out + len, "\",\"count\":");
+    len += formatFixed(out + len, stats.count, 0);
+    len += appendText(out + len, ",\"min_us\":");
+    len += appendMicros(out + len, stats.minCycles);
+    len += appendText(out + len, ",\"avg_us\":");
+    len += appendMicros(out + len, stats.totalCycles / stats.count);
+    len += appendText(out + len, ",\"max_us\":");
+    len += appendMicros(out + len, stats.maxCycles);
+    len += appendText(out + len, ",\"max_cycles\":");
+    len += formatFixed(out + len, stats.maxCycles, 0);
+    len += appendText(out + len, ",\"hist_from\":");
+    len += formatFixed(out + len, from, 0);
+    len += appendText(out + len, ",\"hist\":[");
+    for (uint8_t b = from; b < to; b++) {
+      if (b > from) out[len++] = ',';
+      len += formatFixed(out + len, stats.histogram[b], 0);
+    }
+    len += appendText(out + len, "]}");
+  }
+
+  static constexpr size_t BOOT_JSON_MAX = 24 + PERF_BOOT_PHASE_COUNT * 64;
+  if (conn.genSeries == 1 && cap - len >= BOOT_JSON_MAX) {
+    len += appendText(out + len, ",\"boot\":[");
+    bool first = true;
+    for (uint8_t phase = 0; phase < PERF_BOOT_PHASE_COUNT; phase++) {
+      PerfBootTime boot;
+      if (!perf_boot_time((PerfBootPhase)phase, &boot)) continue;
+      if (!first) out[len++] = ',';
+      first = false;
+      len += appendText(out + len, "{\"phase\":\"");
+      len += appendText(out + len, perf_boot_phase_name((PerfBootPhase)phase));
+      len += appendText(out + len, "\",\"start_us\":");
+      len += formatFixed(out + len, (int32_t)boot.startUs, 0);
+      len += appendText(out + len, ",\"us\":");
+      len += formatFixed(out + len, (int32_t)boot.durationUs, 0);
+      out[len++] = '}';
+    }
+    len += appendText(out + len, "]}");
+    conn.genSeries = 2;
+  }
+  return len;
+}
+#endif
+
+// --- Binary telemetry serializer (see telemetry_format.h) ---
+
+// Sensor channels of the binary layout, in wire order: CHANNELS order
+static_assert(Telemetry::SENSOR_CHANNEL_COUNT == SENSOR_SERIES_COUNT,
+              "Telemetry sensor channels must match the controller history");
+
+static inline void putLe16(char *out, uint16_t v) {
+  out[0] = (char)(v & 0xFF);
+  out[1] = (char)(v >> 8);
+}
+
+// The recorded state word is the wire format, no repacking needed
+static_assert(Telemetry::ACTUATOR_FOGGER == ACTUATOR_BIT_FOGGER &&
+              Telemetry::ACTUATOR_SWIRLER == ACTUATOR_BIT_SWIRLER &&
+              Telemetry::ACTUATOR_FRESHAIR == ACTUATOR_BIT_FRESHAIR &&
+              Telemetry::ACTUATOR_HEATER == ACTUATOR_BIT_HEATER,
+              "Telemetry actuator bits must match the controller state word");
+
+static size_t writeTelemetryHeader(const HttpConnection &conn, char *out, uint8_t flags) {
+  Telemetry::Header header;
+  header.magic[0] = Telemetry::MAGIC_0;
+  header.magic[1] = Telemetry::MAGIC_1;
+  header.version = Telemetry::FORMAT_VERSION;
+  header.flags = flags | (conn.genReset ? Telemetry::FLAG_RESET : 0);
+  header.seq = conn.genSeq;
+  header.count = conn.genCount;
+  header.length = controller_history_length();
+  header.sample_interval_ms = (uint16_t)controller_get_sample_interval_ms();
+  ControllerSnapshot state;
+  controller_snapshot(conn.chamber, &state);
+  header.co2_setpoint = state.co2_setpoint;
+  header.rh_setpoint_x10 = state.rh_setpoint_x10;
+  header.temp_setpoint_x10 = state.temp_setpoint_x10;
+  header.uptime_s = millis() / 1000;
+  memcpy(out, &header, sizeof(header)); // Cortex-M is little-endian
+  return sizeof(header);
+}
+
+// Stream the binary layout channel by channel, one chunk per call
+static size_t historyBinaryGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  if (!conn.genStarted) {
+    len += writeTelemetryHeader(conn, out, 0);
+    conn.genStarted = true;
+  }
+
+  // Channels 0..SENSOR_CHANNEL_COUNT-1 are sensors, the last one actuators
+  while (conn.genSeries <= Telemetry::SENSOR_CHANNEL_COUNT && cap - len >= 2) {
+    if (conn.genIndex >= conn.genCount) {
+      conn.genIndex = 0;
+      conn.genSeries++;
+      continue;
+    }
+
+    uint32_t back = conn.genCount - 1 - conn.genIndex;
+    uint32_t seq = (back >= conn.genSeq) ? 0 : conn.genSeq - back; // 0 reads as zero padding
+
+    if (conn.genSeries < Telemetry::SENSOR_CHANNEL_COUNT) {
+      HistorySeries series = (HistorySeries)conn.genSeries;
+      const CachedSample *row = cachedSample(conn.chamber, seq);
+      int16_t fixed;
+      if (row != nullptr) {
+        fixed = row->fixed[series];
+      } else {
+        fixed = (seq == 0) ? 0 : controller_history_value(conn.chamber, series, seq);
+      }
+      putLe16(out + len, (uint16_t)fixed);
+      len += 2;
+    } else {
+      const CachedSample *row = cachedSample(conn.chamber, seq);
+      out[len++] = (char)((row != nullptr) ? row->actuators : controller_history_actuators(conn.chamber, seq));
+    }
+    conn.genIndex++;
+  }
+  return len;
+}
+
+// Packed layout: a block header and its delta-coded payload per call
+static constexpr size_t PACKED_BLOCK_MAX = 3 + sample_codec_max_bytes(Telemetry::PACKED_BLOCK_SAMPLES);
+static_assert(sizeof(Telemetry::Header) + PACKED_BLOCK_MAX <=
+              SCRATCH_BUFFER_SIZE - CHUNK_HEADER_SIZE - CHUNK_TRAILER_SIZE,
+              "Header and one packed block must fit a chunk");
+
+// Fixed-point record of one history sample; seq 0 is zero padding
+static void historyRecord(uint8_t chamber, uint32_t seq, SampleRecord *out) {
+  const CachedSample *row = cachedSample(chamber, seq);
+  if (row == nullptr) {
+    int16_t frame[SERIES_COUNT] = {};
+    uint8_t actuators = 0;
+    if (seq != 0) {
+      controller_history_frame(chamber, seq, frame);
+      actuators = controller_history_actuators(chamber, seq);
+    }
+    sample_log_encode(frame, actuators, out);
+    return;
+  }
+  out->co2 = (uint16_t)row->fixed[SERIES_CO2];
+  out->co2_2 = (uint16_t)row->fixed[SERIES_CO2_2];
+  out->rh_x10 = row->fixed[SERIES_RH];
+  out->rh_2_x10 = row->fixed[SERIES_RH_2];
+  out->temp_x10 = row->fixed[SERIES_TEMP];
+  out->temp_2_x10 = row->fixed[SERIES_TEMP_2];
+  out->temp_outer_x10 = row->fixed[SERIES_TEMP_OUTER];
+  out->actuators = row->actuators;
+}
+
+static size_t historyPackedGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  if (!conn.genStarted) {
+    len += writeTelemetryHeader(conn, out, Telemetry::FLAG_PACKED);
+    conn.genStarted = true;
+  }
+
+  while (conn.genIndex < conn.genCount && cap - len >= PACKED_BLOCK_MAX) {
+    SampleRecord records[Telemetry::PACKED_BLOCK_SAMPLES];
+    uint16_t count = conn.genCount - conn.genIndex;
+    if (count > Telemetry::PACKED_BLOCK_SAMPLES) count = Telemetry::PACKED_BLOCK_SAMPLES;
+    for (uint16_t i = 0; i < count; i++) {
+      uint32_t back = conn.genCount - 1 - (conn.genIndex + i);
+      historyRecord(conn.chamber, (back >= conn.genSeq) ? 0 : conn.genSeq - back, &records[i]);
+    }
+    size_t bytes = sample_codec_encode(records, count, (uint8_t *)out + len + 3, PACKED_BLOCK_MAX - 3);
+    out[len] = (char)count;
+    putLe16(out + len + 1, (uint16_t)bytes);
+    len += 3 + bytes;
+    conn.genIndex += count;
+  }
+  return len;
+}
+
+// JSON for the browser, binary for "format=bin", delta-coded for "format=packed"
+static BodyGenerator historyGenerator(HttpSlice query, const char **contentType);
+
+// API endpoint: /api/last200 (all series + all setpoints + timestamp)
+//
+// ?points=N (JSON only): all retained samples downsampled to N points
+static void handleLast200(HttpConnection &conn, HttpSlice query) {
+  uint16_t retained = controller_tier_length(conn.chamber, RES_RAW);
+  uint16_t points = requestedPoints(query, retained);
+  if (points > 0 && queryParam(query, "format").len == 0) {
+    beginChunkedResponse(conn, "application/json", downsampleJsonGenerator);
+    conn.genSeq = controller_tier_seq(conn.chamber, RES_RAW);
+    conn.genCount = retained;
+    conn.genPoints = points;
+    return;
+  }
+
+  const char *contentType;
+  BodyGenerator generator = historyGenerator(query, &contentType);
+  beginChunkedResponse(conn, contentType, generator);
+  ControllerSnapshot state;
+  controller_snapshot(conn.chamber, &state);
+  conn.genSeq = state.seq; // Consistent window for the whole response
+  conn.genCount = controller_history_length();
+}
+
+static BodyGenerator historyGenerator(HttpSlice query, const char **contentType) {
+  HttpSlice format = queryParam(query, "format");
+  if (sliceIs(format, "bin")) {
+    *contentType = "application/octet-stream";
+    return historyBinaryGenerator;
+  }
+  if (sliceIs(format, "packed")) {
+    *contentType = "application/octet-stream";
+    return historyPackedGenerator;
+  }
+  *contentType = "application/json";
+  return historyJsonGenerator;
+}
+
+// API endpoint: /api/since?seq=N (samples newer than N)
+//
+// Returns only the samples after the client's last-seen sequence number.
+// Falls back to the full window ("reset":true) when the client has no data
+// yet, has fallen out of the ring, or the controller restarted.
+static void handleSince(HttpConnection &conn, HttpSlice query) {
+  uint32_t since = (uint32_t)sliceToLong(queryParam(query, "seq"));
+  ControllerSnapshot state;
+  controller_snapshot(conn.chamber, &state);
+  uint32_t newest = state.seq;
+  uint16_t length = controller_history_length();
+
+  const char *contentType;
+  BodyGenerator generator = historyGenerator(query, &contentType);
+  beginChunkedResponse(conn, contentType, generator);
+  conn.genSeq = newest;
+  conn.genDelta = true;
+  conn.genReset = (since == 0 || since > newest || (newest - since) > length);
+  conn.genCount = conn.genReset ? length : (uint16_t)(newest - since);
+}
+
+// Respond with {"setpoint":<value>}
+static void beginSetpointResponse(HttpConnection &conn, float value, uint8_t decimals) {
+  size_t len = appendText(conn.scratch, "{\"setpoint\":");
+  len += formatNumber(conn.scratch + len, value, decimals);
+  len += appendText(conn.scratch + len, "}\r\n");
+  beginScratchResponse(conn, "200 OK", "application/json", len);
+}
+
+// Queue a clamped setting change for the controller's command task and
+// respond with the value it will apply. Returns false (503 sent) if the
+// command queue is full.
+static bool postSetting(HttpConnection &conn, SettingKey key, float value, float *applied) {
+  int32_t raw = storage_setting_from_float(key, value);
+  if (!control_link_post(conn.chamber, key, raw)) {
+    int len = snprintf(conn.scratch, sizeof(conn.scratch), "{\"error\":\"busy, retry\"}\r\n");
+    beginScratchResponse(conn, "503 Service Unavailable", "application/json", len);
+    return false;
+  }
+  *applied = storage_setting_to_float(key, raw);
+  beginSetpointResponse(conn, *applied, storage_setting_decimals(key));
+  return true;
+}
+
+// API endpoint: /api/setpoint?value=XXX (set CO2 setpoint)
+static void handleSetpoint(HttpConnection &conn, HttpSlice query) {
+  uint16_t newSetpoint = 800; // default
+  HttpSlice value = queryParam(query, "value");
+  if (value.len > 0) {
+    newSetpoint = sliceToLong(value);
+  }
+
+  // Clamped to 400-10000, applied by the controller on its next pass
+  float actualSetpoint;
+  if (!postSetting(conn, SETTING_CO2_SETPOINT, newSetpoint, &actualSetpoint)) return;
+
+  event_log_chamber(conn.chamber, EVT_API_CO2_SETPOINT, lroundf(actualSetpoint));
+}
+
+// API endpoint: /api/setpoint_rh?value=XX.X (set RH setpoint)
+static void handleSetpointRH(HttpConnection &conn, HttpSlice query) {
+  float newSetpoint = 95.0f; // default
+  HttpSlice value = queryParam(query, "value");
+  if (value.len > 0) {
+    newSetpoint = sliceToFloat(value);
+  }
+
+  float actualSetpoint;
+  if (!postSetting(conn, SETTING_RH_SETPOINT, newSetpoint, &actualSetpoint)) return;
+
+  event_log_chamber(conn.chamber, EVT_API_RH_SETPOINT, event_tenths(actualSetpoint));
+}
+
+// API endpoint: /api/setpoint_temp?value=XX.X (set Temp setpoint)
+static void handleSetpointTemp(HttpConnection &conn, HttpSlice query) {
+  float newSetpoint = 25.0f; // default
+  HttpSlice value = queryParam(query, "value");
+  if (value.len > 0) {
+    newSetpoint = sliceToFloat(value);
+  }
+
+  float actualSetpoint;
+  if (!postSetting(conn, SETTING_TEMP_SETPOINT, newSetpoint, &actualSetpoint)) return;
+
+  event_log_chamber(conn.chamber, EVT_API_TEMP_SETPOINT, event_tenths(actualSetpoint));
+}
+
+// API endpoint: POST /api/setpoints with {"co2":900,"rh":92.5,"temp":25.0}
+//
+// Any subset of the setpoints, plus every other setting under its
+// /api/settings name (e.g. "heater_kp"). All members are validated first;
+// nothing is queued unless every key is known and in range. The batch
+// reaches the controller in one command pass: one controller update, and
+// the storage write coalescing turns it into one flash commit.
+
+struct SettingAlias {
+  const char *name;
+  SettingKey key;
+};
+
+static const SettingAlias SETPOINT_ALIASES[] = {
+  {"co2", SETTING_CO2_SETPOINT},
+  {"rh", SETTING_RH_SETPOINT},
+  {"temp", SETTING_TEMP_SETPOINT},
+};
+
+static constexpr size_t SETTINGS_BODY_MAX = HEAD_BUFFER_SIZE - 1; // Body is parsed in conn.head
+static constexpr int KEY_ECHO_MAX = 32;                            // Key characters quoted in errors
+
+static SettingKey settingForMember(const JsonMember &member) {
+  for (const SettingAlias &alias : SETPOINT_ALIASES) {
+    if (JsonObjectReader::keyIs(member, alias.name)) return alias.key;
+  }
+  for (uint8_t k = SETTING_COUNTER + 1; k < SETTING_COUNT; k++) {
+    if (JsonObjectReader::keyIs(member, storage_setting_name((SettingKey)k))) return (SettingKey)k;
+  }
+  return SETTING_COUNT;
+}
+
+static void beginMemberError(HttpConnection &conn, const char *status, const JsonMember &member,
+                             const char *problem) {
+  int keyLen = (member.keyLen < KEY_ECHO_MAX) ? member.keyLen : KEY_ECHO_MAX;
+  int len = snprintf(conn.scratch, sizeof(conn.scratch), "{\"error\":\"%s\",\"key\":\"%.*s\"}\r\n",
+                     problem, keyLen, member.key);
+  beginScratchResponse(conn, status, "application/json", len);
+}
+
+// Validate a settings object into `batch` (members: the request's keys).
+// Returns false with the error response already started.
+static bool parseSettingsBody(HttpConnection &conn, const char *body, ControlCommand *batch, JsonMember *members,
+                              uint8_t *countOut) {
+  uint8_t count = 0;
+  JsonObjectReader reader(body);
+  JsonMember member;
+  while (reader.next(&member)) {
+    SettingKey key = settingForMember(member);
+    if (key == SETTING_COUNT) {
+      beginMemberError(conn, "400 Bad Request", member, "unknown setting");
+      return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+      if (batch[i].key == key) {
+        beginMemberError(conn, "400 Bad Request", member, "duplicate setting");
+        return false;
+      }
+    }
+    int32_t raw;
+    if (!storage_setting_parse(key, member.value, &raw)) {
+      beginMemberError(conn, "422 Unprocessable Entity", member, "out of range");
+      return false;
+    }
+    batch[count].chamber = conn.chamber;
+    batch[count].key = key;
+    batch[count].raw = raw;
+    members[count] = member;
+    count++;
+  }
+  if (!reader.ok()) {
+    beginErrorResponse(conn, "400 Bad Request", "malformed JSON object");
+    return false;
+  }
+  if (count == 0) {
+    beginErrorResponse(conn, "400 Bad Request", "no settings");
+    return false;
+  }
+  *countOut = count;
+  return true;
+}
+
+static void applySettingsBody(HttpConnection &conn, const char *body) {
+  ControlCommand batch[SETTING_COUNT];
+  JsonMember members[SETTING_COUNT];
+  uint8_t count;
+  if (!parseSettingsBody(conn, body, batch, members, &count)) return;
+  if (!control_link_post_batch(batch, count)) {
+    beginErrorResponse(conn, "503 Service Unavailable", "busy, retry");
+    return;
+  }
+  event_log_chamber(conn.chamber, EVT_API_SETTINGS_BATCH, count);
+
+  // Echo the values the controller will apply, under the request's keys
+  size_t len = 0;
+  conn.scratch[len++] = '{';
+  for (uint8_t i = 0; i < count; i++) {
+    if (i > 0) conn.scratch[len++] = ',';
+    conn.scratch[len++] = '"';
+    memcpy(conn.scratch + len, members[i].key, members[i].keyLen);
+    len += members[i].keyLen;
+    len += appendText(conn.scratch + len, "\":");
+    len += formatNumber(conn.scratch + len, storage_setting_to_float(batch[i].key, batch[i].raw),
+                        storage_setting_decimals(batch[i].key));
+  }
+  len += appendText(conn.scratch + len, "}\r\n");
+  beginScratchResponse(conn, "200 OK", "application/json", len);
+}
+
+// Collect the body in conn.head (unused until the response), then apply it
+static void settingsBodySink(HttpConnection &conn, const uint8_t *data, size_t len) {
+  if (len > 0) {
+    memcpy(conn.head + conn.genBytes, data, len);
+    conn.genBytes += len;
+    return;
+  }
+  conn.head[conn.genBytes] = '\0';
+  applySettingsBody(conn, conn.head);
+}
+
+// Start reading a POSTed settings object into conn.head; `sink` applies it
+static void acceptSettingsBody(HttpConnection &conn, BodySink sink) {
+  if (conn.method != HTTP_POST) {
+    beginErrorResponse(conn, "405 Method Not Allowed", "use POST with a JSON object");
+    return;
+  }
+  if (conn.contentLength < 0) {
+    beginErrorResponse(conn, "411 Length Required", "Content-Length required");
+    return;
+  }
+  if ((size_t)conn.contentLength > SETTINGS_BODY_MAX) {
+    beginErrorResponse(conn, "413 Payload Too Large", "body too large");
+    return;
+  }
+  conn.sink = sink;
+  conn.bodyRemaining = (uint32_t)conn.contentLength;
+  conn.genBytes = 0;
+  conn.state = CONN_BODY;
+}
+
+static void handleSetpointsPost(HttpConnection &conn) {
+  acceptSettingsBody(conn, settingsBodySink);
+}
+
+// Route a fully parsed request to its handler
+// API endpoint: /api/history?res=raw|1m|15m[&n=N][&points=P]
+//
+// Serves the newest N (default: all retained) buckets of a downsampled tier:
+// min/mean/max per sensor and on-duty per actuator. res=raw is /api/last200.
+// With points=P the window is reduced to P points per field (downsample.h).
+static void handleHistory(HttpConnection &conn, HttpSlice query) {
+  HttpSlice res = queryParam(query, "res");
+  HistoryResolution tier;
+  if (sliceIs(res, "1m")) {
+    tier = RES_1M;
+  } else if (sliceIs(res, "15m")) {
+    tier = RES_15M;
+  } else if (res.len == 0 || sliceIs(res, "raw")) {
+    handleLast200(conn, query);
+    return;
+  } else {
+    int len = snprintf(conn.scratch, sizeof(conn.scratch),
+                       "{\"error\":\"res must be raw, 1m or 15m\"}");
+    beginScratchResponse(conn, "400 Bad Request", "application/json", len);
+    return;
+  }
+
+  uint16_t length = controller_tier_length(conn.chamber, tier);
+  long n = sliceToLong(queryParam(query, "n"));
+  uint16_t count = (n > 0 && n < length) ? (uint16_t)n : length;
+  uint16_t points = requestedPoints(query, count);
+  beginChunkedResponse(conn, "application/json", (points > 0) ? downsampleJsonGenerator : tierJsonGenerator);
+  conn.genRes = tier;
+  conn.genSeq = controller_tier_seq(conn.chamber, tier);
+  conn.genCount = count;
+  conn.genPoints = points;
+}
+
+// API endpoint: /api/log?from=N[&n=M] (persisted samples, survives reboots)
+//
+// Without "from" the newest M (default 200) samples are returned.
+static void handleLog(HttpConnection &conn, HttpSlice query) {
+  uint32_t oldest = sample_log_oldest_seq();
+  uint32_t newest = sample_log_newest_seq();
+  long n = sliceToLong(queryParam(query, "n"));
+  uint16_t count = (n > 0 && n < LOG_MAX_SAMPLES) ? (uint16_t)n : Config::SENSOR_RING_BUFFER_SIZE;
+  if (n >= LOG_MAX_SAMPLES) count = LOG_MAX_SAMPLES;
+
+  uint32_t first;
+  HttpSlice from = queryParam(query, "from");
+  if (from.len > 0) {
+    first = (uint32_t)sliceToLong(from);
+    if (first < oldest) first = oldest;
+  } else {
+    first = (newest >= oldest + count) ? newest - count + 1 : oldest;
+  }
+  if (oldest == 0 || first > newest) {
+    count = 0;
+  } else if (newest - first + 1 < count) {
+    count = (uint16_t)(newest - first + 1);
+  }
+
+  beginChunkedResponse(conn, "application/json", logJsonGenerator);
+  conn.genSeq = first;
+  conn.genCount = count;
+}
+
+// Query parameter as a wall time (epoch seconds or ISO 8601 UTC); false if
+// present but malformed, `fallback` if absent
+static bool queryTime(HttpSlice query, const char *name, uint32_t fallback, uint32_t *out) {
+  HttpSlice value = queryParam(query, name);
+  if (value.len == 0) {
+    *out = fallback;
+    return true;
+  }
+  return wall_clock_parse(value.data, value.len, out);
+}
+
+// API endpoint: /api/export.csv?from=T&to=T (persisted samples in a wall time
+// range, streamed from flash as CSV; T = epoch seconds or 2026-01-31T12:00:00Z)
+//
+// Without "from" the export starts at the oldest sample, without "to" it
+// runs to the newest.
+static void handleExport(HttpConnection &conn, HttpSlice query) {
+  if (!sample_log_available()) {
+    beginErrorResponse(conn, "503 Service Unavailable", "sample log not available");
+    return;
+  }
+  uint32_t from, to;
+  if (!queryTime(query, "from", 0, &from) || !queryTime(query, "to", UINT32_MAX, &to)) {
+    beginErrorResponse(conn, "400 Bad Request", "from/to: epoch seconds or YYYY-MM-DDTHH:MM:SSZ");
+    return;
+  }
+  if (from > to) {
+    beginErrorResponse(conn, "400 Bad Request", "from after to");
+    return;
+  }
+
+  beginChunkedResponse(conn, "text/csv", csvExportGenerator);
+  conn.genSeq = sample_log_find_time(from);
+  conn.genFrom = from;
+  conn.genUntil = to;
+}
+
+// API endpoint: GET /api/time (wall clock state),
+// POST /api/time?epoch=T (set the RTC; T = epoch seconds or ISO 8601 UTC)
+static void handleTime(HttpConnection &conn, HttpSlice query) {
+  bool pending = false;
+  if (conn.method == HTTP_POST) {
+    uint32_t epoch;
+    HttpSlice value = queryParam(query, "epoch");
+    if (!wall_clock_parse(value.data, value.len, &epoch) || !wall_clock_request_set(epoch)) {
+      beginErrorResponse(conn, "400 Bad Request", "epoch: UTC seconds or YYYY-MM-DDTHH:MM:SSZ after 2024");
+      return;
+    }
+    uint32_t before = wall_clock_now();
+    event_log(EVT_API_TIME_SET, before != 0 ? (int32_t)(epoch - before) : 0);
+    pending = true;
+  }
+
+  WallClockStatus status;
+  wall_clock_status(&status);
+  uint32_t now = wall_clock_now();
+  char *out = conn.scratch;
+  size_t len = appendText(out, "{\"epoch\":");
+  len += formatFixed(out + len, now, 0);
+  len += appendText(out + len, ",\"iso\":");
+  if (now != 0) {
+    out[len++] = '"';
+    len += wall_clock_format_iso(out + len, now);
+    out[len++] = '"';
+  } else {
+    len += appendText(out + len, "null");
+  }
+  len += appendText(out + len, ",\"valid\":");
+  len += appendText(out + len, status.valid ? "true" : "false");
+  len += appendText(out + len, ",\"pending\":");
+  len += appendText(out + len, pending ? "true" : "false");
+  len += appendText(out + len, ",\"rate_ppm\":");
+  len += formatNumber(out + len, status.ratePpm, 2);
+  len += appendText(out + len, ",\"last_error_ms\":");
+  len += formatFixed(out + len, status.lastErrorMs, 0);
+  len += appendText(out + len, ",\"syncs\":");
+  len += formatFixed(out + len, status.syncs, 0);
+  len += appendText(out + len, ",\"steps\":");
+  len += formatFixed(out + len, status.steps, 0);
+  len += appendText(out + len, "}\r\n");
+  beginScratchResponse(conn, "200 OK", "application/json", len);
+}
+
+// API endpoint: /api/usb (USB stick logger counters, {"enabled":false} without CC_USB_LOG=1)
+static void handleUsb(HttpConnection &conn) {
+  UsbLoggerStatus status;
+  usb_logger_status(&status);
+  char *out = conn.scratch;
+  size_t len = appendText(out, CC_USB_LOG ? "{\"enabled\":true" : "{\"enabled\":false");
+  len += appendText(out + len, ",\"mounted\":");
+  len += appendText(out + len, status.mounted ? "true" : "false");
+  len += appendText(out + len, ",\"files\":");
+  len += formatFixed(out + len, status.files, 0);
+  len += appendText(out + len, ",\"bytes\":");
+  len += formatFixed(out + len, status.bytesWritten, 0);
+  len += appendText(out + len, ",\"frames\":");
+  len += formatFixed(out + len, status.framesLogged, 0);
+  len += appendText(out + len, ",\"dropped\":");
+  len += formatFixed(out + len, status.framesDropped, 0);
+  len += appendText(out + len, ",\"write_errors\":");
+  len += formatFixed(out + len, status.writeErrors, 0);
+  len += appendText(out + len, ",\"max_write_ms\":");
+  len += formatFixed(out + len, status.maxWriteMs, 0);
+  len += appendText(out + len, "}\r\n");
+  beginScratchResponse(conn, "200 OK", "application/json", len);
+}
+
+// --- Trace replay (/api/trace) ---
+
+static constexpr const char *TRACE_STATE_NAMES[TRACE_STOPPED + 1] = {"idle", "running", "done", "stopped"};
+static constexpr const char *TRACE_BAND_NAMES[TRACE_BAND_COUNT] = {"co2", "rh", "temp"};
+static constexpr const char *ACTION_NAMES[ACTION_COUNT] = {"none", "co2", "rh_down", "rh_up", "baseline", "safety"};
+static_assert(ACTION_COUNT == 6, "ACTION_NAMES out of sync with ActionType");
+
+// Larger part: the counters with duty and switches per actuator, or the
+// bands, actions and pass times
+static constexpr size_t TRACE_COUNTERS_JSON_MAX =
+    116 + longestName(TRACE_STATE_NAMES, TRACE_STOPPED + 1) + 6 * JSON_NUMBER_MAX +
+    2 * ACTUATOR_COUNT * (4 + actuatorKeyMax() + JSON_NUMBER_MAX);
+static constexpr size_t TRACE_REPORT_JSON_MAX =
+    64 + 3 * JSON_NUMBER_MAX +
+    TRACE_BAND_COUNT * (4 + longestName(TRACE_BAND_NAMES, TRACE_BAND_COUNT) + JSON_NUMBER_MAX) +
+    ACTION_COUNT * (4 + longestName(ACTION_NAMES, ACTION_COUNT) + JSON_NUMBER_MAX);
+static constexpr size_t TRACE_JSON_MAX =
+    (TRACE_COUNTERS_JSON_MAX > TRACE_REPORT_JSON_MAX) ? TRACE_COUNTERS_JSON_MAX : TRACE_REPORT_JSON_MAX;
+static_assert(TRACE_JSON_MAX <= CHUNK_PAYLOAD_MAX, "One /api/trace part must fit a chunk");
+
+// Two parts, each from a fresh status copy (a running replay may move one
+// sample between them):
+// {"enabled":true,"state":"running","first":F,"last":L,"frames":N,"unreadable":0,"samples":S,"duration_s":D,
+//  "duty":{"fogger":0.125,...},"switches":{"fogger":3,...},"in_band":{"co2":0.98,...},
+//  "actions":{"co2":2,...},"pass_us":{"runs":R,"mean":M,"max":X}}
+static size_t traceJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  while (conn.genIndex < 2 && cap - len >= TRACE_JSON_MAX) {
+    TraceStatus status;
+    sensor_trace_status(&status);
+    const TraceReport &report = status.report;
+
+    if (conn.genIndex == 0) {
+      len += appendText(out + len, "{\"enabled\":true,\"state\":\"");
+      len += appendText(out + len, TRACE_STATE_NAMES[status.state]);
+      len += appendText(out + len, "\",\"first\":");
+      len += formatFixed(out + len, status.firstSeq, 0);
+      len += appendText(out + len, ",\"last\":");
+      len += formatFixed(out + len, status.lastSeq, 0);
+      len += appendText(out + len, ",\"frames\":");
+      len += formatFixed(out + len, status.frames, 0);
+      len += appendText(out + len, ",\"unreadable\":");
+      len += formatFixed(out + len, status.unreadable, 0);
+      len += appendText(out + len, ",\"samples\":");
+      len += formatFixed(out + len, report.samples(), 0);
+      len += appendText(out + len, ",\"duration_s\":");
+      len += formatFixed(out + len, (int32_t)(report.durationMs() / 1000u), 0);
+      len += appendText(out + len, ",\"duty\":{");
+      for (uint8_t a = 0; a < ACTUATOR_COUNT; a++) {
+        len += appendText(out + len, (a > 0) ? ",\"" : "\"");
+        len += appendText(out + len, CHANNELS[SENSOR_SERIES_COUNT + a].key);
+        len += appendText(out + len, "\":");
+        len += formatShare(out + len, report.duty(a));
+      }
+      len += appendText(out + len, "},\"switches\":{");
+      for (uint8_t a = 0; a < ACTUATOR_COUNT; a++) {
+        len += appendText(out + len, (a > 0) ? ",\"" : "\"");
+        len += appendText(out + len, CHANNELS[SENSOR_SERIES_COUNT + a].key);
+        len += appendText(out + len, "\":");
+        len += formatFixed(out + len, report.switches(a), 0);
+      }
+      out[len++] = '}';
+    } else {
+      len += appendText(out + len, ",\"in_band\":{");
+      for (uint8_t b = 0; b < TRACE_BAND_COUNT; b++) {
+        len += appendText(out + len, (b > 0) ? ",\"" : "\"");
+        len += appendText(out + len, TRACE_BAND_NAMES[b]);
+        len += appendText(out + len, "\":");
+        len += formatShare(out + len, report.timeInBand(b));
+      }
+      len += appendText(out + len, "},\"actions\":{");
+      for (uint8_t a = ACTION_NONE + 1; a < ACTION_COUNT; a++) {
+        len += appendText(out + len, (a > ACTION_NONE + 1) ? ",\"" : "\"");
+        len += appendText(out + len, ACTION_NAMES[a]);
+        len += appendText(out + len, "\":");
+        len += formatFixed(out + len, report.actions(a), 0);
+      }
+      len += appendText(out + len, "},\"pass_us\":{\"runs\":");
+      len += formatFixed(out + len, report.passes(), 0);
+      len += appendText(out + len, ",\"mean\":");
+      len += formatFixed(out + len, report.passMeanUs(), 0);
+      len += appendText(out + len, ",\"max\":");
+      len += formatFixed(out + len, report.passMaxUs(), 0);
+      len += appendText(out + len, "}}\r\n");
+    }
+    conn.genIndex++;
+  }
+  return len;
+}
+
+// First logged sample stamped at or after `epochS`, 0 if none. find_time
+// lands up to a block early, so the walk is bounded by two blocks.
+static uint32_t sampleAtOrAfter(uint32_t epochS) {
+  uint32_t newest = sample_log_newest_seq();
+  uint32_t seq = sample_log_find_time(epochS);
+  for (uint32_t n = 0; seq != 0 && seq <= newest && n < 2u * Config::SAMPLE_LOG_BLOCK_SAMPLES; seq++, n++) {
+    SampleRecord r;
+    uint32_t epoch;
+    if (sample_log_read(seq, &r, &epoch) && epoch >= epochS) return seq;
+  }
+  return 0;
+}
+
+// API endpoint: GET /api/trace (replay state and run report),
+// POST /api/trace?from=T&to=T or ?first=N&last=N (replay logged samples into
+// chamber 0; T = epoch seconds or ISO 8601 UTC, N = sample numbers),
+// POST /api/trace?stop=1. {"enabled":false} without CC_TRACE=1.
+static void handleTrace(HttpConnection &conn, HttpSlice query) {
+  if (!CC_TRACE) {
+    size_t len = appendText(conn.scratch, "{\"enabled\":false}\r\n");
+    beginScratchResponse(conn, "200 OK", "application/json", len);
+    return;
+  }
+  if (conn.method == HTTP_POST) {
+    if (sliceIs(queryParam(query, "stop"), "1")) {
+      sensor_trace_request_stop();
+    } else {
+      uint32_t first, last;
+      HttpSlice firstParam = queryParam(query, "first");
+      if (firstParam.len > 0) {
+        first = (uint32_t)sliceToLong(firstParam);
+        HttpSlice lastParam = queryParam(query, "last");
+        last = (lastParam.len > 0) ? (uint32_t)sliceToLong(lastParam) : sample_log_newest_seq();
+      } else {
+        uint32_t from, to;
+        if (!queryTime(query, "from", 0, &from) || !queryTime(query, "to", UINT32_MAX, &to) || from > to) {
+          beginErrorResponse(conn, "400 Bad Request", "from/to: epoch seconds or YYYY-MM-DDTHH:MM:SSZ");
+          return;
+        }
+        first = sampleAtOrAfter(from);
+        uint32_t after = (to == UINT32_MAX) ? 0 : sampleAtOrAfter(to + 1);
+        last = (after != 0) ? after - 1 : sample_log_newest_seq();
+      }
+      if (!sensor_trace_request(first, last)) {
+        beginErrorResponse(conn, "400 Bad Request", "no logged samples in that range");
+        return;
+      }
+    }
+  }
+  beginChunkedResponse(conn, "application/json", traceJsonGenerator);
+}
+
+// API endpoint: /api/channels (chart layout, keys, units and colors of the history fields)
+static void handleChannels(HttpConnection &conn) {
+  beginChunkedResponse(conn, "application/json", channelsJsonGenerator);
+}
+
+// API endpoint: /api/settings (all persistent settings + change/write counters)
+static void handleSettings(HttpConnection &conn) {
+  beginChunkedResponse(conn, "application/json", settingsJsonGenerator);
+}
+
+// API endpoint: /api/stats (actuator on-time, switch-ons and energy: last
+// hour, last 24 h, since boot; board-wide lifetime totals)
+static void handleStats(HttpConnection &conn) {
+  beginChunkedResponse(conn, "application/json", statsJsonGenerator);
+}
+
+// API endpoint: /api/alarms[?since=N] (active rules and raise counts per
+// chamber, retained alarm edges after N)
+static void handleAlarms(HttpConnection &conn, HttpSlice query) {
+  HttpSlice since = queryParam(query, "since");
+  beginChunkedResponse(conn, "application/json", alarmsJsonGenerator);
+  conn.genSeq = (since.len > 0) ? (uint32_t)sliceToLong(since) : 0;
+  conn.genCount = 0;
+}
+
+// API endpoint: /api/loops (heater/fogger control mode, output and loop
+// quality since the last setpoint step)
+static void handleLoops(HttpConnection &conn) {
+  static const char *const LOOP_NAMES[CONTROL_LOOP_COUNT] = {"heater", "fogger"};
+  ControllerSnapshot state;
+  controller_snapshot(conn.chamber, &state);
+
+  char *out = conn.scratch;
+  size_t len = appendText(out, "{\"loops\":[");
+  for (uint8_t i = 0; i < CONTROL_LOOP_COUNT; i++) {
+    const ControlLoopStatus &loop = state.loops[i];
+    if (i > 0) out[len++] = ',';
+    len += appendText(out + len, "{\"name\":\"");
+    len += appendText(out + len, LOOP_NAMES[i]);
+    len += appendText(out + len, loop.mode == Config::Control::MODE_PI ? "\",\"mode\":\"pi\""
+                                                                       : "\",\"mode\":\"hysteresis\"");
+    len += appendText(out + len, ",\"setpoint\":");
+    len += formatNumber(out + len, loop.setpoint, 1);
+    len += appendText(out + len, ",\"value\":");
+    len += formatNumber(out + len, loop.value, 1);
+    len += appendText(out + len, ",\"output\":");
+    len += formatNumber(out + len, loop.output, 3);
+    len += appendText(out + len, ",\"duty\":");
+    len += formatNumber(out + len, loop.duty, 3);
+    len += appendText(out + len, ",\"overshoot\":");
+    len += formatNumber(out + len, loop.overshoot, 2);
+    len += appendText(out + len, ",\"settled\":");
+    len += appendText(out + len, loop.settled ? "true" : "false");
+    len += appendText(out + len, ",\"settling_s\":");
+    len += formatNumber(out + len, loop.settled ? loop.settlingS : 0.0f, 0);
+    out[len++] = '}';
+  }
+  len += appendText(out + len, "]}\r\n");
+  beginScratchResponse(conn, "200 OK", "application/json", len);
+}
+
+// API endpoint: /api/events?since=N[&n=M] (event log records newer than N)
+//
+// Without "since" the newest M (default 50) retained records are returned.
+static void handleEvents(HttpConnection &conn, HttpSlice query) {
+  uint32_t oldest = event_log_oldest_seq();
+  uint32_t newest = event_log_newest_seq();
+  long n = sliceToLong(queryParam(query, "n"));
+  uint16_t count = (n > 0 && n < Config::EventLog::CAPACITY) ? (uint16_t)n : EVENTS_DEFAULT_COUNT;
+  if (n >= Config::EventLog::CAPACITY) count = Config::EventLog::CAPACITY;
+
+  uint32_t first;
+  HttpSlice since = queryParam(query, "since");
+  if (since.len > 0) {
+    first = (uint32_t)sliceToLong(since) + 1;
+    if (first < oldest) first = oldest;
+  } else {
+    first = (newest >= oldest + count) ? newest - count + 1 : oldest;
+  }
+  if (newest == 0 || first > newest) {
+    count = 0;
+  } else if (newest - first + 1 < count) {
+    count = (uint16_t)(newest - first + 1);
+  }
+
+  beginChunkedResponse(conn, "application/json", eventsJsonGenerator);
+  conn.genSeq = first;
+  conn.genCount = count;
+}
+
+// API endpoint: /api/perf[?reset=1] (per-task cycle statistics)
+static void handlePerf(HttpConnection &conn, HttpSlice query) {
+#if CC_PERF
+  if (sliceIs(queryParam(query, "reset"), "1")) perf_request_reset();
+  beginChunkedResponse(conn, "application/json", perfJsonGenerator);
+#else
+  (void)query;
+  int len = snprintf(conn.scratch, sizeof(conn.scratch), "{\"enabled\":false}\r\n");
+  beginScratchResponse(conn, "200 OK", "application/json", len);
+#endif
+}
+
+// --- CAN fleet (/api/fleet, only with -DCC_CAN=1, see can_link.h) ---
+
+#if CC_CAN
+static constexpr size_t FLEET_JSON_MAX = 200; // One node header or one chamber
+static const char *const ACK_STATUS_NAMES[] = {"ok", "busy", "invalid"};
+
+// {"enabled":true,"role":"gateway","node":1,"tx_frames":..,"tx_retries":..,"tx_dropped":..,
+//  "rx_frames":..,"rx_filtered":..,"rx_invalid":..,"batches":..,"nodes":[{"node":2,"online":true,
+//  "age_ms":A,"interval_ms":I,"ack_tag":T,"ack_status":"ok","chambers":[{"chamber":0,"seq":N,
+//  "sample":[co2,co2_2,rh,rh_2,temp,temp_2,temp_outer,actuators],"setpoints":[co2,rh,temp]},...]},...]}
+// Cursor: genIndex = node, genSeries = 0 before its header, else chamber + 1;
+// genCount = chambers written for the current node. Only a gateway lists nodes.
+static size_t fleetJsonGenerator(HttpConnection &conn, char *out, size_t cap) {
+  size_t len = 0;
+
+  if (!conn.genStarted) {
+    CanLinkStatus status;
+    can_link_status(&status);
+    len += appendText(out, "{\"enabled\":true,\"role\":\"");
+    len += appendText(out + len, can_link_is_gateway() ? "gateway" : "node");
+    len += appendText(out + len, "\",\"node\":");
+    len += formatFixed(out + len, Config::Can::NODE_ID, 0);
+    len += appendText(out + len, ",\"tx_frames\":");
+    len += formatFixed(out + len, status.txFrames, 0);
+    len += appendText(out + len, ",\"tx_retries\":");
+    len += formatFixed(out + len, status.txRetries, 0);
+    len += appendText(out + len, ",\"tx_dropped\":");
+    len += formatFixed(out + len, status.txDropped, 0);
+    len += appendText(out + len, ",\"rx_frames\":");
+    len += formatFixed(out + len, status.rxFrames, 0);
+    len += appendText(out + len, ",\"rx_filtered\":");
+    len += formatFixed(out + len, status.rxFiltered, 0);
+    len += appendText(out + len, ",\"rx_invalid\":");
+    len += formatFixed(out + len, status.rxInvalid, 0);
+    len += appendText(out + len, ",\"batches\":");
+    len += formatFixed(out + len, status.batches, 0);
+    len += appendText(out + len, ",\"nodes\":[");
+    conn.genStarted = true;
+  }
+
+  while (conn.genIndex <= Config::Can::MAX_NODES && cap - len >= FLEET_JSON_MAX) {
+    if (conn.genIndex == Config::Can::MAX_NODES) {
+      len += appendText(out + len, "]}\r\n");
+      conn.genIndex++;
+      break;
+    }
+    uint8_t id = (uint8_t)conn.genIndex;
+    CanNodeInfo node;
+    if (!can_link_node(id, &node)) {
+      conn.genIndex++;
+      continue;
+    }
+
+    if (conn.genSeries == 0) {
+      if (conn.genEmitted++ > 0) out[len++] = ',';
+      len += appendText(out + len, "{\"node\":");
+      len += formatFixed(out + len, id, 0);
+      len += appendText(out + len, ",\"online\":");
+      len += appendText(out + len, node.online ? "true" : "false");
+      len += appendText(out + len, ",\"age_ms\":");
+      len += formatFixed(out + len, (int32_t)node.ageMs, 0);
+      len += appendText(out + len, ",\"interval_ms\":");
+      len += formatFixed(out + len, node.sampleIntervalMs, 0);
+      len += appendText(out + len, ",\"ack_tag\":");
+      len += formatFixed(out + len, node.ackTag, 0);
+      len += appendText(out + len, ",\"ack_status\":");
+      if (node.ackTag == 0 || node.ackStatus > CAN_ACK_INVALID) {
+        len += appendText(out + len, "null");
+      } else {
+        out[len++] = '"';
+        len += appendText(out + len, ACK_STATUS_NAMES[node.ackStatus]);
+        out[len++] = '"';
+      }
+      len += appendText(out + len, ",\"chambers\":[");
+      conn.genSeries = 1;
+      conn.genCount = 0;
+      continue;
+    }
+
+    uint8_t chamber = conn.genSeries - 1;
+    CanChamberInfo info;
+    if (chamber >= node.chambers || chamber >= Config::Chambers::MAX_COUNT) {
+      len += appendText(out + len, "]}");
+      conn.genSeries = 0;
+      conn.genIndex++;
+      continue;
+    }
+    conn.genSeries++;
+    if (!can_link_chamber(id, chamber, &info) || !(info.hasSample || info.hasSetpoints)) continue;
+
+    if (conn.genCount++ > 0) out[len++] = ',';
+    len += appendText(out + len, "{\"chamber\":");
+    len += formatFixed(out + len, chamber, 0);
+    len += appendText(out + len, ",\"seq\":");
+    len += formatFixed(out + len, info.hasSample ? info.seq : 0, 0);
+    len += appendText(out + len, ",\"sample\":");
+    if (info.hasSample) {
+      const SampleRecord &r = info.record;
+      const int32_t fields[] = {r.co2, r.co2_2, r.rh_x10, r.rh_2_x10, r.temp_x10,
+                                r.temp_2_x10, r.temp_outer_x10, r.actuators};
+      out[len++] = '[';
+      for (uint8_t i = 0; i < 8; i++) {
+        if (i > 0) out[len++] = ',';
+        bool deci = (i >= 2 && i < 7);
+        len += formatFixed(out + len, fields[i], deci ? 1 : 0);
+      }
+      out[len++] = ']';
+    } else {
+      len += appendText(out + len, "null");
+    }
+    len += appendText(out + len, ",\"setpoints\":");
+    if (info.hasSetpoints) {
+      out[len++] = '[';
+      len += formatFixed(out + len, info.co2Setpoint, 0);
+      out[len++] = ',';
+      len += formatFixed(out + len, info.rhSetpoint_x10, 1);
+      out[len++] = ',';
+      len += formatFixed(out + len, info.tempSetpoint_x10, 1);
+      out[len++] = ']';
+    } else {
+      len += appendText(out + len, "null");
+    }
+    out[len++] = '}';
+  }
+  return len;
+}
+
+// Body of POST /api/fleet/setpoints: validated like /api/setpoints, then
+// forwarded to conn.fleetNode. 202: the node's answer shows up in /api/fleet.
+static void fleetSettingsBodySink(HttpConnection &conn, const uint8_t *data, size_t len) {
+  if (len > 0) {
+    memcpy(conn.head + conn.genBytes, data, len);
+    conn.genBytes += len;
+    return;
+  }
+  conn.head[conn.genBytes] = '\0';
+
+  ControlCommand batch[SETTING_COUNT];
+  JsonMember members[SETTING_COUNT];
+  uint8_t count;
+  if (!parseSettingsBody(conn, conn.head, batch, members, &count)) return;
+  uint8_t tag;
+  if (!can_link_send_settings(conn.fleetNode, conn.chamber, batch, count, &tag)) {
+    beginErrorResponse(conn, "503 Service Unavailable", "busy, retry");
+    return;
+  }
+  int out = snprintf(conn.scratch, sizeof(conn.scratch),
+                     "{\"node\":%u,\"chamber\":%u,\"tag\":%u,\"settings\":%u}\r\n",
+                     conn.fleetNode, conn.chamber, tag, count);
+  beginScratchResponse(conn, "202 Accepted", "application/json", out);
+}
+#endif
+
+// API endpoint: /api/fleet (CAN bus counters; the gateway adds every node's
+// latest sample and setpoints)
+static void handleFleet(HttpConnection &conn) {
+#if CC_CAN
+  beginChunkedResponse(conn, "application/json", fleetJsonGenerator);
+#else
+  int len = snprintf(conn.scratch, sizeof(conn.scratch), "{\"enabled\":false}\r\n");
+  beginScratchResponse(conn, "200 OK", "application/json", len);
+#endif
+}
+
+// API endpoint: POST /api/fleet/setpoints?node=N&chamber=C with the
+// /api/setpoints body, applied by that node's chamber (gateway only)
+static void handleFleetSetpoints(HttpConnection &conn, HttpSlice query) {
+#if CC_CAN
+  if (!can_link_is_gateway()) {
+    beginErrorResponse(conn, "409 Conflict", "not the CAN gateway");
+    return;
+  }
+  HttpSlice nodeParam = queryParam(query, "node");
+  HttpSlice chamberParam = queryParam(query, "chamber");
+  if (nodeParam.len == 0 || chamberParam.len == 0) {
+    beginErrorResponse(conn, "400 Bad Request", "node and chamber required");
+    return;
+  }
+  long node = sliceToLong(nodeParam);
+  long chamber = sliceToLong(chamberParam);
+  CanNodeInfo info;
+  if (node < 0 || node >= Config::Can::MAX_NODES || !can_link_node((uint8_t)node, &info) || !info.online) {
+    beginErrorResponse(conn, "404 Not Found", "unknown or offline node");
+    return;
+  }
+  if (chamber < 0 || chamber >= info.chambers) {
+    beginErrorResponse(conn, "404 Not Found", "unknown chamber");
+    return;
+  }
+  conn.fleetNode = (uint8_t)node;
+  conn.chamber = (uint8_t)chamber;
+  acceptSettingsBody(conn, fleetSettingsBodySink);
+#else
+  (void)query;
+  beginErrorResponse(conn, "404 Not Found", "CAN fleet link disabled");
+#endif
+}
+
+// --- Push stream (/api/stream, Server-Sent Events) ---
+//
+// Subscribers leave the connection pool once the request is parsed and only
+// keep their socket and a write cursor. Each new sample is encoded once into
+// a shared frame, in the /api/since document format with one sample per
+// series, and every subscriber writes the same bytes. Two frame buffers
+// alternate; a subscriber still writing the older one when a third sample
+// arrives is dropped (EventSource reconnects). Alarm edges since the
+// previous frame ride along as named "alarm" events in the same buffer.
+
+static constexpr uint8_t MAX_STREAMS = Config::WebUI::HTTP_MAX_STREAMS;
+static constexpr size_t STREAM_FRAME_SIZE = 1024;
+static_assert(Config::WebUI::HTTP_STREAM_HEARTBEAT_MS < IDLE_TIMEOUT_MS,
+              "Stream heartbeats must keep subscribers inside the idle timeout");
+
+static const char STREAM_HEAD[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-store\r\n"
+    "Connection: close\r\n"
+    "\r\n"
+    "retry: 3000\n\n";
+static const char STREAM_HEARTBEAT[] = ":\n\n";
+
+struct StreamFrame {
+  char data[STREAM_FRAME_SIZE];
+  uint16_t len;
+  uint32_t seq;        // Sample in this frame (0 = empty)
+};
+
+struct StreamSubscriber {
+  WiFiClient client;
+  bool active;
+  const char *pending; // Frame, head or heartbeat being written
+  uint16_t pendingLen;
+  uint16_t pendingSent;
+  uint8_t frame;       // g_streamFrames index of `pending` (frames only)
+  bool pendingIsFrame;
+  uint32_t seq;        // Newest sample handed to this subscriber
+  unsigned long lastWriteMs;
+
+  StreamSubscriber() : active(false), pending(nullptr), pendingLen(0), pendingSent(0), frame(0),
+                       pendingIsFrame(false), seq(0), lastWriteMs(0) {}
+};
+
+static StreamSubscriber g_streams[MAX_STREAMS];
+static StreamFrame g_streamFrames[2];
+static uint8_t g_streamCurrent = 0; // Newest frame
+static uint8_t g_streamCount = 0;
+static uint32_t g_streamAlarmSeq = 0;  // Newest alarm edge put into a frame
+
+// "id: <seq>\ndata: {...}\n\n" for one sample
+static size_t encodeStreamFrame(char *out, uint32_t seq) {
+  size_t len = appendText(out, "id: ");
+  len += formatFixed(out + len, seq, 0);
+  len += appendText(out + len, "\ndata: {\"seq\":");
+  len += formatFixed(out + len, seq, 0);
+  len += appendText(out + len, ",\"len\":");
+  len += formatFixed(out + len, controller_history_length(), 0);
+  len += appendText(out + len, ",\"reset\":false");
+  for (uint8_t i = 0; i < SERIES_COUNT; i++) {
+    len += appendText(out + len, ",\"");
+    len += appendText(out + len, CHANNELS[i].key);
+    len += appendText(out + len, "\":[");
+    len += appendSampleValue(out + len, 0, CHANNELS[i], seq);
+    if (i + 1 < SERIES_COUNT) out[len++] = ']';
+  }
+  len += appendTrailer(out + len, 0); // Closes the last array
+  len += appendText(out + len, "\n\n");
+  return len;
+}
+
+static void closeStream(StreamSubscriber &sub) {
+  sub.client.stop();
+  sub.active = false;
+  sub.pending = nullptr;
+  g_streamCount--;
+  event_log(EVT_WEB_DISCONNECT);
+}
+
+// "event: alarm\ndata: {...}\n\n" for the edges after g_streamAlarmSeq, as many as fit
+static size_t encodeStreamAlarms(char *out, size_t room) {
+  static const char PREFIX[] = "event: alarm\ndata: ";
+  size_t len = 0;
+  uint32_t newest = alarms_newest_seq();
+  uint32_t oldest = alarms_oldest_seq();
+  if (g_streamAlarmSeq + 1 < oldest) g_streamAlarmSeq = oldest - 1; // Overwritten meanwhile
+  while (g_streamAlarmSeq < newest && room - len >= sizeof(PREFIX) + ALARM_EDGE_JSON_MAX + 2) {
+    AlarmEdge edge;
+    g_streamAlarmSeq++;
+    if (!alarms_edge(g_streamAlarmSeq, &edge)) continue;
+    len += appendText(out + len, PREFIX);
+    len += alarms_edge_json(out + len, edge);
+    len += appendText(out + len, "\n\n");
+  }
+  return len;
+}
+
+// Encode the newest sample once, if it is new and anybody listens
+static void publishStreamFrame() {
+  if (g_streamCount == 0) {
+    g_streamAlarmSeq = alarms_newest_seq(); // A new subscriber starts with the next edge
+    return;
+  }
+  uint32_t seq = controller_get_sample_seq(0);
+  if (seq == 0 || seq == g_streamFrames[g_streamCurrent].seq) return;
+
+  uint8_t next = g_streamCurrent ^ 1;
+  for (uint8_t i = 0; i < MAX_STREAMS; i++) {
+    StreamSubscriber &sub = g_streams[i];
+    if (sub.active && sub.pendingIsFrame && sub.frame == next && sub.pendingSent < sub.pendingLen) {
+      event_log(EVT_WEB_STREAM_DROPPED);
+      closeStream(sub);
+    }
+  }
+  StreamFrame &frame = g_streamFrames[next];
+  size_t len = encodeStreamFrame(frame.data, seq);
+  len += encodeStreamAlarms(frame.data + len, sizeof(frame.data) - len);
+  frame.len = (uint16_t)len;
+  frame.seq = seq;
+  g_streamCurrent = next;
+}
+
+static void writeStream(StreamSubscriber &sub, unsigned long now) {
+  if (!sub.client.connected()) {
+    closeStream(sub);
+    return;
+  }
+  size_t budget = WRITE_BUDGET_BYTES;
+  while (budget > 0) {
+    if (sub.pending == nullptr || sub.pendingSent >= sub.pendingLen) {
+      const StreamFrame &frame = g_streamFrames[g_streamCurrent];
+      if (frame.seq != 0 && frame.seq != sub.seq) {
+        sub.pending = frame.data;
+        sub.pendingLen = frame.len;
+        sub.frame = g_streamCurrent;
+        sub.pendingIsFrame = true;
+        sub.seq = frame.seq;
+      } else if (now - sub.lastWriteMs >= Config::WebUI::HTTP_STREAM_HEARTBEAT_MS) {
+        sub.pending = STREAM_HEARTBEAT;
+        sub.pendingLen = sizeof(STREAM_HEARTBEAT) - 1;
+        sub.pendingIsFrame = false;
+      } else {
+        return;
+      }
+      sub.pendingSent = 0;
+    }
+    size_t n = sub.pendingLen - sub.pendingSent;
+    if (n > budget) n = budget;
+    size_t written = sub.client.write((const uint8_t *)sub.pending + sub.pendingSent, n);
+    sub.pendingSent += written;
+    budget -= written;
+    if (written > 0) sub.lastWriteMs = now;
+    if (written < n) break; // Socket buffer full, resume next tick
+  }
+  if (now - sub.lastWriteMs > IDLE_TIMEOUT_MS) {
+    event_log(EVT_WEB_IDLE_TIMEOUT);
+    closeStream(sub);
+  }
+}
+
+// API endpoint: /api/stream
+//
+// Moves the client into a subscriber slot; the first frame is the next
+// sample. Clients fetch /api/since on open and after a gap in "seq".
+static void handleStream(HttpConnection &conn) {
+  for (uint8_t i = 0; i < MAX_STREAMS; i++) {
+    StreamSubscriber &sub = g_streams[i];
+    if (sub.active) continue;
+    sub.client = conn.client;
+    sub.active = true;
+    sub.pending = STREAM_HEAD;
+    sub.pendingLen = sizeof(STREAM_HEAD) - 1;
+    sub.pendingSent = 0;
+    sub.pendingIsFrame = false;
+    sub.seq = g_streamFrames[g_streamCurrent].seq;
+    sub.lastWriteMs = millis();
+    g_streamCount++;
+    event_log(EVT_WEB_STREAM_OPEN, g_streamCount);
+    // The socket belongs to the subscriber now; free the pool slot
+    conn.client = WiFiClient();
+    conn.state = CONN_FREE;
+    return;
+  }
+  int len = snprintf(conn.scratch, sizeof(conn.scratch), "{\"error\":\"too many streams\"}\r\n");
+  beginScratchResponse(conn, "503 Service Unavailable", "application/json", len);
+}
+
+// Endpoints that exist once per chamber: /api/<name> serves chamber 0,
+// /api/c/{id}/<name> chamber id (conn.chamber). false if `name` is none of them.
+static bool dispatchChamberRequest(HttpConnection &conn, HttpSlice name, HttpSlice query) {
+  if (sliceIs(name, "last200")) {
+    handleLast200(conn, query);
+  } else if (sliceIs(name, "since")) {
+    handleSince(conn, query);
+  } else if (sliceIs(name, "history")) {
+    handleHistory(conn, query);
+  } else if (sliceIs(name, "settings")) {
+    handleSettings(conn);
+  } else if (sliceIs(name, "loops")) {
+    handleLoops(conn);
+  } else if (sliceIs(name, "stats")) {
+    handleStats(conn);
+  } else if (sliceIs(name, "setpoints")) {
+    handleSetpointsPost(conn);
+  } else if (sliceIs(name, "setpoint")) {
+    handleSetpoint(conn, query);
+  } else if (sliceIs(name, "setpoint_rh")) {
+    handleSetpointRH(conn, query);
+  } else if (sliceIs(name, "setpoint_temp")) {
+    handleSetpointTemp(conn, query);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// /api/c/{id}/<name>: decimal chamber id below Config::Chambers::COUNT
+static void dispatchChamberPath(HttpConnection &conn, HttpSlice rest, HttpSlice query) {
+  uint16_t digits = 0;
+  uint16_t id = 0;
+  while (digits < rest.len && digits < 3 && rest.data[digits] >= '0' && rest.data[digits] <= '9') {
+    id = id * 10 + (rest.data[digits] - '0');
+    digits++;
+  }
+  if (digits == 0 || digits >= rest.len || rest.data[digits] != '/' || id >= Config::Chambers::COUNT) {
+    beginErrorResponse(conn, "404 Not Found", "unknown chamber");
+    return;
+  }
+  conn.chamber = (uint8_t)id;
+  if (!dispatchChamberRequest(conn, sliceFrom(rest, digits + 1), query)) {
+    beginErrorResponse(conn, "404 Not Found", "no such chamber endpoint");
+  }
+}
+
+static void dispatchRequest(HttpConnection &conn, const WebServerConfig *config) {
+  event_log_text(EVT_WEB_REQUEST, conn.target);
+
+  HttpSlice pathOnly = conn.path;
+  HttpSlice query = conn.query;
+  static const char ASSETS_PREFIX[] = "/api/assets/";
+  static const char CHAMBER_PREFIX[] = "/api/c/";
+  static const char API_PREFIX[] = "/api/";
+
+  if (conn.method == HTTP_PUT) {
+    if (sliceStartsWith(pathOnly, ASSETS_PREFIX)) {
+      handleAssetUpload(conn, sliceFrom(pathOnly, sizeof(ASSETS_PREFIX) - 1));
+    } else {
+      int len = snprintf(conn.scratch, sizeof(conn.scratch), "Method Not Allowed\r\n");
+      beginScratchResponse(conn, "405 Method Not Allowed", "text/plain", len);
+    }
+  } else if (sliceIs(pathOnly, "/inc")) {
+    handleIncrement(conn, config);
+  } else if (sliceStartsWith(pathOnly, CHAMBER_PREFIX)) {
+    dispatchChamberPath(conn, sliceFrom(pathOnly, sizeof(CHAMBER_PREFIX) - 1), query);
+  } else if (sliceStartsWith(pathOnly, API_PREFIX) &&
+             dispatchChamberRequest(conn, sliceFrom(pathOnly, sizeof(API_PREFIX) - 1), query)) {
+    // Chamber 0
+  } else if (sliceIs(pathOnly, "/api/stream")) {
+    handleStream(conn);
+  } else if (sliceIs(pathOnly, "/api/channels")) {
+    handleChannels(conn);
+  } else if (sliceIs(pathOnly, "/api/log")) {
+    handleLog(conn, query);
+  } else if (sliceIs(pathOnly, "/api/export.csv")) {
+    handleExport(conn, query);
+  } else if (sliceIs(pathOnly, "/api/time")) {
+    handleTime(conn, query);
+  } else if (sliceIs(pathOnly, "/api/usb")) {
+    handleUsb(conn);
+  } else if (sliceIs(pathOnly, "/api/trace")) {
+    handleTrace(conn, query);
+  } else if (sliceIs(pathOnly, "/api/alarms")) {
+    handleAlarms(conn, query);
+  } else if (sliceIs(pathOnly, "/api/events")) {
+    handleEvents(conn, query);
+  } else if (sliceIs(pathOnly, "/api/perf")) {
+    handlePerf(conn, query);
+  } else if (sliceIs(pathOnly, "/api/fleet")) {
+    handleFleet(conn);
+  } else if (sliceIs(pathOnly, "/api/fleet/setpoints")) {
+    handleFleetSetpoints(conn, query);
+  } else if (sliceIs(pathOnly, "/chart.js")) {
+    serveStoredAsset(conn, ASSET_CHART_JS, CHART_JS_CDN_URL);
+  } else if (sliceIs(pathOnly, "/old")) {
+    // Old counter interface
+    serveIndex(conn, config);
+  } else {
+    // Default: Climate chamber UI
+    serveClimateUI(conn);
+  }
+}
+
+// --- Connection state machine ---
+
+static void closeConnection(HttpConnection &conn) {
+  conn.client.stop();
+  if (conn.state == CONN_BODY && conn.sink == assetUploadSink && conn.genBytes > 0) {
+    asset_store_abort(); // Upload cut off
+  }
+  conn.body = nullptr;
+  conn.generator = nullptr;
+  conn.sink = nullptr;
+  conn.state = CONN_FREE;
+  event_log(EVT_WEB_DISCONNECT);
+}
+
+// Wait for the next request on a new or kept-alive connection
+static void beginRequest(HttpConnection &conn, unsigned long now) {
+  conn.state = CONN_REQUEST_LINE;
+  conn.lastActivityMs = now;
+  // A pipelined request already read moves to the front
+  uint16_t pending = conn.fill - conn.scanPos;
+  memmove(conn.request, conn.request + conn.scanPos, pending);
+  conn.fill = pending;
+  conn.scanPos = 0;
+  conn.lineStart = 0;
+  conn.headerBytes = 0;
+  conn.lineOverflow = false;
+  conn.target = "";
+  conn.path = HttpSlice{"", 0};
+  conn.query = HttpSlice{"", 0};
+  conn.ifNoneMatch[0] = '\0';
+  conn.method = HTTP_GET;
+  conn.chamber = 0;
+  conn.contentLength = -1;
+  conn.keepAlive = false;
+  conn.sink = nullptr;
+  conn.bodyRemaining = 0;
+  conn.body = nullptr;
+  conn.bodyLen = 0;
+  conn.bodySent = 0;
+  conn.generator = nullptr;
+}
+
+// Kept-alive connection between requests with nothing received yet
+static bool idleBetweenRequests(HttpConnection &conn) {
+  return conn.state == CONN_REQUEST_LINE && conn.requests > 0 && conn.fill == 0 &&
+         conn.client.available() <= 0;
+}
+
+static void acceptConnection(const WebServerConfig *config) {
+  for (uint8_t i = 0; i < MAX_CONNECTIONS; i++) {
+    HttpConnection &conn = g_connections[i];
+    if (conn.state != CONN_FREE) {
+      continue;
+    }
+    // Only accept while a slot is free; pending clients wait in the backlog
+    WiFiClient client = config->server->accept();
+    if (!client) {
+      return;
+    }
+    conn.client = client;
+    conn.requests = 0;
+    conn.fill = 0;
+    conn.scanPos = 0;
+    beginRequest(conn, millis());
+    event_log(EVT_WEB_CONNECT);
+    return;
+  }
+
+  // Pool full: a waiting client takes over the slot of an idle keep-alive
+  // connection (the browser simply opens a new one next time)
+  for (uint8_t i = 0; i < MAX_CONNECTIONS; i++) {
+    HttpConnection &conn = g_connections[i];
+    if (!idleBetweenRequests(conn)) {
+      continue;
+    }
+    WiFiClient client = config->server->accept();
+    if (!client) {
+      return;
+    }
+    closeConnection(conn);
+    conn.client = client;
+    conn.requests = 0;
+    conn.fill = 0;
+    conn.scanPos = 0;
+    beginRequest(conn, millis());
+    event_log(EVT_WEB_CONNECT);
+    return;
+  }
+}
+
+// Request line: "METHOD SP TARGET SP VERSION" (NUL-terminated, in the
+// request buffer). Returns false if malformed.
+static bool parseRequestLine(HttpConnection &conn, char *line) {
+  char *sp1 = strchr(line, ' ');
+  if (sp1 == nullptr || sp1 == line) {
+    return false;
+  }
+  char *target = sp1 + 1;
+  char *sp2 = strchr(target, ' ');
+  if (sp2 == nullptr || sp2 == target) {
+    return false;
+  }
+  *sp2 = '\0';
+  uint16_t len = sp2 - target;
+  const char *mark = (const char *)memchr(target, '?', len);
+  uint16_t pathLen = (mark != nullptr) ? mark - target : len;
+  conn.target = target;
+  conn.path = HttpSlice{target, pathLen};
+  conn.query = (mark != nullptr) ? HttpSlice{mark + 1, (uint16_t)(len - pathLen - 1)} : HttpSlice{sp2, 0};
+
+  // HTTP/1.1 is persistent unless "Connection: close"; 1.0 only on request
+  conn.keepAlive = (strcmp(sp2 + 1, "HTTP/1.1") == 0);
+  conn.requests++;
+
+  size_t methodLen = sp1 - line;
+  if (methodLen == 3 && strncmp(line, "GET", 3) == 0) {
+    conn.method = HTTP_GET;
+  } else if (methodLen == 3 && strncmp(line, "PUT", 3) == 0) {
+    conn.method = HTTP_PUT;
+  } else if (methodLen == 4 && strncmp(line, "POST", 4) == 0) {
+    conn.method = HTTP_POST;
+  } else {
+    conn.method = HTTP_OTHER;
+  }
+  return true;
+}
+
+// "Name: value" header line (NUL-terminated)
+static void parseHeader(HttpConnection &conn, const char *line) {
+  static const char CONNECTION[] = "Connection:";
+  static const char CONTENT_LENGTH[] = "Content-Length:";
+  static const char IF_NONE_MATCH[] = "If-None-Match:";
+  if (strncasecmp(line, CONNECTION, sizeof(CONNECTION) - 1) == 0) {
+    const char *value = line + sizeof(CONNECTION) - 1;
+    while (*value == ' ') value++;
+    if (strncasecmp(value, "close", 5) == 0) conn.keepAlive = false;
+    if (strncasecmp(value, "keep-alive", 10) == 0) conn.keepAlive = true;
+    return;
+  }
+  if (strncasecmp(line, CONTENT_LENGTH, sizeof(CONTENT_LENGTH) - 1) == 0) {
+    char *end = nullptr;
+    long value = strtol(line + sizeof(CONTENT_LENGTH) - 1, &end, 10);
+    conn.contentLength = (end != nullptr && value >= 0 && value <= INT32_MAX) ? (int32_t)value : -1;
+    return;
+  }
+  if (strncasecmp(line, IF_NONE_MATCH, sizeof(IF_NONE_MATCH) - 1) != 0) {
+    return;
+  }
+  const char *value = line + sizeof(IF_NONE_MATCH) - 1;
+  while (*value == ' ') value++;
+  strncpy(conn.ifNoneMatch, value, sizeof(conn.ifNoneMatch) - 1);
+  conn.ifNoneMatch[sizeof(conn.ifNoneMatch) - 1] = '\0';
+}
+
+// Refuse the request; the rest of it is never parsed, so the connection closes
+static void rejectRequest(HttpConnection &conn, const char *status, const char *text) {
+  conn.keepAlive = false;
+  int n = snprintf(conn.scratch, sizeof(conn.scratch), "%s\r\n", text);
+  beginScratchResponse(conn, status, "text/plain", n);
+}
+
+// Handle one complete line (NUL-terminated, without CR LF) of `consumed`
+// bytes. Returns false once the request is complete.
+static bool handleLine(HttpConnection &conn, const WebServerConfig *config, char *line, uint16_t len,
+                       uint16_t consumed) {
+  if (conn.state == CONN_REQUEST_LINE) {
+    if (len == 0) {
+      return true; // Ignore leading empty lines
+    }
+    if (!parseRequestLine(conn, line)) {
+      rejectRequest(conn, "400 Bad Request", "Bad Request");
+      return false;
+    }
+    conn.lineStart = conn.scanPos; // Keep the request line for the slices
+    conn.state = CONN_HEADERS;
+    return true;
+  }
+
+  conn.headerBytes += consumed;
+  if (conn.headerBytes > MAX_HEADER_BYTES) {
+    rejectRequest(conn, "431 Request Header Fields Too Large", "Request Header Fields Too Large");
+    return false;
+  }
+  if (conn.lineOverflow) {
+    conn.lineOverflow = false; // End of a header too long to parse, ignored
+    return true;
+  }
+
+  // A blank line ends the request; only Connection, Content-Length (uploads)
+  // and If-None-Match (static assets) are kept
+  if (len == 0) {
+    conn.bodyRemaining = (conn.contentLength > 0) ? (uint32_t)conn.contentLength : 0;
+    dispatchRequest(conn, config);
+    return false;
+  }
+  parseHeader(conn, line);
+  return true;
+}
+
+// Parse the complete lines buffered. Returns false once the request is
+// complete or refused.
+static bool parseBuffered(HttpConnection &conn, const WebServerConfig *config) {
+  while (true) {
+    char *line = conn.request + conn.scanPos;
+    uint16_t pending = conn.fill - conn.scanPos;
+    char *newline = (char *)memchr(line, '\n', pending);
+
+    if (newline == nullptr) {
+      if (conn.state == CONN_REQUEST_LINE && pending > REQUEST_LINE_MAX) {
+        rejectRequest(conn, "414 URI Too Long", "URI Too Long"); // No need to wait for the end
+        return false;
+      }
+      if (conn.fill == sizeof(conn.request)) {
+        if (conn.scanPos > conn.lineStart) {
+          // Make room: move the partial line next to the request line
+          memmove(conn.request + conn.lineStart, line, pending);
+          conn.scanPos = conn.lineStart;
+          conn.fill = conn.lineStart + pending;
+        } else {
+          // A header line fills the whole region: drop it up to its end
+          conn.headerBytes += pending;
+          conn.fill = conn.lineStart;
+          conn.lineOverflow = true;
+          if (conn.headerBytes > MAX_HEADER_BYTES) {
+            rejectRequest(conn, "431 Request Header Fields Too Large", "Request Header Fields Too Large");
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    uint16_t consumed = newline - line + 1;
+    uint16_t len = consumed - 1;
+    if (len > 0 && line[len - 1] == '\r') len--;
+    if (conn.state == CONN_REQUEST_LINE && len > REQUEST_LINE_MAX) {
+      rejectRequest(conn, "414 URI Too Long", "URI Too Long");
+      return false;
+    }
+    line[len] = '\0';
+    conn.scanPos += consumed;
+    if (!handleLine(conn, config, line, len, consumed)) {
+      return false;
+    }
+  }
+}
+
+// Read up to READ_BUDGET_BYTES of request data in bulk and parse it
+static void readRequest(HttpConnection &conn, const WebServerConfig *config, unsigned long now) {
+  uint16_t budget = READ_BUDGET_BYTES;
+  while (parseBuffered(conn, config)) {
+    if (budget == 0) {
+      return;
+    }
+    int available = conn.client.available();
+    if (available <= 0) {
+      if (!conn.client.connected()) {
+        conn.state = CONN_CLOSE;
+      }
+      return;
+    }
+    size_t n = sizeof(conn.request) - conn.fill;
+    if (n > (size_t)available) n = available;
+    if (n > budget) n = budget;
+    int got = conn.client.read((uint8_t *)conn.request + conn.fill, n);
+    if (got <= 0) {
+      return;
+    }
+    conn.fill += got;
+    budget -= got;
+    conn.lastActivityMs = now;
+  }
+}
+
+// Pass up to READ_BUDGET_BYTES of the request body to the sink
+static void readBody(HttpConnection &conn, unsigned long now) {
+  if (conn.bodyRemaining > 0 && conn.scanPos < conn.fill) {
+    // Body bytes read together with the headers
+    uint16_t n = conn.fill - conn.scanPos;
+    if (n > conn.bodyRemaining) n = conn.bodyRemaining;
+    const uint8_t *data = (const uint8_t *)conn.request + conn.scanPos;
+    conn.scanPos += n;
+    conn.bodyRemaining -= n;
+    conn.sink(conn, data, n);
+    if (conn.state != CONN_BODY) return;
+  }
+  if (conn.bodyRemaining > 0) {
+    int available = conn.client.available();
+    if (available <= 0) {
+      if (!conn.client.connected()) conn.state = CONN_CLOSE;
+      return;
+    }
+    size_t n = (size_t)available;
+    if (n > READ_BUDGET_BYTES) n = READ_BUDGET_BYTES;
+    if (n > sizeof(conn.scratch)) n = sizeof(conn.scratch);
+    if (n > conn.bodyRemaining) n = conn.bodyRemaining;
+    int got = conn.client.read((uint8_t *)conn.scratch, n);
+    if (got <= 0) return;
+    conn.lastActivityMs = now;
+    conn.bodyRemaining -= got;
+    conn.sink(conn, (const uint8_t *)conn.scratch, (size_t)got);
+    if (conn.state != CONN_BODY) return; // Rejected: the sink responded
+  }
+  if (conn.bodyRemaining == 0) conn.sink(conn, nullptr, 0);
+}
+
+// Next generator output as a raw block (Content-Length responses)
+static void refillRaw(HttpConnection &conn) {
+  unsigned long start = micros();
+  size_t len = conn.generator(conn, conn.scratch, sizeof(conn.scratch));
+  conn.genMicros += micros() - start;
+  conn.genBytes += len;
+
+  conn.body = conn.scratch;
+  conn.bodyLen = len;
+  conn.bodySent = 0;
+  if (len == 0) {
+    conn.generator = nullptr;
+    event_log(EVT_WEB_STREAMED, conn.genBytes, conn.genMicros);
+  }
+}
+
+// Frame the next generator output as one chunk in the scratch buffer
+static void refillChunk(HttpConnection &conn) {
+  if (conn.genRaw) {
+    refillRaw(conn);
+    return;
+  }
+
+  char *payload = conn.scratch + CHUNK_HEADER_SIZE;
+  size_t cap = sizeof(conn.scratch) - CHUNK_HEADER_SIZE - CHUNK_TRAILER_SIZE;
+
+  unsigned long start = micros();
+  size_t len = conn.generator(conn, payload, cap);
+  conn.genMicros += micros() - start;
+  conn.genBytes += len;
+
+  if (len == 0) {
+    // Last chunk
+    memcpy(conn.scratch, "0\r\n\r\n", 5);
+    conn.body = conn.scratch;
+    conn.bodyLen = 5;
+    conn.bodySent = 0;
+    conn.generator = nullptr;
+
+    event_log(EVT_WEB_STREAMED, conn.genBytes, conn.genMicros);
+    return;
+  }
+
+  // Chunk size in hex, right-aligned against the payload
+  char hex[CHUNK_HEADER_SIZE];
+  int hexLen = snprintf(hex, sizeof(hex), "%X\r\n", (unsigned)len);
+  char *chunk = payload - hexLen;
+  memcpy(chunk, hex, hexLen);
+  payload[len] = '\r';
+  payload[len + 1] = '\n';
+
+  conn.body = chunk;
+  conn.bodyLen = hexLen + len + CHUNK_TRAILER_SIZE;
+  conn.bodySent = 0;
+}
+
+// Write up to conn.writeBudget bytes of the pending response
+static void writeResponse(HttpConnection &conn, unsigned long now) {
+  if (!conn.client.connected()) {
+    conn.state = CONN_CLOSE;
+    return;
+  }
+
+  size_t budget = conn.writeBudget;
+
+  if (conn.headSent < conn.headLen) {
+    size_t n = conn.headLen - conn.headSent;
+    if (n > budget) n = budget;
+    size_t written = conn.client.write((const uint8_t *)conn.head + conn.headSent, n);
+    conn.headSent += written;
+    budget -= written;
+    if (written > 0) conn.lastActivityMs = now;
+    if (written < n) return; // Socket buffer full, resume next tick
+  }
+
+  while (budget > 0) {
+    if (conn.bodySent >= conn.bodyLen) {
+      if (conn.generator == nullptr) break;
+      refillChunk(conn);
+      if (conn.bodyLen == 0) break;
+    }
+    size_t n = conn.bodyLen - conn.bodySent;
+    if (n > budget) n = budget;
+    size_t written = conn.client.write((const uint8_t *)conn.body + conn.bodySent, n);
+    conn.bodySent += written;
+    budget -= written;
+    if (written > 0) conn.lastActivityMs = now;
+    if (written < n) return;
+  }
+
+  if (conn.headSent >= conn.headLen && conn.bodySent >= conn.bodyLen &&
+      conn.generator == nullptr) {
+    conn.client.flush();
+    if (conn.keepAlive) {
+      beginRequest(conn, now); // Pipelined requests are already waiting in the socket
+    } else {
+      conn.state = CONN_CLOSE;
+    }
+  }
+}
+
+void web_server_handle(const WebServerConfig *config) {
+  if (config == nullptr || config->server == nullptr) {
+    return;
+  }
+
+  acceptConnection(config);
+  syncSampleCache();
+
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < MAX_CONNECTIONS; i++) {
+    HttpConnection &conn = g_connections[i];
+
+    switch (conn.state) {
+      case CONN_FREE:
+        continue;
+
+      case CONN_REQUEST_LINE:
+      case CONN_HEADERS:
+        readRequest(conn, config, now);
+        break;
+
+      case CONN_BODY:
+        readBody(conn, now);
+        break;
+
+      case CONN_RESPONSE:
+        writeResponse(conn, now);
+        break;
+
+      case CONN_CLOSE:
+        break;
+    }
+    if (conn.state == CONN_FREE) {
+      continue; // Handed over to a stream subscriber
+    }
+
+    if (conn.state != CONN_CLOSE && (now - conn.lastActivityMs) > IDLE_TIMEOUT_MS) {
+      event_log(EVT_WEB_IDLE_TIMEOUT);
+      conn.state = CONN_CLOSE;
+    }
+    if (conn.state == CONN_CLOSE) {
+      closeConnection(conn);
+    }
+  }
+
+  publishStreamFrame();
+  for (uint8_t i = 0; i < MAX_STREAMS; i++) {
+    if (g_streams[i].active) writeStream(g_streams[i], now);
+  }
+}
+
+#if CC_BENCH
+size_t web_server_bench_serialize(const char *format) {
+  static HttpConnection conn;
+  syncSampleCache();
+  char query[24] = "";
+  if (format != nullptr) snprintf(query, sizeof(query), "format=%s", format);
+  handleLast200(conn, HttpSlice{query, (uint16_t)strlen(query)});
+  size_t total = 0;
+  while (conn.generator != nullptr) {
+    size_t len = conn.generator(conn, conn.scratch, sizeof(conn.scratch));
+    if (len == 0) break;
+    total += len;
+  }
+  conn.generator = nullptr;
+  conn.state = CONN_FREE;
+  return total;
 }
+#endif
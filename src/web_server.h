@@ -2,6 +2,7 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
+#include "config.h"
 
 typedef void (*WebIncrementHandler)();
 
@@ -12,4 +13,30 @@ typedef struct {
     WebIncrementHandler on_increment;
 } WebServerConfig;
 
+/**
+ * @brief Advance all HTTP connections by one bounded step
+ *
+ * Call this repeatedly in the main loop. Accepts at most one new client per
+ * call and moves every open connection through request-line parsing, header
+ * parsing and response writing, limited by Config::WebUI::HTTP_*_BUDGET_BYTES.
+ * HTTP/1.1 connections are kept alive and serve further (pipelined)
+ * requests. Connections idle for longer than HTTP_IDLE_TIMEOUT_MS are closed. Also
+ * encodes a new sample once for the /api/stream subscribers and writes it
+ * to each of them. Never blocks waiting on a client.
+ *
+ * @param config Server instance and application values
+ */
 void web_server_handle(const WebServerConfig *config);
+
+#if CC_BENCH
+/**
+ * @brief Serialize the current /api/last200 window into a discard buffer
+ *
+ * Benchmark hook (bench.cpp): runs the same chunk generator as a real
+ * request, without a client.
+ *
+ * @param format "bin" or "packed" telemetry, nullptr for JSON
+ * @return Payload bytes produced
+ */
+size_t web_server_bench_serialize(const char *format);
+#endif
@@ -1,7 +1,27 @@
 #include "wifi_manager.h"
+#include <atomic>
+
+// Connection state machine, advanced by wifi_tick()
+enum WifiState : uint8_t {
+  WIFI_OFF,         // No credentials
+  WIFI_START,       // First attempt on the next tick
+  WIFI_CONNECTING,  // begin() issued, waiting for WL_CONNECTED
+  WIFI_CONNECTED,
+  WIFI_BACKOFF      // Waiting before the next attempt
+};
 
 // Internal state
 static WiFiServer g_server(WIFI_SERVER_PORT);
+static const char *g_ssid = nullptr;
+static const char *g_pass = nullptr;
+static WifiState g_state = WIFI_OFF;
+static std::atomic<bool> g_linkUp(false);    // WIFI_CONNECTED, read from other threads
+static unsigned long g_stateMs = 0;          // Entered the current state
+static unsigned long g_backoffMs = 0;        // Wait of the current WIFI_BACKOFF
+static unsigned long g_nextBackoffMs = WIFI_RETRY_DELAY_MS;
+static int g_failures = 0;                   // Consecutive failed attempts
+static bool g_scanned = false;               // Networks reported during this outage
+static bool g_serverStarted = false;
 static bool g_ipPrinted = false;
 static int g_lastStatus = -1;
 static unsigned long g_lastHeartbeatMs = 0;
@@ -64,76 +84,76 @@ void wifi_init(const char *ssid, const char *pass) {
   if (ssid == nullptr || pass == nullptr) {
     return;
   }
+  g_ssid = ssid;
+  g_pass = pass;
+  WiFi.setTimeout(WIFI_ATTEMPT_TIMEOUT_MS); // Bounds the blocking begin() of the mbed driver
+  g_state = WIFI_START;
+  g_stateMs = millis();
+}
 
+static void startAttempt(unsigned long now) {
   Serial.print("WiFi: Connecting to ");
-  Serial.println(ssid);
-
-  WiFi.disconnect();
-  delay(100);
-
-  for (int attempt = 1; attempt <= WIFI_MAX_RETRIES; ++attempt) {
-    WiFi.begin(ssid, pass);
-
-    unsigned long start = millis();
-    int lastStatus = -1;
-
-    while ((millis() - start) < WIFI_ATTEMPT_TIMEOUT_MS) {
-      int s = WiFi.status();
-      if (s == WL_CONNECTED) {
-        break;
-      }
-      if (s != lastStatus) {
-        Serial.print("  Status (");
-        Serial.print(wifiStatusToString(s));
-        Serial.println(")");
-        lastStatus = s;
-      } else {
-        Serial.print('.');
-      }
-      delay(500);
-    }
+  Serial.print(g_ssid);
+  Serial.print(" (attempt ");
+  Serial.print(g_failures + 1);
+  Serial.println(")");
+  g_state = WIFI_CONNECTING;
+  g_stateMs = now;
+  WiFi.begin(g_ssid, g_pass);
+}
 
-    int finalStatus = WiFi.status();
-    if (finalStatus == WL_CONNECTED) {
-      Serial.println();
-      Serial.print("Connected! IP: ");
-      Serial.println(WiFi.localIP());
-      Serial.print("WiFi RSSI: ");
-      Serial.print(WiFi.RSSI());
-      Serial.println(" dBm");
-      g_lastRssiPrintMs = millis(); // Initialize RSSI timer
-      g_server.begin();
-      return;
-    }
+static void onConnected(unsigned long now) {
+  Serial.print("Connected! IP: ");
+  Serial.println(WiFi.localIP());
+  g_ipPrinted = true;
+  if (!g_serverStarted) {
+    g_server.begin(); // The listening socket survives later reconnects
+    g_serverStarted = true;
+  }
+  g_state = WIFI_CONNECTED;
+  g_linkUp.store(true, std::memory_order_release); // After the server socket exists
+  g_stateMs = now;
+  g_failures = 0;
+  g_scanned = false;
+  g_nextBackoffMs = WIFI_RETRY_DELAY_MS;
+}
 
-    Serial.println();
-    Serial.print("  Attempt ");
-    Serial.print(attempt);
-    Serial.print(" failed (status ");
-    Serial.print(finalStatus);
-    Serial.println(")");
+static void startBackoff(unsigned long now) {
+  g_backoffMs = g_nextBackoffMs;
+  g_nextBackoffMs = (g_nextBackoffMs * 2 < WIFI_RETRY_MAX_MS) ? g_nextBackoffMs * 2 : WIFI_RETRY_MAX_MS;
+  g_state = WIFI_BACKOFF;
+  g_stateMs = now;
+}
 
-    if (attempt < WIFI_MAX_RETRIES) {
-      Serial.print("  Retrying in ");
-      Serial.print(WIFI_RETRY_DELAY_MS / 1000);
-      Serial.println("s...");
-      delay(WIFI_RETRY_DELAY_MS);
-    }
+static void onAttemptFailed(unsigned long now, int status) {
+  g_failures++;
+  Serial.print("  Attempt ");
+  Serial.print(g_failures);
+  Serial.print(" failed (");
+  Serial.print(wifiStatusToString(status));
+  Serial.println(")");
+
+  // Once per outage: is the access point visible at all? (the scan blocks
+  // for a few seconds, like begin())
+  if (g_failures >= WIFI_MAX_RETRIES && !g_scanned) {
+    g_scanned = true;
+    Serial.println("WiFi: Connection attempts keep failing. Scanning networks...");
+    scanAndReportNetworks(g_ssid);
   }
 
-  // All retries exhausted
-  Serial.println("WiFi: All connection attempts failed. Scanning networks...");
-  scanAndReportNetworks(ssid);
+  startBackoff(now);
+  Serial.print("  Retrying in ");
+  Serial.print(g_backoffMs / 1000);
+  Serial.println("s...");
 }
 
-void wifi_tick() {
+// Status line on change and every WIFI_HEARTBEAT_MS, IP once, RSSI every 5 s
+static void reportStatus(unsigned long now, int status) {
   if (!Serial) {
     g_ipPrinted = false;
     return;
   }
 
-  unsigned long now = millis();
-  int status = WiFi.status();
   if (status != g_lastStatus) {
     g_lastStatus = status;
     g_lastHeartbeatMs = now;
@@ -164,6 +184,61 @@ void wifi_tick() {
   }
 }
 
+void wifi_tick() {
+  unsigned long now = millis();
+  int status = WiFi.status();
+
+  switch (g_state) {
+    case WIFI_OFF:
+      return;
+
+    case WIFI_START:
+      startAttempt(now);
+      status = WiFi.status();
+      now = millis();
+      if (status == WL_CONNECTED) onConnected(now);
+      break;
+
+    case WIFI_CONNECTING:
+      if (status == WL_CONNECTED) {
+        onConnected(now);
+      } else if (status == WL_CONNECT_FAILED || status == WL_NO_SSID_AVAIL ||
+                 (now - g_stateMs) >= WIFI_ATTEMPT_TIMEOUT_MS) {
+        onAttemptFailed(now, status);
+      }
+      break;
+
+    case WIFI_CONNECTED:
+      if (status != WL_CONNECTED) {
+        Serial.print("WiFi: Link lost (");
+        Serial.print(wifiStatusToString(status));
+        Serial.println("), reconnecting");
+        g_linkUp.store(false, std::memory_order_relaxed);
+        WiFi.disconnect();
+        g_nextBackoffMs = WIFI_RETRY_DELAY_MS;
+        startBackoff(now);
+      }
+      break;
+
+    case WIFI_BACKOFF:
+      if (status == WL_CONNECTED) {
+        onConnected(now); // The driver got the link back on its own
+      } else if ((now - g_stateMs) >= g_backoffMs) {
+        startAttempt(now);
+        status = WiFi.status();
+        now = millis();
+        if (status == WL_CONNECTED) onConnected(now);
+      }
+      break;
+  }
+
+  reportStatus(now, status);
+}
+
+bool wifi_connected() {
+  return g_linkUp.load(std::memory_order_acquire);
+}
+
 WiFiServer* wifi_get_server() {
   return &g_server;
 }
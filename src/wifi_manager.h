@@ -5,16 +5,28 @@
 
 // WiFi Configuration Constants
 static constexpr uint16_t WIFI_SERVER_PORT = 80;
-static constexpr int WIFI_MAX_RETRIES = 3;
+static constexpr int WIFI_MAX_RETRIES = 3;                 // Failed attempts before the networks are scanned once
 static constexpr unsigned long WIFI_ATTEMPT_TIMEOUT_MS = 20000UL;
-static constexpr unsigned long WIFI_RETRY_DELAY_MS = 2000UL;
+static constexpr unsigned long WIFI_RETRY_DELAY_MS = 2000UL;   // First back-off, doubled per failed attempt
+static constexpr unsigned long WIFI_RETRY_MAX_MS = 60000UL;    // Back-off ceiling
 static constexpr unsigned long WIFI_HEARTBEAT_MS = 30000UL;
 
-// Initialize WiFi and server (call once in setup)
+// Remember the credentials; the connection is made by wifi_tick() (call once,
+// from the thread that calls wifi_tick())
 void wifi_init(const char *ssid, const char *pass);
 
-// Periodic tick for WiFi status monitoring (call in loop)
+// Advance connect / retry / reconnect and report the status (call periodically)
+//
+// Never waits itself, but on mbed WiFi.begin() returns only once the attempt
+// has succeeded or failed (bounded by WIFI_ATTEMPT_TIMEOUT_MS), and a network
+// scan takes seconds as well. Call it from a thread of its own, never from a
+// scheduler task: the network thread (CC_NETWORK_THREAD=1) or the WiFi
+// thread of main.cpp.
 void wifi_tick();
 
+// Whether the link is up and the server socket open (as of the last
+// wifi_tick(), safe from any thread)
+bool wifi_connected();
+
 // Get server instance for web server module
 WiFiServer* wifi_get_server();
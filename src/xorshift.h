@@ -0,0 +1,45 @@
+/*
+ * *****************************************************************************
+ * XORSHIFT - SEEDED PSEUDO-RANDOM NUMBERS FOR THE SIMULATION
+ * *****************************************************************************
+ * Marsaglia's xorshift32 (13/17/5): three shifts and three XORs per number,
+ * period 2^32 - 1. The same seed gives the same sequence on every build and
+ * host, so a simulated scenario (SimSensor, Config::Simulation::SEED) can be
+ * rerun exactly. Not for anything security related. test/test_xorshift
+ * pins the sequence to Marsaglia's published values.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class XorShift32 {
+private:
+  uint32_t state;  // Never 0 (a fixed point of the generator)
+
+public:
+  explicit XorShift32(uint32_t seed = 1) : state(seed != 0 ? seed : 1) {}
+
+  void seed(uint32_t value) { state = (value != 0) ? value : 1; }
+
+  uint32_t next() {
+    uint32_t x = state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state = x;
+    return x;
+  }
+
+  /**
+   * @brief Uniform in [lo, hi), like Arduino's random(lo, hi)
+   *
+   * Multiply-shift instead of a modulo; the bias is below 2^-32 * range.
+   */
+  int32_t range(int32_t lo, int32_t hi) {
+    if (hi <= lo) return lo;
+    uint32_t span = (uint32_t)(hi - lo);
+    return lo + (int32_t)(((uint64_t)next() * span) >> 32);
+  }
+};
@@ -0,0 +1,75 @@
+/*
+ * *****************************************************************************
+ * HOST SIMULATION - BOOT AND RUN THE FIRMWARE ON THE VIRTUAL CLOCK
+ * *****************************************************************************
+ * Shared by the env:native tests. host_sim_boot() runs the setup() order of
+ * main.cpp against lib/HostHal; host_sim_run() drives the real scheduler
+ * with the firmware's own task table (src/tasks.h) and jumps the virtual
+ * clock to the next due task, so days of chamber time take seconds. With
+ * the chamber clock in MODE_STEP (CC_TRACE) the control tasks are due on
+ * every pass; each pass then costs HOST_SIM_PASS_US.
+ *
+ * The entries main.cpp defines are stand-ins here: no web task (no WiFi on
+ * the host) and a boot task that idles, host_sim_boot() having done its
+ * stages already. The front ends run against the HostHal stand-ins;
+ * CC_SIM_SENSOR feeds the controller.
+ * *****************************************************************************
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "actuator_stats.h"
+#include "tasks.h"
+
+static constexpr uint32_t HOST_SIM_EPOCH = 1767225600; // 2026-01-01T00:00:00Z
+static constexpr unsigned long HOST_SIM_PASS_US = 200;  // Host time of one pass in MODE_STEP
+
+#if !CC_NETWORK_THREAD
+void main_web_tick(unsigned long) {}
+#endif
+
+void main_boot_tick(unsigned long) {}
+
+unsigned long main_boot_next_ms(unsigned long now) {
+  return now + Config::Scheduler::MAX_IDLE_MS;
+}
+
+/**
+ * @brief Power-on: setup() of main.cpp on the current RAM flash content
+ *
+ * Call host_flash_wipe() first for a factory-fresh board; without it this
+ * is a reboot that keeps settings and the sample log.
+ */
+static inline void host_sim_boot() {
+  host_serial_echo(false);
+  host_rtc_set_epoch(HOST_SIM_EPOCH);
+  outputs_init();
+  storage_init();
+  storage_load();
+  wall_clock_init();
+  temp_probes_init();
+  analog_inputs_init();
+  modbus_master_init();
+  chamber_clock_init();
+  controller_init();
+  sample_log_init(); // main.cpp: first stage of the boot task
+  scheduler_init(TASKS, TASK_COUNT);
+}
+
+/**
+ * @brief Run the scheduler for `ms` of (virtual) real time
+ */
+static inline void host_sim_run(unsigned long ms) {
+  unsigned long end = millis() + ms;
+  while ((long)(millis() - end) < 0) {
+    if (scheduler_run_pass()) {
+      if (Config::Clock::MODE == Config::Clock::MODE_STEP) host_clock_advance_us(HOST_SIM_PASS_US);
+      continue;
+    }
+    unsigned long due = scheduler_next_due_ms();
+    if ((long)(due - end) > 0) due = end;
+    unsigned long now = millis();
+    host_clock_advance_ms(((long)(due - now) > 0) ? due - now : 1);
+  }
+}
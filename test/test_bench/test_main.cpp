@@ -0,0 +1,37 @@
+/*
+ * *****************************************************************************
+ * BENCH - THE MICRO-BENCHMARKS ON THE HOST CPU (env:native)
+ * *****************************************************************************
+ * Runs bench_run() (bench.h) on the real clock after the same boot as on
+ * the board, so a change to a hot path can be compared before flashing:
+ * `pio test -e native -f test_bench -v` prints the ns/op lines. The numbers
+ * are the host's, only their ratios carry over to the M7.
+ * *****************************************************************************
+ */
+
+#include <unity.h>
+#include "../host_sim.h"
+#include "bench.h"
+
+void setUp() {
+  host_clock_set_us(0);
+  host_flash_wipe();
+  host_sim_boot();
+  host_sim_run(60000); // Fill the history the serializers walk
+}
+
+void tearDown() {}
+
+static void test_bench_runs() {
+  host_serial_echo(true);
+  host_clock_use_real();
+  uint64_t before = host_serial_bytes();
+  bench_run();
+  TEST_ASSERT_GREATER_THAN_UINT32(0, (uint32_t)(host_serial_bytes() - before));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_bench_runs);
+  return UNITY_END();
+}
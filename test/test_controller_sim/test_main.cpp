@@ -0,0 +1,94 @@
+/*
+ * *****************************************************************************
+ * CONTROLLER SIMULATION - DAYS OF SIMULATED CHAMBER TIME (env:native)
+ * *****************************************************************************
+ * Boots the firmware on the host (../host_sim.h), lets SimSensor drive every
+ * chamber for three simulated days and checks what a long run on the bench
+ * would show: samples keep coming at the configured interval, values stay
+ * in range, the sample log takes them without a single bad flash program,
+ * and a reboot continues the log.
+ * *****************************************************************************
+ */
+
+#include <unity.h>
+#include "../host_sim.h"
+
+static constexpr unsigned long HOUR_MS = 3600000UL;
+
+void setUp() {
+  host_clock_set_us(0);
+  host_flash_wipe();
+  host_sim_boot();
+}
+
+void tearDown() {}
+
+// One chamber-time sample per SAMPLE_INTERVAL_MS, whatever the speedup
+static void test_samples_follow_the_chamber_clock() {
+  host_sim_run(HOUR_MS);
+  uint32_t expected = (uint32_t)(chamber_clock_now() / Config::SAMPLE_INTERVAL_MS);
+  for (uint8_t chamber = 0; chamber < Config::Chambers::COUNT; chamber++) {
+    uint32_t seq = controller_get_sample_seq(chamber);
+    TEST_ASSERT_UINT32_WITHIN(2, expected, seq);
+  }
+}
+
+static void test_three_simulated_days_stay_in_range() {
+  unsigned long stepMs = 15UL * 60000UL / chamber_clock_speedup(); // 15 min chamber time
+  uint8_t seenActuators = 0;
+  for (int step = 0; step < 3 * 96; step++) {
+    host_sim_run(stepMs);
+    for (uint8_t chamber = 0; chamber < Config::Chambers::COUNT; chamber++) {
+      ControllerSnapshot snap;
+      controller_snapshot(chamber, &snap);
+      TEST_ASSERT_GREATER_THAN_UINT32(0, snap.seq);
+      TEST_ASSERT_INT16_WITHIN(5000, 5000, snap.sensors[SERIES_CO2]);
+      TEST_ASSERT_INT16_WITHIN(500, 500, snap.sensors[SERIES_RH]);
+      TEST_ASSERT_INT16_WITHIN(600, 200, snap.sensors[SERIES_TEMP]);
+      seenActuators |= snap.actuators;
+    }
+  }
+  TEST_ASSERT_NOT_EQUAL(0, seenActuators); // Something was regulated
+
+  HostFlashStats flash;
+  host_flash_stats(&flash);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, flash.programs);
+  TEST_ASSERT_EQUAL_UINT32(0, flash.programFaults); // Never programmed over unerased bits
+}
+
+static void test_deadlines_hold_on_the_virtual_clock() {
+  host_sim_run(HOUR_MS);
+  for (uint8_t i = 0; i < scheduler_task_count(); i++) {
+    const SchedulerTaskStats *stats = scheduler_task_stats(i);
+    TEST_ASSERT_NOT_NULL(stats);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats->runs);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, stats->deadlineMisses, scheduler_task(i)->name);
+  }
+}
+
+static void test_reboot_continues_the_sample_log() {
+  host_sim_run(HOUR_MS);
+  uint32_t newest = sample_log_newest_seq();
+  TEST_ASSERT_GREATER_THAN_UINT32(Config::SAMPLE_LOG_BLOCK_SAMPLES, newest);
+
+  host_sim_boot(); // Same flash: the unfinished block is lost, nothing else
+  uint32_t recovered = sample_log_newest_seq();
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(newest, recovered);
+  TEST_ASSERT_GREATER_THAN_UINT32(newest - Config::SAMPLE_LOG_BLOCK_SAMPLES, recovered);
+
+  host_sim_run(HOUR_MS);
+  TEST_ASSERT_GREATER_THAN_UINT32(recovered, sample_log_newest_seq());
+  SampleRecord record;
+  uint32_t epoch = 0;
+  TEST_ASSERT_TRUE(sample_log_read(recovered + 1, &record, &epoch));
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(HOST_SIM_EPOCH, epoch);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_samples_follow_the_chamber_clock);
+  RUN_TEST(test_three_simulated_days_stay_in_range);
+  RUN_TEST(test_deadlines_hold_on_the_virtual_clock);
+  RUN_TEST(test_reboot_continues_the_sample_log);
+  return UNITY_END();
+}
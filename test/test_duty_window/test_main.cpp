@@ -0,0 +1,101 @@
+/*
+ * *****************************************************************************
+ * DUTY WINDOW - BUCKET RING WITH RUNNING SUMS (env:native)
+ * *****************************************************************************
+ * A small window (4 x 1 s, two actuators) from duty_window.h: intervals
+ * split at bucket boundaries, the window sliding in BUCKET_MS steps, the
+ * span before and after it is full, a gap longer than the window and
+ * times across the millis() wrap.
+ * *****************************************************************************
+ */
+
+#include <unity.h>
+#include "duty_window.h"
+
+typedef DutyWindow<2, 4, 1000> Window;
+
+static Window g_window;
+
+void setUp() {
+  g_window.reset(0);
+}
+
+void tearDown() {}
+
+static void test_add_and_count_switch() {
+  g_window.countSwitch(0, 0);
+  g_window.add(0, 500, 0x01);
+  g_window.add(500, 800, 0x03);
+  TEST_ASSERT_EQUAL_UINT32(800, g_window.onTimeMs(0));
+  TEST_ASSERT_EQUAL_UINT32(300, g_window.onTimeMs(1));
+  TEST_ASSERT_EQUAL_UINT32(1, g_window.switches(0));
+  TEST_ASSERT_EQUAL_UINT32(0, g_window.switches(1));
+  TEST_ASSERT_EQUAL_UINT32(800, g_window.spanMs(800));
+}
+
+// 3 closed buckets + the open one: the first bucket drops out at 4 s
+static void test_window_slides_in_bucket_steps() {
+  g_window.countSwitch(0, 0);
+  g_window.add(0, 1000, 0x01);
+  g_window.add(1000, 3999, 0x00);
+  TEST_ASSERT_EQUAL_UINT32(1000, g_window.onTimeMs(0));
+  TEST_ASSERT_EQUAL_UINT32(1, g_window.switches(0));
+  TEST_ASSERT_EQUAL_UINT32(3999, g_window.spanMs(3999));
+
+  g_window.add(3999, 4000, 0x00);
+  TEST_ASSERT_EQUAL_UINT32(0, g_window.onTimeMs(0));
+  TEST_ASSERT_EQUAL_UINT32(0, g_window.switches(0));
+  TEST_ASSERT_EQUAL_UINT32(3000, g_window.spanMs(4000));
+}
+
+// An interval over a boundary is split, so only its old part drops out
+static void test_interval_split_at_boundaries() {
+  g_window.add(0, 500, 0x00);
+  g_window.add(500, 2500, 0x02);
+  TEST_ASSERT_EQUAL_UINT32(2000, g_window.onTimeMs(1));
+  g_window.add(2500, 4200, 0x00);
+  TEST_ASSERT_EQUAL_UINT32(1500, g_window.onTimeMs(1));
+  g_window.add(4200, 5000, 0x00);
+  TEST_ASSERT_EQUAL_UINT32(500, g_window.onTimeMs(1));
+}
+
+static void test_gap_longer_than_window_clears_it() {
+  g_window.countSwitch(1, 0);
+  g_window.add(0, 1000, 0x03);
+  g_window.add(1000, 100000, 0x00);
+  TEST_ASSERT_EQUAL_UINT32(0, g_window.onTimeMs(0));
+  TEST_ASSERT_EQUAL_UINT32(0, g_window.onTimeMs(1));
+  TEST_ASSERT_EQUAL_UINT32(0, g_window.switches(1));
+  TEST_ASSERT_EQUAL_UINT32(3000, g_window.spanMs(100000));
+
+  g_window.add(100000, 100250, 0x01);
+  TEST_ASSERT_EQUAL_UINT32(250, g_window.onTimeMs(0));
+}
+
+// A long interval keeps only what the window covers at its end
+static void test_long_interval_is_capped_to_window() {
+  g_window.add(0, 60000, 0x01);
+  TEST_ASSERT_EQUAL_UINT32(3000, g_window.onTimeMs(0));
+  TEST_ASSERT_EQUAL_UINT32(3000, g_window.spanMs(60000));
+}
+
+static void test_times_across_the_wrap() {
+  unsigned long start = (unsigned long)0 - 1500;
+  g_window.reset(start);
+  g_window.add(start, start + 2500, 0x01); // Ends at 1000 after the wrap
+  TEST_ASSERT_EQUAL_UINT32(2500, g_window.onTimeMs(0));
+  TEST_ASSERT_EQUAL_UINT32(2500, g_window.spanMs(start + 2500));
+  g_window.add(start + 2500, start + 4500, 0x00); // First bucket dropped
+  TEST_ASSERT_EQUAL_UINT32(1500, g_window.onTimeMs(0));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_add_and_count_switch);
+  RUN_TEST(test_window_slides_in_bucket_steps);
+  RUN_TEST(test_interval_split_at_boundaries);
+  RUN_TEST(test_gap_longer_than_window_clears_it);
+  RUN_TEST(test_long_interval_is_capped_to_window);
+  RUN_TEST(test_times_across_the_wrap);
+  return UNITY_END();
+}
@@ -0,0 +1,76 @@
+/*
+ * *****************************************************************************
+ * RUN REPORT - ACCOUNTING OF ONE RUN (env:native)
+ * *****************************************************************************
+ * RunReport (run_report.h) on hand-made samples: duty and time in band
+ * weighted by the sample durations, switch-ons counted on rising edges
+ * only, pass times and reset().
+ * *****************************************************************************
+ */
+
+#include <unity.h>
+#include "run_report.h"
+
+typedef RunReport<3, 2, 2> Report;
+
+static Report g_report;
+
+void setUp() {
+  g_report.reset();
+}
+
+void tearDown() {}
+
+static void test_duty_and_band_are_time_weighted() {
+  g_report.addSample(0x01, 0x01, 1000);
+  g_report.addSample(0x03, 0x00, 3000);
+  TEST_ASSERT_EQUAL_UINT32(2, g_report.samples());
+  TEST_ASSERT_EQUAL_UINT64(4000, g_report.durationMs());
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, g_report.duty(0));
+  TEST_ASSERT_EQUAL_FLOAT(0.75f, g_report.duty(1));
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, g_report.duty(2));
+  TEST_ASSERT_EQUAL_FLOAT(0.25f, g_report.timeInBand(0));
+}
+
+// An actuator already on in the first sample did not switch on during the run
+static void test_switch_ons_count_rising_edges() {
+  g_report.addSample(0x01, 0, 100);
+  g_report.addSample(0x00, 0, 100);
+  g_report.addSample(0x01, 0, 100);
+  g_report.addSample(0x01, 0, 100);
+  g_report.addSample(0x04, 0, 100);
+  TEST_ASSERT_EQUAL_UINT32(1, g_report.switches(0));
+  TEST_ASSERT_EQUAL_UINT32(0, g_report.switches(1));
+  TEST_ASSERT_EQUAL_UINT32(1, g_report.switches(2));
+}
+
+static void test_actions_and_passes() {
+  g_report.addAction(1);
+  g_report.addAction(1);
+  g_report.addAction(7); // Out of range: ignored
+  g_report.addPass(10);
+  g_report.addPass(30);
+  TEST_ASSERT_EQUAL_UINT32(0, g_report.actions(0));
+  TEST_ASSERT_EQUAL_UINT32(2, g_report.actions(1));
+  TEST_ASSERT_EQUAL_UINT32(2, g_report.passes());
+  TEST_ASSERT_EQUAL_UINT32(20, g_report.passMeanUs());
+  TEST_ASSERT_EQUAL_UINT32(30, g_report.passMaxUs());
+}
+
+static void test_empty_and_reset() {
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, g_report.duty(0));
+  TEST_ASSERT_EQUAL_UINT32(0, g_report.passMeanUs());
+  g_report.addSample(0x07, 0x03, 500);
+  g_report.reset();
+  TEST_ASSERT_EQUAL_UINT32(0, g_report.samples());
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, g_report.timeInBand(1));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_duty_and_band_are_time_weighted);
+  RUN_TEST(test_switch_ons_count_rising_edges);
+  RUN_TEST(test_actions_and_passes);
+  RUN_TEST(test_empty_and_reset);
+  return UNITY_END();
+}
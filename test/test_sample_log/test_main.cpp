@@ -0,0 +1,132 @@
+/*
+ * *****************************************************************************
+ * SAMPLE LOG - APPEND, READ BACK, RECOVER (env:native)
+ * *****************************************************************************
+ * Drives sample_log.cpp directly on the RAM flash of lib/HostHal: reads
+ * from the pending block and from flash, recovery after a reset, the
+ * segment ring recycling its oldest segment, and the time index.
+ * *****************************************************************************
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "config.h"
+#include "sample_log.h"
+#include "storage.h"
+
+static constexpr uint32_t EPOCH = 1767225600; // 2026-01-01T00:00:00Z
+static constexpr uint32_t STEP_S = Config::SAMPLE_INTERVAL_MS / 1000;
+
+static uint32_t g_appended = 0;
+
+static void boot() {
+  storage_init(); // Opens the block device for all regions
+  TEST_ASSERT_TRUE(sample_log_init());
+}
+
+// Sample n: every value a function of n, so any sample can be checked
+static void sampleValues(uint32_t n, int16_t *values) {
+  for (uint8_t i = 0; i < 7; i++) values[i] = (int16_t)(400 + (n * 7 + i * 13) % 600);
+}
+
+static void append(uint32_t count) {
+  int16_t values[7];
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t n = g_appended++;
+    sampleValues(n, values);
+    sample_log_append(values, (uint8_t)(n & 0x0F), EPOCH + n * STEP_S);
+    sample_log_tick(); // What the scheduler's sample_log task does between samples
+  }
+}
+
+static void checkSample(uint32_t seq, uint32_t n) {
+  SampleRecord record;
+  uint32_t epoch = 0;
+  TEST_ASSERT_TRUE(sample_log_read(seq, &record, &epoch));
+  int16_t expected[7];
+  int16_t decoded[7];
+  sampleValues(n, expected);
+  sample_log_decode(record, decoded);
+  TEST_ASSERT_EQUAL_MEMORY(expected, decoded, sizeof(expected));
+  TEST_ASSERT_EQUAL_UINT8(n & 0x0F, record.actuators);
+  TEST_ASSERT_UINT32_WITHIN(STEP_S, EPOCH + n * STEP_S, epoch);
+}
+
+void setUp() {
+  host_serial_echo(false);
+  host_clock_set_us(0);
+  host_flash_wipe();
+  g_appended = 0;
+  boot();
+}
+
+void tearDown() {}
+
+static void test_empty_log() {
+  TEST_ASSERT_TRUE(sample_log_available());
+  TEST_ASSERT_EQUAL_UINT32(0, sample_log_oldest_seq());
+  TEST_ASSERT_EQUAL_UINT32(0, sample_log_find_time(EPOCH));
+}
+
+// Sample numbers start at 1; the unfinished block reads from RAM
+static void test_reads_pending_and_flushed_samples() {
+  uint32_t count = 3 * Config::SAMPLE_LOG_BLOCK_SAMPLES + 5;
+  append(count);
+  TEST_ASSERT_EQUAL_UINT32(1, sample_log_oldest_seq());
+  TEST_ASSERT_EQUAL_UINT32(count, sample_log_newest_seq());
+  for (uint32_t seq = 1; seq <= count; seq++) checkSample(seq, seq - 1);
+  SampleRecord record;
+  TEST_ASSERT_FALSE(sample_log_read(count + 1, &record));
+}
+
+static void test_reset_loses_only_the_unfinished_block() {
+  uint32_t blocks = 4;
+  append(blocks * Config::SAMPLE_LOG_BLOCK_SAMPLES + 7);
+  boot();
+  TEST_ASSERT_EQUAL_UINT32(blocks * Config::SAMPLE_LOG_BLOCK_SAMPLES, sample_log_newest_seq());
+  checkSample(sample_log_newest_seq(), sample_log_newest_seq() - 1);
+
+  // Numbering continues after the recovered samples
+  g_appended = sample_log_newest_seq();
+  append(Config::SAMPLE_LOG_BLOCK_SAMPLES);
+  checkSample(sample_log_newest_seq(), g_appended - 1);
+}
+
+// More samples than the region holds: the oldest segments are recycled,
+// everything still indexed reads back, nothing is programmed unerased
+static void test_ring_recycles_oldest_segments() {
+  uint32_t capacity = Config::SAMPLE_LOG_REGION_BYTES / 5; // Well above the packed size of a sample
+  append(capacity);
+  uint32_t oldest = sample_log_oldest_seq();
+  uint32_t newest = sample_log_newest_seq();
+  TEST_ASSERT_GREATER_THAN_UINT32(1, oldest);
+  TEST_ASSERT_EQUAL_UINT32(capacity, newest);
+  for (uint32_t seq = oldest; seq <= newest; seq += 97) checkSample(seq, seq - 1);
+  checkSample(newest, newest - 1);
+
+  HostFlashStats flash;
+  host_flash_stats(&flash);
+  TEST_ASSERT_EQUAL_UINT32(0, flash.programFaults);
+
+  boot();
+  TEST_ASSERT_EQUAL_UINT32(oldest, sample_log_oldest_seq());
+}
+
+static void test_find_time_lands_in_the_right_block() {
+  append(20 * Config::SAMPLE_LOG_BLOCK_SAMPLES);
+  uint32_t target = 300;
+  uint32_t seq = sample_log_find_time(EPOCH + target * STEP_S);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(target + 1, seq);
+  TEST_ASSERT_GREATER_THAN_UINT32(target + 1 - Config::SAMPLE_LOG_BLOCK_SAMPLES, seq);
+  TEST_ASSERT_EQUAL_UINT32(sample_log_oldest_seq(), sample_log_find_time(EPOCH - 3600));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_log);
+  RUN_TEST(test_reads_pending_and_flushed_samples);
+  RUN_TEST(test_reset_loses_only_the_unfinished_block);
+  RUN_TEST(test_ring_recycles_oldest_segments);
+  RUN_TEST(test_find_time_lands_in_the_right_block);
+  return UNITY_END();
+}
@@ -0,0 +1,150 @@
+/*
+ * *****************************************************************************
+ * STORAGE - SETTINGS RING ON THE RAM FLASH (env:native)
+ * *****************************************************************************
+ * Power cycles are storage_init() + storage_load() on the unchanged RAM
+ * flash (lib/HostHal). Checks persistence, the ring wrapping over its
+ * sectors, per-chamber keys, the lifetime counters and that no slot is
+ * programmed unerased.
+ * *****************************************************************************
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "config.h"
+#include "flash_ringbuffer.h"
+#include "storage.h"
+
+static void reboot() {
+  storage_init();
+  storage_load();
+}
+
+void setUp() {
+  host_serial_echo(false);
+  host_clock_set_us(0);
+  host_flash_wipe();
+  reboot();
+}
+
+void tearDown() {}
+
+static void test_fresh_flash_gives_defaults() {
+  TEST_ASSERT_EQUAL_INT32(800, storage_get_setting(SETTING_CO2_SETPOINT));
+  TEST_ASSERT_EQUAL_INT32(890, storage_get_setting(SETTING_RH_SETPOINT));
+  TEST_ASSERT_EQUAL_UINT32(0, storage_flash_writes());
+}
+
+static void test_setting_survives_reboot() {
+  storage_set_setting(SETTING_CO2_SETPOINT, 1200);
+  storage_set_rh_setpoint(91.5f);
+  TEST_ASSERT_TRUE(storage_write_pending());
+  storage_save_now();
+  TEST_ASSERT_FALSE(storage_write_pending());
+
+  reboot();
+  TEST_ASSERT_EQUAL_INT32(1200, storage_get_setting(SETTING_CO2_SETPOINT));
+  TEST_ASSERT_EQUAL_FLOAT(91.5f, storage_get_rh_setpoint());
+  TEST_ASSERT_EQUAL_UINT32(1, storage_setting_changes(SETTING_CO2_SETPOINT));
+  TEST_ASSERT_EQUAL_UINT32(2, storage_total_changes());
+}
+
+static void test_values_are_clamped_to_range() {
+  TEST_ASSERT_EQUAL_INT32(10000, storage_set_setting(SETTING_CO2_SETPOINT, 50000));
+  TEST_ASSERT_EQUAL_INT32(400, storage_set_setting(SETTING_CO2_SETPOINT, 0));
+  int32_t raw;
+  TEST_ASSERT_FALSE(storage_setting_parse(SETTING_TEMP_SETPOINT, 99.0f, &raw));
+  TEST_ASSERT_TRUE(storage_setting_parse(SETTING_TEMP_SETPOINT, 26.4f, &raw));
+  TEST_ASSERT_EQUAL_INT32(264, raw);
+}
+
+// The counter keys span the full int32 range: out-of-range floats are
+// rejected or clamped before they reach lroundf()
+static void test_out_of_range_floats_are_caught() {
+  int32_t raw = -1;
+  TEST_ASSERT_FALSE(storage_setting_parse(SETTING_FOGGER_ON_S, 2147483648.0f, &raw));
+  TEST_ASSERT_FALSE(storage_setting_parse(SETTING_FOGGER_ON_S, 3e9f, &raw));
+  TEST_ASSERT_FALSE(storage_setting_parse(SETTING_FOGGER_ON_S, -1.0f, &raw));
+  TEST_ASSERT_EQUAL_INT32(-1, raw);
+  TEST_ASSERT_TRUE(storage_setting_parse(SETTING_FOGGER_ON_S, 2147483520.0f, &raw)); // Largest float below 2^31
+  TEST_ASSERT_EQUAL_INT32(2147483520, raw);
+  TEST_ASSERT_EQUAL_INT32(INT32_MAX, storage_setting_from_float(SETTING_FOGGER_ON_S, 1e12f));
+  TEST_ASSERT_EQUAL_INT32(0, storage_setting_from_float(SETTING_FOGGER_ON_S, -1e12f));
+  TEST_ASSERT_EQUAL_INT32(400, storage_setting_from_float(SETTING_CO2_SETPOINT, NAN));
+}
+
+// Lifetime totals are written like settings but are not user changes
+static void test_counters_do_not_count_as_changes() {
+  storage_add_counter(SETTING_HEATER_ON_S, 3600);
+  storage_add_counter(SETTING_HEATER_SWITCHES, 12);
+  storage_add_counter(SETTING_HEATER_ON_S, 1800);
+  TEST_ASSERT_TRUE(storage_write_pending());
+  TEST_ASSERT_EQUAL_UINT32(0, storage_total_changes());
+  TEST_ASSERT_EQUAL_UINT32(0, storage_setting_changes(SETTING_HEATER_ON_S));
+
+  storage_save_now();
+  reboot();
+  TEST_ASSERT_EQUAL_INT32(5400, storage_get_setting(SETTING_HEATER_ON_S));
+  TEST_ASSERT_EQUAL_INT32(12, storage_get_setting(SETTING_HEATER_SWITCHES));
+  TEST_ASSERT_EQUAL_UINT32(0, storage_total_changes());
+
+  // Saturates instead of wrapping negative
+  storage_set_setting(SETTING_HEATER_ON_S, INT32_MAX - 10);
+  TEST_ASSERT_EQUAL_INT32(INT32_MAX, storage_add_counter(SETTING_HEATER_ON_S, 3600));
+  TEST_ASSERT_EQUAL_UINT32(1, storage_total_changes()); // Only the explicit set
+}
+
+// Several trips round the ring: the newest image wins, every slot is
+// programmed only after its sector was erased
+static void test_ring_wraps_and_keeps_newest() {
+  for (int32_t i = 0; i < 3 * (int32_t)RING_BUFFER_NUM_SLOTS + 5; i++) {
+    storage_set_setting(SETTING_CO2_SETPOINT, 1000 + i);
+    storage_save_now();
+    for (int t = 0; t < 4; t++) { // Erase-ahead runs from storage_tick()
+      host_clock_advance_ms(Config::Scheduler::STORAGE_PERIOD_MS);
+      storage_tick();
+    }
+  }
+  reboot();
+  TEST_ASSERT_EQUAL_INT32(1000 + 3 * RING_BUFFER_NUM_SLOTS + 4, storage_get_setting(SETTING_CO2_SETPOINT));
+  TEST_ASSERT_EQUAL_UINT32(3 * RING_BUFFER_NUM_SLOTS + 5, storage_flash_writes());
+
+  HostFlashStats flash;
+  host_flash_stats(&flash);
+  TEST_ASSERT_EQUAL_UINT32(0, flash.programFaults);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, flash.erases);
+}
+
+// Coalescing: a change that is undone before the quiet time ends is never written
+static void test_cancelled_change_is_not_written() {
+  storage_set_setting(SETTING_TEMP_SETPOINT, 300);
+  storage_set_setting(SETTING_TEMP_SETPOINT, 250);
+  for (int t = 0; t < 10; t++) {
+    host_clock_advance_ms(PERSIST_INTERVAL_MS);
+    storage_tick();
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, storage_flash_writes());
+}
+
+static void test_chambers_keep_their_own_setpoints() {
+  if (Config::Chambers::COUNT < 2) return;
+  storage_set_chamber_setting(1, SETTING_TEMP_SETPOINT, 220);
+  storage_save_now();
+  reboot();
+  TEST_ASSERT_EQUAL_INT32(250, storage_get_chamber_setting(0, SETTING_TEMP_SETPOINT));
+  TEST_ASSERT_EQUAL_INT32(220, storage_get_chamber_setting(1, SETTING_TEMP_SETPOINT));
+  TEST_ASSERT_FALSE(storage_setting_per_chamber(SETTING_COUNTER));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fresh_flash_gives_defaults);
+  RUN_TEST(test_setting_survives_reboot);
+  RUN_TEST(test_values_are_clamped_to_range);
+  RUN_TEST(test_out_of_range_floats_are_caught);
+  RUN_TEST(test_counters_do_not_count_as_changes);
+  RUN_TEST(test_ring_wraps_and_keeps_newest);
+  RUN_TEST(test_cancelled_change_is_not_written);
+  RUN_TEST(test_chambers_keep_their_own_setpoints);
+  return UNITY_END();
+}
@@ -0,0 +1,103 @@
+/*
+ * *****************************************************************************
+ * SENSOR TRACE - REPLAY ON THE HOST (env:native_trace, CC_TRACE=1)
+ * *****************************************************************************
+ * Records a SimSensor scenario into the sample log, then replays it into
+ * chamber 0 after a reboot (sensor_trace.h). The same trace on the same
+ * firmware must give the same run report, which is what makes two
+ * firmware versions comparable on it.
+ * *****************************************************************************
+ */
+
+#include <unity.h>
+#include "../host_sim.h"
+#include "sensor_trace.h"
+
+static constexpr uint32_t TRACE_SAMPLES = 600; // 30 min of chamber time
+
+static uint32_t g_first = 0;
+static uint32_t g_last = 0;
+
+static void record() {
+  while (sample_log_newest_seq() < TRACE_SAMPLES + 1) host_sim_run(1000);
+  g_first = sample_log_oldest_seq();
+  g_last = g_first + TRACE_SAMPLES - 1;
+}
+
+// Reboot, replay g_first..g_last from the first pass on, run to the end
+static TraceStatus replay() {
+  host_sim_boot();
+  uint32_t logged = sample_log_newest_seq();
+  TEST_ASSERT_TRUE(sensor_trace_request(g_first, g_last));
+  TraceStatus status;
+  for (int i = 0; i < 10000; i++) {
+    host_sim_run(100);
+    sensor_trace_status(&status);
+    if (status.state != TRACE_RUNNING) break;
+    TEST_ASSERT_EQUAL_UINT32(logged, sample_log_newest_seq()); // The trace stays intact
+  }
+  return status;
+}
+
+void setUp() {
+  host_clock_set_us(0);
+  host_flash_wipe();
+  host_sim_boot();
+  record();
+}
+
+void tearDown() {}
+
+static void test_replay_runs_every_frame() {
+  TraceStatus status = replay();
+  TEST_ASSERT_EQUAL(TRACE_DONE, status.state);
+  TEST_ASSERT_EQUAL_UINT32(TRACE_SAMPLES, status.frames);
+  TEST_ASSERT_EQUAL_UINT32(0, status.unreadable);
+  TEST_ASSERT_UINT32_WITHIN(2, TRACE_SAMPLES, status.report.samples());
+  TEST_ASSERT_UINT32_WITHIN(2 * Config::SAMPLE_INTERVAL_MS, (uint32_t)TRACE_SAMPLES * Config::SAMPLE_INTERVAL_MS,
+                            (uint32_t)status.report.durationMs());
+}
+
+static void test_same_trace_gives_same_report() {
+  TraceStatus a = replay();
+  TraceStatus b = replay();
+  TEST_ASSERT_EQUAL_UINT32(a.report.samples(), b.report.samples());
+  for (uint8_t i = 0; i < ACTUATOR_COUNT; i++) {
+    TEST_ASSERT_EQUAL_FLOAT(a.report.duty(i), b.report.duty(i));
+    TEST_ASSERT_EQUAL_UINT32(a.report.switches(i), b.report.switches(i));
+  }
+  for (uint8_t i = 0; i < TRACE_BAND_COUNT; i++) {
+    TEST_ASSERT_EQUAL_FLOAT(a.report.timeInBand(i), b.report.timeInBand(i));
+  }
+  for (uint8_t i = 0; i < ACTION_COUNT; i++) {
+    TEST_ASSERT_EQUAL_UINT32(a.report.actions(i), b.report.actions(i));
+  }
+}
+
+static void test_stop_ends_the_run() {
+  host_sim_boot();
+  TEST_ASSERT_TRUE(sensor_trace_request(g_first, g_last));
+  host_sim_run(1000);
+  TEST_ASSERT_TRUE(sensor_trace_active());
+  sensor_trace_request_stop();
+  host_sim_run(1000);
+  TraceStatus status;
+  sensor_trace_status(&status);
+  TEST_ASSERT_EQUAL(TRACE_STOPPED, status.state);
+  TEST_ASSERT_FALSE(sensor_trace_active());
+  TEST_ASSERT_LESS_THAN_UINT32(TRACE_SAMPLES, status.frames);
+}
+
+static void test_range_outside_the_log_is_refused() {
+  TEST_ASSERT_FALSE(sensor_trace_request(g_last, g_first));
+  TEST_ASSERT_FALSE(sensor_trace_request(g_first, sample_log_newest_seq() + 1));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_replay_runs_every_frame);
+  RUN_TEST(test_same_trace_gives_same_report);
+  RUN_TEST(test_stop_ends_the_run);
+  RUN_TEST(test_range_outside_the_log_is_refused);
+  return UNITY_END();
+}
@@ -0,0 +1,50 @@
+/*
+ * *****************************************************************************
+ * XORSHIFT - SEQUENCE AND RANGE (env:native)
+ * *****************************************************************************
+ * The simulation is only reproducible across builds if the generator gives
+ * the published xorshift32 sequence; range() must stay inside its bounds.
+ * *****************************************************************************
+ */
+
+#include <unity.h>
+#include "xorshift.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_matches_marsaglia() {
+  XorShift32 rng(2463534242u); // Seed and first value from Marsaglia (2003)
+  TEST_ASSERT_EQUAL_UINT32(723471715u, rng.next());
+
+  rng.seed(1);
+  TEST_ASSERT_EQUAL_UINT32(270369u, rng.next());
+  TEST_ASSERT_EQUAL_UINT32(67634689u, rng.next());
+  TEST_ASSERT_EQUAL_UINT32(2647435461u, rng.next());
+}
+
+static void test_zero_seed_is_replaced() {
+  XorShift32 zero(0);
+  XorShift32 one(1);
+  TEST_ASSERT_EQUAL_UINT32(one.next(), zero.next());
+}
+
+static void test_range_covers_its_bounds_only() {
+  XorShift32 rng(42);
+  bool seen[7] = {};
+  for (int i = 0; i < 10000; i++) {
+    int32_t v = rng.range(-3, 4);
+    TEST_ASSERT_TRUE(v >= -3 && v < 4);
+    seen[v + 3] = true;
+  }
+  for (bool s : seen) TEST_ASSERT_TRUE(s);
+  TEST_ASSERT_EQUAL_INT32(5, rng.range(5, 5));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_matches_marsaglia);
+  RUN_TEST(test_zero_seed_is_replaced);
+  RUN_TEST(test_range_covers_its_bounds_only);
+  return UNITY_END();
+}